@@ -43,10 +43,12 @@
 #include <QtNetwork/QNetworkReply>
 
 #include <Logging.h>
+#include <Metrics.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
 #include <Node.h>
 #include <PacketHeaders.h>
+#include <Profiler.h>
 #include <SharedUtil.h>
 #include <StdDev.h>
 #include <UUID.h>
@@ -75,6 +77,8 @@ bool AudioMixer::_printStreamStats = false;
 
 bool AudioMixer::_enableFilter = false;
 
+static MetricHistogram hashMatchTime("audio-mixer/packetVersionAndHashMatch_usecs");
+
 AudioMixer::AudioMixer(const QByteArray& packet) :
     ThreadedAssignment(packet),
     _trailingSleepRatio(1.0f),
@@ -87,10 +91,9 @@ AudioMixer::AudioMixer(const QByteArray& packet) :
     _listenerUnattenuatedZone(NULL),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
-    _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
-    _timeSpentPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
-    _timeSpentPerHashMatchCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
-    _readPendingCallsPerSecondStats(1, READ_DATAGRAMS_STATS_WINDOW_SECONDS)
+    _datagramsReadPerCallStats(AudioMixerDatagramProcessor::_datagramsPerRead, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
+    _timeSpentPerCallStats(AudioMixerDatagramProcessor::_readPendingDatagramsTime, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
+    _timeSpentPerHashMatchCallStats(hashMatchTime, READ_DATAGRAMS_STATS_WINDOW_SECONDS)
 {
     
 }
@@ -348,6 +351,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(PositionalAudioStream*
 }
 
 int AudioMixer::prepareMixForListeningNode(Node* node) {
+    PROFILE_SCOPE("prepareMix");
     AvatarAudioStream* nodeAudioStream = ((AudioMixerClientData*) node->getLinkedData())->getAvatarAudioStream();
     
     // zero out the client mix for this node
@@ -378,7 +382,11 @@ int AudioMixer::prepareMixForListeningNode(Node* node) {
 void AudioMixer::readPendingDatagram(const QByteArray& receivedPacket, const HifiSockAddr& senderSockAddr) {
     NodeList* nodeList = NodeList::getInstance();
     
-    if (nodeList->packetVersionAndHashMatch(receivedPacket)) {
+    quint64 hashMatchStart = usecTimestampNow();
+    bool packetMatches = nodeList->packetVersionAndHashMatch(receivedPacket);
+    hashMatchTime.record(usecTimestampNow() - hashMatchStart);
+
+    if (packetMatches) {
         // pull any new audio data from nodes off of the network stack
         PacketType mixerPacketType = packetTypeForPacket(receivedPacket);
         if (mixerPacketType == PacketTypeMicrophoneAudioNoEcho
@@ -793,45 +801,55 @@ void AudioMixer::run() {
     }
 }
 
+// the seconds that a window of stats covers, which are fewer than its length until it fills
+static double getWindowSeconds(const MetricHistogramWindow& window) {
+    return qMax(1, window.getNumIntervals());
+}
+
 void AudioMixer::perSecondActions() {
     _sendAudioStreamStats = true;
 
-    int callsLastSecond = _datagramsReadPerCallStats.getCurrentIntervalSamples();
-    _readPendingCallsPerSecondStats.update(callsLastSecond);
+    _datagramsReadPerCallStats.endInterval();
+    _timeSpentPerCallStats.endInterval();
+    _timeSpentPerHashMatchCallStats.endInterval();
 
     if (_printStreamStats) {
 
         printf("\n================================================================================\n\n");
 
-        printf("            readPendingDatagram() calls per second | avg: %.2f, avg_30s: %.2f, last_second: %d\n",
-            _readPendingCallsPerSecondStats.getAverage(),
-            _readPendingCallsPerSecondStats.getWindowAverage(),
-            callsLastSecond);
+        MetricHistogramSnapshot datagramsReadPerCall = _datagramsReadPerCallStats.getWindow();
+        MetricHistogramSnapshot timeSpentPerCall = _timeSpentPerCallStats.getWindow();
+        MetricHistogramSnapshot timeSpentPerHashMatchCall = _timeSpentPerHashMatchCallStats.getWindow();
+        double windowSeconds = getWindowSeconds(_timeSpentPerCallStats);
+
+        printf("            readPendingDatagram() calls per second | avg_30s: %.2f, last_second: %lld\n",
+            timeSpentPerCall.getCount() / windowSeconds,
+            (long long)_timeSpentPerCallStats.getLastInterval().getCount());
 
         printf("                           Datagrams read per call | avg: %.2f, avg_30s: %.2f, last_second: %.2f\n",
-            _datagramsReadPerCallStats.getAverage(),
-            _datagramsReadPerCallStats.getWindowAverage(),
-            _datagramsReadPerCallStats.getCurrentIntervalAverage());
+            AudioMixerDatagramProcessor::_datagramsPerRead.getSnapshot().getMean(),
+            datagramsReadPerCall.getMean(),
+            _datagramsReadPerCallStats.getLastInterval().getMean());
 
         printf("        Usecs spent per readPendingDatagram() call | avg: %.2f, avg_30s: %.2f, last_second: %.2f\n",
-            _timeSpentPerCallStats.getAverage(),
-            _timeSpentPerCallStats.getWindowAverage(),
-            _timeSpentPerCallStats.getCurrentIntervalAverage());
+            AudioMixerDatagramProcessor::_readPendingDatagramsTime.getSnapshot().getMean(),
+            timeSpentPerCall.getMean(),
+            _timeSpentPerCallStats.getLastInterval().getMean());
 
         printf("  Usecs spent per packetVersionAndHashMatch() call | avg: %.2f, avg_30s: %.2f, last_second: %.2f\n",
-            _timeSpentPerHashMatchCallStats.getAverage(),
-            _timeSpentPerHashMatchCallStats.getWindowAverage(),
-            _timeSpentPerHashMatchCallStats.getCurrentIntervalAverage());
-
-        double WINDOW_LENGTH_USECS = READ_DATAGRAMS_STATS_WINDOW_SECONDS * USECS_PER_SECOND;
+            hashMatchTime.getSnapshot().getMean(),
+            timeSpentPerHashMatchCall.getMean(),
+            _timeSpentPerHashMatchCallStats.getLastInterval().getMean());
 
         printf("       %% time spent in readPendingDatagram() calls | avg_30s: %.6f%%, last_second: %.6f%%\n",
-            _timeSpentPerCallStats.getWindowSum() / WINDOW_LENGTH_USECS * 100.0,
-            _timeSpentPerCallStats.getCurrentIntervalSum() / USECS_PER_SECOND * 100.0);
+            timeSpentPerCall.getSum() / (windowSeconds * USECS_PER_SECOND) * 100.0,
+            _timeSpentPerCallStats.getLastInterval().getSum() / (double)USECS_PER_SECOND * 100.0);
 
         printf("%% time spent in packetVersionAndHashMatch() calls: | avg_30s: %.6f%%, last_second: %.6f%%\n",
-            _timeSpentPerHashMatchCallStats.getWindowSum() / WINDOW_LENGTH_USECS * 100.0,
-            _timeSpentPerHashMatchCallStats.getCurrentIntervalSum() / USECS_PER_SECOND * 100.0);
+            timeSpentPerHashMatchCall.getSum() / (windowSeconds * USECS_PER_SECOND) * 100.0,
+            _timeSpentPerHashMatchCallStats.getLastInterval().getSum() / (double)USECS_PER_SECOND * 100.0);
+
+        printf("%s", qPrintable(Metrics::getStatsString(getMetricsPrefix())));
 
         foreach(const SharedNodePointer& node, NodeList::getInstance()->getNodeHash()) {
             if (node->getLinkedData()) {
@@ -845,36 +863,37 @@ void AudioMixer::perSecondActions() {
             }
         }
     }
-
-    _datagramsReadPerCallStats.currentIntervalComplete();
-    _timeSpentPerCallStats.currentIntervalComplete();
-    _timeSpentPerHashMatchCallStats.currentIntervalComplete();
 }
 
 QString AudioMixer::getReadPendingDatagramsCallsPerSecondsStatsString() const {
-    QString result = "calls_per_sec_avg_30s: " + QString::number(_readPendingCallsPerSecondStats.getWindowAverage(), 'f', 2)
-        + " calls_last_sec: " + QString::number(_readPendingCallsPerSecondStats.getLastCompleteIntervalStats().getSum() + 0.5, 'f', 0);
+    QString result = "calls_per_sec_avg_30s: "
+        + QString::number(_timeSpentPerCallStats.getWindow().getCount() / getWindowSeconds(_timeSpentPerCallStats), 'f', 2)
+        + " calls_last_sec: " + QString::number(_timeSpentPerCallStats.getLastInterval().getCount());
     return result;
 }
 
 QString AudioMixer::getReadPendingDatagramsPacketsPerCallStatsString() const {
-    QString result = "pkts_per_call_avg_30s: " + QString::number(_datagramsReadPerCallStats.getWindowAverage(), 'f', 2)
-        + " pkts_per_call_avg_1s: " + QString::number(_datagramsReadPerCallStats.getLastCompleteIntervalStats().getAverage(), 'f', 2);
+    QString result = "pkts_per_call_avg_30s: " + QString::number(_datagramsReadPerCallStats.getWindow().getMean(), 'f', 2)
+        + " pkts_per_call_avg_1s: " + QString::number(_datagramsReadPerCallStats.getLastInterval().getMean(), 'f', 2);
     return result;
 }
 
+// the mean time per call and the share of time spent in the calls, over the window and over its last second
+static QString getTimeStatsString(const MetricHistogramWindow& stats, const QString& callName) {
+    MetricHistogramSnapshot window = stats.getWindow();
+    const MetricHistogramSnapshot& lastSecond = stats.getLastInterval();
+    return "usecs_per_" + callName + "_avg_30s: " + QString::number(window.getMean(), 'f', 2)
+        + " usecs_per_" + callName + "_avg_1s: " + QString::number(lastSecond.getMean(), 'f', 2)
+        + " prct_time_in_" + callName + "_30s: "
+        + QString::number(window.getSum() / (getWindowSeconds(stats) * USECS_PER_SECOND) * 100.0, 'f', 6) + "%"
+        + " prct_time_in_" + callName + "_1s: "
+        + QString::number(lastSecond.getSum() / (double)USECS_PER_SECOND * 100.0, 'f', 6) + "%";
+}
+
 QString AudioMixer::getReadPendingDatagramsTimeStatsString() const {
-    QString result = "usecs_per_call_avg_30s: " + QString::number(_timeSpentPerCallStats.getWindowAverage(), 'f', 2)
-        + " usecs_per_call_avg_1s: " + QString::number(_timeSpentPerCallStats.getLastCompleteIntervalStats().getAverage(), 'f', 2)
-        + " prct_time_in_call_30s: " + QString::number(_timeSpentPerCallStats.getWindowSum() / (READ_DATAGRAMS_STATS_WINDOW_SECONDS*USECS_PER_SECOND) * 100.0, 'f', 6) + "%"
-        + " prct_time_in_call_1s: " + QString::number(_timeSpentPerCallStats.getLastCompleteIntervalStats().getSum() / USECS_PER_SECOND * 100.0, 'f', 6) + "%";
-    return result;
+    return getTimeStatsString(_timeSpentPerCallStats, "call");
 }
 
 QString AudioMixer::getReadPendingDatagramsHashMatchTimeStatsString() const {
-    QString result = "usecs_per_hashmatch_avg_30s: " + QString::number(_timeSpentPerHashMatchCallStats.getWindowAverage(), 'f', 2)
-        + " usecs_per_hashmatch_avg_1s: " + QString::number(_timeSpentPerHashMatchCallStats.getLastCompleteIntervalStats().getAverage(), 'f', 2)
-        + " prct_time_in_hashmatch_30s: " + QString::number(_timeSpentPerHashMatchCallStats.getWindowSum() / (READ_DATAGRAMS_STATS_WINDOW_SECONDS*USECS_PER_SECOND) * 100.0, 'f', 6) + "%"
-        + " prct_time_in_hashmatch_1s: " + QString::number(_timeSpentPerHashMatchCallStats.getLastCompleteIntervalStats().getSum() / USECS_PER_SECOND * 100.0, 'f', 6) + "%";
-    return result;
+    return getTimeStatsString(_timeSpentPerHashMatchCallStats, "hashmatch");
 }
@@ -14,6 +14,7 @@
 
 #include <AABox.h>
 #include <AudioRingBuffer.h>
+#include <Metrics.h>
 #include <ThreadedAssignment.h>
 
 class PositionalAudioStream;
@@ -40,6 +41,8 @@ public slots:
     void sendStatsPacket();
 
     static const InboundAudioStream::Settings& getStreamSettings() { return _streamSettings; }
+
+    virtual QString getMetricsPrefix() const { return "audio-mixer/"; }
     
 private:
     /// adds one stream to the mix for a listening node
@@ -78,12 +81,10 @@ private:
 
     bool _sendAudioStreamStats;
 
-    // stats
-    MovingMinMaxAvg<int> _datagramsReadPerCallStats;     // update with # of datagrams read for each readPendingDatagrams call
-    MovingMinMaxAvg<quint64> _timeSpentPerCallStats;     // update with usecs spent inside each readPendingDatagrams call
-    MovingMinMaxAvg<quint64> _timeSpentPerHashMatchCallStats; // update with usecs spent inside each packetVersionAndHashMatch call
-
-    MovingMinMaxAvg<int> _readPendingCallsPerSecondStats;     // update with # of readPendingDatagrams calls in the last second
+    // stats of the last second and of the last READ_DATAGRAMS_STATS_WINDOW_SECONDS, one interval per second
+    MetricHistogramWindow _datagramsReadPerCallStats;
+    MetricHistogramWindow _timeSpentPerCallStats;
+    MetricHistogramWindow _timeSpentPerHashMatchCallStats;
 };
 
 #endif // hifi_AudioMixer_h
@@ -13,9 +13,13 @@
 
 #include <HifiSockAddr.h>
 #include <NodeList.h>
+#include <SharedUtil.h>
 
 #include "AudioMixerDatagramProcessor.h"
 
+MetricHistogram AudioMixerDatagramProcessor::_readPendingDatagramsTime("audio-mixer/readPendingDatagrams_usecs");
+MetricHistogram AudioMixerDatagramProcessor::_datagramsPerRead("audio-mixer/datagramsPerRead");
+
 AudioMixerDatagramProcessor::AudioMixerDatagramProcessor(QUdpSocket& nodeSocket, QThread* previousNodeSocketThread) :
     _nodeSocket(nodeSocket),
     _previousNodeSocketThread(previousNodeSocketThread)
@@ -29,12 +33,15 @@ AudioMixerDatagramProcessor::~AudioMixerDatagramProcessor() {
 }
 
 void AudioMixerDatagramProcessor::readPendingDatagrams() {
+    quint64 start = usecTimestampNow();
+    int numDatagrams = 0;
     
     HifiSockAddr senderSockAddr;
     static QByteArray incomingPacket;
     
     // read everything that is available
     while (_nodeSocket.hasPendingDatagrams()) {
+        numDatagrams++;
         incomingPacket.resize(_nodeSocket.pendingDatagramSize());
         
         // just get this packet off the stack
@@ -44,4 +51,7 @@ void AudioMixerDatagramProcessor::readPendingDatagrams() {
         // emit the signal to tell AudioMixer it needs to process a packet
         emit packetRequiresProcessing(incomingPacket, senderSockAddr);
     }
+
+    _datagramsPerRead.record(numDatagrams);
+    _readPendingDatagramsTime.record(usecTimestampNow() - start);
 }
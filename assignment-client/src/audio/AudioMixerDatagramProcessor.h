@@ -15,11 +15,17 @@
 #include <qobject.h>
 #include <qudpsocket.h>
 
+#include <Metrics.h>
+
 class AudioMixerDatagramProcessor : public QObject {
     Q_OBJECT
 public:
     AudioMixerDatagramProcessor(QUdpSocket& nodeSocket, QThread* previousNodeSocketThread);
     ~AudioMixerDatagramProcessor();
+
+    static MetricHistogram _readPendingDatagramsTime;
+    static MetricHistogram _datagramsPerRead;
+
 public slots:
     void readPendingDatagrams();
 signals:
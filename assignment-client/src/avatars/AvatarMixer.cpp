@@ -18,6 +18,7 @@
 #include <Logging.h>
 #include <NodeList.h>
 #include <PacketHeaders.h>
+#include <Profiler.h>
 #include <SharedUtil.h>
 #include <UUID.h>
 
@@ -61,6 +62,7 @@ const float BILLBOARD_AND_IDENTITY_SEND_PROBABILITY = 1.0f / 300.0f;
 //    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
 //       if the avatar is not in view or in the keyhole.
 void AvatarMixer::broadcastAvatarData() {
+    PROFILE_SCOPE("broadcastAvatarData");
     
     int idleTime = QDateTime::currentMSecsSinceEpoch() - _lastFrameTimestamp;
     
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QJsonObject>
+#include <QLocale>
 #include <QTimer>
 #include <ModelTree.h>
 
@@ -118,6 +120,31 @@ int ModelServer::sendSpecialPacket(const SharedNodePointer& node, OctreeQueryNod
     return packetLength;
 }
 
+QString ModelServer::getTreeStatusString() {
+    ModelTree* tree = static_cast<ModelTree*>(_tree);
+    const float AS_PERCENT = 100.0f;
+    tree->lockForRead();
+    int modelCount = tree->getModelCount();
+    int activeModelCount = tree->getActiveModelCount();
+    tree->unlock();
+    QLocale locale(QLocale::English);
+
+    QString statusString = QString("         Total Models: %1 models\r\n")
+        .arg(locale.toString(modelCount).rightJustified(16, ' '));
+    statusString += QString().sprintf("        Active Models: %s models (%5.2f%%)\r\n",
+                                      locale.toString(activeModelCount).rightJustified(16, ' ').toLocal8Bit().constData(),
+                                      modelCount > 0 ? ((float)activeModelCount / (float)modelCount) * AS_PERCENT : 0.0f);
+    return statusString;
+}
+
+void ModelServer::addTreeStats(QJsonObject& statsObject, const QString& baseName) {
+    ModelTree* tree = static_cast<ModelTree*>(_tree);
+    tree->lockForRead();
+    statsObject[baseName + QString(".1.4.octree.modelCount")] = (double)tree->getModelCount();
+    statsObject[baseName + QString(".1.5.octree.activeModelCount")] = (double)tree->getActiveModelCount();
+    tree->unlock();
+}
+
 void ModelServer::pruneDeletedModels() {
     ModelTree* tree = static_cast<ModelTree*>(_tree);
     if (tree->hasAnyDeletedModels()) {
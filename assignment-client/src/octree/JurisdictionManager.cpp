@@ -0,0 +1,154 @@
+//
+//  JurisdictionManager.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+
+#include <SharedUtil.h>
+
+#include "OctreeServer.h"
+#include "JurisdictionManager.h"
+
+const quint64 MSECS_TO_USECS = 1000;
+const quint64 FILE_CHECK_INTERVAL = 1000 * MSECS_TO_USECS; // look at the jurisdiction file every second
+
+JurisdictionManager::JurisdictionManager(OctreeServer* server, int balanceInterval) :
+    _server(server),
+    _balanceInterval(balanceInterval * MSECS_TO_USECS),
+    _load(server->getJurisdiction()),
+    _intervalStart(usecTimestampNow()),
+    _lastFileCheck(0)
+{
+    // the server has just read the file, only later changes are picked up
+    if (!server->getJurisdictionFile().isEmpty()) {
+        _jurisdictionFileModified = QFileInfo(server->getJurisdictionFile()).lastModified();
+    }
+}
+
+void JurisdictionManager::recordEdit(const unsigned char* editData, int editLength, quint64 processUsecs) {
+    QMutexLocker locker(&_loadMutex);
+    _load.recordEdit(editData, editLength, processUsecs);
+}
+
+void JurisdictionManager::recordEncode(const QUuid& clientID, const glm::vec3& position, quint64 encodeUsecs) {
+    QMutexLocker locker(&_loadMutex);
+    _load.recordEncode(clientID, position, encodeUsecs);
+}
+
+bool JurisdictionManager::process() {
+    if (isStillRunning()) {
+        const quint64 USECS_TO_SLEEP = 100 * MSECS_TO_USECS;
+        usleep(USECS_TO_SLEEP);
+
+        quint64 now = usecTimestampNow();
+        if (now - _lastFileCheck > FILE_CHECK_INTERVAL) {
+            _lastFileCheck = now;
+            checkJurisdictionFile();
+        }
+
+        if (now - _intervalStart >= _balanceInterval) {
+            endInterval(now);
+            balance();
+        }
+    }
+    return isStillRunning();  // keep running till they terminate us
+}
+
+void JurisdictionManager::checkJurisdictionFile() {
+    const QString& fileName = _server->getJurisdictionFile();
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QFileInfo fileInfo(fileName);
+    if (!fileInfo.exists() || fileInfo.lastModified() == _jurisdictionFileModified) {
+        return;
+    }
+    _jurisdictionFileModified = fileInfo.lastModified();
+
+    JurisdictionMap* jurisdiction = new JurisdictionMap(qPrintable(fileName));
+    _server->setJurisdiction(jurisdiction);
+
+    // the load under the old root doesn't mean anything under the new one
+    QMutexLocker locker(&_loadMutex);
+    _load.setJurisdiction(jurisdiction);
+    _proposal.clear();
+}
+
+void JurisdictionManager::endInterval(quint64 now) {
+    QMutexLocker locker(&_loadMutex);
+    _load.endInterval(now - _intervalStart);
+    _intervalStart = now;
+}
+
+void JurisdictionManager::balance() {
+    // only this thread replaces the jurisdiction, so the map and the load's root stay valid here
+    JurisdictionMap* jurisdiction = _server->getJurisdiction();
+    const unsigned char* rootCode = _load.getRootOctalCode();
+    QString proposal;
+
+    _loadMutex.lock();
+    int childIndex = -1;
+    JurisdictionLoad::Proposal proposalType = _load.propose(jurisdiction, childIndex);
+    float load = _load.getLastLoad(JurisdictionLoad::TOTAL);
+    float childLoad = (childIndex == -1) ? 0.0f : _load.getLastLoad(childIndex);
+    _loadMutex.unlock();
+
+    if (proposalType == JurisdictionLoad::SPLIT_PROPOSAL) {
+        unsigned char* childCode = childOctalCode(rootCode, childIndex);
+        proposal = QString().sprintf("split off subtree %s, load %.2f of %.2f", qPrintable(octalCodeToHexString(childCode)),
+                                     childLoad, load);
+        delete[] childCode;
+
+    } else if (proposalType == JurisdictionLoad::MERGE_PROPOSAL) {
+        proposal = QString().sprintf("merge subtree %s back into its parent server, load %.2f",
+                                     qPrintable(octalCodeToHexString(rootCode)), load);
+    }
+
+    QMutexLocker locker(&_loadMutex);
+    if (!proposal.isEmpty() && proposal != _proposal) {
+        qDebug() << "JurisdictionManager proposes to" << qPrintable(proposal);
+    }
+    _proposal = proposal;
+}
+
+QString JurisdictionManager::getStatusString() {
+    QMutexLocker locker(&_loadMutex);
+    QString statusString;
+    const unsigned char* rootCode = _load.getRootOctalCode();
+
+    statusString += "<b>Jurisdiction Load:</b>\r\n";
+    quint64 intervalUsecs = _load.getLastIntervalUsecs();
+    if (intervalUsecs == 0) {
+        statusString += "        No complete interval yet\r\n";
+        return statusString;
+    }
+
+    const float USECS_PER_SECOND = 1000000.0f;
+    float intervalSeconds = intervalUsecs / USECS_PER_SECOND;
+    statusString += "           Subtree    Edits/sec   Edit Load Encode Load  Clients\r\n";
+    for (int i = 0; i <= JurisdictionLoad::TOTAL; i++) {
+        QString name;
+        if (i == JurisdictionLoad::TOTAL) {
+            name = "total";
+        } else {
+            unsigned char* childCode = childOctalCode(rootCode, i);
+            name = octalCodeToHexString(childCode);
+            delete[] childCode;
+        }
+        statusString += QString().sprintf("    %14s %12.1f %11.3f %11.3f %8d\r\n", qPrintable(name),
+                                          _load.getLast(i).edits / intervalSeconds,
+                                          _load.getLast(i).editUsecs / (float)intervalUsecs,
+                                          _load.getLast(i).encodeUsecs / (float)intervalUsecs,
+                                          _load.getLast(i).clients.size());
+    }
+    statusString += QString("        Proposal: %1\r\n").arg(_proposal.isEmpty() ? QString("none") : _proposal);
+    return statusString;
+}
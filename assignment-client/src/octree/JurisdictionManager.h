@@ -0,0 +1,75 @@
+//
+//  JurisdictionManager.h
+//  assignment-client/src/octree
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Watches the load on each of the eight subtrees under an octree server's jurisdiction root, and proposes splits and
+//  merges of the jurisdiction with other servers of the same type. The load and the proposals are on the status page and
+//  in the log.
+//
+//  A proposal is carried out by changing the jurisdiction files of the servers involved: a split adds the subtree to the
+//  busy server's end nodes and makes it the root of another server, a merge removes the idle server's root from its
+//  parent's end nodes. Each server picks up the change to its file while it runs, and broadcasts its new map to the
+//  clients, so that their edits go to the new owner.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JurisdictionManager_h
+#define hifi_JurisdictionManager_h
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+
+#include <GenericThread.h>
+#include <JurisdictionLoad.h>
+#include <JurisdictionMap.h>
+
+class OctreeServer;
+
+class JurisdictionManager : public GenericThread {
+    Q_OBJECT
+public:
+    static const int DEFAULT_BALANCE_INTERVAL = 1000 * 10; // every 10 seconds
+
+    JurisdictionManager(OctreeServer* server, int balanceInterval = DEFAULT_BALANCE_INTERVAL);
+
+    /// Called by the inbound packet processor for each edit record, editData starts with the edit's octal code.
+    void recordEdit(const unsigned char* editData, int editLength, quint64 processUsecs);
+
+    /// Called by the send threads for each encode, position is the client's position in voxel scale.
+    void recordEncode(const QUuid& clientID, const glm::vec3& position, quint64 encodeUsecs);
+
+    /// the load of the last complete interval and any pending proposal, for the server status page
+    QString getStatusString();
+
+protected:
+    /// Implements generic processing behavior for this thread.
+    virtual bool process();
+
+private:
+    void checkJurisdictionFile();
+    void endInterval(quint64 now);
+    void balance();
+
+    OctreeServer* _server;
+    quint64 _balanceInterval; // usecs
+
+    // guards the load, which other threads record into, and what the status page reads
+    QMutex _loadMutex;
+    JurisdictionLoad _load; // its root is only changed by this thread
+    quint64 _intervalStart;
+    QString _proposal;
+
+    // only touched by this thread
+    QDateTime _jurisdictionFileModified;
+    quint64 _lastFileCheck;
+};
+
+#endif // hifi_JurisdictionManager_h
@@ -129,6 +129,10 @@ void OctreeInboundPacketProcessor::processPacket(const SharedNodePointer& sendin
             _myServer->getOctree()->unlock();
             quint64 endProcess = usecTimestampNow();
 
+            if (_myServer->getJurisdictionManager()) {
+                _myServer->getJurisdictionManager()->recordEdit(editData, editDataBytesRead, endProcess - startProcess);
+            }
+
             editsInPacket++;
             quint64 thisProcessTime = endProcess - startProcess;
             quint64 thisLockWaitTime = startProcess - startLock;
@@ -33,6 +33,7 @@ OctreeQueryNode::OctreeQueryNode() :
     _viewFrustumJustStoppedChanging(true),
     _currentPacketIsColor(true),
     _currentPacketIsCompressed(false),
+    _currentPacketCompressionCodec(ZLIB_PACKET_COMPRESSION),
     _octreeSendThread(NULL),
     _lastClientBoundaryLevelAdjust(0),
     _lastClientOctreeSizeScale(DEFAULT_OCTREE_SIZE_SCALE),
@@ -58,7 +59,6 @@ OctreeQueryNode::~OctreeQueryNode() {
 
 void OctreeQueryNode::nodeKilled() {
     _isShuttingDown = true;
-    nodeBag.unhookNotifications(); // if our node is shutting down, then we no longer need octree element notifications
     if (_octreeSendThread) {
         // just tell our thread we want to shutdown, this is asynchronous, and fast, we don't need or want it to block
         // while the thread actually shuts down
@@ -68,7 +68,6 @@ void OctreeQueryNode::nodeKilled() {
 
 void OctreeQueryNode::forceNodeShutdown() {
     _isShuttingDown = true;
-    nodeBag.unhookNotifications(); // if our node is shutting down, then we no longer need octree element notifications
     if (_octreeSendThread) {
         // we really need to force our thread to shutdown, this is synchronous, we will block while the thread actually 
         // shuts down because we really need it to shutdown, and it's ok if we wait for it to complete
@@ -180,12 +179,16 @@ void OctreeQueryNode::resetOctreePacket() {
     // the clients requested color state.
     _currentPacketIsColor = getWantColor();
     _currentPacketIsCompressed = getWantCompression();
+    _currentPacketCompressionCodec = getWantCompressionCodec();
     OCTREE_PACKET_FLAGS flags = 0;
     if (_currentPacketIsColor) {
         setAtBit(flags,PACKET_IS_COLOR_BIT);
     }
     if (_currentPacketIsCompressed) {
         setAtBit(flags,PACKET_IS_COMPRESSED_BIT);
+        if (_currentPacketCompressionCodec == FAST_LZ_PACKET_COMPRESSION) {
+            setAtBit(flags, PACKET_IS_FAST_COMPRESSED_BIT);
+        }
     }
 
     _octreePacketAvailableBytes = MAX_PACKET_SIZE;
@@ -17,6 +17,7 @@
 
 #include <CoverageMap.h>
 #include <NodeData.h>
+#include <OcclusionBuffer.h>
 #include <OctreeConstants.h>
 #include <OctreeElementBag.h>
 #include <OctreePacketData.h>
@@ -58,6 +59,7 @@ public:
 
     OctreeElementBag nodeBag;
     CoverageMap map;
+    OcclusionBuffer occlusionBuffer; // used instead of map when the server wants occlusion buffers
 
     ViewFrustum& getCurrentViewFrustum() { return _currentViewFrustum; }
     ViewFrustum& getLastKnownViewFrustum() { return _lastKnownViewFrustum; }
@@ -80,8 +82,15 @@ public:
 
     bool getCurrentPacketIsColor() const { return _currentPacketIsColor; }
     bool getCurrentPacketIsCompressed() const { return _currentPacketIsCompressed; }
+    OctreePacketCompressionCodec getCurrentPacketCompressionCodec() const { return _currentPacketCompressionCodec; }
     bool getCurrentPacketFormatMatches() {
-        return (getCurrentPacketIsColor() == getWantColor() && getCurrentPacketIsCompressed() == getWantCompression());
+        return (getCurrentPacketIsColor() == getWantColor() && getCurrentPacketIsCompressed() == getWantCompression()
+                && getCurrentPacketCompressionCodec() == getWantCompressionCodec());
+    }
+
+    /// the codec to compress sections with, the fast codec is only used if the client says it can decode it
+    OctreePacketCompressionCodec getWantCompressionCodec() const {
+        return getWantFastCompression() ? FAST_LZ_PACKET_COMPRESSION : ZLIB_PACKET_COMPRESSION;
     }
 
     bool hasLodChanged() const { return _lodChanged; };
@@ -139,6 +148,7 @@ private:
     bool _viewFrustumJustStoppedChanging;
     bool _currentPacketIsColor;
     bool _currentPacketIsCompressed;
+    OctreePacketCompressionCodec _currentPacketCompressionCodec;
 
     OctreeSendThread* _octreeSendThread;
 
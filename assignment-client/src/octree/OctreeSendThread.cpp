@@ -11,7 +11,7 @@
 
 #include <NodeList.h>
 #include <PacketHeaders.h>
-#include <PerfStat.h>
+#include <Profiler.h>
 #include <SharedUtil.h>
 
 #include "OctreeSendThread.h"
@@ -100,8 +100,9 @@ bool OctreeSendThread::process() {
         int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
 
         if (usecToSleep > 0) {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
+            quint64 sleepStart = usecTimestampNow();
             usleep(usecToSleep);
+            _usleepTime.record(usecTimestampNow() - sleepStart);
         } else {
             const int MIN_USEC_TO_SLEEP = 1;
             usleep(MIN_USEC_TO_SLEEP);
@@ -111,8 +112,7 @@ bool OctreeSendThread::process() {
     return isStillRunning();  // keep running till they terminate us
 }
 
-quint64 OctreeSendThread::_usleepTime = 0;
-quint64 OctreeSendThread::_usleepCalls = 0;
+MetricHistogram OctreeSendThread::_usleepTime("octree-server/usleep_usecs");
 
 quint64 OctreeSendThread::_totalBytes = 0;
 quint64 OctreeSendThread::_totalWastedBytes = 0;
@@ -280,8 +280,37 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
     return packetsSent;
 }
 
+void OctreeSendThread::startSection(OctreeQueryNode* nodeData, bool wantCompression,
+                                    OctreePacketCompressionCodec compressionCodec) {
+    // A compressed section targets the uncompressed size we expect to compress into our current available space in the
+    // wire packet, less room for our section header. Nothing is compressed until the section is written.
+    if (wantCompression) {
+        _packetData.changeCompressedSettings(nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE),
+                                             compressionCodec);
+    } else {
+        _packetData.changeSettings(false, MAX_OCTREE_PACKET_DATA_SIZE, compressionCodec); // will do reset
+    }
+    _sectionSubTrees.clear();
+}
+
+void OctreeSendThread::encodeSectionAgain(OctreeQueryNode* nodeData) {
+    // Finalizing the section reset the prediction to a section size that always fits, so its subtrees go back into the
+    // bag to be encoded into sections of that size. The coverage map and occlusion buffer hold what was encoded into
+    // the section, which would cull it now, so they start over.
+    _myServer->getOctree()->lockForRead();
+    foreach (const OctreeElementHandle& subTree, _sectionSubTrees) {
+        if (subTree.isAlive()) {
+            nodeData->nodeBag.insert(subTree.element);
+        }
+    }
+    _myServer->getOctree()->unlock();
+    nodeData->map.erase();
+    nodeData->occlusionBuffer.erase();
+}
+
 /// Version of voxel distributor that sends the deepest LOD level at once
 int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged) {
+    PROFILE_SCOPE("packetDistributor");
         
     OctreeServer::didPacketDistributor(this);
 
@@ -311,6 +340,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
     //     the clients requested color state.
     bool wantColor = nodeData->getWantColor();
     bool wantCompression = nodeData->getWantCompression();
+    OctreePacketCompressionCodec compressionCodec = nodeData->getWantCompressionCodec();
 
     // If we have a packet waiting, and our desired want color, doesn't match the current waiting packets color
     // then let's just send that waiting packet.
@@ -320,11 +350,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         } else {
             nodeData->resetOctreePacket();
         }
-        int targetSize = MAX_OCTREE_PACKET_DATA_SIZE;
-        if (wantCompression) {
-            targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
-        }
-        _packetData.changeSettings(wantCompression, targetSize);
+        startSection(nodeData, wantCompression, compressionCodec);
     }
 
     const ViewFrustum* lastViewFrustum =  wantDelta ? &nodeData->getLastKnownViewFrustum() : NULL;
@@ -339,6 +365,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 nodeData->dumpOutOfView();
             }
             nodeData->map.erase();
+            nodeData->occlusionBuffer.erase();
         }
 
         if (!viewFrustumChanged && !nodeData->getWantDelta()) {
@@ -368,9 +395,18 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         // TODO: add these to stats page
         //::startSceneSleepTime = _usleepTime;
         
-        // start tracking our stats
+        // start tracking our stats, the jurisdiction map is only valid under the tree's lock. The bag reads the elements
+        // it holds to prioritize them, so it is reordered and the root is added under the lock too. The lock is let go
+        // after that, and each slice of extracting and encoding below takes it again.
+        _myServer->getOctree()->lockForRead();
         nodeData->stats.sceneStarted(isFullScene, viewFrustumChanged, _myServer->getOctree()->getRoot(), _myServer->getJurisdiction());
 
+        // In priority mode the bag hands out the elements that look biggest from here first. This also reorders anything
+        // still in the bag from the last view.
+        if (_myServer->wantsSendByPriority()) {
+            nodeData->nodeBag.setPriorityViewFrustum(&nodeData->getCurrentViewFrustum());
+        }
+
         // This is the start of "resending" the scene.
         bool dontRestartSceneOnMove = false; // this is experimental
         if (dontRestartSceneOnMove) {
@@ -380,6 +416,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         } else {
             nodeData->nodeBag.insert(_myServer->getOctree()->getRoot()); // original behavior, reset on move or empty
         }
+        _myServer->getOctree()->unlock();
     }
 
     // If we have something in our nodeBag, then turn them into packets and send them out...
@@ -391,7 +428,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         //quint64 startCompressTimeMsecs = OctreePacketData::getCompressContentTime() / 1000;
         //quint64 startCompressCalls = OctreePacketData::getCompressContentCalls();
 
-        int extraPackingAttempts = 0;
+        int extraPackingAttempts = 0; // sections packed into the wire packet to fill its leftover space
         bool completedScene = false;
         while (somethingToSend && packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown()) {
             float lockWaitElapsedUsec = OctreeServer::SKIP_TIME;
@@ -403,7 +440,16 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
 
             bool lastNodeDidntFit = false; // assume each node fits
             if (!nodeData->nodeBag.isEmpty()) {
+                // the element we extract could be deleted by the tree's writer, so take it under the read lock
+                quint64 lockWaitStart = usecTimestampNow();
+                _myServer->getOctree()->lockForRead();
+                quint64 lockWaitEnd = usecTimestampNow();
+                lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
+
                 OctreeElement* subTree = nodeData->nodeBag.extract();
+                if (subTree) {
+                    _sectionSubTrees.append(subTree->getHandle());
+                }
                 
                 /* TODO: Looking for a way to prevent locking and encoding a tree that is not
                 // going to result in any packets being sent...
@@ -427,7 +473,10 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 */
 
                 bool wantOcclusionCulling = nodeData->getWantOcclusionCulling();
-                CoverageMap* coverageMap = wantOcclusionCulling ? &nodeData->map : IGNORE_COVERAGE_MAP;
+                bool useOcclusionBuffer = wantOcclusionCulling && _myServer->wantsOcclusionBuffer();
+                CoverageMap* coverageMap = (wantOcclusionCulling && !useOcclusionBuffer)
+                                                ? &nodeData->map : IGNORE_COVERAGE_MAP;
+                OcclusionBuffer* occlusionBuffer = useOcclusionBuffer ? &nodeData->occlusionBuffer : IGNORE_OCCLUSION_BUFFER;
                 
                 float voxelSizeScale = nodeData->getOctreeSizeScale();
                 int boundaryLevelAdjustClient = nodeData->getBoundaryLevelAdjust();
@@ -439,22 +488,25 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                                              WANT_EXISTS_BITS, DONT_CHOP, wantDelta, lastViewFrustum,
                                              wantOcclusionCulling, coverageMap, boundaryLevelAdjust, voxelSizeScale,
                                              nodeData->getLastTimeBagEmpty(),
-                                             isFullScene, &nodeData->stats, _myServer->getJurisdiction());
+                                             isFullScene, &nodeData->stats, IGNORE_JURISDICTION_MAP,
+                                             occlusionBuffer);
 
                 // TODO: should this include the lock time or not? This stat is sent down to the client,
                 // it seems like it may be a good idea to include the lock time as part of the encode time
                 // are reported to client. Since you can encode without the lock
                 nodeData->stats.encodeStarted();
                 
-                quint64 lockWaitStart = usecTimestampNow();
-                _myServer->getOctree()->lockForRead();
-                quint64 lockWaitEnd = usecTimestampNow();
-                lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
+                params.jurisdictionMap = _myServer->getJurisdiction();
 
                 quint64 encodeStart = usecTimestampNow();
                 bytesWritten = _myServer->getOctree()->encodeTreeBitstream(subTree, &_packetData, nodeData->nodeBag, params);
                 quint64 encodeEnd = usecTimestampNow();
                 encodeElapsedUsec = (float)(encodeEnd - encodeStart);
+
+                if (_myServer->getJurisdictionManager()) {
+                    _myServer->getJurisdictionManager()->recordEncode(_nodeUUID,
+                        nodeData->getCurrentViewFrustum().getPositionVoxelScale(), encodeEnd - encodeStart);
+                }
                 
                 // If after calling encodeTreeBitstream() there are no nodes left to send, then we know we've
                 // sent the entire scene. We want to know this below so we'll actually write this content into
@@ -462,16 +514,14 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 completedScene = nodeData->nodeBag.isEmpty();
 
                 // if we're trying to fill a full size packet, then we use this logic to determine if we have a DIDNT_FIT case.
-                if (_packetData.getTargetSize() == MAX_OCTREE_PACKET_DATA_SIZE) {
+                if (!_packetData.isCompressed()) {
                     if (_packetData.hasContent() && bytesWritten == 0 &&
                             params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
                         lastNodeDidntFit = true;
                     }
                 } else {
-                    // in compressed mode and we are trying to pack more... and we don't care if the _packetData has
-                    // content or not... because in this case even if we were unable to pack any data, we want to drop
-                    // below to our sendNow logic, but we do want to track that we attempted to pack extra
-                    extraPackingAttempts++;
+                    // in compressed mode we don't care if the _packetData has content or not... because in this case
+                    // even if we were unable to pack any data, we want to drop below to our sendNow logic
                     if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
                         lastNodeDidntFit = true;
                     }
@@ -503,47 +553,45 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                     unsigned int writtenSize = _packetData.getFinalizedSize()
                             + (nodeData->getCurrentPacketIsCompressed() ? sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) : 0);
 
+                    if (writtenSize > MAX_OCTREE_PACKET_DATA_SIZE) {
+                        // the section compressed so much worse than predicted that not even an empty packet holds it
+                        encodeSectionAgain(nodeData);
+                    } else {
+                        if (writtenSize > nodeData->getAvailable()) {
+                            packetsSentThisInterval += handlePacketSend(nodeData, trueBytesSent, truePacketsSent);
+                            extraPackingAttempts = 0;
+                        }
 
-                    if (writtenSize > nodeData->getAvailable()) {
-                        packetsSentThisInterval += handlePacketSend(nodeData, trueBytesSent, truePacketsSent);
+                        nodeData->writeToPacket(_packetData.getFinalizedData(), _packetData.getFinalizedSize());
                     }
-
-                    nodeData->writeToPacket(_packetData.getFinalizedData(), _packetData.getFinalizedSize());
-                    extraPackingAttempts = 0;
                     quint64 compressAndWriteEnd = usecTimestampNow();
                     compressAndWriteElapsedUsec = (float)(compressAndWriteEnd - compressAndWriteStart);
                 }
 
                 // If we're not running compressed, then we know we can just send now. Or if we're running compressed, but
-                // the packet doesn't have enough space to bother attempting to pack more...
+                // the packet doesn't have enough space to bother attempting to pack more... Sections are cut at the size
+                // predicted to fill the packet, so space is mostly left when the content compressed better than predicted.
+                // We keep packing sections into it while that is the case.
                 bool sendNow = true;
                 
                 if (nodeData->getCurrentPacketIsCompressed() &&
                     nodeData->getAvailable() >= MINIMUM_ATTEMPT_MORE_PACKING &&
-                    extraPackingAttempts <= REASONABLE_NUMBER_OF_PACKING_ATTEMPTS) {
+                    extraPackingAttempts < REASONABLE_NUMBER_OF_PACKING_ATTEMPTS) {
                     sendNow = false; // try to pack more
+                    extraPackingAttempts++;
                 }
 
-                int targetSize = MAX_OCTREE_PACKET_DATA_SIZE;
                 if (sendNow) {
                     quint64 packetSendingStart = usecTimestampNow();
                     packetsSentThisInterval += handlePacketSend(nodeData, trueBytesSent, truePacketsSent);
                     quint64 packetSendingEnd = usecTimestampNow();
                     packetSendingElapsedUsec = (float)(packetSendingEnd - packetSendingStart);
-
-                    if (wantCompression) {
-                        targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
-                    }
-                } else {
-                    // If we're in compressed mode, then we want to see if we have room for more in this wire packet.
-                    // but we've finalized the _packetData, so we want to start a new section, we will do that by
-                    // resetting the packet settings with the max uncompressed size of our current available space
-                    // in the wire packet. We also include room for our section header, and a little bit of padding
-                    // to account for the fact that whenc compressing small amounts of data, we sometimes end up with
-                    // a larger compressed size then uncompressed size
-                    targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) - COMPRESS_PADDING;
+                    extraPackingAttempts = 0;
                 }
-                _packetData.changeSettings(nodeData->getWantCompression(), targetSize); // will do reset
+
+                // If we're in compressed mode, then we start a new section, either in the new wire packet or in what is
+                // left of this one.
+                startSection(nodeData, nodeData->getWantCompression(), compressionCodec);
 
             }
             OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
@@ -583,8 +631,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         }
 
         quint64 end = usecTimestampNow();
-        int elapsedmsec = (end - start)/USECS_PER_MSEC;
-        OctreeServer::trackLoopTime(elapsedmsec);
+        OctreeServer::trackLoopTime((float)(end - start));
 
         // TODO: add these to stats page
         //quint64 endCompressCalls = OctreePacketData::getCompressContentCalls();
@@ -598,6 +645,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             nodeData->updateLastKnownViewFrustum();
             nodeData->setViewSent(true);
             nodeData->map.erase(); // It would be nice if we could save this, and only reset it when the view frustum changes
+            nodeData->occlusionBuffer.erase();
         }
 
     } // end if bag wasn't empty, and so we sent stuff...
@@ -14,7 +14,10 @@
 #ifndef hifi_OctreeSendThread_h
 #define hifi_OctreeSendThread_h
 
+#include <QtCore/QVector>
+
 #include <GenericThread.h>
+#include <Metrics.h>
 #include <NetworkPacket.h>
 #include <OctreeElementBag.h>
 
@@ -35,8 +38,7 @@ public:
     static quint64 _totalWastedBytes;
     static quint64 _totalPackets;
 
-    static quint64 _usleepTime;
-    static quint64 _usleepCalls;
+    static MetricHistogram _usleepTime;
 
 protected:
     /// Implements generic processing behavior for this thread.
@@ -50,8 +52,11 @@ private:
 
     int handlePacketSend(OctreeQueryNode* nodeData, int& trueBytesSent, int& truePacketsSent);
     int packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged);
+    void startSection(OctreeQueryNode* nodeData, bool wantCompression, OctreePacketCompressionCodec compressionCodec);
+    void encodeSectionAgain(OctreeQueryNode* nodeData);
 
     OctreePacketData _packetData;
+    QVector<OctreeElementHandle> _sectionSubTrees; // the subtrees encoded into _packetData, see encodeSectionAgain()
     
     int _nodeMissingCount;
     bool _isShuttingDown;
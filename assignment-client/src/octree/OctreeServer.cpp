@@ -19,6 +19,8 @@
 #include <AccountManager.h>
 #include <HTTPConnection.h>
 #include <Logging.h>
+#include <OctreeElementPool.h>
+#include <OctreePacketCompressor.h>
 #include <UUID.h>
 
 #include "../AssignmentClient.h"
@@ -28,185 +30,137 @@
 
 OctreeServer* OctreeServer::_instance = NULL;
 int OctreeServer::_clientCount = 0;
-const int MOVING_AVERAGE_SAMPLE_COUNTS = 1000000;
 
 float OctreeServer::SKIP_TIME = -1.0f; // use this for trackXXXTime() calls for non-times
 
-SimpleMovingAverage OctreeServer::_averageLoopTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageInsideTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-
-SimpleMovingAverage OctreeServer::_averageEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageShortEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageLongEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageExtraLongEncodeTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongEncode = 0;
-int OctreeServer::_longEncode = 0;
-int OctreeServer::_shortEncode = 0;
-int OctreeServer::_noEncode = 0;
-
-SimpleMovingAverage OctreeServer::_averageTreeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageTreeExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongTreeWait = 0;
-int OctreeServer::_longTreeWait = 0;
-int OctreeServer::_shortTreeWait = 0;
-int OctreeServer::_noTreeWait = 0;
-
-SimpleMovingAverage OctreeServer::_averageNodeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-
-SimpleMovingAverage OctreeServer::_averageCompressAndWriteTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageShortCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageLongCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageExtraLongCompressTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongCompress = 0;
-int OctreeServer::_longCompress = 0;
-int OctreeServer::_shortCompress = 0;
-int OctreeServer::_noCompress = 0;
-
-SimpleMovingAverage OctreeServer::_averagePacketSendingTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_noSend = 0;
-
-SimpleMovingAverage OctreeServer::_averageProcessWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-SimpleMovingAverage OctreeServer::_averageProcessExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
-int OctreeServer::_extraLongProcessWait = 0;
-int OctreeServer::_longProcessWait = 0;
-int OctreeServer::_shortProcessWait = 0;
-int OctreeServer::_noProcessWait = 0;
+MetricHistogram OctreeServer::_loopTime("octree-server/loop_usecs");
+MetricHistogram OctreeServer::_insideTime("octree-server/inside_usecs");
 
+MetricHistogram OctreeServer::_encodeTime("octree-server/encode_usecs");
+MetricCounter OctreeServer::_noEncode("octree-server/noEncode");
+
+MetricHistogram OctreeServer::_treeWaitTime("octree-server/treeWait_usecs");
+MetricCounter OctreeServer::_noTreeWait("octree-server/noTreeWait");
+
+MetricHistogram OctreeServer::_nodeWaitTime("octree-server/nodeWait_usecs");
+
+MetricHistogram OctreeServer::_compressAndWriteTime("octree-server/compressAndWrite_usecs");
+MetricCounter OctreeServer::_noCompress("octree-server/noCompress");
+
+MetricHistogram OctreeServer::_packetSendingTime("octree-server/packetSending_usecs");
+MetricCounter OctreeServer::_noSend("octree-server/noSend");
+
+MetricHistogram OctreeServer::_processWaitTime("octree-server/processWait_usecs");
+MetricCounter OctreeServer::_noProcessWait("octree-server/noProcessWait");
+
+MetricHistogramWindow OctreeServer::_loopTimeWindow(_loopTime, TIME_STATS_WINDOW_SECONDS);
+MetricHistogramWindow OctreeServer::_insideTimeWindow(_insideTime, TIME_STATS_WINDOW_SECONDS);
+MetricHistogramWindow OctreeServer::_encodeTimeWindow(_encodeTime, TIME_STATS_WINDOW_SECONDS);
+MetricHistogramWindow OctreeServer::_treeWaitTimeWindow(_treeWaitTime, TIME_STATS_WINDOW_SECONDS);
+MetricHistogramWindow OctreeServer::_nodeWaitTimeWindow(_nodeWaitTime, TIME_STATS_WINDOW_SECONDS);
+MetricHistogramWindow OctreeServer::_compressAndWriteTimeWindow(_compressAndWriteTime, TIME_STATS_WINDOW_SECONDS);
+MetricHistogramWindow OctreeServer::_packetSendingTimeWindow(_packetSendingTime, TIME_STATS_WINDOW_SECONDS);
+MetricHistogramWindow OctreeServer::_processWaitTimeWindow(_processWaitTime, TIME_STATS_WINDOW_SECONDS);
 
 void OctreeServer::resetSendingStats() {
-    _averageLoopTime.reset();
-
-    _averageEncodeTime.reset();
-    _averageShortEncodeTime.reset();
-    _averageLongEncodeTime.reset();
-    _averageExtraLongEncodeTime.reset();
-    _extraLongEncode = 0;
-    _longEncode = 0;
-    _shortEncode = 0;
-    _noEncode = 0;
-
-    _averageInsideTime.reset();
-    _averageTreeWaitTime.reset();
-    _averageTreeShortWaitTime.reset();
-    _averageTreeLongWaitTime.reset();
-    _averageTreeExtraLongWaitTime.reset();
-    _extraLongTreeWait = 0;
-    _longTreeWait = 0;
-    _shortTreeWait = 0;
-    _noTreeWait = 0;
-
-    _averageNodeWaitTime.reset();
-
-    _averageCompressAndWriteTime.reset();
-    _averageShortCompressTime.reset();
-    _averageLongCompressTime.reset();
-    _averageExtraLongCompressTime.reset();
-    _extraLongCompress = 0;
-    _longCompress = 0;
-    _shortCompress = 0;
-    _noCompress = 0;
-
-    _averagePacketSendingTime.reset();
-    _noSend = 0;
-
-    _averageProcessWaitTime.reset();
-    _averageProcessShortWaitTime.reset();
-    _averageProcessLongWaitTime.reset();
-    _averageProcessExtraLongWaitTime.reset();
-    _extraLongProcessWait = 0;
-    _longProcessWait = 0;
-    _shortProcessWait = 0;
-    _noProcessWait = 0;
+    Metrics::resetAll(getMetricsPrefix());
+    clearTimeStatsWindows();
 }
 
-void OctreeServer::trackEncodeTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
+void OctreeServer::endTimeStatsIntervals() {
+    _loopTimeWindow.endInterval();
+    _insideTimeWindow.endInterval();
+    _encodeTimeWindow.endInterval();
+    _treeWaitTimeWindow.endInterval();
+    _nodeWaitTimeWindow.endInterval();
+    _compressAndWriteTimeWindow.endInterval();
+    _packetSendingTimeWindow.endInterval();
+    _processWaitTimeWindow.endInterval();
+}
 
-    if (time == SKIP_TIME) {
-        _noEncode++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortEncode++;
-        _averageShortEncodeTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longEncode++;
-        _averageLongEncodeTime.updateAverage(time);
-    } else {
-        _extraLongEncode++;
-        _averageExtraLongEncodeTime.updateAverage(time);
-    }
-    _averageEncodeTime.updateAverage(time); 
+void OctreeServer::clearTimeStatsWindows() {
+    _loopTimeWindow.clear();
+    _insideTimeWindow.clear();
+    _encodeTimeWindow.clear();
+    _treeWaitTimeWindow.clear();
+    _nodeWaitTimeWindow.clear();
+    _compressAndWriteTimeWindow.clear();
+    _packetSendingTimeWindow.clear();
+    _processWaitTimeWindow.clear();
 }
 
-void OctreeServer::trackTreeWaitTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noTreeWait++;
+// skipped times are counted, and recorded as zero so that they're in the averages
+static void trackTime(MetricHistogram& times, MetricCounter& skips, float time) {
+    if (time == OctreeServer::SKIP_TIME) {
+        skips.increment();
         time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortTreeWait++;
-        _averageTreeShortWaitTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longTreeWait++;
-        _averageTreeLongWaitTime.updateAverage(time);
-    } else {
-        _extraLongTreeWait++;
-        _averageTreeExtraLongWaitTime.updateAverage(time);
     }
-    _averageTreeWaitTime.updateAverage(time);
+    times.record((int)time);
 }
 
-void OctreeServer::trackCompressAndWriteTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noCompress++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortCompress++;
-        _averageShortCompressTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longCompress++;
-        _averageLongCompressTime.updateAverage(time);
-    } else {
-        _extraLongCompress++;
-        _averageExtraLongCompressTime.updateAverage(time);
-    }
-    _averageCompressAndWriteTime.updateAverage(time); 
+void OctreeServer::trackEncodeTime(float time) {
+    trackTime(_encodeTime, _noEncode, time);
 }
 
-void OctreeServer::trackPacketSendingTime(float time) { 
-    if (time == SKIP_TIME) {
-        _noSend++;
-        time = 0.0f;
-    }
-    _averagePacketSendingTime.updateAverage(time); 
+void OctreeServer::trackTreeWaitTime(float time) {
+    trackTime(_treeWaitTime, _noTreeWait, time);
 }
 
+void OctreeServer::trackCompressAndWriteTime(float time) {
+    trackTime(_compressAndWriteTime, _noCompress, time);
+}
 
-void OctreeServer::trackProcessWaitTime(float time) { 
-    const float MAX_SHORT_TIME = 10.0f;
-    const float MAX_LONG_TIME = 100.0f;
-    if (time == SKIP_TIME) {
-        _noProcessWait++;
-        time = 0.0f;
-    } else if (time <= MAX_SHORT_TIME) {
-        _shortProcessWait++;
-        _averageProcessShortWaitTime.updateAverage(time);
-    } else if (time <= MAX_LONG_TIME) {
-        _longProcessWait++;
-        _averageProcessLongWaitTime.updateAverage(time);
-    } else {
-        _extraLongProcessWait++;
-        _averageProcessExtraLongWaitTime.updateAverage(time);
+void OctreeServer::trackPacketSendingTime(float time) {
+    trackTime(_packetSendingTime, _noSend, time);
+}
+
+void OctreeServer::trackProcessWaitTime(float time) {
+    trackTime(_processWaitTime, _noProcessWait, time);
+}
+
+// the lines of the status page for a time that is short up to 10 usecs, long up to 100 and extra long beyond that
+static QString getBandedTimeStatsString(const QString& averageLabel, const QString& skipLabel, const QString& bandLabel,
+                                        MetricHistogram& times, MetricCounter& skips) {
+    const int LABEL_WIDTH = 36;
+    const int MAX_SHORT_TIME = 10;
+    const int MAX_LONG_TIME = 100;
+    const float AS_PERCENT = 100.0f;
+
+    MetricHistogramSnapshot snapshot = times.getSnapshot();
+    qint64 allTimes = snapshot.getCount();
+    qint64 numSkips = skips.getValue();
+
+    QString statsString;
+    statsString += QString().sprintf("%s:    %9.2f usecs                 samples: %12lld \r\n",
+                                     qPrintable(averageLabel.rightJustified(LABEL_WIDTH)), snapshot.getMean(), allTimes);
+
+    float skipsVsTotal = (allTimes > 0) ? ((float)numSkips / (float)allTimes) : 0.0f;
+    statsString += QString().sprintf("%s:                          (%6.2f%%) samples: %12lld \r\n",
+                                     qPrintable(skipLabel.rightJustified(LABEL_WIDTH)), skipsVsTotal * AS_PERCENT, numSkips);
+
+    // the skipped times were recorded as zero, so they're in the count but not the sum of the short times
+    const char* BAND_NAMES[] = { "short", "long", "extra long" };
+    int bandBounds[] = { -1, MAX_SHORT_TIME, MAX_LONG_TIME, snapshot.bounds.last() };
+    for (int i = 0; i < 3; ++i) {
+        qint64 bandTimes = snapshot.getCount(bandBounds[i], bandBounds[i + 1]);
+        qint64 bandSum = snapshot.getSum(bandBounds[i], bandBounds[i + 1]);
+        if (i == 0) {
+            bandTimes = qMax(bandTimes - numSkips, (qint64)0);
+        } else if (i == 2) {
+            bandTimes += snapshot.counts.last();
+            bandSum += snapshot.sums.last();
+        }
+        float bandAverage = (bandTimes > 0) ? ((float)bandSum / (float)bandTimes) : 0.0f;
+        float bandVsTotal = (allTimes > 0) ? ((float)bandTimes / (float)allTimes) : 0.0f;
+        statsString += QString().sprintf("%s:          %9.2f usecs (%6.2f%%) samples: %12lld \r\n",
+                                         qPrintable(bandLabel.arg(BAND_NAMES[i]).rightJustified(LABEL_WIDTH)),
+                                         bandAverage, bandVsTotal * AS_PERCENT, bandTimes);
     }
-    _averageProcessWaitTime.updateAverage(time);
+    statsString += QString().sprintf("%s:    p50: %d p90: %d p99: %d max: %d usecs\r\n\r\n",
+                                     qPrintable(QString("Percentiles").rightJustified(LABEL_WIDTH)),
+                                     snapshot.getPercentile(0.5f), snapshot.getPercentile(0.9f),
+                                     snapshot.getPercentile(0.99f), snapshot.max);
+    return statsString;
 }
 
 void OctreeServer::attachQueryNodeToNode(Node* newNode) {
@@ -231,8 +185,11 @@ OctreeServer::OctreeServer(const QByteArray& packet) :
     _debugSending(false),
     _debugReceiving(false),
     _verboseDebug(false),
+    _wantOcclusionBuffer(false),
+    _wantSendByPriority(false),
     _jurisdiction(NULL),
     _jurisdictionSender(NULL),
+    _jurisdictionManager(NULL),
     _octreeInboundPacketProcessor(NULL),
     _persistThread(NULL),
     _started(time(0)),
@@ -245,7 +202,6 @@ OctreeServer::OctreeServer(const QByteArray& packet) :
     qDebug() << "Octree Server starting... setting _instance to=[" << this << "]";
     _instance = this;
 
-    _averageLoopTime.updateAverage(0);
     qDebug() << "Octree server starting... [" << this << "]";
     
     // make sure the AccountManager has an Auth URL for payment redemptions
@@ -262,6 +218,11 @@ OctreeServer::~OctreeServer() {
         delete[] _parsedArgV;
     }
 
+    if (_jurisdictionManager) {
+        _jurisdictionManager->terminate();
+        _jurisdictionManager->deleteLater();
+    }
+
     if (_jurisdictionSender) {
         _jurisdictionSender->terminate();
         _jurisdictionSender->deleteLater();
@@ -330,6 +291,12 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             _octreeInboundPacketProcessor->resetStats();
             resetSendingStats();
             showStats = true;
+        } else if (url.path() == "/metrics") {
+            // every metric of the assignment, as in the stats it sends to the domain server
+            QJsonObject metricsObject;
+            Metrics::addToStats(metricsObject, Metrics::getNames(getMetricsPrefix()));
+            connection->respond(HTTPConnection::StatusCode200, QJsonDocument(metricsObject).toJson(), "application/json");
+            return true;
         }
     }
 
@@ -395,6 +362,11 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         unsigned long internalNodeCount = OctreeElement::getInternalNodeCount();
         unsigned long leafNodeCount = OctreeElement::getLeafNodeCount();
 
+        if (_jurisdictionManager) {
+            statsString += _jurisdictionManager->getStatusString();
+            statsString += "\r\n";
+        }
+
         statsString += "<b>Current Elements in scene:</b>\r\n";
         statsString += QString("       Total Elements: %1 nodes\r\n")
             .arg(locale.toString((uint)nodeCount).rightJustified(16, ' '));
@@ -405,6 +377,7 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString().sprintf("        Leaf Elements: %s nodes (%5.2f%%)\r\n",
                                          locale.toString((uint)leafNodeCount).rightJustified(16, ' ').toLocal8Bit().constData(),
                                          ((float)leafNodeCount / (float)nodeCount) * AS_PERCENT);
+        statsString += getTreeStatusString();
         statsString += "\r\n";
         statsString += "\r\n";
 
@@ -433,155 +406,66 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("      writeDatagram() last second: %1 clients\r\n\r\n")
             .arg(locale.toString((uint)howManyThreadsDidCallWriteDatagram(oneSecondAgo)).rightJustified(COLUMN_WIDTH, ' '));
 
-        float averageLoopTime = getAverageLoopTime();
+        MetricHistogramSnapshot loopTimes = _loopTime.getSnapshot();
         statsString += QString().sprintf("           Average packetLoop() time:      %7.2f msecs"
-                                         "                 samples: %12d \r\n", 
-                                         averageLoopTime, _averageLoopTime.getSampleCount());
+                                         "                 samples: %12lld \r\n", 
+                                         loopTimes.getMean() / USECS_PER_MSEC, loopTimes.getCount());
 
-        float averageInsideTime = getAverageInsideTime();
+        MetricHistogramSnapshot insideTimes = _insideTime.getSnapshot();
+        float averageInsideTime = insideTimes.getMean();
         statsString += QString().sprintf("               Average 'inside' time:    %9.2f usecs"
-                                         "                 samples: %12d \r\n\r\n", 
-                                         averageInsideTime, _averageInsideTime.getSampleCount());
-
-
-        // Process Wait
-        {
-            int allWaitTimes = _extraLongProcessWait +_longProcessWait + _shortProcessWait + _noProcessWait;
-
-            float averageProcessWaitTime = getAverageProcessWaitTime();
-            statsString += QString().sprintf("      Average process lock wait time:"
-                                             "    %9.2f usecs                 samples: %12d \r\n",
-                                             averageProcessWaitTime, allWaitTimes);
-
-            float zeroVsTotal = (allWaitTimes > 0) ? ((float)_noProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("                        No Lock Wait:"
-                                             "                          (%6.2f%%) samples: %12d \r\n",
-                                             zeroVsTotal * AS_PERCENT, _noProcessWait);
-
-            float shortVsTotal = (allWaitTimes > 0) ? ((float)_shortProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("    Avg process lock short wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                             _averageProcessShortWaitTime.getAverage(), 
-                                             shortVsTotal * AS_PERCENT, _shortProcessWait);
-
-            float longVsTotal = (allWaitTimes > 0) ? ((float)_longProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("     Avg process lock long wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                             _averageProcessLongWaitTime.getAverage(), 
-                                             longVsTotal * AS_PERCENT, _longProcessWait);
-
-            float extraLongVsTotal = (allWaitTimes > 0) ? ((float)_extraLongProcessWait / (float)allWaitTimes) : 0.0f;
-            statsString += QString().sprintf("Avg process lock extralong wait time:"
-                                             "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                             _averageProcessExtraLongWaitTime.getAverage(), 
-                                             extraLongVsTotal * AS_PERCENT, _extraLongProcessWait);
-        }
+                                         "                 samples: %12lld \r\n\r\n", 
+                                         averageInsideTime, insideTimes.getCount());
 
-        // Tree Wait
-        int allWaitTimes = _extraLongTreeWait +_longTreeWait + _shortTreeWait + _noTreeWait;
+        statsString += getBandedTimeStatsString("Average process lock wait time", "No Lock Wait",
+                                                "Avg process lock %1 wait time", _processWaitTime, _noProcessWait);
 
         float averageTreeWaitTime = getAverageTreeWaitTime();
-        statsString += QString().sprintf("         Average tree lock wait time:"
-                                         "    %9.2f usecs                 samples: %12d \r\n",
-                                         averageTreeWaitTime, allWaitTimes);
-
-        float zeroVsTotal = (allWaitTimes > 0) ? ((float)_noTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("                        No Lock Wait:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         zeroVsTotal * AS_PERCENT, _noTreeWait);
-
-        float shortVsTotal = (allWaitTimes > 0) ? ((float)_shortTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("       Avg tree lock short wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageTreeShortWaitTime.getAverage(), 
-                                         shortVsTotal * AS_PERCENT, _shortTreeWait);
-
-        float longVsTotal = (allWaitTimes > 0) ? ((float)_longTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("        Avg tree lock long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageTreeLongWaitTime.getAverage(), 
-                                         longVsTotal * AS_PERCENT, _longTreeWait);
-
-        float extraLongVsTotal = (allWaitTimes > 0) ? ((float)_extraLongTreeWait / (float)allWaitTimes) : 0.0f;
-        statsString += QString().sprintf("  Avg tree lock extra long wait time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         _averageTreeExtraLongWaitTime.getAverage(), 
-                                         extraLongVsTotal * AS_PERCENT, _extraLongTreeWait);
-
-        // encode
-        float averageEncodeTime = getAverageEncodeTime();
-        statsString += QString().sprintf("                 Average encode time:    %9.2f usecs\r\n", averageEncodeTime);
-        
-        int allEncodeTimes = _noEncode + _shortEncode + _longEncode + _extraLongEncode;
-
-        float zeroVsTotalEncode = (allEncodeTimes > 0) ? ((float)_noEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("                           No Encode:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         zeroVsTotalEncode * AS_PERCENT, _noEncode);
-
-        float shortVsTotalEncode = (allEncodeTimes > 0) ? ((float)_shortEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("               Avg short encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageShortEncodeTime.getAverage(), 
-                                         shortVsTotalEncode * AS_PERCENT, _shortEncode);
-
-        float longVsTotalEncode = (allEncodeTimes > 0) ? ((float)_longEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("                Avg long encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageLongEncodeTime.getAverage(), 
-                                         longVsTotalEncode * AS_PERCENT, _longEncode);
-
-        float extraLongVsTotalEncode = (allEncodeTimes > 0) ? ((float)_extraLongEncode / (float)allEncodeTimes) : 0.0f;
-        statsString += QString().sprintf("          Avg extra long encode time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         _averageExtraLongEncodeTime.getAverage(), 
-                                         extraLongVsTotalEncode * AS_PERCENT, _extraLongEncode);
+        statsString += getBandedTimeStatsString("Average tree lock wait time", "No Lock Wait",
+                                                "Avg tree lock %1 wait time", _treeWaitTime, _noTreeWait);
 
+        float averageEncodeTime = getAverageEncodeTime();
+        statsString += getBandedTimeStatsString("Average encode time", "No Encode",
+                                                "Avg %1 encode time", _encodeTime, _noEncode);
 
         float averageCompressAndWriteTime = getAverageCompressAndWriteTime();
-        statsString += QString().sprintf("     Average compress and write time:    %9.2f usecs\r\n", 
-            averageCompressAndWriteTime);
-
-        int allCompressTimes = _noCompress + _shortCompress + _longCompress + _extraLongCompress;
-
-        float zeroVsTotalCompress = (allCompressTimes > 0) ? ((float)_noCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("                      No compression:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         zeroVsTotalCompress * AS_PERCENT, _noCompress);
-
-        float shortVsTotalCompress = (allCompressTimes > 0) ? ((float)_shortCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("             Avg short compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageShortCompressTime.getAverage(), 
-                                         shortVsTotalCompress * AS_PERCENT, _shortCompress);
-
-        float longVsTotalCompress = (allCompressTimes > 0) ? ((float)_longCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("              Avg long compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n",
-                                         _averageLongCompressTime.getAverage(), 
-                                         longVsTotalCompress * AS_PERCENT, _longCompress);
-
-        float extraLongVsTotalCompress = (allCompressTimes > 0) ? ((float)_extraLongCompress / (float)allCompressTimes) : 0.0f;
-        statsString += QString().sprintf("        Avg extra long compress time:"
-                                         "          %9.2f usecs (%6.2f%%) samples: %12d \r\n\r\n",
-                                         _averageExtraLongCompressTime.getAverage(), 
-                                         extraLongVsTotalCompress * AS_PERCENT, _extraLongCompress);
-
-        float averagePacketSendingTime = getAveragePacketSendingTime();
+        statsString += getBandedTimeStatsString("Average compress and write time", "No compression",
+                                                "Avg %1 compress time", _compressAndWriteTime, _noCompress);
+
+        const OctreePacketCompressionCodec CODECS[] = { ZLIB_PACKET_COMPRESSION, FAST_LZ_PACKET_COMPRESSION };
+        for (size_t i = 0; i < sizeof(CODECS) / sizeof(CODECS[0]); i++) {
+            OctreePacketCompressor* compressor = OctreePacketCompressor::getCompressor(CODECS[i]);
+            quint64 compressCalls = compressor->getCompressCalls();
+            float averageCompressTime = (compressCalls > 0) ? ((float)compressor->getCompressTime() / compressCalls) : 0.0f;
+            float compressionRatio = (compressor->getUncompressedBytes() > 0)
+                ? ((float)compressor->getCompressedBytes() / (float)compressor->getUncompressedBytes()) : 0.0f;
+            statsString += QString().sprintf("%25s compressor: %9.2f usecs ratio: %5.2f%% calls: %12llu failed: %llu\r\n",
+                                             compressor->getName(), averageCompressTime, compressionRatio * AS_PERCENT,
+                                             compressCalls, compressor->getFailedCompressCalls());
+        }
+        statsString += "\r\n";
+
+        MetricHistogramSnapshot packetSendingTimes = _packetSendingTime.getSnapshot();
+        float averagePacketSendingTime = packetSendingTimes.getMean();
         statsString += QString().sprintf("         Average packet sending time:    %9.2f usecs (includes node lock)\r\n", 
                                         averagePacketSendingTime);
 
-        float noVsTotalSend = (_averagePacketSendingTime.getSampleCount() > 0) ? 
-                                        ((float)_noSend / (float)_averagePacketSendingTime.getSampleCount()) : 0.0f;
+        qint64 numNoSends = _noSend.getValue();
+        float noVsTotalSend = (packetSendingTimes.getCount() > 0) ? 
+                                        ((float)numNoSends / (float)packetSendingTimes.getCount()) : 0.0f;
         statsString += QString().sprintf("                         Not sending:"
-                                         "                          (%6.2f%%) samples: %12d \r\n",
-                                         noVsTotalSend * AS_PERCENT, _noSend);
+                                         "                          (%6.2f%%) samples: %12lld \r\n",
+                                         noVsTotalSend * AS_PERCENT, numNoSends);
                                         
-        float averageNodeWaitTime = getAverageNodeWaitTime();
-        statsString += QString().sprintf("         Average node lock wait time:    %9.2f usecs\r\n", averageNodeWaitTime);
+        statsString += QString().sprintf("         Average node lock wait time:    %9.2f usecs\r\n",
+                                         _nodeWaitTime.getSnapshot().getMean());
 
         statsString += QString().sprintf("--------------------------------------------------------------\r\n");
 
+        // the lines above are over the server's lifetime, but the ratios are of the recent times
+        averageInsideTime = getAverageInsideTime();
+        averagePacketSendingTime = getAveragePacketSendingTime();
+        float averageNodeWaitTime = getAverageNodeWaitTime();
         float encodeToInsidePercent = averageInsideTime == 0.0f ? 0.0f : (averageEncodeTime / averageInsideTime) * AS_PERCENT;
         statsString += QString().sprintf("                          encode ratio:      %5.2f%%\r\n", 
                                         encodeToInsidePercent);
@@ -721,6 +605,21 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          OctreeElement::getTotalMemoryUsage() / memoryScale, memoryScaleLabel);
         statsString += "\r\n";
 
+        statsString += "Element Pool Statistics...\r\n";
+        std::vector<OctreeElementPool*> pools = OctreeElementPool::getPools();
+        for (size_t i = 0; i < pools.size(); i++) {
+            OctreeElementPool* pool = pools[i];
+            statsString += QString("    %1 (%2 bytes each)\r\n").arg(pool->getName()).arg(pool->getItemSize());
+            statsString += QString("        Live: %1  Free: %2  Slabs: %3  Allocations: %4\r\n")
+                .arg(locale.toString((uint)pool->getLiveCount()).rightJustified(COLUMN_WIDTH, ' '))
+                .arg(locale.toString((uint)pool->getFreeCount()).rightJustified(COLUMN_WIDTH, ' '))
+                .arg(locale.toString((uint)pool->getSlabCount()).rightJustified(COLUMN_WIDTH, ' '))
+                .arg(locale.toString((uint)pool->getAllocationCount()).rightJustified(COLUMN_WIDTH, ' '));
+        }
+        statsString += QString().sprintf("                Reserved:        %8.2f %s\r\n",
+                                         OctreeElementPool::getTotalReservedMemory() / memoryScale, memoryScaleLabel);
+        statsString += "\r\n";
+
         statsString += "OctreeElement Children Population Statistics...\r\n";
         checkSum = 0;
         for (int i=0; i <= NUMBER_OF_CHILDREN; i++) {
@@ -774,6 +673,10 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          OctreeElement::getCouldNotStoreFourChildrenInternally());
 #endif
 
+        statsString += "\r\n\r\n";
+        statsString += "<b>Metrics... <a href='/metrics'>[JSON]</a></b>\r\n";
+        statsString += Metrics::getStatsString(getMetricsPrefix());
+
         statsString += "\r\n\r\n";
         statsString += "</pre>\r\n";
         statsString += "</doc></html>";
@@ -917,6 +820,7 @@ void OctreeServer::run() {
     const char* jurisdictionFile = getCmdOption(_argc, _argv, JURISDICTION_FILE);
     if (jurisdictionFile) {
         qDebug("jurisdictionFile=%s", jurisdictionFile);
+        _jurisdictionFile = jurisdictionFile;
 
         qDebug("about to readFromFile().... jurisdictionFile=%s", jurisdictionFile);
         _jurisdiction = new JurisdictionMap(jurisdictionFile);
@@ -969,6 +873,16 @@ void OctreeServer::run() {
     _debugReceiving =  cmdOptionExists(_argc, _argv, DEBUG_RECEIVING);
     qDebug("debugReceiving=%s", debug::valueOf(_debugReceiving));
 
+    // clients that ask for occlusion culling get the hierarchical occlusion buffer instead of the coverage map
+    const char* OCCLUSION_BUFFER = "--occlusionBuffer";
+    _wantOcclusionBuffer = cmdOptionExists(_argc, _argv, OCCLUSION_BUFFER);
+    qDebug("wantOcclusionBuffer=%s", debug::valueOf(_wantOcclusionBuffer));
+
+    // send the elements that look biggest to each client first, instead of in whatever order they come out of the bag
+    const char* SEND_BY_PRIORITY = "--sendByPriority";
+    _wantSendByPriority = cmdOptionExists(_argc, _argv, SEND_BY_PRIORITY);
+    qDebug("wantSendByPriority=%s", debug::valueOf(_wantSendByPriority));
+
     // By default we will persist, if you want to disable this, then pass in this parameter
     const char* NO_PERSIST = "--NoPersist";
     if (cmdOptionExists(_argc, _argv, NO_PERSIST)) {
@@ -1041,6 +955,10 @@ void OctreeServer::run() {
     _jurisdictionSender = new JurisdictionSender(_jurisdiction, getMyNodeType());
     _jurisdictionSender->initialize(true);
 
+    // watch the load on our jurisdiction, and pick up changes to the jurisdiction file
+    _jurisdictionManager = new JurisdictionManager(this);
+    _jurisdictionManager->initialize(true);
+
     // set up our OctreeServerPacketProcessor
     _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(this);
     _octreeInboundPacketProcessor->initialize(true);
@@ -1059,6 +977,24 @@ void OctreeServer::run() {
     qDebug() << "Now running... started at: " << localBuffer << utcBuffer;
 }
 
+void OctreeServer::setJurisdiction(JurisdictionMap* jurisdiction) {
+    jurisdiction->setNodeType(getMyNodeType());
+
+    // the send threads only look at the map while they hold the tree's read lock
+    _tree->lockForWrite();
+    JurisdictionMap* oldJurisdiction = _jurisdiction;
+    _jurisdiction = jurisdiction;
+    _tree->unlock();
+
+    // the sender swaps maps under its own lock, after which nothing refers to the old one
+    _jurisdictionSender->setJurisdiction(jurisdiction);
+    _jurisdictionSender->broadcastJurisdiction();
+    delete oldJurisdiction;
+
+    qDebug() << qPrintable(_safeServerName) << "server jurisdiction changed...";
+    jurisdiction->displayDebugDetails();
+}
+
 void OctreeServer::nodeAdded(SharedNodePointer node) {
     // we might choose to use this notifier to track clients in a pending state
     qDebug() << qPrintable(_safeServerName) << "server added node:" << *node;
@@ -1265,6 +1201,8 @@ void OctreeServer::sendStatsPacket() {
     //    1) remember last state sent
     //    2) only send new data
     //    3) automatically break up into multiple packets
+    endTimeStatsIntervals();
+
     static QJsonObject statsObject1;
     
     QString baseName = getMyServerName() + QString("Server");
@@ -1290,6 +1228,7 @@ void OctreeServer::sendStatsPacket() {
     statsObject1[baseName + QString(".1.1.octree.elementCount")] = (double)OctreeElement::getNodeCount();
     statsObject1[baseName + QString(".1.2.octree.internalElementCount")] = (double)OctreeElement::getInternalNodeCount();
     statsObject1[baseName + QString(".1.3.octree.leafElementCount")] = (double)OctreeElement::getLeafNodeCount();
+    addTreeStats(statsObject1, baseName);
 
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject1);
 
@@ -20,13 +20,16 @@
 
 #include <ThreadedAssignment.h>
 #include <EnvironmentData.h>
+#include <Metrics.h>
 
+#include "JurisdictionManager.h"
 #include "OctreePersistThread.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
 
 const int DEFAULT_PACKETS_PER_INTERVAL = 2000; // some 120,000 packets per second total
+const int TIME_STATS_WINDOW_SECONDS = 30; // stats intervals end once a second, when the stats are sent
 
 /// Handles assignments of type OctreeServer - sending octrees to various clients.
 class OctreeServer : public ThreadedAssignment, public HTTPRequestHandler {
@@ -41,9 +44,17 @@ public:
     bool wantsDebugSending() const { return _debugSending; }
     bool wantsDebugReceiving() const { return _debugReceiving; }
     bool wantsVerboseDebug() const { return _verboseDebug; }
+    bool wantsOcclusionBuffer() const { return _wantOcclusionBuffer; }
+    bool wantsSendByPriority() const { return _wantSendByPriority; }
 
     Octree* getOctree() { return _tree; }
     JurisdictionMap* getJurisdiction() { return _jurisdiction; }
+    const QString& getJurisdictionFile() const { return _jurisdictionFile; }
+    JurisdictionManager* getJurisdictionManager() { return _jurisdictionManager; }
+
+    /// Replaces the jurisdiction while running, and tells the clients about it. Takes ownership of the map, and deletes the
+    /// old one, so getJurisdiction() is only safe to use while holding the tree's lock or on the thread that calls this.
+    void setJurisdiction(JurisdictionMap* jurisdiction);
 
     int getPacketsPerClientPerInterval() const { return std::min(_packetsPerClientPerInterval, 
                                 std::max(1, getPacketsTotalPerInterval() / std::max(1, getCurrentClientCount()))); }
@@ -74,34 +85,38 @@ public:
     virtual void beforeRun() { };
     virtual bool hasSpecialPacketToSend(const SharedNodePointer& node) { return false; }
     virtual int sendSpecialPacket(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent) { return 0; }
+    virtual QString getTreeStatusString() { return QString(); } // lines about the tree's content for the status page
+    virtual void addTreeStats(QJsonObject& statsObject, const QString& baseName) { }
 
     static void attachQueryNodeToNode(Node* newNode);
     
     static float SKIP_TIME; // use this for trackXXXTime() calls for non-times
 
-    static void trackLoopTime(float time) { _averageLoopTime.updateAverage(time); }
-    static float getAverageLoopTime() { return _averageLoopTime.getAverage(); }
+    // the times of the send threads, which can be tracked from any thread. The averages are of the last
+    // TIME_STATS_WINDOW_SECONDS of stats intervals, and are only for the server's own thread
+    static void trackLoopTime(float time) { _loopTime.record((int)time); } // usecs
+    static float getAverageLoopTime() { return _loopTimeWindow.getWindow().getMean() / USECS_PER_MSEC; } // msecs
 
     static void trackEncodeTime(float time);
-    static float getAverageEncodeTime() { return _averageEncodeTime.getAverage(); }
+    static float getAverageEncodeTime() { return _encodeTimeWindow.getWindow().getMean(); }
 
-    static void trackInsideTime(float time) { _averageInsideTime.updateAverage(time); }
-    static float getAverageInsideTime() { return _averageInsideTime.getAverage(); }
+    static void trackInsideTime(float time) { _insideTime.record((int)time); }
+    static float getAverageInsideTime() { return _insideTimeWindow.getWindow().getMean(); }
 
     static void trackTreeWaitTime(float time);
-    static float getAverageTreeWaitTime() { return _averageTreeWaitTime.getAverage(); }
+    static float getAverageTreeWaitTime() { return _treeWaitTimeWindow.getWindow().getMean(); }
 
-    static void trackNodeWaitTime(float time) { _averageNodeWaitTime.updateAverage(time); }
-    static float getAverageNodeWaitTime() { return _averageNodeWaitTime.getAverage(); }
+    static void trackNodeWaitTime(float time) { _nodeWaitTime.record((int)time); }
+    static float getAverageNodeWaitTime() { return _nodeWaitTimeWindow.getWindow().getMean(); }
 
     static void trackCompressAndWriteTime(float time);
-    static float getAverageCompressAndWriteTime() { return _averageCompressAndWriteTime.getAverage(); }
+    static float getAverageCompressAndWriteTime() { return _compressAndWriteTimeWindow.getWindow().getMean(); }
 
     static void trackPacketSendingTime(float time);
-    static float getAveragePacketSendingTime() { return _averagePacketSendingTime.getAverage(); }
+    static float getAveragePacketSendingTime() { return _packetSendingTimeWindow.getWindow().getMean(); }
 
     static void trackProcessWaitTime(float time);
-    static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
+    static float getAverageProcessWaitTime() { return _processWaitTimeWindow.getWindow().getMean(); }
     
     // these methods allow us to track which threads got to various states
     static void didProcess(OctreeSendThread* thread);
@@ -118,6 +133,7 @@ public:
     bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url);
 
     virtual void aboutToFinish();
+    virtual QString getMetricsPrefix() const { return "octree-server/"; }
     void forceNodeShutdown(SharedNodePointer node);
     
 public slots:
@@ -157,8 +173,12 @@ protected:
     bool _debugSending;
     bool _debugReceiving;
     bool _verboseDebug;
+    bool _wantOcclusionBuffer;
+    bool _wantSendByPriority;
     JurisdictionMap* _jurisdiction;
+    QString _jurisdictionFile;
     JurisdictionSender* _jurisdictionSender;
+    JurisdictionManager* _jurisdictionManager;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
 
@@ -169,50 +189,37 @@ protected:
     QString _safeServerName;
     
     static int _clientCount;
-    static SimpleMovingAverage _averageLoopTime;
-
-    static SimpleMovingAverage _averageEncodeTime;
-    static SimpleMovingAverage _averageShortEncodeTime;
-    static SimpleMovingAverage _averageLongEncodeTime;
-    static SimpleMovingAverage _averageExtraLongEncodeTime;
-    static int _extraLongEncode;
-    static int _longEncode;
-    static int _shortEncode;
-    static int _noEncode;
-
-    static SimpleMovingAverage _averageInsideTime;
-
-    static SimpleMovingAverage _averageTreeWaitTime;
-    static SimpleMovingAverage _averageTreeShortWaitTime;
-    static SimpleMovingAverage _averageTreeLongWaitTime;
-    static SimpleMovingAverage _averageTreeExtraLongWaitTime;
-    static int _extraLongTreeWait;
-    static int _longTreeWait;
-    static int _shortTreeWait;
-    static int _noTreeWait;
-
-    static SimpleMovingAverage _averageNodeWaitTime;
-
-    static SimpleMovingAverage _averageCompressAndWriteTime;
-    static SimpleMovingAverage _averageShortCompressTime;
-    static SimpleMovingAverage _averageLongCompressTime;
-    static SimpleMovingAverage _averageExtraLongCompressTime;
-    static int _extraLongCompress;
-    static int _longCompress;
-    static int _shortCompress;
-    static int _noCompress;
-
-    static SimpleMovingAverage _averagePacketSendingTime;
-    static int _noSend;
-
-    static SimpleMovingAverage _averageProcessWaitTime;
-    static SimpleMovingAverage _averageProcessShortWaitTime;
-    static SimpleMovingAverage _averageProcessLongWaitTime;
-    static SimpleMovingAverage _averageProcessExtraLongWaitTime;
-    static int _extraLongProcessWait;
-    static int _longProcessWait;
-    static int _shortProcessWait;
-    static int _noProcessWait;
+    static MetricHistogram _loopTime;
+    static MetricHistogram _insideTime;
+
+    static MetricHistogram _encodeTime;
+    static MetricCounter _noEncode;
+
+    static MetricHistogram _treeWaitTime;
+    static MetricCounter _noTreeWait;
+
+    static MetricHistogram _nodeWaitTime;
+
+    static MetricHistogram _compressAndWriteTime;
+    static MetricCounter _noCompress;
+
+    static MetricHistogram _packetSendingTime;
+    static MetricCounter _noSend;
+
+    static MetricHistogram _processWaitTime;
+    static MetricCounter _noProcessWait;
+
+    static void endTimeStatsIntervals();
+    static void clearTimeStatsWindows();
+
+    static MetricHistogramWindow _loopTimeWindow;
+    static MetricHistogramWindow _insideTimeWindow;
+    static MetricHistogramWindow _encodeTimeWindow;
+    static MetricHistogramWindow _treeWaitTimeWindow;
+    static MetricHistogramWindow _nodeWaitTimeWindow;
+    static MetricHistogramWindow _compressAndWriteTimeWindow;
+    static MetricHistogramWindow _packetSendingTimeWindow;
+    static MetricHistogramWindow _processWaitTimeWindow;
 
     static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
     static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
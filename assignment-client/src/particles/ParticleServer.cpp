@@ -9,7 +9,10 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QJsonObject>
+#include <QLocale>
 #include <QTimer>
+#include <ParticleScriptPool.h>
 #include <ParticleTree.h>
 
 #include "ParticleServer.h"
@@ -44,6 +47,79 @@ void ParticleServer::beforeRun() {
     connect(pruneDeletedParticlesTimer, SIGNAL(timeout()), this, SLOT(pruneDeletedParticles()));
     const int PRUNE_DELETED_PARTICLES_INTERVAL_MSECS = 1 * 1000; // once every second
     pruneDeletedParticlesTimer->start(PRUNE_DELETED_PARTICLES_INTERVAL_MSECS);
+
+    // update script time per update before updates are deferred, 0 to never defer them
+    const char* SCRIPT_BUDGET_USECS = "--scriptBudgetUsecs";
+    const char* scriptBudgetUsecs = getCmdOption(_argc, _argv, SCRIPT_BUDGET_USECS);
+    if (scriptBudgetUsecs) {
+        static_cast<ParticleTree*>(_tree)->setScriptBudgetUsecs(QString(scriptBudgetUsecs).toULongLong());
+    }
+    qDebug("scriptBudgetUsecs=%llu", static_cast<ParticleTree*>(_tree)->getScriptBudgetUsecs());
+}
+
+QString ParticleServer::getTreeStatusString() {
+    ParticleTree* tree = static_cast<ParticleTree*>(_tree);
+    QLocale locale(QLocale::English);
+
+    tree->lockForRead();
+    QHash<QString, ParticleScriptPool::ScriptStats> scriptStats = tree->getScriptStats();
+    quint64 scriptTickUsecs = tree->getLastScriptTickUsecs();
+    int deferredCount = tree->getLastDeferredScriptCount();
+    tree->unlock();
+
+    QString statusString = QString("       Script Budget: %1 usecs per update\r\n")
+        .arg(locale.toString(tree->getScriptBudgetUsecs()).rightJustified(16, ' '));
+    statusString += QString(" Last Update Scripts: %1 usecs, %2 deferred\r\n")
+        .arg(locale.toString(scriptTickUsecs).rightJustified(16, ' '))
+        .arg(locale.toString(deferredCount));
+    statusString += QString("    Particle Scripts: %1 scripts\r\n")
+        .arg(locale.toString(scriptStats.size()).rightJustified(16, ' '));
+
+    // scripts are only known by their source, so they are shown by its first line
+    const int MAX_SCRIPT_NAME_LENGTH = 40;
+    for (QHash<QString, ParticleScriptPool::ScriptStats>::const_iterator script = scriptStats.constBegin();
+            script != scriptStats.constEnd(); ++script) {
+        const ParticleScriptPool::ScriptStats& stats = script.value();
+        QString name = script.key().section('\n', 0, 0).simplified().left(MAX_SCRIPT_NAME_LENGTH);
+        quint64 calls = stats.updates + stats.collisions;
+        statusString += QString("            %1 updates: %2 collisions: %3 deferred: %4 "
+                                "average: %5 usecs max: %6 usecs\r\n")
+            .arg(name.leftJustified(MAX_SCRIPT_NAME_LENGTH, ' ').toHtmlEscaped())
+            .arg(locale.toString(stats.updates))
+            .arg(locale.toString(stats.collisions))
+            .arg(locale.toString(stats.deferredUpdates))
+            .arg(locale.toString(calls > 0 ? stats.usecs / calls : 0))
+            .arg(locale.toString(stats.maxUsecs));
+    }
+    return statusString;
+}
+
+void ParticleServer::addTreeStats(QJsonObject& statsObject, const QString& baseName) {
+    ParticleTree* tree = static_cast<ParticleTree*>(_tree);
+    quint64 updates = 0;
+    quint64 collisions = 0;
+    quint64 deferredUpdates = 0;
+    quint64 usecs = 0;
+
+    tree->lockForRead();
+    const QHash<QString, ParticleScriptPool::ScriptStats>& scriptStats = tree->getScriptStats();
+    int scriptCount = scriptStats.size();
+    foreach (const ParticleScriptPool::ScriptStats& stats, scriptStats) {
+        updates += stats.updates;
+        collisions += stats.collisions;
+        deferredUpdates += stats.deferredUpdates;
+        usecs += stats.usecs;
+    }
+    quint64 scriptTickUsecs = tree->getLastScriptTickUsecs();
+    tree->unlock();
+
+    statsObject[baseName + QString(".1.4.scripts.1.budgetUsecs")] = (double)tree->getScriptBudgetUsecs();
+    statsObject[baseName + QString(".1.4.scripts.2.scriptCount")] = (double)scriptCount;
+    statsObject[baseName + QString(".1.4.scripts.3.lastUpdateUsecs")] = (double)scriptTickUsecs;
+    statsObject[baseName + QString(".1.4.scripts.4.updates")] = (double)updates;
+    statsObject[baseName + QString(".1.4.scripts.5.collisions")] = (double)collisions;
+    statsObject[baseName + QString(".1.4.scripts.6.deferredUpdates")] = (double)deferredUpdates;
+    statsObject[baseName + QString(".1.4.scripts.7.usecs")] = (double)usecs;
 }
 
 void ParticleServer::particleCreated(const Particle& newParticle, const SharedNodePointer& senderNode) {
@@ -39,6 +39,8 @@ public:
     virtual void beforeRun();
     virtual bool hasSpecialPacketToSend(const SharedNodePointer& node);
     virtual int sendSpecialPacket(const SharedNodePointer& node, OctreeQueryNode* queryNode, int& packetsSent);
+    virtual QString getTreeStatusString();
+    virtual void addTreeStats(QJsonObject& statsObject, const QString& baseName);
 
     virtual void particleCreated(const Particle& newParticle, const SharedNodePointer& senderNode);
 
@@ -19,7 +19,7 @@
 #include <GeometryUtil.h>
 #include <NodeList.h>
 #include <PacketHeaders.h>
-#include <PerfStat.h>
+#include <Profiler.h>
 #include <SharedUtil.h>
 
 #include "Application.h"
@@ -103,7 +103,7 @@ float Avatar::getLODDistance() const {
 }
 
 void Avatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    PROFILE_SCOPE("simulate");
     
     // update the avatar's position according to its referential
     if (_referential) {
@@ -149,14 +149,14 @@ void Avatar::simulate(float deltaTime) {
         ViewFrustum::OUTSIDE;
 
     {
-        PerformanceTimer perfTimer("hand");
+        PROFILE_SCOPE("hand");
         getHand()->simulate(deltaTime, false);
     }
     _skeletonModel.setLODDistance(getLODDistance());
     
     if (!_shouldRenderBillboard && inViewFrustum) {
         {
-            PerformanceTimer perfTimer("skeleton");
+            PROFILE_SCOPE("skeleton");
             if (_hasNewJointRotations) {
                 for (int i = 0; i < _jointData.size(); i++) {
                     const JointData& data = _jointData.at(i);
@@ -168,7 +168,7 @@ void Avatar::simulate(float deltaTime) {
             _hasNewJointRotations = false;
         }
         {
-            PerformanceTimer perfTimer("head");
+            PROFILE_SCOPE("head");
             glm::vec3 headPosition = _position;
             _skeletonModel.getHeadPosition(headPosition);
             Head* head = getHead();
@@ -177,7 +177,7 @@ void Avatar::simulate(float deltaTime) {
             head->simulate(deltaTime, false, _shouldRenderBillboard);
         }
         if (Menu::getInstance()->isOptionChecked(MenuOption::StringHair)) {
-            PerformanceTimer perfTimer("hair");
+            PROFILE_SCOPE("hair");
             _hair.setAcceleration(getAcceleration() * getHead()->getFinalOrientationInWorldFrame());
             _hair.setAngularVelocity((getAngularVelocity() + getHead()->getAngularVelocity()) * getHead()->getFinalOrientationInWorldFrame());
             _hair.setAngularAcceleration(getAngularAcceleration() * getHead()->getFinalOrientationInWorldFrame());
@@ -185,6 +185,11 @@ void Avatar::simulate(float deltaTime) {
             _hair.simulate(deltaTime);
         }
     }
+    {
+        PROFILE_SCOPE("shapeTree");
+        // particles and ray picks search the skeleton's shapes through its tree
+        _skeletonModel.updateShapeTree();
+    }
     
     // update position by velocity, and subtract the change added earlier for gravity
     _position += _velocity * deltaTime;
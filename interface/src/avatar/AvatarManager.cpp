@@ -14,6 +14,7 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include <PerfStat.h>
+#include <Profiler.h>
 #include <UUID.h>
 
 #include "Application.h"
@@ -47,7 +48,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateAvatars()");
 
-    PerformanceTimer perfTimer("otherAvatars");
+    PROFILE_SCOPE("otherAvatars");
     Application* applicationInstance = Application::getInstance();
     glm::vec3 mouseOrigin = applicationInstance->getMouseRayOrigin();
     glm::vec3 mouseDirection = applicationInstance->getMouseRayDirection();
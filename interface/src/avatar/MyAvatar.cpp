@@ -24,7 +24,7 @@
 #include <GeometryUtil.h>
 #include <NodeList.h>
 #include <PacketHeaders.h>
-#include <PerfStat.h>
+#include <Profiler.h>
 #include <ShapeCollider.h>
 #include <SharedUtil.h>
 
@@ -137,7 +137,7 @@ void MyAvatar::update(float deltaTime) {
 }
 
 void MyAvatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    PROFILE_SCOPE("simulate");
     
     // Play back recording
     if (_player && _player->isPlaying()) {
@@ -152,28 +152,28 @@ void MyAvatar::simulate(float deltaTime) {
     _skeletonModel.setShowTrueJointTransforms(! Menu::getInstance()->isOptionChecked(MenuOption::CollideAsRagdoll));
 
     {
-        PerformanceTimer perfTimer("transform");
+        PROFILE_SCOPE("transform");
         updateOrientation(deltaTime);
         updatePosition(deltaTime);
     }
     
     {
-        PerformanceTimer perfTimer("hand");
+        PROFILE_SCOPE("hand");
         // update avatar skeleton and simulate hand and head
         getHand()->simulate(deltaTime, true);
     }
 
     {
-        PerformanceTimer perfTimer("skeleton");
+        PROFILE_SCOPE("skeleton");
         _skeletonModel.simulate(deltaTime);
     }
     {
-        PerformanceTimer perfTimer("attachments");
+        PROFILE_SCOPE("attachments");
         simulateAttachments(deltaTime);
     }
 
     {
-        PerformanceTimer perfTimer("joints");
+        PROFILE_SCOPE("joints");
         // copy out the skeleton joints from the model
         _jointData.resize(_skeletonModel.getJointStateCount());
         if (Menu::getInstance()->isOptionChecked(MenuOption::CollideAsRagdoll)) {
@@ -190,7 +190,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("head");
+        PROFILE_SCOPE("head");
         Head* head = getHead();
         glm::vec3 headPosition;
         if (!_skeletonModel.getHeadPosition(headPosition)) {
@@ -202,7 +202,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
     
     {
-        PerformanceTimer perfTimer("hair");
+        PROFILE_SCOPE("hair");
         if (Menu::getInstance()->isOptionChecked(MenuOption::StringHair)) {
             _hair.setAcceleration(getAcceleration() * getHead()->getFinalOrientationInWorldFrame());
             _hair.setAngularVelocity((getAngularVelocity() + getHead()->getAngularVelocity()) * getHead()->getFinalOrientationInWorldFrame());
@@ -213,7 +213,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("ragdoll");
+        PROFILE_SCOPE("ragdoll");
         Ragdoll* ragdoll = _skeletonModel.getRagdoll();
         if (ragdoll && Menu::getInstance()->isOptionChecked(MenuOption::CollideAsRagdoll)) {
             const float minError = 0.00001f;
@@ -232,11 +232,12 @@ void MyAvatar::simulate(float deltaTime) {
         } else {
             _skeletonModel.moveShapesTowardJoints(1.0f);
         }
+        _skeletonModel.updateShapeTree();
     }
 
     // now that we're done stepping the avatar forward in time, compute new collisions
     if (_collisionGroups != 0) {
-        PerformanceTimer perfTimer("collisions");
+        PROFILE_SCOPE("collisions");
         Camera* myCamera = Application::getInstance()->getCamera();
 
         float radius = getSkeletonHeight() * COLLISION_RADIUS_SCALE;
@@ -245,17 +246,17 @@ void MyAvatar::simulate(float deltaTime) {
             radius *= COLLISION_RADIUS_SCALAR;
         }
         if (_collisionGroups & COLLISION_GROUP_ENVIRONMENT) {
-            PerformanceTimer perfTimer("environment");
+            PROFILE_SCOPE("environment");
             updateCollisionWithEnvironment(deltaTime, radius);
         }
         if (_collisionGroups & COLLISION_GROUP_VOXELS) {
-            PerformanceTimer perfTimer("voxels");
+            PROFILE_SCOPE("voxels");
             updateCollisionWithVoxels(deltaTime, radius);
         } else {
             _trapDuration = 0.0f;
         }
         if (_collisionGroups & COLLISION_GROUP_AVATARS) {
-            PerformanceTimer perfTimer("avatars");
+            PROFILE_SCOPE("avatars");
             updateCollisionWithAvatars(deltaTime);
         }
     }
@@ -14,7 +14,7 @@
 #include <QtDebug>
 #include <glm/glm.hpp>
 
-#include <PerfStat.h>
+#include <Profiler.h>
 
 #include "JoystickManager.h"
 
@@ -47,7 +47,7 @@ JoystickManager::~JoystickManager() {
 
 void JoystickManager::update() {
 #ifdef HAVE_SDL
-    PerformanceTimer perfTimer("joystick");
+    PROFILE_SCOPE("joystick");
     SDL_JoystickUpdate();
     
     for (int i = 0; i < _joystickStates.size(); i++) {
@@ -13,7 +13,7 @@
 #include <QtDebug>
 
 #include <FBXReader.h>
-#include <PerfStat.h>
+#include <Profiler.h>
 
 #include "Application.h"
 #include "PrioVR.h"
@@ -167,7 +167,7 @@ void PrioVR::update(float deltaTime) {
     if (!_skeletalDevice) {
         return;
     }
-    PerformanceTimer perfTimer("PrioVR");
+    PROFILE_SCOPE("PrioVR");
     unsigned int timestamp;
     yei_getLastStreamDataAll(_skeletalDevice, (char*)_jointRotations.data(),
         _jointRotations.size() * sizeof(glm::quat), &timestamp);
@@ -11,7 +11,7 @@
 
 #include <vector>
 
-#include <PerfStat.h>
+#include <Profiler.h>
 
 #include "Application.h"
 #include "SixenseManager.h"
@@ -90,7 +90,7 @@ void SixenseManager::update(float deltaTime) {
         return;
     } 
 
-    PerformanceTimer perfTimer("sixense");
+    PROFILE_SCOPE("sixense");
     if (!_hydrasConnected) {
         _hydrasConnected = true;
         UserActivityLogger::getInstance().connectedDevice("spatial_controller", "hydra");
@@ -14,7 +14,7 @@
 
 #include <QOpenGLFramebufferObject>
 
-#include <PerfStat.h>
+#include <Profiler.h>
 
 #include "Application.h"
 #include "GlowEffect.h"
@@ -121,7 +121,7 @@ static void maybeRelease(QOpenGLFramebufferObject* fbo) {
 }
 
 QOpenGLFramebufferObject* GlowEffect::render(bool toTexture) {
-    PerformanceTimer perfTimer("glowEffect");
+    PROFILE_SCOPE("glowEffect");
 
     QOpenGLFramebufferObject* primaryFBO = Application::getInstance()->getTextureCache()->getPrimaryFramebufferObject();
     primaryFBO->release();
@@ -18,7 +18,7 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
-#include <PerfStat.h>
+#include <Profiler.h>
 
 #include "Stats.h"
 #include "InterfaceConfig.h"
@@ -400,7 +400,7 @@ void Stats::display(
         // we will also include room for 1 line per timing record and a header
         lines += 1;
 
-        const QMap<QString, PerformanceTimerRecord>& allRecords = PerformanceTimer::getAllTimerRecords();
+        const QMap<QString, PerformanceTimerRecord>& allRecords = Profiler::getRecords();
         QMapIterator<QString, PerformanceTimerRecord> i(allRecords);
         while (i.hasNext()) {
             i.next();
@@ -566,7 +566,7 @@ void Stats::display(
         drawText(horizontalOffset, verticalOffset, scale, rotation, font, (char*)voxelStats.str().c_str(), color);
     }
 
-    PerformanceTimer::tallyAllTimerRecords();
+    Profiler::tallyRecords();
 
     // TODO: the display of these timing details should all be moved to JavaScript
     if (_expanded && Menu::getInstance()->isOptionChecked(MenuOption::DisplayTimingDetails)) {
@@ -577,7 +577,7 @@ void Stats::display(
         drawText(horizontalOffset, verticalOffset, scale, rotation, font, 
                 "--------------------- Function -------------------- --msecs- -calls--", color);
 
-        const QMap<QString, PerformanceTimerRecord>& allRecords = PerformanceTimer::getAllTimerRecords();
+        const QMap<QString, PerformanceTimerRecord>& allRecords = Profiler::getRecords();
         QMapIterator<QString, PerformanceTimerRecord> i(allRecords);
         while (i.hasNext()) {
             i.next();
@@ -571,6 +571,7 @@ int VoxelSystem::parseData(const QByteArray& packet) {
 
             bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
             bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+            OctreePacketCompressionCodec codec = OctreePacketData::compressionCodecForFlags(flags);
 
             OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
             int flightTime = arrivedAt - sentAt;
@@ -598,7 +599,7 @@ int VoxelSystem::parseData(const QByteArray& packet) {
                     // ask the VoxelTree to read the bitstream into the tree
                     ReadBitstreamToTreeParams args(packetIsColored ? WANT_COLOR : NO_COLOR, WANT_EXISTS_BITS, NULL, getDataSourceUUID());
                     _tree->lockForWrite();
-                    OctreePacketData packetData(packetIsCompressed);
+                    OctreePacketData packetData(packetIsCompressed, OctreePacketData::getMaxSectionSize(codec), codec);
                     packetData.loadFinalizedContent(dataAt, sectionLength);
                     if (Application::getInstance()->getLogger()->extraDebugging()) {
                         qDebug("VoxelSystem::parseData() ... Got Packet Section"
@@ -1212,10 +1213,6 @@ void VoxelSystem::init() {
     // VBO for the verticesArray
     _initialMemoryUsageGPU = getFreeMemoryGPU();
     initVoxelMemory();
-
-    // our own _removedVoxels doesn't need to be notified of voxel deletes
-    VoxelTreeElement::removeDeleteHook(&_removedVoxels);
-
 }
 
 void VoxelSystem::changeTree(VoxelTree* newTree) {
@@ -274,9 +274,11 @@ int ModelItem::readModelDataFromBuffer(const unsigned char* data, int bytesLeftT
             bytesRead += animationURLLength;
 
             // animationIsPlaying
-            memcpy(&_animationIsPlaying, dataAt, sizeof(_animationIsPlaying));
-            dataAt += sizeof(_animationIsPlaying);
-            bytesRead += sizeof(_animationIsPlaying);
+            bool animationIsPlaying;
+            memcpy(&animationIsPlaying, dataAt, sizeof(animationIsPlaying));
+            dataAt += sizeof(animationIsPlaying);
+            bytesRead += sizeof(animationIsPlaying);
+            setAnimationIsPlaying(animationIsPlaying);
 
             // animationFrameIndex
             memcpy(&_animationFrameIndex, dataAt, sizeof(_animationFrameIndex));
@@ -425,9 +427,11 @@ ModelItem ModelItem::fromEditPacket(const unsigned char* data, int length, int&
     if (isNewModelItem || ((packetContainsBits & 
                     MODEL_PACKET_CONTAINS_ANIMATION_PLAYING) == MODEL_PACKET_CONTAINS_ANIMATION_PLAYING)) {
                     
-        memcpy(&newModelItem._animationIsPlaying, dataAt, sizeof(newModelItem._animationIsPlaying));
-        dataAt += sizeof(newModelItem._animationIsPlaying);
-        processedBytes += sizeof(newModelItem._animationIsPlaying);
+        bool animationIsPlaying;
+        memcpy(&animationIsPlaying, dataAt, sizeof(animationIsPlaying));
+        dataAt += sizeof(animationIsPlaying);
+        processedBytes += sizeof(animationIsPlaying);
+        newModelItem.setAnimationIsPlaying(animationIsPlaying);
     }
 
     // animationFrameIndex
@@ -773,7 +777,21 @@ void ModelItem::update(const quint64& updateTime) {
 }
 
 void ModelItem::copyChangedProperties(const ModelItem& other) {
+    // the animation keeps its own clock while it plays, other's was set whenever other was made
+    bool wasPlaying = _animationIsPlaying;
+    quint64 lastAnimated = _lastAnimated;
     *this = other;
+    if (_animationIsPlaying) {
+        _lastAnimated = wasPlaying ? lastAnimated : usecTimestampNow();
+    }
+}
+
+void ModelItem::setAnimationIsPlaying(bool value) {
+    // models that aren't playing aren't updated, so the animation has to start its clock over when it starts playing
+    if (value && !_animationIsPlaying) {
+        _lastAnimated = usecTimestampNow();
+    }
+    _animationIsPlaying = value;
 }
 
 ModelItemProperties ModelItem::getProperties() const {
@@ -256,7 +256,7 @@ public:
     void setModelRotation(const glm::quat& rotation) { _modelRotation = rotation; }
     void setAnimationURL(const QString& url) { _animationURL = url; }
     void setAnimationFrameIndex(float value) { _animationFrameIndex = value; }
-    void setAnimationIsPlaying(bool value) { _animationIsPlaying = value; }
+    void setAnimationIsPlaying(bool value);
     void setAnimationFPS(float value) { _animationFPS = value; }
     void setGlowLevel(float glowLevel) { _glowLevel = glowLevel; }
     void setSittingPoints(QVector<SittingPoint> sittingPoints) { _sittingPoints = sittingPoints; }
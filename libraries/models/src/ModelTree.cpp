@@ -14,7 +14,11 @@
 
 #include "ModelTree.h"
 
-ModelTree::ModelTree(bool shouldReaverage) : Octree(shouldReaverage) {
+ModelTree::ModelTree(bool shouldReaverage) :
+    Octree(shouldReaverage),
+    _needsFullUpdate(false),
+    _activeModelCount(0)
+{
     _rootElement = createNewElement();
 }
 
@@ -107,27 +111,35 @@ bool FindAndUpdateModelOperator::PreRecursion(OctreeElement* element) {
 bool FindAndUpdateModelOperator::PostRecursion(OctreeElement* element) {
     if (_found) {
         element->markWithChangedTime();
+        static_cast<ModelTreeElement*>(element)->setHasActiveModelsInSubtree(true);
     }
     return !_found; // if we haven't yet found it, keep looking
 }
 
 
-// TODO: improve this to not use multiple recursions
 void ModelTree::storeModel(const ModelItem& model, const SharedNodePointer& senderNode) {
     // First, look for the existing model in the tree..
-    FindAndUpdateModelOperator theOperator(model);
-    recurseTreeWithOperator(&theOperator);
+    bool found = false;
+    ModelTreeElement* containingElement;
+    if (lookUpModel(ModelItemID(model.getID()), containingElement)) {
+        if (containingElement && containingElement->updateModel(model)) {
+            markPathChanged(containingElement);
+            found = true;
+        }
+    } else {
+        FindAndUpdateModelOperator theOperator(model);
+        recurseTreeWithOperator(&theOperator);
+        found = theOperator.wasFound();
+    }
     
     // if we didn't find it in the tree, then store it...
-    if (!theOperator.wasFound()) {
-        AACube modelCube = model.getAACube();
+    if (!found) {
         ModelTreeElement* element = static_cast<ModelTreeElement*>(getOrCreateChildElementContaining(model.getAACube()));
         element->storeModel(model);
         
         // In the case where we stored it, we also need to mark the entire "path" down to the model as
-        // having changed. Otherwise viewers won't see this change. So we call this recursion now that
-        // we know it will be found, this find/update will correctly mark the tree as changed.
-        recurseTreeWithOperator(&theOperator);
+        // having changed. Otherwise viewers won't see this change.
+        markPathChanged(element);
     }
 
     _isDirty = true;
@@ -167,15 +179,26 @@ bool FindAndUpdateModelWithIDandPropertiesOperator::PreRecursion(OctreeElement*
 bool FindAndUpdateModelWithIDandPropertiesOperator::PostRecursion(OctreeElement* element) {
     if (_found) {
         element->markWithChangedTime();
+        static_cast<ModelTreeElement*>(element)->setHasActiveModelsInSubtree(true);
     }
     return !_found; // if we haven't yet found it, keep looking
 }
 
 void ModelTree::updateModel(const ModelItemID& modelID, const ModelItemProperties& properties) {
     // Look for the existing model in the tree..
-    FindAndUpdateModelWithIDandPropertiesOperator theOperator(modelID, properties);
-    recurseTreeWithOperator(&theOperator);
-    if (theOperator.wasFound()) {
+    bool found = false;
+    ModelTreeElement* containingElement;
+    if (lookUpModel(modelID, containingElement)) {
+        if (containingElement && containingElement->updateModel(modelID, properties)) {
+            markPathChanged(containingElement);
+            found = true;
+        }
+    } else {
+        FindAndUpdateModelWithIDandPropertiesOperator theOperator(modelID, properties);
+        recurseTreeWithOperator(&theOperator);
+        found = theOperator.wasFound();
+    }
+    if (found) {
         _isDirty = true;
     }
 }
@@ -191,15 +214,24 @@ void ModelTree::addModel(const ModelItemID& modelID, const ModelItemProperties&
     
     ModelTreeElement* element = static_cast<ModelTreeElement*>(getOrCreateChildElementAt(position.x, position.y, position.z, size));
     element->storeModel(model);
+    markPathChanged(element);
     
     _isDirty = true;
 }
 
 void ModelTree::deleteModel(const ModelItemID& modelID) {
     if (modelID.isKnownID) {
-        FindAndDeleteModelsArgs args;
-        args._idsToDelete.push_back(modelID.id);
-        recurseTreeWithOperation(findAndDeleteOperation, &args);
+        ModelTreeElement* containingElement;
+        if (lookUpModel(modelID, containingElement)) {
+            if (containingElement && containingElement->removeModelWithID(modelID.id)) {
+                markPathActive(containingElement); // so that the update pass prunes it if it is now empty
+            }
+        } else {
+            FindAndDeleteModelsArgs args;
+            args._idsToDelete.push_back(modelID.id);
+            recurseTreeWithOperation(findAndDeleteOperation, &args);
+            _needsFullUpdate = true;
+        }
     }
 }
 
@@ -280,7 +312,21 @@ void ModelTree::handleAddModelResponse(const QByteArray& packet) {
                 << " getIsViewing()=" << getIsViewing();
     }
     lockForWrite();
-    recurseTreeWithOperation(findAndUpdateModelItemIDOperation, &args);
+    ModelTreeElement* creatorTokenElement;
+    ModelTreeElement* viewedElement = NULL;
+    if (lookUpModel(ModelItemID(UNKNOWN_MODEL_ID, creatorTokenID, false), creatorTokenElement) &&
+            (!getIsViewing() || lookUpModel(ModelItemID(modelID), viewedElement))) {
+        if (creatorTokenElement) {
+            creatorTokenElement->updateModelItemID(&args);
+        }
+        if (viewedElement && viewedElement != creatorTokenElement) {
+            viewedElement->updateModelItemID(&args);
+            markPathActive(viewedElement); // the viewed copy was removed from it
+        }
+    } else {
+        recurseTreeWithOperation(findAndUpdateModelItemIDOperation, &args);
+        _needsFullUpdate = true;
+    }
     unlock();
 }
 
@@ -456,16 +502,25 @@ bool ModelTree::findByIDOperation(OctreeElement* element, void* extraData) {
 
 
 const ModelItem* ModelTree::findModelByID(uint32_t id, bool alreadyLocked) {
-    FindByIDArgs args = { id, false, NULL };
+    const ModelItem* foundModel = NULL;
 
     if (!alreadyLocked) {
         lockForRead();
     }
-    recurseTreeWithOperation(findByIDOperation, &args);
+    ModelTreeElement* containingElement;
+    if (lookUpModel(ModelItemID(id), containingElement)) {
+        if (containingElement) {
+            foundModel = containingElement->getModelWithID(id);
+        }
+    } else {
+        FindByIDArgs args = { id, false, NULL };
+        recurseTreeWithOperation(findByIDOperation, &args);
+        foundModel = args.foundModel;
+    }
     if (!alreadyLocked) {
         unlock();
     }
-    return args.foundModel;
+    return foundModel;
 }
 
 
@@ -525,30 +580,130 @@ void ModelTree::removeNewlyCreatedHook(NewlyCreatedModelHook* hook) {
 }
 
 
-bool ModelTree::updateOperation(OctreeElement* element, void* extraData) {
-    ModelTreeUpdateArgs* args = static_cast<ModelTreeUpdateArgs*>(extraData);
-    ModelTreeElement* modelTreeElement = static_cast<ModelTreeElement*>(element);
-    modelTreeElement->update(*args);
-    return true;
+ModelTree::~ModelTree() {
+    // the elements take their models out of the indexes, which are gone by the time ~Octree() deletes them
+    delete _rootElement;
+    _rootElement = NULL;
 }
 
-bool ModelTree::pruneOperation(OctreeElement* element, void* extraData) {
-    ModelTreeElement* modelTreeElement = static_cast<ModelTreeElement*>(element);
+void ModelTree::eraseAllOctreeElements() {
+    // clear the indexes first, so that the elements don't have to take their models out one by one
+    _modelsByID.clear();
+    _modelsByCreatorToken.clear();
+    Octree::eraseAllOctreeElements();
+}
+
+void ModelTree::indexModel(const ModelItem& model, ModelTreeElement* element) {
+    if (model.getID() != UNKNOWN_MODEL_ID) {
+        _modelsByID.insert(model.getID(), element);
+    } else if (model.getCreatorTokenID() != UNKNOWN_MODEL_TOKEN) {
+        _modelsByCreatorToken.insert(model.getCreatorTokenID(), element);
+    }
+}
+
+void ModelTree::unindexModel(const ModelItem& model, ModelTreeElement* element) {
+    if (model.getID() != UNKNOWN_MODEL_ID) {
+        _modelsByID.remove(model.getID(), element);
+    } else if (model.getCreatorTokenID() != UNKNOWN_MODEL_TOKEN) {
+        _modelsByCreatorToken.remove(model.getCreatorTokenID(), element);
+    }
+}
+
+int ModelTree::getModelCount() const {
+    return countIndexedModels(_modelsByID, true) + countIndexedModels(_modelsByCreatorToken, false);
+}
+
+// an entry can outlive its model when a removal was missed, so only the entries whose elements hold the model count
+int ModelTree::countIndexedModels(const OctreeItemIndex& index, bool isKnownID) const {
+    int count = 0;
+    foreach (quint32 key, index.getIDs()) {
+        ModelItemID modelID(isKnownID ? key : UNKNOWN_MODEL_ID, isKnownID ? UNKNOWN_MODEL_TOKEN : key, isKnownID);
+        ModelTreeElement* element = static_cast<ModelTreeElement*>(index.find(key));
+        if (element && element->hasModel(modelID)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Every model in the tree is indexed, so a model that isn't in the index isn't in the tree. But if the index points at
+// an element that doesn't hold the model, the caller falls back to searching the whole tree.
+bool ModelTree::lookUpModel(const ModelItemID& modelID, ModelTreeElement*& element) const {
+    element = NULL;
+    quint32 key = modelID.isKnownID ? modelID.id : modelID.creatorTokenID;
+    if (key == (modelID.isKnownID ? UNKNOWN_MODEL_ID : UNKNOWN_MODEL_TOKEN)) {
+        return false;
+    }
+    const OctreeItemIndex& index = modelID.isKnownID ? _modelsByID : _modelsByCreatorToken;
+    if (!index.contains(key)) {
+        return true;
+    }
+    element = static_cast<ModelTreeElement*>(index.find(key));
+    if (element && element->hasModel(modelID)) {
+        return true;
+    }
+    element = NULL;
+    return false;
+}
+
+// marks element and all of its ancestors as changed, so that viewers will see the change, and as having active models,
+// so that the next update pass visits element
+void ModelTree::markPathChanged(ModelTreeElement* element) {
+    int elementLevel = numberOfThreeBitSectionsInCode(element->getOctalCode());
+    ModelTreeElement* ancestor = getRoot();
+    for (int level = 0; ancestor; level++) {
+        ancestor->markWithChangedTime();
+        ancestor->setHasActiveModelsInSubtree(true);
+        if (level == elementLevel) {
+            break;
+        }
+        ancestor = ancestor->getChildAtIndex(branchIndexWithDescendant(ancestor->getOctalCode(), element->getOctalCode()));
+    }
+}
+
+// only makes the next update pass visit element, for when models were taken out of it
+void ModelTree::markPathActive(ModelTreeElement* element) {
+    int elementLevel = numberOfThreeBitSectionsInCode(element->getOctalCode());
+    ModelTreeElement* ancestor = getRoot();
+    for (int level = 0; ancestor; level++) {
+        ancestor->setHasActiveModelsInSubtree(true);
+        if (level == elementLevel) {
+            break;
+        }
+        ancestor = ancestor->getChildAtIndex(branchIndexWithDescendant(ancestor->getOctalCode(), element->getOctalCode()));
+    }
+}
+
+// Updates the models of element and its descendants in post-fix order, skipping the subtrees without active models
+// unless this is a full update, and pruning the empty leaves that it visits.
+bool ModelTree::updateSubtree(ModelTreeElement* element, ModelTreeUpdateArgs& args, bool fullUpdate) {
+    bool hasActiveModels = element->update(args);
+
     for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        ModelTreeElement* childAt = modelTreeElement->getChildAtIndex(i);
-        if (childAt && childAt->isLeaf() && !childAt->hasModels()) {
-            modelTreeElement->deleteChildAtIndex(i);
+        ModelTreeElement* childAt = element->getChildAtIndex(i);
+        if (!childAt || !(fullUpdate || childAt->hasActiveModelsInSubtree())) {
+            continue;
+        }
+        if (updateSubtree(childAt, args, fullUpdate)) {
+            hasActiveModels = true;
+        }
+        if (childAt->isLeaf() && !childAt->hasModels()) {
+            element->deleteChildAtIndex(i);
         }
     }
-    return true;
+    element->setHasActiveModelsInSubtree(hasActiveModels);
+    return hasActiveModels;
 }
 
 void ModelTree::update() {
     lockForWrite();
-    _isDirty = true;
 
+    // only the paths down to active or edited models are visited, unless a search of the whole tree changed something
     ModelTreeUpdateArgs args;
-    recurseTreeWithOperation(updateOperation, &args);
+    if (_needsFullUpdate || getRoot()->hasActiveModelsInSubtree()) {
+        updateSubtree(getRoot(), args, _needsFullUpdate);
+        _needsFullUpdate = false;
+    }
 
     // now add back any of the particles that moved elements....
     int movingModels = args._movingModels.size();
@@ -570,8 +725,10 @@ void ModelTree::update() {
         }
     }
 
-    // prune the tree...
-    recurseTreeWithOperation(pruneOperation, NULL);
+    if (args._totalElements > 0) {
+        _isDirty = true;
+    }
+    _activeModelCount = args._activeItems;
     unlock();
 }
 
@@ -734,10 +891,20 @@ void ModelTree::processEraseMessage(const QByteArray& dataByteArray, const Share
             dataAt += sizeof(modelID);
             processedBytes += sizeof(modelID);
 
-            args._idsToDelete.push_back(modelID);
+            ModelTreeElement* containingElement;
+            if (lookUpModel(ModelItemID(modelID), containingElement)) {
+                if (containingElement && containingElement->removeModelWithID(modelID)) {
+                    markPathActive(containingElement);
+                }
+            } else {
+                args._idsToDelete.push_back(modelID);
+            }
         }
 
-        // calling recurse to actually delete the models
-        recurseTreeWithOperation(findAndDeleteOperation, &args);
+        // calling recurse to actually delete the models the index couldn't find
+        if (!args._idsToDelete.isEmpty()) {
+            recurseTreeWithOperation(findAndDeleteOperation, &args);
+            _needsFullUpdate = true;
+        }
     }
 }
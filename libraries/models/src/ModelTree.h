@@ -13,6 +13,7 @@
 #define hifi_ModelTree_h
 
 #include <Octree.h>
+#include <OctreeItemIndex.h>
 #include "ModelTreeElement.h"
 
 class Model;
@@ -32,6 +33,7 @@ class ModelTree : public Octree {
     Q_OBJECT
 public:
     ModelTree(bool shouldReaverage = false);
+    virtual ~ModelTree();
 
     /// Implements our type specific root element factory
     virtual ModelTreeElement* createNewElement(unsigned char * octalCode = NULL);
@@ -50,6 +52,12 @@ public:
 
     virtual bool rootElementHasData() const { return true; }
     virtual void update();
+    virtual void eraseAllOctreeElements();
+
+    /// the models that were animating or dying as of the last update, which are the only ones it keeps visiting
+    int getActiveModelCount() const { return _activeModelCount; }
+    /// the models in the indexes whose elements still hold them, call with the tree locked for reading
+    int getModelCount() const;
 
     void storeModel(const ModelItem& model, const SharedNodePointer& senderNode = SharedNodePointer());
     void updateModel(const ModelItemID& modelID, const ModelItemProperties& properties);
@@ -91,16 +99,27 @@ public:
     }
     void sendModels(ModelEditPacketSender* packetSender, float x, float y, float z);
 
+    /// Keep the index of which element holds each model up to date, called by the elements as models are stored in them
+    /// and taken out of them. Models are indexed by ID once it is known, and by creator token until then.
+    void indexModel(const ModelItem& model, ModelTreeElement* element);
+    void unindexModel(const ModelItem& model, ModelTreeElement* element);
+
 private:
+    /// Finds the element holding a model through the index.
+    /// \param element[out] the element holding the model, or NULL if the model isn't in the tree
+    /// \return false if the index can't tell, in which case the caller has to search the tree and element is NULL
+    bool lookUpModel(const ModelItemID& modelID, ModelTreeElement*& element) const;
+    int countIndexedModels(const OctreeItemIndex& index, bool isKnownID) const;
+    void markPathChanged(ModelTreeElement* element);
+    void markPathActive(ModelTreeElement* element);
+    bool updateSubtree(ModelTreeElement* element, ModelTreeUpdateArgs& args, bool fullUpdate);
 
     static bool sendModelsOperation(OctreeElement* element, void* extraData);
-    static bool updateOperation(OctreeElement* element, void* extraData);
     static bool findInCubeOperation(OctreeElement* element, void* extraData);
     static bool findAndUpdateOperation(OctreeElement* element, void* extraData);
     static bool findAndUpdateWithIDandPropertiesOperation(OctreeElement* element, void* extraData);
     static bool findNearPointOperation(OctreeElement* element, void* extraData);
     static bool findInSphereOperation(OctreeElement* element, void* extraData);
-    static bool pruneOperation(OctreeElement* element, void* extraData);
     static bool findByIDOperation(OctreeElement* element, void* extraData);
     static bool findAndDeleteOperation(OctreeElement* element, void* extraData);
     static bool findAndUpdateModelItemIDOperation(OctreeElement* element, void* extraData);
@@ -115,6 +134,12 @@ private:
     QReadWriteLock _recentlyDeletedModelsLock;
     QMultiMap<quint64, uint32_t> _recentlyDeletedModelItemIDs;
     ModelItemFBXService* _fbxService;
+
+    OctreeItemIndex _modelsByID;
+    OctreeItemIndex _modelsByCreatorToken;
+
+    bool _needsFullUpdate; // a search of the whole tree changed models, so update() can't know which paths to visit
+    int _activeModelCount;
 };
 
 #endif // hifi_ModelTree_h
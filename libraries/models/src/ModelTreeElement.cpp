@@ -17,12 +17,25 @@
 #include "ModelTree.h"
 #include "ModelTreeElement.h"
 
-ModelTreeElement::ModelTreeElement(unsigned char* octalCode) : OctreeElement(), _modelItems(NULL) {
+IMPLEMENT_OCTREE_ELEMENT_POOL(ModelTreeElement)
+
+ModelTreeElement::ModelTreeElement(unsigned char* octalCode) :
+    OctreeElement(),
+    _myTree(NULL),
+    _modelItems(NULL),
+    _hasActiveModelsInSubtree(false) {
     init(octalCode);
 };
 
 ModelTreeElement::~ModelTreeElement() {
     _voxelMemoryUsage -= sizeof(ModelTreeElement);
+
+    // the models go with the element, so they can't stay in the index
+    if (_myTree) {
+        for (int i = 0; i < _modelItems->size(); i++) {
+            _myTree->unindexModel((*_modelItems)[i], this);
+        }
+    }
     delete _modelItems;
     _modelItems = NULL;
 }
@@ -133,8 +146,10 @@ bool ModelTreeElement::bestFitModelBounds(const ModelItem& model) const {
     return false;
 }
 
-void ModelTreeElement::update(ModelTreeUpdateArgs& args) {
+bool ModelTreeElement::update(ModelTreeUpdateArgs& args) {
     args._totalElements++;
+    bool hasActiveModels = false;
+
     // update our contained models
     QList<ModelItem>::iterator modelItr = _modelItems->begin();
     while(modelItr != _modelItems->end()) {
@@ -150,6 +165,7 @@ void ModelTreeElement::update(ModelTreeUpdateArgs& args) {
         // into the arguments moving models. These will be added back or deleted completely
         if (model.getShouldDie() || !bestFitModelBounds(model)) {
             args._movingModels.push_back(model);
+            _myTree->unindexModel(model, this);
 
             // erase this model
             modelItr = _modelItems->erase(modelItr);
@@ -159,9 +175,14 @@ void ModelTreeElement::update(ModelTreeUpdateArgs& args) {
             // this element has changed so mark it...
             markWithChangedTime();
         } else {
+            if (isActiveModel(model)) {
+                args._activeItems++;
+                hasActiveModels = true;
+            }
             ++modelItr;
         }
     }
+    return hasActiveModels;
 }
 
 bool ModelTreeElement::findDetailedRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
@@ -349,6 +370,7 @@ bool ModelTreeElement::updateModel(const ModelItemID& modelID, const ModelItemPr
 }
 
 void ModelTreeElement::updateModelItemID(FindAndUpdateModelItemIDArgs* args) {
+    bool creatorTokenFoundHere = false;
     uint16_t numberOfModels = _modelItems->size();
     for (uint16_t i = 0; i < numberOfModels; i++) {
         ModelItem& thisModel = (*_modelItems)[i];
@@ -356,14 +378,17 @@ void ModelTreeElement::updateModelItemID(FindAndUpdateModelItemIDArgs* args) {
         if (!args->creatorTokenFound) {
             // first, we're looking for matching creatorTokenIDs, if we find that, then we fix it to know the actual ID
             if (thisModel.getCreatorTokenID() == args->creatorTokenID) {
+                _myTree->unindexModel(thisModel, this);
                 thisModel.setID(args->modelID);
                 args->creatorTokenFound = true;
+                creatorTokenFoundHere = true;
             }
         }
         
         // if we're in an isViewing tree, we also need to look for an kill any viewed models
         if (!args->viewedModelFound && args->isViewing) {
             if (thisModel.getCreatorTokenID() == UNKNOWN_MODEL_TOKEN && thisModel.getID() == args->modelID) {
+                _myTree->unindexModel(thisModel, this);
                 _modelItems->removeAt(i); // remove the model at this index
                 numberOfModels--; // this means we have 1 fewer model in this list
                 i--; // and we actually want to back up i as well.
@@ -371,6 +396,14 @@ void ModelTreeElement::updateModelItemID(FindAndUpdateModelItemIDArgs* args) {
             }
         }
     }
+
+    // index the model by its new ID once any viewed copy of it is gone
+    if (creatorTokenFoundHere) {
+        const ModelItem* model = getModelWithID(args->modelID);
+        if (model) {
+            _myTree->indexModel(*model, this);
+        }
+    }
 }
 
 
@@ -430,6 +463,17 @@ void ModelTreeElement::getModelsForUpdate(const AACube& box, QVector<ModelItem*>
     }
 }
 
+bool ModelTreeElement::hasModel(const ModelItemID& modelID) const {
+    uint16_t numberOfModels = _modelItems->size();
+    for (uint16_t i = 0; i < numberOfModels; i++) {
+        const ModelItem& model = (*_modelItems)[i];
+        if (modelID.isKnownID ? model.getID() == modelID.id : model.getCreatorTokenID() == modelID.creatorTokenID) {
+            return true;
+        }
+    }
+    return false;
+}
+
 const ModelItem* ModelTreeElement::getModelWithID(uint32_t id) const {
     // NOTE: this lookup is O(N) but maybe we don't care? (guaranteed that num models per elemen is small?)
     const ModelItem* foundModel = NULL;
@@ -449,6 +493,7 @@ bool ModelTreeElement::removeModelWithID(uint32_t id) {
     for (uint16_t i = 0; i < numberOfModels; i++) {
         if ((*_modelItems)[i].getID() == id) {
             foundModel = true;
+            _myTree->unindexModel((*_modelItems)[i], this);
             _modelItems->removeAt(i);
             break;
         }
@@ -512,6 +557,7 @@ bool ModelTreeElement::collapseChildren() {
 
 void ModelTreeElement::storeModel(const ModelItem& model) {
     _modelItems->push_back(model);
+    _myTree->indexModel(model, this);
     markWithChangedTime();
 }
 
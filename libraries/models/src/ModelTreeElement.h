@@ -13,6 +13,7 @@
 #define hifi_ModelTreeElement_h
 
 #include <OctreeElement.h>
+#include <OctreeElementPool.h>
 #include <QList>
 
 #include "ModelItem.h"
@@ -26,13 +27,15 @@ public:
     ModelTreeUpdateArgs() :
             _totalElements(0),
             _totalItems(0),
-            _movingItems(0)
+            _movingItems(0),
+            _activeItems(0)
     { }
     
     QList<ModelItem> _movingModels;
     int _totalElements;
     int _totalItems;
     int _movingItems;
+    int _activeItems;
 };
 
 class FindAndUpdateModelItemIDArgs {
@@ -59,6 +62,8 @@ class ModelTreeElement : public OctreeElement {
 
     virtual OctreeElement* createNewElement(unsigned char* octalCode = NULL);
 
+    DECLARE_OCTREE_ELEMENT_POOL()
+
 public:
     virtual ~ModelTreeElement();
 
@@ -118,9 +123,19 @@ public:
     QList<ModelItem>& getModels() { return *_modelItems; }
     bool hasModels() const { return _modelItems ? _modelItems->size() > 0 : false; }
 
-    void update(ModelTreeUpdateArgs& args);
+    /// Updates our models, moving the ones that die or no longer fit into args.
+    /// \return true if any of our models still need to be updated, because they are animating
+    bool update(ModelTreeUpdateArgs& args);
     void setTree(ModelTree* tree) { _myTree = tree; }
 
+    /// Whether a model needs the tree's update pass. Models don't move on their own, so only animating and dying ones do.
+    static bool isActiveModel(const ModelItem& model) { return model.getAnimationIsPlaying() || model.getShouldDie(); }
+
+    /// Whether this element or any of its descendants has models that need the tree's update pass. Set on the path down
+    /// to each edited model, and only cleared by the update pass, which skips the subtrees where it is false.
+    bool hasActiveModelsInSubtree() const { return _hasActiveModelsInSubtree; }
+    void setHasActiveModelsInSubtree(bool hasActiveModelsInSubtree) { _hasActiveModelsInSubtree = hasActiveModelsInSubtree; }
+
     bool updateModel(const ModelItem& model);
     bool updateModel(const ModelItemID& modelID, const ModelItemProperties& properties);
     void updateModelItemID(FindAndUpdateModelItemIDArgs* args);
@@ -140,6 +155,9 @@ public:
 
     void getModelsInside(const AACube& box, QVector<ModelItem*>& foundModels);
 
+    /// \return whether we hold the model, by ID if it is known and by creator token if not
+    bool hasModel(const ModelItemID& modelID) const;
+
     const ModelItem* getModelWithID(uint32_t id) const;
 
     bool removeModelWithID(uint32_t id);
@@ -154,6 +172,7 @@ protected:
 
     ModelTree* _myTree;
     QList<ModelItem>* _modelItems;
+    bool _hasActiveModelsInSubtree;
 };
 
 #endif // hifi_ModelTreeElement_h
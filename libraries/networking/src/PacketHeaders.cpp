@@ -71,16 +71,20 @@ PacketVersion versionForPacketType(PacketType type) {
             return 1;
         case PacketTypeOctreeStats:
             return 1;
-        case PacketTypeParticleData:
+        case PacketTypeVoxelData:
             return 1;
+        case PacketTypeParticleData:
+            return 2;
         case PacketTypeParticleErase:
             return 1;
         case PacketTypeModelData:
-            return 2;
+            return 3;
         case PacketTypeModelErase:
             return 1;
         case PacketTypeAudioStreamStats:
             return 1;
+        case PacketTypeJurisdiction:
+            return 1;
         case PacketTypeMetavoxelData:
             return 3;
         default:
@@ -10,13 +10,64 @@
 //
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
 #include <QtCore/QJsonObject>
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
+#include <Metrics.h>
+#include <Profiler.h>
+
 #include "Logging.h"
+#include "PacketHeaders.h"
 #include "ThreadedAssignment.h"
 
+// the bytes that stats take in a stats packet, which carries them as a QVariantMap
+static int getStatsSize(const QJsonObject& statsObject) {
+    QByteArray statsData;
+    QDataStream statsStream(&statsData, QIODevice::WriteOnly);
+    statsStream << statsObject.toVariantMap();
+    return statsData.size();
+}
+
+// gathers stats into packets that each fit in an MTU, sending a packet whenever the next stats would overflow it
+class StatsPacker {
+public:
+    StatsPacker() :
+        _maxSize(MAX_PACKET_SIZE - numBytesForPacketHeaderGivenPacketType(PacketTypeNodeJsonStats)),
+        _emptySize(getStatsSize(QJsonObject())),
+        _size(_emptySize) {
+    }
+
+    void add(const QJsonObject& stats) {
+        // the properties of a map follow its count, so their sizes add up
+        int size = getStatsSize(stats) - _emptySize;
+        if (_size + size > _maxSize && !_stats.isEmpty()) {
+            send();
+        }
+        for (QJsonObject::const_iterator it = stats.constBegin(); it != stats.constEnd(); ++it) {
+            _stats.insert(it.key(), it.value());
+        }
+        _size += size;
+    }
+
+    /// Sends the stats gathered since the last packet, if any.
+    void send() {
+        if (!_stats.isEmpty()) {
+            NodeList::getInstance()->sendStatsToDomainServer(_stats);
+            _stats = QJsonObject();
+            _size = _emptySize;
+        }
+    }
+
+private:
+    int _maxSize;
+    int _emptySize;
+    int _size;
+    QJsonObject _stats;
+};
+
 ThreadedAssignment::ThreadedAssignment(const QByteArray& packet) :
     Assignment(packet),
     _isFinished(false),
@@ -30,6 +81,10 @@ void ThreadedAssignment::setFinished(bool isFinished) {
 
     if (_isFinished) {
         aboutToFinish();
+
+        if (!_profileTraceFilename.isEmpty()) {
+            Profiler::writeChromeTrace(_profileTraceFilename);
+        }
         
         NodeList* nodeList = NodeList::getInstance();
         
@@ -55,6 +110,11 @@ void ThreadedAssignment::setFinished(bool isFinished) {
 void ThreadedAssignment::commonInit(const QString& targetName, NodeType_t nodeType, bool shouldSendStats) {
     // change the logging target name while the assignment is running
     Logging::setTargetName(targetName);
+
+    // the latest scopes of every thread are written to this file when the assignment finishes
+    const QString PROFILE_TRACE_ENV = "HIFI_PROFILE_TRACE";
+    _profileTraceFilename = QProcessEnvironment::systemEnvironment().value(PROFILE_TRACE_ENV);
+    Profiler::setTracing(!_profileTraceFilename.isEmpty());
     
     NodeList* nodeList = NodeList::getInstance();
     nodeList->setOwnerType(nodeType);
@@ -84,8 +144,31 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject &statsObje
     
     statsObject["packets_per_second"] = packetsPerSecond;
     statsObject["bytes_per_second"] = bytesPerSecond;
-    
-    nodeList->sendStatsToDomainServer(statsObject);
+
+    // the domain server merges the stats it's sent, so they are split over as many packets as keep each in an MTU
+    StatsPacker packer;
+    packer.add(statsObject);
+
+    // the average time of each profiled scope, on any thread of the assignment
+    Profiler::tallyRecords();
+    QMapIterator<QString, PerformanceTimerRecord> i(Profiler::getRecords());
+    while (i.hasNext()) {
+        i.next();
+        QJsonObject profileObject;
+        profileObject["profile" + i.key() + "_usecs"] = (double)i.value().getMovingAverage();
+        packer.add(profileObject);
+    }
+
+    // other assignments that ran in this process leave their metrics behind, so only the assignment's own are sent
+    QString metricsPrefix = getMetricsPrefix();
+    if (!metricsPrefix.isEmpty()) {
+        foreach (const QString& name, Metrics::getNames(metricsPrefix)) {
+            QJsonObject metricObject;
+            Metrics::addToStats(metricObject, QStringList(name));
+            packer.add(metricObject);
+        }
+    }
+    packer.send();
 }
 
 void ThreadedAssignment::sendStatsPacket() {
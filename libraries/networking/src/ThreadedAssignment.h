@@ -25,6 +25,9 @@ public:
     virtual void aboutToFinish() { };
     void addPacketStatsAndSendStatsPacket(QJsonObject& statsObject);
 
+    /// \return the start of the names of the assignment's own metrics, which it sends with its stats; empty for none
+    virtual QString getMetricsPrefix() const { return QString(); }
+
 public slots:
     /// threaded run of assignment
     virtual void run() = 0;
@@ -38,6 +41,7 @@ protected:
     void commonInit(const QString& targetName, NodeType_t nodeType, bool shouldSendStats = true);
     bool _isFinished;
     QThread* _datagramProcessingThread;
+    QString _profileTraceFilename;
     
 private slots:
     void checkInWithDomainServerOrExit();
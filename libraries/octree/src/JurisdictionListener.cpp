@@ -27,9 +27,11 @@ JurisdictionListener::JurisdictionListener(NodeType_t type) :
 }
 
 void JurisdictionListener::nodeKilled(SharedNodePointer node) {
+    _jurisdictions.lockForWrite();
     if (_jurisdictions.find(node->getUUID()) != _jurisdictions.end()) {
         _jurisdictions.erase(_jurisdictions.find(node->getUUID()));
     }
+    _jurisdictions.unlock();
 }
 
 bool JurisdictionListener::queueJurisdictionRequest() {
@@ -62,7 +64,11 @@ void JurisdictionListener::processPacket(const SharedNodePointer& sendingNode, c
         QUuid nodeUUID = sendingNode->getUUID();
         JurisdictionMap map;
         map.unpackFromMessage(reinterpret_cast<const unsigned char*>(packet.data()), packet.size());
+
+        // servers can change their jurisdictions while running, and the edit senders read this map from other threads
+        _jurisdictions.lockForWrite();
         _jurisdictions[nodeUUID] = map;
+        _jurisdictions.unlock();
     }
 }
 
@@ -0,0 +1,122 @@
+//
+//  JurisdictionLoad.cpp
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cmath>
+
+#include "JurisdictionLoad.h"
+
+const float JurisdictionLoad::DEFAULT_SPLIT_LOAD = 0.5f;
+const float JurisdictionLoad::DEFAULT_MERGE_LOAD = 0.02f;
+
+JurisdictionLoad::JurisdictionLoad(const JurisdictionMap* jurisdiction) {
+    setJurisdiction(jurisdiction);
+}
+
+void JurisdictionLoad::setJurisdiction(const JurisdictionMap* jurisdiction) {
+    // no jurisdiction at all means the whole universe
+    static const unsigned char UNIVERSE_ROOT_CODE = 0;
+    const unsigned char* rootCode = jurisdiction ? jurisdiction->getRootOctalCode() : &UNIVERSE_ROOT_CODE;
+
+    _rootCodeLength = numberOfThreeBitSectionsInCode(rootCode);
+    _rootOctalCode = QByteArray(reinterpret_cast<const char*>(rootCode), bytesRequiredForCodeLength(_rootCodeLength));
+    voxelDetailsForCode(rootCode, _rootDetails);
+
+    for (int i = 0; i <= TOTAL; i++) {
+        _current[i].reset();
+        _last[i].reset();
+    }
+    _lastIntervalUsecs = 0;
+    _busyIntervals = 0;
+    _idleIntervals = 0;
+}
+
+void JurisdictionLoad::recordEdit(const unsigned char* editData, int maxLength, quint64 processUsecs) {
+    _current[TOTAL].edits++;
+    _current[TOTAL].editUsecs += processUsecs;
+
+    int codeLength = numberOfThreeBitSectionsInCode(editData, maxLength);
+    if (codeLength != OVERFLOWED_OCTCODE_BUFFER && codeLength > _rootCodeLength &&
+            isAncestorOf(getRootOctalCode(), editData)) {
+        SubtreeLoad& subtree = _current[branchIndexWithDescendant(getRootOctalCode(), editData)];
+        subtree.edits++;
+        subtree.editUsecs += processUsecs;
+    }
+}
+
+void JurisdictionLoad::recordEncode(const QUuid& clientID, const glm::vec3& position, quint64 encodeUsecs) {
+    _current[TOTAL].encodeUsecs += encodeUsecs;
+    _current[TOTAL].clients.insert(clientID);
+
+    // the encode is charged to the subtree the client is in, which is where most of what it sees usually comes from
+    glm::vec3 offset = position - glm::vec3(_rootDetails.x, _rootDetails.y, _rootDetails.z);
+    float size = _rootDetails.s;
+    if (offset.x >= 0.0f && offset.x < size && offset.y >= 0.0f && offset.y < size && offset.z >= 0.0f && offset.z < size) {
+        float halfSize = size * 0.5f;
+        int childIndex = (offset.x >= halfSize ? 4 : 0) | (offset.y >= halfSize ? 2 : 0) | (offset.z >= halfSize ? 1 : 0);
+        _current[childIndex].encodeUsecs += encodeUsecs;
+        _current[childIndex].clients.insert(clientID);
+    }
+}
+
+void JurisdictionLoad::endInterval(quint64 intervalUsecs) {
+    for (int i = 0; i <= TOTAL; i++) {
+        _last[i] = _current[i];
+        _current[i].reset();
+    }
+    _lastIntervalUsecs = intervalUsecs;
+}
+
+JurisdictionLoad::Proposal JurisdictionLoad::propose(const JurisdictionMap* jurisdiction, int& splitChild) {
+    if (_lastIntervalUsecs == 0) {
+        return NO_PROPOSAL;
+    }
+    float load = getLastLoad(TOTAL);
+    _busyIntervals = (load > DEFAULT_SPLIT_LOAD) ? _busyIntervals + 1 : 0;
+    _idleIntervals = (load < DEFAULT_MERGE_LOAD) ? _idleIntervals + 1 : 0;
+
+    if (_busyIntervals >= INTERVALS_BEFORE_SPLIT) {
+        splitChild = chooseSplitChild(jurisdiction);
+        return (splitChild == -1) ? NO_PROPOSAL : SPLIT_PROPOSAL;
+    }
+    // only servers without end nodes merge, so that a subtree never comes back with parts of it owned by a third server
+    if (_idleIntervals >= INTERVALS_BEFORE_MERGE && _rootCodeLength > 0 && jurisdiction &&
+            jurisdiction->getEndNodeCount() == 0) {
+        return MERGE_PROPOSAL;
+    }
+    return NO_PROPOSAL;
+}
+
+int JurisdictionLoad::chooseSplitChild(const JurisdictionMap* jurisdiction) const {
+    // the best split leaves both servers with about half of the load
+    float halfLoad = getLastLoad(TOTAL) * 0.5f;
+    int bestChild = -1;
+    float bestDifference = 0.0f;
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        float load = getLastLoad(i);
+        if (load <= 0.0f) {
+            continue;
+        }
+        // a subtree that is already partly someone else's can't be handed over as a whole
+        bool ownsAll = true;
+        if (jurisdiction) {
+            unsigned char* childCode = childOctalCode(getRootOctalCode(), i);
+            for (int j = 0; j < jurisdiction->getEndNodeCount() && ownsAll; j++) {
+                ownsAll = !isAncestorOf(childCode, jurisdiction->getEndNodeOctalCode(j));
+            }
+            delete[] childCode;
+        }
+        float difference = fabsf(load - halfLoad);
+        if (ownsAll && (bestChild == -1 || difference < bestDifference)) {
+            bestChild = i;
+            bestDifference = difference;
+        }
+    }
+    return bestChild;
+}
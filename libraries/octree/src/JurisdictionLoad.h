@@ -0,0 +1,101 @@
+//
+//  JurisdictionLoad.h
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  The load on each of the eight subtrees under a jurisdiction's root, measured over fixed intervals, and the splits and
+//  merges of the jurisdiction that the load calls for. It doesn't lock, the owner guards it.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JurisdictionLoad_h
+#define hifi_JurisdictionLoad_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSet>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+
+#include <OctalCode.h>
+
+#include "JurisdictionMap.h"
+#include "OctreeConstants.h"
+
+class JurisdictionLoad {
+public:
+    static const float DEFAULT_SPLIT_LOAD; // busy time per second of the whole jurisdiction before a split is proposed
+    static const float DEFAULT_MERGE_LOAD; // busy time per second below which a merge is proposed
+    static const int INTERVALS_BEFORE_SPLIT = 3;
+    static const int INTERVALS_BEFORE_MERGE = 6;
+
+    // the whole jurisdiction, which also gets the edits addressed to the root like particle and model edits
+    static const int TOTAL = NUMBER_OF_CHILDREN;
+
+    class SubtreeLoad {
+    public:
+        SubtreeLoad() : edits(0), editUsecs(0), encodeUsecs(0) { }
+
+        void reset() { edits = 0; editUsecs = 0; encodeUsecs = 0; clients.clear(); }
+        float getLoad(quint64 intervalUsecs) const { return (float)(editUsecs + encodeUsecs) / intervalUsecs; }
+
+        int edits;
+        quint64 editUsecs;
+        quint64 encodeUsecs;
+        QSet<QUuid> clients;
+    };
+
+    enum Proposal {
+        NO_PROPOSAL,
+        SPLIT_PROPOSAL,
+        MERGE_PROPOSAL
+    };
+
+    /// \param jurisdiction NULL for the whole universe
+    JurisdictionLoad(const JurisdictionMap* jurisdiction = NULL);
+
+    /// Moves the root to that of the jurisdiction and forgets all load, which doesn't mean anything under a new root.
+    void setJurisdiction(const JurisdictionMap* jurisdiction);
+
+    /// editData starts with the octal code of the edit.
+    void recordEdit(const unsigned char* editData, int maxLength, quint64 processUsecs);
+
+    /// position is the client's position in voxel scale.
+    void recordEncode(const QUuid& clientID, const glm::vec3& position, quint64 encodeUsecs);
+
+    /// Makes the current interval the last complete one and starts a new one.
+    void endInterval(quint64 intervalUsecs);
+
+    /// Counts the last interval as busy, idle or neither, and proposes what the streak of such intervals calls for.
+    /// \param jurisdiction the map the load is measured under, only subtrees it owns completely are split off
+    /// \param splitChild set to the child to split off for a SPLIT_PROPOSAL
+    Proposal propose(const JurisdictionMap* jurisdiction, int& splitChild);
+
+    /// \return the child whose split leaves both halves closest to half of the load, -1 if no child has load
+    int chooseSplitChild(const JurisdictionMap* jurisdiction) const;
+
+    const unsigned char* getRootOctalCode() const { return reinterpret_cast<const unsigned char*>(_rootOctalCode.constData()); }
+    int getRootCodeLength() const { return _rootCodeLength; }
+
+    /// \param index a child number or TOTAL
+    const SubtreeLoad& getLast(int index) const { return _last[index]; }
+    float getLastLoad(int index) const { return _last[index].getLoad(_lastIntervalUsecs); }
+    quint64 getLastIntervalUsecs() const { return _lastIntervalUsecs; }
+    int getBusyIntervals() const { return _busyIntervals; }
+    int getIdleIntervals() const { return _idleIntervals; }
+
+private:
+    QByteArray _rootOctalCode;
+    int _rootCodeLength;
+    VoxelPositionSize _rootDetails;
+    SubtreeLoad _current[NUMBER_OF_CHILDREN + 1];
+    SubtreeLoad _last[NUMBER_OF_CHILDREN + 1];
+    quint64 _lastIntervalUsecs;
+    int _busyIntervals;
+    int _idleIntervals;
+};
+
+#endif // hifi_JurisdictionLoad_h
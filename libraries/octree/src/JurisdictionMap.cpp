@@ -33,6 +33,7 @@ JurisdictionMap::JurisdictionMap(JurisdictionMap&& other) : _rootOctalCode(NULL)
     init(other._rootOctalCode, other._endNodes);
     other._rootOctalCode = NULL;
     other._endNodes.clear();
+    other.buildIndex();
 }
 
 // move assignment
@@ -40,6 +41,7 @@ JurisdictionMap& JurisdictionMap::operator=(JurisdictionMap&& other) {
     init(other._rootOctalCode, other._endNodes);
     other._rootOctalCode = NULL;
     other._endNodes.clear();
+    other.buildIndex();
     return *this;
 }
 #endif
@@ -93,6 +95,8 @@ void JurisdictionMap::clear() {
         }
     }
     _endNodes.clear();
+    _rootSections.clear();
+    _endNodeTrie.clear();
 }
 
 JurisdictionMap::JurisdictionMap(NodeType_t type) : _rootOctalCode(NULL) {
@@ -175,6 +179,7 @@ JurisdictionMap::JurisdictionMap(const char* rootHexCode, const char* endNodesHe
         myDebugPrintOctalCode(endNodeOctcode, true);
 
     }    
+    buildIndex();
 }
 
 
@@ -182,29 +187,79 @@ void JurisdictionMap::init(unsigned char* rootOctalCode, const std::vector<unsig
     clear(); // clean up our own memory
     _rootOctalCode = rootOctalCode;
     _endNodes = endNodes;
+    buildIndex();
+}
+
+void JurisdictionMap::buildIndex() {
+    _rootSections.clear();
+    if (_rootOctalCode) {
+        int rootLength = numberOfThreeBitSectionsInCode(_rootOctalCode);
+        for (int section = 0; section < rootLength; section++) {
+            _rootSections.push_back(getOctalCodeSectionValue(_rootOctalCode, section));
+        }
+    }
+
+    _endNodeTrie.assign(1, EndNodeTrieNode());
+    for (size_t i = 0; i < _endNodes.size(); i++) {
+        if (!_endNodes[i]) {
+            continue;
+        }
+        int trieNode = 0;
+        int endNodeLength = numberOfThreeBitSectionsInCode(_endNodes[i]);
+        for (int section = 0; section < endNodeLength; section++) {
+            int value = getOctalCodeSectionValue(_endNodes[i], section);
+            if (_endNodeTrie[trieNode].children[value] == EndNodeTrieNode::NO_CHILD) {
+                _endNodeTrie[trieNode].children[value] = (int)_endNodeTrie.size();
+                _endNodeTrie.push_back(EndNodeTrieNode()); // invalidates references into the trie
+            }
+            trieNode = _endNodeTrie[trieNode].children[value];
+        }
+        _endNodeTrie[trieNode].isEndNode = true;
+    }
 }
 
 JurisdictionMap::Area JurisdictionMap::isMyJurisdiction(const unsigned char* nodeOctalCode, int childIndex) const {
     // to be in our jurisdiction, we must be under the root...
-
-    // if the node is an ancestor of my root, then we return ABOVE
-    if (isAncestorOf(nodeOctalCode, _rootOctalCode)) {
-        return ABOVE;
+    if (!_rootOctalCode || !nodeOctalCode) {
+        return BELOW;
     }
-    
-    // otherwise...
-    bool isInJurisdiction = isAncestorOf(_rootOctalCode, nodeOctalCode, childIndex);
-    // if we're under the root, then we can't be under any of the endpoints
-    if (isInJurisdiction) {
-        for (size_t i = 0; i < _endNodes.size(); i++) {
-            bool isUnderEndNode = isAncestorOf(_endNodes[i], nodeOctalCode);
+    int nodeLength = numberOfThreeBitSectionsInCode(nodeOctalCode);
+    int rootLength = _rootSections.size();
+
+    // walk down the node's sections once, matching them against the root and the end nodes at the same time
+    int trieNode = 0; // NO_CHILD once the node is off the path of every end node
+    bool isUnderEndNode = false;
+    for (int section = 0; section < nodeLength; section++) {
+        int value = getOctalCodeSectionValue(nodeOctalCode, section);
+        if (section < rootLength && value != _rootSections[section]) {
+            return BELOW; // neither an ancestor of the root nor under it
+        }
+        if (trieNode != EndNodeTrieNode::NO_CHILD && !isUnderEndNode) {
+            if (_endNodeTrie[trieNode].isEndNode) {
+                isUnderEndNode = true;
+            } else {
+                trieNode = _endNodeTrie[trieNode].children[value];
+            }
+        }
+        // once past the root, we're under it, and the end nodes decide as soon as they can
+        if (section >= rootLength) {
             if (isUnderEndNode) {
-                isInJurisdiction = false;
-                break;
+                return BELOW;
+            }
+            if (trieNode == EndNodeTrieNode::NO_CHILD) {
+                return WITHIN;
             }
         }
     }
-    return isInJurisdiction ? WITHIN : BELOW;
+
+    // if the node is an ancestor of my root, or my root itself, then we return ABOVE
+    if (nodeLength <= rootLength) {
+        return ABOVE;
+    }
+    if (isUnderEndNode || (trieNode != EndNodeTrieNode::NO_CHILD && _endNodeTrie[trieNode].isEndNode)) {
+        return BELOW;
+    }
+    return WITHIN;
 }
 
 
@@ -231,6 +286,7 @@ bool JurisdictionMap::readFromFile(const char* filename) {
         _endNodes.push_back(octcode);
     }
     settings.endGroup();
+    buildIndex();
     return true;
 }
 
@@ -296,7 +352,7 @@ int JurisdictionMap::packIntoMessage(unsigned char* destinationBuffer, int avail
 
     // add the root jurisdiction
     if (_rootOctalCode) {
-        size_t bytes = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(_rootOctalCode));
+        int bytes = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(_rootOctalCode));
         memcpy(destinationBuffer, &bytes, sizeof(bytes));
         destinationBuffer += sizeof(bytes);
         memcpy(destinationBuffer, _rootOctalCode, bytes);
@@ -309,7 +365,7 @@ int JurisdictionMap::packIntoMessage(unsigned char* destinationBuffer, int avail
 
         for (int i=0; i < endNodeCount; i++) {
             unsigned char* endNodeCode = _endNodes[i];
-            size_t bytes = 0;
+            int bytes = 0;
             if (endNodeCode) {
                 bytes = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(endNodeCode));
             }
@@ -327,6 +383,12 @@ int JurisdictionMap::packIntoMessage(unsigned char* destinationBuffer, int avail
     return destinationBuffer - bufferStart; // includes header!
 }
 
+// Jurisdictions are never anywhere near 255 levels deep, which is the only case where the length of a code takes more
+// than its first byte.
+static bool isOctalCodeOfSize(const unsigned char* octalCode, int bytes) {
+    return *octalCode != 255 && (int)bytesRequiredForCodeLength(*octalCode) == bytes;
+}
+
 int JurisdictionMap::unpackFromMessage(const unsigned char* sourceBuffer, int availableBytes) {
     clear();
     const unsigned char* startPosition = sourceBuffer;
@@ -335,14 +397,25 @@ int JurisdictionMap::unpackFromMessage(const unsigned char* sourceBuffer, int av
     int numBytesPacketHeader = numBytesForPacketHeader(reinterpret_cast<const char*>(sourceBuffer));
     sourceBuffer += numBytesPacketHeader;
     int remainingBytes = availableBytes - numBytesPacketHeader;
-    
+
+    // read the node type, packed in the first byte
+    NodeType_t type;
+    if (remainingBytes < (int)(sizeof(type) + sizeof(int))) {
+        return sourceBuffer - startPosition;
+    }
+    memcpy(&type, sourceBuffer, sizeof(type));
+    sourceBuffer += sizeof(type);
+    remainingBytes -= sizeof(type);
+    setNodeType(type);
+
     // read the root jurisdiction
     int bytes = 0;
     memcpy(&bytes, sourceBuffer, sizeof(bytes));
     sourceBuffer += sizeof(bytes);
     remainingBytes -= sizeof(bytes);
 
-    if (bytes > 0 && bytes <= remainingBytes) {
+    // the lengths come from the network, so a truncated or damaged packet stops at the first one that doesn't fit
+    if (bytes > 0 && bytes + (int)sizeof(int) <= remainingBytes && isOctalCodeOfSize(sourceBuffer, bytes)) {
         _rootOctalCode = new unsigned char[bytes];
         memcpy(_rootOctalCode, sourceBuffer, bytes);
         sourceBuffer += bytes;
@@ -352,25 +425,27 @@ int JurisdictionMap::unpackFromMessage(const unsigned char* sourceBuffer, int av
         int endNodeCount = 0;
         memcpy(&endNodeCount, sourceBuffer, sizeof(endNodeCount));
         sourceBuffer += sizeof(endNodeCount);
-        for (int i=0; i < endNodeCount; i++) {
+        remainingBytes -= sizeof(endNodeCount);
+        for (int i = 0; i < endNodeCount && remainingBytes >= (int)sizeof(int); i++) {
             int bytes = 0;
             memcpy(&bytes, sourceBuffer, sizeof(bytes));
             sourceBuffer += sizeof(bytes);
             remainingBytes -= sizeof(bytes);
-            
-            if (bytes <= remainingBytes) {
+            if (bytes < 0 || bytes > remainingBytes) {
+                break;
+            }
+
+            // if the endNodeCode was 0 length then don't add it
+            if (bytes > 0 && isOctalCodeOfSize(sourceBuffer, bytes)) {
                 unsigned char* endNodeCode = new unsigned char[bytes];
                 memcpy(endNodeCode, sourceBuffer, bytes);
-                sourceBuffer += bytes;
-                remainingBytes -= bytes;
-            
-                // if the endNodeCode was 0 length then don't add it
-                if (bytes > 0) {
-                    _endNodes.push_back(endNodeCode);
-                }
+                _endNodes.push_back(endNodeCode);
             }
+            sourceBuffer += bytes;
+            remainingBytes -= bytes;
         }
     }
-    
+    buildIndex();
+
     return sourceBuffer - startPosition; // includes header!
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_JurisdictionMap_h
 #define hifi_JurisdictionMap_h
 
+#include <algorithm>
 #include <map>
 #include <stdint.h>
 #include <vector>
@@ -22,6 +23,8 @@
 
 #include <Node.h>
 
+#include "OctreeConstants.h"
+
 class JurisdictionMap {
 public:
     enum Area {
@@ -49,6 +52,11 @@ public:
     JurisdictionMap(const char* rootHextString, const char* endNodesHextString);
     ~JurisdictionMap();
 
+    /// Where the element with nodeOctalCode is relative to this jurisdiction. Elements that are ancestors of the root,
+    /// or the root itself, are ABOVE. Elements under the root that are not under any end node are WITHIN, and
+    /// everything else is BELOW, including the end nodes. The answer for a child of the element is the same as for the
+    /// element, so childIndex doesn't change it. Uses an index built whenever the map changes, so it takes time in the
+    /// depth of the code and does not allocate.
     Area isMyJurisdiction(const unsigned char* nodeOctalCode, int childIndex) const;
 
     bool writeToFile(const char* filename);
@@ -72,13 +80,28 @@ public:
     void setNodeType(NodeType_t type) { _nodeType = type; }
     
 private:
+    /// a node in the trie of the end nodes' sections, the root of the trie is at index 0
+    class EndNodeTrieNode {
+    public:
+        static const int NO_CHILD = -1;
+
+        EndNodeTrieNode() : isEndNode(false) { std::fill(children, children + NUMBER_OF_CHILDREN, (int)NO_CHILD); }
+
+        int children[NUMBER_OF_CHILDREN];
+        bool isEndNode;
+    };
+
     void copyContents(const JurisdictionMap& other); // use assignment instead
     void clear();
     void init(unsigned char* rootOctalCode, const std::vector<unsigned char*>& endNodes);
+    void buildIndex(); // must be called whenever the root or end nodes change
 
     unsigned char* _rootOctalCode;
     std::vector<unsigned char*> _endNodes;
     NodeType_t _nodeType;
+
+    std::vector<unsigned char> _rootSections;
+    std::vector<EndNodeTrieNode> _endNodeTrie;
 };
 
 /// Map between node IDs and their reported JurisdictionMap. Typically used by classes that need to know which nodes are 
@@ -39,6 +39,22 @@ void JurisdictionSender::processPacket(const SharedNodePointer& sendingNode, con
     }
 }
 
+void JurisdictionSender::setJurisdiction(JurisdictionMap* map) {
+    lockRequestingNodes();
+    _jurisdictionMap = map;
+    unlockRequestingNodes();
+}
+
+void JurisdictionSender::broadcastJurisdiction() {
+    lockRequestingNodes();
+    foreach (const SharedNodePointer& node, NodeList::getInstance()->getNodeHash()) {
+        if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
+            _nodesRequestingJurisdictions.push(node->getUUID());
+        }
+    }
+    unlockRequestingNodes();
+}
+
 bool JurisdictionSender::process() {
     bool continueProcessing = isStillRunning();
 
@@ -48,15 +64,14 @@ bool JurisdictionSender::process() {
         static unsigned char buffer[MAX_PACKET_SIZE];
         unsigned char* bufferOut = &buffer[0];
         int sizeOut = 0;
+        int nodeCount = 0;
 
+        lockRequestingNodes();
         if (_jurisdictionMap) {
             sizeOut = _jurisdictionMap->packIntoMessage(bufferOut, MAX_PACKET_SIZE);
         } else {
             sizeOut = JurisdictionMap::packEmptyJurisdictionIntoMessage(getNodeType(), bufferOut, MAX_PACKET_SIZE);
         }
-        int nodeCount = 0;
-
-        lockRequestingNodes();
         while (!_nodesRequestingJurisdictions.empty()) {
 
             QUuid nodeUUID = _nodesRequestingJurisdictions.front();
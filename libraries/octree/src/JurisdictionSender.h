@@ -30,7 +30,13 @@ public:
     JurisdictionSender(JurisdictionMap* map, NodeType_t type = NodeType::VoxelServer);
     ~JurisdictionSender();
 
-    void setJurisdiction(JurisdictionMap* map) { _jurisdictionMap = map; }
+    /// Replaces the map that is sent, the caller still owns it. The previous map may be in the middle of being packed,
+    /// so the caller must not delete it until this returns.
+    void setJurisdiction(JurisdictionMap* map);
+
+    /// Sends the current map to every agent, not just the ones that asked for it. Used after the jurisdiction changes,
+    /// so that edit senders stop routing edits by the old map as soon as possible.
+    void broadcastJurisdiction();
 
     virtual bool process();
 
@@ -0,0 +1,196 @@
+//
+//  OcclusionBuffer.cpp
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <QtCore/QDebug>
+
+#include "OcclusionBuffer.h"
+
+const float OcclusionBuffer::NOT_COVERED = FLT_MAX;
+const int OcclusionBuffer::RESOLUTION;
+const int OcclusionBuffer::LEVEL_COUNT;
+const int OcclusionBuffer::PYRAMID_SIZE;
+
+AtomicCounter OcclusionBuffer::_occlusionTests;
+AtomicCounter OcclusionBuffer::_occludedCount;
+AtomicCounter OcclusionBuffer::_storedCount;
+AtomicCounter OcclusionBuffer::_pixelsWritten;
+
+// the size of a pixel in the -1 to 1 projected space
+const float PIXEL_SIZE = 2.0f / OcclusionBuffer::RESOLUTION;
+
+/// inclusive range of finest level pixels
+class OcclusionBuffer::PixelRange {
+public:
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+};
+
+OcclusionBuffer::OcclusionBuffer() {
+    int offset = 0;
+    for (int level = 0; level < LEVEL_COUNT; level++) {
+        _levelOffsets[level] = offset;
+        int side = RESOLUTION >> level;
+        offset += side * side;
+    }
+    erase();
+}
+
+void OcclusionBuffer::erase() {
+    std::fill(_minDepth, _minDepth + PYRAMID_SIZE, NOT_COVERED);
+    std::fill(_maxDepth, _maxDepth + PYRAMID_SIZE, NOT_COVERED);
+    _occluderCount = 0;
+}
+
+void OcclusionBuffer::printStats() {
+    qDebug("OcclusionBuffer::printStats()...");
+    qDebug("_occluderCount=%d", _occluderCount);
+    qDebug("_occlusionTests=%lld", _occlusionTests.get());
+    qDebug("_occludedCount=%lld", _occludedCount.get());
+    qDebug("_storedCount=%lld", _storedCount.get());
+    qDebug("_pixelsWritten=%lld", _pixelsWritten.get());
+}
+
+static int pixelForCoordinate(float coordinate) {
+    int pixel = (int)floorf((coordinate + 1.0f) / PIXEL_SIZE);
+    return std::max(0, std::min(OcclusionBuffer::RESOLUTION - 1, pixel));
+}
+
+bool OcclusionBuffer::getPixelRange(const OctreeProjectedPolygon& polygon, PixelRange& range) const {
+    if (polygon.getVertexCount() < 3 || polygon.getMaxX() < -1.0f || polygon.getMinX() > 1.0f ||
+            polygon.getMaxY() < -1.0f || polygon.getMinY() > 1.0f) {
+        return false;
+    }
+    // every pixel the bounds touch, which is conservative for occludees
+    range.minX = pixelForCoordinate(polygon.getMinX());
+    range.minY = pixelForCoordinate(polygon.getMinY());
+    range.maxX = pixelForCoordinate(polygon.getMaxX());
+    range.maxY = pixelForCoordinate(polygon.getMaxY());
+    return true;
+}
+
+bool OcclusionBuffer::isOccluded(int level, int x, int y, const PixelRange& range, float nearDistance) const {
+    // skip the parts of the tile that are outside of the occludee, they don't need to be covered
+    int firstPixelX = x << level;
+    int firstPixelY = y << level;
+    int lastPixelX = firstPixelX + (1 << level) - 1;
+    int lastPixelY = firstPixelY + (1 << level) - 1;
+    if (lastPixelX < range.minX || firstPixelX > range.maxX || lastPixelY < range.minY || firstPixelY > range.maxY) {
+        return true;
+    }
+    // every pixel of the tile has an occluder nearer than the occludee
+    if (getMaxDepth(level, x, y) < nearDistance) {
+        return true;
+    }
+    // no pixel of the tile does, and at least one of them is under the occludee
+    if (level == 0 || getMinDepth(level, x, y) >= nearDistance) {
+        return false;
+    }
+    int childLevel = level - 1;
+    return isOccluded(childLevel, x * 2, y * 2, range, nearDistance) &&
+           isOccluded(childLevel, x * 2 + 1, y * 2, range, nearDistance) &&
+           isOccluded(childLevel, x * 2, y * 2 + 1, range, nearDistance) &&
+           isOccluded(childLevel, x * 2 + 1, y * 2 + 1, range, nearDistance);
+}
+
+bool OcclusionBuffer::rasterize(const OctreeProjectedPolygon& polygon, const PixelRange& range, float farDistance) {
+    // the projected shadow of a box is convex, so a pixel is inside if it is on the inner side of every edge. Work out
+    // the winding first so that inner is always to the left
+    int vertexCount = polygon.getVertexCount();
+    float doubleArea = 0.0f;
+    for (int i = 0; i < vertexCount; i++) {
+        const glm::vec2& a = polygon.getVertex(i);
+        const glm::vec2& b = polygon.getVertex((i + 1) % vertexCount);
+        doubleArea += a.x * b.y - b.x * a.y;
+    }
+    if (doubleArea == 0.0f) {
+        return false;
+    }
+    float winding = (doubleArea > 0.0f) ? 1.0f : -1.0f;
+
+    int pixelsWritten = 0;
+    for (int y = range.minY; y <= range.maxY; y++) {
+        float pixelMinY = -1.0f + y * PIXEL_SIZE;
+        float pixelMaxY = pixelMinY + PIXEL_SIZE;
+        for (int x = range.minX; x <= range.maxX; x++) {
+            float pixelMinX = -1.0f + x * PIXEL_SIZE;
+            float pixelMaxX = pixelMinX + PIXEL_SIZE;
+
+            // for each edge only the corner of the pixel that is farthest to the outside matters
+            bool inside = true;
+            for (int i = 0; i < vertexCount && inside; i++) {
+                const glm::vec2& a = polygon.getVertex(i);
+                const glm::vec2& b = polygon.getVertex((i + 1) % vertexCount);
+                float edgeX = (b.x - a.x) * winding;
+                float edgeY = (b.y - a.y) * winding;
+                float cornerX = (edgeY > 0.0f) ? pixelMaxX : pixelMinX;
+                float cornerY = (edgeX > 0.0f) ? pixelMinY : pixelMaxY;
+                inside = (edgeX * (cornerY - a.y) - edgeY * (cornerX - a.x)) >= 0.0f;
+            }
+            if (inside) {
+                float* depth = maxDepthAt(0, x, y);
+                if (farDistance < *depth) {
+                    *depth = farDistance;
+                    *minDepthAt(0, x, y) = farDistance;
+                    pixelsWritten++;
+                }
+            }
+        }
+    }
+    _pixelsWritten += pixelsWritten;
+    return pixelsWritten > 0;
+}
+
+void OcclusionBuffer::updatePyramid(const PixelRange& range) {
+    for (int level = 1; level < LEVEL_COUNT; level++) {
+        int childLevel = level - 1;
+        for (int y = range.minY >> level; y <= range.maxY >> level; y++) {
+            for (int x = range.minX >> level; x <= range.maxX >> level; x++) {
+                float minDepth = NOT_COVERED;
+                float maxDepth = 0.0f;
+                for (int child = 0; child < 4; child++) {
+                    int childX = x * 2 + (child & 1);
+                    int childY = y * 2 + (child >> 1);
+                    minDepth = std::min(minDepth, getMinDepth(childLevel, childX, childY));
+                    maxDepth = std::max(maxDepth, getMaxDepth(childLevel, childX, childY));
+                }
+                *minDepthAt(level, x, y) = minDepth;
+                *maxDepthAt(level, x, y) = maxDepth;
+            }
+        }
+    }
+}
+
+CoverageMapStorageResult OcclusionBuffer::checkBuffer(const OctreeProjectedPolygon& polygon,
+                                                      float nearDistance, float farDistance, bool storeIt) {
+    PixelRange range;
+    if (!getPixelRange(polygon, range)) {
+        return NOT_STORED;
+    }
+
+    _occlusionTests++;
+    if (_occluderCount > 0 && isOccluded(LEVEL_COUNT - 1, 0, 0, range, nearDistance)) {
+        _occludedCount++;
+        return OCCLUDED;
+    }
+
+    if (storeIt && rasterize(polygon, range, farDistance)) {
+        updatePyramid(range);
+        _occluderCount++;
+        _storedCount++;
+        return STORED;
+    }
+    return NOT_STORED;
+}
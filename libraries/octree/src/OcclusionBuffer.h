@@ -0,0 +1,80 @@
+//
+//  OcclusionBuffer.h
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A hierarchical occlusion buffer, an alternative to CoverageMap and CoverageMapV2 for occlusion culling while
+//  encoding. Occluders are rasterized into a fixed low resolution depth buffer, and a pyramid of the min and max depth
+//  of each tile lets most tests stop at a coarse level. It uses the same -1 to 1 projected space as the coverage maps,
+//  and all of its storage is inline, so checking an element never allocates.
+//
+//  Both directions are conservative. An occluder only covers the pixels that lie entirely inside its polygon, and it
+//  covers them with its farthest distance. An occludee is tested against every pixel its bounds touch, using its nearest
+//  distance. So an element is only reported as occluded if it really is hidden.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OcclusionBuffer_h
+#define hifi_OcclusionBuffer_h
+
+#include <AtomicCounter.h>
+
+#include "CoverageMap.h"
+#include "OctreeProjectedPolygon.h"
+
+class OcclusionBuffer {
+public:
+    static const int RESOLUTION = 64; // pixels on a side at the finest level
+    static const int LEVEL_COUNT = 7; // 64x64 down to 1x1
+    static const float NOT_COVERED;
+
+    OcclusionBuffer();
+
+    /// Checks whether polygon, whose content lies between nearDistance and farDistance from the camera, is hidden by the
+    /// occluders stored so far. If it is not, and storeIt is set, it is stored as an occluder.
+    /// \return OCCLUDED, STORED, or NOT_STORED if it is visible and wasn't stored or was too small to cover any pixel
+    CoverageMapStorageResult checkBuffer(const OctreeProjectedPolygon& polygon, float nearDistance, float farDistance,
+                                         bool storeIt = true);
+
+    void erase(); // remove all occluders
+
+    int getOccluderCount() const { return _occluderCount; }
+
+    void printStats();
+
+    // shared by the buffers of every send thread
+    static AtomicCounter _occlusionTests;
+    static AtomicCounter _occludedCount;
+    static AtomicCounter _storedCount;
+    static AtomicCounter _pixelsWritten;
+
+private:
+    class PixelRange;
+
+    bool getPixelRange(const OctreeProjectedPolygon& polygon, PixelRange& range) const;
+    bool isOccluded(int level, int x, int y, const PixelRange& range, float nearDistance) const;
+    bool rasterize(const OctreeProjectedPolygon& polygon, const PixelRange& range, float farDistance);
+    void updatePyramid(const PixelRange& range);
+
+    float* minDepthAt(int level, int x, int y) { return &_minDepth[_levelOffsets[level] + y * (RESOLUTION >> level) + x]; }
+    float* maxDepthAt(int level, int x, int y) { return &_maxDepth[_levelOffsets[level] + y * (RESOLUTION >> level) + x]; }
+    float getMinDepth(int level, int x, int y) const {
+        return _minDepth[_levelOffsets[level] + y * (RESOLUTION >> level) + x];
+    }
+    float getMaxDepth(int level, int x, int y) const {
+        return _maxDepth[_levelOffsets[level] + y * (RESOLUTION >> level) + x];
+    }
+
+    // (64^2 + 32^2 + ... + 1) entries, the finest level first
+    static const int PYRAMID_SIZE = 5461;
+
+    int _levelOffsets[LEVEL_COUNT];
+    float _minDepth[PYRAMID_SIZE]; // nearest occluder depth of any pixel in each tile
+    float _maxDepth[PYRAMID_SIZE]; // farthest occluder depth of any pixel in each tile, NOT_COVERED if any are empty
+    int _occluderCount;
+};
+
+#endif // hifi_OcclusionBuffer_h
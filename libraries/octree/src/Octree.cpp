@@ -13,13 +13,20 @@
 #define _USE_MATH_DEFINES
 #endif
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 #include <cmath>
 #include <fstream> // to load voxels from file
+#include <vector>
 
 #include <QDebug>
+#include <QFile>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
 
+#include <AtomicCounter.h>
 #include <GeometryUtil.h>
 #include <OctalCode.h>
 #include <PacketHeaders.h>
@@ -30,6 +37,7 @@
 //#include "Tags.h"
 
 #include "CoverageMap.h"
+#include "OcclusionBuffer.h"
 #include "OctreeConstants.h"
 #include "OctreeElementBag.h"
 #include "Octree.h"
@@ -43,7 +51,8 @@ Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
     _isDirty(true),
     _shouldReaverage(shouldReaverage),
-    _stopImport(false),
+    _stopImport(0),
+    _maxLoadThreads(0),
     _lock(),
     _isViewing(false) 
 {
@@ -125,11 +134,14 @@ void Octree::recurseElementWithOperationDistanceSorted(OctreeElement* element, R
         int indexOfChildren[NUMBER_OF_CHILDREN] = { 0, 0, 0, 0, 0, 0, 0, 0 };
         int currentCount = 0;
 
+        // the squared distances sort the same way, and can be calculated for all of the children at once
+        float distancesSquared[NUMBER_OF_CHILDREN];
+        ViewFrustum::calculateChildDistancesSquared(element->getAACube(), point, distancesSquared);
+
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
             OctreeElement* childElement = element->getChildAtIndex(i);
             if (childElement) {
-                // chance to optimize, doesn't need to be actual distance!! Could be distance squared
-                float distanceSquared = childElement->distanceSquareToPoint(point);
+                float distanceSquared = distancesSquared[i];
                 currentCount = insertIntoSortedArrays((void*)childElement, distanceSquared, i,
                                                       (void**)&sortedChildren, (float*)&distancesToChildren,
                                                       (int*)&indexOfChildren, currentCount, NUMBER_OF_CHILDREN);
@@ -240,7 +252,7 @@ int Octree::readElementData(OctreeElement* destinationElement, const unsigned ch
             if (!destinationElement->getChildAtIndex(i)) {
                 destinationElement->addChildAtIndex(i);
                 if (destinationElement->isDirty()) {
-                    _isDirty = true;
+                    args.treeIsDirty = true;
                 }
             }
 
@@ -248,7 +260,7 @@ int Octree::readElementData(OctreeElement* destinationElement, const unsigned ch
             bool nodeIsDirty = false;
             if (childElementAt) {
                 bytesRead += childElementAt->readElementDataFromBuffer(nodeData + bytesRead, bytesLeftToRead, args);
-                childElementAt->setSourceUUID(args.sourceUUID);
+                childElementAt->setSourceUUIDKey(args.sourceUUIDKey);
 
                 // if we had a local version of the element already, it's possible that we have it already but
                 // with the same color data, so this won't count as a change. To address this we check the following
@@ -259,7 +271,7 @@ int Octree::readElementData(OctreeElement* destinationElement, const unsigned ch
                 nodeIsDirty = childElementAt->isDirty();
             }
             if (nodeIsDirty) {
-                _isDirty = true;
+                args.treeIsDirty = true;
             }
         }
     }
@@ -280,7 +292,7 @@ int Octree::readElementData(OctreeElement* destinationElement, const unsigned ch
                 destinationElement->addChildAtIndex(childIndex);
                 bool nodeIsDirty = destinationElement->isDirty();
                 if (nodeIsDirty) {
-                    _isDirty = true;
+                    args.treeIsDirty = true;
                 }
             }
 
@@ -297,7 +309,7 @@ int Octree::readElementData(OctreeElement* destinationElement, const unsigned ch
             // subtree/element, because it shouldn't actually exist in the tree.
             if (!oneAtBit(childrenInTreeMask, i) && destinationElement->getChildAtIndex(i)) {
                 destinationElement->safeDeepDeleteChildAtIndex(i);
-                _isDirty = true; // by definition!
+                args.treeIsDirty = true; // by definition!
             }
         }
     }
@@ -311,47 +323,422 @@ int Octree::readElementData(OctreeElement* destinationElement, const unsigned ch
     return bytesRead;
 }
 
+int Octree::readBitstreamSubtree(OctreeElement* ancestorElement, const unsigned char* bitstreamAt, int bytesLeftToRead,
+                                 ReadBitstreamToTreeParams& args) {
+    OctreeElement* bitstreamRootElement = ancestorElement;
+    if (*bitstreamAt != *ancestorElement->getOctalCode()) {
+        bitstreamRootElement = nodeForOctalCode(ancestorElement, bitstreamAt, NULL);
+    }
+    if (*bitstreamAt != *bitstreamRootElement->getOctalCode()) {
+        // if the octal code returned is not on the same level as
+        // the code being searched for, we have OctreeElements to create
+
+        // Note: we need to create this element relative to root, because we're assuming that the bitstream for the initial
+        // octal code is always relative to root!
+        bitstreamRootElement = createMissingElement(ancestorElement, bitstreamAt);
+        if (bitstreamRootElement->isDirty()) {
+            args.treeIsDirty = true;
+        }
+    }
+    return readElementData(bitstreamRootElement, bitstreamAt + bytesRequiredForCodeLength(*bitstreamAt),
+                           bytesLeftToRead, args);
+}
+
 void Octree::readBitstreamToTree(const unsigned char * bitstream, unsigned long int bufferSizeBytes,
                                     ReadBitstreamToTreeParams& args) {
-    int bytesRead = 0;
+    unsigned long int bytesRead = 0;
     const unsigned char* bitstreamAt = bitstream;
+    int lastProgressReported = -1;
 
     // If destination element is not included, set it to root
     if (!args.destinationElement) {
         args.destinationElement = _rootElement;
     }
+    args.sourceUUIDKey = OctreeElement::addSourceUUIDKey(args.sourceUUID);
+    args.treeIsDirty = false;
 
     // Keep looping through the buffer calling readElementData() this allows us to pack multiple root-relative Octal codes
     // into a single network packet. readElementData() basically goes down a tree from the root, and fills things in from there
     // if there are more bytes after that, it's assumed to be another root relative tree
 
     while (bitstreamAt < bitstream + bufferSizeBytes) {
-        OctreeElement* bitstreamRootElement = nodeForOctalCode(args.destinationElement, (unsigned char *)bitstreamAt, NULL);
-        if (*bitstreamAt != *bitstreamRootElement->getOctalCode()) {
-            // if the octal code returned is not on the same level as
-            // the code being searched for, we have OctreeElements to create
-
-            // Note: we need to create this element relative to root, because we're assuming that the bitstream for the initial
-            // octal code is always relative to root!
-            bitstreamRootElement = createMissingElement(args.destinationElement, (unsigned char*) bitstreamAt);
-            if (bitstreamRootElement->isDirty()) {
-                _isDirty = true;
-            }
+        // imports can be canceled between root relative subtrees, the tree is left with whatever was read so far
+        if (args.wantImportProgress && _stopImport.loadAcquire()) {
+            qDebug("Canceled import after %lu of %lu bytes.", bytesRead, bufferSizeBytes);
+            break;
         }
 
         int octalCodeBytes = bytesRequiredForCodeLength(*bitstreamAt);
+
+        // Each root relative subtree was written from a single packet or section, so it can never be larger than the
+        // largest section. Clamping here keeps large (multi-GB) SVO files from overflowing the int sized element
+        // readers.
+        unsigned long int bytesLeftInBitstream = bufferSizeBytes - (bytesRead + octalCodeBytes);
+        int bytesLeftToRead = (int)std::min(bytesLeftInBitstream, (unsigned long int)MAX_OCTREE_PREDICTED_SECTION_SIZE);
+
         int theseBytesRead = 0;
         theseBytesRead += octalCodeBytes;
-        theseBytesRead += readElementData(bitstreamRootElement, bitstreamAt + octalCodeBytes,
-                                       bufferSizeBytes - (bytesRead + octalCodeBytes), args);
+        theseBytesRead += readBitstreamSubtree(args.destinationElement, bitstreamAt, bytesLeftToRead, args);
         // skip bitstream to new startPoint
         bitstreamAt += theseBytesRead;
         bytesRead +=  theseBytesRead;
 
+        // only signal when the percentage actually moves, large files contain millions of subtrees
         if (args.wantImportProgress) {
-            emit importProgress((100 * (bitstreamAt - bitstream)) / bufferSizeBytes);
+            int progress = (int)((100 * (quint64)bytesRead) / bufferSizeBytes);
+            if (progress != lastProgressReported) {
+                lastProgressReported = progress;
+                emit importProgress(progress);
+            }
+        }
+    }
+    if (args.treeIsDirty) {
+        _isDirty = true;
+    }
+}
+
+int Octree::skipElementData(const unsigned char* nodeData, int bytesLeftToRead, bool isRoot,
+                            const ReadBitstreamToTreeParams& args) const {
+    // this takes the same steps as readElementData(), and gives up wherever that would read past the end of the data
+    if (bytesLeftToRead < (int)sizeof(unsigned char)) {
+        return -1;
+    }
+    unsigned char colorInPacketMask = *nodeData;
+    int bytesRead = sizeof(colorInPacketMask);
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        if (oneAtBit(colorInPacketMask, i)) {
+            int dataBytes = elementDataSizeInBuffer(nodeData + bytesRead, bytesLeftToRead - bytesRead, args);
+            if (dataBytes < 0 || bytesRead + dataBytes > bytesLeftToRead) {
+                return -1;
+            }
+            bytesRead += dataBytes;
+        }
+    }
+
+    int existsBytes = args.includeExistsBits ? sizeof(unsigned char) : 0;
+    if (bytesRead + existsBytes + (int)sizeof(unsigned char) > bytesLeftToRead) {
+        return -1;
+    }
+    unsigned char childMask = *(nodeData + bytesRead + existsBytes);
+    bytesRead += existsBytes + sizeof(childMask);
+
+    for (int childIndex = 0; bytesLeftToRead - bytesRead > 0 && childIndex < NUMBER_OF_CHILDREN; childIndex++) {
+        if (oneAtBit(childMask, childIndex)) {
+            int childBytes = skipElementData(nodeData + bytesRead, bytesLeftToRead - bytesRead, false, args);
+            if (childBytes < 0) {
+                return -1;
+            }
+            bytesRead += childBytes;
+        }
+    }
+
+    if (isRoot && rootElementHasData() && (bytesLeftToRead - bytesRead) > 0) {
+        int dataBytes = elementDataSizeInBuffer(nodeData + bytesRead, bytesLeftToRead - bytesRead, args);
+        if (dataBytes < 0 || bytesRead + dataBytes > bytesLeftToRead) {
+            return -1;
+        }
+        bytesRead += dataBytes;
+    }
+    return bytesRead;
+}
+
+// files smaller than this are read faster than they can be split up
+const unsigned long int MIN_PARALLEL_LOAD_BYTES = 1024 * 1024;
+
+// subtrees are grouped by their ancestor at no more than this depth, which makes at most 512 groups
+const int MAX_LOAD_PARTITION_DEPTH = 3;
+
+// a root relative subtree of a bitstream, found without reading it into the tree
+class BitstreamSubtree {
+public:
+    const unsigned char* octalCode;
+    int bytesLeftToRead; // what readBitstreamToTree() would give to its element data
+    int length; // of the octal code and element data
+};
+
+// the subtrees below one element at the partition depth, which one thread reads in bitstream order
+class SubtreeGroup {
+public:
+    OctreeElement* root;
+    int key;
+    int first; // index of the first subtree in the grouped subtrees
+    int count;
+    quint64 bytes;
+};
+
+static bool groupHasMoreBytes(const SubtreeGroup& first, const SubtreeGroup& second) {
+    return first.bytes > second.bytes;
+}
+
+// the branches that octalCode takes down to depth, as one number
+static int partitionKey(const unsigned char* octalCode, int depth) {
+    int key = 0;
+    for (unsigned char sections = 0; sections < depth; sections++) {
+        // the length byte is all of the ancestor code that branchIndexWithDescendant() looks at
+        key = key * NUMBER_OF_CHILDREN + branchIndexWithDescendant(&sections, octalCode);
+    }
+    return key;
+}
+
+// the bytes that the busiest thread reads when the subtrees are grouped at depth: the shallower subtrees, which one
+// thread reads between the runs of deeper ones, and for every run either its biggest group or its share of the threads
+static quint64 busiestThreadBytes(const std::vector<BitstreamSubtree>& subtrees, int depth, int numThreads) {
+    std::vector<quint64> groupBytes(1 << (BITS_IN_OCTAL * depth), 0);
+    std::vector<int> usedKeys;
+    quint64 busiestBytes = 0;
+    quint64 runBytes = 0;
+    quint64 biggestGroupBytes = 0;
+    int numSubtrees = subtrees.size();
+    for (int i = 0; i <= numSubtrees; i++) {
+        if (i == numSubtrees || *subtrees[i].octalCode < depth) {
+            busiestBytes += std::max(biggestGroupBytes, runBytes / numThreads);
+            for (size_t j = 0; j < usedKeys.size(); j++) {
+                groupBytes[usedKeys[j]] = 0;
+            }
+            usedKeys.clear();
+            runBytes = biggestGroupBytes = 0;
+            if (i < numSubtrees) {
+                busiestBytes += subtrees[i].length;
+            }
+        } else {
+            int key = partitionKey(subtrees[i].octalCode, depth);
+            if (groupBytes[key] == 0) {
+                usedKeys.push_back(key);
+            }
+            groupBytes[key] += subtrees[i].length;
+            biggestGroupBytes = std::max(biggestGroupBytes, groupBytes[key]);
+            runBytes += subtrees[i].length;
         }
     }
+    return busiestBytes;
+}
+
+// the groups of one run of subtrees, which any number of threads take from until there are none left
+class SubtreeReadBatch {
+public:
+    SubtreeReadBatch(Octree* tree, const std::vector<SubtreeGroup>& groups,
+                     const std::vector<const BitstreamSubtree*>& groupedSubtrees, const ReadBitstreamToTreeParams& args) :
+        _tree(tree),
+        _groups(groups),
+        _groupedSubtrees(groupedSubtrees),
+        _args(args),
+        _nextGroup(0),
+        _treeIsDirty(0) {
+        _bytesRead.reset();
+    }
+
+    /// \param reportProgress whether this is the thread that the tree signals import progress on
+    /// \param bytesBefore the bytes of the bitstream read before this batch
+    /// \param bufferSizeBytes the size of the whole bitstream
+    void readGroups(bool reportProgress, quint64 bytesBefore, quint64 bufferSizeBytes, int& lastProgressReported) {
+        ReadBitstreamToTreeParams args(_args);
+        args.treeIsDirty = false;
+        int numGroups = _groups.size();
+        bool canceled = false;
+        for (int i = _nextGroup.fetchAndAddOrdered(1); i < numGroups && !canceled; i = _nextGroup.fetchAndAddOrdered(1)) {
+            const SubtreeGroup& group = _groups[i];
+            for (int j = 0; j < group.count; j++) {
+                if (args.wantImportProgress && _tree->_stopImport.loadAcquire()) {
+                    canceled = true;
+                    break;
+                }
+                const BitstreamSubtree* subtree = _groupedSubtrees[group.first + j];
+                _tree->readBitstreamSubtree(group.root, subtree->octalCode, subtree->bytesLeftToRead, args);
+                _bytesRead += subtree->length;
+            }
+            if (reportProgress && args.wantImportProgress) {
+                int progress = (int)((100 * (bytesBefore + _bytesRead.get())) / bufferSizeBytes);
+                if (progress != lastProgressReported) {
+                    lastProgressReported = progress;
+                    emit _tree->importProgress(progress);
+                }
+            }
+        }
+        if (args.treeIsDirty) {
+            _treeIsDirty.fetchAndStoreRelaxed(1);
+        }
+    }
+
+    bool isTreeDirty() const { return _treeIsDirty.load() != 0; }
+
+    QSemaphore finishedThreads;
+
+private:
+    Octree* _tree;
+    const std::vector<SubtreeGroup>& _groups;
+    const std::vector<const BitstreamSubtree*>& _groupedSubtrees;
+    const ReadBitstreamToTreeParams& _args;
+    QAtomicInt _nextGroup;
+    QAtomicInt _treeIsDirty;
+    AtomicCounter _bytesRead;
+};
+
+class SubtreeReader : public QRunnable {
+public:
+    SubtreeReader(SubtreeReadBatch* batch) : _batch(batch) { }
+
+    virtual void run() {
+        int unusedProgress = -1;
+        _batch->readGroups(false, 0, 1, unusedProgress);
+        _batch->finishedThreads.release();
+    }
+
+private:
+    SubtreeReadBatch* _batch;
+};
+
+bool Octree::readBitstreamToTreeInParallel(const unsigned char* bitstream, unsigned long int bufferSizeBytes,
+                                           ReadBitstreamToTreeParams& args) {
+    // update hooks, and the deletes that exists bits ask for, tell other code about the elements, which may not expect
+    // to hear from several threads at once
+    QThreadPool* threadPool = QThreadPool::globalInstance();
+    int numThreads = (_maxLoadThreads > 0) ? _maxLoadThreads : threadPool->maxThreadCount();
+    if (numThreads < 2 || bufferSizeBytes < MIN_PARALLEL_LOAD_BYTES || OctreeElement::hasUpdateHooks() ||
+            args.includeExistsBits || (args.destinationElement && args.destinationElement != _rootElement)) {
+        return false;
+    }
+
+    // find the root relative subtrees the way readBitstreamToTree() steps through them, if the bitstream isn't what
+    // we expect then the serial reader deals with it the way it always has
+    std::vector<BitstreamSubtree> subtrees;
+    unsigned long int bytesFound = 0;
+    while (bytesFound < bufferSizeBytes) {
+        const unsigned char* bitstreamAt = bitstream + bytesFound;
+        int octalCodeBytes = bytesRequiredForCodeLength(*bitstreamAt);
+        if (bytesFound + octalCodeBytes > bufferSizeBytes) {
+            return false;
+        }
+        unsigned long int bytesLeftInBitstream = bufferSizeBytes - (bytesFound + octalCodeBytes);
+        BitstreamSubtree subtree;
+        subtree.octalCode = bitstreamAt;
+        subtree.bytesLeftToRead = (int)std::min(bytesLeftInBitstream, (unsigned long int)MAX_OCTREE_PREDICTED_SECTION_SIZE);
+        int elementBytes = skipElementData(bitstreamAt + octalCodeBytes, subtree.bytesLeftToRead, *bitstreamAt == 0, args);
+        if (elementBytes < 0) {
+            return false;
+        }
+        subtree.length = octalCodeBytes + elementBytes;
+        subtrees.push_back(subtree);
+        bytesFound += subtree.length;
+    }
+
+    // group the subtrees at the depth where the busiest thread has the least to read
+    int partitionDepth = 0;
+    quint64 leastBusiestBytes = bufferSizeBytes;
+    for (int depth = 1; depth <= MAX_LOAD_PARTITION_DEPTH; depth++) {
+        quint64 busiestBytes = busiestThreadBytes(subtrees, depth, numThreads);
+        if (busiestBytes < leastBusiestBytes) {
+            leastBusiestBytes = busiestBytes;
+            partitionDepth = depth;
+        }
+    }
+    if (partitionDepth == 0) {
+        return false;
+    }
+
+    args.destinationElement = _rootElement;
+    args.sourceUUIDKey = OctreeElement::addSourceUUIDKey(args.sourceUUID);
+    args.treeIsDirty = false;
+
+    quint64 bytesRead = 0;
+    int lastProgressReported = -1;
+    std::vector<int> groupOfKey(1 << (BITS_IN_OCTAL * partitionDepth), -1);
+    std::vector<SubtreeGroup> groups;
+    std::vector<const BitstreamSubtree*> groupedSubtrees;
+    int numSubtrees = subtrees.size();
+    int subtreeIndex = 0;
+    while (subtreeIndex < numSubtrees) {
+        if (args.wantImportProgress && _stopImport.loadAcquire()) {
+            qDebug("Canceled import after %llu of %lu bytes.", bytesRead, bufferSizeBytes);
+            break;
+        }
+
+        // subtrees above the partition depth may reach into any group, so they're read on their own
+        const BitstreamSubtree& shallowSubtree = subtrees[subtreeIndex];
+        if (*shallowSubtree.octalCode < partitionDepth) {
+            readBitstreamSubtree(_rootElement, shallowSubtree.octalCode, shallowSubtree.bytesLeftToRead, args);
+            bytesRead += shallowSubtree.length;
+            subtreeIndex++;
+            if (args.wantImportProgress) {
+                int progress = (int)((100 * bytesRead) / bufferSizeBytes);
+                if (progress != lastProgressReported) {
+                    lastProgressReported = progress;
+                    emit importProgress(progress);
+                }
+            }
+            continue;
+        }
+
+        // the deeper subtrees up to the next shallow one are grouped by their ancestor at the partition depth, which is
+        // made here, the way createMissingElement() would, so that no two threads add children to the same element
+        int runEnd = subtreeIndex;
+        groups.clear();
+        for (; runEnd < numSubtrees && *subtrees[runEnd].octalCode >= partitionDepth; runEnd++) {
+            const BitstreamSubtree& subtree = subtrees[runEnd];
+            int key = partitionKey(subtree.octalCode, partitionDepth);
+            if (groupOfKey[key] < 0) {
+                OctreeElement* ancestor = _rootElement;
+                for (int level = 0; level < partitionDepth; level++) {
+                    int childIndex = branchIndexWithDescendant(ancestor->getOctalCode(), subtree.octalCode);
+                    if (ancestor->requiresSplit()) {
+                        ancestor->splitChildren();
+                    } else if (!ancestor->getChildAtIndex(childIndex)) {
+                        ancestor->addChildAtIndex(childIndex);
+                    }
+                    ancestor = ancestor->getChildAtIndex(childIndex);
+                }
+                if (ancestor->isDirty()) {
+                    args.treeIsDirty = true;
+                }
+                groupOfKey[key] = groups.size();
+                SubtreeGroup group = { ancestor, key, 0, 0, 0 };
+                groups.push_back(group);
+            }
+            groups[groupOfKey[key]].count++;
+            groups[groupOfKey[key]].bytes += subtree.length;
+        }
+        int first = 0;
+        quint64 runBytes = 0;
+        for (size_t i = 0; i < groups.size(); i++) {
+            groups[i].first = first;
+            first += groups[i].count;
+            runBytes += groups[i].bytes;
+            groups[i].count = 0;
+        }
+        groupedSubtrees.resize(first);
+        for (int i = subtreeIndex; i < runEnd; i++) {
+            SubtreeGroup& group = groups[groupOfKey[partitionKey(subtrees[i].octalCode, partitionDepth)]];
+            groupedSubtrees[group.first + group.count++] = &subtrees[i];
+        }
+        for (size_t i = 0; i < groups.size(); i++) {
+            groupOfKey[groups[i].key] = -1;
+        }
+
+        // the biggest groups go first, so that the threads finish at about the same time, the calling thread reads
+        // groups too, and only threads that the pool can start right away help
+        std::sort(groups.begin(), groups.end(), groupHasMoreBytes);
+        SubtreeReadBatch batch(this, groups, groupedSubtrees, args);
+        int numHelpers = 0;
+        int runThreads = std::min(numThreads, (int)groups.size());
+        for (int i = 1; i < runThreads; i++) {
+            SubtreeReader* reader = new SubtreeReader(&batch);
+            if (!threadPool->tryStart(reader)) {
+                delete reader;
+                break;
+            }
+            numHelpers++;
+        }
+        batch.readGroups(true, bytesRead, bufferSizeBytes, lastProgressReported);
+        batch.finishedThreads.acquire(numHelpers);
+        if (batch.isTreeDirty()) {
+            args.treeIsDirty = true;
+        }
+        bytesRead += runBytes;
+        subtreeIndex = runEnd;
+    }
+    if (args.treeIsDirty) {
+        _isDirty = true;
+    }
+    return true;
 }
 
 void Octree::deleteOctreeElementAt(float x, float y, float z, float s) {
@@ -984,6 +1371,25 @@ int Octree::encodeTreeBitstream(OctreeElement* element,
     return bytesWritten;
 }
 
+// Checks an element's shadow against the occlusion buffer. Unlike the coverage maps the buffer doesn't keep the polygon,
+// so it can live on the stack.
+static CoverageMapStorageResult checkOcclusionBuffer(EncodeBitstreamParams& params, OctreeElement* element, bool storeIt) {
+    AACube voxelBox = element->getAACube();
+    voxelBox.scale(TREE_SCALE);
+    OctreeProjectedPolygon voxelPolygon(params.viewFrustum->getProjectedPolygon(voxelBox));
+
+    // just like with the coverage maps, we ignore occlusion culling for shadows that aren't "all in view"
+    if (!voxelPolygon.getAllInView()) {
+        return NOT_STORED;
+    }
+
+    // the polygon's distance is to the center of the voxel, all of the voxel is within half a diagonal of that
+    const float HALF_SQUARE_ROOT_OF_THREE = 0.866025f;
+    float halfDiagonal = voxelBox.getScale() * HALF_SQUARE_ROOT_OF_THREE;
+    return params.occlusionBuffer->checkBuffer(voxelPolygon, voxelPolygon.getDistance() - halfDiagonal,
+                                               voxelPolygon.getDistance() + halfDiagonal, storeIt);
+}
+
 int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                                             OctreePacketData* packetData, OctreeElementBag& bag,
                                             EncodeBitstreamParams& params, int& currentEncodeLevel,
@@ -1010,10 +1416,12 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
     }
 
     // If we've been provided a jurisdiction map, then we need to honor it.
+    JurisdictionMap::Area elementJurisdiction = JurisdictionMap::WITHIN;
     if (params.jurisdictionMap) {
         // here's how it works... if we're currently above our root jurisdiction, then we proceed normally.
         // but once we're in our own jurisdiction, then we need to make sure we're not below it.
-        if (JurisdictionMap::BELOW == params.jurisdictionMap->isMyJurisdiction(element->getOctalCode(), CHECK_NODE_ONLY)) {
+        elementJurisdiction = params.jurisdictionMap->isMyJurisdiction(element->getOctalCode(), CHECK_NODE_ONLY);
+        if (JurisdictionMap::BELOW == elementJurisdiction) {
             params.stopReason = EncodeBitstreamParams::OUT_OF_JURISDICTION;
             return bytesAtThisLevel;
         }
@@ -1107,7 +1515,15 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
 
         // If the user also asked for occlusion culling, check if this element is occluded, but only if it's not a leaf.
         // leaf occlusion is handled down below when we check child nodes
-        if (params.wantOcclusionCulling && !element->isLeaf()) {
+        if (params.wantOcclusionCulling && !element->isLeaf() && params.occlusionBuffer) {
+            if (checkOcclusionBuffer(params, element, false) == OCCLUDED) {
+                if (params.stats) {
+                    params.stats->skippedOccluded(element);
+                }
+                params.stopReason = EncodeBitstreamParams::OCCLUDED;
+                return bytesAtThisLevel;
+            }
+        } else if (params.wantOcclusionCulling && !element->isLeaf()) {
             AACube voxelBox = element->getAACube();
             voxelBox.scale(TREE_SCALE);
             OctreeProjectedPolygon* voxelPolygon = new OctreeProjectedPolygon(params.viewFrustum->getProjectedPolygon(voxelBox));
@@ -1155,16 +1571,25 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
     int indexOfChildren[NUMBER_OF_CHILDREN] = { 0, 0, 0, 0, 0, 0, 0, 0 };
     int currentCount = 0;
 
+    // classify all of the children against the view in one pass, rather than one child at a time in the loops below
+    ViewFrustum::ChildrenInFrustum childrenInView;
+    float childBoundaryDistance = 1;
+    if (params.viewFrustum) {
+        params.viewFrustum->calculateChildrenInFrustum(element->getAACube(), nodeLocationThisView, childrenInView);
+        childBoundaryDistance = boundaryDistanceForRenderLevel(element->getLevel() + 1 + params.boundaryLevelAdjust,
+                                                               params.octreeElementSizeScale);
+    }
+    ViewFrustum::ChildrenInFrustum childrenInLastView; // only calculated if a child needs it
+    bool haveChildrenInLastView = false;
+
     for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
         OctreeElement* childElement = element->getChildAtIndex(i);
 
         // if the caller wants to include childExistsBits, then include them even if not in view, if however,
         // we're in a portion of the tree that's not our responsibility, then we assume the child nodes exist
         // even if they don't in our local tree
-        bool notMyJurisdiction = false;
-        if (params.jurisdictionMap) {
-            notMyJurisdiction = JurisdictionMap::WITHIN != params.jurisdictionMap->isMyJurisdiction(element->getOctalCode(), i);
-        }
+        // the children get the same answer as their parent, so there's no need to look each of them up
+        bool notMyJurisdiction = (JurisdictionMap::WITHIN != elementJurisdiction);
         if (params.includeExistsBits) {
             // If the child is known to exist, OR, it's not my jurisdiction, then we mark the bit as existing
             if (childElement || notMyJurisdiction) {
@@ -1174,7 +1599,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
 
         if (params.wantOcclusionCulling) {
             if (childElement) {
-                float distance = params.viewFrustum ? childElement->distanceToCamera(*params.viewFrustum) : 0;
+                float distance = params.viewFrustum ? childrenInView.distances[i] : 0;
 
                 currentCount = insertIntoSortedArrays((void*)childElement, distance, i,
                                                       (void**)&sortedChildren, (float*)&distancesToChildren,
@@ -1200,11 +1625,10 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         OctreeElement* childElement = sortedChildren[i];
         int originalIndex = indexOfChildren[i];
 
+        // if the parent was fully in view, all of the children were classified as INSIDE without testing them
         bool childIsInView  = (childElement && 
                 ( !params.viewFrustum || // no view frustum was given, everything is assumed in view
-                  (nodeLocationThisView == ViewFrustum::INSIDE) || // parent was fully in view, we can assume ALL children are
-                  (nodeLocationThisView == ViewFrustum::INTERSECT && 
-                        childElement->isInView(*params.viewFrustum)) // the parent intersects and the child is in view
+                  childrenInView.locations[originalIndex] != ViewFrustum::OUTSIDE
                 ));
 
         if (!childIsInView) {
@@ -1215,11 +1639,8 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         } else {
             // Before we determine consider this further, let's see if it's in our LOD scope...
             float distance = distancesToChildren[i];
-            float boundaryDistance = !params.viewFrustum ? 1 :
-                                     boundaryDistanceForRenderLevel(childElement->getLevel() + params.boundaryLevelAdjust,
-                                            params.octreeElementSizeScale);
 
-            if (!(distance < boundaryDistance)) {
+            if (!(distance < childBoundaryDistance)) {
                 // don't need to check childElement here, because we can't get here with no childElement
                 if (params.stats) {
                     params.stats->skippedDistance(childElement);
@@ -1238,7 +1659,10 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                 bool childIsOccluded = false; // assume it's not occluded
 
                 // If the user also asked for occlusion culling, check if this element is occluded
-                if (params.wantOcclusionCulling && childElement->isLeaf()) {
+                if (params.wantOcclusionCulling && childElement->isLeaf() && params.occlusionBuffer) {
+                    // leaves are stored as occluders for the rest of the scene, since we go front to back
+                    childIsOccluded = (checkOcclusionBuffer(params, childElement, true) == OCCLUDED);
+                } else if (params.wantOcclusionCulling && childElement->isLeaf()) {
                     // Don't check occlusion here, just add them to our distance ordered array...
 
                     AACube voxelBox = childElement->getAACube();
@@ -1290,7 +1714,12 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                     bool childWasInView = false;
 
                     if (childElement && params.deltaViewFrustum && params.lastViewFrustum) {
-                        ViewFrustum::location location = childElement->inFrustum(*params.lastViewFrustum);
+                        if (!haveChildrenInLastView) {
+                            params.lastViewFrustum->calculateChildrenInFrustum(element->getAACube(), ViewFrustum::INTERSECT,
+                                                                               childrenInLastView);
+                            haveChildrenInLastView = true;
+                        }
+                        ViewFrustum::location location = childrenInLastView.locations[originalIndex];
 
                         // If we're a leaf, then either intersect or inside is considered "formerly in view"
                         if (childElement->isLeaf()) {
@@ -1511,7 +1940,15 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         if (continueThisLevel && params.wantOcclusionCulling) {
             unsigned char tempReshuffleBuffer[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
 
-            unsigned char* tempBufferTo = &tempReshuffleBuffer[0]; // this is our temporary destination
+            // a predicted section can hold more than a packet, the few levels that do are reshuffled on the heap
+            std::vector<unsigned char> largeReshuffleBuffer;
+            unsigned char* reshuffleBuffer = &tempReshuffleBuffer[0];
+            if (allSlicesSize > (int)sizeof(tempReshuffleBuffer)) {
+                largeReshuffleBuffer.resize(allSlicesSize);
+                reshuffleBuffer = &largeReshuffleBuffer[0];
+            }
+
+            unsigned char* tempBufferTo = reshuffleBuffer; // this is our temporary destination
 
             // iterate through our childrenExistInPacketBits, these will be the sections of the packet that we copied subTree
             // details into. Unfortunately, they're in distance sorted order, not original index order. we need to put them
@@ -1527,7 +1964,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
             }
 
             // now that all slices are back in the correct order, copy them to the correct output buffer
-            continueThisLevel = packetData->updatePriorBytes(firstRecursiveSliceOffset, &tempReshuffleBuffer[0], allSlicesSize);
+            continueThisLevel = packetData->updatePriorBytes(firstRecursiveSliceOffset, reshuffleBuffer, allSlicesSize);
         }
     } // end keepDiggingDeeper
 
@@ -1573,23 +2010,31 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
 bool Octree::readFromSVOFile(const char* fileName) {
     bool fileOk = false;
     PacketVersion gotVersion = 0;
-    std::ifstream file(fileName, std::ios::in|std::ios::binary|std::ios::ate);
-    if(file.is_open()) {
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly)) {
+        _stopImport.storeRelease(0);
         emit importSize(1.0f, 1.0f, 1.0f);
         emit importProgress(0);
 
         qDebug("Loading file %s...", fileName);
 
         // get file length....
-        unsigned long fileLength = file.tellg();
-        file.seekg( 0, std::ios::beg );
-
-        // read the entire file into a buffer, WHAT!? Why not.
-        unsigned char* entireFile = new unsigned char[fileLength];
-        file.read((char*)entireFile, fileLength);
+        unsigned long fileLength = file.size();
+
+        // Map the file rather than reading it into a heap buffer, this way large worlds don't need twice their size in
+        // RAM while loading, and the OS can page the file in as the decoder streams through it. If the file can't be
+        // mapped (for example it's on a file system that doesn't support it) then fall back to reading it in.
+        QByteArray fileContents;
+        const unsigned char* entireFile = fileLength > 0 ? file.map(0, fileLength) : NULL;
+        if (!entireFile && fileLength > 0) {
+            qDebug("Unable to memory map file %s, reading it into memory instead.", fileName);
+            fileContents = file.readAll();
+            entireFile = reinterpret_cast<const unsigned char*>(fileContents.constData());
+            fileLength = fileContents.size();
+        }
         bool wantImportProgress = true;
 
-        unsigned char* dataAt = entireFile;
+        const unsigned char* dataAt = entireFile;
         unsigned long  dataLength = fileLength;
 
         // before reading the file, check to see if this version of the Octree supports file versions
@@ -1598,38 +2043,44 @@ bool Octree::readFromSVOFile(const char* fileName) {
             PacketType expectedType = expectedDataPacketType();
             
             PacketType gotType;
-            memcpy(&gotType, dataAt, sizeof(gotType));
-            
-            if (gotType == expectedType) {
-                dataAt += sizeof(expectedType);
-                dataLength -= sizeof(expectedType);
-                gotVersion = *dataAt;
-                if (canProcessVersion(gotVersion)) {
-                    dataAt += sizeof(gotVersion);
-                    dataLength -= sizeof(gotVersion);
-                    fileOk = true;
-                    qDebug("SVO file version match. Expected: %d Got: %d", 
-                                versionForPacketType(expectedDataPacketType()), gotVersion);
+            if (dataLength < sizeof(gotType) + sizeof(gotVersion)) {
+                qDebug("SVO file too short to contain a version header. Length: %lu", dataLength);
+            } else {
+                memcpy(&gotType, dataAt, sizeof(gotType));
+
+                if (gotType == expectedType) {
+                    dataAt += sizeof(expectedType);
+                    dataLength -= sizeof(expectedType);
+                    gotVersion = *dataAt;
+                    if (canProcessVersion(gotVersion)) {
+                        dataAt += sizeof(gotVersion);
+                        dataLength -= sizeof(gotVersion);
+                        fileOk = true;
+                        qDebug("SVO file version match. Expected: %d Got: %d",
+                                    versionForPacketType(expectedDataPacketType()), gotVersion);
+                    } else {
+                        qDebug("SVO file version mismatch. Expected: %d Got: %d",
+                                    versionForPacketType(expectedDataPacketType()), gotVersion);
+                    }
                 } else {
-                    qDebug("SVO file version mismatch. Expected: %d Got: %d", 
-                                versionForPacketType(expectedDataPacketType()), gotVersion);
+                    qDebug("SVO file type mismatch. Expected: %c Got: %c", expectedType, gotType);
                 }
-            } else {
-                qDebug("SVO file type mismatch. Expected: %c Got: %c", expectedType, gotType);
             }
         } else {
             fileOk = true; // assume the file is ok
         }
-        if (fileOk) {
+        if (fileOk && dataLength > 0) {
             ReadBitstreamToTreeParams args(WANT_COLOR, NO_EXISTS_BITS, NULL, 0, 
                                                 SharedNodePointer(), wantImportProgress, gotVersion);
-            readBitstreamToTree(dataAt, dataLength, args);
+            if (!readBitstreamToTreeInParallel(dataAt, dataLength, args)) {
+                readBitstreamToTree(dataAt, dataLength, args);
+            }
         }
-        delete[] entireFile;
+        _stopImport.storeRelease(0);
 
         emit importProgress(100);
 
-        file.close();
+        file.close(); // also unmaps the file
     }
     return fileOk;
 }
@@ -1746,6 +2197,6 @@ void Octree::copyFromTreeIntoSubTree(Octree* sourceTree, OctreeElement* destinat
 }
 
 void Octree::cancelImport() {
-    _stopImport = true;
+    _stopImport.storeRelease(1);
 }
 
@@ -16,6 +16,7 @@
 #include <SimpleMovingAverage.h>
 
 class CoverageMap;
+class OcclusionBuffer;
 class ReadBitstreamToTreeParams;
 class Octree;
 class OctreeElement;
@@ -33,6 +34,7 @@ class Shape;
 
 #include <CollisionInfo.h>
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QReadWriteLock>
 
@@ -65,6 +67,7 @@ const quint64 IGNORE_LAST_SENT  = 0;
 #define IGNORE_VIEW_FRUSTUM      NULL
 #define IGNORE_COVERAGE_MAP      NULL
 #define IGNORE_JURISDICTION_MAP  NULL
+#define IGNORE_OCCLUSION_BUFFER  NULL
 
 class EncodeBitstreamParams {
 public:
@@ -84,6 +87,7 @@ public:
     OctreeSceneStats* stats;
     CoverageMap* map;
     JurisdictionMap* jurisdictionMap;
+    OcclusionBuffer* occlusionBuffer; // if set, used for occlusion culling instead of map
 
     // output hints from the encode process
     typedef enum {
@@ -115,7 +119,8 @@ public:
         quint64 lastViewFrustumSent = IGNORE_LAST_SENT,
         bool forceSendScene = true,
         OctreeSceneStats* stats = IGNORE_SCENE_STATS,
-        JurisdictionMap* jurisdictionMap = IGNORE_JURISDICTION_MAP) :
+        JurisdictionMap* jurisdictionMap = IGNORE_JURISDICTION_MAP,
+        OcclusionBuffer* occlusionBuffer = IGNORE_OCCLUSION_BUFFER) :
             maxEncodeLevel(maxEncodeLevel),
             maxLevelReached(0),
             viewFrustum(viewFrustum),
@@ -132,6 +137,7 @@ public:
             stats(stats),
             map(map),
             jurisdictionMap(jurisdictionMap),
+            occlusionBuffer(occlusionBuffer),
             stopReason(UNKNOWN)
     {}
 
@@ -171,6 +177,8 @@ public:
     SharedNodePointer sourceNode;
     bool wantImportProgress;
     PacketVersion bitstreamVersion;
+    uint16_t sourceUUIDKey; // set by readBitstreamToTree() from sourceUUID
+    bool treeIsDirty; // set by the readers when they change the tree, readBitstreamToTree() passes it on to the tree
 
     ReadBitstreamToTreeParams(
         bool includeColor = WANT_COLOR,
@@ -186,7 +194,9 @@ public:
             sourceUUID(sourceUUID),
             sourceNode(sourceNode),
             wantImportProgress(wantImportProgress),
-            bitstreamVersion(bitstreamVersion)
+            bitstreamVersion(bitstreamVersion),
+            sourceUUIDKey(0),
+            treeIsDirty(false)
     {}
 };
 
@@ -213,12 +223,20 @@ public:
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
 
+    /// Implement this if your elements know the size of their data in a bitstream without reading it, then
+    /// readFromSVOFile() can find the subtrees of a file up front and read them on several threads.
+    /// \return the number of bytes readElementDataFromBuffer() would read from data, or -1 if that isn't known
+    virtual int elementDataSizeInBuffer(const unsigned char* data, int bytesLeftToRead,
+                                        const ReadBitstreamToTreeParams& args) const { return -1; }
+
 
     virtual void update() { }; // nothing to do by default
 
     OctreeElement* getRoot() { return _rootElement; }
 
-    void eraseAllOctreeElements();
+    /// Deletes every element and starts over with an empty root. Override this to reset anything you keep about the
+    /// elements, and call the base class.
+    virtual void eraseAllOctreeElements();
 
     void processRemoveOctreeElementsBitstream(const unsigned char* bitstream, int bufferSizeBytes);
     void readBitstreamToTree(const unsigned char* bitstream,  unsigned long int bufferSizeBytes, ReadBitstreamToTreeParams& args);
@@ -322,6 +340,11 @@ signals:
 public slots:
     void cancelImport();
 
+    /// \param maxLoadThreads most threads readFromSVOFile() reads subtrees on, including the calling one, or 0 for as
+    /// many as the global QThreadPool has
+    void setMaxLoadThreads(int maxLoadThreads) { _maxLoadThreads = maxLoadThreads; }
+    int getMaxLoadThreads() const { return _maxLoadThreads; }
+
 
 protected:
     void deleteOctalCodeFromTreeRecursion(OctreeElement* element, void* extraData);
@@ -337,12 +360,20 @@ protected:
     OctreeElement* createMissingElement(OctreeElement* lastParentElement, const unsigned char* codeToReach);
     int readElementData(OctreeElement *destinationElement, const unsigned char* nodeData,
                 int bufferSizeBytes, ReadBitstreamToTreeParams& args);
+    int readBitstreamSubtree(OctreeElement* ancestorElement, const unsigned char* bitstreamAt, int bytesLeftToRead,
+                ReadBitstreamToTreeParams& args);
+    int skipElementData(const unsigned char* nodeData, int bytesLeftToRead, bool isRoot,
+                const ReadBitstreamToTreeParams& args) const;
+    bool readBitstreamToTreeInParallel(const unsigned char* bitstream, unsigned long int bufferSizeBytes,
+                ReadBitstreamToTreeParams& args);
+    friend class SubtreeReadBatch;
 
     OctreeElement* _rootElement;
 
     bool _isDirty;
     bool _shouldReaverage;
-    bool _stopImport;
+    QAtomicInt _stopImport; // set by cancelImport() from the UI thread, polled by the loading threads
+    int _maxLoadThreads;
 
     QReadWriteLock _lock;
     
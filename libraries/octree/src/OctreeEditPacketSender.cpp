@@ -201,9 +201,12 @@ void OctreeEditPacketSender::queuePacketToNodes(unsigned char* buffer, size_t le
             bool isMyJurisdiction = true;
             // we need to get the jurisdiction for this
             // here we need to get the "pending packet" for this server
+            // don't use operator[] here, it would insert a map for servers we haven't heard from while we only hold
+            // the read lock
             _serverJurisdictions->lockForRead();
-            const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
-            isMyJurisdiction = (map.isMyJurisdiction(octCode, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
+            NodeToJurisdictionMap::const_iterator map = _serverJurisdictions->constFind(nodeUUID);
+            isMyJurisdiction = (map != _serverJurisdictions->constEnd() &&
+                                map->isMyJurisdiction(octCode, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
             _serverJurisdictions->unlock();
             if (isMyJurisdiction) {
                 queuePacketToNode(nodeUUID, buffer, length, satoshiCost);
@@ -256,12 +259,9 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, unsigned ch
                 // we need to get the jurisdiction for this
                 // here we need to get the "pending packet" for this server
                 _serverJurisdictions->lockForRead();
-                if ((*_serverJurisdictions).find(nodeUUID) != (*_serverJurisdictions).end()) {
-                    const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
-                    isMyJurisdiction = (map.isMyJurisdiction(codeColorBuffer, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
-                } else {
-                    isMyJurisdiction = false;
-                }
+                NodeToJurisdictionMap::const_iterator map = _serverJurisdictions->constFind(nodeUUID);
+                isMyJurisdiction = (map != _serverJurisdictions->constEnd() &&
+                                    map->isMyJurisdiction(codeColorBuffer, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
                 _serverJurisdictions->unlock();
             }
             if (isMyJurisdiction) {
@@ -9,11 +9,16 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <stdio.h>
+#include <vector>
 
 #include <QtCore/QDebug>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThreadStorage>
 
 #include <NodeList.h>
 #include <PerfStat.h>
@@ -23,18 +28,141 @@
 #include "OctalCode.h"
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
+#include "OctreeElementPool.h"
 #include "Octree.h"
 #include "SharedUtil.h"
 
-quint64 OctreeElement::_voxelMemoryUsage = 0;
-quint64 OctreeElement::_octcodeMemoryUsage = 0;
-quint64 OctreeElement::_externalChildrenMemoryUsage = 0;
-quint64 OctreeElement::_voxelNodeCount = 0;
-quint64 OctreeElement::_voxelNodeLeafCount = 0;
+AtomicCounter OctreeElement::_voxelMemoryUsage;
+AtomicCounter OctreeElement::_octcodeMemoryUsage;
+AtomicCounter OctreeElement::_externalChildrenMemoryUsage;
+AtomicCounter OctreeElement::_voxelNodeCount;
+AtomicCounter OctreeElement::_voxelNodeLeafCount;
 
 void OctreeElement::resetPopulationStatistics() {
-    _voxelNodeCount = 0;
-    _voxelNodeLeafCount = 0;
+    _voxelNodeCount.reset();
+    _voxelNodeLeafCount.reset();
+}
+
+// The generations of the elements, kept outside of them so that a handle can be checked after its element is deleted.
+// Each live element owns a slot, and releasing the slot bumps its generation, which invalidates every handle taken from
+// the element. Released slots are reused. The chunks of slots, and the pages of pointers to them, are only allocated as
+// the elements need them, and are never freed or moved, so that handles can be checked without the lock.
+//
+// Elements are made and deleted far too often to share a lock, so each thread keeps its own free slots and only trades
+// them with the shared list in batches.
+class GenerationTable {
+public:
+    static const int CHUNK_BITS = 16;
+    static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+    static const int MAX_CHUNKS = (1 << 16) - 1; // one short of the full 32 bits, so that NO_SLOT is never a real slot
+    static const int CHUNK_PAGE_BITS = 8;
+    static const int CHUNK_PAGE_SIZE = 1 << CHUNK_PAGE_BITS; // chunk pointers per page
+    static const int MAX_CHUNK_PAGES = (MAX_CHUNKS + CHUNK_PAGE_SIZE - 1) / CHUNK_PAGE_SIZE;
+    static const quint32 NO_SLOT = OctreeElementHandle::NO_SLOT;
+    static const int SLOT_BATCH_SIZE = 256;
+
+    GenerationTable() : _chunkCount(0) {
+        memset(_chunkPages, 0, sizeof(_chunkPages));
+    }
+
+    /// \return a free slot, or NO_SLOT if every slot is taken
+    quint32 acquireSlot() {
+        std::vector<quint32>& freeSlots = getThreadFreeSlots();
+        if (freeSlots.empty()) {
+            QMutexLocker locker(&_mutex);
+            if (_freeSlots.empty() && !addChunk()) {
+                return NO_SLOT;
+            }
+            moveSlots(_freeSlots, freeSlots, SLOT_BATCH_SIZE);
+        }
+        quint32 slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    void releaseSlot(quint32 slot) {
+        if (slot == NO_SLOT) {
+            return;
+        }
+        slotAt(slot).fetchAndAddRelease(1);
+
+        // the thread that deletes elements isn't always the one that made them, so give back what it can't reuse soon
+        std::vector<quint32>& freeSlots = getThreadFreeSlots();
+        freeSlots.push_back(slot);
+        if (freeSlots.size() > (size_t)(2 * SLOT_BATCH_SIZE)) {
+            QMutexLocker locker(&_mutex);
+            moveSlots(freeSlots, _freeSlots, SLOT_BATCH_SIZE);
+        }
+    }
+
+    quint32 getGeneration(quint32 slot) const { return slot == NO_SLOT ? 0 : (quint32)slotAt(slot).loadAcquire(); }
+
+private:
+    // a thread's free slots, which go back to the shared list when the thread finishes
+    class ThreadFreeSlots {
+    public:
+        ThreadFreeSlots(GenerationTable* table) : _table(table) { }
+        ~ThreadFreeSlots() {
+            QMutexLocker locker(&_table->_mutex);
+            moveSlots(_slots, _table->_freeSlots, _slots.size());
+        }
+
+        GenerationTable* _table;
+        std::vector<quint32> _slots;
+    };
+
+    std::vector<quint32>& getThreadFreeSlots() {
+        ThreadFreeSlots* threadFreeSlots = _threadFreeSlots.localData();
+        if (!threadFreeSlots) {
+            threadFreeSlots = new ThreadFreeSlots(this);
+            _threadFreeSlots.setLocalData(threadFreeSlots);
+        }
+        return threadFreeSlots->_slots;
+    }
+
+    // called with _mutex held, a chunk is published before any of its slots are handed out so readers never miss one
+    bool addChunk() {
+        if (_chunkCount >= MAX_CHUNKS) {
+            qDebug() << "ERROR: GenerationTable ran out of slots for octree elements,"
+                << "handles to new elements will never be alive";
+            return false;
+        }
+        QAtomicInt**& chunkPage = _chunkPages[_chunkCount >> CHUNK_PAGE_BITS];
+        if (!chunkPage) {
+            chunkPage = new QAtomicInt*[CHUNK_PAGE_SIZE];
+        }
+        chunkPage[_chunkCount & (CHUNK_PAGE_SIZE - 1)] = new QAtomicInt[CHUNK_SIZE];
+        quint32 firstSlot = (quint32)_chunkCount << CHUNK_BITS;
+        _chunkCount++;
+        for (int i = CHUNK_SIZE - 1; i >= 0; i--) {
+            _freeSlots.push_back(firstSlot + i);
+        }
+        return true;
+    }
+
+    static void moveSlots(std::vector<quint32>& from, std::vector<quint32>& to, size_t count) {
+        size_t first = from.size() - std::min(count, from.size());
+        to.insert(to.end(), from.begin() + first, from.end());
+        from.resize(first);
+    }
+
+    QAtomicInt& slotAt(quint32 slot) const {
+        quint32 chunk = slot >> CHUNK_BITS;
+        return _chunkPages[chunk >> CHUNK_PAGE_BITS][chunk & (CHUNK_PAGE_SIZE - 1)][slot & (CHUNK_SIZE - 1)];
+    }
+
+    QMutex _mutex;
+    QAtomicInt** _chunkPages[MAX_CHUNK_PAGES];
+    int _chunkCount;
+    std::vector<quint32> _freeSlots;
+    QThreadStorage<ThreadFreeSlots*> _threadFreeSlots;
+};
+
+// elements can be created during static initialization, so the table is made on first use and never deleted, which
+// also keeps it alive for the threads that return their slots as they finish
+static GenerationTable& generationTable() {
+    static GenerationTable* table = new GenerationTable();
+    return *table;
 }
 
 OctreeElement::OctreeElement() {
@@ -51,6 +179,7 @@ void OctreeElement::init(unsigned char * octalCode) {
     _voxelNodeCount++;
     _voxelNodeLeafCount++; // all nodes start as leaf nodes
 
+    _generationSlot = generationTable().acquireSlot();
 
     size_t octalCodeLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(octalCode));
     if (octalCodeLength > sizeof(_octalCode)) {
@@ -99,6 +228,7 @@ void OctreeElement::init(unsigned char * octalCode) {
 
 OctreeElement::~OctreeElement() {
     notifyDeleteHooks();
+    generationTable().releaseSlot(_generationSlot);
     _voxelNodeCount--;
     if (isLeaf()) {
         _voxelNodeLeafCount--;
@@ -138,7 +268,14 @@ uint16_t OctreeElement::_nextUUIDKey = KEY_FOR_NULL + 1; // start at 1, 0 is res
 std::map<QString, uint16_t> OctreeElement::_mapSourceUUIDsToKeys;
 std::map<uint16_t, QString> OctreeElement::_mapKeysToSourceUUIDs;
 
-void OctreeElement::setSourceUUID(const QUuid& sourceUUID) {
+// elements of trees that are read on different threads share the maps, which can be used during static initialization
+static QMutex& sourceUUIDsMutex() {
+    static QMutex* mutex = new QMutex();
+    return *mutex;
+}
+
+uint16_t OctreeElement::addSourceUUIDKey(const QUuid& sourceUUID) {
+    QMutexLocker locker(&sourceUUIDsMutex());
     uint16_t key;
     QString sourceUUIDString = sourceUUID.toString();
     if (_mapSourceUUIDsToKeys.end() != _mapSourceUUIDsToKeys.find(sourceUUIDString)) {
@@ -149,11 +286,16 @@ void OctreeElement::setSourceUUID(const QUuid& sourceUUID) {
         _mapSourceUUIDsToKeys[sourceUUIDString] = key;
         _mapKeysToSourceUUIDs[key] = sourceUUIDString;
     }
-    _sourceUUIDKey = key;
+    return key;
+}
+
+void OctreeElement::setSourceUUID(const QUuid& sourceUUID) {
+    _sourceUUIDKey = addSourceUUIDKey(sourceUUID);
 }
 
 QUuid OctreeElement::getSourceUUID() const {
     if (_sourceUUIDKey > KEY_FOR_NULL) {
+        QMutexLocker locker(&sourceUUIDsMutex());
         if (_mapKeysToSourceUUIDs.end() != _mapKeysToSourceUUIDs.find(_sourceUUIDKey)) {
             return QUuid(_mapKeysToSourceUUIDs[_sourceUUIDKey]);
         }
@@ -163,6 +305,7 @@ QUuid OctreeElement::getSourceUUID() const {
 
 bool OctreeElement::matchesSourceUUID(const QUuid& sourceUUID) const {
     if (_sourceUUIDKey > KEY_FOR_NULL) {
+        QMutexLocker locker(&sourceUUIDsMutex());
         if (_mapKeysToSourceUUIDs.end() != _mapKeysToSourceUUIDs.find(_sourceUUIDKey)) {
             return QUuid(_mapKeysToSourceUUIDs[_sourceUUIDKey]) == sourceUUID;
         }
@@ -171,6 +314,7 @@ bool OctreeElement::matchesSourceUUID(const QUuid& sourceUUID) const {
 }
 
 uint16_t OctreeElement::getSourceNodeUUIDKey(const QUuid& sourceUUID) {
+    QMutexLocker locker(&sourceUUIDsMutex());
     uint16_t key = KEY_FOR_NULL;
     QString sourceUUIDString = sourceUUID.toString();
     if (_mapSourceUUIDsToKeys.end() != _mapSourceUUIDsToKeys.find(sourceUUIDString)) {
@@ -293,8 +437,18 @@ quint64 OctreeElement::_couldStoreFourChildrenInternally = 0;
 quint64 OctreeElement::_couldNotStoreFourChildrenInternally = 0;
 #endif
 
-quint64 OctreeElement::_externalChildrenCount = 0;
-quint64 OctreeElement::_childrenCount[NUMBER_OF_CHILDREN + 1] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+AtomicCounter OctreeElement::_externalChildrenCount;
+AtomicCounter OctreeElement::_childrenCount[NUMBER_OF_CHILDREN + 1];
+
+#ifdef SIMPLE_EXTERNAL_CHILDREN
+// every element with two or more children has an external array of NUMBER_OF_CHILDREN pointers, these are all the
+// same size so we carve them out of a pool instead of the heap
+static OctreeElementPool& externalChildrenPool() {
+    static OctreeElementPool* pool = new OctreeElementPool("OctreeElement children", 
+                                                           NUMBER_OF_CHILDREN * sizeof(OctreeElement*));
+    return *pool;
+}
+#endif
 
 OctreeElement* OctreeElement::getChildAtIndex(int childIndex) const {
 #ifdef SIMPLE_CHILD_ARRAY
@@ -647,6 +801,18 @@ void OctreeElement::deleteAllChildren() {
         }
     }
 
+#ifdef SIMPLE_EXTERNAL_CHILDREN
+    // elements with two or more children keep them in an external array, return it to the pool and reset our
+    // population data
+    int childCount = getChildCount();
+    if (childCount > 1) {
+        externalChildrenPool().deallocate(_children.external);
+        _externalChildrenMemoryUsage -= NUMBER_OF_CHILDREN * sizeof(OctreeElement*);
+    }
+    _childrenCount[childCount]--;
+    _children.single = NULL;
+#endif // SIMPLE_EXTERNAL_CHILDREN
+
 #ifdef BLENDED_UNION_CHILDREN
     // now, reset our internal state and ANY and all population data
     int childCount = getChildCount();
@@ -739,7 +905,7 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
         _children.single = child;
     } else if (previousChildCount == 1 && newChildCount == 2) {
         OctreeElement* previousChild = _children.single;
-        _children.external = new OctreeElement*[NUMBER_OF_CHILDREN];
+        _children.external = static_cast<OctreeElement**>(externalChildrenPool().allocate());
         memset(_children.external, 0, sizeof(OctreeElement*) * NUMBER_OF_CHILDREN);
         _children.external[firstIndex] = previousChild;
         _children.external[childIndex] = child;
@@ -750,7 +916,7 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
         assert(!child); // we are removing a child, so this must be true!
         OctreeElement* previousFirstChild = _children.external[firstIndex];
         OctreeElement* previousSecondChild = _children.external[secondIndex];
-        delete[] _children.external;
+        externalChildrenPool().deallocate(_children.external);
         _externalChildrenMemoryUsage -= NUMBER_OF_CHILDREN * sizeof(OctreeElement*);
         if (childIndex == firstIndex) {
             _children.single = previousSecondChild;
@@ -1253,6 +1419,20 @@ float OctreeElement::distanceToPoint(const glm::vec3& point) const {
     return distance;
 }
 
+const quint32 OctreeElementHandle::NO_SLOT;
+
+OctreeElementHandle OctreeElement::getHandle() {
+    OctreeElementHandle handle;
+    handle.element = this;
+    handle.slot = _generationSlot;
+    handle.generation = generationTable().getGeneration(_generationSlot);
+    return handle;
+}
+
+bool OctreeElementHandle::isAlive() const {
+    return element && slot != NO_SLOT && generationTable().getGeneration(slot) == generation;
+}
+
 QReadWriteLock OctreeElement::_deleteHooksLock;
 std::vector<OctreeElementDeleteHook*> OctreeElement::_deleteHooks;
 
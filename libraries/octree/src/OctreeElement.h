@@ -18,6 +18,7 @@
 
 #include <QReadWriteLock>
 
+#include <AtomicCounter.h>
 #include <SharedUtil.h>
 
 #include "AACube.h"
@@ -46,6 +47,28 @@ public:
     virtual void elementUpdated(OctreeElement* element) = 0;
 };
 
+/// A weak reference to an element, see OctreeElement::getHandle(). The generation of the element's slot is kept in a side
+/// table that outlives every element, so isAlive() never touches the element itself and can be asked after it is deleted.
+class OctreeElementHandle {
+public:
+    /// the slot of an element made after every slot was taken, handles to it are never alive
+    static const quint32 NO_SLOT = 0xFFFFFFFF;
+
+    OctreeElementHandle() : element(NULL), slot(0), generation(0) { }
+
+    /// \return whether element is still the element that the handle was taken from
+    bool isAlive() const;
+
+    bool operator==(const OctreeElementHandle& other) const {
+        return element == other.element && slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const OctreeElementHandle& other) const { return !(*this == other); }
+
+    OctreeElement* element;
+    quint32 slot;
+    quint32 generation;
+};
+
 
 class OctreeElement {
 
@@ -164,21 +187,34 @@ public:
     bool matchesSourceUUID(const QUuid& sourceUUID) const;
     static uint16_t getSourceNodeUUIDKey(const QUuid& sourceUUID);
 
+    /// Same as setSourceUUID() with a key from addSourceUUIDKey(), which saves looking the UUID up for every element.
+    void setSourceUUIDKey(uint16_t key) { _sourceUUIDKey = key; }
+
+    /// \return the key of sourceUUID, adding one if it has none yet
+    static uint16_t addSourceUUIDKey(const QUuid& sourceUUID);
+
+    /// A weak handle to this element, which holders like OctreeElementBag keep instead of the bare pointer, so that they
+    /// can tell whether the element is still alive without registering a delete hook. Each element gets a slot in a
+    /// side table for its lifetime, deleting the element bumps the slot's generation, and the slot is reused later.
+    OctreeElementHandle getHandle();
+
     static void addDeleteHook(OctreeElementDeleteHook* hook);
     static void removeDeleteHook(OctreeElementDeleteHook* hook);
 
     static void addUpdateHook(OctreeElementUpdateHook* hook);
     static void removeUpdateHook(OctreeElementUpdateHook* hook);
+    static bool hasUpdateHooks() { return !_updateHooks.empty(); }
     
     static void resetPopulationStatistics();
-    static unsigned long getNodeCount() { return _voxelNodeCount; }
-    static unsigned long getInternalNodeCount() { return _voxelNodeCount - _voxelNodeLeafCount; }
-    static unsigned long getLeafNodeCount() { return _voxelNodeLeafCount; }
+    static unsigned long getNodeCount() { return _voxelNodeCount.get(); }
+    static unsigned long getInternalNodeCount() { return _voxelNodeCount.get() - _voxelNodeLeafCount.get(); }
+    static unsigned long getLeafNodeCount() { return _voxelNodeLeafCount.get(); }
 
-    static quint64 getVoxelMemoryUsage() { return _voxelMemoryUsage; }
-    static quint64 getOctcodeMemoryUsage() { return _octcodeMemoryUsage; }
-    static quint64 getExternalChildrenMemoryUsage() { return _externalChildrenMemoryUsage; }
-    static quint64 getTotalMemoryUsage() { return _voxelMemoryUsage + _octcodeMemoryUsage + _externalChildrenMemoryUsage; }
+    static quint64 getVoxelMemoryUsage() { return _voxelMemoryUsage.get(); }
+    static quint64 getOctcodeMemoryUsage() { return _octcodeMemoryUsage.get(); }
+    static quint64 getExternalChildrenMemoryUsage() { return _externalChildrenMemoryUsage.get(); }
+    static quint64 getTotalMemoryUsage() { return getVoxelMemoryUsage() + getOctcodeMemoryUsage() +
+                                                  getExternalChildrenMemoryUsage(); }
 
     static quint64 getGetChildAtIndexTime() { return _getChildAtIndexTime; }
     static quint64 getGetChildAtIndexCalls() { return _getChildAtIndexCalls; }
@@ -195,8 +231,8 @@ public:
     static quint64 getCouldNotStoreFourChildrenInternally() { return _couldNotStoreFourChildrenInternally; }
 #endif
 
-    static quint64 getExternalChildrenCount() { return _externalChildrenCount; }
-    static quint64 getChildrenCount(int childCount) { return _childrenCount[childCount]; }
+    static quint64 getExternalChildrenCount() { return _externalChildrenCount.get(); }
+    static quint64 getChildrenCount(int childCount) { return _childrenCount[childCount].get(); }
     
 #ifdef BLENDED_UNION_CHILDREN
 #ifdef HAS_AUDIT_CHILDREN
@@ -289,6 +325,8 @@ protected:
 
     uint16_t _sourceUUIDKey; /// Client only, stores node id of voxel server that sent his voxel, 2 bytes
 
+    quint32 _generationSlot; /// Client and server, see getHandle(), 4 bytes
+
     // Support for _sourceUUID, we use these static member variables to track the UUIDs that are
     // in use by various voxel server nodes. We map the UUID strings into an 16 bit key, this limits us to at
     // most 65k voxel servers in use at a time within the client. Which is far more than we need.
@@ -311,12 +349,13 @@ protected:
     //static QReadWriteLock _updateHooksLock;
     static std::vector<OctreeElementUpdateHook*> _updateHooks;
 
-    static quint64 _voxelNodeCount;
-    static quint64 _voxelNodeLeafCount;
+    // elements are made and deleted on more than one thread, for example while a file is loaded in parallel
+    static AtomicCounter _voxelNodeCount;
+    static AtomicCounter _voxelNodeLeafCount;
 
-    static quint64 _voxelMemoryUsage;
-    static quint64 _octcodeMemoryUsage;
-    static quint64 _externalChildrenMemoryUsage;
+    static AtomicCounter _voxelMemoryUsage;
+    static AtomicCounter _octcodeMemoryUsage;
+    static AtomicCounter _externalChildrenMemoryUsage;
 
     static quint64 _getChildAtIndexTime;
     static quint64 _getChildAtIndexCalls;
@@ -332,8 +371,8 @@ protected:
     static quint64 _couldStoreFourChildrenInternally;
     static quint64 _couldNotStoreFourChildrenInternally;
 #endif
-    static quint64 _externalChildrenCount;
-    static quint64 _childrenCount[NUMBER_OF_CHILDREN + 1];
+    static AtomicCounter _externalChildrenCount;
+    static AtomicCounter _childrenCount[NUMBER_OF_CHILDREN + 1];
 };
 
 #endif // hifi_OctreeElement_h
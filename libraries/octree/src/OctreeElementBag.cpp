@@ -9,57 +9,141 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "OctreeElementBag.h"
 #include <OctalCode.h>
 
+#include "ViewFrustum.h"
+
 OctreeElementBag::OctreeElementBag() : 
-    _bagElements()
+    _bagElements(),
+    _priorityViewFrustum(NULL),
+    _priorityQueue()
 {
-    OctreeElement::addDeleteHook(this);
-    _hooked = true;
 };
 
 OctreeElementBag::~OctreeElementBag() {
-    unhookNotifications();
     deleteAll();
 }
 
-void OctreeElementBag::unhookNotifications() {
-    if (_hooked) {
-        OctreeElement::removeDeleteHook(this);
-        _hooked = false;
-    }
-}
-
-void OctreeElementBag::elementDeleted(OctreeElement* element) {
-    remove(element); // note: remove can safely handle nodes that aren't in it, so we don't need to check contains()
-}
-
-
 void OctreeElementBag::deleteAll() {
     _bagElements.clear();
+    _priorityQueue.clear();
 }
 
 
 void OctreeElementBag::insert(OctreeElement* element) {
-    _bagElements.insert(element);
+    OctreeElementHandle handle = element->getHandle();
+    if (_priorityViewFrustum) {
+        QHash<OctreeElement*, OctreeElementHandle>::const_iterator existing = _bagElements.constFind(element);
+        if (existing != _bagElements.constEnd() && existing.value() == handle) {
+            return; // it's already queued
+        }
+        // a different handle means the old element at this address was deleted, its queue entry is now stale
+        PrioritizedElement entry = { calculatePriority(element), handle };
+        _priorityQueue.push_back(entry);
+        std::push_heap(_priorityQueue.begin(), _priorityQueue.end());
+    }
+    _bagElements.insert(element, handle);
+}
+
+void OctreeElementBag::dropDeletedElements() {
+    if (_priorityViewFrustum) {
+        while (!_priorityQueue.empty()) {
+            const OctreeElementHandle& top = _priorityQueue.front().handle;
+            QHash<OctreeElement*, OctreeElementHandle>::iterator member = _bagElements.find(top.element);
+            bool isStale = (member == _bagElements.end() || member.value() != top);
+            if (!isStale) {
+                if (top.isAlive()) {
+                    return;
+                }
+                _bagElements.erase(member);
+            }
+            std::pop_heap(_priorityQueue.begin(), _priorityQueue.end());
+            _priorityQueue.pop_back();
+        }
+    } else {
+        while (!_bagElements.isEmpty()) {
+            QHash<OctreeElement*, OctreeElementHandle>::iterator front = _bagElements.begin();
+            if (front.value().isAlive()) {
+                return;
+            }
+            _bagElements.erase(front);
+        }
+    }
+}
+
+bool OctreeElementBag::isEmpty() {
+    dropDeletedElements();
+    return _bagElements.isEmpty();
 }
 
 OctreeElement* OctreeElementBag::extract() {
+    dropDeletedElements();
     OctreeElement* result = NULL;
 
-    if (_bagElements.size() > 0) {
-        QSet<OctreeElement*>::iterator front = _bagElements.begin();
-        result = *front;
+    if (_priorityViewFrustum) {
+        if (!_priorityQueue.empty()) {
+            std::pop_heap(_priorityQueue.begin(), _priorityQueue.end());
+            result = _priorityQueue.back().handle.element;
+            _priorityQueue.pop_back();
+            _bagElements.remove(result);
+        }
+    } else if (!_bagElements.isEmpty()) {
+        QHash<OctreeElement*, OctreeElementHandle>::iterator front = _bagElements.begin();
+        result = front.key();
         _bagElements.erase(front);
     }
     return result;
 }
 
 bool OctreeElementBag::contains(OctreeElement* element) {
-    return _bagElements.contains(element);
+    QHash<OctreeElement*, OctreeElementHandle>::const_iterator member = _bagElements.constFind(element);
+    return member != _bagElements.constEnd() && member.value().isAlive();
 }
 
 void OctreeElementBag::remove(OctreeElement* element) {
     _bagElements.remove(element);
+
+    // don't let the stale entries pile up if elements are removed faster than they reach the top of the queue
+    const size_t MINIMUM_QUEUE_SIZE_TO_COMPACT = 64;
+    if (_priorityViewFrustum && _priorityQueue.size() > MINIMUM_QUEUE_SIZE_TO_COMPACT
+            && _priorityQueue.size() > 2 * (size_t)_bagElements.size()) {
+        rebuildPriorityQueue();
+    }
+}
+
+void OctreeElementBag::setPriorityViewFrustum(const ViewFrustum* viewFrustum) {
+    _priorityViewFrustum = viewFrustum;
+    if (_priorityViewFrustum) {
+        rebuildPriorityQueue();
+    } else {
+        _priorityQueue.clear();
+    }
+}
+
+// The projected size of the element, its scale over its distance. It's the same measure LOD uses, so bigger values are
+// the elements that the viewer can see the most detail of.
+float OctreeElementBag::calculatePriority(OctreeElement* element) const {
+    const float MINIMUM_DISTANCE = 0.001f; // don't divide by zero when the camera is at the center of an element
+    float distance = std::max(element->distanceToCamera(*_priorityViewFrustum), MINIMUM_DISTANCE);
+    return (element->getScale() * TREE_SCALE) / distance;
+}
+
+void OctreeElementBag::rebuildPriorityQueue() {
+    _priorityQueue.clear();
+    _priorityQueue.reserve(_bagElements.size());
+    QHash<OctreeElement*, OctreeElementHandle>::iterator member = _bagElements.begin();
+    while (member != _bagElements.end()) {
+        // deleted elements can't be measured, so this is a good time to drop them
+        if (!member.value().isAlive()) {
+            member = _bagElements.erase(member);
+            continue;
+        }
+        PrioritizedElement entry = { calculatePriority(member.key()), member.value() };
+        _priorityQueue.push_back(entry);
+        ++member;
+    }
+    std::make_heap(_priorityQueue.begin(), _priorityQueue.end());
 }
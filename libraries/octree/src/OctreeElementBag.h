@@ -10,6 +10,14 @@
 //  more than once (in other words, it de-dupes automatically), also, it supports collapsing it's several peer nodes
 //  into a parent node in cases where you add enough peers that it makes more sense to just add the parent.
 //
+//  By default elements come out of the bag in any order. In priority mode the bag hands out the element that looks
+//  largest from the view frustum first, so that when a scene is cut short by packet limits, what did get sent is the
+//  detail that matters most to the viewer.
+//
+//  The bag holds weak handles (see OctreeElement::getHandle()). Elements that are deleted while in the bag are dropped
+//  when the bag runs into them, rather than through a delete hook, so deleting an element costs the same no matter how
+//  many bags exist. Whether an element is alive is only ever asked of the handle, never of the element.
+//
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
@@ -17,30 +25,58 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
+#include <vector>
+
+#include <QHash>
+
 #include "OctreeElement.h"
 
-class OctreeElementBag : public OctreeElementDeleteHook {
+class ViewFrustum;
+
+class OctreeElementBag {
 
 public:
     OctreeElementBag();
     ~OctreeElementBag();
     
     void insert(OctreeElement* element); // put a element into the bag
-    OctreeElement* extract(); // pull a element out of the bag (could come in any order)
+    OctreeElement* extract(); // pull a element out of the bag (could come in any order, unless in priority mode)
     bool contains(OctreeElement* element); // is this element in the bag?
     void remove(OctreeElement* element); // remove a specific element from the bag
     
-    bool isEmpty() const { return _bagElements.isEmpty(); }
+    /// true if extract() has nothing left to return, drops any deleted elements it finds on the way
+    bool isEmpty();
+
+    /// the number of elements in the bag, which may include elements that were deleted since they were inserted
     int count() const { return _bagElements.size(); }
 
     void deleteAll();
-    virtual void elementDeleted(OctreeElement* element);
 
-    void unhookNotifications();
+    /// Switches the bag into priority mode, extracting elements in order of their size over their distance from
+    /// viewFrustum. Call again whenever the view frustum changes to reprioritize the elements already in the bag. Pass
+    /// NULL to go back to extracting in any order.
+    void setPriorityViewFrustum(const ViewFrustum* viewFrustum);
+    bool isPrioritized() const { return _priorityViewFrustum != NULL; }
 
 private:
-    QSet<OctreeElement*> _bagElements;
-    bool _hooked;
+    class PrioritizedElement {
+    public:
+        float priority;
+        OctreeElementHandle handle;
+        bool operator<(const PrioritizedElement& other) const { return priority < other.priority; }
+    };
+
+    float calculatePriority(OctreeElement* element) const;
+    void rebuildPriorityQueue();
+    void dropDeletedElements(); // makes sure the next element extract() would return is still alive
+
+    QHash<OctreeElement*, OctreeElementHandle> _bagElements; // element to the handle taken when it was inserted
+
+    // In priority mode _bagElements is still the source of truth for membership. The heap may hold entries for elements
+    // that have since been removed or deleted, they are skipped when they reach the top, which keeps remove() as cheap
+    // as before.
+    const ViewFrustum* _priorityViewFrustum;
+    std::vector<PrioritizedElement> _priorityQueue;
 };
 
 #endif // hifi_OctreeElementBag_h
@@ -0,0 +1,104 @@
+//
+//  OctreeElementPool.cpp
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QMutexLocker>
+
+#include "OctreeElementPool.h"
+
+// pools can be created during static initialization (for example by a static tree's root element), so the registry is
+// built on first use rather than relying on the static initialization order of this file
+static QMutex& poolRegistryMutex() {
+    static QMutex* mutex = new QMutex();
+    return *mutex;
+}
+
+static std::vector<OctreeElementPool*>& poolRegistry() {
+    static std::vector<OctreeElementPool*>* pools = new std::vector<OctreeElementPool*>();
+    return *pools;
+}
+
+// every item must be able to hold the free list link, and keep the same alignment the global heap would give it
+const size_t POOL_ITEM_ALIGNMENT = 2 * sizeof(void*);
+
+OctreeElementPool::OctreeElementPool(const QString& name, size_t itemSize, int itemsPerSlab) :
+    _name(name),
+    _itemSize(itemSize),
+    _itemsPerSlab(itemsPerSlab),
+    _mutex(),
+    _freeList(NULL),
+    _slabs(),
+    _liveCount(0),
+    _freeCount(0),
+    _allocationCount(0)
+{
+    if (_itemSize < sizeof(FreeItem)) {
+        _itemSize = sizeof(FreeItem);
+    }
+    _itemSize = ((_itemSize + POOL_ITEM_ALIGNMENT - 1) / POOL_ITEM_ALIGNMENT) * POOL_ITEM_ALIGNMENT;
+
+    QMutexLocker locker(&poolRegistryMutex());
+    poolRegistry().push_back(this);
+}
+
+void OctreeElementPool::allocateSlab() {
+    // the global operator new returns memory suitably aligned for any type, and since _itemSize is a multiple of
+    // POOL_ITEM_ALIGNMENT every item in the slab keeps that alignment
+    char* slab = static_cast<char*>(::operator new(_itemSize * _itemsPerSlab));
+    _slabs.push_back(slab);
+
+    // thread the new items onto the free list back to front, so that allocations walk the slab in address order
+    for (int i = _itemsPerSlab - 1; i >= 0; i--) {
+        FreeItem* item = reinterpret_cast<FreeItem*>(slab + (i * _itemSize));
+        item->next = _freeList;
+        _freeList = item;
+    }
+    _freeCount += _itemsPerSlab;
+}
+
+void* OctreeElementPool::allocate() {
+    _mutex.lock();
+    if (!_freeList) {
+        allocateSlab();
+    }
+    FreeItem* item = _freeList;
+    _freeList = item->next;
+    _freeCount--;
+    _liveCount++;
+    _allocationCount++;
+    _mutex.unlock();
+    return item;
+}
+
+void OctreeElementPool::deallocate(void* item) {
+    if (!item) {
+        return;
+    }
+    _mutex.lock();
+    FreeItem* freeItem = static_cast<FreeItem*>(item);
+    freeItem->next = _freeList;
+    _freeList = freeItem;
+    _freeCount++;
+    _liveCount--;
+    _mutex.unlock();
+}
+
+std::vector<OctreeElementPool*> OctreeElementPool::getPools() {
+    QMutexLocker locker(&poolRegistryMutex());
+    return poolRegistry();
+}
+
+quint64 OctreeElementPool::getTotalReservedMemory() {
+    quint64 total = 0;
+    std::vector<OctreeElementPool*> pools = getPools();
+    for (size_t i = 0; i < pools.size(); i++) {
+        total += pools[i]->getReservedMemory();
+    }
+    return total;
+}
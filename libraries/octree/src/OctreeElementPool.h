@@ -0,0 +1,98 @@
+//
+//  OctreeElementPool.h
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A slab allocator for fixed size octree objects. Octree element subclasses route their operator new/delete through a
+//  pool of their own size, so elements are carved out of large slabs instead of one heap allocation each. Freed elements
+//  go onto a free list and are reused by the next allocation, which keeps bulk loads and teardowns out of the general
+//  purpose heap and avoids the per allocation malloc overhead on every node.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeElementPool_h
+#define hifi_OctreeElementPool_h
+
+#include <vector>
+
+#include <QMutex>
+#include <QString>
+
+class OctreeElementPool {
+public:
+    static const int DEFAULT_ITEMS_PER_SLAB = 1024;
+
+    OctreeElementPool(const QString& name, size_t itemSize, int itemsPerSlab = DEFAULT_ITEMS_PER_SLAB);
+
+    /// Returns storage for one item of getItemSize() bytes, allocating a new slab if the free list is empty.
+    void* allocate();
+
+    /// Returns an item previously handed out by allocate() to the free list. NULL is ignored.
+    void deallocate(void* item);
+
+    const QString& getName() const { return _name; }
+    size_t getItemSize() const { return _itemSize; }
+    quint64 getLiveCount() const { return _liveCount; }
+    quint64 getFreeCount() const { return _freeCount; }
+    quint64 getSlabCount() const { return _slabs.size(); }
+    quint64 getAllocationCount() const { return _allocationCount; }
+    quint64 getReservedMemory() const { return getSlabCount() * _itemsPerSlab * _itemSize; }
+
+    /// All pools that have been created in this process, for stats reporting.
+    static std::vector<OctreeElementPool*> getPools();
+    static quint64 getTotalReservedMemory();
+
+private:
+    // pools are created on first use and live for the life of the process, elements may still be deleted by static
+    // destructors after main() returns so we never hand slabs back
+    OctreeElementPool(const OctreeElementPool&);
+    OctreeElementPool& operator=(const OctreeElementPool&);
+
+    void allocateSlab();
+
+    struct FreeItem {
+        FreeItem* next;
+    };
+
+    QString _name;
+    size_t _itemSize;
+    int _itemsPerSlab;
+
+    QMutex _mutex;
+    FreeItem* _freeList;
+    std::vector<char*> _slabs;
+
+    quint64 _liveCount;
+    quint64 _freeCount;
+    quint64 _allocationCount;
+};
+
+/// Use in the declaration of a fixed size octree class to give it pooled operator new/delete. The class must also use
+/// IMPLEMENT_OCTREE_ELEMENT_POOL() in its implementation file. Allocations of a different size than the class itself
+/// (for example an unpooled subclass) fall through to the global heap.
+#define DECLARE_OCTREE_ELEMENT_POOL() \
+public: \
+    static void* operator new(size_t size); \
+    static void operator delete(void* pointer, size_t size); \
+    static OctreeElementPool& getElementPool();
+
+#define IMPLEMENT_OCTREE_ELEMENT_POOL(Class) \
+    OctreeElementPool& Class::getElementPool() { \
+        static OctreeElementPool* pool = new OctreeElementPool(#Class, sizeof(Class)); \
+        return *pool; \
+    } \
+    void* Class::operator new(size_t size) { \
+        return (size == sizeof(Class)) ? getElementPool().allocate() : ::operator new(size); \
+    } \
+    void Class::operator delete(void* pointer, size_t size) { \
+        if (size == sizeof(Class)) { \
+            getElementPool().deallocate(pointer); \
+        } else { \
+            ::operator delete(pointer); \
+        } \
+    }
+
+#endif // hifi_OctreeElementPool_h
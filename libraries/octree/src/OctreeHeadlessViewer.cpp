@@ -59,6 +59,7 @@ void OctreeHeadlessViewer::queryOctree() {
     _octreeQuery.setWantDelta(true);
     _octreeQuery.setWantOcclusionCulling(false);
     _octreeQuery.setWantCompression(true); // TODO: should be on by default
+    _octreeQuery.setWantFastCompression(true);
 
     _octreeQuery.setCameraPosition(_viewFrustum.getPosition());
     _octreeQuery.setCameraOrientation(_viewFrustum.getOrientation());
@@ -0,0 +1,30 @@
+//
+//  OctreeItemIndex.cpp
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeItemIndex.h"
+
+void OctreeItemIndex::insert(quint32 id, OctreeElement* element) {
+    _entries.insert(id, element->getHandle());
+}
+
+void OctreeItemIndex::remove(quint32 id, const OctreeElement* element) {
+    QHash<quint32, OctreeElementHandle>::iterator entry = _entries.find(id);
+    if (entry != _entries.end() && entry.value().element == element) {
+        _entries.erase(entry);
+    }
+}
+
+OctreeElement* OctreeItemIndex::find(quint32 id) const {
+    QHash<quint32, OctreeElementHandle>::const_iterator entry = _entries.constFind(id);
+    if (entry == _entries.constEnd() || !entry.value().isAlive()) {
+        return NULL;
+    }
+    return entry.value().element;
+}
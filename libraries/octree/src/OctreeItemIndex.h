@@ -0,0 +1,51 @@
+//
+//  OctreeItemIndex.h
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Maps the IDs of the items stored in an octree, like particles and models, to the element that holds each of them,
+//  so that finding an item by ID doesn't need a recursion over the whole tree.
+//
+//  The trees keep the index up to date as items are stored, moved and removed, and the elements take their items out
+//  when they are deleted. Entries are still weak handles like the ones in OctreeElementBag (see
+//  OctreeElement::getHandle()), so that a missed removal can't hand out a deleted element, and callers should check that
+//  the element holds the item.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeItemIndex_h
+#define hifi_OctreeItemIndex_h
+
+#include <QHash>
+
+#include "OctreeElement.h"
+
+class OctreeItemIndex {
+public:
+    /// records element as the holder of the item with id, replacing any element recorded before
+    void insert(quint32 id, OctreeElement* element);
+
+    /// forgets the item with id, but only if element is the one recorded for it, so that an item that was already
+    /// stored somewhere else stays indexed
+    void remove(quint32 id, const OctreeElement* element);
+
+    /// \return the element recorded for id, or NULL if there is none or it has since been deleted
+    OctreeElement* find(quint32 id) const;
+
+    /// \return whether an entry for id exists
+    bool contains(quint32 id) const { return _entries.contains(id); }
+
+    void clear() { _entries.clear(); }
+
+    /// the number of entries, including any whose element no longer holds the item
+    int size() const { return _entries.size(); }
+    QList<quint32> getIDs() const { return _entries.keys(); }
+
+private:
+    QHash<quint32, OctreeElementHandle> _entries;
+};
+
+#endif // hifi_OctreeItemIndex_h
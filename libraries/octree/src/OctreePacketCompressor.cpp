@@ -0,0 +1,369 @@
+//
+//  OctreePacketCompressor.cpp
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <QVarLengthArray>
+
+#include <zlib.h>
+
+#include <SharedUtil.h>
+
+#include "OctreeConstants.h"
+#include "OctreePacketCompressor.h"
+#include "OctreePacketData.h"
+#include "OctreePacketDictionary.h"
+
+const int FastLZPacketCompressor::MAX_DICTIONARY_SIZE;
+
+OctreePacketCompressor::OctreePacketCompressor() :
+    _dictionary()
+{
+    _compressCalls.reset();
+    _compressTime.reset();
+    _failedCompressCalls.reset();
+    _uncompressedBytes.reset();
+    _compressedBytes.reset();
+}
+
+OctreePacketCompressor::~OctreePacketCompressor() {
+}
+
+int OctreePacketCompressor::compress(const unsigned char* input, int inputLength,
+                                     unsigned char* output, int outputCapacity) {
+    quint64 start = usecTimestampNow();
+    int compressedLength = compressContent(input, inputLength, output, outputCapacity);
+    _compressTime += (int)(usecTimestampNow() - start);
+    _compressCalls++;
+    if (compressedLength < 0) {
+        _failedCompressCalls++;
+    } else {
+        _uncompressedBytes += inputLength;
+        _compressedBytes += compressedLength;
+    }
+    return compressedLength;
+}
+
+static OctreePacketCompressor* newFastLZCompressor() {
+    OctreePacketCompressor* compressor = new FastLZPacketCompressor();
+    compressor->setDictionary(OctreePacketCompressor::getDefaultDictionary());
+    return compressor;
+}
+
+OctreePacketCompressor* OctreePacketCompressor::getCompressor(OctreePacketCompressionCodec codec) {
+    // created on first use and never destroyed, packets may still be decoded by static destructors
+    static OctreePacketCompressor* zlibCompressor = new ZlibPacketCompressor();
+    static OctreePacketCompressor* fastLZCompressor = newFastLZCompressor();
+    return (codec == FAST_LZ_PACKET_COMPRESSION) ? fastLZCompressor : zlibCompressor;
+}
+
+const QByteArray& OctreePacketCompressor::getDefaultDictionary() {
+    // created on first use and never destroyed, like the compressors
+    static QByteArray* dictionary = new QByteArray(QByteArray::fromRawData(
+        reinterpret_cast<const char*>(OCTREE_PACKET_DICTIONARY), sizeof(OCTREE_PACKET_DICTIONARY)));
+    return *dictionary;
+}
+
+// qCompress() prefixes the zlib stream with the uncompressed length as a big endian 32 bit value
+const int ZLIB_LENGTH_HEADER_SIZE = 4;
+
+ZlibPacketCompressor::ZlibPacketCompressor(int level) :
+    _level(level)
+{
+}
+
+int ZlibPacketCompressor::compressContent(const unsigned char* input, int inputLength,
+                                          unsigned char* output, int outputCapacity) {
+    if (outputCapacity <= ZLIB_LENGTH_HEADER_SIZE) {
+        return -1;
+    }
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit(&stream, _level) != Z_OK) {
+        return -1;
+    }
+    if (!_dictionary.isEmpty()) {
+        deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(_dictionary.constData()), _dictionary.size());
+    }
+    stream.next_in = const_cast<Bytef*>(input);
+    stream.avail_in = inputLength;
+    stream.next_out = output + ZLIB_LENGTH_HEADER_SIZE;
+    stream.avail_out = outputCapacity - ZLIB_LENGTH_HEADER_SIZE;
+
+    // a single Z_FINISH call only returns Z_STREAM_END if all of the output fit
+    int result = deflate(&stream, Z_FINISH);
+    int compressedLength = (int)stream.total_out;
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        return -1;
+    }
+
+    output[0] = (inputLength >> 24) & 0xff;
+    output[1] = (inputLength >> 16) & 0xff;
+    output[2] = (inputLength >> 8) & 0xff;
+    output[3] = inputLength & 0xff;
+    return ZLIB_LENGTH_HEADER_SIZE + compressedLength;
+}
+
+int ZlibPacketCompressor::decompress(const unsigned char* input, int inputLength,
+                                     unsigned char* output, int outputCapacity) {
+    if (inputLength <= ZLIB_LENGTH_HEADER_SIZE) {
+        return -1;
+    }
+    unsigned int expectedLength = (input[0] << 24) | (input[1] << 16) | (input[2] << 8) | input[3];
+    if (expectedLength > (unsigned int)outputCapacity) {
+        return -1;
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit(&stream) != Z_OK) {
+        return -1;
+    }
+    stream.next_in = const_cast<Bytef*>(input + ZLIB_LENGTH_HEADER_SIZE);
+    stream.avail_in = inputLength - ZLIB_LENGTH_HEADER_SIZE;
+    stream.next_out = output;
+    stream.avail_out = expectedLength;
+
+    int result = inflate(&stream, Z_FINISH);
+    if (result == Z_NEED_DICT && !_dictionary.isEmpty()) {
+        inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(_dictionary.constData()), _dictionary.size());
+        result = inflate(&stream, Z_FINISH);
+    }
+    unsigned int decompressedLength = stream.total_out;
+    inflateEnd(&stream);
+    if (result != Z_STREAM_END || decompressedLength != expectedLength) {
+        return -1;
+    }
+    return decompressedLength;
+}
+
+const int FAST_LZ_LENGTH_HEADER_SIZE = sizeof(quint16);
+const int FAST_LZ_MAX_INPUT_SIZE = 65535;
+const int FAST_LZ_MIN_MATCH = 4;
+const int FAST_LZ_MAX_OFFSET = 65535;
+const int FAST_LZ_HASH_BITS = 12;
+const int FAST_LZ_HASH_SIZE = 1 << FAST_LZ_HASH_BITS;
+const int FAST_LZ_NIBBLE_MAX = 15;
+const int FAST_LZ_LENGTH_BYTE_MAX = 255;
+
+// the dictionary and the packet are matched as one window, so that matches can reach back into the dictionary
+typedef QVarLengthArray<unsigned char,
+    FastLZPacketCompressor::MAX_DICTIONARY_SIZE + MAX_OCTREE_PREDICTED_SECTION_SIZE> FastLZWindow;
+
+static quint32 readFourBytes(const unsigned char* at) {
+    quint32 value;
+    memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+static int fastLZHash(quint32 fourBytes) {
+    // Knuth's multiplicative hash, keeping the top bits
+    return (int)((fourBytes * 2654435761U) >> (32 - FAST_LZ_HASH_BITS));
+}
+
+static unsigned char* writeExtendedLength(unsigned char* at, int length) {
+    while (length >= FAST_LZ_LENGTH_BYTE_MAX) {
+        *at++ = FAST_LZ_LENGTH_BYTE_MAX;
+        length -= FAST_LZ_LENGTH_BYTE_MAX;
+    }
+    *at++ = length;
+    return at;
+}
+
+/// writes one sequence, matchLength of 0 means the final literals only sequence
+/// \return the new output position, or NULL if the sequence does not fit before outputEnd
+static unsigned char* writeSequence(unsigned char* at, const unsigned char* outputEnd, const unsigned char* literals,
+                                    int literalLength, int offset, int matchLength) {
+    int worstCase = 1 + (literalLength / FAST_LZ_LENGTH_BYTE_MAX + 1) + literalLength
+                    + sizeof(quint16) + (matchLength / FAST_LZ_LENGTH_BYTE_MAX + 1);
+    if (at + worstCase > outputEnd) {
+        return NULL;
+    }
+
+    int matchCode = (matchLength > 0) ? matchLength - FAST_LZ_MIN_MATCH : 0;
+    unsigned char* token = at++;
+    *token = (std::min(literalLength, FAST_LZ_NIBBLE_MAX) << 4) | std::min(matchCode, FAST_LZ_NIBBLE_MAX);
+    if (literalLength >= FAST_LZ_NIBBLE_MAX) {
+        at = writeExtendedLength(at, literalLength - FAST_LZ_NIBBLE_MAX);
+    }
+    memcpy(at, literals, literalLength);
+    at += literalLength;
+
+    if (matchLength > 0) {
+        quint16 packedOffset = offset;
+        memcpy(at, &packedOffset, sizeof(packedOffset));
+        at += sizeof(packedOffset);
+        if (matchCode >= FAST_LZ_NIBBLE_MAX) {
+            at = writeExtendedLength(at, matchCode - FAST_LZ_NIBBLE_MAX);
+        }
+    }
+    return at;
+}
+
+int FastLZPacketCompressor::compressContent(const unsigned char* input, int inputLength,
+                                            unsigned char* output, int outputCapacity) {
+    if (inputLength > FAST_LZ_MAX_INPUT_SIZE || outputCapacity < FAST_LZ_LENGTH_HEADER_SIZE) {
+        return -1;
+    }
+
+    int dictionaryLength = std::min(_dictionary.size(), MAX_DICTIONARY_SIZE);
+    const unsigned char* window = input;
+    FastLZWindow dictionaryWindow;
+    if (dictionaryLength > 0) {
+        dictionaryWindow.resize(dictionaryLength + inputLength);
+        memcpy(dictionaryWindow.data(), _dictionary.constData() + _dictionary.size() - dictionaryLength,
+               dictionaryLength);
+        memcpy(dictionaryWindow.data() + dictionaryLength, input, inputLength);
+        window = dictionaryWindow.constData();
+    }
+
+    // positions are stored plus one, so that a zeroed table means no candidates
+    int hashTable[FAST_LZ_HASH_SIZE];
+    memset(hashTable, 0, sizeof(hashTable));
+    for (int position = 0; position + FAST_LZ_MIN_MATCH <= dictionaryLength; position++) {
+        hashTable[fastLZHash(readFourBytes(window + position))] = position + 1;
+    }
+
+    quint16 packedLength = inputLength;
+    memcpy(output, &packedLength, sizeof(packedLength));
+    unsigned char* outputAt = output + FAST_LZ_LENGTH_HEADER_SIZE;
+    const unsigned char* outputEnd = output + outputCapacity;
+
+    int end = dictionaryLength + inputLength;
+    int anchor = dictionaryLength;
+    int position = dictionaryLength;
+    while (position + FAST_LZ_MIN_MATCH <= end) {
+        quint32 fourBytes = readFourBytes(window + position);
+        int hash = fastLZHash(fourBytes);
+        int candidate = hashTable[hash] - 1;
+        hashTable[hash] = position + 1;
+
+        if (candidate < 0 || position - candidate > FAST_LZ_MAX_OFFSET || readFourBytes(window + candidate) != fourBytes) {
+            position++;
+            continue;
+        }
+
+        int matchLength = FAST_LZ_MIN_MATCH;
+        while (position + matchLength < end && window[candidate + matchLength] == window[position + matchLength]) {
+            matchLength++;
+        }
+        outputAt = writeSequence(outputAt, outputEnd, window + anchor, position - anchor, position - candidate, matchLength);
+        if (!outputAt) {
+            return -1;
+        }
+        position += matchLength;
+        anchor = position;
+    }
+
+    outputAt = writeSequence(outputAt, outputEnd, window + anchor, end - anchor, 0, 0);
+    if (!outputAt) {
+        return -1;
+    }
+    return outputAt - output;
+}
+
+static const unsigned char* readExtendedLength(const unsigned char* at, const unsigned char* inputEnd, int& length) {
+    unsigned char byte;
+    do {
+        if (at >= inputEnd) {
+            return NULL;
+        }
+        byte = *at++;
+        length += byte;
+    } while (byte == FAST_LZ_LENGTH_BYTE_MAX);
+    return at;
+}
+
+int FastLZPacketCompressor::decompress(const unsigned char* input, int inputLength,
+                                       unsigned char* output, int outputCapacity) {
+    if (inputLength < FAST_LZ_LENGTH_HEADER_SIZE + 1) {
+        return -1;
+    }
+    quint16 packedLength;
+    memcpy(&packedLength, input, sizeof(packedLength));
+    int expectedLength = packedLength;
+    if (expectedLength > outputCapacity) {
+        return -1;
+    }
+
+    // with a dictionary we decode behind a copy of it so that offsets can reach back into it, then copy the packet out
+    int dictionaryLength = std::min(_dictionary.size(), MAX_DICTIONARY_SIZE);
+    unsigned char* window = output;
+    FastLZWindow dictionaryWindow;
+    if (dictionaryLength > 0) {
+        dictionaryWindow.resize(dictionaryLength + expectedLength);
+        memcpy(dictionaryWindow.data(), _dictionary.constData() + _dictionary.size() - dictionaryLength,
+               dictionaryLength);
+        window = dictionaryWindow.data();
+    }
+
+    const unsigned char* inputAt = input + FAST_LZ_LENGTH_HEADER_SIZE;
+    const unsigned char* inputEnd = input + inputLength;
+    unsigned char* outputAt = window + dictionaryLength;
+    const unsigned char* outputEnd = outputAt + expectedLength;
+
+    while (true) {
+        if (inputAt >= inputEnd) {
+            return -1;
+        }
+        unsigned char token = *inputAt++;
+
+        int literalLength = token >> 4;
+        if (literalLength == FAST_LZ_NIBBLE_MAX && !(inputAt = readExtendedLength(inputAt, inputEnd, literalLength))) {
+            return -1;
+        }
+        if (literalLength > inputEnd - inputAt || literalLength > outputEnd - outputAt) {
+            return -1;
+        }
+        memcpy(outputAt, inputAt, literalLength);
+        inputAt += literalLength;
+        outputAt += literalLength;
+
+        // every sequence but the last is followed by a match of at least FAST_LZ_MIN_MATCH bytes
+        if (outputAt == outputEnd) {
+            break;
+        }
+
+        if (inputEnd - inputAt < (int)sizeof(quint16)) {
+            return -1;
+        }
+        quint16 offset;
+        memcpy(&offset, inputAt, sizeof(offset));
+        inputAt += sizeof(offset);
+        if (offset == 0 || offset > outputAt - window) {
+            return -1;
+        }
+
+        int matchLength = token & FAST_LZ_NIBBLE_MAX;
+        if (matchLength == FAST_LZ_NIBBLE_MAX && !(inputAt = readExtendedLength(inputAt, inputEnd, matchLength))) {
+            return -1;
+        }
+        matchLength += FAST_LZ_MIN_MATCH;
+        if (matchLength > outputEnd - outputAt) {
+            return -1;
+        }
+
+        // matches may overlap their own output, so copy forward a byte at a time
+        const unsigned char* matchAt = outputAt - offset;
+        for (int i = 0; i < matchLength; i++) {
+            *outputAt++ = *matchAt++;
+        }
+    }
+
+    if (inputAt != inputEnd) {
+        return -1;
+    }
+    if (dictionaryLength > 0) {
+        memcpy(output, window + dictionaryLength, expectedLength);
+    }
+    return expectedLength;
+}
@@ -0,0 +1,114 @@
+//
+//  OctreePacketCompressor.h
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Codecs used to compress the sections of octree data packets. The zlib codec produces the same stream as qCompress(),
+//  so it stays compatible with clients that predate the codec interface. The fast LZ codec trades some compression ratio
+//  for much cheaper compression, which matters since the send threads compress every section they finalize.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePacketCompressor_h
+#define hifi_OctreePacketCompressor_h
+
+#include <QByteArray>
+
+#include <AtomicCounter.h>
+
+enum OctreePacketCompressionCodec {
+    ZLIB_PACKET_COMPRESSION = 0,
+    FAST_LZ_PACKET_COMPRESSION
+};
+
+class OctreePacketCompressor {
+public:
+    OctreePacketCompressor();
+    virtual ~OctreePacketCompressor();
+
+    virtual OctreePacketCompressionCodec getCodec() const = 0;
+    virtual const char* getName() const = 0;
+
+    /// compresses input into output
+    /// \return the number of bytes written to output, or -1 if the compressed form does not fit in outputCapacity
+    int compress(const unsigned char* input, int inputLength, unsigned char* output, int outputCapacity);
+
+    /// decompresses input, which must be a complete stream produced by compress() with the same dictionary
+    /// \return the number of bytes written to output, or -1 if the stream is corrupt or does not fit in outputCapacity
+    virtual int decompress(const unsigned char* input, int inputLength, unsigned char* output, int outputCapacity) = 0;
+
+    /// Sets a preset dictionary of content expected to show up in packets, which primes the codec so that even small
+    /// sections compress well. The dictionary is not sent on the wire, both ends must set the same one before any
+    /// packets are compressed. Pass an empty array to go back to no dictionary.
+    void setDictionary(const QByteArray& dictionary) { _dictionary = dictionary; }
+    const QByteArray& getDictionary() const { return _dictionary; }
+
+    quint64 getCompressCalls() const { return _compressCalls.get(); } /// total calls to compress()
+    quint64 getCompressTime() const { return _compressTime.get(); } /// total usecs spent in compress()
+    quint64 getFailedCompressCalls() const { return _failedCompressCalls.get(); } /// calls whose result did not fit
+    quint64 getUncompressedBytes() const { return _uncompressedBytes.get(); } /// total input bytes of successful calls
+    quint64 getCompressedBytes() const { return _compressedBytes.get(); } /// total output bytes of successful calls
+
+    /// The shared instance of a codec. The fast LZ one is created with getDefaultDictionary(), the zlib one has no
+    /// dictionary, since its stream must stay readable by qUncompress() in clients that predate the codecs.
+    static OctreePacketCompressor* getCompressor(OctreePacketCompressionCodec codec);
+
+    /// a dictionary of runs that octree bitstreams share, checked in as OCTREE_PACKET_DICTIONARY
+    static const QByteArray& getDefaultDictionary();
+
+protected:
+    virtual int compressContent(const unsigned char* input, int inputLength,
+                                unsigned char* output, int outputCapacity) = 0;
+
+    QByteArray _dictionary;
+
+private:
+    // the send threads of every client compress with the same instance
+    AtomicCounter _compressCalls;
+    AtomicCounter _compressTime;
+    AtomicCounter _failedCompressCalls;
+    AtomicCounter _uncompressedBytes;
+    AtomicCounter _compressedBytes;
+};
+
+/// Produces the same stream as qCompress(), a big endian uncompressed length followed by a zlib stream.
+class ZlibPacketCompressor : public OctreePacketCompressor {
+public:
+    static const int DEFAULT_COMPRESSION_LEVEL = 9;
+
+    ZlibPacketCompressor(int level = DEFAULT_COMPRESSION_LEVEL);
+
+    virtual OctreePacketCompressionCodec getCodec() const { return ZLIB_PACKET_COMPRESSION; }
+    virtual const char* getName() const { return "zlib"; }
+    virtual int decompress(const unsigned char* input, int inputLength, unsigned char* output, int outputCapacity);
+
+    void setLevel(int level) { _level = level; }
+    int getLevel() const { return _level; }
+
+protected:
+    virtual int compressContent(const unsigned char* input, int inputLength, unsigned char* output, int outputCapacity);
+
+private:
+    int _level;
+};
+
+/// A byte oriented LZ77 codec in the style of LZ4. The stream is the uncompressed length followed by sequences of a
+/// token byte (literal count in the high nibble, match length in the low nibble), the literals, and a two byte offset
+/// back to the match. The last sequence has literals only.
+class FastLZPacketCompressor : public OctreePacketCompressor {
+public:
+    /// the largest dictionary that is used, only its last MAX_DICTIONARY_SIZE bytes are used if it is longer
+    static const int MAX_DICTIONARY_SIZE = 4096;
+
+    virtual OctreePacketCompressionCodec getCodec() const { return FAST_LZ_PACKET_COMPRESSION; }
+    virtual const char* getName() const { return "fast LZ"; }
+    virtual int decompress(const unsigned char* input, int inputLength, unsigned char* output, int outputCapacity);
+
+protected:
+    virtual int compressContent(const unsigned char* input, int inputLength, unsigned char* output, int outputCapacity);
+};
+
+#endif // hifi_OctreePacketCompressor_h
@@ -24,13 +24,30 @@ quint64 OctreePacketData::_totalBytesOfRawData = 0;
 
 
 
-OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
-    changeSettings(enableCompression, targetSize); // does reset...
+const int COMPRESSION_RATIO_SAMPLES = 32;
+
+OctreePacketData::OctreePacketData(bool enableCompression, int targetSize, OctreePacketCompressionCodec codec) :
+    _compressor(OctreePacketCompressor::getCompressor(codec)),
+    _compressionRatio(COMPRESSION_RATIO_SAMPLES)
+{
+    changeSettings(enableCompression, targetSize, codec); // does reset...
 }
 
-void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize) {
+void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize, OctreePacketCompressionCodec codec) {
     _enableCompression = enableCompression;
-    _targetSize = std::min(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, targetSize);
+    if (codec != _compressor->getCodec()) {
+        // the ratio we've seen so far says nothing about another codec
+        _compressor = OctreePacketCompressor::getCompressor(codec);
+        _compressionRatio.reset();
+    }
+    _targetSize = std::min(MAX_OCTREE_PREDICTED_SECTION_SIZE, targetSize);
+    reset();
+}
+
+void OctreePacketData::changeCompressedSettings(unsigned int compressedBytesAvailable,
+                                                OctreePacketCompressionCodec codec) {
+    changeSettings(true, getMaxSectionSize(codec), codec); // the prediction must use the new codec's ratio
+    _targetSize = getPredictedTargetSize(compressedBytesAvailable);
     reset();
 }
 
@@ -366,25 +383,60 @@ bool OctreePacketData::compressContent() {
     _bytesInUseLastCheck = _bytesInUse;
 
     bool success = false;
-    const int MAX_COMPRESSION = 9;
 
     // we only want to compress the data payload, not the message header
-    const uchar* uncompressedData = &_uncompressed[0];
-    int uncompressedSize = _bytesInUse;
-
-    QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+    int compressedBytes = _compressor->compress(&_uncompressed[0], _bytesInUse, &_compressed[0], sizeof(_compressed));
+    if (compressedBytes >= 0) {
+        _compressedBytes = compressedBytes;
+        _dirty = false;
+        success = true;
 
-    if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
-        _compressedBytes = compressedData.size();
-        for (int i = 0; i < _compressedBytes; i++) {
-            _compressed[i] = compressedData[i];
+        if (_compressedBytes > (int)MAX_OCTREE_COMPRESSED_SECTION_SIZE) {
+            // the section compressed so much worse than predicted that it outgrew a packet, forget what we've seen so
+            // that the next section is cut at a size that is sure to fit
+            _compressionRatio.reset();
+        } else if (_bytesInUse > 0) {
+            _compressionRatio.updateAverage((float)_compressedBytes / (float)_bytesInUse);
         }
+    } else {
+        // _compressed has room for any section that doesn't compress at all, so this doesn't happen, but the stale
+        // compressed form must never pass for this content, so the section is reported as too large to send
+        _compressedBytes = sizeof(_compressed);
         _dirty = false;
-        success = true;
     }
     return success;
 }
 
+unsigned int OctreePacketData::getPredictedTargetSize(unsigned int compressedBytesAvailable) const {
+    if (compressedBytesAvailable <= COMPRESS_PADDING) {
+        return 0;
+    }
+    // this is what we'd target without any history, and it is safe since COMPRESS_PADDING covers the worst case
+    // inflation of both codecs for a packet sized input
+    unsigned int targetSize = compressedBytesAvailable - COMPRESS_PADDING;
+
+    const float MINIMUM_PREDICTED_RATIO = 0.05f;
+    const float PREDICTION_SAFETY_MARGIN = 0.9f; // aim a little low, an overshoot costs a send of a partly empty packet
+    if (_enableCompression && _compressionRatio.getSampleCount() > 0) {
+        float ratio = std::max(_compressionRatio.getAverage(), MINIMUM_PREDICTED_RATIO);
+        unsigned int predictedSize = (unsigned int)(PREDICTION_SAFETY_MARGIN * targetSize / ratio);
+        targetSize = std::max(targetSize, predictedSize);
+    }
+
+    // a section that compresses worse than predicted can outgrow compressedBytesAvailable, the sender then moves it to a
+    // packet of its own, or encodes it again if it outgrew that too, see getFinalizedSize()
+    return std::min(targetSize, getMaxSectionSize(_compressor->getCodec()));
+}
+
+OctreePacketCompressionCodec OctreePacketData::compressionCodecForFlags(OCTREE_PACKET_FLAGS flags) {
+    return oneAtBit(flags, PACKET_IS_FAST_COMPRESSED_BIT) ? FAST_LZ_PACKET_COMPRESSION : ZLIB_PACKET_COMPRESSION;
+}
+
+unsigned int OctreePacketData::getMaxSectionSize(OctreePacketCompressionCodec codec) {
+    // clients that predate the fast codec decode zlib sections into one packet
+    return (codec == FAST_LZ_PACKET_COMPRESSION) ? MAX_OCTREE_PREDICTED_SECTION_SIZE
+                                                 : MAX_OCTREE_UNCOMRESSED_PACKET_SIZE;
+}
 
 void OctreePacketData::loadFinalizedContent(const unsigned char* data, int length) {
     reset();
@@ -392,20 +444,14 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
     if (data && length > 0) {
 
         if (_enableCompression) {
-            QByteArray compressedData;
-            for (int i = 0; i < length; i++) {
-                compressedData[i] = data[i];
-                _compressed[i] = compressedData[i];
+            if (length <= (int)sizeof(_compressed)) {
+                memcpy(_compressed, data, length);
+                _compressedBytes = length;
             }
-            _compressedBytes = length;
-            QByteArray uncompressedData = qUncompress(compressedData);
-            if (uncompressedData.size() <= _bytesAvailable) {
-                _bytesInUse = uncompressedData.size();
-                _bytesAvailable -= uncompressedData.size();
-
-                for (int i = 0; i < _bytesInUse; i++) {
-                    _uncompressed[i] = uncompressedData[i];
-                }
+            int uncompressedBytes = _compressor->decompress(data, length, &_uncompressed[0], _bytesAvailable);
+            if (uncompressedBytes >= 0) {
+                _bytesInUse = uncompressedBytes;
+                _bytesAvailable -= uncompressedBytes;
             }
         } else {
             for (int i = 0; i < length; i++) {
@@ -22,8 +22,11 @@
 #ifndef hifi_OctreePacketData_h
 #define hifi_OctreePacketData_h
 
+#include <SimpleMovingAverage.h>
+
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
+#include "OctreePacketCompressor.h"
 
 typedef unsigned char OCTREE_PACKET_FLAGS;
 typedef uint16_t OCTREE_PACKET_SEQUENCE;
@@ -40,12 +43,22 @@ const unsigned int MAX_OCTREE_PACKET_DATA_SIZE = MAX_PACKET_SIZE - (MAX_PACKET_H
             
 const unsigned int MAX_OCTREE_UNCOMRESSED_PACKET_SIZE = MAX_OCTREE_PACKET_DATA_SIZE;
 
+// Sections whose size is predicted from the compression ratio can hold more than a packet of content, so that content
+// that compresses well fills a wire packet in one section. Only fast LZ sections do, zlib ones stay within
+// MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, since clients that predate the fast codec decode them into a buffer of that size.
+const unsigned int MAX_OCTREE_PREDICTED_SECTION_SIZE = 4 * MAX_OCTREE_PACKET_DATA_SIZE;
+
+// the largest compressed section, it must fit in an empty wire packet along with its size
+const unsigned int MAX_OCTREE_COMPRESSED_SECTION_SIZE = MAX_OCTREE_PACKET_DATA_SIZE
+                                                        - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+
 const unsigned int MINIMUM_ATTEMPT_MORE_PACKING = sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) + 40;
 const unsigned int COMPRESS_PADDING = 15;
 const int REASONABLE_NUMBER_OF_PACKING_ATTEMPTS = 5;
 
 const int PACKET_IS_COLOR_BIT = 0;
 const int PACKET_IS_COMPRESSED_BIT = 1;
+const int PACKET_IS_FAST_COMPRESSED_BIT = 2; // only meaningful with PACKET_IS_COMPRESSED_BIT, sections use the fast LZ codec
 
 /// An opaque key used when starting, ending, and discarding encoding/packing levels of OctreePacketData
 class LevelDetails {
@@ -68,11 +81,17 @@ private:
 /// Handles packing of the data portion of PacketType_OCTREE_DATA messages. 
 class OctreePacketData {
 public:
-    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                     OctreePacketCompressionCodec codec = ZLIB_PACKET_COMPRESSION);
     ~OctreePacketData();
 
     /// change compression and target size settings
-    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                        OctreePacketCompressionCodec codec = ZLIB_PACKET_COMPRESSION);
+
+    /// Changes to compressed sections that are to fill compressedBytesAvailable bytes of a wire packet. The target size
+    /// is predicted with getPredictedTargetSize(), nothing is compressed until the section is finalized.
+    void changeCompressedSettings(unsigned int compressedBytesAvailable, OctreePacketCompressionCodec codec);
 
     /// reset completely, all data is discarded
     void reset();
@@ -153,7 +172,9 @@ public:
 
     /// get access to the finalized data (it may be compressed or rewritten into optimal form)
     const unsigned char* getFinalizedData();
-    /// get size of the finalized data (it may be compressed or rewritten into optimal form)
+    /// get size of the finalized data (it may be compressed or rewritten into optimal form). A compressed section whose
+    /// target size was predicted can compress worse than predicted, and be larger than MAX_OCTREE_COMPRESSED_SECTION_SIZE,
+    /// such a section can't be sent and must be encoded again. This resets the prediction to the size that always fits.
     int getFinalizedSize();
 
     /// get pointer to the start of uncompressed stream buffer
@@ -170,9 +191,24 @@ public:
     /// returns whether or not zlib compression enabled on finalization
     bool isCompressed() const { return _enableCompression; }
     
+    /// returns the codec used when compression is enabled
+    OctreePacketCompressionCodec getCompressionCodec() const { return _compressor->getCodec(); }
+
     /// returns the target uncompressed size
     unsigned int getTargetSize() const { return _targetSize; }
 
+    /// Returns an uncompressed target size whose compressed form is expected to fit in compressedBytesAvailable, based
+    /// on the compression ratio of the content this packet data has finalized so far. This lets the sender fill the
+    /// remaining space in a wire packet in one attempt, rather than with a series of shrinking trial compressions.
+    /// The result never exceeds the largest section the codec's decoders accept.
+    unsigned int getPredictedTargetSize(unsigned int compressedBytesAvailable) const;
+
+    /// returns the codec that the sections of a packet with these flags were compressed with
+    static OctreePacketCompressionCodec compressionCodecForFlags(OCTREE_PACKET_FLAGS flags);
+
+    /// the most uncompressed content a section compressed with codec can hold, the target size for decoding them
+    static unsigned int getMaxSectionSize(OctreePacketCompressionCodec codec);
+
     /// displays contents for debugging
     void debugContent();
     
@@ -191,15 +227,18 @@ private:
 
     unsigned int _targetSize;
     bool _enableCompression;
+    OctreePacketCompressor* _compressor;
+    SimpleMovingAverage _compressionRatio; // compressed over uncompressed size, survives reset()
     
-    unsigned char _uncompressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
+    unsigned char _uncompressed[MAX_OCTREE_PREDICTED_SECTION_SIZE];
     int _bytesInUse;
     int _bytesAvailable;
     int _subTreeAt;
 
     bool compressContent();
     
-    unsigned char _compressed[MAX_OCTREE_UNCOMRESSED_PACKET_SIZE];
+    // room for a predicted section that doesn't compress at all, so that its true compressed size is known
+    unsigned char _compressed[MAX_OCTREE_PREDICTED_SECTION_SIZE + MAX_OCTREE_PACKET_DATA_SIZE];
     int _compressedBytes;
     int _bytesInUseLastCheck;
     bool _dirty;
@@ -0,0 +1,278 @@
+//
+//  OctreePacketDictionary.h
+//  libraries/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  The preset dictionary of the fast LZ codec, see OctreePacketCompressor::getDefaultDictionary(). It holds the 8 byte
+//  runs that the most of 256 sample subtree bitstreams shared, with the most common ones last. The samples were a few
+//  levels of colored children under octal codes 4 to 12 levels deep, which share their top levels, like the sections of
+//  a scene. It is not sent on the wire, so any change to it must bump the versions of the octree data packets.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePacketDictionary_h
+#define hifi_OctreePacketDictionary_h
+
+const unsigned char OCTREE_PACKET_DICTIONARY[] = {
+    0x9a, 0x3c, 0xdf, 0xcf, 0x9f, 0x4c, 0x9a, 0x3c, 0x9a, 0x3c, 0xdf, 0xcf, 0x9f, 0x4b, 0x99, 0x3b,
+    0x9a, 0x3c, 0x8c, 0x6c, 0x46, 0x7f, 0x7f, 0x7f, 0x9a, 0x3c, 0x8b, 0x6b, 0x45, 0xdf, 0xcf, 0x9f,
+    0x9a, 0x3c, 0x4c, 0x9a, 0x3c, 0x8c, 0x6c, 0x46, 0x9a, 0x3c, 0x4b, 0x99, 0x3b, 0x2f, 0x5f, 0xbf,
+    0x99, 0x3b, 0xe1, 0xd1, 0xa1, 0x80, 0x80, 0x80, 0x99, 0x3b, 0xe0, 0xd0, 0xa0, 0x30, 0x60, 0xc0,
+    0x99, 0x3b, 0xdf, 0xcf, 0x9f, 0x2f, 0x5f, 0xbf, 0x99, 0x3b, 0x8c, 0x6c, 0x46, 0x31, 0x61, 0xc1,
+    0x99, 0x3b, 0x8c, 0x6c, 0x46, 0x2f, 0x5f, 0xbf, 0x99, 0x3b, 0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81,
+    0x99, 0x3b, 0x8a, 0x6a, 0x44, 0xe1, 0xd1, 0xa1, 0x99, 0x3b, 0x81, 0x81, 0x81, 0xe0, 0xd0, 0xa0,
+    0x99, 0x3b, 0x80, 0x80, 0x80, 0x7f, 0x7f, 0x7f, 0x99, 0x3b, 0x80, 0x80, 0x80, 0x30, 0x60, 0xc0,
+    0x99, 0x3b, 0x7f, 0x7f, 0x7f, 0x2f, 0x5f, 0xbf, 0x99, 0x3b, 0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0x44,
+    0x8c, 0x6c, 0x46, 0x8b, 0x6b, 0x45, 0xe1, 0xd1, 0x8c, 0x6c, 0x46, 0x8b, 0x6b, 0x45, 0xe0, 0xd0,
+    0x8c, 0x6c, 0x46, 0x80, 0x80, 0x80, 0xdf, 0xcf, 0x8c, 0x6c, 0x46, 0x4d, 0x9b, 0x3d, 0xe1, 0xd1,
+    0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x81, 0x81,
+    0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x80, 0x80, 0x8c, 0x6c, 0x46, 0x4b, 0x99, 0x3b, 0x4b, 0x99,
+    0x8c, 0x6c, 0x46, 0x30, 0x60, 0xc0, 0x30, 0x60, 0x8b, 0x6b, 0x45, 0xe0, 0xd0, 0xa0, 0x8c, 0x6c,
+    0x8b, 0x6b, 0x45, 0xdf, 0xcf, 0x9f, 0x00, 0xff, 0x8b, 0x6b, 0x45, 0x8c, 0x6c, 0x46, 0x4d, 0x9b,
+    0x8b, 0x6b, 0x45, 0x8b, 0x6b, 0x45, 0x8a, 0x6a, 0x8b, 0x6b, 0x45, 0x8b, 0x6b, 0x45, 0x31, 0x61,
+    0x8b, 0x6b, 0x45, 0x8b, 0x6b, 0x45, 0x2f, 0x5f, 0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81, 0x8a, 0x6a,
+    0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81, 0x81, 0x81, 0x8b, 0x6b, 0x45, 0x80, 0x80, 0x80, 0x8c, 0x6c,
+    0x8b, 0x6b, 0x45, 0x80, 0x80, 0x80, 0x4c, 0x9a, 0x8b, 0x6b, 0x45, 0x7f, 0x7f, 0x7f, 0x8b, 0x6b,
+    0x8b, 0x6b, 0x45, 0x7f, 0x7f, 0x7f, 0x81, 0x81, 0x8a, 0x6a, 0x44, 0xe1, 0xd1, 0xa1, 0x31, 0x61,
+    0x8a, 0x6a, 0x44, 0xe0, 0xd0, 0xa0, 0xe0, 0xd0, 0x8a, 0x6a, 0x44, 0xe0, 0xd0, 0xa0, 0x4b, 0x99,
+    0x8a, 0x6a, 0x44, 0x8b, 0x6b, 0x45, 0x2f, 0x5f, 0x8a, 0x6a, 0x44, 0x80, 0x80, 0x80, 0xdf, 0xcf,
+    0x8a, 0x6a, 0x44, 0x80, 0x80, 0x80, 0x8b, 0x6b, 0x8a, 0x6a, 0x44, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c,
+    0x8a, 0x6a, 0x44, 0x4d, 0x9b, 0x3d, 0x8a, 0x6a, 0x8a, 0x6a, 0x44, 0x4c, 0x9a, 0x3c, 0xdf, 0xcf,
+    0x8a, 0x6a, 0x44, 0x31, 0x61, 0xc1, 0x4d, 0x9b, 0x8a, 0x6a, 0x44, 0x2f, 0x5f, 0xbf, 0xe1, 0xd1,
+    0x81, 0x81, 0xe1, 0xd1, 0xa1, 0x7f, 0x7f, 0x7f, 0x81, 0x81, 0xdf, 0xcf, 0x9f, 0x8c, 0x6c, 0x46,
+    0x81, 0x81, 0x8a, 0x6a, 0x44, 0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81, 0xe1, 0xd1, 0xa1, 0x7f, 0x7f,
+    0x81, 0x81, 0x81, 0xdf, 0xcf, 0x9f, 0x8c, 0x6c, 0x81, 0x81, 0x81, 0x8a, 0x6a, 0x44, 0x8b, 0x6b,
+    0x81, 0x81, 0x81, 0x80, 0x80, 0x80, 0x4d, 0x9b, 0x81, 0x81, 0x81, 0x4d, 0x9b, 0x3d, 0x4b, 0x99,
+    0x81, 0x81, 0x81, 0x4d, 0x9b, 0x3d, 0x2f, 0x5f, 0x81, 0x81, 0x81, 0x31, 0x61, 0xc1, 0x4d, 0x9b,
+    0x81, 0x81, 0x81, 0x30, 0x60, 0xc0, 0x31, 0x61, 0x81, 0x81, 0x81, 0x00, 0xff, 0x4b, 0x99, 0x3b,
+    0x81, 0x81, 0x80, 0x80, 0x80, 0x4d, 0x9b, 0x3d, 0x81, 0x81, 0x4d, 0x9b, 0x3d, 0x4b, 0x99, 0x3b,
+    0x81, 0x81, 0x4d, 0x9b, 0x3d, 0x2f, 0x5f, 0xbf, 0x81, 0x81, 0x30, 0x60, 0xc0, 0x31, 0x61, 0xc1,
+    0x80, 0x80, 0xe1, 0xd1, 0xa1, 0x31, 0x61, 0xc1, 0x80, 0x80, 0x8c, 0x6c, 0x46, 0x8b, 0x6b, 0x45,
+    0x80, 0x80, 0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81, 0x80, 0x80, 0x8a, 0x6a, 0x44, 0xe1, 0xd1, 0xa1,
+    0x80, 0x80, 0x81, 0x81, 0x81, 0xdf, 0xcf, 0x9f, 0x80, 0x80, 0x80, 0xe1, 0xd1, 0xa1, 0x31, 0x61,
+    0x80, 0x80, 0x80, 0x8c, 0x6c, 0x46, 0x8b, 0x6b, 0x80, 0x80, 0x80, 0x8b, 0x6b, 0x45, 0x81, 0x81,
+    0x80, 0x80, 0x80, 0x8a, 0x6a, 0x44, 0xe1, 0xd1, 0x80, 0x80, 0x80, 0x81, 0x81, 0x81, 0xdf, 0xcf,
+    0x80, 0x80, 0x80, 0x7f, 0x7f, 0x7f, 0x2f, 0x5f, 0x80, 0x80, 0x80, 0x4c, 0x9a, 0x3c, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0x80, 0x80, 0x80, 0x31, 0x61, 0xc1, 0x81, 0x81,
+    0x80, 0x80, 0x7f, 0x7f, 0x7f, 0x2f, 0x5f, 0xbf, 0x80, 0x80, 0x4d, 0x9b, 0x3d, 0x8c, 0x6c, 0x46,
+    0x80, 0x80, 0x4c, 0x9a, 0x3c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0x44,
+    0x80, 0x80, 0x31, 0x61, 0xc1, 0x81, 0x81, 0x81, 0x7f, 0x7f, 0xe0, 0xd0, 0xa0, 0x8b, 0x6b, 0x45,
+    0x7f, 0x7f, 0xe0, 0xd0, 0xa0, 0x4d, 0x9b, 0x3d, 0x7f, 0x7f, 0x8c, 0x6c, 0x46, 0x8c, 0x6c, 0x46,
+    0x7f, 0x7f, 0x8c, 0x6c, 0x46, 0x31, 0x61, 0xc1, 0x7f, 0x7f, 0x8b, 0x6b, 0x45, 0x8b, 0x6b, 0x45,
+    0x7f, 0x7f, 0x8b, 0x6b, 0x45, 0x4d, 0x9b, 0x3d, 0x7f, 0x7f, 0x8b, 0x6b, 0x45, 0x30, 0x60, 0xc0,
+    0x7f, 0x7f, 0x7f, 0xe0, 0xd0, 0xa0, 0x8b, 0x6b, 0x7f, 0x7f, 0x7f, 0xe0, 0xd0, 0xa0, 0x4d, 0x9b,
+    0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x46, 0x8c, 0x6c, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x46, 0x31, 0x61,
+    0x7f, 0x7f, 0x7f, 0x8b, 0x6b, 0x45, 0x8b, 0x6b, 0x7f, 0x7f, 0x7f, 0x8b, 0x6b, 0x45, 0x4d, 0x9b,
+    0x7f, 0x7f, 0x7f, 0x8b, 0x6b, 0x45, 0x30, 0x60, 0x7f, 0x7f, 0x7f, 0x4d, 0x9b, 0x3d, 0x7f, 0x7f,
+    0x7f, 0x7f, 0x7f, 0x30, 0x60, 0xc0, 0x8a, 0x6a, 0x7f, 0x7f, 0x7f, 0x2f, 0x5f, 0xbf, 0x81, 0x81,
+    0x7f, 0x7f, 0x4d, 0x9b, 0x3d, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x30, 0x60, 0xc0, 0x8a, 0x6a, 0x44,
+    0x7f, 0x7f, 0x2f, 0x5f, 0xbf, 0x81, 0x81, 0x81, 0x6c, 0x46, 0x8b, 0x6b, 0x45, 0xe1, 0xd1, 0xa1,
+    0x6c, 0x46, 0x8b, 0x6b, 0x45, 0xe0, 0xd0, 0xa0, 0x6c, 0x46, 0x80, 0x80, 0x80, 0xdf, 0xcf, 0x9f,
+    0x6c, 0x46, 0x4d, 0x9b, 0x3d, 0xe1, 0xd1, 0xa1, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0xa1,
+    0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x81, 0x81, 0x81, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x80, 0x80, 0x80,
+    0x6c, 0x46, 0x4b, 0x99, 0x3b, 0x4b, 0x99, 0x3b, 0x6c, 0x46, 0x30, 0x60, 0xc0, 0x30, 0x60, 0xc0,
+    0x6b, 0x45, 0xe0, 0xd0, 0xa0, 0x8c, 0x6c, 0x46, 0x6b, 0x45, 0x8c, 0x6c, 0x46, 0x4d, 0x9b, 0x3d,
+    0x6b, 0x45, 0x8b, 0x6b, 0x45, 0x8a, 0x6a, 0x44, 0x6b, 0x45, 0x8b, 0x6b, 0x45, 0x31, 0x61, 0xc1,
+    0x6b, 0x45, 0x8b, 0x6b, 0x45, 0x2f, 0x5f, 0xbf, 0x6b, 0x45, 0x81, 0x81, 0x81, 0x8a, 0x6a, 0x44,
+    0x6b, 0x45, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x6b, 0x45, 0x80, 0x80, 0x80, 0x8c, 0x6c, 0x46,
+    0x6b, 0x45, 0x80, 0x80, 0x80, 0x4c, 0x9a, 0x3c, 0x6b, 0x45, 0x7f, 0x7f, 0x7f, 0x8b, 0x6b, 0x45,
+    0x6b, 0x45, 0x7f, 0x7f, 0x7f, 0x81, 0x81, 0x81, 0x6a, 0x44, 0xe1, 0xd1, 0xa1, 0x31, 0x61, 0xc1,
+    0x6a, 0x44, 0xe0, 0xd0, 0xa0, 0xe0, 0xd0, 0xa0, 0x6a, 0x44, 0xe0, 0xd0, 0xa0, 0x4b, 0x99, 0x3b,
+    0x6a, 0x44, 0x8b, 0x6b, 0x45, 0x2f, 0x5f, 0xbf, 0x6a, 0x44, 0x80, 0x80, 0x80, 0xdf, 0xcf, 0x9f,
+    0x6a, 0x44, 0x80, 0x80, 0x80, 0x8b, 0x6b, 0x45, 0x6a, 0x44, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x46,
+    0x6a, 0x44, 0x4d, 0x9b, 0x3d, 0x8a, 0x6a, 0x44, 0x6a, 0x44, 0x4c, 0x9a, 0x3c, 0xdf, 0xcf, 0x9f,
+    0x6a, 0x44, 0x31, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x6a, 0x44, 0x2f, 0x5f, 0xbf, 0xe1, 0xd1, 0xa1,
+    0x61, 0xc1, 0xe1, 0xd1, 0xa1, 0x4b, 0x99, 0x3b, 0x61, 0xc1, 0xe1, 0xd1, 0xa1, 0x2f, 0x5f, 0xbf,
+    0x61, 0xc1, 0xdf, 0xcf, 0x9f, 0x80, 0x80, 0x80, 0x61, 0xc1, 0x81, 0x81, 0x81, 0x4b, 0x99, 0x3b,
+    0x61, 0xc1, 0x80, 0x80, 0x80, 0xe0, 0xd0, 0xa0, 0x61, 0xc1, 0x80, 0x80, 0x80, 0x7f, 0x7f, 0x7f,
+    0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x80, 0x80, 0x80, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x31, 0x61, 0xc1,
+    0x61, 0xc1, 0x4c, 0x9a, 0x3c, 0x81, 0x81, 0x81, 0x61, 0xc1, 0x4b, 0x99, 0x3b, 0xdf, 0xcf, 0x9f,
+    0x61, 0xc1, 0x30, 0x60, 0xc0, 0xe0, 0xd0, 0xa0, 0x60, 0xc0, 0x81, 0x81, 0x81, 0x8c, 0x6c, 0x46,
+    0x60, 0xc0, 0x81, 0x81, 0x81, 0x7f, 0x7f, 0x7f, 0x60, 0xc0, 0x80, 0x80, 0x80, 0xdf, 0xcf, 0x9f,
+    0x60, 0xc0, 0x7f, 0x7f, 0x7f, 0x80, 0x80, 0x80, 0x60, 0xc0, 0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d,
+    0x60, 0xc0, 0x4d, 0x9b, 0x3d, 0x31, 0x61, 0xc1, 0x60, 0xc0, 0x4c, 0x9a, 0x3c, 0x2f, 0x5f, 0xbf,
+    0x60, 0xc0, 0x31, 0x61, 0xc1, 0x81, 0x81, 0x81, 0x60, 0xc0, 0x31, 0x61, 0xc1, 0x31, 0x61, 0xc1,
+    0x60, 0xc0, 0x30, 0x60, 0xc0, 0x31, 0x61, 0xc1, 0x5f, 0xbf, 0xe1, 0xd1, 0xa1, 0xe1, 0xd1, 0xa1,
+    0x5f, 0xbf, 0xe1, 0xd1, 0xa1, 0x80, 0x80, 0x80, 0x5f, 0xbf, 0xe0, 0xd0, 0xa0, 0xdf, 0xcf, 0x9f,
+    0x5f, 0xbf, 0xe0, 0xd0, 0xa0, 0x8b, 0x6b, 0x45, 0x5f, 0xbf, 0x8a, 0x6a, 0x44, 0xe0, 0xd0, 0xa0,
+    0x5f, 0xbf, 0x80, 0x80, 0x80, 0x7f, 0x7f, 0x7f, 0x5f, 0xbf, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x46,
+    0x4d, 0x9b, 0x3d, 0xe1, 0xd1, 0xa1, 0x4c, 0x9a, 0x4d, 0x9b, 0x3d, 0xe0, 0xd0, 0xa0, 0xe0, 0xd0,
+    0x4d, 0x9b, 0x3d, 0xe0, 0xd0, 0xa0, 0x8c, 0x6c, 0x4d, 0x9b, 0x3d, 0xe0, 0xd0, 0xa0, 0x7f, 0x7f,
+    0x4d, 0x9b, 0x3d, 0x8b, 0x6b, 0x45, 0x8c, 0x6c, 0x4d, 0x9b, 0x3d, 0x8a, 0x6a, 0x44, 0xe1, 0xd1,
+    0x4d, 0x9b, 0x3d, 0x80, 0x80, 0x80, 0x4c, 0x9a, 0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d, 0x8b, 0x6b,
+    0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d, 0x80, 0x80, 0x4d, 0x9b, 0x3d, 0x4b, 0x99, 0x3b, 0x80, 0x80,
+    0x4d, 0x9b, 0x3d, 0x4b, 0x99, 0x3b, 0x4b, 0x99, 0x4d, 0x9b, 0x3d, 0x31, 0x61, 0xc1, 0x8a, 0x6a,
+    0x4d, 0x9b, 0x3d, 0x2f, 0x5f, 0xbf, 0xe0, 0xd0, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0xa1, 0xff, 0x00,
+    0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0xa1, 0x8a, 0x6a, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0xa1, 0x4b, 0x99,
+    0x4c, 0x9a, 0x3c, 0xdf, 0xcf, 0x9f, 0x4c, 0x9a, 0x4c, 0x9a, 0x3c, 0xdf, 0xcf, 0x9f, 0x4b, 0x99,
+    0x4c, 0x9a, 0x3c, 0x8c, 0x6c, 0x46, 0x7f, 0x7f, 0x4c, 0x9a, 0x3c, 0x8b, 0x6b, 0x45, 0xdf, 0xcf,
+    0x4c, 0x9a, 0x3c, 0x4c, 0x9a, 0x3c, 0x8c, 0x6c, 0x4c, 0x9a, 0x3c, 0x4b, 0x99, 0x3b, 0x2f, 0x5f,
+    0x4b, 0x99, 0x3b, 0xe1, 0xd1, 0xa1, 0x80, 0x80, 0x4b, 0x99, 0x3b, 0xe0, 0xd0, 0xa0, 0x30, 0x60,
+    0x4b, 0x99, 0x3b, 0xdf, 0xcf, 0x9f, 0x2f, 0x5f, 0x4b, 0x99, 0x3b, 0x8c, 0x6c, 0x46, 0x31, 0x61,
+    0x4b, 0x99, 0x3b, 0x8c, 0x6c, 0x46, 0x2f, 0x5f, 0x4b, 0x99, 0x3b, 0x8b, 0x6b, 0x45, 0x81, 0x81,
+    0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0x44, 0xe1, 0xd1, 0x4b, 0x99, 0x3b, 0x81, 0x81, 0x81, 0xe0, 0xd0,
+    0x4b, 0x99, 0x3b, 0x80, 0x80, 0x80, 0x7f, 0x7f, 0x4b, 0x99, 0x3b, 0x80, 0x80, 0x80, 0x30, 0x60,
+    0x4b, 0x99, 0x3b, 0x7f, 0x7f, 0x7f, 0x2f, 0x5f, 0x4b, 0x99, 0x3b, 0x4b, 0x99, 0x3b, 0x8a, 0x6a,
+    0x31, 0x61, 0xc1, 0xe1, 0xd1, 0xa1, 0x4b, 0x99, 0x31, 0x61, 0xc1, 0xe1, 0xd1, 0xa1, 0x2f, 0x5f,
+    0x31, 0x61, 0xc1, 0xdf, 0xcf, 0x9f, 0x80, 0x80, 0x31, 0x61, 0xc1, 0x8a, 0x6a, 0x44, 0xff, 0x00,
+    0x31, 0x61, 0xc1, 0x81, 0x81, 0x81, 0x4b, 0x99, 0x31, 0x61, 0xc1, 0x80, 0x80, 0x80, 0xe0, 0xd0,
+    0x31, 0x61, 0xc1, 0x80, 0x80, 0x80, 0x7f, 0x7f, 0x31, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x80, 0x80,
+    0x31, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x31, 0x61, 0x31, 0x61, 0xc1, 0x4c, 0x9a, 0x3c, 0x81, 0x81,
+    0x31, 0x61, 0xc1, 0x4b, 0x99, 0x3b, 0xdf, 0xcf, 0x31, 0x61, 0xc1, 0x30, 0x60, 0xc0, 0xe0, 0xd0,
+    0x30, 0x60, 0xc0, 0x81, 0x81, 0x81, 0x8c, 0x6c, 0x30, 0x60, 0xc0, 0x81, 0x81, 0x81, 0x7f, 0x7f,
+    0x30, 0x60, 0xc0, 0x80, 0x80, 0x80, 0xdf, 0xcf, 0x30, 0x60, 0xc0, 0x7f, 0x7f, 0x7f, 0x80, 0x80,
+    0x30, 0x60, 0xc0, 0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x30, 0x60, 0xc0, 0x4d, 0x9b, 0x3d, 0x31, 0x61,
+    0x30, 0x60, 0xc0, 0x4c, 0x9a, 0x3c, 0x2f, 0x5f, 0x30, 0x60, 0xc0, 0x31, 0x61, 0xc1, 0x81, 0x81,
+    0x30, 0x60, 0xc0, 0x31, 0x61, 0xc1, 0x31, 0x61, 0x30, 0x60, 0xc0, 0x30, 0x60, 0xc0, 0x31, 0x61,
+    0x2f, 0x5f, 0xbf, 0xe1, 0xd1, 0xa1, 0xe1, 0xd1, 0x2f, 0x5f, 0xbf, 0xe1, 0xd1, 0xa1, 0x80, 0x80,
+    0x2f, 0x5f, 0xbf, 0xe0, 0xd0, 0xa0, 0xdf, 0xcf, 0x2f, 0x5f, 0xbf, 0xe0, 0xd0, 0xa0, 0x8b, 0x6b,
+    0x2f, 0x5f, 0xbf, 0x8a, 0x6a, 0x44, 0xe0, 0xd0, 0x2f, 0x5f, 0xbf, 0x80, 0x80, 0x80, 0x7f, 0x7f,
+    0x2f, 0x5f, 0xbf, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x00, 0xff, 0xe1, 0xd1, 0xa1, 0x80, 0x80, 0x80,
+    0x00, 0xff, 0xe1, 0xd1, 0xa1, 0x4c, 0x9a, 0x3c, 0x00, 0xff, 0xe0, 0xd0, 0xa0, 0x4c, 0x9a, 0x3c,
+    0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x8c, 0x6c, 0x46, 0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x8a, 0x6a, 0x44,
+    0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x80, 0x80, 0x80, 0x00, 0xff, 0x8c, 0x6c, 0x46, 0x4b, 0x99, 0x3b,
+    0x00, 0xff, 0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81, 0x00, 0xff, 0x8b, 0x6b, 0x45, 0x80, 0x80, 0x80,
+    0x00, 0xff, 0x8b, 0x6b, 0x45, 0x4b, 0x99, 0x3b, 0x00, 0xff, 0x8a, 0x6a, 0x44, 0x80, 0x80, 0x80,
+    0x00, 0xff, 0x8a, 0x6a, 0x44, 0x4d, 0x9b, 0x3d, 0x00, 0xff, 0x81, 0x81, 0x81, 0x8a, 0x6a, 0x44,
+    0x00, 0xff, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x00, 0xff, 0x80, 0x80, 0x80, 0x7f, 0x7f, 0x7f,
+    0x00, 0xff, 0x80, 0x80, 0x80, 0x4d, 0x9b, 0x3d, 0x00, 0xff, 0x7f, 0x7f, 0x7f, 0xe0, 0xd0, 0xa0,
+    0x00, 0xff, 0x7f, 0x7f, 0x7f, 0x4d, 0x9b, 0x3d, 0x00, 0xff, 0x7f, 0x7f, 0x7f, 0x4b, 0x99, 0x3b,
+    0x00, 0xff, 0x7f, 0x7f, 0x7f, 0x2f, 0x5f, 0xbf, 0x00, 0xff, 0x4d, 0x9b, 0x3d, 0x8b, 0x6b, 0x45,
+    0x00, 0xff, 0x4c, 0x9a, 0x3c, 0x8a, 0x6a, 0x44, 0x00, 0xff, 0x4c, 0x9a, 0x3c, 0x4c, 0x9a, 0x3c,
+    0x00, 0xff, 0x4c, 0x9a, 0x3c, 0x30, 0x60, 0xc0, 0x00, 0xff, 0x4b, 0x99, 0x3b, 0xe0, 0xd0, 0xa0,
+    0x00, 0xff, 0x4b, 0x99, 0x3b, 0x31, 0x61, 0xc1, 0x00, 0xff, 0x31, 0x61, 0xc1, 0x80, 0x80, 0x80,
+    0x00, 0xff, 0x31, 0x61, 0xc1, 0x4c, 0x9a, 0x3c, 0x00, 0xff, 0x31, 0x61, 0xc1, 0x31, 0x61, 0xc1,
+    0xe1, 0xd1, 0xa1, 0xe0, 0xd0, 0xa0, 0x8c, 0x6c, 0xe1, 0xd1, 0xa1, 0x8c, 0x6c, 0x46, 0x4c, 0x9a,
+    0xe1, 0xd1, 0xa1, 0x8a, 0x6a, 0x44, 0x4d, 0x9b, 0xe1, 0xd1, 0xa1, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c,
+    0xe1, 0xd1, 0xa1, 0x4b, 0x99, 0x3b, 0x8c, 0x6c, 0xe0, 0xd0, 0xa0, 0xe0, 0xd0, 0xa0, 0xe1, 0xd1,
+    0xe0, 0xd0, 0xa0, 0x80, 0x80, 0x80, 0x4b, 0x99, 0xe0, 0xd0, 0xa0, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1,
+    0xe0, 0xd0, 0xa0, 0x4c, 0x9a, 0x3c, 0x8a, 0x6a, 0xe0, 0xd0, 0xa0, 0x30, 0x60, 0xc0, 0x4b, 0x99,
+    0xdf, 0xcf, 0x9f, 0x8b, 0x6b, 0x45, 0x81, 0x81, 0xdf, 0xcf, 0x9f, 0x8a, 0x6a, 0x44, 0x7f, 0x7f,
+    0xdf, 0xcf, 0x9f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0xdf, 0xcf, 0x9f, 0x7f, 0x7f, 0x7f, 0x31, 0x61,
+    0xdf, 0xcf, 0x9f, 0x4c, 0x9a, 0x3c, 0x8b, 0x6b, 0xdf, 0xcf, 0x9f, 0x2f, 0x5f, 0xbf, 0x8a, 0x6a,
+    0xd1, 0xa1, 0xe0, 0xd0, 0xa0, 0x8c, 0x6c, 0x46, 0xd1, 0xa1, 0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c,
+    0xd1, 0xa1, 0x8a, 0x6a, 0x44, 0x4d, 0x9b, 0x3d, 0xd1, 0xa1, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x46,
+    0xd1, 0xa1, 0x4b, 0x99, 0x3b, 0x8c, 0x6c, 0x46, 0xd0, 0xa0, 0xe0, 0xd0, 0xa0, 0xe1, 0xd1, 0xa1,
+    0xd0, 0xa0, 0x80, 0x80, 0x80, 0x4b, 0x99, 0x3b, 0xd0, 0xa0, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0xa1,
+    0xd0, 0xa0, 0x4c, 0x9a, 0x3c, 0x8a, 0x6a, 0x44, 0xd0, 0xa0, 0x30, 0x60, 0xc0, 0x4b, 0x99, 0x3b,
+    0xcf, 0x9f, 0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81, 0xcf, 0x9f, 0x8a, 0x6a, 0x44, 0x7f, 0x7f, 0x7f,
+    0xcf, 0x9f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0xcf, 0x9f, 0x7f, 0x7f, 0x7f, 0x31, 0x61, 0xc1,
+    0xcf, 0x9f, 0x4c, 0x9a, 0x3c, 0x8b, 0x6b, 0x45, 0xcf, 0x9f, 0x2f, 0x5f, 0xbf, 0x8a, 0x6a, 0x44,
+    0x9b, 0x3d, 0xdf, 0xcf, 0x9f, 0x8a, 0x6a, 0x44, 0x9b, 0x3d, 0x8c, 0x6c, 0x46, 0x30, 0x60, 0xc0,
+    0x9b, 0x3d, 0x4b, 0x99, 0x3b, 0xe1, 0xd1, 0xa1, 0x9a, 0x3c, 0xe0, 0xd0, 0xa0, 0x4b, 0x99, 0x3b,
+    0x9a, 0x3c, 0x8b, 0x6b, 0x45, 0xe1, 0xd1, 0xa1, 0x9a, 0x3c, 0x8b, 0x6b, 0x45, 0x4b, 0x99, 0x3b,
+    0x9a, 0x3c, 0x8a, 0x6a, 0x44, 0x4c, 0x9a, 0x3c, 0x9a, 0x3c, 0x4d, 0x9b, 0x3d, 0xe0, 0xd0, 0xa0,
+    0x99, 0x3b, 0xe0, 0xd0, 0xa0, 0xdf, 0xcf, 0x9f, 0x99, 0x3b, 0xe0, 0xd0, 0xa0, 0x7f, 0x7f, 0x7f,
+    0x99, 0x3b, 0x8a, 0x6a, 0x44, 0x80, 0x80, 0x80, 0x99, 0x3b, 0x4b, 0x99, 0x3b, 0x8b, 0x6b, 0x45,
+    0x99, 0x3b, 0x2f, 0x5f, 0xbf, 0x80, 0x80, 0x80, 0x8c, 0x6c, 0x46, 0xe0, 0xd0, 0xa0, 0x2f, 0x5f,
+    0x8c, 0x6c, 0x46, 0xdf, 0xcf, 0x9f, 0x8b, 0x6b, 0x8c, 0x6c, 0x46, 0x81, 0x81, 0x81, 0x4b, 0x99,
+    0x8c, 0x6c, 0x46, 0x80, 0x80, 0x80, 0x81, 0x81, 0x8c, 0x6c, 0x46, 0x7f, 0x7f, 0x7f, 0x80, 0x80,
+    0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0xe0, 0xd0, 0x8b, 0x6b, 0x45, 0xdf, 0xcf, 0x9f, 0x8c, 0x6c,
+    0x8b, 0x6b, 0x45, 0x8c, 0x6c, 0x46, 0x8b, 0x6b, 0x8b, 0x6b, 0x45, 0x8a, 0x6a, 0x44, 0x8b, 0x6b,
+    0x8b, 0x6b, 0x45, 0x81, 0x81, 0x81, 0x4d, 0x9b, 0x8a, 0x6a, 0x44, 0x8b, 0x6b, 0x45, 0x7f, 0x7f,
+    0x8a, 0x6a, 0x44, 0x80, 0x80, 0x80, 0xe1, 0xd1, 0x8a, 0x6a, 0x44, 0x7f, 0x7f, 0x7f, 0xe1, 0xd1,
+    0x81, 0x81, 0xe0, 0xd0, 0xa0, 0xe0, 0xd0, 0xa0, 0x81, 0x81, 0x81, 0xe0, 0xd0, 0xa0, 0xe0, 0xd0,
+    0x81, 0x81, 0x81, 0x7f, 0x7f, 0x7f, 0x8b, 0x6b, 0x81, 0x81, 0x7f, 0x7f, 0x7f, 0x8b, 0x6b, 0x45,
+    0x80, 0x80, 0x80, 0x7f, 0x7f, 0x7f, 0x4d, 0x9b, 0x80, 0x80, 0x7f, 0x7f, 0x7f, 0x4d, 0x9b, 0x3d,
+    0x7f, 0x7f, 0x80, 0x80, 0x80, 0x4d, 0x9b, 0x3d, 0x7f, 0x7f, 0x7f, 0x80, 0x80, 0x80, 0x4d, 0x9b,
+    0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0xff, 0x00, 0x7f, 0x7f, 0x7f, 0x4d, 0x9b, 0x3d, 0xff, 0x00,
+    0x7f, 0x7f, 0x7f, 0x4c, 0x9a, 0x3c, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x31, 0x61, 0xc1, 0x81, 0x81,
+    0x7f, 0x7f, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0xa1, 0x7f, 0x7f, 0x4c, 0x9a, 0x3c, 0x7f, 0x7f, 0x7f,
+    0x6c, 0x46, 0xe0, 0xd0, 0xa0, 0x2f, 0x5f, 0xbf, 0x6c, 0x46, 0xdf, 0xcf, 0x9f, 0x8b, 0x6b, 0x45,
+    0x6c, 0x46, 0x81, 0x81, 0x81, 0x4b, 0x99, 0x3b, 0x6c, 0x46, 0x80, 0x80, 0x80, 0x81, 0x81, 0x81,
+    0x6c, 0x46, 0x7f, 0x7f, 0x7f, 0x80, 0x80, 0x80, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0xe0, 0xd0, 0xa0,
+    0x6b, 0x45, 0xdf, 0xcf, 0x9f, 0x8c, 0x6c, 0x46, 0x6b, 0x45, 0x8c, 0x6c, 0x46, 0x8b, 0x6b, 0x45,
+    0x6b, 0x45, 0x8a, 0x6a, 0x44, 0x8b, 0x6b, 0x45, 0x6b, 0x45, 0x81, 0x81, 0x81, 0x4d, 0x9b, 0x3d,
+    0x6a, 0x44, 0x8b, 0x6b, 0x45, 0x7f, 0x7f, 0x7f, 0x6a, 0x44, 0x80, 0x80, 0x80, 0xe1, 0xd1, 0xa1,
+    0x6a, 0x44, 0x7f, 0x7f, 0x7f, 0xe1, 0xd1, 0xa1, 0x61, 0xc1, 0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c,
+    0x61, 0xc1, 0x81, 0x81, 0x81, 0x30, 0x60, 0xc0, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x7f, 0x7f, 0x7f,
+    0x61, 0xc1, 0x31, 0x61, 0xc1, 0xdf, 0xcf, 0x9f, 0x60, 0xc0, 0xdf, 0xcf, 0x9f, 0x80, 0x80, 0x80,
+    0x60, 0xc0, 0x8b, 0x6b, 0x45, 0x80, 0x80, 0x80, 0x5f, 0xbf, 0xe0, 0xd0, 0xa0, 0x2f, 0x5f, 0xbf,
+    0x5f, 0xbf, 0x8c, 0x6c, 0x46, 0x30, 0x60, 0xc0, 0x5f, 0xbf, 0x8b, 0x6b, 0x45, 0x2f, 0x5f, 0xbf,
+    0x5f, 0xbf, 0x7f, 0x7f, 0x7f, 0x81, 0x81, 0x81, 0x5f, 0xbf, 0x4d, 0x9b, 0x3d, 0x4b, 0x99, 0x3b,
+    0x5f, 0xbf, 0x30, 0x60, 0xc0, 0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d, 0xdf, 0xcf, 0x9f, 0x8a, 0x6a,
+    0x4d, 0x9b, 0x3d, 0x8c, 0x6c, 0x46, 0x30, 0x60, 0x4d, 0x9b, 0x3d, 0x4b, 0x99, 0x3b, 0xe1, 0xd1,
+    0x4c, 0x9a, 0x3c, 0xe0, 0xd0, 0xa0, 0x4b, 0x99, 0x4c, 0x9a, 0x3c, 0x8b, 0x6b, 0x45, 0xe1, 0xd1,
+    0x4c, 0x9a, 0x3c, 0x8b, 0x6b, 0x45, 0x4b, 0x99, 0x4c, 0x9a, 0x3c, 0x8a, 0x6a, 0x44, 0x4c, 0x9a,
+    0x4c, 0x9a, 0x3c, 0x4d, 0x9b, 0x3d, 0xe0, 0xd0, 0x4b, 0x99, 0x3b, 0xe0, 0xd0, 0xa0, 0xdf, 0xcf,
+    0x4b, 0x99, 0x3b, 0xe0, 0xd0, 0xa0, 0x7f, 0x7f, 0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0x44, 0x80, 0x80,
+    0x4b, 0x99, 0x3b, 0x4b, 0x99, 0x3b, 0x8b, 0x6b, 0x4b, 0x99, 0x3b, 0x2f, 0x5f, 0xbf, 0x80, 0x80,
+    0x31, 0x61, 0xc1, 0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x31, 0x61, 0xc1, 0x81, 0x81, 0x81, 0x30, 0x60,
+    0x31, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x7f, 0x7f, 0x31, 0x61, 0xc1, 0x31, 0x61, 0xc1, 0xdf, 0xcf,
+    0x30, 0x60, 0xc0, 0xdf, 0xcf, 0x9f, 0x80, 0x80, 0x30, 0x60, 0xc0, 0x8b, 0x6b, 0x45, 0x80, 0x80,
+    0x2f, 0x5f, 0xbf, 0xe0, 0xd0, 0xa0, 0x2f, 0x5f, 0x2f, 0x5f, 0xbf, 0xdf, 0xcf, 0x9f, 0xff, 0x00,
+    0x2f, 0x5f, 0xbf, 0x8c, 0x6c, 0x46, 0x30, 0x60, 0x2f, 0x5f, 0xbf, 0x8b, 0x6b, 0x45, 0x2f, 0x5f,
+    0x2f, 0x5f, 0xbf, 0x7f, 0x7f, 0x7f, 0x81, 0x81, 0x2f, 0x5f, 0xbf, 0x4d, 0x9b, 0x3d, 0x4b, 0x99,
+    0x2f, 0x5f, 0xbf, 0x30, 0x60, 0xc0, 0x4d, 0x9b, 0x00, 0xff, 0xe1, 0xd1, 0xa1, 0x8b, 0x6b, 0x45,
+    0x00, 0xff, 0xe0, 0xd0, 0xa0, 0xdf, 0xcf, 0x9f, 0x00, 0xff, 0xe0, 0xd0, 0xa0, 0x30, 0x60, 0xc0,
+    0x00, 0xff, 0xdf, 0xcf, 0x9f, 0xdf, 0xcf, 0x9f, 0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x7f, 0x7f, 0x7f,
+    0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x4b, 0x99, 0x3b, 0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x30, 0x60, 0xc0,
+    0x00, 0xff, 0x8c, 0x6c, 0x46, 0x8b, 0x6b, 0x45, 0x00, 0xff, 0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c,
+    0x00, 0xff, 0x81, 0x81, 0x81, 0xe1, 0xd1, 0xa1, 0x00, 0xff, 0x81, 0x81, 0x81, 0xdf, 0xcf, 0x9f,
+    0x00, 0xff, 0x81, 0x81, 0x81, 0x80, 0x80, 0x80, 0x00, 0xff, 0x81, 0x81, 0x81, 0x30, 0x60, 0xc0,
+    0x00, 0xff, 0x80, 0x80, 0x80, 0x4c, 0x9a, 0x3c, 0x00, 0xff, 0x7f, 0x7f, 0x7f, 0xdf, 0xcf, 0x9f,
+    0x00, 0xff, 0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x46, 0x00, 0xff, 0x7f, 0x7f, 0x7f, 0x8b, 0x6b, 0x45,
+    0x00, 0xff, 0x4d, 0x9b, 0x3d, 0x80, 0x80, 0x80, 0x00, 0xff, 0x4b, 0x99, 0x3b, 0x80, 0x80, 0x80,
+    0x00, 0xff, 0x31, 0x61, 0xc1, 0xdf, 0xcf, 0x9f, 0x00, 0xff, 0x31, 0x61, 0xc1, 0x7f, 0x7f, 0x7f,
+    0x00, 0xff, 0x31, 0x61, 0xc1, 0x2f, 0x5f, 0xbf, 0x00, 0xff, 0x30, 0x60, 0xc0, 0xe0, 0xd0, 0xa0,
+    0x00, 0xff, 0x30, 0x60, 0xc0, 0x2f, 0x5f, 0xbf, 0x00, 0xff, 0x2f, 0x5f, 0xbf, 0xe0, 0xd0, 0xa0,
+    0xe1, 0xd1, 0xa1, 0x8a, 0x6a, 0x44, 0x8c, 0x6c, 0xe0, 0xd0, 0xa0, 0x8c, 0x6c, 0x46, 0x4d, 0x9b,
+    0xe0, 0xd0, 0xa0, 0x80, 0x80, 0x80, 0x8c, 0x6c, 0xdf, 0xcf, 0x9f, 0x4d, 0x9b, 0x3d, 0x8a, 0x6a,
+    0xdf, 0xcf, 0x9f, 0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0xd1, 0xa1, 0x8a, 0x6a, 0x44, 0x8c, 0x6c, 0x46,
+    0xd0, 0xa0, 0x8c, 0x6c, 0x46, 0x4d, 0x9b, 0x3d, 0xd0, 0xa0, 0x80, 0x80, 0x80, 0x8c, 0x6c, 0x46,
+    0xcf, 0x9f, 0x4d, 0x9b, 0x3d, 0x8a, 0x6a, 0x44, 0xcf, 0x9f, 0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0x44,
+    0x9a, 0x3c, 0xe0, 0xd0, 0xa0, 0x4c, 0x9a, 0x3c, 0x99, 0x3b, 0x8a, 0x6a, 0x44, 0xdf, 0xcf, 0x9f,
+    0x8c, 0x6c, 0x46, 0xe1, 0xd1, 0xa1, 0x8c, 0x6c, 0x8c, 0x6c, 0x46, 0xdf, 0xcf, 0x9f, 0x7f, 0x7f,
+    0x8c, 0x6c, 0x46, 0x80, 0x80, 0x80, 0x8b, 0x6b, 0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x8b, 0x6b,
+    0x8c, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x31, 0x61, 0x8a, 0x6a, 0x44, 0xe1, 0xd1, 0xa1, 0x4d, 0x9b,
+    0x81, 0x81, 0x8a, 0x6a, 0x44, 0x2f, 0x5f, 0xbf, 0x81, 0x81, 0x81, 0x8a, 0x6a, 0x44, 0x2f, 0x5f,
+    0x80, 0x80, 0x8c, 0x6c, 0x46, 0x4b, 0x99, 0x3b, 0x80, 0x80, 0x8b, 0x6b, 0x45, 0xdf, 0xcf, 0x9f,
+    0x80, 0x80, 0x80, 0x8c, 0x6c, 0x46, 0x4b, 0x99, 0x80, 0x80, 0x80, 0x8b, 0x6b, 0x45, 0xdf, 0xcf,
+    0x80, 0x80, 0x80, 0x4c, 0x9a, 0x3c, 0x81, 0x81, 0x80, 0x80, 0x80, 0x4b, 0x99, 0x3b, 0x7f, 0x7f,
+    0x80, 0x80, 0x4c, 0x9a, 0x3c, 0x81, 0x81, 0x81, 0x80, 0x80, 0x4b, 0x99, 0x3b, 0x7f, 0x7f, 0x7f,
+    0x7f, 0x7f, 0x81, 0x81, 0x81, 0x8c, 0x6c, 0x46, 0x7f, 0x7f, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81,
+    0x7f, 0x7f, 0x7f, 0x81, 0x81, 0x81, 0x8c, 0x6c, 0x7f, 0x7f, 0x7f, 0x81, 0x81, 0x81, 0x81, 0x81,
+    0x7f, 0x7f, 0x7f, 0x2f, 0x5f, 0xbf, 0x2f, 0x5f, 0x7f, 0x7f, 0x2f, 0x5f, 0xbf, 0x2f, 0x5f, 0xbf,
+    0x6c, 0x46, 0xe1, 0xd1, 0xa1, 0x8c, 0x6c, 0x46, 0x6c, 0x46, 0xdf, 0xcf, 0x9f, 0x7f, 0x7f, 0x7f,
+    0x6c, 0x46, 0x80, 0x80, 0x80, 0x8b, 0x6b, 0x45, 0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x8b, 0x6b, 0x45,
+    0x6c, 0x46, 0x4c, 0x9a, 0x3c, 0x31, 0x61, 0xc1, 0x6a, 0x44, 0xe1, 0xd1, 0xa1, 0x4d, 0x9b, 0x3d,
+    0x61, 0xc1, 0xe1, 0xd1, 0xa1, 0x8c, 0x6c, 0x46, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d,
+    0x61, 0xc1, 0x2f, 0x5f, 0xbf, 0x8b, 0x6b, 0x45, 0x60, 0xc0, 0xe0, 0xd0, 0xa0, 0x4c, 0x9a, 0x3c,
+    0x5f, 0xbf, 0x4c, 0x9a, 0x3c, 0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d, 0x8c, 0x6c, 0x46, 0xff, 0x00,
+    0x4c, 0x9a, 0x3c, 0xe0, 0xd0, 0xa0, 0x4c, 0x9a, 0x4b, 0x99, 0x3b, 0x8a, 0x6a, 0x44, 0xdf, 0xcf,
+    0x31, 0x61, 0xc1, 0xe1, 0xd1, 0xa1, 0x8c, 0x6c, 0x31, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x4d, 0x9b,
+    0x31, 0x61, 0xc1, 0x2f, 0x5f, 0xbf, 0x8b, 0x6b, 0x30, 0x60, 0xc0, 0xe0, 0xd0, 0xa0, 0x4c, 0x9a,
+    0x2f, 0x5f, 0xbf, 0x4c, 0x9a, 0x3c, 0x4d, 0x9b, 0x00, 0xff, 0xe1, 0xd1, 0xa1, 0xe0, 0xd0, 0xa0,
+    0x00, 0xff, 0xe0, 0xd0, 0xa0, 0x80, 0x80, 0x80, 0x00, 0xff, 0xe0, 0xd0, 0xa0, 0x31, 0x61, 0xc1,
+    0x00, 0xff, 0xdf, 0xcf, 0x9f, 0xe0, 0xd0, 0xa0, 0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x4c, 0x9a, 0x3c,
+    0x00, 0xff, 0xdf, 0xcf, 0x9f, 0x2f, 0x5f, 0xbf, 0x00, 0xff, 0x8b, 0x6b, 0x45, 0xe1, 0xd1, 0xa1,
+    0x00, 0xff, 0x8b, 0x6b, 0x45, 0x8a, 0x6a, 0x44, 0x00, 0xff, 0x81, 0x81, 0x81, 0x4c, 0x9a, 0x3c,
+    0x00, 0xff, 0x7f, 0x7f, 0x7f, 0xe1, 0xd1, 0xa1, 0x00, 0xff, 0x7f, 0x7f, 0x7f, 0x31, 0x61, 0xc1,
+    0x00, 0xff, 0x4d, 0x9b, 0x3d, 0x4c, 0x9a, 0x3c, 0x00, 0xff, 0x4d, 0x9b, 0x3d, 0x2f, 0x5f, 0xbf,
+    0x00, 0xff, 0x4c, 0x9a, 0x3c, 0x2f, 0x5f, 0xbf, 0x00, 0xff, 0x4b, 0x99, 0x3b, 0xe1, 0xd1, 0xa1,
+    0x00, 0xff, 0x30, 0x60, 0xc0, 0x30, 0x60, 0xc0, 0x00, 0xff, 0x2f, 0x5f, 0xbf, 0x8b, 0x6b, 0x45,
+    0x00, 0xff, 0x2f, 0x5f, 0xbf, 0x30, 0x60, 0xc0, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d, 0xe1, 0xd1, 0xa1,
+    0x9b, 0x3d, 0x30, 0x60, 0xc0, 0xe0, 0xd0, 0xa0, 0x99, 0x3b, 0x80, 0x80, 0x80, 0x4c, 0x9a, 0x3c,
+    0x8c, 0x6c, 0x46, 0x8c, 0x6c, 0x46, 0xe1, 0xd1, 0x8b, 0x6b, 0x45, 0xe1, 0xd1, 0xa1, 0x80, 0x80,
+    0x8b, 0x6b, 0x45, 0x4d, 0x9b, 0x3d, 0x8c, 0x6c, 0x8a, 0x6a, 0x44, 0xe1, 0xd1, 0xa1, 0x8a, 0x6a,
+    0x7f, 0x7f, 0x8c, 0x6c, 0x46, 0x30, 0x60, 0xc0, 0x7f, 0x7f, 0x80, 0x80, 0x80, 0xdf, 0xcf, 0x9f,
+    0x7f, 0x7f, 0x7f, 0x8c, 0x6c, 0x46, 0x30, 0x60, 0x7f, 0x7f, 0x7f, 0x80, 0x80, 0x80, 0xdf, 0xcf,
+    0x6c, 0x46, 0x8c, 0x6c, 0x46, 0xe1, 0xd1, 0xa1, 0x6b, 0x45, 0xe1, 0xd1, 0xa1, 0x80, 0x80, 0x80,
+    0x6b, 0x45, 0x4d, 0x9b, 0x3d, 0x8c, 0x6c, 0x46, 0x6a, 0x44, 0xe1, 0xd1, 0xa1, 0x8a, 0x6a, 0x44,
+    0x4d, 0x9b, 0x3d, 0x4d, 0x9b, 0x3d, 0xe1, 0xd1, 0x4d, 0x9b, 0x3d, 0x30, 0x60, 0xc0, 0xe0, 0xd0,
+    0x4b, 0x99, 0x3b, 0x80, 0x80, 0x80, 0x4c, 0x9a, 0x00, 0xff, 0x8b, 0x6b, 0x45, 0x7f, 0x7f, 0x7f,
+    0x00, 0xff, 0x2f, 0x5f, 0xbf, 0x8a, 0x6a, 0x44, 0x00, 0x00, 0xff, 0xff, 0xff, 0xe0, 0xd0, 0xa0,
+    0x9b, 0x3d, 0x31, 0x61, 0xc1, 0xe1, 0xd1, 0xa1, 0x8b, 0x6b, 0x45, 0x31, 0x61, 0xc1, 0x31, 0x61,
+    0x80, 0x80, 0x80, 0x2f, 0x5f, 0xbf, 0x4d, 0x9b, 0x80, 0x80, 0x2f, 0x5f, 0xbf, 0x4d, 0x9b, 0x3d,
+    0x6b, 0x45, 0x31, 0x61, 0xc1, 0x31, 0x61, 0xc1, 0x4d, 0x9b, 0x3d, 0x31, 0x61, 0xc1, 0xe1, 0xd1,
+    0x00, 0xff, 0xe1, 0xd1, 0xa1, 0xdf, 0xcf, 0x9f, 0x00, 0xff, 0xe1, 0xd1, 0xa1, 0x7f, 0x7f, 0x7f,
+    0x00, 0xff, 0xe0, 0xd0, 0xa0, 0x4b, 0x99, 0x3b, 0x00, 0xff, 0x81, 0x81, 0x81, 0x7f, 0x7f, 0x7f,
+    0x00, 0xff, 0x30, 0x60, 0xc0, 0x4c, 0x9a, 0x3c, 0xe1, 0xd1, 0xa1, 0xe0, 0xd0, 0xa0, 0x80, 0x80,
+    0xd1, 0xa1, 0xe0, 0xd0, 0xa0, 0x80, 0x80, 0x80, 0x9a, 0x3c, 0xdf, 0xcf, 0x9f, 0x8b, 0x6b, 0x45,
+    0x4c, 0x9a, 0x3c, 0xdf, 0xcf, 0x9f, 0x8b, 0x6b, 0x00, 0xff, 0x30, 0x60, 0xc0, 0x8b, 0x6b, 0x45
+};
+
+#endif // hifi_OctreePacketDictionary_h
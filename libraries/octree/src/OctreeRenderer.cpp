@@ -83,6 +83,7 @@ void OctreeRenderer::processDatagram(const QByteArray& dataByteArray, const Shar
 
         bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
         bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+        OctreePacketCompressionCodec codec = OctreePacketData::compressionCodecForFlags(flags);
         
         OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
         int clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
@@ -118,7 +119,7 @@ void OctreeRenderer::processDatagram(const QByteArray& dataByteArray, const Shar
                 ReadBitstreamToTreeParams args(packetIsColored ? WANT_COLOR : NO_COLOR, WANT_EXISTS_BITS, NULL, 
                                                 sourceUUID, sourceNode, false, expectedVersion);
                 _tree->lockForWrite();
-                OctreePacketData packetData(packetIsCompressed);
+                OctreePacketData packetData(packetIsCompressed, OctreePacketData::getMaxSectionSize(codec), codec);
                 packetData.loadFinalizedContent(dataAt, sectionLength);
                 if (extraDebugging) {
                     qDebug("OctreeRenderer::processDatagram() ... Got Packet Section"
@@ -392,6 +392,82 @@ ViewFrustum::location ViewFrustum::cubeInFrustum(const AACube& cube) const {
     return regularResult;
 }
 
+// The three bits of a child index choose the near or far half of its parent on each axis, see copyFirstVertexForCode()
+const int CHILD_X_BIT = 4;
+const int CHILD_Y_BIT = 2;
+const int CHILD_Z_BIT = 1;
+
+void ViewFrustum::calculateChildDistancesSquared(const AACube& parentCube, const glm::vec3& point,
+                                                 float distancesSquared[NUMBER_OF_CHILDREN]) {
+    float childScale = parentCube.getScale() * 0.5f;
+
+    // the children only differ by which half they are in on each axis, so there are just two terms per axis to add up
+    glm::vec3 nearOffset = parentCube.getCorner() + glm::vec3(childScale * 0.5f) - point;
+    glm::vec3 farOffset = nearOffset + glm::vec3(childScale);
+    glm::vec3 nearSquared = nearOffset * nearOffset;
+    glm::vec3 farSquared = farOffset * farOffset;
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        distancesSquared[i] = ((i & CHILD_X_BIT) ? farSquared.x : nearSquared.x) +
+                              ((i & CHILD_Y_BIT) ? farSquared.y : nearSquared.y) +
+                              ((i & CHILD_Z_BIT) ? farSquared.z : nearSquared.z);
+    }
+}
+
+void ViewFrustum::calculateChildrenInFrustum(const AACube& parentCube, ViewFrustum::location parentLocation,
+                                             ChildrenInFrustum& children) const {
+    AACube cube = parentCube;
+    cube.scale(TREE_SCALE);
+    const glm::vec3& corner = cube.getCorner();
+    float childScale = cube.getScale() * 0.5f;
+
+    calculateChildDistancesSquared(cube, _position, children.distances);
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        children.distances[i] = sqrtf(children.distances[i]);
+    }
+
+    // children are contained by their parent, so they can't be anywhere else if it is entirely inside or outside
+    if (parentLocation != INTERSECT) {
+        std::fill(children.locations, children.locations + NUMBER_OF_CHILDREN, parentLocation);
+        return;
+    }
+
+    bool outside[NUMBER_OF_CHILDREN] = { false, false, false, false, false, false, false, false };
+    bool intersects[NUMBER_OF_CHILDREN] = { false, false, false, false, false, false, false, false };
+    for (int plane = 0; plane < 6; plane++) {
+        // like cubeInFrustum(), test the corner of each child that is farthest along the normal and the one that is
+        // farthest against it. The distance to any child corner is the distance to the parent corner plus a step per axis
+        const glm::vec3& normal = _planes[plane].getNormal();
+        float parentCornerDistance = _planes[plane].distance(corner);
+        glm::vec3 step = normal * childScale;
+        float vertexPOffset = std::max(step.x, 0.0f) + std::max(step.y, 0.0f) + std::max(step.z, 0.0f);
+        float vertexNOffset = std::min(step.x, 0.0f) + std::min(step.y, 0.0f) + std::min(step.z, 0.0f);
+
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            float childCornerDistance = parentCornerDistance + ((i & CHILD_X_BIT) ? step.x : 0.0f) +
+                                        ((i & CHILD_Y_BIT) ? step.y : 0.0f) + ((i & CHILD_Z_BIT) ? step.z : 0.0f);
+            outside[i] |= (childCornerDistance + vertexPOffset < 0.0f);
+            intersects[i] |= (childCornerDistance + vertexNOffset < 0.0f);
+        }
+    }
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        ViewFrustum::location regularResult = outside[i] ? OUTSIDE : (intersects[i] ? INTERSECT : INSIDE);
+
+        // the keyhole can only matter to children that aren't entirely in the regular frustum
+        if (_keyholeRadius >= 0.0f && regularResult != INSIDE) {
+            glm::vec3 childCorner = corner + glm::vec3((i & CHILD_X_BIT) ? childScale : 0.0f,
+                                                       (i & CHILD_Y_BIT) ? childScale : 0.0f,
+                                                       (i & CHILD_Z_BIT) ? childScale : 0.0f);
+            ViewFrustum::location keyholeResult = cubeInKeyhole(AACube(childCorner, childScale));
+            if (keyholeResult == INSIDE || regularResult == OUTSIDE) {
+                regularResult = keyholeResult;
+            }
+        }
+        children.locations[i] = regularResult;
+    }
+}
+
 bool testMatches(glm::quat lhs, glm::quat rhs, float epsilon = EPSILON) {
     return (fabs(lhs.x - rhs.x) <= epsilon && fabs(lhs.y - rhs.y) <= epsilon && fabs(lhs.z - rhs.z) <= epsilon
             && fabs(lhs.w - rhs.w) <= epsilon);
@@ -98,6 +98,26 @@ public:
     ViewFrustum::location cubeInFrustum(const AACube& cube) const;
     ViewFrustum::location boxInFrustum(const AABox& box) const;
 
+    /// The frustum locations and camera distances of the eight children of a cube, indexed like the children of an
+    /// OctreeElement
+    class ChildrenInFrustum {
+    public:
+        ViewFrustum::location locations[NUMBER_OF_CHILDREN];
+        float distances[NUMBER_OF_CHILDREN]; // from the camera position to the center of each child, in TREE_SCALE
+    };
+
+    /// Classifies all of the children of parentCube, which is in voxel scale, in one pass over the planes. This gives
+    /// the same answers as cubeInFrustum() and OctreeElement::distanceToCamera() on each child, but shares the plane
+    /// math between the children. parentLocation is where the parent itself is, if it is already known to be INSIDE
+    /// or OUTSIDE so are all of its children and the planes aren't tested at all.
+    void calculateChildrenInFrustum(const AACube& parentCube, ViewFrustum::location parentLocation,
+                                    ChildrenInFrustum& children) const;
+
+    /// Fills distancesSquared with the squared distance from point to the center of each of the children of parentCube,
+    /// indexed like the children of an OctreeElement. point and parentCube must be in the same scale.
+    static void calculateChildDistancesSquared(const AACube& parentCube, const glm::vec3& point,
+                                               float distancesSquared[NUMBER_OF_CHILDREN]);
+
     // some frustum comparisons
     bool matches(const ViewFrustum& compareTo, bool debug = false) const;
     bool matches(const ViewFrustum* compareTo, bool debug = false) const { return matches(*compareTo, debug); }
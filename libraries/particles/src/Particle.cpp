@@ -26,6 +26,7 @@
 
 #include "ParticlesScriptingInterface.h"
 #include "Particle.h"
+#include "ParticleScriptPool.h"
 #include "ParticleTree.h"
 
 uint32_t Particle::_nextID = 0;
@@ -81,6 +82,7 @@ Particle::Particle(const ParticleID& particleID, const ParticleProperties& prope
     _lastEdited = now;
     _lastUpdated = now;
     _created = now; // will get updated as appropriate in setAge()
+    _simulationIndex = -1;
 
     _position = glm::vec3(0,0,0);
     _radius = 0;
@@ -118,6 +120,7 @@ void Particle::init(glm::vec3 position, float radius, rgbColor color, glm::vec3
     _lastEdited = now;
     _lastUpdated = now;
     _created = now; // will get updated as appropriate in setAge()
+    _simulationIndex = -1;
 
     _position = position;
     _radius = radius;
@@ -960,59 +963,24 @@ void Particle::update(const quint64& now) {
     }
 }
 
-void Particle::startParticleScriptContext(ScriptEngine& engine, ParticleScriptObject& particleScriptable) {
-    if (_voxelEditSender) {
-        engine.getVoxelsScriptingInterface()->setPacketSender(_voxelEditSender);
-    }
-    if (_particleEditSender) {
-        engine.getParticlesScriptingInterface()->setPacketSender(_particleEditSender);
-    }
-
-    // Add the "this" Particle object
-    engine.registerGlobalObject("Particle", &particleScriptable);
-    engine.evaluate();
-}
-
-void Particle::endParticleScriptContext(ScriptEngine& engine, ParticleScriptObject& particleScriptable) {
-    if (_voxelEditSender) {
-        _voxelEditSender->releaseQueuedMessages();
-    }
-    if (_particleEditSender) {
-        _particleEditSender->releaseQueuedMessages();
-    }
-}
-
 void Particle::executeUpdateScripts() {
     // Only run this particle script if there's a script attached directly to the particle.
     if (!_script.isEmpty()) {
-        ScriptEngine engine(_script);
-        ParticleScriptObject particleScriptable(this);
-        startParticleScriptContext(engine, particleScriptable);
-        particleScriptable.emitUpdate();
-        endParticleScriptContext(engine, particleScriptable);
+        ParticleScriptPool::getInstance()->update(this);
     }
 }
 
 void Particle::collisionWithParticle(Particle* other, const glm::vec3& penetration) {
     // Only run this particle script if there's a script attached directly to the particle.
     if (!_script.isEmpty()) {
-        ScriptEngine engine(_script);
-        ParticleScriptObject particleScriptable(this);
-        startParticleScriptContext(engine, particleScriptable);
-        ParticleScriptObject otherParticleScriptable(other);
-        particleScriptable.emitCollisionWithParticle(&otherParticleScriptable, penetration);
-        endParticleScriptContext(engine, particleScriptable);
+        ParticleScriptPool::getInstance()->collisionWithParticle(this, other, penetration);
     }
 }
 
 void Particle::collisionWithVoxel(VoxelDetail* voxelDetails, const glm::vec3& penetration) {
     // Only run this particle script if there's a script attached directly to the particle.
     if (!_script.isEmpty()) {
-        ScriptEngine engine(_script);
-        ParticleScriptObject particleScriptable(this);
-        startParticleScriptContext(engine, particleScriptable);
-        particleScriptable.emitCollisionWithVoxel(*voxelDetails, penetration);
-        endParticleScriptContext(engine, particleScriptable);
+        ParticleScriptPool::getInstance()->collisionWithVoxel(this, voxelDetails, penetration);
     }
 }
 
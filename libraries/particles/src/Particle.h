@@ -238,11 +238,19 @@ public:
 
     /// The last updated/simulated time of this particle from the time perspective of the authoritative server/source
     quint64 getLastUpdated() const { return _lastUpdated; }
+    void setLastUpdated(quint64 lastUpdated) { _lastUpdated = lastUpdated; }
 
     /// The last edited time of this particle from the time perspective of the authoritative server/source
     quint64 getLastEdited() const { return _lastEdited; }
     void setLastEdited(quint64 lastEdited) { _lastEdited = lastEdited; }
 
+    /// the time this particle was created, from the time perspective of the authoritative server/source
+    quint64 getCreated() const { return _created; }
+
+    /// the particle's entry in its tree's ParticleSimulation, only meaningful to the simulation, copies keep it
+    int getSimulationIndex() const { return _simulationIndex; }
+    void setSimulationIndex(int simulationIndex) { _simulationIndex = simulationIndex; }
+
     /// lifetime of the particle in seconds
     float getAge() const { return static_cast<float>(usecTimestampNow() - _created) / static_cast<float>(USECS_PER_SECOND); }
     float getEditedAgo() const { return static_cast<float>(usecTimestampNow() - _lastEdited) / static_cast<float>(USECS_PER_SECOND); }
@@ -324,8 +332,6 @@ protected:
     static VoxelEditPacketSender* _voxelEditSender;
     static ParticleEditPacketSender* _particleEditSender;
 
-    void startParticleScriptContext(ScriptEngine& engine, ParticleScriptObject& particleScriptable);
-    void endParticleScriptContext(ScriptEngine& engine, ParticleScriptObject& particleScriptable);
     void executeUpdateScripts();
 
     void setAge(float age);
@@ -359,17 +365,21 @@ protected:
     // this doesn't go on the wire, we send it as lifetime
     quint64 _created;
 
+    int _simulationIndex; // doesn't go on the wire either
+
     // used by the static interfaces for creator token ids
     static uint32_t _nextCreatorTokenID;
     static std::map<uint32_t,uint32_t> _tokenIDsToIDs;
 };
 
 /// Scriptable interface to a single Particle object. Used exclusively in the JavaScript API for interacting with single
-/// Particles.
+/// Particles. The object may be between particles, like the one in a pooled script engine between calls, in which case the
+/// getters return defaults and the setters do nothing.
 class ParticleScriptObject  : public QObject {
     Q_OBJECT
 public:
     ParticleScriptObject(Particle* particle) { _particle = particle; }
+    void setParticle(Particle* particle) { _particle = particle; }
     //~ParticleScriptObject() { qDebug() << "~ParticleScriptObject() this=" << this; }
 
     void emitUpdate() { emit update(); }
@@ -379,45 +389,45 @@ public:
                 { emit collisionWithVoxel(voxel, penetration); }
 
 public slots:
-    unsigned int getID() const { return _particle->getID(); }
+    unsigned int getID() const { return _particle ? _particle->getID() : UNKNOWN_PARTICLE_ID; }
     
     /// get position in meter units
-    glm::vec3 getPosition() const { return _particle->getPosition() * (float)TREE_SCALE; }
+    glm::vec3 getPosition() const { return _particle ? _particle->getPosition() * (float)TREE_SCALE : glm::vec3(); }
 
     /// get velocity in meter units
-    glm::vec3 getVelocity() const { return _particle->getVelocity() * (float)TREE_SCALE; }
-    xColor getColor() const { return _particle->getXColor(); }
+    glm::vec3 getVelocity() const { return _particle ? _particle->getVelocity() * (float)TREE_SCALE : glm::vec3(); }
+    xColor getColor() const { xColor noColor = { 0, 0, 0 }; return _particle ? _particle->getXColor() : noColor; }
 
     /// get gravity in meter units
-    glm::vec3 getGravity() const { return _particle->getGravity() * (float)TREE_SCALE; }
+    glm::vec3 getGravity() const { return _particle ? _particle->getGravity() * (float)TREE_SCALE : glm::vec3(); }
 
-    float getDamping() const { return _particle->getDamping(); }
+    float getDamping() const { return _particle ? _particle->getDamping() : 0.0f; }
 
     /// get radius in meter units
-    float getRadius() const { return _particle->getRadius() * (float)TREE_SCALE; }
-    bool getShouldDie() { return _particle->getShouldDie(); }
-    float getAge() const { return _particle->getAge(); }
-    float getLifetime() const { return _particle->getLifetime(); }
-    ParticleProperties getProperties() const { return _particle->getProperties(); }
+    float getRadius() const { return _particle ? _particle->getRadius() * (float)TREE_SCALE : 0.0f; }
+    bool getShouldDie() { return _particle ? _particle->getShouldDie() : false; }
+    float getAge() const { return _particle ? _particle->getAge() : 0.0f; }
+    float getLifetime() const { return _particle ? _particle->getLifetime() : 0.0f; }
+    ParticleProperties getProperties() const { return _particle ? _particle->getProperties() : ParticleProperties(); }
 
     /// set position in meter units
-    void setPosition(glm::vec3 value) { _particle->setPosition(value / (float)TREE_SCALE); }
+    void setPosition(glm::vec3 value) { if (_particle) { _particle->setPosition(value / (float)TREE_SCALE); } }
 
     /// set velocity in meter units
-    void setVelocity(glm::vec3 value) { _particle->setVelocity(value / (float)TREE_SCALE); }
+    void setVelocity(glm::vec3 value) { if (_particle) { _particle->setVelocity(value / (float)TREE_SCALE); } }
 
     /// set gravity in meter units
-    void setGravity(glm::vec3 value) { _particle->setGravity(value / (float)TREE_SCALE); }
+    void setGravity(glm::vec3 value) { if (_particle) { _particle->setGravity(value / (float)TREE_SCALE); } }
     
-    void setDamping(float value) { _particle->setDamping(value); }
-    void setColor(xColor value) { _particle->setColor(value); }
+    void setDamping(float value) { if (_particle) { _particle->setDamping(value); } }
+    void setColor(xColor value) { if (_particle) { _particle->setColor(value); } }
 
     /// set radius in meter units
-    void setRadius(float value) { _particle->setRadius(value / (float)TREE_SCALE); }
-    void setShouldDie(bool value) { _particle->setShouldDie(value); }
-    void setScript(const QString& script) { _particle->setScript(script); }
-    void setLifetime(float value) const { return _particle->setLifetime(value); }
-    void setProperties(const ParticleProperties& properties) { return _particle->setProperties(properties); }
+    void setRadius(float value) { if (_particle) { _particle->setRadius(value / (float)TREE_SCALE); } }
+    void setShouldDie(bool value) { if (_particle) { _particle->setShouldDie(value); } }
+    void setScript(const QString& script) { if (_particle) { _particle->setScript(script); } }
+    void setLifetime(float value) const { if (_particle) { _particle->setLifetime(value); } }
+    void setProperties(const ParticleProperties& properties) { if (_particle) { _particle->setProperties(properties); } }
 
 signals:
     void update();
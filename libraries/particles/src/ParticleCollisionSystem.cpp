@@ -23,9 +23,14 @@
 
 const int MAX_COLLISIONS_PER_PARTICLE = 16;
 
+// how much the broadphase grows spheres by, enough to cover the rounding of the exact tests
+const float PARTICLE_GRID_MARGIN = 1.0e-6f; // in domain units
+const float AVATAR_GRID_MARGIN = 1.0e-3f; // in meters
+
 ParticleCollisionSystem::ParticleCollisionSystem(ParticleEditPacketSender* packetSender,
     ParticleTree* particles, VoxelTree* voxels, AbstractAudioInterface* audio,
-    AvatarHashMap* avatars) : _collisions(MAX_COLLISIONS_PER_PARTICLE) {
+    AvatarHashMap* avatars) : _collisions(MAX_COLLISIONS_PER_PARTICLE), _useBroadphase(true),
+    _hasBroadphase(false) {
     init(packetSender, particles, voxels, audio, avatars);
 }
 
@@ -58,19 +63,98 @@ bool ParticleCollisionSystem::updateOperation(OctreeElement* element, void* extr
 }
 
 
+bool ParticleCollisionSystem::gatherOperation(OctreeElement* element, void* extraData) {
+    ParticleCollisionSystem* system = static_cast<ParticleCollisionSystem*>(extraData);
+    ParticleTreeElement* particleTreeElement = static_cast<ParticleTreeElement*>(element);
+
+    QList<Particle>& particles = particleTreeElement->getParticles();
+    uint16_t numberOfParticles = particles.size();
+    for (uint16_t i = 0; i < numberOfParticles; i++) {
+        system->_gridParticles.push_back(&particles[i]);
+    }
+    return true;
+}
+
+void ParticleCollisionSystem::buildBroadphase() {
+    _gridParticles.clear();
+    _particles->recurseTreeWithOperation(gatherOperation, this);
+
+    float maxRadius = 0.0f;
+    for (std::vector<Particle*>::const_iterator particle = _gridParticles.begin(); particle != _gridParticles.end();
+            ++particle) {
+        maxRadius = std::max(maxRadius, (*particle)->getRadius());
+    }
+    _particleGrid.clear(maxRadius * 2.0f, PARTICLE_GRID_MARGIN);
+    _gridIndices.clear();
+    int gridParticleCount = _gridParticles.size();
+    for (int i = 0; i < gridParticleCount; i++) {
+        _particleGrid.add(_gridParticles[i]->getPosition(), _gridParticles[i]->getRadius());
+        _gridIndices.push_back(std::make_pair(_gridParticles[i], i));
+    }
+    std::sort(_gridIndices.begin(), _gridIndices.end());
+
+    _gridAvatars.clear();
+    if (_avatars) {
+        float maxBoundingRadius = 0.0f;
+        foreach (const AvatarSharedPointer& avatarPointer, _avatars->getAvatarHash()) {
+            _gridAvatars.push_back(avatarPointer);
+            maxBoundingRadius = std::max(maxBoundingRadius, avatarPointer->getBoundingRadius());
+        }
+        _avatarGrid.clear(maxBoundingRadius * 2.0f, AVATAR_GRID_MARGIN);
+        for (std::vector<AvatarSharedPointer>::const_iterator avatar = _gridAvatars.begin(); avatar != _gridAvatars.end();
+                ++avatar) {
+            _avatarGrid.add((*avatar)->getPosition(), (*avatar)->getBoundingRadius());
+        }
+    }
+}
+
 void ParticleCollisionSystem::update() {
     // update all particles
     if (_particles->tryLockForRead()) {
+        if (_useBroadphase) {
+            buildBroadphase();
+            _hasBroadphase = true;
+        }
         _particles->recurseTreeWithOperation(updateOperation, this);
+        _hasBroadphase = false;
+        _gridAvatars.clear(); // don't keep avatars that leave alive until the next update
         _particles->unlock();
     }
 }
 
+bool ParticleCollisionSystem::mayCollideWithParticles(Particle* particle) {
+    if (!_hasBroadphase) {
+        return true;
+    }
+    const glm::vec3& center = particle->getPosition();
+    float radius = particle->getRadius();
+    if (_particleGrid.findOverlapping(center, radius, _nearby)) {
+        for (std::vector<int>::const_iterator nearby = _nearby.begin(); nearby != _nearby.end(); ++nearby) {
+            if (_gridParticles[*nearby] != particle) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ParticleCollisionSystem::moveInBroadphase(Particle* particle) {
+    // the grid has the particles where they were when it was built, so one that moves is added again where it is now
+    std::vector<std::pair<Particle*, int> >::const_iterator entry = std::lower_bound(_gridIndices.begin(),
+        _gridIndices.end(), std::make_pair(particle, 0));
+    if (entry != _gridIndices.end() && entry->first == particle) {
+        _particleGrid.move(entry->second, particle->getPosition());
+    }
+}
 
 void ParticleCollisionSystem::checkParticle(Particle* particle) {
+    glm::vec3 position = particle->getPosition();
     updateCollisionWithVoxels(particle);
     updateCollisionWithParticles(particle);
     updateCollisionWithAvatars(particle);
+    if (_hasBroadphase && particle->getPosition() != position) {
+        moveInBroadphase(particle);
+    }
 }
 
 void ParticleCollisionSystem::emitGlobalParticleCollisionWithVoxel(Particle* particle, 
@@ -121,6 +205,10 @@ void ParticleCollisionSystem::updateCollisionWithVoxels(Particle* particle) {
 }
 
 void ParticleCollisionSystem::updateCollisionWithParticles(Particle* particleA) {
+    // the tree can only find a penetration if the broadphase has a particle near this one
+    if (!mayCollideWithParticles(particleA)) {
+        return;
+    }
     glm::vec3 center = particleA->getPosition() * (float)(TREE_SCALE);
     float radius = particleA->getRadius() * (float)(TREE_SCALE);
     //const float ELASTICITY = 0.4f;
@@ -162,7 +250,9 @@ void ParticleCollisionSystem::updateCollisionWithParticles(Particle* particleA)
             propertiesA.copyFromParticle(*particleA);
             propertiesA.setVelocity(particleA->getVelocity() * (float)TREE_SCALE);
             propertiesA.setPosition(particleA->getPosition() * (float)TREE_SCALE);
-            _packetSender->queueParticleEditMessage(PacketTypeParticleAddOrEdit, idA, propertiesA);
+            if (_packetSender) {
+                _packetSender->queueParticleEditMessage(PacketTypeParticleAddOrEdit, idA, propertiesA);
+            }
 
             // handle particle B
             particleB->setVelocity(particleB->getVelocity() + axialVelocity * (2.0f * massA / totalMass));
@@ -172,11 +262,17 @@ void ParticleCollisionSystem::updateCollisionWithParticles(Particle* particleA)
             propertiesB.copyFromParticle(*particleB);
             propertiesB.setVelocity(particleB->getVelocity() * (float)TREE_SCALE);
             propertiesB.setPosition(particleB->getPosition() * (float)TREE_SCALE);
-            _packetSender->queueParticleEditMessage(PacketTypeParticleAddOrEdit, idB, propertiesB);
-
-            _packetSender->releaseQueuedMessages();
+            if (_packetSender) {
+                _packetSender->queueParticleEditMessage(PacketTypeParticleAddOrEdit, idB, propertiesB);
+                _packetSender->releaseQueuedMessages();
+            }
 
             updateCollisionSound(particleA, penetration, COLLISION_FREQUENCY);
+
+            // B's collision script can move it
+            if (_hasBroadphase) {
+                moveInBroadphase(particleB);
+            }
         }
     }
 }
@@ -189,45 +285,59 @@ void ParticleCollisionSystem::updateCollisionWithAvatars(Particle* particle) {
 
     glm::vec3 center = particle->getPosition() * (float)(TREE_SCALE);
     float radius = particle->getRadius() * (float)(TREE_SCALE);
+
+    _collisions.clear();
+    if (_hasBroadphase) {
+        // only the avatars that are near, in the order of the avatar hash, so the same as visiting all of them
+        _avatarGrid.findOverlapping(center, radius, _nearby);
+        for (std::vector<int>::const_iterator nearby = _nearby.begin(); nearby != _nearby.end(); ++nearby) {
+            updateCollisionWithAvatar(particle, _gridAvatars[*nearby].data(), center, radius);
+        }
+    } else {
+        foreach (const AvatarSharedPointer& avatarPointer, _avatars->getAvatarHash()) {
+            updateCollisionWithAvatar(particle, avatarPointer.data(), center, radius);
+        }
+    }
+}
+
+void ParticleCollisionSystem::updateCollisionWithAvatar(Particle* particle, AvatarData* avatar, const glm::vec3& center,
+                                                        float radius) {
     const float ELASTICITY = 0.9f;
     const float DAMPING = 0.1f;
     const float COLLISION_FREQUENCY = 0.5f;
-    glm::vec3 penetration;
-
-    _collisions.clear();
-    foreach (const AvatarSharedPointer& avatarPointer, _avatars->getAvatarHash()) {
-        AvatarData* avatar = avatarPointer.data();
 
-        float totalRadius = avatar->getBoundingRadius() + radius;
-        glm::vec3 relativePosition = center - avatar->getPosition();
-        if (glm::dot(relativePosition, relativePosition) > (totalRadius * totalRadius)) {
-            continue;
-        }
+    float totalRadius = avatar->getBoundingRadius() + radius;
+    glm::vec3 relativePosition = center - avatar->getPosition();
+    if (glm::dot(relativePosition, relativePosition) > (totalRadius * totalRadius)) {
+        return;
+    }
 
-        if (avatar->findSphereCollisions(center, radius, _collisions)) {
-            int numCollisions = _collisions.size();
-            for (int i = 0; i < numCollisions; ++i) {
-                CollisionInfo* collision = _collisions.getCollision(i);
-                collision->_damping = DAMPING;
-                collision->_elasticity = ELASTICITY;
-    
-                collision->_addedVelocity /= (float)(TREE_SCALE);
-                glm::vec3 relativeVelocity = collision->_addedVelocity - particle->getVelocity();
-    
-                if (glm::dot(relativeVelocity, collision->_penetration) <= 0.f) {
-                    // only collide when particle and collision point are moving toward each other
-                    // (doing this prevents some "collision snagging" when particle penetrates the object)
-                    updateCollisionSound(particle, collision->_penetration, COLLISION_FREQUENCY);
-                    collision->_penetration /= (float)(TREE_SCALE);
-                    particle->applyHardCollision(*collision);
-                    queueParticlePropertiesUpdate(particle);
-                }
+    if (avatar->findSphereCollisions(center, radius, _collisions)) {
+        int numCollisions = _collisions.size();
+        for (int i = 0; i < numCollisions; ++i) {
+            CollisionInfo* collision = _collisions.getCollision(i);
+            collision->_damping = DAMPING;
+            collision->_elasticity = ELASTICITY;
+
+            collision->_addedVelocity /= (float)(TREE_SCALE);
+            glm::vec3 relativeVelocity = collision->_addedVelocity - particle->getVelocity();
+
+            if (glm::dot(relativeVelocity, collision->_penetration) <= 0.f) {
+                // only collide when particle and collision point are moving toward each other
+                // (doing this prevents some "collision snagging" when particle penetrates the object)
+                updateCollisionSound(particle, collision->_penetration, COLLISION_FREQUENCY);
+                collision->_penetration /= (float)(TREE_SCALE);
+                particle->applyHardCollision(*collision);
+                queueParticlePropertiesUpdate(particle);
             }
         }
     }
 }
 
 void ParticleCollisionSystem::queueParticlePropertiesUpdate(Particle* particle) {
+    if (!_packetSender) {
+        return;
+    }
     // queue the result for sending to the particle server
     ParticleProperties properties;
     ParticleID particleID(particle->getID());
@@ -264,7 +374,7 @@ void ParticleCollisionSystem::updateCollisionSound(Particle* particle, const glm
     // (sometimes the average penetration of a bunch of voxels is a zero length vector which cannot be normalized) 
     // however the check below will fail (NaN comparisons always fail) and everything will be fine.
 
-    if (normalSpeed > AUDIBLE_COLLISION_THRESHOLD) {
+    if (_audio && normalSpeed > AUDIBLE_COLLISION_THRESHOLD) {
         //  Volume is proportional to collision velocity
         //  Base frequency is modified upward by the angle of the collision
         //  Noise is a function of the angle of collision
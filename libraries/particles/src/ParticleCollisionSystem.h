@@ -14,6 +14,8 @@
 
 #include <glm/glm.hpp>
 #include <stdint.h>
+#include <utility>
+#include <vector>
 
 #include <QtScript/QScriptEngine>
 #include <QtCore/QObject>
@@ -21,6 +23,7 @@
 #include <AvatarHashMap.h>
 #include <CollisionInfo.h>
 #include <SharedUtil.h>
+#include <SphereGrid.h>
 #include <OctreePacketData.h>
 
 #include "Particle.h"
@@ -47,10 +50,15 @@ public:
 
     void update();
 
+    /// Whether update() culls with the broadphase, on by default. Collisions are the same either way, only slower without.
+    void setUseBroadphase(bool useBroadphase) { _useBroadphase = useBroadphase; }
+    bool getUseBroadphase() const { return _useBroadphase; }
+
     void checkParticle(Particle* particle);
     void updateCollisionWithVoxels(Particle* particle);
     void updateCollisionWithParticles(Particle* particle);
     void updateCollisionWithAvatars(Particle* particle);
+    void updateCollisionWithAvatar(Particle* particle, AvatarData* avatar, const glm::vec3& center, float radius);
     void queueParticlePropertiesUpdate(Particle* particle);
     void updateCollisionSound(Particle* particle, const glm::vec3 &penetration, float frequency);
 
@@ -60,6 +68,12 @@ signals:
 
 private:
     static bool updateOperation(OctreeElement* element, void* extraData);
+    static bool gatherOperation(OctreeElement* element, void* extraData);
+
+    void buildBroadphase();
+    bool mayCollideWithParticles(Particle* particle);
+    void moveInBroadphase(Particle* particle);
+
     void emitGlobalParticleCollisionWithVoxel(Particle* particle, VoxelDetail* voxelDetails, const CollisionInfo& penetration);
     void emitGlobalParticleCollisionWithParticle(Particle* particleA, Particle* particleB, const CollisionInfo& penetration);
 
@@ -69,6 +83,17 @@ private:
     AbstractAudioInterface* _audio;
     AvatarHashMap* _avatars;
     CollisionList _collisions;
+
+    // The broadphase, built at the start of each update(). A particle is only looked for in the particle tree if the
+    // grid has another particle near it, and only the avatars that the grid has near it are tested.
+    bool _useBroadphase;
+    bool _hasBroadphase;
+    SphereGrid _particleGrid;
+    std::vector<Particle*> _gridParticles; // in the order they were added to _particleGrid
+    std::vector<std::pair<Particle*, int> > _gridIndices; // the index of each particle in _particleGrid, sorted by particle
+    SphereGrid _avatarGrid;
+    std::vector<AvatarSharedPointer> _gridAvatars; // in the order of the avatar hash
+    std::vector<int> _nearby;
 };
 
 #endif // hifi_ParticleCollisionSystem_h
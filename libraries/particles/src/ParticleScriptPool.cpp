@@ -0,0 +1,177 @@
+//
+//  ParticleScriptPool.cpp
+//  libraries/particles/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QThreadStorage>
+
+#include <SharedUtil.h>
+
+#include <VoxelEditPacketSender.h>
+#include <VoxelsScriptingInterface.h>
+
+// see the note in Particle.cpp about including this without linking to script-engine
+#include <ScriptEngine.h>
+
+#include "ParticleEditPacketSender.h"
+#include "ParticlesScriptingInterface.h"
+#include "ParticleScriptPool.h"
+
+const int ParticleScriptPool::MAX_ENGINES;
+const quint64 ParticleScriptPool::NO_BUDGET;
+
+class ParticleScriptPool::PooledEngine {
+public:
+    PooledEngine(const QString& script) :
+        program(script),
+        particleScriptable(NULL),
+        lastUse(0) {
+
+        engine.init();
+        engine.registerGlobalObject("Particle", &particleScriptable);
+        engine.evaluate(program); // connects the script's handlers to particleScriptable
+    }
+
+    QScriptProgram program;
+    ScriptEngine engine;
+    ParticleScriptObject particleScriptable;
+    quint64 lastUse;
+    ScriptStats stats;
+};
+
+static QThreadStorage<ParticleScriptPool*> pools;
+
+ParticleScriptPool* ParticleScriptPool::getInstance() {
+    if (!pools.hasLocalData()) {
+        pools.setLocalData(new ParticleScriptPool());
+    }
+    return pools.localData();
+}
+
+ParticleScriptPool::ParticleScriptPool() :
+    _useCount(0),
+    _budgetUsecs(NO_BUDGET),
+    _tickUsecs(0) {
+}
+
+ParticleScriptPool::~ParticleScriptPool() {
+    qDeleteAll(_engines);
+}
+
+void ParticleScriptPool::startTick(quint64 budgetUsecs) {
+    _budgetUsecs = budgetUsecs;
+    _tickUsecs = 0;
+    _deferredLastTick.swap(_deferredThisTick);
+    _deferredThisTick.clear();
+}
+
+ParticleScriptPool::PooledEngine* ParticleScriptPool::getEngine(const QString& script) {
+    PooledEngine* engine = _engines.value(script);
+    if (!engine) {
+        if (_engines.size() >= MAX_ENGINES) {
+            releaseLeastRecentlyUsedEngine();
+        }
+        engine = new PooledEngine(script);
+        _engines.insert(script, engine);
+    }
+    engine->lastUse = ++_useCount;
+    return engine;
+}
+
+void ParticleScriptPool::releaseLeastRecentlyUsedEngine() {
+    QHash<QString, PooledEngine*>::iterator leastRecentlyUsed = _engines.begin();
+    for (QHash<QString, PooledEngine*>::iterator engine = _engines.begin(); engine != _engines.end(); ++engine) {
+        if (engine.value()->lastUse < leastRecentlyUsed.value()->lastUse) {
+            leastRecentlyUsed = engine;
+        }
+    }
+    if (leastRecentlyUsed != _engines.end()) {
+        delete leastRecentlyUsed.value();
+        _engines.erase(leastRecentlyUsed);
+    }
+}
+
+void ParticleScriptPool::startCall(PooledEngine* engine, Particle* particle) {
+    if (Particle::getVoxelEditPacketSender()) {
+        ScriptEngine::getVoxelsScriptingInterface()->setPacketSender(Particle::getVoxelEditPacketSender());
+    }
+    if (Particle::getParticleEditPacketSender()) {
+        ScriptEngine::getParticlesScriptingInterface()->setPacketSender(Particle::getParticleEditPacketSender());
+    }
+    engine->particleScriptable.setParticle(particle);
+}
+
+quint64 ParticleScriptPool::endCall(PooledEngine* engine, quint64 start) {
+    // a timer would fire between calls, when the script has no particle, so timers only last as long as the call did
+    // back when each call had an engine of its own
+    engine->engine.stopAllTimers();
+    engine->particleScriptable.setParticle(NULL);
+    if (engine->engine.hasUncaughtException()) {
+        qDebug() << "Uncaught exception in particle script at line" << engine->engine.uncaughtExceptionLineNumber() << ":"
+                 << engine->engine.uncaughtException().toString();
+        engine->engine.clearExceptions();
+    }
+    if (Particle::getVoxelEditPacketSender()) {
+        Particle::getVoxelEditPacketSender()->releaseQueuedMessages();
+    }
+    if (Particle::getParticleEditPacketSender()) {
+        Particle::getParticleEditPacketSender()->releaseQueuedMessages();
+    }
+
+    quint64 usecs = usecTimestampNow() - start;
+    engine->stats.usecs += usecs;
+    engine->stats.maxUsecs = std::max(engine->stats.maxUsecs, usecs);
+    return usecs;
+}
+
+bool ParticleScriptPool::update(Particle* particle) {
+    PooledEngine* engine = getEngine(particle->getScript());
+    if (_budgetUsecs != NO_BUDGET && _tickUsecs >= _budgetUsecs && !_deferredLastTick.contains(particle->getID())) {
+        _deferredThisTick.insert(particle->getID());
+        engine->stats.deferredUpdates++;
+        return false;
+    }
+
+    quint64 start = usecTimestampNow();
+    startCall(engine, particle);
+    engine->particleScriptable.emitUpdate();
+    _tickUsecs += endCall(engine, start);
+    engine->stats.updates++;
+    return true;
+}
+
+void ParticleScriptPool::collisionWithParticle(Particle* particle, Particle* other, const glm::vec3& penetration) {
+    PooledEngine* engine = getEngine(particle->getScript());
+    quint64 start = usecTimestampNow();
+    startCall(engine, particle);
+    ParticleScriptObject otherParticleScriptable(other);
+    engine->particleScriptable.emitCollisionWithParticle(&otherParticleScriptable, penetration);
+    endCall(engine, start);
+    engine->stats.collisions++;
+}
+
+void ParticleScriptPool::collisionWithVoxel(Particle* particle, VoxelDetail* voxelDetails, const glm::vec3& penetration) {
+    PooledEngine* engine = getEngine(particle->getScript());
+    quint64 start = usecTimestampNow();
+    startCall(engine, particle);
+    engine->particleScriptable.emitCollisionWithVoxel(*voxelDetails, penetration);
+    endCall(engine, start);
+    engine->stats.collisions++;
+}
+
+QHash<QString, ParticleScriptPool::ScriptStats> ParticleScriptPool::getScriptStats() const {
+    QHash<QString, ScriptStats> scriptStats;
+    for (QHash<QString, PooledEngine*>::const_iterator engine = _engines.constBegin(); engine != _engines.constEnd();
+            ++engine) {
+        scriptStats.insert(engine.key(), engine.value()->stats);
+    }
+    return scriptStats;
+}
@@ -0,0 +1,92 @@
+//
+//  ParticleScriptPool.h
+//  libraries/particles/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Runs the scripts attached to particles. Setting up a ScriptEngine costs far more than running a particle script, so
+//  rather than an engine per particle per call, there is one engine for each distinct script, which evaluates the
+//  compiled script once. Its Particle object is pointed at each particle in turn before the update or collision signal
+//  is emitted. A consequence is that global variables in a script are shared by all the particles that run it. Timers
+//  that a script sets up are stopped at the end of the call that set them up, since the engine has no particle between
+//  calls.
+//
+//  Engines are QObjects and the script handlers are connected to signals, so each thread that runs particle scripts has
+//  its own pool. Update scripts can be given a budget of script time per tick, past which updates are deferred to the
+//  next tick. A particle that was deferred in the last tick is never deferred twice in a row.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParticleScriptPool_h
+#define hifi_ParticleScriptPool_h
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtScript/QScriptProgram>
+
+#include <glm/glm.hpp>
+
+#include "Particle.h"
+
+class ParticleScriptPool {
+public:
+    static const int MAX_ENGINES = 64; // least recently used engines are released past this
+    static const quint64 NO_BUDGET = 0;
+
+    /// the time spent in one script, for all the particles that run it, since its engine was created
+    class ScriptStats {
+    public:
+        ScriptStats() : updates(0), collisions(0), deferredUpdates(0), usecs(0), maxUsecs(0) { }
+
+        quint64 updates;
+        quint64 collisions;
+        quint64 deferredUpdates;
+        quint64 usecs;
+        quint64 maxUsecs; // the longest single call
+    };
+
+    /// the pool for the calling thread
+    static ParticleScriptPool* getInstance();
+
+    ~ParticleScriptPool();
+
+    /// Starts a new tick of update scripts. Once they have used up budgetUsecs in it, further updates are deferred.
+    void startTick(quint64 budgetUsecs = NO_BUDGET);
+
+    /// Runs the update handlers of particle's script.
+    /// \return false if the update was deferred because the tick is over budget
+    bool update(Particle* particle);
+
+    void collisionWithParticle(Particle* particle, Particle* other, const glm::vec3& penetration);
+    void collisionWithVoxel(Particle* particle, VoxelDetail* voxelDetails, const glm::vec3& penetration);
+
+    /// the stats of every script that has an engine, by script source
+    QHash<QString, ScriptStats> getScriptStats() const;
+
+    int getEngineCount() const { return _engines.size(); }
+    quint64 getTickUsecs() const { return _tickUsecs; }
+    int getDeferredCount() const { return _deferredThisTick.size(); }
+
+private:
+    class PooledEngine;
+
+    ParticleScriptPool();
+
+    PooledEngine* getEngine(const QString& script);
+    void releaseLeastRecentlyUsedEngine();
+    void startCall(PooledEngine* engine, Particle* particle);
+    quint64 endCall(PooledEngine* engine, quint64 start);
+
+    QHash<QString, PooledEngine*> _engines;
+    quint64 _useCount; // orders the engines by their last use
+
+    quint64 _budgetUsecs;
+    quint64 _tickUsecs;
+    QSet<uint32_t> _deferredLastTick;
+    QSet<uint32_t> _deferredThisTick;
+};
+
+#endif // hifi_ParticleScriptPool_h
@@ -0,0 +1,253 @@
+//
+//  ParticleSimulation.cpp
+//  libraries/particles/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <SharedUtil.h>
+
+#include "ParticleSimulation.h"
+
+ParticleSimulation::ParticleSimulation() :
+    _now(0),
+    _previousNow(0),
+    _count(0),
+    _storedCount(0) {
+}
+
+void ParticleSimulation::clear() {
+    _count = 0;
+    _storedCount = 0;
+    _particles.clear();
+    _positionX.clear();
+    _positionY.clear();
+    _positionZ.clear();
+    _velocityX.clear();
+    _velocityY.clear();
+    _velocityZ.clear();
+    _gravityX.clear();
+    _gravityY.clear();
+    _gravityZ.clear();
+    _damping.clear();
+    _nextPositionX.clear();
+    _nextPositionY.clear();
+    _nextPositionZ.clear();
+    _nextVelocityX.clear();
+    _nextVelocityY.clear();
+    _nextVelocityZ.clear();
+    _visited.clear();
+}
+
+void ParticleSimulation::simulate(quint64 now) {
+    _previousNow = _now;
+    _now = now;
+    _storedCount = 0;
+    std::fill(_visited.begin(), _visited.end(), 0);
+
+    int count = _particles.size();
+    if (count == 0) {
+        return;
+    }
+    // every entry is in the state of the previous pass, so they all move for the same time
+    const float timeElapsed = (float)(_now - _previousNow) / (float)(USECS_PER_SECOND);
+    const float* positionX = &_positionX[0];
+    const float* positionY = &_positionY[0];
+    const float* positionZ = &_positionZ[0];
+    const float* velocityX = &_velocityX[0];
+    const float* velocityY = &_velocityY[0];
+    const float* velocityZ = &_velocityZ[0];
+    const float* gravityX = &_gravityX[0];
+    const float* gravityY = &_gravityY[0];
+    const float* gravityZ = &_gravityZ[0];
+    const float* damping = &_damping[0];
+    float* nextPositionX = &_nextPositionX[0];
+    float* nextPositionY = &_nextPositionY[0];
+    float* nextPositionZ = &_nextPositionZ[0];
+    float* nextVelocityX = &_nextVelocityX[0];
+    float* nextVelocityY = &_nextVelocityY[0];
+    float* nextVelocityZ = &_nextVelocityZ[0];
+
+    // the same operations in the same order as Particle::update, so that both give the same results
+    for (int i = 0; i < count; i++) {
+        nextPositionX[i] = positionX[i] + velocityX[i] * timeElapsed;
+        nextPositionY[i] = positionY[i] + velocityY[i] * timeElapsed;
+        nextPositionZ[i] = positionZ[i] + velocityZ[i] * timeElapsed;
+    }
+
+    // bounce off the ground
+    for (int i = 0; i < count; i++) {
+        bool bounced = nextPositionY[i] <= 0.0f;
+        nextVelocityX[i] = velocityX[i];
+        nextVelocityY[i] = bounced ? -velocityY[i] : velocityY[i];
+        nextVelocityZ[i] = velocityZ[i];
+        nextPositionY[i] = bounced ? 0.0f : nextPositionY[i];
+    }
+
+    // gravity, then damping
+    for (int i = 0; i < count; i++) {
+        nextVelocityX[i] += gravityX[i] * timeElapsed;
+        nextVelocityY[i] += gravityY[i] * timeElapsed;
+        nextVelocityZ[i] += gravityZ[i] * timeElapsed;
+
+        nextVelocityX[i] -= (nextVelocityX[i] * damping[i]) * timeElapsed;
+        nextVelocityY[i] -= (nextVelocityY[i] * damping[i]) * timeElapsed;
+        nextVelocityZ[i] -= (nextVelocityZ[i] * damping[i]) * timeElapsed;
+    }
+}
+
+bool ParticleSimulation::store(Particle& particle) {
+    int i = particle.getSimulationIndex();
+    if (!isEntryOf(i, particle) || !canSimulate(particle) || particle.getLastUpdated() != _previousNow) {
+        return false;
+    }
+    // edits, collisions and scripts change particles in place, then the entry is stale and the particle runs
+    // Particle::update instead
+    const glm::vec3& position = particle.getPosition();
+    const glm::vec3& velocity = particle.getVelocity();
+    const glm::vec3& gravity = particle.getGravity();
+    if (position.x != _positionX[i] || position.y != _positionY[i] || position.z != _positionZ[i] ||
+            velocity.x != _velocityX[i] || velocity.y != _velocityY[i] || velocity.z != _velocityZ[i] ||
+            gravity.x != _gravityX[i] || gravity.y != _gravityY[i] || gravity.z != _gravityZ[i] ||
+            particle.getDamping() != _damping[i]) {
+        return false;
+    }
+    _visited[i] = 1;
+    _storedCount++;
+
+    // the age as of this pass, rather than of the moment the particle is looked at
+    float age = (float)(_now - particle.getCreated()) / (float)(USECS_PER_SECOND);
+    particle.setLastUpdated(_now);
+    particle.setShouldDie(age > particle.getLifetime() || particle.getShouldDie());
+    particle.setPosition(glm::vec3(_nextPositionX[i], _nextPositionY[i], _nextPositionZ[i]));
+    particle.setVelocity(glm::vec3(_nextVelocityX[i], _nextVelocityY[i], _nextVelocityZ[i]));
+    return true;
+}
+
+void ParticleSimulation::keep(Particle& particle) {
+    if (!canSimulate(particle) || particle.getLastUpdated() != _now) {
+        remove(particle);
+        return;
+    }
+    int i = particle.getSimulationIndex();
+    if (!isEntryOf(i, particle)) {
+        i = _particles.size();
+        _particles.push_back(&particle);
+        _positionX.push_back(0.0f);
+        _positionY.push_back(0.0f);
+        _positionZ.push_back(0.0f);
+        _velocityX.push_back(0.0f);
+        _velocityY.push_back(0.0f);
+        _velocityZ.push_back(0.0f);
+        _gravityX.push_back(0.0f);
+        _gravityY.push_back(0.0f);
+        _gravityZ.push_back(0.0f);
+        _damping.push_back(0.0f);
+        _nextPositionX.push_back(0.0f);
+        _nextPositionY.push_back(0.0f);
+        _nextPositionZ.push_back(0.0f);
+        _nextVelocityX.push_back(0.0f);
+        _nextVelocityY.push_back(0.0f);
+        _nextVelocityZ.push_back(0.0f);
+        _visited.push_back(0);
+        _count++;
+        particle.setSimulationIndex(i);
+    }
+    _visited[i] = 1;
+
+    const glm::vec3& position = particle.getPosition();
+    _nextPositionX[i] = position.x;
+    _nextPositionY[i] = position.y;
+    _nextPositionZ[i] = position.z;
+
+    const glm::vec3& velocity = particle.getVelocity();
+    _nextVelocityX[i] = velocity.x;
+    _nextVelocityY[i] = velocity.y;
+    _nextVelocityZ[i] = velocity.z;
+
+    const glm::vec3& gravity = particle.getGravity();
+    _gravityX[i] = gravity.x;
+    _gravityY[i] = gravity.y;
+    _gravityZ[i] = gravity.z;
+
+    _damping[i] = particle.getDamping();
+}
+
+void ParticleSimulation::remove(const Particle& particle) {
+    int i = particle.getSimulationIndex();
+    if (isEntryOf(i, particle)) {
+        _particles[i] = NULL;
+        _visited[i] = 0;
+        _count--;
+    }
+}
+
+void ParticleSimulation::finish() {
+    _positionX.swap(_nextPositionX);
+    _positionY.swap(_nextPositionY);
+    _positionZ.swap(_nextPositionZ);
+    _velocityX.swap(_nextVelocityX);
+    _velocityY.swap(_nextVelocityY);
+    _velocityZ.swap(_nextVelocityZ);
+
+    // particles that were deleted or replaced outside of the pass weren't visited, and may no longer exist
+    int size = _particles.size();
+    for (int i = 0; i < size; i++) {
+        if (!_visited[i] && _particles[i]) {
+            _particles[i] = NULL;
+            _count--;
+        }
+    }
+
+    // dropped entries are integrated like the others until they are compacted away
+    if (_count < size / 2) {
+        compact();
+    }
+}
+
+void ParticleSimulation::compact() {
+    // only the particles that this pass visited are left, and they are all still in their elements
+    int size = _particles.size();
+    int count = 0;
+    for (int i = 0; i < size; i++) {
+        if (!_particles[i]) {
+            continue;
+        }
+        _particles[count] = _particles[i];
+        _particles[count]->setSimulationIndex(count);
+        _positionX[count] = _positionX[i];
+        _positionY[count] = _positionY[i];
+        _positionZ[count] = _positionZ[i];
+        _velocityX[count] = _velocityX[i];
+        _velocityY[count] = _velocityY[i];
+        _velocityZ[count] = _velocityZ[i];
+        _gravityX[count] = _gravityX[i];
+        _gravityY[count] = _gravityY[i];
+        _gravityZ[count] = _gravityZ[i];
+        _damping[count] = _damping[i];
+        count++;
+    }
+    _particles.resize(count);
+    _positionX.resize(count);
+    _positionY.resize(count);
+    _positionZ.resize(count);
+    _velocityX.resize(count);
+    _velocityY.resize(count);
+    _velocityZ.resize(count);
+    _gravityX.resize(count);
+    _gravityY.resize(count);
+    _gravityZ.resize(count);
+    _damping.resize(count);
+    _nextPositionX.resize(count);
+    _nextPositionY.resize(count);
+    _nextPositionZ.resize(count);
+    _nextVelocityX.resize(count);
+    _nextVelocityY.resize(count);
+    _nextVelocityZ.resize(count);
+    _visited.resize(count);
+}
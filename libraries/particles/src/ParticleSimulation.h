@@ -0,0 +1,95 @@
+//
+//  ParticleSimulation.h
+//  libraries/particles/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Integrates the motion of particles in batches. Particles live as values in the lists of their tree elements, which
+//  is the wrong layout for a tight loop, so the fields that Particle::update reads are also kept in one array per
+//  field, integrated with simple loops the compiler can vectorize, and the elements store the results back as they
+//  visit their particles. The arrays live from pass to pass: a particle's entry is only written when it joins the
+//  batch, or when something other than the batch changed it, which the store notices by comparing the particle with
+//  its entry.
+//
+//  Only particles without an update script, that aren't in hand, are in the batch. The others still run
+//  Particle::update, since a script can change any of the particle's properties before it moves.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParticleSimulation_h
+#define hifi_ParticleSimulation_h
+
+#include <vector>
+
+#include "Particle.h"
+
+class ParticleSimulation {
+public:
+    ParticleSimulation();
+
+    /// drops every particle from the batch
+    void clear();
+
+    /// \return true if particle can move with the batch rather than running Particle::update
+    static bool canSimulate(const Particle& particle) { return !particle.getInHand() && particle.getScript().isEmpty(); }
+
+    /// Starts a pass, integrating every particle in the batch from the time of the previous pass to now.
+    void simulate(quint64 now);
+
+    /// Stores the integrated state in particle, if it is in the batch and nothing else changed it since the last pass.
+    /// \return false if it wasn't stored, in which case it should run Particle::update and then be passed to keep()
+    bool store(Particle& particle);
+
+    /// Adds particle to the batch, or refreshes its entry, after it ran Particle::update in this pass. Particles that
+    /// can't be simulated are dropped from the batch instead. particle must stay at the same address while it is in the
+    /// batch, or be removed.
+    void keep(Particle& particle);
+
+    /// drops particle from the batch, when it leaves the element that holds it
+    void remove(const Particle& particle);
+
+    /// Ends a pass. Particles in the batch that the pass didn't store or keep have left the tree, and are dropped. The
+    /// arrays are compacted once most of their entries were dropped.
+    void finish();
+
+    int getCount() const { return _count; }
+    int getStoredCount() const { return _storedCount; }
+
+private:
+    bool isEntryOf(int index, const Particle& particle) const {
+        return index >= 0 && index < (int)_particles.size() && _particles[index] == &particle;
+    }
+    void compact();
+
+    quint64 _now; // the time of the current pass
+    quint64 _previousNow; // the time of the pass that left the particles in the state of their entries
+    int _count; // entries that hold a particle, the others were dropped
+    int _storedCount;
+
+    // the particles' state as the previous pass left it, except for the new ones, which are in the next arrays
+    std::vector<Particle*> _particles;
+    std::vector<float> _positionX;
+    std::vector<float> _positionY;
+    std::vector<float> _positionZ;
+    std::vector<float> _velocityX;
+    std::vector<float> _velocityY;
+    std::vector<float> _velocityZ;
+    std::vector<float> _gravityX;
+    std::vector<float> _gravityY;
+    std::vector<float> _gravityZ;
+    std::vector<float> _damping;
+
+    // the state this pass leaves the particles in, swapped with the arrays above when the pass is finished
+    std::vector<float> _nextPositionX;
+    std::vector<float> _nextPositionY;
+    std::vector<float> _nextPositionZ;
+    std::vector<float> _nextVelocityX;
+    std::vector<float> _nextVelocityY;
+    std::vector<float> _nextVelocityZ;
+
+    std::vector<unsigned char> _visited; // whether this pass stored or kept the entry
+};
+
+#endif // hifi_ParticleSimulation_h
@@ -9,9 +9,16 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "ParticleScriptPool.h"
 #include "ParticleTree.h"
 
-ParticleTree::ParticleTree(bool shouldReaverage) : Octree(shouldReaverage) {
+ParticleTree::ParticleTree(bool shouldReaverage) :
+    Octree(shouldReaverage),
+    _scriptBudgetUsecs(DEFAULT_SCRIPT_BUDGET_USECS),
+    _lastScriptTickUsecs(0),
+    _lastDeferredScriptCount(0),
+    _simulateInBatches(true)
+{
     _rootElement = createNewElement();
 }
 
@@ -94,11 +101,18 @@ bool ParticleTree::findAndUpdateOperation(OctreeElement* element, void* extraDat
 
 void ParticleTree::storeParticle(const Particle& particle, const SharedNodePointer& senderNode) {
     // First, look for the existing particle in the tree..
-    FindAndUpdateParticleArgs args = { particle, false };
-    recurseTreeWithOperation(findAndUpdateOperation, &args);
+    bool found = false;
+    ParticleTreeElement* containingElement;
+    if (lookUpParticle(ParticleID(particle.getID()), containingElement)) {
+        found = containingElement && containingElement->updateParticle(particle);
+    } else {
+        FindAndUpdateParticleArgs args = { particle, false };
+        recurseTreeWithOperation(findAndUpdateOperation, &args);
+        found = args.found;
+    }
 
     // if we didn't find it in the tree, then store it...
-    if (!args.found) {
+    if (!found) {
         glm::vec3 position = particle.getPosition();
         float size = std::max(MINIMUM_PARTICLE_ELEMENT_SIZE, particle.getRadius());
 
@@ -135,10 +149,17 @@ bool ParticleTree::findAndUpdateWithIDandPropertiesOperation(OctreeElement* elem
 
 void ParticleTree::updateParticle(const ParticleID& particleID, const ParticleProperties& properties) {
     // First, look for the existing particle in the tree..
-    FindAndUpdateParticleWithIDandPropertiesArgs args = { particleID, properties, false };
-    recurseTreeWithOperation(findAndUpdateWithIDandPropertiesOperation, &args);
+    bool found = false;
+    ParticleTreeElement* containingElement;
+    if (lookUpParticle(particleID, containingElement)) {
+        found = containingElement && containingElement->updateParticle(particleID, properties);
+    } else {
+        FindAndUpdateParticleWithIDandPropertiesArgs args = { particleID, properties, false };
+        recurseTreeWithOperation(findAndUpdateWithIDandPropertiesOperation, &args);
+        found = args.found;
+    }
     // if we found it in the tree, then mark the tree as dirty
-    if (args.found) {
+    if (found) {
         _isDirty = true;
     }
 }
@@ -160,9 +181,16 @@ void ParticleTree::addParticle(const ParticleID& particleID, const ParticlePrope
 
 void ParticleTree::deleteParticle(const ParticleID& particleID) {
     if (particleID.isKnownID) {
-        FindAndDeleteParticlesArgs args;
-        args._idsToDelete.push_back(particleID.id);
-        recurseTreeWithOperation(findAndDeleteOperation, &args);
+        ParticleTreeElement* containingElement;
+        if (lookUpParticle(particleID, containingElement)) {
+            if (containingElement) {
+                containingElement->removeParticleWithID(particleID.id);
+            }
+        } else {
+            FindAndDeleteParticlesArgs args;
+            args._idsToDelete.push_back(particleID.id);
+            recurseTreeWithOperation(findAndDeleteOperation, &args);
+        }
     }
 }
 
@@ -217,7 +245,19 @@ void ParticleTree::handleAddParticleResponse(const QByteArray& packet) {
                 << " getIsViewing()=" << getIsViewing();
     }
     lockForWrite();
-    recurseTreeWithOperation(findAndUpdateParticleIDOperation, &args);
+    ParticleTreeElement* creatorTokenElement;
+    ParticleTreeElement* viewedElement = NULL;
+    if (lookUpParticle(ParticleID(UNKNOWN_PARTICLE_ID, creatorTokenID, false), creatorTokenElement) &&
+            (!getIsViewing() || lookUpParticle(ParticleID(particleID), viewedElement))) {
+        if (creatorTokenElement) {
+            creatorTokenElement->updateParticleID(&args);
+        }
+        if (viewedElement && viewedElement != creatorTokenElement) {
+            viewedElement->updateParticleID(&args);
+        }
+    } else {
+        recurseTreeWithOperation(findAndUpdateParticleIDOperation, &args);
+    }
     unlock();
 }
 
@@ -373,16 +413,25 @@ bool ParticleTree::findByIDOperation(OctreeElement* element, void* extraData) {
 
 
 const Particle* ParticleTree::findParticleByID(uint32_t id, bool alreadyLocked) {
-    FindByIDArgs args = { id, false, NULL };
+    const Particle* foundParticle = NULL;
 
     if (!alreadyLocked) {
         lockForRead();
     }
-    recurseTreeWithOperation(findByIDOperation, &args);
+    ParticleTreeElement* containingElement;
+    if (lookUpParticle(ParticleID(id), containingElement)) {
+        if (containingElement) {
+            foundParticle = containingElement->getParticleWithID(id);
+        }
+    } else {
+        FindByIDArgs args = { id, false, NULL };
+        recurseTreeWithOperation(findByIDOperation, &args);
+        foundParticle = args.foundParticle;
+    }
     if (!alreadyLocked) {
         unlock();
     }
-    return args.foundParticle;
+    return foundParticle;
 }
 
 
@@ -442,30 +491,120 @@ void ParticleTree::removeNewlyCreatedHook(NewlyCreatedParticleHook* hook) {
 }
 
 
-bool ParticleTree::updateOperation(OctreeElement* element, void* extraData) {
-    ParticleTreeUpdateArgs* args = static_cast<ParticleTreeUpdateArgs*>(extraData);
-    ParticleTreeElement* particleTreeElement = static_cast<ParticleTreeElement*>(element);
-    particleTreeElement->update(*args);
-    return true;
+ParticleTree::~ParticleTree() {
+    // the elements take their particles out of the indexes, which are gone by the time ~Octree() deletes them
+    delete _rootElement;
+    _rootElement = NULL;
 }
 
-bool ParticleTree::pruneOperation(OctreeElement* element, void* extraData) {
-    ParticleTreeElement* particleTreeElement = static_cast<ParticleTreeElement*>(element);
+void ParticleTree::eraseAllOctreeElements() {
+    // clear the indexes first, so that the elements don't have to take their particles out one by one
+    _particlesByID.clear();
+    _particlesByCreatorToken.clear();
+    _simulation.clear();
+    Octree::eraseAllOctreeElements();
+}
+
+void ParticleTree::indexParticle(const Particle& particle, ParticleTreeElement* element) {
+    if (particle.getID() != UNKNOWN_PARTICLE_ID) {
+        _particlesByID.insert(particle.getID(), element);
+    } else if (particle.getCreatorTokenID() != UNKNOWN_TOKEN) {
+        _particlesByCreatorToken.insert(particle.getCreatorTokenID(), element);
+    }
+}
+
+void ParticleTree::unindexParticle(const Particle& particle, ParticleTreeElement* element) {
+    if (particle.getID() != UNKNOWN_PARTICLE_ID) {
+        _particlesByID.remove(particle.getID(), element);
+    } else if (particle.getCreatorTokenID() != UNKNOWN_TOKEN) {
+        _particlesByCreatorToken.remove(particle.getCreatorTokenID(), element);
+    }
+}
+
+// Every particle in the tree is indexed, so a particle that isn't in the index isn't in the tree. But if the index
+// points at an element that doesn't hold the particle, the caller falls back to searching the whole tree.
+bool ParticleTree::lookUpParticle(const ParticleID& particleID, ParticleTreeElement*& element) const {
+    element = NULL;
+    quint32 key = particleID.isKnownID ? particleID.id : particleID.creatorTokenID;
+    if (key == (particleID.isKnownID ? UNKNOWN_PARTICLE_ID : UNKNOWN_TOKEN)) {
+        return false;
+    }
+    const OctreeItemIndex& index = particleID.isKnownID ? _particlesByID : _particlesByCreatorToken;
+    if (!index.contains(key)) {
+        return true;
+    }
+    element = static_cast<ParticleTreeElement*>(index.find(key));
+    if (element && element->hasParticle(particleID)) {
+        return true;
+    }
+    element = NULL;
+    return false;
+}
+
+void ParticleTree::markPathChanged(ParticleTreeElement* element) {
+    int elementLevel = numberOfThreeBitSectionsInCode(element->getOctalCode());
+    ParticleTreeElement* ancestor = getRoot();
+    for (int level = 0; ancestor; level++) {
+        ancestor->setHasParticlesInSubtree(true);
+        ancestor->markWithChangedTime();
+        if (level == elementLevel) {
+            break;
+        }
+        ancestor = ancestor->getChildAtIndex(branchIndexWithDescendant(ancestor->getOctalCode(), element->getOctalCode()));
+    }
+}
+
+// Updates the particles of element and its descendants in post-fix order, so that an element can be marked as changed
+// if anything below it changed. Subtrees without particles are skipped, and pruned.
+bool ParticleTree::updateSubtree(ParticleTreeElement* element, ParticleTreeUpdateArgs& args) {
+    bool changed = element->update(args);
+    bool hasParticlesInSubtree = element->hasParticles();
+
     for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        ParticleTreeElement* childAt = particleTreeElement->getChildAtIndex(i);
-        if (childAt && childAt->isLeaf() && !childAt->hasParticles()) {
-            particleTreeElement->deleteChildAtIndex(i);
+        ParticleTreeElement* childAt = element->getChildAtIndex(i);
+        if (!childAt) {
+            continue;
+        }
+        if (childAt->hasParticlesInSubtree() && updateSubtree(childAt, args)) {
+            changed = true;
+        }
+        if (childAt->hasParticlesInSubtree()) {
+            hasParticlesInSubtree = true;
+        } else {
+            element->deleteChildAtIndex(i);
+            changed = true;
         }
     }
-    return true;
+    element->setHasParticlesInSubtree(hasParticlesInSubtree);
+
+    if (changed) {
+        element->markWithChangedTime();
+    }
+    return changed;
+}
+
+void ParticleTree::setSimulateInBatches(bool simulateInBatches) {
+    lockForWrite();
+    _simulateInBatches = simulateInBatches;
+    _simulation.clear(); // a batch that missed passes doesn't match its particles anymore
+    unlock();
 }
 
 void ParticleTree::update() {
     lockForWrite();
-    _isDirty = true;
+    ParticleScriptPool* scriptPool = ParticleScriptPool::getInstance();
+    scriptPool->startTick(_scriptBudgetUsecs);
 
-    ParticleTreeUpdateArgs args = { };
-    recurseTreeWithOperation(updateOperation, &args);
+    quint64 now = usecTimestampNow();
+    ParticleTreeUpdateArgs args = { now, QList<Particle>(), NULL };
+    if (_simulateInBatches) {
+        _simulation.simulate(now);
+        args._simulation = &_simulation;
+    }
+    bool changed = updateSubtree(getRoot(), args);
+    if (_simulateInBatches) {
+        _simulation.finish();
+    }
 
     // now add back any of the particles that moved elements....
     int movingParticles = args._movingParticles.size();
@@ -486,8 +625,14 @@ void ParticleTree::update() {
         }
     }
 
-    // prune the tree...
-    recurseTreeWithOperation(pruneOperation, NULL);
+    // only a pass that changed something needs to be persisted
+    if (changed) {
+        _isDirty = true;
+    }
+
+    _scriptStats = scriptPool->getScriptStats();
+    _lastScriptTickUsecs = scriptPool->getTickUsecs();
+    _lastDeferredScriptCount = scriptPool->getDeferredCount();
     unlock();
 }
 
@@ -649,10 +794,19 @@ void ParticleTree::processEraseMessage(const QByteArray& dataByteArray, const Sh
             dataAt += sizeof(particleID);
             processedBytes += sizeof(particleID);
 
-            args._idsToDelete.push_back(particleID);
+            ParticleTreeElement* containingElement;
+            if (lookUpParticle(ParticleID(particleID), containingElement)) {
+                if (containingElement) {
+                    containingElement->removeParticleWithID(particleID);
+                }
+            } else {
+                args._idsToDelete.push_back(particleID);
+            }
         }
 
-        // calling recurse to actually delete the particles
-        recurseTreeWithOperation(findAndDeleteOperation, &args);
+        // calling recurse to actually delete the particles the index couldn't find
+        if (!args._idsToDelete.isEmpty()) {
+            recurseTreeWithOperation(findAndDeleteOperation, &args);
+        }
     }
 }
@@ -13,6 +13,8 @@
 #define hifi_ParticleTree_h
 
 #include <Octree.h>
+#include <OctreeItemIndex.h>
+#include "ParticleScriptPool.h"
 #include "ParticleTreeElement.h"
 
 class NewlyCreatedParticleHook {
@@ -23,7 +25,10 @@ public:
 class ParticleTree : public Octree {
     Q_OBJECT
 public:
+    static const quint64 DEFAULT_SCRIPT_BUDGET_USECS = 5000; // update script time per update() before updates are deferred
+
     ParticleTree(bool shouldReaverage = false);
+    virtual ~ParticleTree();
 
     /// Implements our type specific root element factory
     virtual ParticleTreeElement* createNewElement(unsigned char * octalCode = NULL);
@@ -36,11 +41,29 @@ public:
     // own definition. Implement these to allow your octree based server to support editing
     virtual bool getWantSVOfileVersions() const { return true; }
     virtual PacketType expectedDataPacketType() const { return PacketTypeParticleData; }
+    // version 2 only changed how the sections of data packets are compressed, files hold the bitstream of version 1
+    virtual bool canProcessVersion(PacketVersion thisVersion) const { return thisVersion == 1 || thisVersion == 2; }
     virtual bool handlesEditPacketType(PacketType packetType) const;
     virtual int processEditPacketData(PacketType packetType, const unsigned char* packetData, int packetLength,
                     const unsigned char* editData, int maxLength, const SharedNodePointer& senderNode);
 
     virtual void update();
+    virtual void eraseAllOctreeElements();
+
+    /// the update script time per update(), ParticleScriptPool::NO_BUDGET to never defer update scripts
+    void setScriptBudgetUsecs(quint64 scriptBudgetUsecs) { _scriptBudgetUsecs = scriptBudgetUsecs; }
+    quint64 getScriptBudgetUsecs() const { return _scriptBudgetUsecs; }
+
+    /// whether update() integrates the particles without scripts in a ParticleSimulation batch, or runs
+    /// Particle::update() on every particle, defaults to true
+    void setSimulateInBatches(bool simulateInBatches);
+    bool getSimulateInBatches() const { return _simulateInBatches; }
+
+    /// The scripts run by the last update(). The pool that runs them belongs to the thread that calls update(), so these
+    /// are copied from it at the end of each update(), call with the tree locked for reading.
+    const QHash<QString, ParticleScriptPool::ScriptStats>& getScriptStats() const { return _scriptStats; }
+    quint64 getLastScriptTickUsecs() const { return _lastScriptTickUsecs; }
+    int getLastDeferredScriptCount() const { return _lastDeferredScriptCount; }
 
     void storeParticle(const Particle& particle, const SharedNodePointer& senderNode = SharedNodePointer());
     void updateParticle(const ParticleID& particleID, const ParticleProperties& properties);
@@ -73,14 +96,27 @@ public:
     void processEraseMessage(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode);
     void handleAddParticleResponse(const QByteArray& packet);
 
+    /// Marks element and all of its ancestors as changed, so that the encoder will descend to it, and as having
+    /// particles in their subtrees, so that update() will visit it. Called by the elements when their particles are
+    /// stored, edited or removed, since elements don't know their parents.
+    void markPathChanged(ParticleTreeElement* element);
+
+    /// Keep the index of which element holds each particle up to date, called by the elements as particles are stored in
+    /// them and taken out of them. Particles are indexed by ID once it is known, and by creator token until then.
+    void indexParticle(const Particle& particle, ParticleTreeElement* element);
+    void unindexParticle(const Particle& particle, ParticleTreeElement* element);
+
 private:
+    /// Finds the element holding a particle through the index.
+    /// \param element[out] the element holding the particle, or NULL if the particle isn't in the tree
+    /// \return false if the index can't tell, in which case the caller has to search the tree and element is NULL
+    bool lookUpParticle(const ParticleID& particleID, ParticleTreeElement*& element) const;
+    bool updateSubtree(ParticleTreeElement* element, ParticleTreeUpdateArgs& args);
 
-    static bool updateOperation(OctreeElement* element, void* extraData);
     static bool findAndUpdateOperation(OctreeElement* element, void* extraData);
     static bool findAndUpdateWithIDandPropertiesOperation(OctreeElement* element, void* extraData);
     static bool findNearPointOperation(OctreeElement* element, void* extraData);
     static bool findInSphereOperation(OctreeElement* element, void* extraData);
-    static bool pruneOperation(OctreeElement* element, void* extraData);
     static bool findByIDOperation(OctreeElement* element, void* extraData);
     static bool findAndDeleteOperation(OctreeElement* element, void* extraData);
     static bool findAndUpdateParticleIDOperation(OctreeElement* element, void* extraData);
@@ -94,6 +130,16 @@ private:
 
     QReadWriteLock _recentlyDeletedParticlesLock;
     QMultiMap<quint64, uint32_t> _recentlyDeletedParticleIDs;
+
+    OctreeItemIndex _particlesByID;
+    OctreeItemIndex _particlesByCreatorToken;
+
+    quint64 _scriptBudgetUsecs;
+    QHash<QString, ParticleScriptPool::ScriptStats> _scriptStats;
+    quint64 _lastScriptTickUsecs;
+    int _lastDeferredScriptCount;
+    bool _simulateInBatches;
+    ParticleSimulation _simulation; // the batch lives from pass to pass
 };
 
 #endif // hifi_ParticleTree_h
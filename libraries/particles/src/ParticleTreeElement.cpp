@@ -14,12 +14,25 @@
 #include "ParticleTree.h"
 #include "ParticleTreeElement.h"
 
-ParticleTreeElement::ParticleTreeElement(unsigned char* octalCode) : OctreeElement(), _particles(NULL) {
+IMPLEMENT_OCTREE_ELEMENT_POOL(ParticleTreeElement)
+
+ParticleTreeElement::ParticleTreeElement(unsigned char* octalCode) :
+    OctreeElement(),
+    _myTree(NULL),
+    _particles(NULL),
+    _hasParticlesInSubtree(false) {
     init(octalCode);
 };
 
 ParticleTreeElement::~ParticleTreeElement() {
     _voxelMemoryUsage -= sizeof(ParticleTreeElement);
+
+    // the particles go with the element, so they can't stay in the index
+    if (_myTree) {
+        for (int i = 0; i < _particles->size(); i++) {
+            _myTree->unindexParticle((*_particles)[i], this);
+        }
+    }
     QList<Particle>* tmpParticles = _particles;
     _particles = NULL;
     delete tmpParticles;
@@ -67,31 +80,54 @@ bool ParticleTreeElement::appendElementData(OctreePacketData* packetData, Encode
     return success;
 }
 
-void ParticleTreeElement::update(ParticleTreeUpdateArgs& args) {
-    markWithChangedTime();
-    // TODO: early exit when _particles is empty
+bool ParticleTreeElement::update(ParticleTreeUpdateArgs& args) {
+    if (_particles->isEmpty()) {
+        return false;
+    }
+    bool changed = false;
 
     // update our contained particles
     QList<Particle>::iterator particleItr = _particles->begin();
     while(particleItr != _particles->end()) {
         Particle& particle = (*particleItr);
-        particle.update(_lastChanged);
+        glm::vec3 oldPosition = particle.getPosition();
+        glm::vec3 oldVelocity = particle.getVelocity();
+        if (!args._simulation) {
+            particle.update(args._now);
+        } else if (!args._simulation->store(particle)) {
+            particle.update(args._now);
+            args._simulation->keep(particle);
+        }
 
         // If the particle wants to die, or if it's left our bounding box, then move it
         // into the arguments moving particles. These will be added back or deleted completely
         if (particle.getShouldDie() || !_cube.contains(particle.getPosition())) {
             args._movingParticles.push_back(particle);
+            _myTree->unindexParticle(particle, this);
+            if (args._simulation) {
+                args._simulation->remove(particle);
+            }
 
             // erase this particle
             particleItr = _particles->erase(particleItr);
+            changed = true;
         } else {
+            // particles at rest don't need to be sent again, but scripts can change any of their properties
+            if (particle.getPosition() != oldPosition || particle.getVelocity() != oldVelocity ||
+                    !particle.getScript().isEmpty()) {
+                changed = true;
+            }
             ++particleItr;
         }
     }
+    if (changed) {
+        markWithChangedTime();
+    }
     // TODO: if _particles is empty after while loop consider freeing memory in _particles if
     // internal array is too big (QList internal array does not decrease size except in dtor and
     // assignment operator).  Otherwise _particles could become a "resource leak" for large
     // roaming piles of particles.
+    return changed;
 }
 
 bool ParticleTreeElement::findSpherePenetration(const glm::vec3& center, float radius,
@@ -149,6 +185,7 @@ bool ParticleTreeElement::updateParticle(const Particle& particle) {
                             difference, debug::valueOf(particle.isNewlyCreated()) );
                 }
                 thisParticle.copyChangedProperties(particle);
+                _myTree->markPathChanged(this);
             } else {
                 if (wantDebug) {
                     qDebug(">>> IGNORING SERVER!!! Would've caused jutter! <<<  "
@@ -179,6 +216,7 @@ bool ParticleTreeElement::updateParticle(const ParticleID& particleID, const Par
         }
         if (found) {
             thisParticle.setProperties(properties);
+            _myTree->markPathChanged(this);
 
             const bool wantDebug = false;
             if (wantDebug) {
@@ -195,6 +233,7 @@ bool ParticleTreeElement::updateParticle(const ParticleID& particleID, const Par
 }
 
 void ParticleTreeElement::updateParticleID(FindAndUpdateParticleIDArgs* args) {
+    bool creatorTokenFoundHere = false;
     uint16_t numberOfParticles = _particles->size();
     for (uint16_t i = 0; i < numberOfParticles; i++) {
         Particle& thisParticle = (*_particles)[i];
@@ -202,21 +241,34 @@ void ParticleTreeElement::updateParticleID(FindAndUpdateParticleIDArgs* args) {
         if (!args->creatorTokenFound) {
             // first, we're looking for matching creatorTokenIDs, if we find that, then we fix it to know the actual ID
             if (thisParticle.getCreatorTokenID() == args->creatorTokenID) {
+                _myTree->unindexParticle(thisParticle, this);
                 thisParticle.setID(args->particleID);
                 args->creatorTokenFound = true;
+                creatorTokenFoundHere = true;
+                _myTree->markPathChanged(this);
             }
         }
         
         // if we're in an isViewing tree, we also need to look for an kill any viewed particles
         if (!args->viewedParticleFound && args->isViewing) {
             if (thisParticle.getCreatorTokenID() == UNKNOWN_TOKEN && thisParticle.getID() == args->particleID) {
+                _myTree->unindexParticle(thisParticle, this);
                 _particles->removeAt(i); // remove the particle at this index
                 numberOfParticles--; // this means we have 1 fewer particle in this list
                 i--; // and we actually want to back up i as well.
                 args->viewedParticleFound = true;
+                _myTree->markPathChanged(this);
             }
         }
     }
+
+    // index the particle by its new ID once any viewed copy of it is gone
+    if (creatorTokenFoundHere) {
+        const Particle* particle = getParticleWithID(args->particleID);
+        if (particle) {
+            _myTree->indexParticle(*particle, this);
+        }
+    }
 }
 
 
@@ -263,6 +315,18 @@ void ParticleTreeElement::getParticlesForUpdate(const AACube& box, QVector<Parti
     }
 }
 
+bool ParticleTreeElement::hasParticle(const ParticleID& particleID) const {
+    uint16_t numberOfParticles = _particles->size();
+    for (uint16_t i = 0; i < numberOfParticles; i++) {
+        const Particle& particle = (*_particles)[i];
+        if (particleID.isKnownID ? particle.getID() == particleID.id :
+                particle.getCreatorTokenID() == particleID.creatorTokenID) {
+            return true;
+        }
+    }
+    return false;
+}
+
 const Particle* ParticleTreeElement::getParticleWithID(uint32_t id) const {
     // NOTE: this lookup is O(N) but maybe we don't care? (guaranteed that num particles per elemen is small?)
     const Particle* foundParticle = NULL;
@@ -283,7 +347,9 @@ bool ParticleTreeElement::removeParticleWithID(uint32_t id) {
         for (uint16_t i = 0; i < numberOfParticles; i++) {
             if ((*_particles)[i].getID() == id) {
                 foundParticle = true;
+                _myTree->unindexParticle((*_particles)[i], this);
                 _particles->removeAt(i);
+                _myTree->markPathChanged(this);
                 break;
             }
         }
@@ -338,6 +404,7 @@ bool ParticleTreeElement::collapseChildren() {
 
 void ParticleTreeElement::storeParticle(const Particle& particle) {
     _particles->push_back(particle);
-    markWithChangedTime();
+    _myTree->indexParticle(particle, this);
+    _myTree->markPathChanged(this);
 }
 
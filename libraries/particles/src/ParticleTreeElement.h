@@ -15,9 +15,11 @@
 //#include <vector>
 
 #include <OctreeElement.h>
+#include <OctreeElementPool.h>
 #include <QList>
 
 #include "Particle.h"
+#include "ParticleSimulation.h"
 #include "ParticleTree.h"
 
 class ParticleTree;
@@ -25,7 +27,9 @@ class ParticleTreeElement;
 
 class ParticleTreeUpdateArgs {
 public:
+    quint64 _now; // the simulation time of this pass
     QList<Particle> _movingParticles;
+    ParticleSimulation* _simulation; // the batch integrated before the pass, NULL when every particle runs update()
 };
 
 class FindAndUpdateParticleIDArgs {
@@ -46,6 +50,8 @@ class ParticleTreeElement : public OctreeElement {
 
     virtual OctreeElement* createNewElement(unsigned char* octalCode = NULL);
 
+    DECLARE_OCTREE_ELEMENT_POOL()
+
 public:
     virtual ~ParticleTreeElement();
 
@@ -96,7 +102,10 @@ public:
     QList<Particle>& getParticles() { return *_particles; }
     bool hasParticles() const { return _particles->size() > 0; }
 
-    void update(ParticleTreeUpdateArgs& args);
+    /// Simulates our particles, moving the ones that die or leave our cube into args. Only marks this element as changed
+    /// if one of its particles changed.
+    /// \return true if any of our particles changed
+    bool update(ParticleTreeUpdateArgs& args);
     void setTree(ParticleTree* tree) { _myTree = tree; }
 
     bool updateParticle(const Particle& particle);
@@ -116,10 +125,18 @@ public:
     /// \param particles[out] vector of non-const Particle*
     void getParticlesForUpdate(const AACube& box, QVector<Particle*>& foundParticles);
 
+    /// \return whether we hold the particle, by ID if it is known and by creator token if not
+    bool hasParticle(const ParticleID& particleID) const;
+
     const Particle* getParticleWithID(uint32_t id) const;
 
     bool removeParticleWithID(uint32_t id);
 
+    /// Whether this element or any of its descendants might hold particles. Set on the path down to each stored particle,
+    /// and only cleared by the tree's update pass, which skips the subtrees where it is false.
+    bool hasParticlesInSubtree() const { return _hasParticlesInSubtree; }
+    void setHasParticlesInSubtree(bool hasParticlesInSubtree) { _hasParticlesInSubtree = hasParticlesInSubtree; }
+
 protected:
     virtual void init(unsigned char * octalCode);
 
@@ -127,6 +144,7 @@ protected:
 
     ParticleTree* _myTree;
     QList<Particle>* _particles;
+    bool _hasParticlesInSubtree;
 };
 
 #endif // hifi_ParticleTreeElement_h
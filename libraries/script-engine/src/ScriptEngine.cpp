@@ -348,6 +348,17 @@ QScriptValue ScriptEngine::evaluate(const QString& program, const QString& fileN
     return result;
 }
 
+QScriptValue ScriptEngine::evaluate(const QScriptProgram& program) {
+    QScriptValue result = QScriptEngine::evaluate(program);
+    if (hasUncaughtException()) {
+        int line = uncaughtExceptionLineNumber();
+        qDebug() << "Uncaught exception at (" << program.fileName() << ") line" << line << ": " << result.toString();
+    }
+    emit evaluationFinished(result, hasUncaughtException());
+    clearExceptions();
+    return result;
+}
+
 void ScriptEngine::sendAvatarIdentityPacket() {
     if (_isAvatar && _avatarData) {
         _avatarData->sendIdentityPacket();
@@ -598,8 +609,10 @@ void ScriptEngine::timerFired() {
         timerFunction.call();
     }
 
-    if (!callingTimer->isActive()) {
+    // the function may have cleared the timer itself, in which case it's already gone
+    if (_timerFunctionMap.contains(callingTimer) && !callingTimer->isActive()) {
         // this timer is done, we can kill it
+        _timerFunctionMap.remove(callingTimer);
         delete callingTimer;
     }
 }
@@ -636,6 +649,12 @@ void ScriptEngine::stopTimer(QTimer *timer) {
     }
 }
 
+void ScriptEngine::stopAllTimers() {
+    foreach (QTimer* timer, _timerFunctionMap.keys()) {
+        stopTimer(timer);
+    }
+}
+
 QUrl ScriptEngine::resolveInclude(const QString& include) const {
     // first lets check to see if it's already a full URL
     QUrl url(include);
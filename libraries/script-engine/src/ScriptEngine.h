@@ -17,6 +17,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtScript/QScriptEngine>
+#include <QtScript/QScriptProgram>
 
 #include <AnimationCache.h>
 #include <AudioScriptingInterface.h>
@@ -85,6 +86,7 @@ public:
     void init();
     void run(); /// runs continuously until Agent.stop() is called
     void evaluate(); /// initializes the engine, and evaluates the script, but then returns control to caller
+    QScriptValue evaluate(const QScriptProgram& program); /// evaluates a script that was compiled ahead of time
 
     void timerFired();
 
@@ -93,6 +95,10 @@ public:
     bool isFinished() const { return _isFinished; }
     bool isRunning() const { return _isRunning; }
 
+    /// Stops and deletes the timers set up by setInterval() and setTimeout(), for engines that run the script in calls
+    /// rather than in run() and so never emit scriptEnding.
+    void stopAllTimers();
+
 public slots:
     void stop();
 
@@ -0,0 +1,408 @@
+//
+//  AABoxTree.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+
+#include <algorithm>
+
+#include "AABoxTree.h"
+#include "SharedUtil.h"
+
+const int AABoxTree::NULL_NODE;
+
+static float getSurfaceArea(const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 size = maximum - minimum;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static bool boxesOverlap(const glm::vec3& minimumA, const glm::vec3& maximumA,
+        const glm::vec3& minimumB, const glm::vec3& maximumB) {
+    return minimumA.x <= maximumB.x && minimumB.x <= maximumA.x &&
+        minimumA.y <= maximumB.y && minimumB.y <= maximumA.y &&
+        minimumA.z <= maximumB.z && minimumB.z <= maximumA.z;
+}
+
+static bool rayHitsBox(const glm::vec3& origin, const glm::vec3& direction,
+        const glm::vec3& minimum, const glm::vec3& maximum) {
+    // clip the ray to the slab of each axis, and see if anything is left
+    float start = 0.0f;
+    float end = FLT_MAX;
+    for (int i = 0; i < 3; ++i) {
+        if (fabsf(direction[i]) < EPSILON) {
+            if (origin[i] < minimum[i] || origin[i] > maximum[i]) {
+                return false;
+            }
+            continue;
+        }
+        float inverse = 1.0f / direction[i];
+        float low = (minimum[i] - origin[i]) * inverse;
+        float high = (maximum[i] - origin[i]) * inverse;
+        if (low > high) {
+            std::swap(low, high);
+        }
+        start = glm::max(start, low);
+        end = glm::min(end, high);
+        if (start > end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AABoxTree::AABoxTree(float margin) :
+    _root(NULL_NODE),
+    _freeList(NULL_NODE),
+    _proxyCount(0),
+    _margin(margin) {
+}
+
+void AABoxTree::clear() {
+    _nodes.clear();
+    _root = NULL_NODE;
+    _freeList = NULL_NODE;
+    _proxyCount = 0;
+}
+
+int AABoxTree::insert(const glm::vec3& minimum, const glm::vec3& maximum, int data) {
+    int leaf = allocateNode();
+    Node& node = _nodes[leaf];
+    node.minimum = minimum - glm::vec3(_margin);
+    node.maximum = maximum + glm::vec3(_margin);
+    node.height = 0;
+    node.data = data;
+    insertLeaf(leaf);
+    _proxyCount++;
+    return leaf;
+}
+
+void AABoxTree::remove(int proxy) {
+    assert(_nodes[proxy].isLeaf() && _nodes[proxy].height == 0);
+    removeLeaf(proxy);
+    freeNode(proxy);
+    _proxyCount--;
+}
+
+bool AABoxTree::move(int proxy, const glm::vec3& minimum, const glm::vec3& maximum) {
+    Node& node = _nodes[proxy];
+    if (glm::all(glm::lessThanEqual(node.minimum, minimum)) && glm::all(glm::lessThanEqual(maximum, node.maximum))) {
+        // still inside its grown box
+        return false;
+    }
+    removeLeaf(proxy);
+    node.minimum = minimum - glm::vec3(_margin);
+    node.maximum = maximum + glm::vec3(_margin);
+    insertLeaf(proxy);
+    return true;
+}
+
+int AABoxTree::findOverlapping(const glm::vec3& minimum, const glm::vec3& maximum, int* overlapping,
+                               int maxOverlapping) const {
+    int count = 0;
+    if (_root == NULL_NODE) {
+        return count;
+    }
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty()) {
+        const Node& node = _nodes[_stack.back()];
+        _stack.pop_back();
+        if (!boxesOverlap(node.minimum, node.maximum, minimum, maximum)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            if (count < maxOverlapping) {
+                overlapping[count] = node.data;
+            }
+            count++;
+        } else {
+            _stack.push_back(node.child1);
+            _stack.push_back(node.child2);
+        }
+    }
+    return count;
+}
+
+int AABoxTree::findRayIntersecting(const glm::vec3& origin, const glm::vec3& direction, int* intersecting,
+                                   int maxIntersecting) const {
+    int count = 0;
+    if (_root == NULL_NODE) {
+        return count;
+    }
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty()) {
+        const Node& node = _nodes[_stack.back()];
+        _stack.pop_back();
+        if (!rayHitsBox(origin, direction, node.minimum, node.maximum)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            if (count < maxIntersecting) {
+                intersecting[count] = node.data;
+            }
+            count++;
+        } else {
+            _stack.push_back(node.child1);
+            _stack.push_back(node.child2);
+        }
+    }
+    return count;
+}
+
+void AABoxTree::findPairs(std::vector<std::pair<int, int> >& pairs) const {
+    pairs.clear();
+    int nodeCount = _nodes.size();
+    for (int leaf = 0; leaf < nodeCount; leaf++) {
+        const Node& leafNode = _nodes[leaf];
+        if (leafNode.height != 0) {
+            continue;
+        }
+        // walk the tree with the leaf's box, keeping only the pairs that the later leaf won't find again
+        _stack.clear();
+        _stack.push_back(_root);
+        while (!_stack.empty()) {
+            int index = _stack.back();
+            _stack.pop_back();
+            const Node& node = _nodes[index];
+            if (!boxesOverlap(node.minimum, node.maximum, leafNode.minimum, leafNode.maximum)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                if (index > leaf) {
+                    pairs.push_back(std::pair<int, int>(leafNode.data, node.data));
+                }
+            } else {
+                _stack.push_back(node.child1);
+                _stack.push_back(node.child2);
+            }
+        }
+    }
+}
+
+int AABoxTree::allocateNode() {
+    int index;
+    if (_freeList == NULL_NODE) {
+        index = _nodes.size();
+        _nodes.push_back(Node());
+    } else {
+        index = _freeList;
+        _freeList = _nodes[index].parent;
+    }
+    Node& node = _nodes[index];
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    node.data = -1;
+    return index;
+}
+
+void AABoxTree::freeNode(int node) {
+    _nodes[node].parent = _freeList;
+    _nodes[node].height = -1;
+    _freeList = node;
+}
+
+void AABoxTree::insertLeaf(int leaf) {
+    if (_root == NULL_NODE) {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // walk down to the sibling that makes the tree grow least, counting the growth of every ancestor on the way
+    glm::vec3 leafMinimum = _nodes[leaf].minimum;
+    glm::vec3 leafMaximum = _nodes[leaf].maximum;
+    int index = _root;
+    while (!_nodes[index].isLeaf()) {
+        const Node& node = _nodes[index];
+        float area = getSurfaceArea(node.minimum, node.maximum);
+        float combinedArea = getSurfaceArea(glm::min(node.minimum, leafMinimum), glm::max(node.maximum, leafMaximum));
+
+        // the cost of a new parent for this node and the leaf, and of pushing the leaf further down
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCosts[2];
+        int children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; i++) {
+            const Node& child = _nodes[children[i]];
+            float childArea = getSurfaceArea(glm::min(child.minimum, leafMinimum), glm::max(child.maximum, leafMaximum));
+            if (!child.isLeaf()) {
+                childArea -= getSurfaceArea(child.minimum, child.maximum);
+            }
+            childCosts[i] = childArea + inheritanceCost;
+        }
+        if (cost < childCosts[0] && cost < childCosts[1]) {
+            break;
+        }
+        index = (childCosts[0] < childCosts[1]) ? children[0] : children[1];
+    }
+    int sibling = index;
+
+    // allocating can move the nodes, so no references are held across it
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+    Node& parentNode = _nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.minimum = glm::min(_nodes[sibling].minimum, leafMinimum);
+    parentNode.maximum = glm::max(_nodes[sibling].maximum, leafMaximum);
+    parentNode.height = _nodes[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+    if (oldParent == NULL_NODE) {
+        _root = newParent;
+    } else if (_nodes[oldParent].child1 == sibling) {
+        _nodes[oldParent].child1 = newParent;
+    } else {
+        _nodes[oldParent].child2 = newParent;
+    }
+
+    refit(newParent);
+}
+
+void AABoxTree::removeLeaf(int leaf) {
+    if (leaf == _root) {
+        _root = NULL_NODE;
+        return;
+    }
+    int parent = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling = (_nodes[parent].child1 == leaf) ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    // the sibling takes the place of the parent
+    _nodes[sibling].parent = grandParent;
+    freeNode(parent);
+    if (grandParent == NULL_NODE) {
+        _root = sibling;
+        return;
+    }
+    if (_nodes[grandParent].child1 == parent) {
+        _nodes[grandParent].child1 = sibling;
+    } else {
+        _nodes[grandParent].child2 = sibling;
+    }
+    refit(grandParent);
+}
+
+void AABoxTree::refit(int node) {
+    // balance and fit every ancestor, from the node up
+    for (int index = node; index != NULL_NODE; index = _nodes[index].parent) {
+        index = balance(index);
+        Node& fitted = _nodes[index];
+        const Node& child1 = _nodes[fitted.child1];
+        const Node& child2 = _nodes[fitted.child2];
+        fitted.minimum = glm::min(child1.minimum, child2.minimum);
+        fitted.maximum = glm::max(child1.maximum, child2.maximum);
+        fitted.height = 1 + glm::max(child1.height, child2.height);
+    }
+}
+
+int AABoxTree::balance(int indexA) {
+    Node& a = _nodes[indexA];
+    if (a.isLeaf() || a.height < 2) {
+        return indexA;
+    }
+    int indexB = a.child1;
+    int indexC = a.child2;
+    Node& b = _nodes[indexB];
+    Node& c = _nodes[indexC];
+    int imbalance = c.height - b.height;
+
+    if (imbalance > 1) {
+        // rotate C up
+        int indexF = c.child1;
+        int indexG = c.child2;
+        Node& f = _nodes[indexF];
+        Node& g = _nodes[indexG];
+
+        c.child1 = indexA;
+        c.parent = a.parent;
+        a.parent = indexC;
+        if (c.parent == NULL_NODE) {
+            _root = indexC;
+        } else if (_nodes[c.parent].child1 == indexA) {
+            _nodes[c.parent].child1 = indexC;
+        } else {
+            _nodes[c.parent].child2 = indexC;
+        }
+
+        // A keeps the lower of C's children, and C the higher
+        if (f.height > g.height) {
+            c.child2 = indexF;
+            a.child2 = indexG;
+            g.parent = indexA;
+            a.minimum = glm::min(b.minimum, g.minimum);
+            a.maximum = glm::max(b.maximum, g.maximum);
+            c.minimum = glm::min(a.minimum, f.minimum);
+            c.maximum = glm::max(a.maximum, f.maximum);
+            a.height = 1 + glm::max(b.height, g.height);
+            c.height = 1 + glm::max(a.height, f.height);
+        } else {
+            c.child2 = indexG;
+            a.child2 = indexF;
+            f.parent = indexA;
+            a.minimum = glm::min(b.minimum, f.minimum);
+            a.maximum = glm::max(b.maximum, f.maximum);
+            c.minimum = glm::min(a.minimum, g.minimum);
+            c.maximum = glm::max(a.maximum, g.maximum);
+            a.height = 1 + glm::max(b.height, f.height);
+            c.height = 1 + glm::max(a.height, g.height);
+        }
+        return indexC;
+    }
+
+    if (imbalance < -1) {
+        // rotate B up
+        int indexD = b.child1;
+        int indexE = b.child2;
+        Node& d = _nodes[indexD];
+        Node& e = _nodes[indexE];
+
+        b.child1 = indexA;
+        b.parent = a.parent;
+        a.parent = indexB;
+        if (b.parent == NULL_NODE) {
+            _root = indexB;
+        } else if (_nodes[b.parent].child1 == indexA) {
+            _nodes[b.parent].child1 = indexB;
+        } else {
+            _nodes[b.parent].child2 = indexB;
+        }
+
+        if (d.height > e.height) {
+            b.child2 = indexD;
+            a.child1 = indexE;
+            e.parent = indexA;
+            a.minimum = glm::min(c.minimum, e.minimum);
+            a.maximum = glm::max(c.maximum, e.maximum);
+            b.minimum = glm::min(a.minimum, d.minimum);
+            b.maximum = glm::max(a.maximum, d.maximum);
+            a.height = 1 + glm::max(c.height, e.height);
+            b.height = 1 + glm::max(a.height, d.height);
+        } else {
+            b.child2 = indexE;
+            a.child1 = indexD;
+            d.parent = indexA;
+            a.minimum = glm::min(c.minimum, d.minimum);
+            a.maximum = glm::max(c.maximum, d.maximum);
+            b.minimum = glm::min(a.minimum, e.minimum);
+            b.maximum = glm::max(a.maximum, e.maximum);
+            a.height = 1 + glm::max(c.height, d.height);
+            b.height = 1 + glm::max(a.height, e.height);
+        }
+        return indexB;
+    }
+    return indexA;
+}
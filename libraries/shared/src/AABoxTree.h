@@ -0,0 +1,103 @@
+//
+//  AABoxTree.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A broadphase for things that move a little every frame: a dynamic bounding volume tree of axis aligned boxes.
+//  Every box is grown by a margin when it is put in the tree, and is only reinserted when what it bounds moves out of
+//  the grown box, so most frames only walk the tree rather than change it. Inserting picks the sibling that grows the
+//  surface area of the tree least, and the tree is kept balanced with rotations.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AABoxTree_h
+#define hifi_AABoxTree_h
+
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class AABoxTree {
+public:
+    static const int NULL_NODE = -1;
+
+    /// \param margin how much every box is grown by when it is put in the tree
+    AABoxTree(float margin = 0.0f);
+
+    /// Removes all boxes.
+    void clear();
+
+    /// Adds a box.
+    /// \param data the value that lookups return for this box
+    /// \return the proxy that identifies the box in the tree until it is removed
+    int insert(const glm::vec3& minimum, const glm::vec3& maximum, int data);
+
+    void remove(int proxy);
+
+    /// Moves a box.
+    /// \return true if the box left its grown box and was reinserted
+    bool move(int proxy, const glm::vec3& minimum, const glm::vec3& maximum);
+
+    void setData(int proxy, int data) { _nodes[proxy].data = data; }
+    int getData(int proxy) const { return _nodes[proxy].data; }
+
+    /// Finds the boxes whose grown boxes overlap a box.
+    /// \param overlapping[out] the data of the boxes, up to maxOverlapping of them
+    /// \return the number of boxes found, which may be more than were written
+    int findOverlapping(const glm::vec3& minimum, const glm::vec3& maximum, int* overlapping, int maxOverlapping) const;
+
+    /// Finds the boxes whose grown boxes a ray passes through.
+    /// \param intersecting[out] the data of the boxes, up to maxIntersecting of them
+    /// \return the number of boxes found, which may be more than were written
+    int findRayIntersecting(const glm::vec3& origin, const glm::vec3& direction, int* intersecting,
+                            int maxIntersecting) const;
+
+    /// Finds every pair of boxes whose grown boxes overlap, each pair once.
+    /// \param pairs[out] the data of the boxes of each pair, any initial contents are lost
+    void findPairs(std::vector<std::pair<int, int> >& pairs) const;
+
+    int getProxyCount() const { return _proxyCount; }
+
+    /// \return the number of levels below the root, 0 for an empty tree or a single box
+    int getHeight() const { return (_root == NULL_NODE) ? 0 : _nodes[_root].height; }
+
+private:
+    class Node {
+    public:
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int parent; // or the next free node, when this one is free
+        int child1;
+        int child2;
+        int height; // 0 for leaves, -1 for free nodes
+        int data;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    int allocateNode();
+    void freeNode(int node);
+
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    void refit(int node);
+
+    /// Rotates the children of an unbalanced node.
+    /// \return the node that took its place in the tree
+    int balance(int node);
+
+    std::vector<Node> _nodes;
+    int _root;
+    int _freeList;
+    int _proxyCount;
+    float _margin;
+
+    // reused by the lookups, which is why only one thread at a time may search a tree
+    mutable std::vector<int> _stack;
+};
+
+#endif // hifi_AABoxTree_h
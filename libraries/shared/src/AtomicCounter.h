@@ -0,0 +1,41 @@
+//
+//  AtomicCounter.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A 64-bit count that any thread can add to without locking. Counters have no constructor, so that static ones are
+//  zero before any static constructor uses them. Counters that are members must be reset() by their owner.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AtomicCounter_h
+#define hifi_AtomicCounter_h
+
+#include <QtCore/QAtomicInteger>
+
+class AtomicCounter {
+public:
+    void add(qint64 amount) { _value.fetchAndAddRelaxed(amount); }
+
+    void operator++(int) { add(1); }
+    void operator--(int) { add(-1); }
+    void operator+=(qint64 amount) { add(amount); }
+    void operator-=(qint64 amount) { add(-amount); }
+
+    /// \return the sum of everything added since the last reset
+    qint64 get() const { return _value.load(); }
+
+    void reset() { _value.store(0); }
+
+    /// Resets the counter without losing what other threads add meanwhile.
+    /// \return the sum of everything added since the last reset
+    qint64 take() { return _value.fetchAndStoreRelaxed(0); }
+
+private:
+    QBasicAtomicInteger<qint64> _value;
+};
+
+#endif // hifi_AtomicCounter_h
@@ -0,0 +1,211 @@
+//
+//  ColoredConstraintSolver.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <math.h>
+
+#include <glm/glm.hpp>
+
+#include "ColoredConstraintSolver.h"
+
+#include "DistanceConstraint.h"
+#include "Lanes.h"
+#include "SharedUtil.h" // for EPSILON
+#include "VerletPoint.h"
+
+// a point remembers the colors of its constraints in the bits of a mask
+const int MAX_CONSTRAINT_COLORS = 32;
+
+ColoredConstraintSolver::ColoredConstraintSolver() :
+    _pointData(NULL),
+    _numPoints(0),
+    _numConstraints(0),
+    _isValid(false) {
+}
+
+bool ColoredConstraintSolver::build(const QVector<VerletPoint>& points, const QVector<DistanceConstraint*>& constraints) {
+    clear();
+    _pointData = points.constData();
+    _numPoints = points.size();
+    _numConstraints = constraints.size();
+
+    // give each constraint the lowest color that neither of its points has yet
+    std::vector<quint32> pointColors(_numPoints, 0);
+    std::vector<int> constraintColors(_numConstraints);
+    std::vector<int> colorCounts(MAX_CONSTRAINT_COLORS, 0);
+    int numColors = 0;
+    for (int i = 0; i < _numConstraints; ++i) {
+        int start = constraints[i]->getPoint(0) - _pointData;
+        int end = constraints[i]->getPoint(1) - _pointData;
+        if (start < 0 || start >= _numPoints || end < 0 || end >= _numPoints || start == end) {
+            // the constraint isn't between two points of the array
+            clearColors();
+            return false;
+        }
+        quint32 usedColors = pointColors[start] | pointColors[end];
+        int color = 0;
+        while (color < MAX_CONSTRAINT_COLORS && (usedColors & (1U << color))) {
+            ++color;
+        }
+        if (color == MAX_CONSTRAINT_COLORS) {
+            clearColors();
+            return false;
+        }
+        pointColors[start] |= (1U << color);
+        pointColors[end] |= (1U << color);
+        constraintColors[i] = color;
+        ++colorCounts[color];
+        numColors = glm::max(numColors, color + 1);
+    }
+
+    // sort the constraints by color, keeping their order within each color
+    _colorStarts.resize(numColors + 1);
+    _colorStarts[0] = 0;
+    for (int i = 0; i < numColors; ++i) {
+        _colorStarts[i + 1] = _colorStarts[i] + colorCounts[i];
+    }
+    std::vector<int> nextIndices(_colorStarts.begin(), _colorStarts.end() - 1);
+    _startIndices.resize(_numConstraints);
+    _endIndices.resize(_numConstraints);
+    _distances.resize(_numConstraints);
+    for (int i = 0; i < _numConstraints; ++i) {
+        int j = nextIndices[constraintColors[i]]++;
+        _startIndices[j] = constraints[i]->getPoint(0) - _pointData;
+        _endIndices[j] = constraints[i]->getPoint(1) - _pointData;
+        _distances[j] = constraints[i]->getDistance();
+    }
+    _x.resize(_numPoints);
+    _y.resize(_numPoints);
+    _z.resize(_numPoints);
+    _isValid = true;
+    return true;
+}
+
+void ColoredConstraintSolver::clear() {
+    _pointData = NULL;
+    _numPoints = 0;
+    _numConstraints = 0;
+    clearColors();
+}
+
+// forgets the coloring but not what it was for, so that a failed build isn't tried again until the constraints change
+void ColoredConstraintSolver::clearColors() {
+    _isValid = false;
+    _startIndices.clear();
+    _endIndices.clear();
+    _distances.clear();
+    _colorStarts.clear();
+}
+
+bool ColoredConstraintSolver::isBuiltFor(const QVector<VerletPoint>& points, int numConstraints) const {
+    return _pointData == points.constData() && _numPoints == points.size() && _numConstraints == numConstraints;
+}
+
+// this is DistanceConstraint::enforce() on the arrays
+static float relaxConstraint(float* x, float* y, float* z, int a, int b, float distance) {
+    float dx = x[a] - x[b];
+    float dy = y[a] - y[b];
+    float dz = z[a] - z[b];
+    float newDistance = sqrtf(dx * dx + dy * dy + dz * dz);
+    float directionX = 0.0f;
+    float directionY = 1.0f;
+    float directionZ = 0.0f;
+    if (newDistance > EPSILON) {
+        float inverseDistance = 1.0f / newDistance;
+        directionX = dx * inverseDistance;
+        directionY = dy * inverseDistance;
+        directionZ = dz * inverseDistance;
+    }
+    float halfDistance = 0.5f * distance;
+    float centerX = 0.5f * (x[a] + x[b]);
+    float centerY = 0.5f * (y[a] + y[b]);
+    float centerZ = 0.5f * (z[a] + z[b]);
+    x[a] = centerX + halfDistance * directionX;
+    y[a] = centerY + halfDistance * directionY;
+    z[a] = centerZ + halfDistance * directionZ;
+    x[b] = centerX - halfDistance * directionX;
+    y[b] = centerY - halfDistance * directionY;
+    z[b] = centerZ - halfDistance * directionZ;
+    return fabsf(newDistance - distance);
+}
+
+float ColoredConstraintSolver::enforce(QVector<VerletPoint>& points) {
+    assert(_isValid && isBuiltFor(points, _numConstraints));
+    if (_numConstraints == 0) {
+        return 0.0f;
+    }
+    VerletPoint* pointData = points.data();
+    for (int i = 0; i < _numPoints; ++i) {
+        const glm::vec3& position = pointData[i]._position;
+        _x[i] = position.x;
+        _y[i] = position.y;
+        _z[i] = position.z;
+    }
+    float* x = &(_x[0]);
+    float* y = &(_y[0]);
+    float* z = &(_z[0]);
+
+    float maxDistance = 0.0f;
+    Lanes maxDistances = Lanes::splat(0.0f);
+    Lanes zero = Lanes::splat(0.0f);
+    Lanes half = Lanes::splat(0.5f);
+    Lanes one = Lanes::splat(1.0f);
+    Lanes epsilon = Lanes::splat(EPSILON);
+    int numColors = getColorCount();
+    for (int color = 0; color < numColors; ++color) {
+        // no two constraints of a color touch the same point, so four of them can be gathered, relaxed and scattered back
+        // at once, which is relaxConstraint() in each lane
+        int i = _colorStarts[color];
+        int end = _colorStarts[color + 1];
+        for (; i + LANE_COUNT <= end; i += LANE_COUNT) {
+            const int* a = &(_startIndices[i]);
+            const int* b = &(_endIndices[i]);
+            Lanes ax = Lanes::gather(x, a);
+            Lanes ay = Lanes::gather(y, a);
+            Lanes az = Lanes::gather(z, a);
+            Lanes bx = Lanes::gather(x, b);
+            Lanes by = Lanes::gather(y, b);
+            Lanes bz = Lanes::gather(z, b);
+            Lanes dx = ax - bx;
+            Lanes dy = ay - by;
+            Lanes dz = az - bz;
+            Lanes newDistance = (dx * dx + dy * dy + dz * dz).sqrt();
+
+            // the lanes whose points are on top of each other are pushed apart along y
+            Lanes isApart = newDistance.greaterThan(epsilon);
+            Lanes inverseDistance = one / newDistance.max(epsilon);
+            Lanes directionX = Lanes::select(isApart, dx * inverseDistance, zero);
+            Lanes directionY = Lanes::select(isApart, dy * inverseDistance, one);
+            Lanes directionZ = Lanes::select(isApart, dz * inverseDistance, zero);
+
+            Lanes distance = Lanes::load(&(_distances[i]));
+            Lanes halfDistance = half * distance;
+            Lanes centerX = half * (ax + bx);
+            Lanes centerY = half * (ay + by);
+            Lanes centerZ = half * (az + bz);
+            (centerX + halfDistance * directionX).scatter(x, a);
+            (centerY + halfDistance * directionY).scatter(y, a);
+            (centerZ + halfDistance * directionZ).scatter(z, a);
+            (centerX - halfDistance * directionX).scatter(x, b);
+            (centerY - halfDistance * directionY).scatter(y, b);
+            (centerZ - halfDistance * directionZ).scatter(z, b);
+            maxDistances = maxDistances.max((newDistance - distance).abs());
+        }
+        for (; i < end; ++i) {
+            maxDistance = glm::max(maxDistance, relaxConstraint(x, y, z, _startIndices[i], _endIndices[i], _distances[i]));
+        }
+    }
+    maxDistance = glm::max(maxDistance, maxDistances.getMax());
+
+    for (int i = 0; i < _numPoints; ++i) {
+        pointData[i]._position = glm::vec3(x[i], y[i], z[i]);
+    }
+    return maxDistance;
+}
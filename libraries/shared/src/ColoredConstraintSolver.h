@@ -0,0 +1,71 @@
+//
+//  ColoredConstraintSolver.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Enforces the DistanceConstraints of a Ragdoll a color at a time, where no two constraints of a color share a point.
+//  The constraints of a color don't depend on each other, so they're relaxed four at a time, with the points copied into
+//  separate arrays of x, y and z while they're relaxed. Between colors it's still Gauss-Seidel, so it converges at about
+//  the rate of enforcing the constraints one after another.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ColoredConstraintSolver_h
+#define hifi_ColoredConstraintSolver_h
+
+#include <vector>
+
+#include <QVector>
+
+class DistanceConstraint;
+class VerletPoint;
+
+class ColoredConstraintSolver {
+public:
+    ColoredConstraintSolver();
+
+    /// Colors constraints, which must all be between points of the given array. The distances of the constraints are
+    /// copied, so the solver must be built again after they change. A build that fails is still built for the points and
+    /// constraints, so that callers that check isBuiltFor() don't try again until they change.
+    /// \return true if the constraints could be colored
+    bool build(const QVector<VerletPoint>& points, const QVector<DistanceConstraint*>& constraints);
+
+    void clear();
+
+    /// \return true if the solver was built for these points and this many constraints, whether or not they were colored
+    bool isBuiltFor(const QVector<VerletPoint>& points, int numConstraints) const;
+
+    /// \return true if the constraints were colored, so that enforce() can be used
+    bool isValid() const { return _isValid; }
+
+    /// Enforces every constraint once.
+    /// \return max distance of point movement
+    float enforce(QVector<VerletPoint>& points);
+
+    int getConstraintCount() const { return _distances.size(); }
+    int getColorCount() const { return (int)_colorStarts.size() - 1; }
+
+private:
+    void clearColors();
+
+    const VerletPoint* _pointData;
+    int _numPoints;
+    int _numConstraints;
+    bool _isValid;
+
+    // the constraints, sorted by color
+    std::vector<int> _startIndices;
+    std::vector<int> _endIndices;
+    std::vector<float> _distances;
+    std::vector<int> _colorStarts; // the first constraint of each color, then the number of constraints
+
+    // the positions of the points while they're relaxed
+    std::vector<float> _x;
+    std::vector<float> _y;
+    std::vector<float> _z;
+};
+
+#endif // hifi_ColoredConstraintSolver_h
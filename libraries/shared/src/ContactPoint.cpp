@@ -29,6 +29,29 @@ ContactPoint::ContactPoint(const CollisionInfo& collision, quint32 frame) :
         _offsetA(0.0f), _offsetB(0.0f), 
         _relativeMassA(0.5f), _relativeMassB(0.5f), 
         _numPointsA(0), _numPoints(0), _normal(0.0f) {
+    reset(collision, frame);
+}
+
+// empties a list without giving back its memory, which QVector::clear() would
+template <typename T>
+static void clearKeepingCapacity(QVector<T>& list) {
+    // a QVector with reserved capacity doesn't shrink when it is resized
+    list.reserve(list.capacity());
+    list.resize(0);
+}
+
+void ContactPoint::reset(const CollisionInfo& collision, quint32 frame) {
+    _lastFrame = frame;
+    _shapeA = collision.getShapeA();
+    _shapeB = collision.getShapeB();
+    _offsetA = glm::vec3(0.0f);
+    _offsetB = glm::vec3(0.0f);
+    _relativeMassA = 0.5f;
+    _relativeMassB = 0.5f;
+    _normal = glm::vec3(0.0f);
+    clearKeepingCapacity(_points);
+    clearKeepingCapacity(_offsets);
+    clearKeepingCapacity(_distances);
 
     glm::vec3 pointA = collision._contactPoint;
     glm::vec3 pointB = collision._contactPoint - collision._penetration;
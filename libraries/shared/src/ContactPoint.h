@@ -25,6 +25,9 @@ public:
     ContactPoint();
     ContactPoint(const CollisionInfo& collision, quint32 frame);
 
+    /// Makes this the contact for another collision, reusing the memory of its lists.
+    void reset(const CollisionInfo& collision, quint32 frame);
+
     virtual float enforce();
 
     void applyFriction();
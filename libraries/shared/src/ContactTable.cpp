@@ -0,0 +1,133 @@
+//
+//  ContactTable.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+
+#include <glm/glm.hpp>
+
+#include "ContactTable.h"
+
+const int MIN_BUCKET_COUNT = 64;
+
+ContactTable::ContactTable() :
+    _bucketMask(0),
+    _size(0) {
+}
+
+ContactPoint* ContactTable::find(quint64 key) {
+    if (_size == 0 || key == 0) {
+        return NULL;
+    }
+    const Bucket& bucket = _buckets[findBucket(key)];
+    return (bucket.key == key) ? &(_slots[bucket.slot]) : NULL;
+}
+
+ContactPoint& ContactTable::insert(quint64 key, const CollisionInfo& collision, quint32 frame) {
+    assert(key != 0);
+    // keep the table at most half full, so that the walks stay short
+    if ((_size + 1) * 2 > (int)_buckets.size()) {
+        grow();
+    }
+    int bucket = findBucket(key);
+    assert(_buckets[bucket].key == 0);
+
+    int slot;
+    if (_freeSlots.empty()) {
+        slot = _slots.size();
+        _slots.push_back(ContactPoint(collision, frame));
+        _slotKeys.push_back(key);
+    } else {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+        _slots[slot].reset(collision, frame);
+        _slotKeys[slot] = key;
+    }
+    _buckets[bucket].key = key;
+    _buckets[bucket].slot = slot;
+    ++_size;
+    return _slots[slot];
+}
+
+void ContactTable::remove(quint64 key) {
+    if (_size == 0 || key == 0) {
+        return;
+    }
+    int hole = findBucket(key);
+    if (_buckets[hole].key != key) {
+        return;
+    }
+    int slot = _buckets[hole].slot;
+    _slotKeys[slot] = 0;
+    _freeSlots.push_back(slot);
+    --_size;
+
+    // shift back the entries after the hole that can't be found past it, rather than leaving a marker
+    int bucket = hole;
+    while (true) {
+        bucket = (bucket + 1) & _bucketMask;
+        quint64 bucketKey = _buckets[bucket].key;
+        if (bucketKey == 0) {
+            break;
+        }
+        // the entry stays if its home is cyclically in (hole, bucket]
+        int home = getHomeBucket(bucketKey);
+        bool stays = (hole <= bucket) ? (hole < home && home <= bucket) : (hole < home || home <= bucket);
+        if (!stays) {
+            _buckets[hole] = _buckets[bucket];
+            hole = bucket;
+        }
+    }
+    _buckets[hole].key = 0;
+}
+
+void ContactTable::clear() {
+    int numBuckets = _buckets.size();
+    for (int i = 0; i < numBuckets; ++i) {
+        _buckets[i].key = 0;
+    }
+    _freeSlots.clear();
+    int numSlots = _slotKeys.size();
+    for (int i = numSlots - 1; i >= 0; --i) {
+        _slotKeys[i] = 0;
+        _freeSlots.push_back(i);
+    }
+    _size = 0;
+}
+
+int ContactTable::getHomeBucket(quint64 key) const {
+    // the keys are pairs of small IDs, which multiplying by a large odd constant spreads over the high bits
+    const quint64 MULTIPLIER = Q_UINT64_C(0x9E3779B97F4A7C15);
+    return (int)((key * MULTIPLIER) >> 32) & _bucketMask;
+}
+
+int ContactTable::findBucket(quint64 key) const {
+    int bucket = getHomeBucket(key);
+    while (_buckets[bucket].key != key && _buckets[bucket].key != 0) {
+        bucket = (bucket + 1) & _bucketMask;
+    }
+    return bucket;
+}
+
+void ContactTable::grow() {
+    int numBuckets = glm::max(MIN_BUCKET_COUNT, (int)_buckets.size() * 2);
+    Bucket emptyBucket = { 0, 0 };
+    _buckets.assign(numBuckets, emptyBucket);
+    _bucketMask = numBuckets - 1;
+
+    // the contacts keep their slots, so only the buckets are rebuilt
+    int numSlots = _slotKeys.size();
+    for (int i = 0; i < numSlots; ++i) {
+        if (_slotKeys[i] != 0) {
+            Bucket& bucket = _buckets[findBucket(_slotKeys[i])];
+            bucket.key = _slotKeys[i];
+            bucket.slot = i;
+        }
+    }
+}
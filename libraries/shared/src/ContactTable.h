@@ -0,0 +1,79 @@
+//
+//  ContactTable.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  The ContactPoints of a PhysicsSimulation, keyed by the pair of shapes that touch. Keys are found in an open addressed
+//  hash table, so that a lookup is a short walk through an array rather than through a tree. The contacts themselves
+//  live in slots that don't move until they're removed, and removed slots are reused, so a simulation whose contacts
+//  come and go at a steady rate doesn't allocate.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ContactTable_h
+#define hifi_ContactTable_h
+
+#include <vector>
+
+#include <QtGlobal>
+
+#include "ContactPoint.h"
+
+class ContactTable {
+public:
+    ContactTable();
+
+    /// \return the contact for key, or NULL if there is none. Valid until the next insert.
+    ContactPoint* find(quint64 key);
+
+    /// Adds a contact for collision, whose shapes must not have one yet.
+    /// \param key the shape pair key of collision, which can't be 0
+    ContactPoint& insert(quint64 key, const CollisionInfo& collision, quint32 frame);
+
+    /// Removes the contact for key, if there is one.
+    void remove(quint64 key);
+
+    /// Removes all contacts, keeping the memory for reuse.
+    void clear();
+
+    int size() const { return _size; }
+    bool isEmpty() const { return _size == 0; }
+
+    /// Contacts can be walked by slot. Removing a contact, even while walking, doesn't change the slots of the others.
+    /// \return the number of slots, some of which may be empty
+    int getSlotCount() const { return _slotKeys.size(); }
+
+    /// \return the key of the contact in a slot, or 0 if the slot is empty
+    quint64 getKey(int slot) const { return _slotKeys[slot]; }
+
+    ContactPoint& getContact(int slot) { return _slots[slot]; }
+
+    void removeSlot(int slot) { remove(_slotKeys[slot]); }
+
+private:
+    class Bucket {
+    public:
+        quint64 key; // 0 for empty buckets
+        int slot;
+    };
+
+    int getHomeBucket(quint64 key) const;
+
+    /// \return the bucket that holds key, or the empty bucket where it would go
+    int findBucket(quint64 key) const;
+
+    void grow();
+
+    std::vector<Bucket> _buckets;
+    int _bucketMask;
+    int _size;
+
+    std::vector<ContactPoint> _slots;
+    std::vector<quint64> _slotKeys;
+    std::vector<int> _freeSlots;
+};
+
+#endif // hifi_ContactTable_h
@@ -23,6 +23,7 @@ public:
     float enforce();
     void setDistance(float distance);
     float getDistance() const { return _distance; }
+    VerletPoint* getPoint(int index) const { return _points[index]; }
 private:
     float _distance;
     VerletPoint* _points[2];
@@ -0,0 +1,307 @@
+//
+//  Lanes.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Four floats that are worked on together, with SSE where the compiler has it. shared is also built for ARM, where there
+//  is no SSE, so there the lanes fall back to plain floats. Comparisons give masks with every bit of a lane set where the
+//  comparison holds, which select() and the bitwise operators use to branch per lane.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Lanes_h
+#define hifi_Lanes_h
+
+#include <math.h>
+#include <string.h>
+
+#include <QtGlobal>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define LANES_SSE
+#include <xmmintrin.h>
+#endif
+
+const int LANE_COUNT = 4;
+
+class Lanes {
+public:
+    Lanes() { }
+
+    static Lanes load(const float* values);
+    static Lanes splat(float value);
+
+    /// \return the values at the given indices
+    static Lanes gather(const float* values, const int* indices);
+
+    void store(float* values) const;
+
+    /// Stores each lane at its index, which must all differ.
+    void scatter(float* values, const int* indices) const;
+
+    Lanes operator+(const Lanes& other) const;
+    Lanes operator-(const Lanes& other) const;
+    Lanes operator*(const Lanes& other) const;
+    Lanes operator/(const Lanes& other) const;
+
+    Lanes min(const Lanes& other) const;
+    Lanes max(const Lanes& other) const;
+    Lanes clamp(const Lanes& lower, const Lanes& upper) const { return max(lower).min(upper); }
+    Lanes abs() const;
+    Lanes sqrt() const;
+
+    /// \return the largest of the lanes
+    float getMax() const;
+
+    Lanes lessThan(const Lanes& other) const;
+    Lanes lessEqual(const Lanes& other) const;
+    Lanes greaterThan(const Lanes& other) const { return other.lessThan(*this); }
+    Lanes greaterEqual(const Lanes& other) const { return other.lessEqual(*this); }
+
+    Lanes operator&(const Lanes& mask) const;
+    Lanes operator|(const Lanes& mask) const;
+
+    /// \return the lanes of this mask that aren't set in the other
+    Lanes andNot(const Lanes& mask) const;
+
+    /// \return a bit for each lane of a mask, set if the lane is set
+    int getBits() const;
+
+    /// \return the lanes of ifTrue where the mask is set, and of ifFalse elsewhere
+    static Lanes select(const Lanes& mask, const Lanes& ifTrue, const Lanes& ifFalse) {
+        return (ifTrue & mask) | ifFalse.andNot(mask);
+    }
+
+private:
+#ifdef LANES_SSE
+    Lanes(__m128 values) : _values(values) { }
+
+    __m128 _values;
+#else
+    static quint32 toBits(float value) {
+        quint32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static float fromBits(quint32 bits) {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    static float toMask(bool isSet) { return fromBits(isSet ? 0xFFFFFFFF : 0); }
+
+    float _values[LANE_COUNT];
+#endif
+};
+
+#ifdef LANES_SSE
+
+inline Lanes Lanes::load(const float* values) { return _mm_loadu_ps(values); }
+inline Lanes Lanes::splat(float value) { return _mm_set1_ps(value); }
+
+inline Lanes Lanes::gather(const float* values, const int* indices) {
+    return _mm_setr_ps(values[indices[0]], values[indices[1]], values[indices[2]], values[indices[3]]);
+}
+
+inline void Lanes::store(float* values) const { _mm_storeu_ps(values, _values); }
+
+inline void Lanes::scatter(float* values, const int* indices) const {
+    float lanes[LANE_COUNT];
+    store(lanes);
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        values[indices[i]] = lanes[i];
+    }
+}
+
+inline Lanes Lanes::operator+(const Lanes& other) const { return _mm_add_ps(_values, other._values); }
+inline Lanes Lanes::operator-(const Lanes& other) const { return _mm_sub_ps(_values, other._values); }
+inline Lanes Lanes::operator*(const Lanes& other) const { return _mm_mul_ps(_values, other._values); }
+inline Lanes Lanes::operator/(const Lanes& other) const { return _mm_div_ps(_values, other._values); }
+
+inline Lanes Lanes::min(const Lanes& other) const { return _mm_min_ps(_values, other._values); }
+inline Lanes Lanes::max(const Lanes& other) const { return _mm_max_ps(_values, other._values); }
+inline Lanes Lanes::abs() const { return _mm_andnot_ps(_mm_set1_ps(-0.0f), _values); }
+inline Lanes Lanes::sqrt() const { return _mm_sqrt_ps(_values); }
+
+inline float Lanes::getMax() const {
+    __m128 pairs = _mm_max_ps(_values, _mm_movehl_ps(_values, _values));
+    return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+inline Lanes Lanes::lessThan(const Lanes& other) const { return _mm_cmplt_ps(_values, other._values); }
+inline Lanes Lanes::lessEqual(const Lanes& other) const { return _mm_cmple_ps(_values, other._values); }
+
+inline Lanes Lanes::operator&(const Lanes& mask) const { return _mm_and_ps(_values, mask._values); }
+inline Lanes Lanes::operator|(const Lanes& mask) const { return _mm_or_ps(_values, mask._values); }
+inline Lanes Lanes::andNot(const Lanes& mask) const { return _mm_andnot_ps(mask._values, _values); }
+
+inline int Lanes::getBits() const { return _mm_movemask_ps(_values); }
+
+#else
+
+inline Lanes Lanes::load(const float* values) {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = values[i];
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::splat(float value) {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = value;
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::gather(const float* values, const int* indices) {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = values[indices[i]];
+    }
+    return lanes;
+}
+
+inline void Lanes::store(float* values) const {
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        values[i] = _values[i];
+    }
+}
+
+inline void Lanes::scatter(float* values, const int* indices) const {
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        values[indices[i]] = _values[i];
+    }
+}
+
+inline Lanes Lanes::operator+(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = _values[i] + other._values[i];
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::operator-(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = _values[i] - other._values[i];
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::operator*(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = _values[i] * other._values[i];
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::operator/(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = _values[i] / other._values[i];
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::min(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = (_values[i] < other._values[i]) ? _values[i] : other._values[i];
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::max(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = (_values[i] > other._values[i]) ? _values[i] : other._values[i];
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::abs() const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = fabsf(_values[i]);
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::sqrt() const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = sqrtf(_values[i]);
+    }
+    return lanes;
+}
+
+inline float Lanes::getMax() const {
+    float result = _values[0];
+    for (int i = 1; i < LANE_COUNT; ++i) {
+        result = (_values[i] > result) ? _values[i] : result;
+    }
+    return result;
+}
+
+inline Lanes Lanes::lessThan(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = toMask(_values[i] < other._values[i]);
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::lessEqual(const Lanes& other) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = toMask(_values[i] <= other._values[i]);
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::operator&(const Lanes& mask) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = fromBits(toBits(_values[i]) & toBits(mask._values[i]));
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::operator|(const Lanes& mask) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = fromBits(toBits(_values[i]) | toBits(mask._values[i]));
+    }
+    return lanes;
+}
+
+inline Lanes Lanes::andNot(const Lanes& mask) const {
+    Lanes lanes;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        lanes._values[i] = fromBits(toBits(_values[i]) & ~toBits(mask._values[i]));
+    }
+    return lanes;
+}
+
+inline int Lanes::getBits() const {
+    int bits = 0;
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        if (toBits(_values[i]) >> 31) {
+            bits |= (1 << i);
+        }
+    }
+    return bits;
+}
+
+#endif // def LANES_SSE
+
+#endif // hifi_Lanes_h
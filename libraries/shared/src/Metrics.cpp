@@ -0,0 +1,405 @@
+//
+//  Metrics.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QGlobalStatic>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadStorage>
+
+#include "Metrics.h"
+
+// the registry is made by the first metric that needs it, which may be a static that is made before main
+static QMutex& getRegistryMutex() {
+    static QMutex mutex(QMutex::Recursive);
+    return mutex;
+}
+
+static QMap<QString, Metric*>& getRegistry() {
+    static QMap<QString, Metric*> registry;
+    return registry;
+}
+
+// threads take the shards in turn, so that a few threads each have a shard to themselves
+static QBasicAtomicInt nextShard = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QThreadStorage<int> threadShards;
+
+Metric::Metric(const QString& name) :
+    _name(name) {
+}
+
+Metric::~Metric() {
+}
+
+int Metric::getShard() {
+    if (!threadShards.hasLocalData()) {
+        threadShards.setLocalData(nextShard.fetchAndAddRelaxed(1) % METRIC_SHARD_COUNT);
+    }
+    return threadShards.localData();
+}
+
+MetricCounter::MetricCounter(const QString& name) :
+    Metric(name) {
+    reset();
+    Metrics::addMetric(this);
+}
+
+MetricCounter::~MetricCounter() {
+    Metrics::removeMetric(this);
+}
+
+qint64 MetricCounter::getValue() const {
+    qint64 value = 0;
+    for (int i = 0; i < METRIC_SHARD_COUNT; ++i) {
+        value += _shards[i * METRIC_COUNTERS_PER_CACHE_LINE].get();
+    }
+    return value;
+}
+
+void MetricCounter::reset() {
+    for (int i = 0; i < METRIC_SHARD_COUNT; ++i) {
+        _shards[i * METRIC_COUNTERS_PER_CACHE_LINE].reset();
+    }
+}
+
+void MetricCounter::addToJson(QJsonObject& object, const QString& prefix) {
+    object[prefix] = (double)getValue();
+}
+
+QString MetricCounter::getStatsString() {
+    return QString("%1: %2").arg(getName()).arg(getValue());
+}
+
+MetricGauge::MetricGauge(const QString& name) :
+    Metric(name),
+    _value(0) {
+    Metrics::addMetric(this);
+}
+
+MetricGauge::~MetricGauge() {
+    Metrics::removeMetric(this);
+}
+
+void MetricGauge::addToJson(QJsonObject& object, const QString& prefix) {
+    object[prefix] = getValue();
+}
+
+QString MetricGauge::getStatsString() {
+    return QString("%1: %2").arg(getName()).arg(getValue());
+}
+
+qint64 MetricHistogramSnapshot::getCount() const {
+    qint64 count = 0;
+    for (int i = 0; i < counts.size(); ++i) {
+        count += counts.at(i);
+    }
+    return count;
+}
+
+qint64 MetricHistogramSnapshot::getSum() const {
+    qint64 sum = 0;
+    for (int i = 0; i < sums.size(); ++i) {
+        sum += sums.at(i);
+    }
+    return sum;
+}
+
+float MetricHistogramSnapshot::getMean() const {
+    qint64 count = getCount();
+    return (count == 0) ? 0.0f : (float)((double)getSum() / count);
+}
+
+int MetricHistogramSnapshot::getPercentile(float fraction) const {
+    qint64 count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+    qint64 rank = qMax((qint64)1, (qint64)(fraction * count + 0.5f));
+    qint64 passed = 0;
+    for (int i = 0; i < bounds.size(); ++i) {
+        passed += counts.at(i);
+        if (passed >= rank) {
+            return qMin(bounds.at(i), max);
+        }
+    }
+    return max;
+}
+
+qint64 MetricHistogramSnapshot::getCount(int lower, int upper) const {
+    qint64 count = 0;
+    for (int i = getBucket(lower) + 1, end = getBucket(upper); i <= end; ++i) {
+        count += counts.at(i);
+    }
+    return count;
+}
+
+qint64 MetricHistogramSnapshot::getSum(int lower, int upper) const {
+    qint64 sum = 0;
+    for (int i = getBucket(lower) + 1, end = getBucket(upper); i <= end; ++i) {
+        sum += sums.at(i);
+    }
+    return sum;
+}
+
+float MetricHistogramSnapshot::getMean(int lower, int upper) const {
+    qint64 count = getCount(lower, upper);
+    return (count == 0) ? 0.0f : (float)((double)getSum(lower, upper) / count);
+}
+
+void MetricHistogramSnapshot::add(const MetricHistogramSnapshot& other) {
+    if (counts.isEmpty()) {
+        *this = other;
+        return;
+    }
+    for (int i = 0; i < counts.size() && i < other.counts.size(); ++i) {
+        counts[i] += other.counts.at(i);
+        sums[i] += other.sums.at(i);
+    }
+    max = qMax(max, other.max);
+}
+
+int MetricHistogramSnapshot::getBucket(int bound) const {
+    if (bound < 0) {
+        return -1;
+    }
+    int bucket = std::lower_bound(bounds.constBegin(), bounds.constEnd(), bound) - bounds.constBegin();
+    if (bucket == bounds.size() || bounds.at(bucket) != bound) {
+        qDebug() << "MetricHistogramSnapshot: " << bound << " is not a bound of the histogram";
+    }
+    return bucket;
+}
+
+static QVector<int> makeLatencyBounds() {
+    QVector<int> bounds;
+    const int MAX_LATENCY = 1000000;
+    const int STEPS[] = { 1, 2, 5 };
+    bounds.append(0);
+    for (int power = 1; power <= MAX_LATENCY; power *= 10) {
+        for (int i = 0; i < 3 && STEPS[i] * power <= MAX_LATENCY; ++i) {
+            bounds.append(STEPS[i] * power);
+        }
+    }
+    return bounds;
+}
+
+// histograms can be made on any thread, Q_GLOBAL_STATIC makes the bounds exactly once
+Q_GLOBAL_STATIC_WITH_ARGS(QVector<int>, latencyBounds, (makeLatencyBounds()))
+
+const QVector<int>& MetricHistogram::getLatencyBounds() {
+    return *latencyBounds();
+}
+
+MetricHistogram::MetricHistogram(const QString& name, const QVector<int>& bounds) :
+    Metric(name),
+    _bounds(bounds),
+    _max(0),
+    _intervalStartCounts(bounds.size() + 1, 0),
+    _intervalStartSums(bounds.size() + 1, 0),
+    _intervalMax(0) {
+
+    // round the shards up to whole cache lines
+    int numBuckets = bounds.size() + 1;
+    _stride = (numBuckets * 2 + METRIC_COUNTERS_PER_CACHE_LINE - 1) / METRIC_COUNTERS_PER_CACHE_LINE *
+        METRIC_COUNTERS_PER_CACHE_LINE;
+    _shards = new AtomicCounter[METRIC_SHARD_COUNT * _stride];
+    for (int i = 0; i < METRIC_SHARD_COUNT * _stride; ++i) {
+        _shards[i].reset();
+    }
+    Metrics::addMetric(this);
+}
+
+MetricHistogram::~MetricHistogram() {
+    Metrics::removeMetric(this);
+    delete[] _shards;
+}
+
+void MetricHistogram::record(int value) {
+    value = qMax(0, value);
+    int bucket = std::lower_bound(_bounds.constBegin(), _bounds.constEnd(), value) - _bounds.constBegin();
+    int numBuckets = _bounds.size() + 1;
+    int shardIndex = getShard();
+    AtomicCounter* shard = _shards + shardIndex * _stride;
+
+    shard[bucket]++;
+    shard[numBuckets + bucket] += value;
+
+    QAtomicInt& max = _shardMaxes[shardIndex * METRIC_INTS_PER_CACHE_LINE];
+    int oldMax = max.load();
+    while (value > oldMax && !max.testAndSetRelaxed(oldMax, value)) {
+        oldMax = max.load();
+    }
+}
+
+MetricHistogramSnapshot MetricHistogram::getSnapshot() {
+    QMutexLocker locker(&getRegistryMutex());
+    MetricHistogramSnapshot snapshot;
+    snapshot.bounds = _bounds;
+    sumShards(snapshot.counts, snapshot.sums);
+    snapshot.max = _max;
+    return snapshot;
+}
+
+MetricHistogramSnapshot MetricHistogram::takeIntervalSnapshot() {
+    QMutexLocker locker(&getRegistryMutex());
+    QVector<qint64> counts;
+    QVector<qint64> sums;
+    sumShards(counts, sums);
+    MetricHistogramSnapshot snapshot;
+    snapshot.bounds = _bounds;
+    snapshot.counts.resize(counts.size());
+    snapshot.sums.resize(sums.size());
+    for (int i = 0; i < counts.size(); ++i) {
+        snapshot.counts[i] = counts.at(i) - _intervalStartCounts.at(i);
+        snapshot.sums[i] = sums.at(i) - _intervalStartSums.at(i);
+    }
+    snapshot.max = _intervalMax;
+
+    _intervalStartCounts = counts;
+    _intervalStartSums = sums;
+    _intervalMax = 0;
+    return snapshot;
+}
+
+void MetricHistogram::reset() {
+    QMutexLocker locker(&getRegistryMutex());
+    for (int i = 0; i < METRIC_SHARD_COUNT * _stride; ++i) {
+        _shards[i].reset();
+    }
+    for (int i = 0; i < METRIC_SHARD_COUNT; ++i) {
+        _shardMaxes[i * METRIC_INTS_PER_CACHE_LINE].fetchAndStoreRelaxed(0);
+    }
+    _max = 0;
+    _intervalStartCounts.fill(0);
+    _intervalStartSums.fill(0);
+    _intervalMax = 0;
+}
+
+void MetricHistogram::addToJson(QJsonObject& object, const QString& prefix) {
+    MetricHistogramSnapshot snapshot = getSnapshot();
+    object[prefix + "_count"] = (double)snapshot.getCount();
+    object[prefix + "_mean"] = snapshot.getMean();
+    object[prefix + "_p50"] = snapshot.getPercentile(0.5f);
+    object[prefix + "_p90"] = snapshot.getPercentile(0.9f);
+    object[prefix + "_p99"] = snapshot.getPercentile(0.99f);
+    object[prefix + "_max"] = snapshot.max;
+}
+
+QString MetricHistogram::getStatsString() {
+    MetricHistogramSnapshot snapshot = getSnapshot();
+    return QString("%1: count: %2 mean: %3 p50: %4 p90: %5 p99: %6 max: %7").arg(getName())
+        .arg(snapshot.getCount()).arg(snapshot.getMean(), 0, 'f', 2).arg(snapshot.getPercentile(0.5f))
+        .arg(snapshot.getPercentile(0.9f)).arg(snapshot.getPercentile(0.99f)).arg(snapshot.max);
+}
+
+void MetricHistogram::sumShards(QVector<qint64>& counts, QVector<qint64>& sums) {
+    int numBuckets = _bounds.size() + 1;
+    counts.fill(0, numBuckets);
+    sums.fill(0, numBuckets);
+    for (int i = 0; i < METRIC_SHARD_COUNT; ++i) {
+        const AtomicCounter* shard = _shards + i * _stride;
+        for (int j = 0; j < numBuckets; ++j) {
+            counts[j] += shard[j].get();
+            sums[j] += shard[numBuckets + j].get();
+        }
+        // the maximum of an interval can't be told from a running maximum, so the shards' are taken
+        int shardMax = _shardMaxes[i * METRIC_INTS_PER_CACHE_LINE].fetchAndStoreRelaxed(0);
+        _max = qMax(_max, shardMax);
+        _intervalMax = qMax(_intervalMax, shardMax);
+    }
+}
+
+MetricHistogramWindow::MetricHistogramWindow(MetricHistogram& histogram, int numIntervals) :
+    _histogram(histogram),
+    _maxIntervals(numIntervals) {
+}
+
+void MetricHistogramWindow::endInterval() {
+    _lastInterval = _histogram.takeIntervalSnapshot();
+    _intervals.append(_lastInterval);
+    if (_intervals.size() > _maxIntervals) {
+        _intervals.removeFirst();
+    }
+}
+
+void MetricHistogramWindow::clear() {
+    _intervals.clear();
+    _lastInterval = MetricHistogramSnapshot();
+}
+
+MetricHistogramSnapshot MetricHistogramWindow::getWindow() const {
+    MetricHistogramSnapshot window;
+    foreach (const MetricHistogramSnapshot& interval, _intervals) {
+        window.add(interval);
+    }
+    return window;
+}
+
+QStringList Metrics::getNames(const QString& prefix) {
+    QMutexLocker locker(&getRegistryMutex());
+    QStringList names;
+    foreach (Metric* metric, getRegistry()) {
+        if (metric->getName().startsWith(prefix)) {
+            names.append(metric->getName());
+        }
+    }
+    return names;
+}
+
+void Metrics::resetAll(const QString& prefix) {
+    QMutexLocker locker(&getRegistryMutex());
+    foreach (Metric* metric, getRegistry()) {
+        if (metric->getName().startsWith(prefix)) {
+            metric->reset();
+        }
+    }
+}
+
+void Metrics::addToStats(QJsonObject& statsObject, const QStringList& names) {
+    QMutexLocker locker(&getRegistryMutex());
+    const QMap<QString, Metric*>& registry = getRegistry();
+    foreach (const QString& name, names) {
+        Metric* metric = registry.value(name);
+        if (metric) {
+            metric->addToJson(statsObject, "metric/" + name);
+        }
+    }
+}
+
+QString Metrics::getStatsString(const QString& prefix) {
+    QMutexLocker locker(&getRegistryMutex());
+    QString statsString;
+    foreach (Metric* metric, getRegistry()) {
+        if (metric->getName().startsWith(prefix)) {
+            statsString += metric->getStatsString() + "\r\n";
+        }
+    }
+    return statsString;
+}
+
+void Metrics::addMetric(Metric* metric) {
+    QMutexLocker locker(&getRegistryMutex());
+    QMap<QString, Metric*>& registry = getRegistry();
+    if (registry.contains(metric->getName())) {
+        qDebug() << "Metrics: there is already a metric called " << metric->getName();
+        return;
+    }
+    registry.insert(metric->getName(), metric);
+}
+
+void Metrics::removeMetric(Metric* metric) {
+    QMutexLocker locker(&getRegistryMutex());
+    QMap<QString, Metric*>& registry = getRegistry();
+    QMap<QString, Metric*>::iterator it = registry.find(metric->getName());
+    if (it != registry.end() && it.value() == metric) {
+        registry.erase(it);
+    }
+}
@@ -0,0 +1,213 @@
+//
+//  Metrics.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Counters, gauges and latency histograms that any thread can update without locking, and that are named in one
+//  registry so that they can all be reported together. Each metric keeps a shard of its values for every few threads, so
+//  that threads updating the same metric don't fight over a cache line. The shards are AtomicCounters, and reading a
+//  metric sums them.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Metrics_h
+#define hifi_Metrics_h
+
+#include <QAtomicInt>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "AtomicCounter.h"
+
+const int METRIC_SHARD_COUNT = 16;
+const int METRIC_CACHE_LINE_SIZE = 64;
+const int METRIC_COUNTERS_PER_CACHE_LINE = METRIC_CACHE_LINE_SIZE / sizeof(AtomicCounter);
+const int METRIC_INTS_PER_CACHE_LINE = METRIC_CACHE_LINE_SIZE / sizeof(int);
+
+/// A named value that is reported with all the others in the registry. Metrics are usually statics. Each kind of metric
+/// adds itself to the registry at the end of its constructor and removes itself at the start of its destructor, so that
+/// the registry never reports one that is partly made.
+class Metric {
+public:
+    Metric(const QString& name);
+    virtual ~Metric();
+
+    const QString& getName() const { return _name; }
+
+    /// Sets the value of the metric back to where it started.
+    virtual void reset() = 0;
+
+    /// Adds the value of the metric to object, as one or more properties whose names start with prefix.
+    virtual void addToJson(QJsonObject& object, const QString& prefix) = 0;
+
+    /// \return the value of the metric on one line
+    virtual QString getStatsString() = 0;
+
+protected:
+    /// \return the shard for the current thread
+    static int getShard();
+
+private:
+    QString _name;
+};
+
+/// A count of events, such as packets sent.
+class MetricCounter : public Metric {
+public:
+    MetricCounter(const QString& name);
+    virtual ~MetricCounter();
+
+    void increment(int amount = 1) { _shards[getShard() * METRIC_COUNTERS_PER_CACHE_LINE].add(amount); }
+
+    qint64 getValue() const;
+
+    virtual void reset();
+    virtual void addToJson(QJsonObject& object, const QString& prefix);
+    virtual QString getStatsString();
+
+private:
+    AtomicCounter _shards[METRIC_SHARD_COUNT * METRIC_COUNTERS_PER_CACHE_LINE];
+};
+
+/// The latest value of a level, such as the length of a queue. Gauges are set rather than added to, so they aren't
+/// sharded.
+class MetricGauge : public Metric {
+public:
+    MetricGauge(const QString& name);
+    virtual ~MetricGauge();
+
+    void setValue(int value) { _value.fetchAndStoreRelaxed(value); }
+    void addToValue(int amount) { _value.fetchAndAddRelaxed(amount); }
+    int getValue() const { return _value.load(); }
+
+    virtual void reset() { setValue(0); }
+    virtual void addToJson(QJsonObject& object, const QString& prefix);
+    virtual QString getStatsString();
+
+private:
+    QAtomicInt _value;
+};
+
+/// The counts, sums and maximum of the values recorded by a MetricHistogram.
+class MetricHistogramSnapshot {
+public:
+    MetricHistogramSnapshot() : max(0) { }
+
+    QVector<int> bounds;
+    QVector<qint64> counts; // one more than the bounds, for the values above the last bound
+    QVector<qint64> sums;
+    int max;
+
+    qint64 getCount() const;
+    qint64 getSum() const;
+    float getMean() const;
+
+    /// \return the upper bound of the bucket that holds the given fraction of the values, or the maximum if that's smaller
+    int getPercentile(float fraction) const;
+
+    /// The values in (lower, upper], where each of lower and upper must be one of the bounds, and lower can be -1 for none.
+    qint64 getCount(int lower, int upper) const;
+    qint64 getSum(int lower, int upper) const;
+    float getMean(int lower, int upper) const;
+
+    /// Adds the values of another snapshot of the same histogram, such as the one of the following interval.
+    void add(const MetricHistogramSnapshot& other);
+
+private:
+    int getBucket(int bound) const;
+};
+
+/// Counts values, usually times in usecs, in fixed buckets, so that it can report their mean and percentiles without
+/// keeping them. Each bucket also keeps the sum of its values, so that the mean of any range of buckets is exact.
+class MetricHistogram : public Metric {
+public:
+    /// Times from 0 to 1 second in usecs, with bounds at 1, 2 and 5 times each power of ten.
+    static const QVector<int>& getLatencyBounds();
+
+    /// \param bounds the inclusive upper bound of each bucket, in increasing order; larger values go in one more
+    MetricHistogram(const QString& name, const QVector<int>& bounds = getLatencyBounds());
+    virtual ~MetricHistogram();
+
+    void record(int value);
+
+    MetricHistogramSnapshot getSnapshot();
+
+    /// \return the values recorded since the last call, or since the histogram was made or reset. The histogram keeps all
+    /// of its values, so the intervals are only for one reader, such as the owner's once a second statistics.
+    MetricHistogramSnapshot takeIntervalSnapshot();
+
+    virtual void reset();
+    virtual void addToJson(QJsonObject& object, const QString& prefix);
+    virtual QString getStatsString();
+
+private:
+    /// Sums the shards into counts and sums, and takes the maximums of the shards into _max and _intervalMax. Called with
+    /// the registry locked.
+    void sumShards(QVector<qint64>& counts, QVector<qint64>& sums);
+
+    QVector<int> _bounds;
+    int _stride; // the counters in each shard: the counts, then the sums
+    AtomicCounter* _shards;
+    QAtomicInt _shardMaxes[METRIC_SHARD_COUNT * METRIC_INTS_PER_CACHE_LINE];
+
+    int _max;
+
+    QVector<qint64> _intervalStartCounts;
+    QVector<qint64> _intervalStartSums;
+    int _intervalMax;
+};
+
+/// The values that a histogram recorded in each of its latest intervals, such as the last second and the last 30 seconds.
+class MetricHistogramWindow {
+public:
+    MetricHistogramWindow(MetricHistogram& histogram, int numIntervals);
+
+    /// Takes the interval that just ended from the histogram, dropping the oldest if the window is full.
+    void endInterval();
+
+    /// Drops every interval, such as after the histogram is reset.
+    void clear();
+
+    /// \return the values of the interval that ended last
+    const MetricHistogramSnapshot& getLastInterval() const { return _lastInterval; }
+
+    /// \return the values of all intervals in the window
+    MetricHistogramSnapshot getWindow() const;
+
+    /// \return the intervals in the window, which can be fewer than its length until it fills
+    int getNumIntervals() const { return _intervals.size(); }
+
+private:
+    MetricHistogram& _histogram;
+    int _maxIntervals;
+    QList<MetricHistogramSnapshot> _intervals;
+    MetricHistogramSnapshot _lastInterval;
+};
+
+/// The registry of all metrics.
+class Metrics {
+public:
+    /// \return the names of the metrics that start with prefix, in order
+    static QStringList getNames(const QString& prefix = QString());
+
+    /// Sets the metrics whose names start with prefix back to where they started.
+    static void resetAll(const QString& prefix = QString());
+
+    /// Adds the values of the named metrics to the stats that an assignment sends to the domain server.
+    static void addToStats(QJsonObject& statsObject, const QStringList& names);
+
+    /// \return the values of every metric whose name starts with prefix, one per line
+    static QString getStatsString(const QString& prefix = QString());
+
+    // for Metric
+    static void addMetric(Metric* metric);
+    static void removeMetric(Metric* metric);
+};
+
+#endif // hifi_Metrics_h
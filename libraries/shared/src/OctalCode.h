@@ -35,6 +35,10 @@ const int UNKNOWN_OCTCODE_LENGTH = -2;
 /// \param int maxBytes number of bytes that octalCode is expected to be, -1 if unknown
 int numberOfThreeBitSectionsInCode(const unsigned char* octalCode, int maxBytes = UNKNOWN_OCTCODE_LENGTH);
 
+/// \return the branch (0 to 7) that octalCode takes at section
+char getOctalCodeSectionValue(const unsigned char* octalCode, int section);
+void setOctalCodeSectionValue(unsigned char* octalCode, int section, char sectionValue);
+
 unsigned char* chopOctalCode(const unsigned char* originalOctalCode, int chopLevels);
 unsigned char* rebaseOctalCode(const unsigned char* originalOctalCode, const unsigned char* newParentOctalCode, 
                                bool includeColorSpace = false);
@@ -72,44 +72,3 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
         _expiry = now + STALE_STAT_PERIOD;
     }
 }
-
-// ----------------------------------------------------------------------------
-// PerformanceTimer
-// ----------------------------------------------------------------------------
-
-QString PerformanceTimer::_fullName;
-QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
-
-
-PerformanceTimer::~PerformanceTimer() {
-    quint64 elapsedusec = (usecTimestampNow() - _start);
-    PerformanceTimerRecord& namedRecord = _records[_fullName];
-    namedRecord.accumulateResult(elapsedusec);
-    _fullName.resize(_fullName.size() - (_name.size() + 1));
-}
-
-// static 
-void PerformanceTimer::tallyAllTimerRecords() {
-    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
-    QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
-    quint64 now = usecTimestampNow();
-    while (recordsItr != recordsEnd) {
-        recordsItr.value().tallyResult(now);
-        if (recordsItr.value().isStale(now)) {
-            // purge stale records
-            recordsItr = _records.erase(recordsItr);
-        } else {
-            ++recordsItr;
-        }
-    }
-}
-
-void PerformanceTimer::dumpAllTimerRecords() {
-    QMapIterator<QString, PerformanceTimerRecord> i(_records);
-    while (i.hasNext()) {
-        i.next();
-        qDebug() << i.key() << ": average " << i.value().getAverage() 
-            << " [" << i.value().getMovingAverage() << "]"
-            << "usecs over" << i.value().getCount() << "calls";
-    }
-}
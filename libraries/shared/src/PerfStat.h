@@ -70,30 +70,5 @@ private:
     SimpleMovingAverage _movingAverage;
 };
 
-class PerformanceTimer {
-public:
-
-    PerformanceTimer(const QString& name) :
-        _start(0),
-        _name(name) {
-            _fullName.append("/");
-            _fullName.append(_name);
-            _start = usecTimestampNow();
-        }
-        
-    ~PerformanceTimer();
-    
-    static const PerformanceTimerRecord& getTimerRecord(const QString& name) { return _records[name]; };
-    static const QMap<QString, PerformanceTimerRecord>& getAllTimerRecords() { return _records; };
-    static void tallyAllTimerRecords();
-    static void dumpAllTimerRecords();
-
-private:
-    quint64 _start;
-    QString _name;
-    static QString _fullName;
-    static QMap<QString, PerformanceTimerRecord> _records;
-};
-
 
 #endif // hifi_PerfStat_h
@@ -9,20 +9,28 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "PhysicsEntity.h"
 
+#include "CapsuleShape.h"
 #include "PhysicsSimulation.h"
 #include "PlaneShape.h"
 #include "Shape.h"
 #include "ShapeCollider.h"
 #include "SphereShape.h"
 
+// how much the boxes in the shape tree are grown by, so that joints that move a little don't change the tree
+const float SHAPE_TREE_MARGIN = 0.05f;
+
 PhysicsEntity::PhysicsEntity() : 
     _translation(0.0f), 
     _rotation(), 
     _boundingRadius(0.0f), 
     _shapesAreDirty(true),
     _enableShapes(false),
+    _shapeTree(SHAPE_TREE_MARGIN),
+    _shapeTreeIsValid(false),
     _simulation(NULL) {
 }
 
@@ -74,13 +82,99 @@ void PhysicsEntity::clearShapes() {
         delete _shapes[i];
     }
     _shapes.clear();
+
+    _shapeTree.clear();
+    _shapeProxies.clear();
+    _unboundedShapes.clear();
+    _shapeTreeIsValid = false;
 }
 
-bool PhysicsEntity::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance) const {
+/// \return false if the shape has no bounds that the shape tree can hold
+static bool getShapeBox(const Shape* shape, glm::vec3& minimum, glm::vec3& maximum) {
+    int type = shape->getType();
+    if (type == SPHERE_SHAPE) {
+        glm::vec3 extent(static_cast<const SphereShape*>(shape)->getRadius());
+        minimum = shape->getTranslation() - extent;
+        maximum = shape->getTranslation() + extent;
+        return true;
+    }
+    if (type == CAPSULE_SHAPE) {
+        const CapsuleShape* capsule = static_cast<const CapsuleShape*>(shape);
+        glm::vec3 startPoint, endPoint;
+        capsule->getStartPoint(startPoint);
+        capsule->getEndPoint(endPoint);
+        glm::vec3 extent(capsule->getRadius());
+        minimum = glm::min(startPoint, endPoint) - extent;
+        maximum = glm::max(startPoint, endPoint) + extent;
+        return true;
+    }
+    return false;
+}
+
+void PhysicsEntity::updateShapeTree() {
     int numShapes = _shapes.size();
+    if (!_shapeTreeIsValid || (int)_shapeProxies.size() != numShapes) {
+        _shapeTree.clear();
+        _shapeProxies.assign(numShapes, AABoxTree::NULL_NODE);
+        _shapeTreeIsValid = true;
+    }
+    _unboundedShapes.clear();
+    for (int i = 0; i < numShapes; ++i) {
+        const Shape* shape = _shapes.at(i);
+        int& proxy = _shapeProxies[i];
+        glm::vec3 minimum, maximum;
+        if (!(shape && getShapeBox(shape, minimum, maximum))) {
+            if (proxy != AABoxTree::NULL_NODE) {
+                _shapeTree.remove(proxy);
+                proxy = AABoxTree::NULL_NODE;
+            }
+            if (shape) {
+                _unboundedShapes.push_back(i);
+            }
+            continue;
+        }
+        if (proxy == AABoxTree::NULL_NODE) {
+            proxy = _shapeTree.insert(minimum, maximum, i);
+        } else {
+            _shapeTree.move(proxy, minimum, maximum);
+        }
+    }
+}
+
+int PhysicsEntity::addUnboundedShapes(int numFound, int* foundShapes) const {
+    int numUnbounded = _unboundedShapes.size();
+    if (numFound + numUnbounded > MAX_FOUND_SHAPES) {
+        return ALL_SHAPES;
+    }
+    std::copy(_unboundedShapes.begin(), _unboundedShapes.end(), foundShapes + numFound);
+    return numFound + numUnbounded;
+}
+
+int PhysicsEntity::findShapes(const Shape* shape, int* foundShapes) const {
+    glm::vec3 minimum, maximum;
+    if (!(hasShapeTree() && getShapeBox(shape, minimum, maximum))) {
+        return ALL_SHAPES;
+    }
+    int numFound = addUnboundedShapes(_shapeTree.findOverlapping(minimum, maximum, foundShapes, MAX_FOUND_SHAPES),
+                                      foundShapes);
+    if (numFound != ALL_SHAPES) {
+        // collisions are found in the order of the shapes, as they would be without the tree
+        std::sort(foundShapes, foundShapes + numFound);
+    }
+    return numFound;
+}
+
+bool PhysicsEntity::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance) const {
+    int foundShapes[MAX_FOUND_SHAPES];
+    int numFound = ALL_SHAPES;
+    if (hasShapeTree()) {
+        numFound = addUnboundedShapes(_shapeTree.findRayIntersecting(origin, direction, foundShapes, MAX_FOUND_SHAPES),
+                                      foundShapes);
+    }
+    int numShapes = (numFound == ALL_SHAPES) ? _shapes.size() : numFound;
     float minDistance = FLT_MAX;
     for (int j = 0; j < numShapes; ++j) {
-        const Shape* shape = _shapes[j];
+        const Shape* shape = _shapes[(numFound == ALL_SHAPES) ? j : foundShapes[j]];
         float thisDistance = FLT_MAX;
         if (shape && shape->findRayIntersection(origin, direction, thisDistance)) {
             if (thisDistance < minDistance) {
@@ -97,15 +191,17 @@ bool PhysicsEntity::findRayIntersection(const glm::vec3& origin, const glm::vec3
 
 bool PhysicsEntity::findCollisions(const QVector<const Shape*> shapes, CollisionList& collisions) {
     bool collided = false;
+    int foundShapes[MAX_FOUND_SHAPES];
     int numTheirShapes = shapes.size();
     for (int i = 0; i < numTheirShapes; ++i) {
         const Shape* theirShape = shapes[i];
         if (!theirShape) {
             continue;
         }
-        int numOurShapes = _shapes.size();
+        int numFound = findShapes(theirShape, foundShapes);
+        int numOurShapes = (numFound == ALL_SHAPES) ? _shapes.size() : numFound;
         for (int j = 0; j < numOurShapes; ++j) {
-            const Shape* ourShape = _shapes.at(j);
+            const Shape* ourShape = _shapes.at((numFound == ALL_SHAPES) ? j : foundShapes[j]);
             if (ourShape && ShapeCollider::collideShapes(theirShape, ourShape, collisions)) {
                 collided = true;
             }
@@ -117,7 +213,11 @@ bool PhysicsEntity::findCollisions(const QVector<const Shape*> shapes, Collision
 bool PhysicsEntity::findSphereCollisions(const glm::vec3& sphereCenter, float sphereRadius, CollisionList& collisions) {
     bool collided = false;
     SphereShape sphere(sphereRadius, sphereCenter);
-    for (int i = 0; i < _shapes.size(); i++) {
+    int foundShapes[MAX_FOUND_SHAPES];
+    int numFound = findShapes(&sphere, foundShapes);
+    int numShapes = (numFound == ALL_SHAPES) ? _shapes.size() : numFound;
+    for (int j = 0; j < numShapes; j++) {
+        int i = (numFound == ALL_SHAPES) ? j : foundShapes[j];
         Shape* shape = _shapes[i];
         if (!shape) {
             continue;
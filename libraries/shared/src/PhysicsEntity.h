@@ -12,12 +12,15 @@
 #ifndef hifi_PhysicsEntity_h
 #define hifi_PhysicsEntity_h
 
+#include <vector>
+
 #include <QVector>
 #include <QSet>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include "AABoxTree.h"
 #include "CollisionInfo.h"
 
 class Shape;
@@ -26,6 +29,10 @@ class PhysicsSimulation;
 // PhysicsEntity is the base class for anything that owns one or more Shapes that collide in a 
 // PhysicsSimulation.  Each CollisionInfo generated by a PhysicsSimulation has back pointers to the 
 // two Shapes involved, and those Shapes may (optionally) have valid back pointers to their PhysicsEntity.
+//
+// The find methods search a tree of the boxes around the shapes, rather than testing every shape, once the tree has been
+// fit to the shapes by updateShapeTree(). The searches reuse a stack that belongs to the tree, so only one thread at a time
+// may call the find methods of an entity that has a tree, even the const ones.
 
 class PhysicsEntity {
 
@@ -50,6 +57,11 @@ public:
 
     PhysicsSimulation* getSimulation() const { return _simulation; }
 
+    /// Fits the tree that the find methods search to where the shapes are now. Call it once a frame, after the shapes
+    /// move, since the finds may miss shapes that have moved since. Until the first call, and after the shapes are
+    /// cleared, the find methods test every shape.
+    void updateShapeTree();
+
     bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance) const;
     bool findCollisions(const QVector<const Shape*> shapes, CollisionList& collisions);
     bool findSphereCollisions(const glm::vec3& sphereCenter, float sphereRadius, CollisionList& collisions);
@@ -70,6 +82,28 @@ protected:
     QSet<int> _disabledCollisions;
 
 private:
+    /// \return true if the tree has been fit to the shapes, and they haven't been replaced since
+    bool hasShapeTree() const { return _shapeTreeIsValid && (int)_shapeProxies.size() == _shapes.size(); }
+
+    /// the most shapes that a find lists, on the stack so that finds don't allocate
+    static const int MAX_FOUND_SHAPES = 64;
+    static const int ALL_SHAPES = -1;
+
+    /// Finds the indices of the shapes that may touch shape, in order, along with all unbounded shapes.
+    /// \param foundShapes[out] room for MAX_FOUND_SHAPES indices
+    /// \return the number of shapes found, or ALL_SHAPES if every shape must be tested, because there is no tree or more
+    /// shapes were found than fit
+    int findShapes(const Shape* shape, int* foundShapes) const;
+
+    /// Adds the unbounded shapes to the numFound shapes that the tree found.
+    /// \return the number of shapes found, or ALL_SHAPES if they don't all fit
+    int addUnboundedShapes(int numFound, int* foundShapes) const;
+
+    AABoxTree _shapeTree;
+    std::vector<int> _shapeProxies; // the proxy of each shape in _shapeTree, or AABoxTree::NULL_NODE if it has none
+    std::vector<int> _unboundedShapes; // the shapes that the tree can't hold, such as planes, which every find tests
+    bool _shapeTreeIsValid;
+
     // PhysicsSimulation is a friend so that it can set the protected _simulation backpointer
     friend class PhysicsSimulation; 
     PhysicsSimulation* _simulation;
@@ -0,0 +1,134 @@
+//
+//  PhysicsIsland.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "PhysicsIsland.h"
+
+#include "ContactPoint.h"
+#include "Profiler.h"
+#include "Ragdoll.h"
+#include "Shape.h"
+#include "SharedUtil.h"
+
+const int MAX_COLLISIONS_PER_ISLAND = 256;
+
+// compares the keys of contact entries, for binary searches
+static bool contactKeyLessThan(const std::pair<quint64, ContactPoint*>& entry, quint64 key) {
+    return entry.first < key;
+}
+
+PhysicsIsland::PhysicsIsland() :
+    _collisions(MAX_COLLISIONS_PER_ISLAND),
+    _frame(0),
+    _iterations(0),
+    _error(0.0f) {
+}
+
+void PhysicsIsland::clear(quint32 frame) {
+    _ragdolls.clear();
+    _pairs.clear();
+    _contacts.clear();
+    _collisions.clear();
+    _frame = frame;
+    _iterations = 0;
+    _error = 0.0f;
+}
+
+void PhysicsIsland::stepForward(float minError, int maxIterations, quint64 expiry) {
+    PROFILE_SCOPE("island");
+
+    // contacts are looked up by key, and enforced in order of key so the results don't depend on the order they were added
+    std::sort(_contacts.begin(), _contacts.end());
+    enforceContacts();
+    enforceConstraints();
+
+    quint64 now = usecTimestampNow();
+    do {
+        computeCollisions();
+        updateContacts();
+        resolveCollisions();
+        _error = enforceConstraints();
+        applyContactFriction();
+        ++_iterations;
+
+        now = usecTimestampNow();
+    } while (_collisions.size() != 0 && (_iterations < maxIterations) && (_error > minError) && (now < expiry));
+}
+
+void PhysicsIsland::enforceContacts() {
+    int numContacts = _contacts.size();
+    for (int i = 0; i < numContacts; ++i) {
+        _contacts[i].second->enforce();
+    }
+}
+
+float PhysicsIsland::enforceConstraints() {
+    float error = 0.0f;
+    int numDolls = _ragdolls.size();
+    for (int i = 0; i < numDolls; ++i) {
+        error = glm::max(error, _ragdolls[i]->enforceConstraints());
+    }
+    return error;
+}
+
+void PhysicsIsland::computeCollisions() {
+    _collisions.clear();
+    _pairs.collide(_collisions);
+}
+
+void PhysicsIsland::updateContacts() {
+    // only the contacts the island was given are updated here, the PhysicsSimulation adds new ones after the step
+    int numCollisions = _collisions.size();
+    for (int i = 0; i < numCollisions; ++i) {
+        CollisionInfo* collision = _collisions.getCollision(i);
+        quint64 key = collision->getShapePairKey();
+        if (key == 0) {
+            continue;
+        }
+        std::vector<ContactEntry>::iterator itr = std::lower_bound(_contacts.begin(), _contacts.end(), key,
+            contactKeyLessThan);
+        if (itr != _contacts.end() && itr->first == key) {
+            itr->second->updateContact(*collision, _frame);
+        }
+    }
+}
+
+void PhysicsIsland::resolveCollisions() {
+    // walk all collisions, accumulate movement on shapes, and build a list of affected shapes
+    _movedShapes.clear();
+    int numCollisions = _collisions.size();
+    for (int i = 0; i < numCollisions; ++i) {
+        CollisionInfo* collision = _collisions.getCollision(i);
+        collision->apply();
+        // there is always a shapeA
+        _movedShapes.push_back(collision->getShapeA());
+        // but need to check for valid shapeB
+        if (collision->_shapeB) {
+            _movedShapes.push_back(collision->getShapeB());
+        }
+    }
+    // walk all affected shapes, once each, and apply accumulated movement
+    std::sort(_movedShapes.begin(), _movedShapes.end());
+    _movedShapes.erase(std::unique(_movedShapes.begin(), _movedShapes.end()), _movedShapes.end());
+    int numShapes = _movedShapes.size();
+    for (int i = 0; i < numShapes; ++i) {
+        _movedShapes[i]->applyAccumulatedDelta();
+    }
+}
+
+void PhysicsIsland::applyContactFriction() {
+    int numContacts = _contacts.size();
+    for (int i = 0; i < numContacts; ++i) {
+        _contacts[i].second->applyFriction();
+    }
+}
@@ -0,0 +1,81 @@
+//
+//  PhysicsIsland.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A group of ragdolls that may touch each other this frame, and everything they may touch, which can be solved
+//  without looking at the rest of the PhysicsSimulation. Islands share nothing that they move, so different islands can
+//  be stepped on different threads at the same time. Shapes without VerletPoints don't move, and may be in any number
+//  of islands.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsIsland_h
+#define hifi_PhysicsIsland_h
+
+#include <utility>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "CollisionInfo.h"
+#include "ShapePairBatch.h"
+
+class ContactPoint;
+class Ragdoll;
+class Shape;
+
+class PhysicsIsland {
+public:
+    PhysicsIsland();
+
+    /// Empties the island for a new frame, keeping the capacity of its lists.
+    void clear(quint32 frame);
+
+    void addRagdoll(Ragdoll* doll) { _ragdolls.push_back(doll); }
+
+    /// Adds a pair of shapes that may collide.
+    void addPair(const Shape* shapeA, const Shape* shapeB) { _pairs.addPair(shapeA, shapeB); }
+
+    /// Adds an existing contact between shapes of the island. Contacts can be added in any order.
+    void addContact(quint64 key, ContactPoint* contact) { _contacts.push_back(ContactEntry(key, contact)); }
+
+    int getPairCount() const { return _pairs.size(); }
+
+    /// Enforces the contacts and constraints, then collides, resolves and enforces again until the island settles or
+    /// runs out of iterations or time. Only touches the island, so may be called from any thread.
+    /// \param minError constraint motion below this value is considered "close enough"
+    /// \param maxIterations max number of iterations before giving up
+    /// \param expiry the time to give up at, in usecs, which may be the largest quint64 for never
+    void stepForward(float minError, int maxIterations, quint64 expiry);
+
+    /// \return the collisions of the last iteration, including those that have no contact yet
+    CollisionList& getCollisions() { return _collisions; }
+
+    int getIterations() const { return _iterations; }
+    float getError() const { return _error; }
+
+private:
+    typedef std::pair<quint64, ContactPoint*> ContactEntry;
+
+    void enforceContacts();
+    float enforceConstraints();
+    void computeCollisions();
+    void updateContacts();
+    void resolveCollisions();
+    void applyContactFriction();
+
+    std::vector<Ragdoll*> _ragdolls;
+    ShapePairBatch _pairs;
+    std::vector<ContactEntry> _contacts;
+    std::vector<Shape*> _movedShapes;
+    CollisionList _collisions;
+    quint32 _frame;
+    int _iterations;
+    float _error;
+};
+
+#endif // hifi_PhysicsIsland_h
@@ -9,24 +9,41 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <glm/glm.hpp>
 
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
 #include "PhysicsSimulation.h"
 
-#include "PerfStat.h"
 #include "PhysicsEntity.h"
+#include "PhysicsIsland.h"
+#include "Profiler.h"
 #include "Ragdoll.h"
 #include "Shape.h"
-#include "ShapeCollider.h"
 #include "SharedUtil.h"
 
 int MAX_DOLLS_PER_SIMULATION = 16;
 int MAX_ENTITIES_PER_SIMULATION = 64;
 int MAX_COLLISIONS_PER_SIMULATION = 256;
 
+// shapes are put in the broadphase grown by this much, so that they can move a little without being reinserted
+const float BROADPHASE_MARGIN = 0.05f; // meters
+
+// a thread isn't started for less work than this
+const int MIN_PAIRS_PER_THREAD = 64;
+
+// values of _entityRagdolls for entities that no ragdoll of the simulation moves
+const int STATIC_ENTITY = -1; // the shapes have no VerletPoints, so nothing moves them
+const int UNOWNED_ENTITY = -2; // the shapes have the VerletPoints of a ragdoll that isn't in the simulation
 
 PhysicsSimulation::PhysicsSimulation() : _translation(0.0f), _frameCount(0), _entity(NULL), _ragdoll(NULL), 
-        _collisions(MAX_COLLISIONS_PER_SIMULATION) {
+        _collisions(MAX_COLLISIONS_PER_SIMULATION), _multiBody(false), _maxThreads(0), 
+        _broadphase(BROADPHASE_MARGIN), _islandCount(0) {
 }
 
 PhysicsSimulation::~PhysicsSimulation() {
@@ -43,6 +60,11 @@ PhysicsSimulation::~PhysicsSimulation() {
     // but Ragdolls do not
     _ragdoll = NULL;
     _otherRagdolls.clear();
+
+    int numIslands = _islands.size();
+    for (int i = 0; i < numIslands; ++i) {
+        delete _islands[i];
+    }
 }
 
 void PhysicsSimulation::setRagdoll(Ragdoll* ragdoll) { 
@@ -88,7 +110,7 @@ bool PhysicsSimulation::addEntity(PhysicsEntity* entity) {
         return false;
     }
     int numEntities = _otherEntities.size();
-    if (numEntities > MAX_ENTITIES_PER_SIMULATION) {
+    if (!_multiBody && numEntities > MAX_ENTITIES_PER_SIMULATION) {
         // list is full
         return false;
     }
@@ -124,24 +146,39 @@ void PhysicsSimulation::removeEntity(PhysicsEntity* entity) {
 
 void PhysicsSimulation::removeShapes(const PhysicsEntity* entity) {
     // remove data structures with pointers to entity's shapes
-    QMap<quint64, ContactPoint>::iterator itr = _contacts.begin();
-    while (itr != _contacts.end()) {
-        if (entity == itr.value().getShapeA()->getEntity() || entity == itr.value().getShapeB()->getEntity()) {
-            itr = _contacts.erase(itr);
-        } else {
-            ++itr;
+    int numSlots = _contacts.getSlotCount();
+    for (int i = 0; i < numSlots; ++i) {
+        if (_contacts.getKey(i) != 0) {
+            ContactPoint& contact = _contacts.getContact(i);
+            if (entity == contact.getShapeA()->getEntity() || entity == contact.getShapeB()->getEntity()) {
+                _contacts.removeSlot(i);
+            }
+        }
+    }
+
+    // and from the broadphase
+    if (!_shapeProxies.isEmpty()) {
+        const QVector<Shape*> shapes = entity->getShapes();
+        int numShapes = shapes.size();
+        for (int i = 0; i < numShapes; ++i) {
+            removeShapeProxy(shapes.at(i));
         }
     }
 }
 
 const float OTHER_RAGDOLL_MASS_SCALE = 10.0f;
 
+// a step with no time limit never expires, so it stops on its iterations and error alone
+static quint64 computeExpiry(quint64 now, quint64 maxUsec) {
+    return (maxUsec > NO_STEP_TIME_LIMIT - now) ? NO_STEP_TIME_LIMIT : now + maxUsec;
+}
+
 bool PhysicsSimulation::addRagdoll(Ragdoll* doll) {
     if (!doll) {
         return false;
     }
     int numDolls = _otherRagdolls.size();
-    if (numDolls > MAX_DOLLS_PER_SIMULATION) {
+    if (!_multiBody && numDolls > MAX_DOLLS_PER_SIMULATION) {
         // list is full
         return false;
     }
@@ -158,8 +195,10 @@ bool PhysicsSimulation::addRagdoll(Ragdoll* doll) {
     doll->_simulation = this;
     _otherRagdolls.push_back(doll);
 
-    // set the massScale of otherRagdolls artificially high
-    doll->setMassScale(OTHER_RAGDOLL_MASS_SCALE);
+    // set the massScale of otherRagdolls artificially high, unless they are all peers
+    if (!_multiBody) {
+        doll->setMassScale(OTHER_RAGDOLL_MASS_SCALE);
+    }
     return true;
 }
 
@@ -186,26 +225,50 @@ void PhysicsSimulation::removeRagdoll(Ragdoll* doll) {
     }
 }
 
+void PhysicsSimulation::setMultiBody(bool multiBody) {
+    if (multiBody == _multiBody) {
+        return;
+    }
+    _multiBody = multiBody;
+
+    // the other ragdolls are only made heavier when the main one is the only one that collisions move
+    float massScale = _multiBody ? 1.0f : OTHER_RAGDOLL_MASS_SCALE;
+    int numDolls = _otherRagdolls.size();
+    for (int i = 0; i < numDolls; ++i) {
+        _otherRagdolls[i]->setMassScale(massScale);
+    }
+    if (!_multiBody) {
+        _broadphase.clear();
+        _shapeProxies.clear();
+        _shapePairs.clear();
+        _islandCount = 0;
+    }
+}
+
 void PhysicsSimulation::stepForward(float deltaTime, float minError, int maxIterations, quint64 maxUsec) {
     ++_frameCount;
+    if (_multiBody) {
+        stepMultiBody(deltaTime, minError, maxIterations, maxUsec);
+        return;
+    }
     if (!_ragdoll) {
         return;
     }
     quint64 now = usecTimestampNow();
-    quint64 startTime = now;
-    quint64 expiry = startTime + maxUsec;
+    quint64 expiry = computeExpiry(now, maxUsec);
 
     moveRagdolls(deltaTime);
     enforceContacts();
     int numDolls = _otherRagdolls.size();
     {
-        PerformanceTimer perfTimer("enforce");
+        PROFILE_SCOPE("enforce");
         _ragdoll->enforceConstraints();
         for (int i = 0; i < numDolls; ++i) {
             _otherRagdolls[i]->enforceConstraints();
         }
     }
 
+    gatherPairs();
     bool collidedWithOtherRagdoll = false;
     int iterations = 0;
     float error = 0.0f;
@@ -215,7 +278,7 @@ void PhysicsSimulation::stepForward(float deltaTime, float minError, int maxIter
         resolveCollisions();
 
         { // enforce constraints
-            PerformanceTimer perfTimer("enforce");
+            PROFILE_SCOPE("enforce");
             error = _ragdoll->enforceConstraints();
             for (int i = 0; i < numDolls; ++i) {
                 error = glm::max(error, _otherRagdolls[i]->enforceConstraints());
@@ -239,7 +302,7 @@ void PhysicsSimulation::stepForward(float deltaTime, float minError, int maxIter
 }
 
 void PhysicsSimulation::moveRagdolls(float deltaTime) {
-    PerformanceTimer perfTimer("integrate");
+    PROFILE_SCOPE("integrate");
     _ragdoll->stepForward(deltaTime);
     int numDolls = _otherRagdolls.size();
     for (int i = 0; i < numDolls; ++i) {
@@ -247,13 +310,14 @@ void PhysicsSimulation::moveRagdolls(float deltaTime) {
     }
 }
 
-bool PhysicsSimulation::computeCollisions() {
-    PerformanceTimer perfTimer("collide");
-    _collisions.clear();
+void PhysicsSimulation::gatherPairs() {
+    // the shapes don't change during a step, only where they are, so the pairs are gathered once for all iterations
+    _selfPairs.clear();
+    _otherPairs.clear();
 
+    // main ragdoll with self
     const QVector<Shape*> shapes = _entity->getShapes();
     int numShapes = shapes.size();
-    // collide main ragdoll with self
     for (int i = 0; i < numShapes; ++i) {
         const Shape* shape = shapes.at(i);
         if (!shape) {
@@ -262,64 +326,84 @@ bool PhysicsSimulation::computeCollisions() {
         for (int j = i+1; j < numShapes; ++j) {
             const Shape* otherShape = shapes.at(j);
             if (otherShape && _entity->collisionsAreEnabled(i, j)) {
-                ShapeCollider::collideShapes(shape, otherShape, _collisions);
+                _selfPairs.addPair(shape, otherShape);
             }
         }
     }
 
-    // collide main ragdoll with others
-    bool otherCollisions = false;
+    // main ragdoll with others
     int numEntities = _otherEntities.size();
     for (int i = 0; i < numEntities; ++i) {
         const QVector<Shape*> otherShapes = _otherEntities.at(i)->getShapes();
-        otherCollisions = ShapeCollider::collideShapesWithShapes(shapes, otherShapes, _collisions) || otherCollisions;
+        int numOtherShapes = otherShapes.size();
+        for (int j = 0; j < numShapes; ++j) {
+            const Shape* shape = shapes.at(j);
+            if (!shape) {
+                continue;
+            }
+            for (int k = 0; k < numOtherShapes; ++k) {
+                const Shape* otherShape = otherShapes.at(k);
+                if (otherShape) {
+                    _otherPairs.addPair(shape, otherShape);
+                }
+            }
+        }
     }
-    return otherCollisions;
+}
+
+bool PhysicsSimulation::computeCollisions() {
+    PROFILE_SCOPE("collide");
+    _collisions.clear();
+    _selfPairs.collide(_collisions);
+    return _otherPairs.collide(_collisions);
 }
 
 void PhysicsSimulation::resolveCollisions() {
-    PerformanceTimer perfTimer("resolve");
+    PROFILE_SCOPE("resolve");
     // walk all collisions, accumulate movement on shapes, and build a list of affected shapes
-    QSet<Shape*> shapes;
+    _movedShapes.clear();
     int numCollisions = _collisions.size();
     for (int i = 0; i < numCollisions; ++i) {
         CollisionInfo* collision = _collisions.getCollision(i);
         collision->apply();
         // there is always a shapeA
-        shapes.insert(collision->getShapeA());
+        _movedShapes.push_back(collision->getShapeA());
         // but need to check for valid shapeB
         if (collision->_shapeB) {
-            shapes.insert(collision->getShapeB());
+            _movedShapes.push_back(collision->getShapeB());
         }
     }
-    // walk all affected shapes and apply accumulated movement
-    QSet<Shape*>::const_iterator shapeItr = shapes.constBegin();
-    while (shapeItr != shapes.constEnd()) {
-        (*shapeItr)->applyAccumulatedDelta();
-        ++shapeItr;
+    // walk all affected shapes, once each, and apply accumulated movement
+    std::sort(_movedShapes.begin(), _movedShapes.end());
+    _movedShapes.erase(std::unique(_movedShapes.begin(), _movedShapes.end()), _movedShapes.end());
+    int numShapes = _movedShapes.size();
+    for (int i = 0; i < numShapes; ++i) {
+        _movedShapes[i]->applyAccumulatedDelta();
     }
 }
 
 void PhysicsSimulation::enforceContacts() {
-    PerformanceTimer perfTimer("contacts");
-    QMap<quint64, ContactPoint>::iterator itr = _contacts.begin();
-    while (itr != _contacts.end()) {
-        itr.value().enforce();
-        ++itr;
+    PROFILE_SCOPE("contacts");
+    int numSlots = _contacts.getSlotCount();
+    for (int i = 0; i < numSlots; ++i) {
+        if (_contacts.getKey(i) != 0) {
+            _contacts.getContact(i).enforce();
+        }
     }
 }
 
 void PhysicsSimulation::applyContactFriction() {
-    PerformanceTimer perfTimer("contacts");
-    QMap<quint64, ContactPoint>::iterator itr = _contacts.begin();
-    while (itr != _contacts.end()) {
-        itr.value().applyFriction();
-        ++itr;
+    PROFILE_SCOPE("contacts");
+    int numSlots = _contacts.getSlotCount();
+    for (int i = 0; i < numSlots; ++i) {
+        if (_contacts.getKey(i) != 0) {
+            _contacts.getContact(i).applyFriction();
+        }
     }
 }
 
 void PhysicsSimulation::updateContacts() {
-    PerformanceTimer perfTimer("contacts");
+    PROFILE_SCOPE("contacts");
     int numCollisions = _collisions.size();
     for (int i = 0; i < numCollisions; ++i) {
         CollisionInfo* collision = _collisions.getCollision(i);
@@ -327,11 +411,11 @@ void PhysicsSimulation::updateContacts() {
         if (key == 0) {
             continue;
         }
-        QMap<quint64, ContactPoint>::iterator itr = _contacts.find(key);
-        if (itr == _contacts.end()) {
-            _contacts.insert(key, ContactPoint(*collision, _frameCount));
+        ContactPoint* contact = _contacts.find(key);
+        if (contact) {
+            contact->updateContact(*collision, _frameCount);
         } else {
-            itr.value().updateContact(*collision, _frameCount);
+            _contacts.insert(key, *collision, _frameCount);
         }
     }
 }
@@ -339,12 +423,432 @@ void PhysicsSimulation::updateContacts() {
 const quint32 MAX_CONTACT_FRAME_LIFETIME = 2;
 
 void PhysicsSimulation::pruneContacts() {
-    QMap<quint64, ContactPoint>::iterator itr = _contacts.begin();
-    while (itr != _contacts.end()) {
-        if (_frameCount - itr.value().getLastFrame() > MAX_CONTACT_FRAME_LIFETIME) {
-            itr = _contacts.erase(itr);
+    int numSlots = _contacts.getSlotCount();
+    for (int i = 0; i < numSlots; ++i) {
+        if (_contacts.getKey(i) != 0 && _frameCount - _contacts.getContact(i).getLastFrame() > MAX_CONTACT_FRAME_LIFETIME) {
+            _contacts.removeSlot(i);
+        }
+    }
+}
+
+// the islands of one step, which any number of threads take from until there are none left
+class IslandBatch {
+public:
+    IslandBatch(PhysicsIsland* const* islands, int numIslands, float minError, int maxIterations, quint64 expiry) :
+        _islands(islands),
+        _numIslands(numIslands),
+        _nextIsland(0),
+        _minError(minError),
+        _maxIterations(maxIterations),
+        _expiry(expiry) {
+    }
+
+    void stepIslands() {
+        for (int i = _nextIsland.fetchAndAddOrdered(1); i < _numIslands; i = _nextIsland.fetchAndAddOrdered(1)) {
+            _islands[i]->stepForward(_minError, _maxIterations, _expiry);
+        }
+    }
+
+    QSemaphore finishedThreads;
+
+private:
+    PhysicsIsland* const* _islands;
+    int _numIslands;
+    QAtomicInt _nextIsland;
+    float _minError;
+    int _maxIterations;
+    quint64 _expiry;
+};
+
+class IslandStepper : public QRunnable {
+public:
+    IslandStepper(IslandBatch* batch) : _batch(batch) { }
+
+    virtual void run() {
+        _batch->stepIslands();
+        _batch->finishedThreads.release();
+    }
+
+private:
+    IslandBatch* _batch;
+};
+
+void PhysicsSimulation::stepMultiBody(float deltaTime, float minError, int maxIterations, quint64 maxUsec) {
+    quint64 expiry = computeExpiry(usecTimestampNow(), maxUsec);
+    gatherBodies();
+    {
+        PROFILE_SCOPE("integrate");
+        int numDolls = _bodyRagdolls.size();
+        for (int i = 0; i < numDolls; ++i) {
+            _bodyRagdolls[i]->stepForward(deltaTime);
+        }
+    }
+    {
+        PROFILE_SCOPE("broadphase");
+        updateBroadphase();
+        buildIslands();
+    }
+    {
+        PROFILE_SCOPE("islands");
+        stepIslands(minError, maxIterations, expiry);
+    }
+    {
+        PROFILE_SCOPE("contacts");
+        addIslandContacts();
+    }
+
+    // every ragdoll may have been moved from its place in the simulation, and its owner harvests the movement
+    int numDolls = _bodyRagdolls.size();
+    for (int i = 0; i < numDolls; ++i) {
+        _bodyRagdolls[i]->removeRootOffset(true);
+    }
+    pruneContacts();
+}
+
+static bool pointLessThanRagdoll(const VerletPoint* point, const std::pair<const VerletPoint*, int>& ragdollPoints) {
+    return point < ragdollPoints.first;
+}
+
+void PhysicsSimulation::gatherBodies() {
+    _bodyEntities.clear();
+    if (_entity) {
+        _bodyEntities.push_back(_entity);
+    }
+    _bodyEntities.insert(_bodyEntities.end(), _otherEntities.constBegin(), _otherEntities.constEnd());
+
+    _bodyRagdolls.clear();
+    if (_ragdoll) {
+        _bodyRagdolls.push_back(_ragdoll);
+    }
+    _bodyRagdolls.insert(_bodyRagdolls.end(), _otherRagdolls.constBegin(), _otherRagdolls.constEnd());
+
+    // VerletShapes point into the points of the ragdoll that moves them, which tells which entity each ragdoll moves
+    _ragdollPoints.clear();
+    int numDolls = _bodyRagdolls.size();
+    for (int i = 0; i < numDolls; ++i) {
+        const QVector<VerletPoint>& points = _bodyRagdolls[i]->getPoints();
+        if (!points.isEmpty()) {
+            _ragdollPoints.push_back(std::pair<const VerletPoint*, int>(points.constData(), i));
+        }
+    }
+    std::sort(_ragdollPoints.begin(), _ragdollPoints.end());
+
+    // An entity's shapes can be moved by more than one ragdoll, and two entities can share the points of a ragdoll that
+    // isn't in the simulation. Either way whatever shares a point has to be stepped in one island, so every point is
+    // looked at, and each sharing is kept as a link between the nodes of buildIslands().
+    int numEntities = _bodyEntities.size();
+    _entityRagdolls.assign(numEntities, STATIC_ENTITY);
+    _nodeLinks.clear();
+    _unownedPoints.clear();
+    for (int i = 0; i < numEntities; ++i) {
+        const QVector<Shape*> shapes = _bodyEntities[i]->getShapes();
+        int numShapes = shapes.size();
+        int linkedRagdoll = STATIC_ENTITY;
+        for (int j = 0; j < numShapes; ++j) {
+            Shape* shape = shapes.at(j);
+            if (!shape) {
+                continue;
+            }
+            // resize rather than clear, which would free the vector's memory
+            _shapePoints.resize(0);
+            shape->getVerletPoints(_shapePoints);
+            int numPoints = _shapePoints.size();
+            for (int k = 0; k < numPoints; ++k) {
+                const VerletPoint* point = _shapePoints.at(k);
+                int ragdoll = findRagdoll(point);
+                if (ragdoll >= 0) {
+                    if (_entityRagdolls[i] < 0) {
+                        _entityRagdolls[i] = ragdoll;
+                    }
+                    if (ragdoll != linkedRagdoll) {
+                        _nodeLinks.push_back(std::pair<int, int>(i, numEntities + ragdoll));
+                        linkedRagdoll = ragdoll;
+                    }
+                    continue;
+                }
+                if (_entityRagdolls[i] == STATIC_ENTITY) {
+                    _entityRagdolls[i] = UNOWNED_ENTITY;
+                }
+                QHash<const VerletPoint*, int>::const_iterator user = _unownedPoints.constFind(point);
+                if (user == _unownedPoints.constEnd()) {
+                    _unownedPoints.insert(point, i);
+                } else if (user.value() != i) {
+                    _nodeLinks.push_back(std::pair<int, int>(i, user.value()));
+                }
+            }
+        }
+    }
+}
+
+int PhysicsSimulation::findRagdoll(const VerletPoint* point) const {
+    std::vector<std::pair<const VerletPoint*, int> >::const_iterator itr = std::upper_bound(
+        _ragdollPoints.begin(), _ragdollPoints.end(), point, pointLessThanRagdoll);
+    if (itr == _ragdollPoints.begin()) {
+        return UNOWNED_ENTITY;
+    }
+    --itr;
+    if (point < itr->first + _bodyRagdolls[itr->second]->getPoints().size()) {
+        return itr->second;
+    }
+    return UNOWNED_ENTITY;
+}
+
+void PhysicsSimulation::updateBroadphase() {
+    _bodyShapes.clear();
+    _unboundedShapes.clear();
+    int numEntities = _bodyEntities.size();
+    for (int i = 0; i < numEntities; ++i) {
+        const QVector<Shape*> shapes = _bodyEntities[i]->getShapes();
+        int numShapes = shapes.size();
+        for (int j = 0; j < numShapes; ++j) {
+            Shape* shape = shapes.at(j);
+            if (!shape) {
+                continue;
+            }
+            int bodyShape = _bodyShapes.size();
+            BodyShape entry = { shape, i, j };
+            _bodyShapes.push_back(entry);
+
+            QHash<const Shape*, ShapeProxy>::iterator itr = _shapeProxies.find(shape);
+            if (itr == _shapeProxies.end()) {
+                ShapeProxy newProxy = { AABoxTree::NULL_NODE, bodyShape, _frameCount };
+                itr = _shapeProxies.insert(shape, newProxy);
+            }
+            ShapeProxy& proxy = itr.value();
+            proxy.bodyShape = bodyShape;
+            proxy.frame = _frameCount;
+
+            if (shape->getType() == PLANE_SHAPE) {
+                // planes have no bounds, and are paired with everything
+                if (proxy.proxy != AABoxTree::NULL_NODE) {
+                    _broadphase.remove(proxy.proxy);
+                    proxy.proxy = AABoxTree::NULL_NODE;
+                }
+                _unboundedShapes.push_back(bodyShape);
+                continue;
+            }
+            glm::vec3 center = shape->getTranslation();
+            glm::vec3 extent(shape->getBoundingRadius());
+            if (proxy.proxy == AABoxTree::NULL_NODE) {
+                proxy.proxy = _broadphase.insert(center - extent, center + extent, bodyShape);
+            } else {
+                _broadphase.move(proxy.proxy, center - extent, center + extent);
+                _broadphase.setData(proxy.proxy, bodyShape);
+            }
+        }
+    }
+
+    // forget the shapes that are gone
+    QHash<const Shape*, ShapeProxy>::iterator itr = _shapeProxies.begin();
+    while (itr != _shapeProxies.end()) {
+        if (itr.value().frame != _frameCount) {
+            if (itr.value().proxy != AABoxTree::NULL_NODE) {
+                _broadphase.remove(itr.value().proxy);
+            }
+            itr = _shapeProxies.erase(itr);
         } else {
             ++itr;
         }
     }
+
+    // keep the pairs that can collide
+    _broadphase.findPairs(_shapePairs);
+    int numPairs = 0;
+    int numFoundPairs = _shapePairs.size();
+    for (int i = 0; i < numFoundPairs; ++i) {
+        if (canCollide(_bodyShapes[_shapePairs[i].first], _bodyShapes[_shapePairs[i].second])) {
+            _shapePairs[numPairs++] = _shapePairs[i];
+        }
+    }
+    _shapePairs.resize(numPairs);
+
+    int numUnboundedShapes = _unboundedShapes.size();
+    int numBodyShapes = _bodyShapes.size();
+    for (int i = 0; i < numUnboundedShapes; ++i) {
+        int unboundedShape = _unboundedShapes[i];
+        for (int j = 0; j < numBodyShapes; ++j) {
+            if (j != unboundedShape && canCollide(_bodyShapes[unboundedShape], _bodyShapes[j])) {
+                _shapePairs.push_back(std::pair<int, int>(unboundedShape, j));
+            }
+        }
+    }
+}
+
+bool PhysicsSimulation::canCollide(const BodyShape& shapeA, const BodyShape& shapeB) const {
+    if (shapeA.entity == shapeB.entity) {
+        return _entityRagdolls[shapeA.entity] != STATIC_ENTITY &&
+            _bodyEntities[shapeA.entity]->collisionsAreEnabled(shapeA.index, shapeB.index);
+    }
+    // there's nothing to do for shapes that don't move
+    return _entityRagdolls[shapeA.entity] != STATIC_ENTITY || _entityRagdolls[shapeB.entity] != STATIC_ENTITY;
+}
+
+void PhysicsSimulation::removeShapeProxy(const Shape* shape) {
+    QHash<const Shape*, ShapeProxy>::iterator itr = _shapeProxies.find(shape);
+    if (itr != _shapeProxies.end()) {
+        if (itr.value().proxy != AABoxTree::NULL_NODE) {
+            _broadphase.remove(itr.value().proxy);
+        }
+        _shapeProxies.erase(itr);
+    }
+}
+
+int PhysicsSimulation::findBodyShape(const Shape* shape) const {
+    QHash<const Shape*, ShapeProxy>::const_iterator itr = _shapeProxies.constFind(shape);
+    return (itr == _shapeProxies.constEnd() || itr.value().frame != _frameCount) ? -1 : itr.value().bodyShape;
+}
+
+int PhysicsSimulation::findRoot(int node) {
+    while (_nodeParents[node] != node) {
+        // halve the path on the way up
+        _nodeParents[node] = _nodeParents[_nodeParents[node]];
+        node = _nodeParents[node];
+    }
+    return node;
+}
+
+void PhysicsSimulation::joinNodes(int nodeA, int nodeB) {
+    int rootA = findRoot(nodeA);
+    int rootB = findRoot(nodeB);
+    if (rootA < rootB) {
+        _nodeParents[rootB] = rootA;
+    } else if (rootB < rootA) {
+        _nodeParents[rootA] = rootB;
+    }
+}
+
+PhysicsIsland* PhysicsSimulation::getIsland(int node) {
+    int root = findRoot(node);
+    if (_nodeIslands[root] == -1) {
+        if (_islandCount == (int)_islands.size()) {
+            _islands.push_back(new PhysicsIsland());
+        }
+        _islands[_islandCount]->clear(_frameCount);
+        _nodeIslands[root] = _islandCount++;
+    }
+    return _islands[_nodeIslands[root]];
+}
+
+static bool islandHasMorePairs(const PhysicsIsland* islandA, const PhysicsIsland* islandB) {
+    return islandA->getPairCount() > islandB->getPairCount();
+}
+
+void PhysicsSimulation::buildIslands() {
+    int numEntities = _bodyEntities.size();
+    int numNodes = numEntities + _bodyRagdolls.size();
+    _nodeParents.resize(numNodes);
+    for (int i = 0; i < numNodes; ++i) {
+        _nodeParents[i] = i;
+    }
+
+    // join each entity with the ragdolls that move it and the entities it shares points with, and the entities that may
+    // touch or are in contact
+    int numLinks = _nodeLinks.size();
+    for (int i = 0; i < numLinks; ++i) {
+        joinNodes(_nodeLinks[i].first, _nodeLinks[i].second);
+    }
+    int numPairs = _shapePairs.size();
+    for (int i = 0; i < numPairs; ++i) {
+        int entityA = _bodyShapes[_shapePairs[i].first].entity;
+        int entityB = _bodyShapes[_shapePairs[i].second].entity;
+        if (_entityRagdolls[entityA] != STATIC_ENTITY && _entityRagdolls[entityB] != STATIC_ENTITY) {
+            joinNodes(entityA, entityB);
+        }
+    }
+    int numSlots = _contacts.getSlotCount();
+    for (int i = 0; i < numSlots; ++i) {
+        if (_contacts.getKey(i) == 0) {
+            continue;
+        }
+        int shapeA = findBodyShape(_contacts.getContact(i).getShapeA());
+        int shapeB = findBodyShape(_contacts.getContact(i).getShapeB());
+        if (shapeA != -1 && shapeB != -1) {
+            int entityA = _bodyShapes[shapeA].entity;
+            int entityB = _bodyShapes[shapeB].entity;
+            if (_entityRagdolls[entityA] != STATIC_ENTITY && _entityRagdolls[entityB] != STATIC_ENTITY) {
+                joinNodes(entityA, entityB);
+            }
+        }
+    }
+
+    // an island for each group of nodes with something that moves, which gets everything its nodes touch
+    _nodeIslands.assign(numNodes, -1);
+    _islandCount = 0;
+    int numDolls = _bodyRagdolls.size();
+    for (int i = 0; i < numDolls; ++i) {
+        getIsland(numEntities + i)->addRagdoll(_bodyRagdolls[i]);
+    }
+    for (int i = 0; i < numPairs; ++i) {
+        const BodyShape& shapeA = _bodyShapes[_shapePairs[i].first];
+        const BodyShape& shapeB = _bodyShapes[_shapePairs[i].second];
+        int node = (_entityRagdolls[shapeA.entity] != STATIC_ENTITY) ? shapeA.entity : shapeB.entity;
+        getIsland(node)->addPair(shapeA.shape, shapeB.shape);
+    }
+    for (int i = 0; i < numSlots; ++i) {
+        quint64 key = _contacts.getKey(i);
+        if (key == 0) {
+            continue;
+        }
+        ContactPoint* contact = &(_contacts.getContact(i));
+        int shapeA = findBodyShape(contact->getShapeA());
+        int shapeB = findBodyShape(contact->getShapeB());
+        if (shapeA == -1 || shapeB == -1) {
+            continue;
+        }
+        int entityA = _bodyShapes[shapeA].entity;
+        int entityB = _bodyShapes[shapeB].entity;
+        if (_entityRagdolls[entityA] != STATIC_ENTITY) {
+            getIsland(entityA)->addContact(key, contact);
+        } else if (_entityRagdolls[entityB] != STATIC_ENTITY) {
+            getIsland(entityB)->addContact(key, contact);
+        }
+    }
+
+    // the islands with the most work go first, so that the threads finish at about the same time
+    std::sort(_islands.begin(), _islands.begin() + _islandCount, islandHasMorePairs);
+}
+
+void PhysicsSimulation::stepIslands(float minError, int maxIterations, quint64 expiry) {
+    if (_islandCount == 0) {
+        return;
+    }
+    QThreadPool* threadPool = QThreadPool::globalInstance();
+    int numThreads = (_maxThreads > 0) ? _maxThreads : threadPool->maxThreadCount();
+    numThreads = glm::min(numThreads, glm::min(_islandCount, 1 + (int)_shapePairs.size() / MIN_PAIRS_PER_THREAD));
+    if (numThreads < 2) {
+        // no batch, whose semaphore would be allocated every step
+        for (int i = 0; i < _islandCount; ++i) {
+            _islands[i]->stepForward(minError, maxIterations, expiry);
+        }
+        return;
+    }
+
+    // the calling thread steps islands too, and only threads that the pool can start right away help
+    IslandBatch batch(&_islands[0], _islandCount, minError, maxIterations, expiry);
+    int numHelpers = 0;
+    for (int i = 1; i < numThreads; ++i) {
+        IslandStepper* stepper = new IslandStepper(&batch);
+        if (!threadPool->tryStart(stepper)) {
+            delete stepper;
+            break;
+        }
+        ++numHelpers;
+    }
+    batch.stepIslands();
+    batch.finishedThreads.acquire(numHelpers);
+}
+
+void PhysicsSimulation::addIslandContacts() {
+    // the islands only update the contacts they were given, so the shapes that started touching get theirs here
+    for (int i = 0; i < _islandCount; ++i) {
+        CollisionList& collisions = _islands[i]->getCollisions();
+        int numCollisions = collisions.size();
+        for (int j = 0; j < numCollisions; ++j) {
+            CollisionInfo* collision = collisions.getCollision(j);
+            quint64 key = collision->getShapePairKey();
+            if (key != 0 && !_contacts.find(key)) {
+                _contacts.insert(key, *collision, _frameCount);
+            }
+        }
+    }
 }
@@ -12,15 +12,26 @@
 #ifndef hifi_PhysicsSimulation
 #define hifi_PhysicsSimulation
 
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include <QtGlobal>
-#include <QMap>
+#include <QHash>
 #include <QVector>
 
+#include "AABoxTree.h"
 #include "CollisionInfo.h"
-#include "ContactPoint.h"
+#include "ContactTable.h"
+#include "ShapePairBatch.h"
 
 class PhysicsEntity;
+class PhysicsIsland;
 class Ragdoll;
+class Shape;
+
+/// The time budget for a step that is limited by its iterations alone, which replays and tests use to be repeatable.
+const quint64 NO_STEP_TIME_LIMIT = std::numeric_limits<quint64>::max();
 
 class PhysicsSimulation {
 public:
@@ -34,6 +45,31 @@ public:
     void setRagdoll(Ragdoll* ragdoll);
     void setEntity(PhysicsEntity* entity);
 
+    Ragdoll* getRagdoll() const { return _ragdoll; }
+    PhysicsEntity* getEntity() const { return _entity; }
+
+    /// \return the ragdolls and entities added with addRagdoll() and addEntity()
+    const QVector<Ragdoll*>& getOtherRagdolls() const { return _otherRagdolls; }
+    const QVector<PhysicsEntity*>& getOtherEntities() const { return _otherEntities; }
+
+    /// In multi-body mode every entity collides with every other one and with itself, and every ragdoll is moved by
+    /// collisions as much as the main one, with no limit on how many there are. Every ragdoll accumulates the movement
+    /// for its owner to harvest. A broadphase finds the shapes that may collide, the ragdolls that may touch are
+    /// gathered into islands, and the islands are stepped in parallel.
+    void setMultiBody(bool multiBody);
+    bool isMultiBody() const { return _multiBody; }
+
+    /// \param maxThreads most threads to step islands on, including the calling one, or 0 for as many as the global
+    /// QThreadPool has
+    void setMaxThreads(int maxThreads) { _maxThreads = maxThreads; }
+    int getMaxThreads() const { return _maxThreads; }
+
+    /// \return number of islands in the last multi-body step
+    int getIslandCount() const { return _islandCount; }
+
+    /// \return number of shape pairs the broadphase found in the last multi-body step
+    int getPairCount() const { return _shapePairs.size(); }
+
     /// \return true if entity was added to or is already in the list
     bool addEntity(PhysicsEntity* entity);
 
@@ -47,12 +83,15 @@ public:
 
     /// \param minError constraint motion below this value is considered "close enough"
     /// \param maxIterations max number of iterations before giving up
-    /// \param maxUsec max number of usec to spend enforcing constraints
+    /// \param maxUsec max number of usec to spend enforcing constraints, where 0 allows one iteration, or
+    /// NO_STEP_TIME_LIMIT to stop on maxIterations and minError alone, so that the step doesn't depend on the clock and
+    /// can be repeated exactly
     /// \return distance of largest movement
     void stepForward(float deltaTime, float minError, int maxIterations, quint64 maxUsec);
 
 protected:
     void moveRagdolls(float deltaTime);
+    void gatherPairs();
 
     /// \return true if main ragdoll collides with other avatar
     bool computeCollisions();
@@ -63,7 +102,36 @@ protected:
     void updateContacts();
     void pruneContacts();
 
+    void stepMultiBody(float deltaTime, float minError, int maxIterations, quint64 maxUsec);
+    void gatherBodies();
+    void updateBroadphase();
+    void buildIslands();
+    void stepIslands(float minError, int maxIterations, quint64 expiry);
+    void addIslandContacts();
+
 private:
+    class BodyShape {
+    public:
+        Shape* shape;
+        int entity; // index in _bodyEntities
+        int index; // index in the entity's shapes
+    };
+
+    class ShapeProxy {
+    public:
+        int proxy; // in _broadphase, or AABoxTree::NULL_NODE for unbounded shapes
+        int bodyShape; // index in _bodyShapes
+        quint32 frame; // last frame the shape was seen in
+    };
+
+    void removeShapeProxy(const Shape* shape);
+    int findBodyShape(const Shape* shape) const;
+    int findRagdoll(const VerletPoint* point) const;
+    bool canCollide(const BodyShape& shapeA, const BodyShape& shapeB) const;
+    int findRoot(int node);
+    void joinNodes(int nodeA, int nodeB);
+    PhysicsIsland* getIsland(int node);
+
     glm::vec3 _translation; // origin of simulation in world-frame
 
     quint32 _frameCount;
@@ -74,7 +142,35 @@ private:
     QVector<Ragdoll*> _otherRagdolls;
     QVector<PhysicsEntity*> _otherEntities;
     CollisionList _collisions;
-    QMap<quint64, ContactPoint> _contacts;
+    ContactTable _contacts;
+    ShapePairBatch _selfPairs; // pairs of the main entity's shapes
+    ShapePairBatch _otherPairs; // pairs of a shape of the main entity and one of another entity
+    std::vector<Shape*> _movedShapes; // scratch space for resolveCollisions(), kept to avoid allocating every iteration
+
+    bool _multiBody;
+    int _maxThreads;
+
+    // multi-body state, rebuilt every step: the bodies, their shapes, and the pairs of shapes that may collide
+    std::vector<PhysicsEntity*> _bodyEntities;
+    std::vector<Ragdoll*> _bodyRagdolls;
+    std::vector<std::pair<const VerletPoint*, int> > _ragdollPoints; // first point of each ragdoll, in address order
+    std::vector<int> _entityRagdolls; // the ragdoll that moves each entity's shapes, or < 0 if there is none
+    std::vector<std::pair<int, int> > _nodeLinks; // nodes of buildIslands() that share VerletPoints
+    QHash<const VerletPoint*, int> _unownedPoints; // the first entity with each point of a ragdoll outside the simulation
+    QVector<VerletPoint*> _shapePoints;
+    std::vector<BodyShape> _bodyShapes;
+    std::vector<int> _unboundedShapes;
+    std::vector<std::pair<int, int> > _shapePairs;
+
+    // multi-body state that is kept between steps
+    AABoxTree _broadphase;
+    QHash<const Shape*, ShapeProxy> _shapeProxies;
+
+    // the islands: a node for each entity followed by a node for each ragdoll, joined into trees of nodes that touch
+    std::vector<int> _nodeParents;
+    std::vector<int> _nodeIslands;
+    std::vector<PhysicsIsland*> _islands;
+    int _islandCount;
 };
 
 #endif // hifi_PhysicsSimulation
@@ -0,0 +1,411 @@
+//
+//  Profiler.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
+
+#include "Profiler.h"
+
+#include "AtomicCounter.h"
+#include "SharedUtil.h"
+
+const int MAX_PROFILE_NODES = 1024; // zones per thread, counting each path through the tree separately
+const int MAX_PROFILE_DEPTH = 64;
+const int MAX_PROFILE_EVENTS = 16384; // the scopes each thread keeps while tracing
+const int MAX_PROFILED_THREADS = 256;
+
+// a zone in the tree of a thread, whose timings are added by the thread and taken by whoever tallies them
+class ProfileNode {
+public:
+    int zone;
+    int parent;
+    int firstChild;
+    int nextSibling;
+    AtomicCounter usecs; // 32 bits of microseconds only last 35 minutes between tallies
+    QAtomicInt count;
+};
+
+class ProfileEvent {
+public:
+    int zone;
+    int depth;
+    quint64 start;
+    quint64 duration;
+};
+
+// the timings of one thread. Only that thread writes them, and everything else only reads what it has published.
+class ProfilerThreadBuffer {
+public:
+    ProfilerThreadBuffer(int index);
+    ~ProfilerThreadBuffer();
+
+    void enter(int zone);
+    void exit(quint64 start);
+
+    /// Drops the timings that haven't been tallied and closes any open scopes. Call with the buffer mutex locked.
+    void clear();
+
+    int _index;
+    QString _threadName;
+    QAtomicInt _inUse; // cleared when the thread finishes, so that another can take the buffer
+
+    ProfileNode _nodes[MAX_PROFILE_NODES];
+    int _numNodes;
+    QAtomicInt _numPublishedNodes;
+
+    int _stack[MAX_PROFILE_DEPTH]; // the nodes of the open scopes, starting with the root
+    int _depth;
+    int _numLostScopes; // scopes opened past the maximum depth, which aren't timed
+
+    QAtomicPointer<ProfileEvent> _events; // a ring of the latest scopes, allocated when the thread first traces
+    QAtomicInt _numEvents;
+
+    // the paths of the nodes, kept by whoever tallies them
+    QVector<QString> _paths;
+
+private:
+    int findChild(int parent, int zone);
+};
+
+ProfilerThreadBuffer::ProfilerThreadBuffer(int index) :
+    _index(index),
+    _inUse(1),
+    _numNodes(1),
+    _numPublishedNodes(1),
+    _depth(0),
+    _numLostScopes(0),
+    _events(NULL),
+    _numEvents(0) {
+
+    // node 0 is the root, whose children are the outermost scopes
+    _nodes[0].zone = 0;
+    _nodes[0].parent = -1;
+    _nodes[0].firstChild = -1;
+    _nodes[0].nextSibling = -1;
+    _nodes[0].usecs.reset();
+    _stack[0] = 0;
+    _paths.push_back(QString());
+}
+
+ProfilerThreadBuffer::~ProfilerThreadBuffer() {
+    delete[] _events.load();
+}
+
+void ProfilerThreadBuffer::enter(int zone) {
+    if (_depth + 1 == MAX_PROFILE_DEPTH) {
+        ++_numLostScopes;
+        return;
+    }
+    int parent = _stack[_depth];
+    _stack[++_depth] = (parent == -1) ? -1 : findChild(parent, zone);
+}
+
+void ProfilerThreadBuffer::exit(quint64 start) {
+    if (_numLostScopes > 0) {
+        --_numLostScopes;
+        return;
+    }
+    int node = _stack[_depth--];
+    if (node == -1) {
+        // the tree was full when the scope opened
+        return;
+    }
+    quint64 now = usecTimestampNow();
+    quint64 elapsed = now - start;
+    _nodes[node].usecs.add(elapsed);
+    _nodes[node].count.fetchAndAddRelaxed(1);
+
+    if (Profiler::isTracing()) {
+        ProfileEvent* events = _events.load();
+        if (!events) {
+            events = new ProfileEvent[MAX_PROFILE_EVENTS];
+            _events.storeRelease(events);
+        }
+        int numEvents = _numEvents.load();
+        ProfileEvent& event = events[(quint32)numEvents % MAX_PROFILE_EVENTS];
+        event.zone = _nodes[node].zone;
+        event.depth = _depth;
+        event.start = start;
+        event.duration = now - start;
+        _numEvents.storeRelease(numEvents + 1);
+    }
+}
+
+void ProfilerThreadBuffer::clear() {
+    int numNodes = _numPublishedNodes.loadAcquire();
+    for (int i = 1; i < numNodes; ++i) {
+        _nodes[i].count.fetchAndStoreRelaxed(0);
+        _nodes[i].usecs.reset();
+    }
+    _depth = 0;
+    _numLostScopes = 0;
+}
+
+int ProfilerThreadBuffer::findChild(int parent, int zone) {
+    for (int child = _nodes[parent].firstChild; child != -1; child = _nodes[child].nextSibling) {
+        if (_nodes[child].zone == zone) {
+            return child;
+        }
+    }
+    if (_numNodes == MAX_PROFILE_NODES) {
+        return -1;
+    }
+    int child = _numNodes++;
+    ProfileNode& node = _nodes[child];
+    node.zone = zone;
+    node.parent = parent;
+    node.firstChild = -1;
+    node.nextSibling = _nodes[parent].firstChild;
+    node.usecs.reset();
+    node.count.store(0);
+    _nodes[parent].firstChild = child;
+
+    // the node is complete before anyone else can see it
+    _numPublishedNodes.storeRelease(_numNodes);
+    return child;
+}
+
+// a thread's claim on a buffer, which QThreadStorage deletes when the thread finishes
+class ProfilerThreadLease {
+public:
+    ProfilerThreadLease(ProfilerThreadBuffer* buffer) : _buffer(buffer) { }
+    ~ProfilerThreadLease() {
+        if (_buffer) {
+            _buffer->_inUse.storeRelease(0);
+        }
+    }
+
+    ProfilerThreadBuffer* getBuffer() const { return _buffer; }
+
+private:
+    ProfilerThreadBuffer* _buffer;
+};
+
+static QThreadStorage<ProfilerThreadLease*> threadLeases;
+
+// the buffers of all threads, which are never deleted, and the names of the zones
+static QMutex bufferMutex;
+static ProfilerThreadBuffer* threadBuffers[MAX_PROFILED_THREADS];
+static int numThreadBuffers = 0;
+
+static QMutex zoneMutex;
+static QVector<QByteArray> zoneNames;
+static QHash<QByteArray, int> zoneIDs;
+
+QBasicAtomicInt Profiler::_enabled = Q_BASIC_ATOMIC_INITIALIZER(1);
+QBasicAtomicInt Profiler::_tracing = Q_BASIC_ATOMIC_INITIALIZER(0);
+QMap<QString, PerformanceTimerRecord> Profiler::_records;
+
+int Profiler::internZone(const char* name) {
+    QMutexLocker locker(&zoneMutex);
+    if (zoneNames.isEmpty()) {
+        // zone 0 is the root of every tree
+        zoneNames.push_back(QByteArray());
+    }
+    QByteArray zoneName(name);
+    QHash<QByteArray, int>::const_iterator itr = zoneIDs.constFind(zoneName);
+    if (itr != zoneIDs.constEnd()) {
+        return itr.value();
+    }
+    int zone = zoneNames.size();
+    zoneNames.push_back(zoneName);
+    zoneIDs.insert(zoneName, zone);
+    return zone;
+}
+
+QString Profiler::getZoneName(int zone) {
+    QMutexLocker locker(&zoneMutex);
+    return (zone > 0 && zone < zoneNames.size()) ? QString::fromLatin1(zoneNames.at(zone)) : QString();
+}
+
+void Profiler::tallyRecords() {
+    QMutexLocker locker(&bufferMutex);
+    for (int i = 0; i < numThreadBuffers; ++i) {
+        ProfilerThreadBuffer* buffer = threadBuffers[i];
+        int numNodes = buffer->_numPublishedNodes.loadAcquire();
+        for (int j = buffer->_paths.size(); j < numNodes; ++j) {
+            const ProfileNode& node = buffer->_nodes[j];
+            buffer->_paths.push_back(buffer->_paths.at(node.parent) + "/" + getZoneName(node.zone));
+        }
+        for (int j = 1; j < numNodes; ++j) {
+            ProfileNode& node = buffer->_nodes[j];
+            int count = node.count.fetchAndStoreRelaxed(0);
+            qint64 usecs = node.usecs.take();
+            if (count > 0) {
+                _records[buffer->_paths.at(j)].accumulateResult((quint64)usecs);
+            }
+        }
+    }
+
+    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
+    quint64 now = usecTimestampNow();
+    while (recordsItr != _records.end()) {
+        recordsItr.value().tallyResult(now);
+        if (recordsItr.value().isStale(now)) {
+            // purge stale records
+            recordsItr = _records.erase(recordsItr);
+        } else {
+            ++recordsItr;
+        }
+    }
+}
+
+void Profiler::resetRecords() {
+    QMutexLocker locker(&bufferMutex);
+    for (int i = 0; i < numThreadBuffers; ++i) {
+        ProfilerThreadBuffer* buffer = threadBuffers[i];
+        int numNodes = buffer->_numPublishedNodes.loadAcquire();
+        for (int j = 1; j < numNodes; ++j) {
+            buffer->_nodes[j].count.fetchAndStoreRelaxed(0);
+            buffer->_nodes[j].usecs.reset();
+        }
+    }
+    _records.clear();
+}
+
+void Profiler::dumpRecords() {
+    QMapIterator<QString, PerformanceTimerRecord> i(_records);
+    while (i.hasNext()) {
+        i.next();
+        qDebug() << i.key() << ": average " << i.value().getAverage()
+            << " [" << i.value().getMovingAverage() << "]"
+            << "usecs over" << i.value().getCount() << "calls";
+    }
+}
+
+static void appendJSONString(QByteArray& json, const QByteArray& string) {
+    json.append('"');
+    for (int i = 0; i < string.size(); ++i) {
+        char c = string.at(i);
+        if (c == '"' || c == '\\') {
+            json.append('\\');
+        }
+        json.append(c);
+    }
+    json.append('"');
+}
+
+QByteArray Profiler::exportChromeTrace() {
+    QVector<QByteArray> names;
+    {
+        QMutexLocker locker(&zoneMutex);
+        names = zoneNames;
+    }
+    QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json("{\"traceEvents\":[");
+    bool firstEntry = true;
+
+    QMutexLocker locker(&bufferMutex);
+    std::vector<ProfileEvent> events;
+    for (int i = 0; i < numThreadBuffers; ++i) {
+        ProfilerThreadBuffer* buffer = threadBuffers[i];
+        ProfileEvent* bufferEvents = buffer->_events.loadAcquire();
+        if (!bufferEvents) {
+            continue;
+        }
+        QByteArray tid = QByteArray::number(buffer->_index);
+        if (!firstEntry) {
+            json.append(',');
+        }
+        firstEntry = false;
+        json.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":");
+        appendJSONString(json, buffer->_threadName.toUtf8());
+        json.append("}}");
+
+        // copy the ring, then keep only the events that the thread can't have written over while it was copied
+        quint32 end = (quint32)buffer->_numEvents.loadAcquire();
+        quint32 copyStart = (end > (quint32)MAX_PROFILE_EVENTS) ? end - MAX_PROFILE_EVENTS : 0;
+        events.resize(end - copyStart);
+        for (quint32 j = copyStart; j < end; ++j) {
+            events[j - copyStart] = bufferEvents[j % MAX_PROFILE_EVENTS];
+        }
+        quint32 start = copyStart;
+        quint32 newEnd = (quint32)buffer->_numEvents.loadAcquire();
+        if (newEnd + 1 > start + MAX_PROFILE_EVENTS) {
+            start = newEnd + 1 - MAX_PROFILE_EVENTS;
+        }
+        for (quint32 j = start; j < end; ++j) {
+            const ProfileEvent& event = events[j - copyStart];
+            json.append(",{\"name\":");
+            appendJSONString(json, (event.zone < names.size()) ? names.at(event.zone) : QByteArray());
+            json.append(",\"cat\":\"hifi\",\"ph\":\"X\",\"ts\":" + QByteArray::number(event.start) +
+                ",\"dur\":" + QByteArray::number(event.duration) + ",\"pid\":" + pid + ",\"tid\":" + tid + "}");
+        }
+    }
+    json.append("]}");
+    return json;
+}
+
+bool Profiler::writeChromeTrace(const QString& filename) {
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Failed to open" << filename << "for the profiler trace";
+        return false;
+    }
+    return file.write(exportChromeTrace()) != -1;
+}
+
+ProfilerThreadBuffer* Profiler::enterZone(QBasicAtomicInt& zone, const char* name, quint64& start) {
+    int zoneID = zone.load();
+    if (zoneID == 0) {
+        // any thread that gets here first interns the same zone
+        zoneID = internZone(name);
+        zone.store(zoneID);
+    }
+    ProfilerThreadBuffer* buffer = getThreadBuffer();
+    if (buffer) {
+        buffer->enter(zoneID);
+        start = usecTimestampNow();
+    }
+    return buffer;
+}
+
+void Profiler::exitZone(ProfilerThreadBuffer* buffer, quint64 start) {
+    buffer->exit(start);
+}
+
+ProfilerThreadBuffer* Profiler::getThreadBuffer() {
+    ProfilerThreadLease* lease = threadLeases.localData();
+    if (lease) {
+        return lease->getBuffer();
+    }
+
+    // take the buffer of a thread that has finished, or make one
+    QMutexLocker locker(&bufferMutex);
+    ProfilerThreadBuffer* buffer = NULL;
+    for (int i = 0; i < numThreadBuffers && !buffer; ++i) {
+        if (threadBuffers[i]->_inUse.testAndSetOrdered(0, 1)) {
+            // what the finished thread did since the last tally shouldn't be counted as this thread's
+            buffer = threadBuffers[i];
+            buffer->clear();
+        }
+    }
+    if (!buffer && numThreadBuffers < MAX_PROFILED_THREADS) {
+        buffer = new ProfilerThreadBuffer(numThreadBuffers);
+        threadBuffers[numThreadBuffers++] = buffer;
+    }
+    if (buffer) {
+        buffer->_threadName = QThread::currentThread()->objectName();
+        if (buffer->_threadName.isEmpty()) {
+            buffer->_threadName = QString("thread %1").arg(buffer->_index);
+        }
+    }
+    // when there are too many threads, the lease remembers that this one has no buffer
+    threadLeases.setLocalData(new ProfilerThreadLease(buffer));
+    return buffer;
+}
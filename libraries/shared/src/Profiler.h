@@ -0,0 +1,93 @@
+//
+//  Profiler.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Times nested scopes on any thread. Each scope is a zone that is named once, the first time it runs, and known by
+//  number after that. Each thread adds its timings to a tree of zones of its own without locking, and the timings of
+//  all threads are gathered into PerformanceTimerRecords, keyed by the path of the zone, when they're tallied. While
+//  tracing, each thread also keeps its latest scopes, which can be exported in the JSON format of chrome://tracing.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Profiler_h
+#define hifi_Profiler_h
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+#include "PerfStat.h"
+
+class ProfilerThreadBuffer;
+
+/// Times the rest of the enclosing scope as the zone called name, which must be a string literal.
+#define PROFILE_SCOPE(name) \
+    static QBasicAtomicInt profileZone = Q_BASIC_ATOMIC_INITIALIZER(0); \
+    ProfileScope profileScope(profileZone, name)
+
+class Profiler {
+public:
+    /// Profiling is enabled by default. When disabled, a scope costs a check of this flag.
+    static void setEnabled(bool enabled) { _enabled.store(enabled ? 1 : 0); }
+    static bool isEnabled() { return _enabled.load() != 0; }
+
+    /// While tracing, every thread keeps its latest scopes for exportChromeTrace().
+    static void setTracing(bool tracing) { _tracing.store(tracing ? 1 : 0); }
+    static bool isTracing() { return _tracing.load() != 0; }
+
+    /// \return the ID of the zone called name, adding the zone if there is none yet
+    static int internZone(const char* name);
+
+    static QString getZoneName(int zone);
+
+    /// Gathers the timings of all threads since the last tally into the records, and updates their averages.
+    /// The records are only for the thread that tallies them, which should always be the same thread.
+    static void tallyRecords();
+    static const QMap<QString, PerformanceTimerRecord>& getRecords() { return _records; }
+    static void dumpRecords();
+
+    /// Drops the records, along with the timings of all threads since the last tally, so the next tally starts afresh.
+    static void resetRecords();
+
+    /// \return the traced scopes of all threads in the JSON format of chrome://tracing
+    static QByteArray exportChromeTrace();
+    static bool writeChromeTrace(const QString& filename);
+
+    // for ProfileScope
+    static ProfilerThreadBuffer* enterZone(QBasicAtomicInt& zone, const char* name, quint64& start);
+    static void exitZone(ProfilerThreadBuffer* buffer, quint64 start);
+
+private:
+    static ProfilerThreadBuffer* getThreadBuffer();
+
+    static QBasicAtomicInt _enabled;
+    static QBasicAtomicInt _tracing;
+    static QMap<QString, PerformanceTimerRecord> _records;
+};
+
+/// Times a zone from its construction to its destruction. Use PROFILE_SCOPE() rather than making one.
+class ProfileScope {
+public:
+    ProfileScope(QBasicAtomicInt& zone, const char* name) : _buffer(NULL), _start(0) {
+        if (Profiler::isEnabled()) {
+            _buffer = Profiler::enterZone(zone, name, _start);
+        }
+    }
+
+    ~ProfileScope() {
+        if (_buffer) {
+            Profiler::exitZone(_buffer, _start);
+        }
+    }
+
+private:
+    ProfilerThreadBuffer* _buffer;
+    quint64 _start;
+};
+
+#endif // hifi_Profiler_h
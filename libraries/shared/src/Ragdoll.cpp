@@ -20,7 +20,7 @@
 #include "SharedUtil.h" // for EPSILON
 
 Ragdoll::Ragdoll() : _massScale(1.0f), _translation(0.0f), _translationInSimulationFrame(0.0f), 
-        _rootIndex(0), _accumulatedMovement(0.0f), _simulation(NULL) {
+        _rootIndex(0), _useColoredSolver(false), _accumulatedMovement(0.0f), _simulation(NULL) {
 }
 
 Ragdoll::~Ragdoll() {
@@ -51,6 +51,7 @@ void Ragdoll::clearConstraintsAndPoints() {
         delete _fixedConstraints[i];
     }
     _fixedConstraints.clear();
+    _coloredSolver.clear();
     _points.clear();
 }
 
@@ -58,12 +59,19 @@ float Ragdoll::enforceConstraints() {
     float maxDistance = 0.0f;
     // enforce the bone constraints first
     int numConstraints = _boneConstraints.size();
-    for (int i = 0; i < numConstraints; ++i) {
-        maxDistance = glm::max(maxDistance, _boneConstraints[i]->enforce());
+    if (_useColoredSolver && !_coloredSolver.isBuiltFor(_points, numConstraints)) {
+        _coloredSolver.build(_points, _boneConstraints);
+    }
+    if (_useColoredSolver && _coloredSolver.isValid()) {
+        maxDistance = _coloredSolver.enforce(_points);
+    } else {
+        for (int i = 0; i < numConstraints; ++i) {
+            maxDistance = glm::max(maxDistance, _boneConstraints[i]->enforce());
+        }
     }
     // enforce FixedConstraints second
     numConstraints = _fixedConstraints.size();
-    for (int i = 0; i < _fixedConstraints.size(); ++i) {
+    for (int i = 0; i < numConstraints; ++i) {
         maxDistance = glm::max(maxDistance, _fixedConstraints[i]->enforce());
     }
     return maxDistance;
@@ -14,6 +14,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include "ColoredConstraintSolver.h"
 #include "VerletPoint.h"
 
 #include <QVector>
@@ -38,15 +39,25 @@ public:
     /// \return max distance of point movement
     float enforceConstraints();
 
+    /// Enforces the bone constraints a color at a time with a ColoredConstraintSolver, rather than one after another.
+    /// The solver is built again when the points move or the number of bone constraints changes.
+    void setUseColoredSolver(bool useColoredSolver) { _useColoredSolver = useColoredSolver; }
+    bool getUseColoredSolver() const { return _useColoredSolver; }
+
     // both const and non-const getPoints()
     const QVector<VerletPoint>& getPoints() const { return _points; }
     QVector<VerletPoint>& getPoints() { return _points; }
 
+    const QVector<DistanceConstraint*>& getBoneConstraints() const { return _boneConstraints; }
+
     void initTransform();
 
     /// set the translation and rotation of the Ragdoll and adjust all VerletPoints.
     void setTransform(const glm::vec3& translation, const glm::quat& rotation);
 
+    const glm::vec3& getTranslation() const { return _translation; }
+    const glm::quat& getRotation() const { return _rotation; }
+
     const glm::vec3& getTranslationInSimulationFrame() const { return _translationInSimulationFrame; }
 
     void setMassScale(float scale);
@@ -75,6 +86,8 @@ protected:
     QVector<VerletPoint> _points;
     QVector<DistanceConstraint*> _boneConstraints;
     QVector<FixedConstraint*> _fixedConstraints;
+    bool _useColoredSolver;
+    ColoredConstraintSolver _coloredSolver;
 
     // The collisions are typically done in a simulation frame that is slaved to the center of one of the Ragdolls.
     // To allow the Ragdoll to provide feedback of its own displacement we store it in _accumulatedMovement.
@@ -0,0 +1,439 @@
+//
+//  ShapePairBatch.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include <QHash>
+
+#include "CapsuleShape.h"
+#include "Lanes.h"
+#include "ShapeCollider.h"
+#include "ShapePairBatch.h"
+#include "SharedUtil.h" // for EPSILON
+#include "SphereShape.h"
+
+// the columns of the shapes, where spheres have no axis and no height
+enum { SHAPE_X, SHAPE_Y, SHAPE_Z, SHAPE_RADIUS, SHAPE_AXIS_X, SHAPE_AXIS_Y, SHAPE_AXIS_Z, SHAPE_HALF_HEIGHT,
+    NUM_SHAPE_COLUMNS };
+
+// the columns of the results of each group
+enum { PENETRATION_X, PENETRATION_Y, PENETRATION_Z, CONTACT_POINT_X, CONTACT_POINT_Y, CONTACT_POINT_Z, NUM_RESULT_COLUMNS };
+
+const int EMPTY_SHAPE_SLOT = -1;
+const size_t MIN_SHAPE_TABLE_SIZE = 64;
+
+// capsules that are further apart than a bound of their extents are skipped four at a time. The bound is widened by this
+// fraction, plus this distance in meters, so that rounding can't make it skip a pair that ShapeCollider finds touching.
+const float BOUND_SLACK = 0.01f;
+
+static Lanes dot(const Lanes& ax, const Lanes& ay, const Lanes& az, const Lanes& bx, const Lanes& by, const Lanes& bz) {
+    return ax * bx + ay * by + az * bz;
+}
+
+ShapePairBatch::ShapePairBatch() {
+    for (int i = 0; i < NUM_BATCHED_TYPES; ++i) {
+        _groups[i].size = 0;
+        _groups[i].stride = 0;
+    }
+}
+
+void ShapePairBatch::clear() {
+    _pairs.clear();
+    for (int i = 0; i < NUM_BATCHED_TYPES; ++i) {
+        _groups[i].size = 0;
+        _groups[i].shapesA.clear();
+        _groups[i].shapesB.clear();
+    }
+    _shapes.clear();
+    std::fill(_shapeTable.begin(), _shapeTable.end(), EMPTY_SHAPE_SLOT);
+}
+
+void ShapePairBatch::addPair(const Shape* shapeA, const Shape* shapeB) {
+    Pair pair = { shapeA, shapeB, OTHER_PAIR, 0 };
+    int typeA = shapeA->getType();
+    int typeB = shapeB->getType();
+    if (typeA == SPHERE_SHAPE && typeB == SPHERE_SHAPE) {
+        pair.type = SPHERE_SPHERE;
+
+    } else if ((typeA == SPHERE_SHAPE && typeB == CAPSULE_SHAPE) || (typeA == CAPSULE_SHAPE && typeB == SPHERE_SHAPE)) {
+        pair.type = SPHERE_CAPSULE;
+        if (typeA == CAPSULE_SHAPE) {
+            // ShapeCollider collides a capsule with a sphere as the sphere with the capsule
+            std::swap(shapeA, shapeB);
+        }
+
+    } else if (typeA == CAPSULE_SHAPE && typeB == CAPSULE_SHAPE) {
+        pair.type = CAPSULE_CAPSULE;
+    }
+    if (pair.type != OTHER_PAIR) {
+        Group& group = _groups[pair.type];
+        pair.lane = group.size++;
+        group.shapesA.push_back(getShapeIndex(shapeA));
+        group.shapesB.push_back(getShapeIndex(shapeB));
+    }
+    _pairs.push_back(pair);
+}
+
+bool ShapePairBatch::collide(CollisionList& collisions) {
+    gather();
+    collideSpheres();
+    collideSphereCapsules();
+    collideCapsules();
+
+    bool collided = false;
+    int numPairs = _pairs.size();
+    for (int i = 0; i < numPairs && !collisions.isFull(); ++i) {
+        const Pair& pair = _pairs[i];
+        int outcome = (pair.type == OTHER_PAIR) ? UNDECIDED : _groups[pair.type].outcomes[pair.lane];
+        if (outcome == UNDECIDED) {
+            collided = ShapeCollider::collideShapes(pair.shapeA, pair.shapeB, collisions) || collided;
+
+        } else if (outcome == COLLIDED) {
+            Group& group = _groups[pair.type];
+            const float* result = &group.results[pair.lane];
+            int stride = group.stride;
+            CollisionInfo* collision = collisions.getNewCollision();
+            collision->_penetration = glm::vec3(result[PENETRATION_X * stride], result[PENETRATION_Y * stride],
+                result[PENETRATION_Z * stride]);
+            collision->_contactPoint = glm::vec3(result[CONTACT_POINT_X * stride], result[CONTACT_POINT_Y * stride],
+                result[CONTACT_POINT_Z * stride]);
+            bool isSwapped = (pair.type == SPHERE_CAPSULE && pair.shapeA->getType() == CAPSULE_SHAPE);
+            collision->_shapeA = isSwapped ? pair.shapeB : pair.shapeA;
+            collision->_shapeB = isSwapped ? pair.shapeA : pair.shapeB;
+            collided = true;
+        }
+    }
+    return collided;
+}
+
+void ShapePairBatch::Group::resize() {
+    stride = (size + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+
+    // the padding lanes are ignored, but must still be the index of a shape
+    shapesA.resize(stride);
+    shapesB.resize(stride);
+    for (int i = size; i < stride; ++i) {
+        shapesA[i] = shapesA[0];
+        shapesB[i] = shapesB[0];
+    }
+    outcomes.resize(stride);
+    results.resize(NUM_RESULT_COLUMNS * stride);
+}
+
+void ShapePairBatch::Group::storeResults(int lane, const Lanes& collided, const Lanes& undecided,
+                                         const Lanes* penetration, const Lanes* contactPoint) {
+    int collidedBits = collided.andNot(undecided).getBits();
+    int undecidedBits = undecided.getBits();
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        outcomes[lane + i] = ((undecidedBits >> i) & 1) ? UNDECIDED : (((collidedBits >> i) & 1) ? COLLIDED : MISSED);
+    }
+    if (collidedBits != 0) {
+        for (int i = 0; i < 3; ++i) {
+            penetration[i].store(getResults(PENETRATION_X + i) + lane);
+            contactPoint[i].store(getResults(CONTACT_POINT_X + i) + lane);
+        }
+    }
+}
+
+void ShapePairBatch::Group::storeMisses(int lane) {
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        outcomes[lane + i] = MISSED;
+    }
+}
+
+int ShapePairBatch::getShapeIndex(const Shape* shape) {
+    // open addressing, in a table kept at least twice as large as the number of shapes so that it never fills
+    if (_shapeTable.size() < 2 * (_shapes.size() + 1)) {
+        _shapeTable.assign(std::max(MIN_SHAPE_TABLE_SIZE, 2 * _shapeTable.size()), EMPTY_SHAPE_SLOT);
+        size_t mask = _shapeTable.size() - 1;
+        for (size_t i = 0; i < _shapes.size(); ++i) {
+            size_t slot = qHash(_shapes[i]) & mask;
+            while (_shapeTable[slot] != EMPTY_SHAPE_SLOT) {
+                slot = (slot + 1) & mask;
+            }
+            _shapeTable[slot] = i;
+        }
+    }
+    size_t mask = _shapeTable.size() - 1;
+    size_t slot = qHash(shape) & mask;
+    while (_shapeTable[slot] != EMPTY_SHAPE_SLOT) {
+        int index = _shapeTable[slot];
+        if (_shapes[index] == shape) {
+            return index;
+        }
+        slot = (slot + 1) & mask;
+    }
+    int index = _shapes.size();
+    _shapeTable[slot] = index;
+    _shapes.push_back(shape);
+    return index;
+}
+
+void ShapePairBatch::gather() {
+    int numShapes = _shapes.size();
+    _shapeColumns.resize(NUM_SHAPE_COLUMNS * numShapes);
+    float* shape = numShapes > 0 ? &_shapeColumns[0] : NULL;
+    for (int i = 0; i < numShapes; ++i, ++shape) {
+        const glm::vec3& center = _shapes[i]->getTranslation();
+        shape[SHAPE_X * numShapes] = center.x;
+        shape[SHAPE_Y * numShapes] = center.y;
+        shape[SHAPE_Z * numShapes] = center.z;
+        if (_shapes[i]->getType() == SPHERE_SHAPE) {
+            shape[SHAPE_RADIUS * numShapes] = static_cast<const SphereShape*>(_shapes[i])->getRadius();
+            shape[SHAPE_AXIS_X * numShapes] = 0.0f;
+            shape[SHAPE_AXIS_Y * numShapes] = 0.0f;
+            shape[SHAPE_AXIS_Z * numShapes] = 0.0f;
+            shape[SHAPE_HALF_HEIGHT * numShapes] = 0.0f;
+        } else {
+            const CapsuleShape* capsule = static_cast<const CapsuleShape*>(_shapes[i]);
+            glm::vec3 axis;
+            capsule->computeNormalizedAxis(axis);
+            shape[SHAPE_RADIUS * numShapes] = capsule->getRadius();
+            shape[SHAPE_AXIS_X * numShapes] = axis.x;
+            shape[SHAPE_AXIS_Y * numShapes] = axis.y;
+            shape[SHAPE_AXIS_Z * numShapes] = axis.z;
+            shape[SHAPE_HALF_HEIGHT * numShapes] = capsule->getHalfHeight();
+        }
+    }
+    for (int i = 0; i < NUM_BATCHED_TYPES; ++i) {
+        _groups[i].resize();
+    }
+}
+
+void ShapePairBatch::collideSpheres() {
+    // ShapeCollider::sphereVsSphere(), leaving spheres that are on top of each other to it
+    Group& group = _groups[SPHERE_SPHERE];
+    if (group.size == 0) {
+        return;
+    }
+    int numShapes = _shapes.size();
+    const float* x = &_shapeColumns[SHAPE_X * numShapes];
+    const float* y = x + numShapes;
+    const float* z = y + numShapes;
+    const float* radius = z + numShapes;
+    Lanes epsilon = Lanes::splat(EPSILON);
+    for (int i = 0; i < group.size; i += LANE_COUNT) {
+        const int* a = &group.shapesA[i];
+        const int* b = &group.shapesB[i];
+        Lanes ax = Lanes::gather(x, a);
+        Lanes ay = Lanes::gather(y, a);
+        Lanes az = Lanes::gather(z, a);
+        Lanes bax = Lanes::gather(x, b) - ax;
+        Lanes bay = Lanes::gather(y, b) - ay;
+        Lanes baz = Lanes::gather(z, b) - az;
+        Lanes radiusA = Lanes::gather(radius, a);
+        Lanes totalRadius = radiusA + Lanes::gather(radius, b);
+        Lanes distanceSquared = dot(bax, bay, baz, bax, bay, baz);
+        Lanes collided = distanceSquared.lessThan(totalRadius * totalRadius);
+        if (collided.getBits() == 0) {
+            group.storeMisses(i);
+            continue;
+        }
+        Lanes distance = distanceSquared.sqrt();
+        Lanes undecided = collided & distance.lessThan(epsilon);
+
+        Lanes normal[] = { bax / distance, bay / distance, baz / distance };
+        Lanes depth = totalRadius - distance;
+        Lanes penetration[] = { normal[0] * depth, normal[1] * depth, normal[2] * depth };
+        Lanes contactPoint[] = { ax + radiusA * normal[0], ay + radiusA * normal[1], az + radiusA * normal[2] };
+        group.storeResults(i, collided, undecided, penetration, contactPoint);
+    }
+}
+
+void ShapePairBatch::collideSphereCapsules() {
+    // ShapeCollider::sphereVsCapsule(), leaving spheres whose centers are on the capsule's axis to it
+    Group& group = _groups[SPHERE_CAPSULE];
+    if (group.size == 0) {
+        return;
+    }
+    int numShapes = _shapes.size();
+    const float* x = &_shapeColumns[SHAPE_X * numShapes];
+    const float* y = x + numShapes;
+    const float* z = y + numShapes;
+    const float* radius = z + numShapes;
+    const float* axisXs = radius + numShapes;
+    const float* axisYs = axisXs + numShapes;
+    const float* axisZs = axisYs + numShapes;
+    const float* halfHeights = axisZs + numShapes;
+    Lanes zero = Lanes::splat(0.0f);
+    Lanes epsilonSquared = Lanes::splat(EPSILON * EPSILON);
+    for (int i = 0; i < group.size; i += LANE_COUNT) {
+        const int* sphere = &group.shapesA[i];
+        const int* capsule = &group.shapesB[i];
+        Lanes sx = Lanes::gather(x, sphere);
+        Lanes sy = Lanes::gather(y, sphere);
+        Lanes sz = Lanes::gather(z, sphere);
+        Lanes bax = Lanes::gather(x, capsule) - sx;
+        Lanes bay = Lanes::gather(y, capsule) - sy;
+        Lanes baz = Lanes::gather(z, capsule) - sz;
+        Lanes axisX = Lanes::gather(axisXs, capsule);
+        Lanes axisY = Lanes::gather(axisYs, capsule);
+        Lanes axisZ = Lanes::gather(axisZs, capsule);
+        Lanes halfHeight = Lanes::gather(halfHeights, capsule);
+        Lanes sphereRadius = Lanes::gather(radius, sphere);
+        Lanes totalRadius = sphereRadius + Lanes::gather(radius, capsule);
+        Lanes totalRadiusSquared = totalRadius * totalRadius;
+
+        // the sphere must be near the segment along the axis, and near the axis across it
+        Lanes axialDistance = zero - dot(bax, bay, baz, axisX, axisY, axisZ);
+        Lanes absAxialDistance = axialDistance.abs();
+        Lanes radialX = bax + axialDistance * axisX;
+        Lanes radialY = bay + axialDistance * axisY;
+        Lanes radialZ = baz + axialDistance * axisZ;
+        Lanes radialDistanceSquared = dot(radialX, radialY, radialZ, radialX, radialY, radialZ);
+        Lanes collided = absAxialDistance.lessThan(totalRadius + halfHeight).andNot(
+            radialDistanceSquared.greaterThan(totalRadiusSquared));
+        if (collided.getBits() == 0) {
+            group.storeMisses(i);
+            continue;
+        }
+
+        // beyond the segment, the sphere hits a cap, so the nearest point is the end of the segment
+        Lanes onCap = absAxialDistance.greaterThan(halfHeight);
+        Lanes capDistance = Lanes::select(axialDistance.greaterThan(zero), halfHeight, zero - halfHeight);
+        Lanes capRadialX = bax + capDistance * axisX;
+        Lanes capRadialY = bay + capDistance * axisY;
+        Lanes capRadialZ = baz + capDistance * axisZ;
+        Lanes capDistanceSquared = dot(capRadialX, capRadialY, capRadialZ, capRadialX, capRadialY, capRadialZ);
+        radialX = Lanes::select(onCap, capRadialX, radialX);
+        radialY = Lanes::select(onCap, capRadialY, radialY);
+        radialZ = Lanes::select(onCap, capRadialZ, radialZ);
+        radialDistanceSquared = Lanes::select(onCap, capDistanceSquared, radialDistanceSquared);
+        collided = collided.andNot(onCap & capDistanceSquared.greaterThan(totalRadiusSquared));
+        Lanes undecided = collided.andNot(radialDistanceSquared.greaterThan(epsilonSquared));
+
+        Lanes radialDistance = radialDistanceSquared.sqrt();
+        Lanes normal[] = { radialX / radialDistance, radialY / radialDistance, radialZ / radialDistance };
+        Lanes depth = totalRadius - radialDistance;
+        Lanes penetration[] = { depth * normal[0], depth * normal[1], depth * normal[2] };
+        Lanes contactPoint[] = { sx + sphereRadius * normal[0], sy + sphereRadius * normal[1],
+            sz + sphereRadius * normal[2] };
+        group.storeResults(i, collided, undecided, penetration, contactPoint);
+    }
+}
+
+void ShapePairBatch::collideCapsules() {
+    // ShapeCollider::capsuleVsCapsule(), leaving nearly parallel capsules and capsules whose nearest points meet to it
+    Group& group = _groups[CAPSULE_CAPSULE];
+    if (group.size == 0) {
+        return;
+    }
+    int numShapes = _shapes.size();
+    const float* x = &_shapeColumns[SHAPE_X * numShapes];
+    const float* y = x + numShapes;
+    const float* z = y + numShapes;
+    const float* radius = z + numShapes;
+    const float* axisXs = radius + numShapes;
+    const float* axisYs = axisXs + numShapes;
+    const float* axisZs = axisYs + numShapes;
+    const float* halfHeights = axisZs + numShapes;
+    Lanes zero = Lanes::splat(0.0f);
+    Lanes one = Lanes::splat(1.0f);
+    Lanes two = Lanes::splat(2.0f);
+    Lanes epsilon = Lanes::splat(EPSILON);
+    Lanes boundScale = Lanes::splat(1.0f + BOUND_SLACK);
+    Lanes boundSlack = Lanes::splat(BOUND_SLACK);
+    for (int i = 0; i < group.size; i += LANE_COUNT) {
+        const int* a = &group.shapesA[i];
+        const int* b = &group.shapesB[i];
+        Lanes ax = Lanes::gather(x, a);
+        Lanes ay = Lanes::gather(y, a);
+        Lanes az = Lanes::gather(z, a);
+        Lanes bx = Lanes::gather(x, b);
+        Lanes by = Lanes::gather(y, b);
+        Lanes bz = Lanes::gather(z, b);
+        Lanes baX = bx - ax;
+        Lanes baY = by - ay;
+        Lanes baZ = bz - az;
+        Lanes halfHeightA = Lanes::gather(halfHeights, a);
+        Lanes halfHeightB = Lanes::gather(halfHeights, b);
+        Lanes radiusA = Lanes::gather(radius, a);
+        Lanes totalRadius = radiusA + Lanes::gather(radius, b);
+
+        // every point of a capsule is within its radius plus half its height of its center, but ShapeCollider treats
+        // nearly parallel capsules as cylinders whose ends can also be the sum of the radii apart across the axis
+        Lanes extent = (totalRadius + halfHeightA + halfHeightB) * boundScale + boundSlack;
+        Lanes across = totalRadius * boundScale + boundSlack;
+        if (dot(baX, baY, baZ, baX, baY, baZ).lessEqual(extent * extent + across * across).getBits() == 0) {
+            group.storeMisses(i);
+            continue;
+        }
+        Lanes axisAX = Lanes::gather(axisXs, a);
+        Lanes axisAY = Lanes::gather(axisYs, a);
+        Lanes axisAZ = Lanes::gather(axisZs, a);
+        Lanes axisBX = Lanes::gather(axisXs, b);
+        Lanes axisBY = Lanes::gather(axisYs, b);
+        Lanes axisBZ = Lanes::gather(axisZs, b);
+
+        Lanes aDotB = dot(axisAX, axisAY, axisAZ, axisBX, axisBY, axisBZ);
+        Lanes denominator = one - aDotB * aDotB;
+        Lanes undecided = denominator.lessEqual(epsilon) | (one - aDotB.abs()).abs().lessThan(epsilon);
+
+        // intersect the axis of A with the cylinder around the axis of B, widened by the radius of A
+        Lanes px = ax - bx;
+        Lanes py = ay - by;
+        Lanes pz = az - bz;
+        Lanes wx = axisAX - aDotB * axisBX;
+        Lanes wy = axisAY - aDotB * axisBY;
+        Lanes wz = axisAZ - aDotB * axisBZ;
+        Lanes pDotB = dot(px, py, pz, axisBX, axisBY, axisBZ);
+        Lanes qx = px - pDotB * axisBX;
+        Lanes qy = py - pDotB * axisBY;
+        Lanes qz = pz - pDotB * axisBZ;
+        Lanes a2 = two * dot(wx, wy, wz, wx, wy, wz);
+        Lanes b2 = two * dot(wx, wy, wz, qx, qy, qz);
+        Lanes determinant = b2 * b2 - two * a2 * (dot(qx, qy, qz, qx, qy, qz) - totalRadius * totalRadius);
+        Lanes collided = determinant.greaterEqual(zero);
+        Lanes firstHit = (zero - b2 - determinant.sqrt()) / a2;
+        Lanes secondHit = zero - (firstHit + two * b2 / a2);
+        Lanes hitLow = firstHit.min(secondHit);
+        Lanes hitHigh = firstHit.max(secondHit);
+        collided = collided.andNot(hitLow.greaterThan(halfHeightA) | hitHigh.lessThan(zero - halfHeightA));
+
+        // the nearest approach of the axes, within the hits and the segment of A
+        Lanes distanceA = dot(baX, baY, baZ, wx, wy, wz) / denominator;
+        distanceA = distanceA.clamp(hitLow, hitHigh).clamp(zero - halfHeightA, halfHeightA);
+
+        // the nearest point of B to that, and if it's off the segment of B, the nearest point of A to the end of B
+        Lanes pointAX = ax + distanceA * axisAX;
+        Lanes pointAY = ay + distanceA * axisAY;
+        Lanes pointAZ = az + distanceA * axisAZ;
+        Lanes distanceB = dot(pointAX - bx, pointAY - by, pointAZ - bz, axisBX, axisBY, axisBZ);
+        Lanes offB = distanceB.abs().greaterThan(halfHeightB);
+        distanceB = Lanes::select(offB, distanceB.clamp(zero - halfHeightB, halfHeightB), distanceB);
+        Lanes pointBX = bx + distanceB * axisBX;
+        Lanes pointBY = by + distanceB * axisBY;
+        Lanes pointBZ = bz + distanceB * axisBZ;
+        Lanes clampedDistanceA = dot(pointBX - ax, pointBY - ay, pointBZ - az, axisAX, axisAY, axisAZ).clamp(
+            zero - halfHeightA, halfHeightA);
+        distanceA = Lanes::select(offB, clampedDistanceA, distanceA);
+        pointAX = ax + distanceA * axisAX;
+        pointAY = ay + distanceA * axisAY;
+        pointAZ = az + distanceA * axisAZ;
+
+        // collide like two spheres at those points
+        Lanes betweenX = pointBX - pointAX;
+        Lanes betweenY = pointBY - pointAY;
+        Lanes betweenZ = pointBZ - pointAZ;
+        Lanes distanceSquared = dot(betweenX, betweenY, betweenZ, betweenX, betweenY, betweenZ);
+        collided = collided & distanceSquared.lessThan(totalRadius * totalRadius);
+        Lanes distance = distanceSquared.sqrt();
+        undecided = undecided | (collided & distance.lessThan(epsilon));
+
+        Lanes normal[] = { betweenX / distance, betweenY / distance, betweenZ / distance };
+        Lanes depth = totalRadius - distance;
+        Lanes penetration[] = { normal[0] * depth, normal[1] * depth, normal[2] * depth };
+        Lanes contactPoint[] = { pointAX + radiusA * normal[0], pointAY + radiusA * normal[1],
+            pointAZ + radiusA * normal[2] };
+        group.storeResults(i, collided, undecided, penetration, contactPoint);
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  ShapePairBatch.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A list of shape pairs that are collided together. The positions and sizes of the shapes are gathered into arrays of
+//  floats, once per shape, and the pairs are grouped by the types of their shapes and collided four at a time, with the
+//  math of ShapeCollider's sphere and capsule kernels. The rare pairs that those kernels handle with a special case, such
+//  as concentric spheres or parallel capsules, and pairs of other types, are left to ShapeCollider. The collisions are
+//  appended in the order the pairs were added, so a batch finds the collisions that colliding each of its pairs would, to
+//  within rounding.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ShapePairBatch_h
+#define hifi_ShapePairBatch_h
+
+#include <vector>
+
+#include <QtGlobal>
+
+#include "CollisionInfo.h"
+
+class Lanes;
+class Shape;
+
+class ShapePairBatch {
+public:
+    ShapePairBatch();
+
+    /// Removes all pairs, keeping the memory for reuse.
+    void clear();
+
+    /// Adds a pair of shapes that may collide, neither of which can be NULL.
+    void addPair(const Shape* shapeA, const Shape* shapeB);
+
+    int size() const { return _pairs.size(); }
+    bool isEmpty() const { return _pairs.empty(); }
+
+    /// Collides every pair, using the current positions of their shapes, until collisions is full.
+    /// \param[out] collisions where to append collision details
+    /// \return true if any pair collided
+    bool collide(CollisionList& collisions);
+
+private:
+    enum PairType { SPHERE_SPHERE, SPHERE_CAPSULE, CAPSULE_CAPSULE, NUM_BATCHED_TYPES, OTHER_PAIR = NUM_BATCHED_TYPES };
+
+    enum Outcome { MISSED, COLLIDED, UNDECIDED };
+
+    class Pair {
+    public:
+        const Shape* shapeA;
+        const Shape* shapeB;
+        int type;
+        int lane; // index in the group of its type
+    };
+
+    /// The pairs of one type, as the indices of their shapes, and what colliding them found, padded to whole sets of four.
+    /// A sphere and a capsule are always in that order.
+    class Group {
+    public:
+        /// Pads the pairs to whole sets of four and makes room for their results, reusing the memory of earlier batches.
+        void resize();
+        float* getResults(int column) { return &results[column * stride]; }
+
+        /// Stores the outcomes of four pairs, starting at the given lane, and the collisions of the ones that collided.
+        void storeResults(int lane, const Lanes& collided, const Lanes& undecided, const Lanes* penetration,
+                          const Lanes* contactPoint);
+
+        /// Stores that none of four pairs, starting at the given lane, collided.
+        void storeMisses(int lane);
+
+        int size;
+        int stride; // size rounded up to a multiple of four
+        std::vector<int> shapesA;
+        std::vector<int> shapesB;
+        std::vector<quint8> outcomes;
+        std::vector<float> results; // the penetrations and contact points
+    };
+
+    int getShapeIndex(const Shape* shape);
+
+    void gather();
+    void collideSpheres();
+    void collideSphereCapsules();
+    void collideCapsules();
+
+    std::vector<Pair> _pairs;
+    Group _groups[NUM_BATCHED_TYPES];
+
+    std::vector<const Shape*> _shapes;
+    std::vector<int> _shapeTable; // the indices of the shapes, hashed by their addresses
+    std::vector<float> _shapeColumns; // the position and size of each shape, one column of floats per value
+};
+
+#endif // hifi_ShapePairBatch_h
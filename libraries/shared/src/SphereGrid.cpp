@@ -0,0 +1,185 @@
+//
+//  SphereGrid.cpp
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "SphereGrid.h"
+
+const int SphereGrid::MAX_CELLS_PER_SPHERE;
+
+const int MIN_BUCKET_COUNT = 16;
+
+int SphereGrid::CellRange::getCellCount() const {
+    glm::ivec3 size = maximum - minimum + glm::ivec3(1);
+    // compare one axis at a time, so that a sphere much larger than the cells doesn't overflow the count
+    if (size.x > MAX_CELLS_PER_SPHERE || size.y > MAX_CELLS_PER_SPHERE || size.z > MAX_CELLS_PER_SPHERE) {
+        return MAX_CELLS_PER_SPHERE + 1;
+    }
+    return size.x * size.y * size.z;
+}
+
+SphereGrid::SphereGrid() :
+    _cellSize(1.0f),
+    _margin(0.0f),
+    _isBuilt(false),
+    _bucketMask(0) {
+}
+
+void SphereGrid::clear(float cellSize, float margin) {
+    _cellSize = (cellSize > 0.0f) ? cellSize : 1.0f;
+    _margin = margin;
+    _spheres.clear();
+    _isBuilt = false;
+}
+
+void SphereGrid::add(const glm::vec3& center, float radius) {
+    _spheres.push_back(glm::vec4(center, radius));
+    _isBuilt = false;
+}
+
+void SphereGrid::move(int sphere, const glm::vec3& center) {
+    _spheres[sphere] = glm::vec4(center, _spheres[sphere].w);
+    if (!_isBuilt) {
+        return;
+    }
+    CellRange range;
+    getCellRange(center, _spheres[sphere].w + _margin, range);
+    if (range.getCellCount() > MAX_CELLS_PER_SPHERE) {
+        _largeSpheres.push_back(sphere);
+        return;
+    }
+    for (int z = range.minimum.z; z <= range.maximum.z; z++) {
+        for (int y = range.minimum.y; y <= range.maximum.y; y++) {
+            for (int x = range.minimum.x; x <= range.maximum.x; x++) {
+                int bucket = getBucket(x, y, z);
+                MovedEntry entry = { sphere, _movedBucketHeads[bucket] };
+                _movedBucketHeads[bucket] = _movedEntries.size();
+                _movedEntries.push_back(entry);
+            }
+        }
+    }
+}
+
+void SphereGrid::getCellRange(const glm::vec3& center, float radius, CellRange& range) const {
+    range.minimum = glm::ivec3(glm::floor((center - glm::vec3(radius)) / _cellSize));
+    range.maximum = glm::ivec3(glm::floor((center + glm::vec3(radius)) / _cellSize));
+}
+
+int SphereGrid::getBucket(int x, int y, int z) const {
+    const unsigned int PRIME_X = 73856093;
+    const unsigned int PRIME_Y = 19349663;
+    const unsigned int PRIME_Z = 83492791;
+    return (int)(((unsigned int)x * PRIME_X) ^ ((unsigned int)y * PRIME_Y) ^ ((unsigned int)z * PRIME_Z)) & _bucketMask;
+}
+
+bool SphereGrid::overlaps(int sphere, const glm::vec3& center, float radius) const {
+    const glm::vec4& other = _spheres[sphere];
+    glm::vec3 offset = center - glm::vec3(other);
+    float limit = radius + other.w + _margin;
+    return glm::dot(offset, offset) <= limit * limit;
+}
+
+void SphereGrid::build() {
+    int bucketCount = MIN_BUCKET_COUNT;
+    while (bucketCount < (int)_spheres.size() * 2) {
+        bucketCount *= 2;
+    }
+    _bucketMask = bucketCount - 1;
+    _bucketStarts.assign(bucketCount + 1, 0);
+    _largeSpheres.clear();
+    _movedBucketHeads.assign(bucketCount, -1);
+    _movedEntries.clear();
+
+    // count the entries of each bucket, then turn the counts into the ends of the buckets
+    int sphereCount = _spheres.size();
+    CellRange range;
+    for (int i = 0; i < sphereCount; i++) {
+        getCellRange(glm::vec3(_spheres[i]), _spheres[i].w + _margin, range);
+        if (range.getCellCount() > MAX_CELLS_PER_SPHERE) {
+            _largeSpheres.push_back(i);
+            continue;
+        }
+        for (int z = range.minimum.z; z <= range.maximum.z; z++) {
+            for (int y = range.minimum.y; y <= range.maximum.y; y++) {
+                for (int x = range.minimum.x; x <= range.maximum.x; x++) {
+                    _bucketStarts[getBucket(x, y, z)]++;
+                }
+            }
+        }
+    }
+    for (int bucket = 1; bucket <= bucketCount; bucket++) {
+        _bucketStarts[bucket] += _bucketStarts[bucket - 1];
+    }
+
+    // fill the buckets from their ends, walking the spheres backwards so that each bucket is in increasing order
+    _bucketSpheres.resize(_bucketStarts[bucketCount]);
+    for (int i = sphereCount - 1; i >= 0; i--) {
+        getCellRange(glm::vec3(_spheres[i]), _spheres[i].w + _margin, range);
+        if (range.getCellCount() > MAX_CELLS_PER_SPHERE) {
+            continue;
+        }
+        for (int z = range.minimum.z; z <= range.maximum.z; z++) {
+            for (int y = range.minimum.y; y <= range.maximum.y; y++) {
+                for (int x = range.minimum.x; x <= range.maximum.x; x++) {
+                    _bucketSpheres[--_bucketStarts[getBucket(x, y, z)]] = i;
+                }
+            }
+        }
+    }
+    _isBuilt = true;
+}
+
+bool SphereGrid::findOverlapping(const glm::vec3& center, float radius, std::vector<int>& overlapping) {
+    overlapping.clear();
+    if (!_isBuilt) {
+        build();
+    }
+    CellRange range;
+    getCellRange(center, radius, range);
+    if (range.getCellCount() > MAX_CELLS_PER_SPHERE) {
+        int sphereCount = _spheres.size();
+        for (int i = 0; i < sphereCount; i++) {
+            if (overlaps(i, center, radius)) {
+                overlapping.push_back(i);
+            }
+        }
+        return !overlapping.empty();
+    }
+
+    for (int z = range.minimum.z; z <= range.maximum.z; z++) {
+        for (int y = range.minimum.y; y <= range.maximum.y; y++) {
+            for (int x = range.minimum.x; x <= range.maximum.x; x++) {
+                int bucket = getBucket(x, y, z);
+                for (int i = _bucketStarts[bucket]; i < _bucketStarts[bucket + 1]; i++) {
+                    if (overlaps(_bucketSpheres[i], center, radius)) {
+                        overlapping.push_back(_bucketSpheres[i]);
+                    }
+                }
+                for (int i = _movedBucketHeads[bucket]; i != -1; i = _movedEntries[i].next) {
+                    if (overlaps(_movedEntries[i].sphere, center, radius)) {
+                        overlapping.push_back(_movedEntries[i].sphere);
+                    }
+                }
+            }
+        }
+    }
+    for (std::vector<int>::const_iterator sphere = _largeSpheres.begin(); sphere != _largeSpheres.end(); ++sphere) {
+        if (overlaps(*sphere, center, radius)) {
+            overlapping.push_back(*sphere);
+        }
+    }
+
+    // a sphere is in every bucket that one of its cells hashes to, and a moved one can be in a bucket twice, so it can be
+    // found more than once
+    std::sort(overlapping.begin(), overlapping.end());
+    overlapping.erase(std::unique(overlapping.begin(), overlapping.end()), overlapping.end());
+    return !overlapping.empty();
+}
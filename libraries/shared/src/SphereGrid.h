@@ -0,0 +1,88 @@
+//
+//  SphereGrid.h
+//  libraries/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A broadphase for sphere overlap tests: a hashed uniform grid of spheres that finds the ones that may overlap a given
+//  sphere without testing all of them. It is rebuilt rather than updated, and rebuilding reuses its arrays, so a grid
+//  that is refilled every frame with about the same number of spheres doesn't allocate. The few spheres that move between
+//  rebuilds are added to the cells at their new centers, in lists beside the buckets.
+//
+//  Lookups are conservative. Every sphere is grown by a margin, so that callers can run their exact tests in other
+//  units or with other rounding, and be sure not to miss anything the grid left out.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SphereGrid_h
+#define hifi_SphereGrid_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class SphereGrid {
+public:
+    // spheres or lookups that span more cells than this are tested against everything instead
+    static const int MAX_CELLS_PER_SPHERE = 64;
+
+    SphereGrid();
+
+    /// Removes all spheres.
+    /// \param cellSize the edge of a cell, best about the diameter of the largest sphere that will be added or looked up
+    /// \param margin how much every sphere is grown by when looking for overlaps
+    void clear(float cellSize, float margin = 0.0f);
+
+    /// Adds a sphere. Spheres are identified by the order that they were added in, starting at 0.
+    void add(const glm::vec3& center, float radius);
+
+    /// Moves a sphere to a new center, so that lookups find it there from now on. The cells at its old center keep it until
+    /// the next rebuild, but lookups test it at its new center, so they don't find it there.
+    void move(int sphere, const glm::vec3& center);
+
+    /// Finds the spheres that may overlap a sphere.
+    /// \param overlapping[out] the indices of the spheres in increasing order, any initial contents are lost
+    /// \return true if any were found
+    bool findOverlapping(const glm::vec3& center, float radius, std::vector<int>& overlapping);
+
+    int getSphereCount() const { return _spheres.size(); }
+
+private:
+    class CellRange {
+    public:
+        glm::ivec3 minimum;
+        glm::ivec3 maximum;
+
+        int getCellCount() const;
+    };
+
+    class MovedEntry {
+    public:
+        int sphere;
+        int next; // the next entry in the same bucket, or -1
+    };
+
+    void build();
+    void getCellRange(const glm::vec3& center, float radius, CellRange& range) const;
+    int getBucket(int x, int y, int z) const;
+    bool overlaps(int sphere, const glm::vec3& center, float radius) const;
+
+    float _cellSize;
+    float _margin;
+    std::vector<glm::vec4> _spheres; // center and radius
+    bool _isBuilt;
+
+    // the spheres in each bucket are _bucketSpheres[_bucketStarts[bucket]] up to _bucketSpheres[_bucketStarts[bucket + 1]]
+    int _bucketMask;
+    std::vector<int> _bucketStarts;
+    std::vector<int> _bucketSpheres;
+    std::vector<int> _largeSpheres; // in no bucket, because they span too many cells
+
+    // the spheres that moved since the grid was built, each bucket is a list starting at _movedBucketHeads[bucket]
+    std::vector<int> _movedBucketHeads;
+    std::vector<MovedEntry> _movedEntries;
+};
+
+#endif // hifi_SphereGrid_h
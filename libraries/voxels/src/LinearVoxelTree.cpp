@@ -0,0 +1,458 @@
+//
+//  LinearVoxelTree.cpp
+//  libraries/voxels/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <assert.h>
+#include <cfloat>
+#include <cstring>
+
+#include <QtCore/QDebug>
+
+#include <GeometryUtil.h>
+#include <OctalCode.h>
+#include <OctreeConstants.h>
+#include <OctreePacketData.h>
+
+#include "LinearVoxelTree.h"
+#include "VoxelTree.h"
+
+// the Morton code keeps its top bit clear, so the first level's section lives in bits 62-60
+const int MORTON_CODE_TOP_SECTION_SHIFT = 60;
+
+static int sectionShiftForLevel(int level) {
+    return MORTON_CODE_TOP_SECTION_SHIFT - (BITS_IN_OCTAL * level);
+}
+
+static bool lessThanMortonOrder(const LinearVoxel& a, const LinearVoxel& b) {
+    // shallower voxels sort ahead of deeper ones with the same code, which puts a voxel ahead of anything inside it
+    return (a.mortonCode < b.mortonCode) || (a.mortonCode == b.mortonCode && a.level < b.level);
+}
+
+static bool lessThanMortonCode(const LinearVoxel& voxel, quint64 mortonCode) {
+    return voxel.mortonCode < mortonCode;
+}
+
+LinearVoxelTree::LinearVoxelTree() :
+    _voxels(),
+    _isSorted(true)
+{
+}
+
+void LinearVoxelTree::clear() {
+    _voxels.clear();
+    _isSorted = true;
+}
+
+quint64 LinearVoxelTree::mortonCodeForOctalCode(const unsigned char* octalCode, int level) {
+    quint64 mortonCode = 0;
+    const unsigned char* sections = octalCode + 1;
+    int bits = level * BITS_IN_OCTAL;
+    for (int bit = 0; bit < bits; bit++) {
+        if ((sections[bit / 8] >> (7 - (bit % 8))) & 1) {
+            mortonCode |= (quint64)1 << (MORTON_CODE_TOP_SECTION_SHIFT + 2 - bit);
+        }
+    }
+    return mortonCode;
+}
+
+AACube LinearVoxelTree::cubeForCode(quint64 mortonCode, int level) {
+    // same walk as copyFirstVertexForCode(), section bits are x, y, z from most to least significant
+    glm::vec3 corner(0.0f, 0.0f, 0.0f);
+    float scale = 1.0f;
+    for (int i = 0; i < level; i++) {
+        scale *= 0.5f;
+        int section = (int)((mortonCode >> sectionShiftForLevel(i)) & 7);
+        corner.x += (section & 4) ? scale : 0.0f;
+        corner.y += (section & 2) ? scale : 0.0f;
+        corner.z += (section & 1) ? scale : 0.0f;
+    }
+    return AACube(corner, scale);
+}
+
+bool LinearVoxelTree::addVoxel(const unsigned char* octalCode, const rgbColor& color) {
+    int level = numberOfThreeBitSectionsInCode(octalCode);
+    if (level > MAX_LEVELS) {
+        return false;
+    }
+    LinearVoxel voxel;
+    voxel.mortonCode = mortonCodeForOctalCode(octalCode, level);
+    voxel.level = level;
+    memcpy(voxel.color, color, sizeof(voxel.color));
+    _voxels.append(voxel);
+    _isSorted = false;
+    return true;
+}
+
+void LinearVoxelTree::finalize() {
+    if (!_isSorted) {
+        std::sort(_voxels.begin(), _voxels.end(), lessThanMortonOrder);
+        _voxels.squeeze();
+        _isSorted = true;
+    }
+}
+
+class BuildLinearVoxelTreeArgs {
+public:
+    LinearVoxelTree* linearTree;
+    int skippedTooDeep;
+};
+
+static bool buildLinearVoxelTreeOperation(OctreeElement* element, void* extraData) {
+    BuildLinearVoxelTreeArgs* args = static_cast<BuildLinearVoxelTreeArgs*>(extraData);
+    VoxelTreeElement* voxel = static_cast<VoxelTreeElement*>(element);
+    if (voxel->isLeaf() && voxel->isColored()) {
+        rgbColor color = { voxel->getColor()[RED_INDEX], voxel->getColor()[GREEN_INDEX], voxel->getColor()[BLUE_INDEX] };
+        if (!args->linearTree->addVoxel(voxel->getOctalCode(), color)) {
+            args->skippedTooDeep++;
+        }
+    }
+    return true; // keep going
+}
+
+void LinearVoxelTree::buildFromTree(VoxelTree* tree) {
+    clear();
+    BuildLinearVoxelTreeArgs args = { this, 0 };
+    tree->recurseTreeWithOperation(buildLinearVoxelTreeOperation, &args);
+    finalize();
+    if (args.skippedTooDeep > 0) {
+        qDebug() << "LinearVoxelTree::buildFromTree() skipped" << args.skippedTooDeep
+                 << "voxels deeper than" << MAX_LEVELS << "levels";
+    }
+}
+
+void LinearVoxelTree::writeOctalCode(quint64 mortonCode, int level, unsigned char* octalCode) {
+    memset(octalCode, 0, bytesRequiredForCodeLength(level));
+    octalCode[0] = level;
+    int bits = level * BITS_IN_OCTAL;
+    for (int bit = 0; bit < bits; bit++) {
+        if ((mortonCode >> (MORTON_CODE_TOP_SECTION_SHIFT + 2 - bit)) & 1) {
+            octalCode[1 + (bit / 8)] |= (1 << (7 - (bit % 8)));
+        }
+    }
+}
+
+void LinearVoxelTree::writeVoxelOctalCode(int index, unsigned char* octalCode) const {
+    writeOctalCode(_voxels[index].mortonCode, _voxels[index].level, octalCode);
+}
+
+unsigned char* LinearVoxelTree::getVoxelOctalCode(int index) const {
+    unsigned char* octalCode = new unsigned char[bytesRequiredForCodeLength(_voxels[index].level)];
+    writeVoxelOctalCode(index, octalCode);
+    return octalCode;
+}
+
+// the octal code of a MAX_LEVELS deep voxel: the length byte plus 63 bits of sections
+const int MAX_OCTAL_CODE_BYTES = 1 + (LinearVoxelTree::MAX_LEVELS * BITS_IN_OCTAL + 7) / 8;
+
+void LinearVoxelTree::writeToTree(VoxelTree* tree, bool destructive) const {
+    // readCodeColorBufferToTree() expects the color to follow the code, every voxel is built in the same buffer
+    unsigned char codeColorBuffer[MAX_OCTAL_CODE_BYTES + SIZE_OF_COLOR_DATA];
+    for (int i = 0; i < _voxels.size(); i++) {
+        writeVoxelOctalCode(i, codeColorBuffer);
+        size_t codeBytes = bytesRequiredForCodeLength(_voxels[i].level);
+        memcpy(codeColorBuffer + codeBytes, _voxels[i].color, SIZE_OF_COLOR_DATA);
+        tree->readCodeColorBufferToTree(codeColorBuffer, destructive);
+    }
+}
+
+int LinearVoxelTree::encodeSubTree(const LinearSubTree& subTree, OctreePacketData* packetData,
+                                   QVector<LinearSubTree>& remaining) const {
+    assert(_isSorted);
+    unsigned char octalCode[MAX_OCTAL_CODE_BYTES];
+    writeOctalCode(subTree.mortonCode, subTree.level, octalCode);
+    if (!packetData->startSubTree(octalCode)) {
+        remaining.append(subTree);
+        return 0;
+    }
+    int bytesWritten = bytesRequiredForCodeLength(subTree.level);
+
+    int begin = lowerBound(subTree.mortonCode, 0, _voxels.size());
+    int end = _voxels.size();
+    if (subTree.level > 0) {
+        end = lowerBound(subTree.mortonCode + ((quint64)1 << sectionShiftForLevel(subTree.level - 1)), begin, end);
+    }
+    int childBytesWritten = encodeRange(subTree.mortonCode, subTree.level, begin, end, packetData, remaining);
+
+    // same as encodeTreeBitstream(), if nothing below the octal code was written, the octal code isn't either
+    if (childBytesWritten) {
+        bytesWritten += childBytesWritten;
+    } else {
+        bytesWritten = 0;
+    }
+    if (bytesWritten == 0) {
+        packetData->discardSubTree();
+    } else {
+        packetData->endSubTree();
+    }
+    return bytesWritten;
+}
+
+// encodeTreeBitstreamRecursion() without a view: every child that exists is sent with its color, and every child that
+// isn't a leaf is recursed
+int LinearVoxelTree::encodeRange(quint64 prefix, int level, int begin, int end, OctreePacketData* packetData,
+                                 QVector<LinearSubTree>& remaining) const {
+    assert(level < MAX_LEVELS);
+    int remainingAtStart = remaining.size();
+
+    // voxels at or above this level fill it, only ones inside of it are its children
+    int index = begin;
+    while (index < end && _voxels[index].level <= level) {
+        index++;
+    }
+    int childBegins[NUMBER_OF_CHILDREN];
+    int childEnds[NUMBER_OF_CHILDREN];
+    unsigned char childrenExistBits = 0;
+    unsigned char childrenExistInPacketBits = 0;
+    int shift = sectionShiftForLevel(level);
+    for (int child = 0; child < NUMBER_OF_CHILDREN; child++) {
+        quint64 childPrefix = prefix | ((quint64)child << shift);
+        childBegins[child] = index;
+        childEnds[child] = lowerBound(childPrefix + ((quint64)1 << shift), index, end);
+        index = childEnds[child];
+        if (childBegins[child] < childEnds[child]) {
+            childrenExistBits += (1 << (7 - child));
+
+            // a voxel hides anything inside of it, so a child that starts with a voxel of its own size is a leaf
+            if (_voxels[childBegins[child]].level != level + 1) {
+                childrenExistInPacketBits += (1 << (7 - child));
+            }
+        }
+    }
+
+    int bytesAtThisLevel = 0;
+    LevelDetails thisLevelKey = packetData->startLevel();
+
+    // without a view every child that exists is colored
+    bool continueThisLevel = packetData->appendBitMask(childrenExistBits);
+    if (continueThisLevel) {
+        bytesAtThisLevel += sizeof(childrenExistBits);
+    }
+    for (int child = 0; continueThisLevel && child < NUMBER_OF_CHILDREN; child++) {
+        if (oneAtBit(childrenExistBits, child)) {
+            int bytesBeforeChild = packetData->getUncompressedSize();
+            if (oneAtBit(childrenExistInPacketBits, child)) {
+                nodeColor color;
+                float density;
+                averageRange(prefix | ((quint64)child << shift), level + 1, childBegins[child], childEnds[child], color,
+                             density);
+                continueThisLevel = packetData->appendColor(color);
+            } else {
+                continueThisLevel = packetData->appendColor(_voxels[childBegins[child]].color);
+            }
+            if (continueThisLevel) {
+                bytesAtThisLevel += packetData->getUncompressedSize() - bytesBeforeChild;
+            }
+        }
+    }
+
+    // the exists in tree bits, then the exists in packet bits that are repaired as the child trees are written
+    if (continueThisLevel) {
+        continueThisLevel = packetData->appendBitMask(childrenExistBits);
+        if (continueThisLevel) {
+            bytesAtThisLevel += sizeof(childrenExistBits);
+        }
+    }
+    if (continueThisLevel) {
+        continueThisLevel = packetData->appendBitMask(childrenExistInPacketBits);
+        if (continueThisLevel) {
+            bytesAtThisLevel += sizeof(childrenExistInPacketBits);
+        }
+    }
+    if (continueThisLevel && childrenExistInPacketBits) {
+        int childExistsPlaceHolder = packetData->getUncompressedByteOffset(sizeof(childrenExistInPacketBits));
+        for (int child = 0; child < NUMBER_OF_CHILDREN; child++) {
+            if (oneAtBit(childrenExistInPacketBits, child)) {
+                int childTreeBytesOut = encodeRange(prefix | ((quint64)child << shift), level + 1, childBegins[child],
+                                                    childEnds[child], packetData, remaining);
+                bytesAtThisLevel += childTreeBytesOut;
+
+                // a child tree that didn't fit is left for a later packet, and out of this one
+                if (childTreeBytesOut == 0) {
+                    childrenExistInPacketBits -= (1 << (7 - child));
+                    continueThisLevel = packetData->updatePriorBitMask(childExistsPlaceHolder, childrenExistInPacketBits);
+                    if (!continueThisLevel) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    if (continueThisLevel) {
+        continueThisLevel = packetData->endLevel(thisLevelKey);
+    } else {
+        packetData->discardLevel(thisLevelKey);
+    }
+    if (!continueThisLevel) {
+        // this level is sent later, and with it the children that didn't fit
+        remaining.resize(remainingAtStart);
+        LinearSubTree subTree = { prefix, level };
+        remaining.append(subTree);
+        bytesAtThisLevel = 0;
+    }
+    return bytesAtThisLevel;
+}
+
+// the color and density that VoxelTreeElement::calculateAverageFromChildren() gives the element, from the voxels below it
+void LinearVoxelTree::averageRange(quint64 prefix, int level, int begin, int end, nodeColor& color,
+                                   float& density) const {
+    if (_voxels[begin].level <= level) {
+        memcpy(color, _voxels[begin].color, SIZE_OF_COLOR_DATA);
+        color[3] = 1;
+        density = 1.0f; // a colored leaf
+        return;
+    }
+    int colorSums[4] = { 0, 0, 0, 0 };
+    density = 0.0f;
+    int index = begin;
+    int shift = sectionShiftForLevel(level);
+    for (int child = 0; child < NUMBER_OF_CHILDREN && index < end; child++) {
+        quint64 childPrefix = prefix | ((quint64)child << shift);
+        int childEnd = lowerBound(childPrefix + ((quint64)1 << shift), index, end);
+        if (index < childEnd) {
+            nodeColor childColor;
+            float childDensity;
+            averageRange(childPrefix, level + 1, index, childEnd, childColor, childDensity);
+            if (childColor[3]) {
+                for (int j = 0; j < 3; j++) {
+                    colorSums[j] += childColor[j];
+                }
+                colorSums[3]++;
+            }
+            density += childDensity;
+        }
+        index = childEnd;
+    }
+    density /= (float)NUMBER_OF_CHILDREN;
+
+    const float VISIBLE_ABOVE_DENSITY = 0.10f; // same as VoxelTreeElement's
+    memset(color, 0, sizeof(nodeColor));
+    if (density > VISIBLE_ABOVE_DENSITY) {
+        for (int j = 0; j < 3; j++) {
+            color[j] = colorSums[j] / colorSums[3];
+        }
+        color[3] = 1;
+    }
+}
+
+int LinearVoxelTree::lowerBound(quint64 mortonCode, int begin, int end) const {
+    QVector<LinearVoxel>::const_iterator first = _voxels.constBegin();
+    return std::lower_bound(first + begin, first + end, mortonCode, lessThanMortonCode) - first;
+}
+
+class LinearVoxelTree::RayQuery {
+public:
+    glm::vec3 origin; // voxel units
+    glm::vec3 direction;
+    float distance; // meters, like Octree::findRayIntersection()
+    BoxFace face;
+    int voxelIndex;
+};
+
+bool LinearVoxelTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                          float& distance, BoxFace& face, int& voxelIndex) const {
+    assert(_isSorted);
+    RayQuery query = { origin / (float)TREE_SCALE, direction, FLT_MAX, UNKNOWN_FACE, -1 };
+    findRayIntersectionInRange(query, 0, 0, 0, _voxels.size());
+    if (query.voxelIndex < 0) {
+        return false;
+    }
+    distance = query.distance;
+    face = query.face;
+    voxelIndex = query.voxelIndex;
+    return true;
+}
+
+void LinearVoxelTree::findRayIntersectionInRange(RayQuery& query, quint64 prefix, int level, int begin, int end) const {
+    if (begin >= end) {
+        return;
+    }
+    AACube cube = cubeForCode(prefix, level);
+    float cubeDistance;
+    BoxFace cubeFace;
+    if (!cube.findRayIntersection(query.origin, query.direction, cubeDistance, cubeFace)) {
+        return; // nothing inside this cube can be hit
+    }
+    // when the origin is inside the cube the distance is to the exit face, so only prune on distance from outside
+    if (!cube.contains(query.origin) && cubeDistance * TREE_SCALE >= query.distance) {
+        return;
+    }
+
+    // voxels at exactly this level fill the cube, they sort ahead of everything below them
+    int index = begin;
+    while (index < end && _voxels[index].level == level) {
+        if (cubeDistance * TREE_SCALE < query.distance) {
+            query.distance = cubeDistance * TREE_SCALE;
+            query.face = cubeFace;
+            query.voxelIndex = index;
+        }
+        index++;
+    }
+    if (level >= MAX_LEVELS) {
+        return;
+    }
+
+    // the rest of the range splits into up to eight contiguous child ranges
+    int shift = sectionShiftForLevel(level);
+    for (int child = 0; child < NUMBER_OF_CHILDREN && index < end; child++) {
+        quint64 childPrefix = prefix | ((quint64)child << shift);
+        int childEnd = lowerBound(childPrefix + ((quint64)1 << shift), index, end);
+        findRayIntersectionInRange(query, childPrefix, level + 1, index, childEnd);
+        index = childEnd;
+    }
+}
+
+class LinearVoxelTree::SphereQuery {
+public:
+    glm::vec3 center; // voxel units
+    float radius;
+    glm::vec3 penetration; // meters
+    bool found;
+};
+
+bool LinearVoxelTree::findSpherePenetration(const glm::vec3& center, float radius, glm::vec3& penetration) const {
+    assert(_isSorted);
+    SphereQuery query = { center / (float)TREE_SCALE, radius / (float)TREE_SCALE, glm::vec3(0.0f, 0.0f, 0.0f), false };
+    findSpherePenetrationInRange(query, 0, 0, 0, _voxels.size());
+    penetration = query.penetration;
+    return query.found;
+}
+
+void LinearVoxelTree::findSpherePenetrationInRange(SphereQuery& query, quint64 prefix, int level, int begin, int end) const {
+    if (begin >= end) {
+        return;
+    }
+    // coarse check against bounds, same as findSpherePenetrationOp()
+    AACube cube = cubeForCode(prefix, level);
+    if (!cube.expandedContains(query.center, query.radius)) {
+        return;
+    }
+
+    int index = begin;
+    while (index < end && _voxels[index].level == level) {
+        glm::vec3 voxelPenetration;
+        if (cube.findSpherePenetration(query.center, query.radius, voxelPenetration)) {
+            query.penetration = addPenetrations(query.penetration, voxelPenetration * (float)TREE_SCALE);
+            query.found = true;
+        }
+        index++;
+    }
+    if (level >= MAX_LEVELS) {
+        return;
+    }
+
+    int shift = sectionShiftForLevel(level);
+    for (int child = 0; child < NUMBER_OF_CHILDREN && index < end; child++) {
+        quint64 childPrefix = prefix | ((quint64)child << shift);
+        int childEnd = lowerBound(childPrefix + ((quint64)1 << shift), index, end);
+        findSpherePenetrationInRange(query, childPrefix, level + 1, index, childEnd);
+        index = childEnd;
+    }
+}
@@ -0,0 +1,119 @@
+//
+//  LinearVoxelTree.h
+//  libraries/voxels/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A compact, read-mostly representation of a voxel world. Instead of a pointer tree of VoxelTreeElements, the colored
+//  leaves are kept in a single array sorted by their Morton (octal) code. Bounds are implied by the code, and the
+//  implicit internal nodes of the octree are recovered during traversal from contiguous ranges of the sorted array.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LinearVoxelTree_h
+#define hifi_LinearVoxelTree_h
+
+#include <QVector>
+
+#include <AACube.h>
+#include <BoxBase.h>
+#include <SharedUtil.h>
+
+class OctreePacketData;
+class VoxelTree;
+
+/// A single colored leaf voxel. The octal code is packed left aligned into mortonCode, three bits per level starting
+/// just below the most significant bit, so that sorting by mortonCode sorts voxels in octree (depth first) order.
+class LinearVoxel {
+public:
+    quint64 mortonCode;
+    unsigned char level; // number of three bit sections in the octal code
+    rgbColor color;
+};
+
+/// A subtree of a LinearVoxelTree, the element with mortonCode's first level sections.
+class LinearSubTree {
+public:
+    quint64 mortonCode;
+    int level;
+};
+
+class LinearVoxelTree {
+public:
+    /// the deepest level that fits in a 64 bit Morton code, ~8mm voxels at TREE_SCALE
+    static const int MAX_LEVELS = 21;
+
+    typedef QVector<LinearVoxel>::const_iterator const_iterator;
+
+    LinearVoxelTree();
+
+    void clear();
+
+    /// Replaces our contents with the colored leaves of tree. The caller is responsible for locking the tree.
+    void buildFromTree(VoxelTree* tree);
+
+    /// Adds a voxel from its octal code. You must call finalize() after adding voxels and before querying.
+    /// \return false if the code is deeper than MAX_LEVELS and the voxel was not added
+    bool addVoxel(const unsigned char* octalCode, const rgbColor& color);
+
+    /// Sorts the voxels into Morton order, must be called after addVoxel() and before any queries.
+    void finalize();
+
+    int getVoxelCount() const { return _voxels.size(); }
+    const LinearVoxel& getVoxel(int index) const { return _voxels[index]; }
+    const_iterator begin() const { return _voxels.constBegin(); }
+    const_iterator end() const { return _voxels.constEnd(); }
+
+    /// \return the bounds of the voxel at index, in voxel (0.0 to 1.0) units
+    AACube getVoxelCube(int index) const { return cubeForCode(_voxels[index].mortonCode, _voxels[index].level); }
+
+    /// \return a newly allocated octal code for the voxel at index, the caller must delete[] it
+    unsigned char* getVoxelOctalCode(int index) const;
+
+    /// \return the bytes used by the voxel storage
+    quint64 getMemoryUsage() const { return (quint64)_voxels.capacity() * sizeof(LinearVoxel); }
+
+    /// Adds all of our voxels to tree, so that a linear world can be edited, or encoded for a view. The expansion does not
+    /// allocate per voxel, beyond the elements the tree creates.
+    /// The caller is responsible for locking the tree.
+    void writeToTree(VoxelTree* tree, bool destructive = false) const;
+
+    /// Encodes a subtree into packetData straight from the sorted voxels, in the format that Octree::encodeTreeBitstream()
+    /// writes with colors and exists bits and no view, which is how whole worlds are saved and sent. Internal elements get
+    /// the average color that VoxelTreeElement::calculateAverageFromChildren() would give them. Start with the root, a
+    /// mortonCode and level of 0, and encode what is left in later packets.
+    /// \param remaining[out] the subtrees that didn't fit are appended, this one if nothing of it did
+    /// \return the bytes written, 0 if nothing fit
+    int encodeSubTree(const LinearSubTree& subTree, OctreePacketData* packetData, QVector<LinearSubTree>& remaining) const;
+
+    /// Same semantics as Octree::findRayIntersection(), origin and distance are in meters.
+    /// \param voxelIndex set to the index of the intersected voxel
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                             float& distance, BoxFace& face, int& voxelIndex) const;
+
+    /// Same semantics as Octree::findSpherePenetration(), center, radius and penetration are in meters.
+    bool findSpherePenetration(const glm::vec3& center, float radius, glm::vec3& penetration) const;
+
+    static quint64 mortonCodeForOctalCode(const unsigned char* octalCode, int level);
+    static AACube cubeForCode(quint64 mortonCode, int level);
+
+private:
+    class RayQuery;
+    class SphereQuery;
+
+    void findRayIntersectionInRange(RayQuery& query, quint64 prefix, int level, int begin, int end) const;
+    void findSpherePenetrationInRange(SphereQuery& query, quint64 prefix, int level, int begin, int end) const;
+    int encodeRange(quint64 prefix, int level, int begin, int end, OctreePacketData* packetData,
+                    QVector<LinearSubTree>& remaining) const;
+    void averageRange(quint64 prefix, int level, int begin, int end, nodeColor& color, float& density) const;
+    int lowerBound(quint64 mortonCode, int begin, int end) const;
+    void writeVoxelOctalCode(int index, unsigned char* octalCode) const; // octalCode must hold the voxel's code
+    static void writeOctalCode(quint64 mortonCode, int level, unsigned char* octalCode);
+
+    QVector<LinearVoxel> _voxels;
+    bool _isSorted;
+};
+
+#endif // hifi_LinearVoxelTree_h
@@ -321,7 +321,7 @@ bool VoxelTree::readFromSquareARGB32Pixels(const char* filename) {
 }
 
 bool VoxelTree::readFromSchematicFile(const char *fileName) {
-    _stopImport = false;
+    _stopImport.storeRelease(0);
     emit importProgress(0);
 
     std::stringstream ss;
@@ -358,9 +358,9 @@ bool VoxelTree::readFromSchematicFile(const char *fileName) {
             emit importProgress((int) 100 * (y * schematics.getLength() + z) / (schematics.getHeight() * schematics.getLength()));
 
             for (int x = 0; x < schematics.getWidth(); ++x) {
-                if (_stopImport) {
+                if (_stopImport.loadAcquire()) {
                     qDebug("Canceled import at %d voxels.", count);
-                    _stopImport = false;
+                    _stopImport.storeRelease(0);
                     return true;
                 }
 
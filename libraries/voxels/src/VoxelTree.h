@@ -57,6 +57,10 @@ public:
                     const unsigned char* editData, int maxLength, const SharedNodePointer& node);
     virtual bool recurseChildrenWithData() const { return false; }
 
+    /// every voxel in a bitstream is its color, see VoxelTreeElement::readElementDataFromBuffer()
+    virtual int elementDataSizeInBuffer(const unsigned char* data, int bytesLeftToRead,
+                                        const ReadBitstreamToTreeParams& args) const { return BYTES_PER_COLOR; }
+
 private:
     // helper functions for nudgeSubTree
     void recurseNodeForNudge(VoxelTreeElement* element, RecurseOctreeOperation operation, void* extraData);
@@ -16,6 +16,8 @@
 #include "VoxelTreeElement.h"
 #include "VoxelTree.h"
 
+IMPLEMENT_OCTREE_ELEMENT_POOL(VoxelTreeElement)
+
 VoxelTreeElement::VoxelTreeElement(unsigned char* octalCode) : 
     OctreeElement(),
     _exteriorOcclusions(OctreeElement::HalfSpace::All),
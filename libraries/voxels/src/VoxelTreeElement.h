@@ -20,6 +20,7 @@
 
 #include <AACube.h>
 #include <OctreeElement.h>
+#include <OctreeElementPool.h>
 #include <SharedUtil.h>
 
 #include "ViewFrustum.h"
@@ -36,6 +37,8 @@ class VoxelTreeElement : public OctreeElement {
 
     virtual OctreeElement* createNewElement(unsigned char* octalCode = NULL);
     
+    DECLARE_OCTREE_ELEMENT_POOL()
+
 public:
     virtual ~VoxelTreeElement();
     virtual void init(unsigned char * octalCode);
@@ -0,0 +1,42 @@
+//
+//  BenchmarkResults.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QJsonDocument>
+
+#include "BenchmarkResults.h"
+
+void BenchmarkResults::add(const QString& name, double value, const QString& unit) {
+    QJsonObject result;
+    result.insert("name", name);
+    result.insert("value", value);
+    result.insert("unit", unit);
+    _results.append(result);
+
+    qDebug() << qPrintable(name) << "=" << value << qPrintable(unit);
+}
+
+void BenchmarkResults::addRate(const QString& name, quint64 elapsedUsecs, quint64 operations) {
+    const double USECS_PER_SECOND = 1000000.0;
+    add(name + ".usecs", (double)elapsedUsecs, "usecs");
+    if (operations > 0) {
+        add(name + ".usecsPerOperation", (double)elapsedUsecs / operations, "usecs");
+    }
+    if (elapsedUsecs > 0) {
+        add(name + ".operationsPerSecond", operations * USECS_PER_SECOND / elapsedUsecs, "1/s");
+    }
+}
+
+QByteArray BenchmarkResults::toJson() const {
+    QJsonObject root;
+    root.insert("config", _config);
+    root.insert("results", _results);
+    return QJsonDocument(root).toJson();
+}
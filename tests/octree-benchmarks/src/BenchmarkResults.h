@@ -0,0 +1,40 @@
+//
+//  BenchmarkResults.h
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Collects named measurements and writes them out as JSON, so that runs on different builds can be compared by a
+//  script rather than by reading logs.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BenchmarkResults_h
+#define hifi_BenchmarkResults_h
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+class BenchmarkResults {
+public:
+    /// records a configuration value, so that results are only compared between runs of the same size
+    void setConfig(const QString& name, double value) { _config.insert(name, value); }
+
+    /// records a measurement, name is dotted like "voxels.encodePerView.usecs"
+    void add(const QString& name, double value, const QString& unit);
+
+    /// helper for the common case of an elapsed time and a count of operations done in it
+    void addRate(const QString& name, quint64 elapsedUsecs, quint64 operations);
+
+    QByteArray toJson() const;
+
+private:
+    QJsonObject _config;
+    QJsonArray _results;
+};
+
+#endif // hifi_BenchmarkResults_h
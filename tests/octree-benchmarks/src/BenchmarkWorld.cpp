@@ -0,0 +1,115 @@
+//
+//  BenchmarkWorld.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <OctreeElementBag.h>
+#include <OctreePacketData.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+
+glm::vec3 randomPointInWorld() {
+    return glm::vec3(WORLD_CORNER) + glm::vec3(randFloat(), randFloat(), randFloat()) * WORLD_SCALE;
+}
+
+float terrainHeight(float x, float z) {
+    const float HILL_FREQUENCY = TWO_PI * 4.0f / WORLD_SCALE;
+    const float HILL_HEIGHT = WORLD_SCALE * 0.1f;
+    return WORLD_CORNER + WORLD_SCALE * 0.25f + HILL_HEIGHT * sinf(x * HILL_FREQUENCY) * cosf(z * HILL_FREQUENCY);
+}
+
+xColor randomColor() {
+    xColor color = { (unsigned char)randIntInRange(0, 255), (unsigned char)randIntInRange(0, 255),
+                     (unsigned char)randIntInRange(0, 255) };
+    return color;
+}
+
+void setupRandomView(ViewFrustum& viewFrustum) {
+    viewFrustum.setPosition(randomPointInWorld() * (float)TREE_SCALE);
+    viewFrustum.setOrientation(glm::quat(glm::vec3(randFloatInRange(-PI_OVER_TWO, PI_OVER_TWO),
+                                                   randFloatInRange(-PI, PI), 0.0f)));
+    viewFrustum.setFieldOfView(DEFAULT_FIELD_OF_VIEW_DEGREES);
+    viewFrustum.setAspectRatio(DEFAULT_ASPECT_RATIO);
+    viewFrustum.setNearClip(DEFAULT_NEAR_CLIP);
+    viewFrustum.setFarClip(DEFAULT_FAR_CLIP);
+    viewFrustum.setKeyholeRadius(DEFAULT_KEYHOLE_RADIUS);
+    viewFrustum.calculate();
+}
+
+Particle randomParticle(const glm::vec3& velocity, const glm::vec3& gravity, float lifetime) {
+    xColor randomXColor = randomColor();
+    rgbColor color = { randomXColor.red, randomXColor.green, randomXColor.blue };
+    Particle particle;
+    particle.init(randomPointInWorld(), randFloatInRange(0.1f, 1.0f) / (float)TREE_SCALE, color, velocity, gravity,
+                  DEFAULT_DAMPING, lifetime);
+    return particle;
+}
+
+quint64 totalBytes(const QVector<QByteArray>& packets) {
+    quint64 bytes = 0;
+    foreach (const QByteArray& packet, packets) {
+        bytes += packet.size();
+    }
+    return bytes;
+}
+
+void applyEdits(Octree& tree, PacketType packetType, const QVector<QByteArray>& edits,
+                const QString& name, BenchmarkResults& results) {
+    tree.lockForWrite();
+    quint64 start = usecTimestampNow();
+    foreach (const QByteArray& edit, edits) {
+        const unsigned char* editData = reinterpret_cast<const unsigned char*>(edit.constData());
+        tree.processEditPacketData(packetType, editData, edit.size(), editData, edit.size(), SharedNodePointer());
+    }
+    quint64 elapsed = usecTimestampNow() - start;
+    tree.unlock();
+    results.addRate(name + ".edit", elapsed, edits.size());
+}
+
+QVector<QByteArray> encodeScene(Octree& tree, const ViewFrustum* viewFrustum, bool byPriority,
+                                QVector<quint64>* packetUsecs) {
+    QVector<QByteArray> packets;
+    OctreePacketData packetData(true);
+    OctreeElementBag bag;
+    if (byPriority && viewFrustum) {
+        bag.setPriorityViewFrustum(viewFrustum);
+    }
+    bag.insert(tree.getRoot());
+    quint64 start = usecTimestampNow();
+
+    while (!bag.isEmpty()) {
+        OctreeElement* subTree = bag.extract();
+        EncodeBitstreamParams params(INT_MAX, viewFrustum);
+        int bytesWritten = tree.encodeTreeBitstream(subTree, &packetData, bag, params);
+
+        if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+            if (!packetData.hasContent()) {
+                qDebug() << "encodeScene() an element doesn't fit in an empty packet, the scene is incomplete";
+                break;
+            }
+            packets.append(QByteArray((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize()));
+            if (packetUsecs) {
+                packetUsecs->append(usecTimestampNow() - start);
+            }
+            packetData.reset();
+            bag.insert(subTree);
+        }
+    }
+    if (packetData.hasContent()) {
+        packets.append(QByteArray((const char*)packetData.getFinalizedData(), packetData.getFinalizedSize()));
+        if (packetUsecs) {
+            packetUsecs->append(usecTimestampNow() - start);
+        }
+    }
+    return packets;
+}
@@ -0,0 +1,62 @@
+//
+//  BenchmarkWorld.h
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  The synthetic worlds and client views that the benchmarks share, and the server paths they drive them through. All of
+//  it is generated with rand(), which main() seeds, so that runs on different builds see the same data.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BenchmarkWorld_h
+#define hifi_BenchmarkWorld_h
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+#include <Octree.h>
+#include <Particle.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+class BenchmarkResults;
+
+// worlds are generated in a cube at the center of the domain, small enough that the views see a good part of them
+const float WORLD_SCALE = 1.0f / 16.0f; // 1km at TREE_SCALE
+const float WORLD_CORNER = 0.5f - WORLD_SCALE * 0.5f;
+const float VOXEL_SCALE = 1.0f / 4096.0f; // 4m voxels
+
+glm::vec3 randomPointInWorld();
+
+/// rolling hills, so that the voxels make a surface like a real world rather than a cloud
+float terrainHeight(float x, float z);
+
+xColor randomColor();
+
+/// a client camera somewhere in the world, looking in a random direction
+void setupRandomView(ViewFrustum& viewFrustum);
+
+/// a particle somewhere in the world, with a radius of 10cm to 1m
+Particle randomParticle(const glm::vec3& velocity, const glm::vec3& gravity, float lifetime);
+
+quint64 totalBytes(const QVector<QByteArray>& packets);
+
+/// applies each edit record the way the octree servers' inbound packet processors do, and records the edit rate as
+/// name.edit
+void applyEdits(Octree& tree, PacketType packetType, const QVector<QByteArray>& edits,
+                const QString& name, BenchmarkResults& results);
+
+/// Encodes everything viewFrustum can see into compressed packets, the way the send threads do for a new scene. Pass
+/// IGNORE_VIEW_FRUSTUM to encode the whole tree. byPriority extracts from the bag the way --sendByPriority does, and
+/// packetUsecs, if set, gets the encoding time up to the end of each packet. The caller is responsible for locking the
+/// tree.
+QVector<QByteArray> encodeScene(Octree& tree, const ViewFrustum* viewFrustum, bool byPriority = false,
+                                QVector<quint64>* packetUsecs = NULL);
+
+#endif // hifi_BenchmarkWorld_h
@@ -0,0 +1,62 @@
+//
+//  ElementBagBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QVector>
+
+#include <OctreeElementBag.h>
+#include <VoxelTree.h>
+
+#include "BenchmarkResults.h"
+#include "OctreeBenchmarks.h"
+
+// Deleting elements while many clients have elements queued to send. The bags don't hook element deletes, so the cost
+// of a delete should not depend on the number of bags, and the bags should drop the deleted elements when drained.
+void OctreeBenchmarks::elementBagBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::elementBagBenchmarks()";
+
+    if (config.bagCount <= 0) {
+        return;
+    }
+
+    VoxelTree tree; // only used to create pooled elements
+    QVector<OctreeElement*> elements;
+    elements.reserve(config.deleteCount);
+    for (int i = 0; i < config.deleteCount; i++) {
+        elements.append(tree.createNewElement());
+    }
+
+    QVector<OctreeElementBag*> bags;
+    for (int i = 0; i < config.bagCount; i++) {
+        bags.append(new OctreeElementBag());
+    }
+    for (int i = 0; i < elements.size(); i++) {
+        bags[i % bags.size()]->insert(elements[i]);
+    }
+
+    quint64 start = usecTimestampNow();
+    foreach (OctreeElement* element, elements) {
+        delete element;
+    }
+    results.addRate("bags.delete", usecTimestampNow() - start, elements.size());
+
+    int extractedElements = 0;
+    start = usecTimestampNow();
+    foreach (OctreeElementBag* bag, bags) {
+        while (!bag->isEmpty()) {
+            bag->extract();
+            extractedElements++;
+        }
+    }
+    results.addRate("bags.drain", usecTimestampNow() - start, elements.size());
+    results.add("bags.drain.extractedDeletedElements", extractedElements, "elements"); // should always be 0
+
+    qDeleteAll(bags);
+}
@@ -0,0 +1,97 @@
+//
+//  ItemIndexBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QVector>
+
+#include <ModelItem.h>
+#include <ModelTree.h>
+#include <Particle.h>
+#include <ParticleTree.h>
+#include <SharedUtil.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+void OctreeBenchmarks::particleIDBenchmarks(ParticleTree& tree, BenchmarkResults& results) {
+    // what scripts do through the scripting interface, each of which looks a particle up by ID
+    QVector<const Particle*> particles;
+    tree.findParticles(glm::vec3(0.5f), 1.0f, particles);
+    QVector<uint32_t> ids;
+    foreach (const Particle* particle, particles) {
+        ids.append(particle->getID());
+    }
+
+    int foundParticles = 0;
+    tree.lockForRead();
+    quint64 start = usecTimestampNow();
+    foreach (uint32_t id, ids) {
+        if (tree.findParticleByID(id, true)) {
+            foundParticles++;
+        }
+    }
+    results.addRate("particles.findByID", usecTimestampNow() - start, ids.size());
+    tree.unlock();
+    results.add("particles.findByID.found", foundParticles, "particles"); // should be every particle
+
+    tree.lockForWrite();
+    start = usecTimestampNow();
+    foreach (uint32_t id, ids) {
+        ParticleProperties properties;
+        properties.setVelocity(glm::vec3(randFloatInRange(-1.0f, 1.0f), 0.0f, randFloatInRange(-1.0f, 1.0f)));
+        tree.updateParticle(ParticleID(id), properties);
+    }
+    results.addRate("particles.editByID", usecTimestampNow() - start, ids.size());
+
+    start = usecTimestampNow();
+    foreach (uint32_t id, ids) {
+        tree.deleteParticle(ParticleID(id));
+    }
+    results.addRate("particles.deleteByID", usecTimestampNow() - start, ids.size());
+    tree.unlock();
+}
+
+void OctreeBenchmarks::modelIDBenchmarks(ModelTree& tree, BenchmarkResults& results) {
+    // what scripts do through the scripting interface, each of which looks a model up by ID
+    QVector<const ModelItem*> models;
+    tree.findModels(glm::vec3(0.5f), 1.0f, models);
+    QVector<uint32_t> ids;
+    foreach (const ModelItem* model, models) {
+        ids.append(model->getID());
+    }
+
+    int foundModels = 0;
+    tree.lockForRead();
+    quint64 start = usecTimestampNow();
+    foreach (uint32_t id, ids) {
+        if (tree.findModelByID(id, true)) {
+            foundModels++;
+        }
+    }
+    results.addRate("models.findByID", usecTimestampNow() - start, ids.size());
+    tree.unlock();
+    results.add("models.findByID.found", foundModels, "models"); // should be every model
+
+    tree.lockForWrite();
+    start = usecTimestampNow();
+    foreach (uint32_t id, ids) {
+        ModelItemProperties properties;
+        properties.setColor(randomColor());
+        tree.updateModel(ModelItemID(id), properties);
+    }
+    results.addRate("models.editByID", usecTimestampNow() - start, ids.size());
+
+    start = usecTimestampNow();
+    foreach (uint32_t id, ids) {
+        tree.deleteModel(ModelItemID(id));
+    }
+    results.addRate("models.deleteByID", usecTimestampNow() - start, ids.size());
+    tree.unlock();
+}
@@ -0,0 +1,150 @@
+//
+//  LinearVoxelTreeBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QVector>
+
+#include <LinearVoxelTree.h>
+#include <OctreePacketData.h>
+#include <VoxelTree.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+void OctreeBenchmarks::linearVoxelTreeBenchmarks(VoxelTree& tree, quint64 treeMemory, const BenchmarkConfig& config,
+                                                 BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::linearVoxelTreeBenchmarks()";
+
+    // the Morton ordered storage of the same world
+    LinearVoxelTree linearTree;
+    tree.lockForRead();
+    quint64 start = usecTimestampNow();
+    linearTree.buildFromTree(&tree);
+    quint64 elapsed = usecTimestampNow() - start;
+    tree.unlock();
+    int voxelCount = linearTree.getVoxelCount();
+    results.addRate("linearVoxels.build", elapsed, voxelCount);
+    if (voxelCount > 0) {
+        results.add("voxels.memoryPerVoxel", (double)treeMemory / voxelCount, "bytes");
+        results.add("linearVoxels.memoryPerVoxel", (double)linearTree.getMemoryUsage() / voxelCount, "bytes");
+    }
+
+    // rays from above the terrain, mostly pointing down at it
+    QVector<glm::vec3> origins;
+    QVector<glm::vec3> directions;
+    for (int i = 0; i < config.rayCount; i++) {
+        glm::vec3 origin = randomPointInWorld();
+        origin.y = WORLD_CORNER + WORLD_SCALE * 0.75f;
+        origins.append(origin * (float)TREE_SCALE);
+        directions.append(glm::normalize(glm::vec3(randFloatInRange(-1.0f, 1.0f), -1.0f, randFloatInRange(-1.0f, 1.0f))));
+    }
+
+    int treeHits = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < config.rayCount; i++) {
+        OctreeElement* element;
+        float distance;
+        BoxFace face;
+        if (tree.findRayIntersection(origins[i], directions[i], element, distance, face, NULL, Octree::NoLock)) {
+            treeHits++;
+        }
+    }
+    results.addRate("voxels.rayIntersection", usecTimestampNow() - start, config.rayCount);
+    results.add("voxels.rayIntersection.hits", treeHits, "rays");
+
+    int linearHits = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < config.rayCount; i++) {
+        float distance;
+        BoxFace face;
+        int voxelIndex;
+        if (linearTree.findRayIntersection(origins[i], directions[i], distance, face, voxelIndex)) {
+            linearHits++;
+        }
+    }
+    results.addRate("linearVoxels.rayIntersection", usecTimestampNow() - start, config.rayCount);
+    results.add("linearVoxels.rayIntersection.hits", linearHits, "rays");
+
+    // spheres of 1m to 10m on the terrain, like avatars and particles colliding with it
+    QVector<glm::vec3> centers;
+    QVector<float> radii;
+    for (int i = 0; i < config.rayCount; i++) {
+        glm::vec3 center = randomPointInWorld();
+        center.y = terrainHeight(center.x, center.z);
+        centers.append(center * (float)TREE_SCALE);
+        radii.append(randFloatInRange(1.0f, 10.0f));
+    }
+
+    int treePenetrations = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < config.rayCount; i++) {
+        glm::vec3 penetration;
+        if (tree.findSpherePenetration(centers[i], radii[i], penetration, NULL, Octree::NoLock)) {
+            treePenetrations++;
+        }
+    }
+    results.addRate("voxels.spherePenetration", usecTimestampNow() - start, config.rayCount);
+    results.add("voxels.spherePenetration.hits", treePenetrations, "spheres");
+
+    int linearPenetrations = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < config.rayCount; i++) {
+        glm::vec3 penetration;
+        if (linearTree.findSpherePenetration(centers[i], radii[i], penetration)) {
+            linearPenetrations++;
+        }
+    }
+    results.addRate("linearVoxels.spherePenetration", usecTimestampNow() - start, config.rayCount);
+    results.add("linearVoxels.spherePenetration.hits", linearPenetrations, "spheres");
+
+    // the whole world into compressed packets, straight from the sorted voxels and from the pointer tree
+    OctreePacketData packetData(true);
+    QVector<LinearSubTree> remaining;
+    LinearSubTree root = { 0, 0 };
+    remaining.append(root);
+    int linearPackets = 0;
+    start = usecTimestampNow();
+    while (!remaining.isEmpty()) {
+        LinearSubTree subTree = remaining.takeLast();
+        if (linearTree.encodeSubTree(subTree, &packetData, remaining) == 0) {
+            if (!packetData.hasContent()) {
+                qDebug() << "linearVoxelTreeBenchmarks() a subtree doesn't fit in an empty packet, the world is incomplete";
+                break;
+            }
+            packetData.getFinalizedData();
+            packetData.reset();
+            linearPackets++;
+        }
+    }
+    if (packetData.hasContent()) {
+        packetData.getFinalizedData();
+        linearPackets++;
+    }
+    results.addRate("linearVoxels.encode", usecTimestampNow() - start, voxelCount);
+    results.add("linearVoxels.encode.packets", linearPackets, "packets");
+
+    tree.lockForRead();
+    start = usecTimestampNow();
+    QVector<QByteArray> treePackets = encodeScene(tree, IGNORE_VIEW_FRUSTUM);
+    elapsed = usecTimestampNow() - start;
+    tree.unlock();
+    results.addRate("voxels.encodeWorld", elapsed, voxelCount);
+    results.add("voxels.encodeWorld.packets", treePackets.size(), "packets");
+
+    // a linear world is expanded into a pointer tree to be edited or encoded for a view, this is what that costs
+    VoxelTree expandedTree;
+    expandedTree.lockForWrite();
+    start = usecTimestampNow();
+    linearTree.writeToTree(&expandedTree);
+    elapsed = usecTimestampNow() - start;
+    expandedTree.unlock();
+    results.addRate("linearVoxels.expandToTree", elapsed, voxelCount);
+}
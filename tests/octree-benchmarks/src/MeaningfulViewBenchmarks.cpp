@@ -0,0 +1,102 @@
+//
+//  MeaningfulViewBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QVector>
+
+#include <OctreePacketData.h>
+#include <VoxelTree.h>
+#include <VoxelTreeElement.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+class ViewWeightArgs {
+public:
+    const ViewFrustum* viewFrustum;
+    double weight;
+};
+
+// the weight of a voxel to a viewer is its projected size, its scale over its distance, the same measure LOD uses
+static bool addViewWeight(OctreeElement* element, void* extraData) {
+    ViewWeightArgs* args = static_cast<ViewWeightArgs*>(extraData);
+    VoxelTreeElement* voxel = static_cast<VoxelTreeElement*>(element);
+    if (voxel->isLeaf() && voxel->isColored()) {
+        const float MINIMUM_DISTANCE = 0.001f;
+        args->weight += voxel->getScale() * TREE_SCALE / std::max(voxel->distanceToCamera(*args->viewFrustum),
+                                                                  MINIMUM_DISTANCE);
+    }
+    return true;
+}
+
+static double viewWeight(VoxelTree& tree, const ViewFrustum& viewFrustum) {
+    ViewWeightArgs args = { &viewFrustum, 0.0 };
+    tree.recurseTreeWithOperation(addViewWeight, &args);
+    return args.weight;
+}
+
+// How soon a client has a meaningful view: the packets, and the encoding time, until the voxels it has decoded make up
+// most of the projected size of the whole scene. Compares extracting from the bag in any order with --sendByPriority,
+// which is what matters when a scene is cut short by the packets per second limit.
+void OctreeBenchmarks::meaningfulViewBenchmarks(VoxelTree& tree, const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::meaningfulViewBenchmarks()";
+
+    const double MEANINGFUL_WEIGHT_FRACTION = 0.9;
+    const int ORDER_KINDS = 2;
+    const char* orderNames[ORDER_KINDS] = { "voxels.firstMeaningfulView.anyOrder", "voxels.firstMeaningfulView.priority" };
+    bool orderByPriority[ORDER_KINDS] = { false, true };
+
+    // both orders are measured on the same views
+    quint64 meaningfulUsecs[ORDER_KINDS] = { 0, 0 };
+    quint64 meaningfulPackets[ORDER_KINDS] = { 0, 0 };
+    quint64 scenePackets[ORDER_KINDS] = { 0, 0 };
+    for (int i = 0; i < config.viewCount; i++) {
+        ViewFrustum viewFrustum;
+        setupRandomView(viewFrustum);
+        for (int order = 0; order < ORDER_KINDS; order++) {
+            QVector<quint64> packetUsecs;
+            tree.lockForRead();
+            QVector<QByteArray> scene = encodeScene(tree, &viewFrustum, orderByPriority[order], &packetUsecs);
+            tree.unlock();
+            scenePackets[order] += scene.size();
+
+            // decode the packets one at a time, the way the client receives them, until the view is meaningful. The
+            // weight of the whole scene is that of the tree with every packet decoded.
+            VoxelTree clientTree;
+            ReadBitstreamToTreeParams args(WANT_COLOR, WANT_EXISTS_BITS, NULL, QUuid(), SharedNodePointer(), false,
+                                           clientTree.expectedVersion());
+            QVector<double> packetWeights;
+            foreach (const QByteArray& packet, scene) {
+                OctreePacketData packetData(true);
+                packetData.loadFinalizedContent((const unsigned char*)packet.constData(), packet.size());
+                clientTree.readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
+                packetWeights.append(viewWeight(clientTree, viewFrustum));
+            }
+            for (int packet = 0; packet < packetWeights.size(); packet++) {
+                if (packetWeights[packet] >= packetWeights.last() * MEANINGFUL_WEIGHT_FRACTION) {
+                    meaningfulUsecs[order] += packetUsecs[packet];
+                    meaningfulPackets[order] += packet + 1;
+                    break;
+                }
+            }
+        }
+    }
+    if (config.viewCount > 0) {
+        for (int order = 0; order < ORDER_KINDS; order++) {
+            QString name = orderNames[order];
+            results.add(name + ".usecs", (double)meaningfulUsecs[order] / config.viewCount, "usecs");
+            results.add(name + ".packets", (double)meaningfulPackets[order] / config.viewCount, "packets");
+            results.add(name + ".scenePackets", (double)scenePackets[order] / config.viewCount, "packets");
+        }
+    }
+}
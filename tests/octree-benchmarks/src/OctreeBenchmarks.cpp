@@ -0,0 +1,210 @@
+//
+//  OctreeBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QVector>
+
+#include <ModelItem.h>
+#include <ModelTree.h>
+#include <OctreePacketData.h>
+#include <Particle.h>
+#include <ParticleTree.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+#include <VoxelTree.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+BenchmarkConfig::BenchmarkConfig() :
+    voxelCount(100000),
+    particleCount(10000),
+    simulatedParticleCount(100000),
+    collidingParticleCount(10000),
+    avatarCount(100),
+    modelCount(10000),
+    viewCount(20),
+    rayCount(10000),
+    bagCount(500),
+    deleteCount(1000000),
+    svoMegabytes(16)
+{
+}
+
+// the measurements every kind of tree supports, tree must already hold the world and decodeTree must be empty
+static void treeBenchmarks(Octree& tree, Octree& decodeTree, const QString& name,
+                           const BenchmarkConfig& config, BenchmarkResults& results) {
+    results.add(name + ".elements", tree.getOctreeElementsCount(), "elements");
+
+    // the whole tree, like an importer or a client with no view frustum
+    tree.lockForRead();
+    quint64 start = usecTimestampNow();
+    QVector<QByteArray> fullScene = encodeScene(tree, IGNORE_VIEW_FRUSTUM);
+    quint64 elapsed = usecTimestampNow() - start;
+    tree.unlock();
+    results.add(name + ".encodeFullScene.usecs", elapsed, "usecs");
+    results.add(name + ".encodeFullScene.packets", fullScene.size(), "packets");
+    results.add(name + ".encodeFullScene.bytes", totalBytes(fullScene), "bytes");
+
+    // a first scene for each of a number of clients
+    quint64 encodeUsecs = 0;
+    quint64 viewPackets = 0;
+    quint64 viewBytes = 0;
+    for (int i = 0; i < config.viewCount; i++) {
+        ViewFrustum viewFrustum;
+        setupRandomView(viewFrustum);
+        tree.lockForRead();
+        start = usecTimestampNow();
+        QVector<QByteArray> scene = encodeScene(tree, &viewFrustum);
+        encodeUsecs += usecTimestampNow() - start;
+        tree.unlock();
+        viewPackets += scene.size();
+        viewBytes += totalBytes(scene);
+    }
+    if (config.viewCount > 0) {
+        results.add(name + ".encodePerView.usecs", (double)encodeUsecs / config.viewCount, "usecs");
+        results.add(name + ".encodePerView.packets", (double)viewPackets / config.viewCount, "packets");
+        results.add(name + ".encodePerView.bytes", (double)viewBytes / config.viewCount, "bytes");
+    }
+
+    // the full scene again, the way a client reads it
+    ReadBitstreamToTreeParams args(WANT_COLOR, WANT_EXISTS_BITS, NULL, QUuid(), SharedNodePointer(), false,
+                                   decodeTree.expectedVersion());
+    quint64 uncompressedBytes = 0;
+    decodeTree.lockForWrite();
+    start = usecTimestampNow();
+    foreach (const QByteArray& packet, fullScene) {
+        OctreePacketData packetData(true);
+        packetData.loadFinalizedContent((const unsigned char*)packet.constData(), packet.size());
+        uncompressedBytes += packetData.getUncompressedSize();
+        decodeTree.readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
+    }
+    elapsed = usecTimestampNow() - start;
+    decodeTree.unlock();
+    results.addRate(name + ".decode", elapsed, fullScene.size());
+    if (elapsed > 0) {
+        const double USECS_PER_SECOND = 1000000.0;
+        results.add(name + ".decode.uncompressedBytesPerSecond", uncompressedBytes * USECS_PER_SECOND / elapsed, "bytes/s");
+    }
+
+    // writeToSVOFile() takes the read lock itself, in slices
+    QByteArray fileName = QDir(QDir::tempPath()).filePath(QString("octree-benchmarks-%1.svo").arg(name)).toLocal8Bit();
+    start = usecTimestampNow();
+    tree.writeToSVOFile(fileName.constData());
+    results.add(name + ".svoWrite.usecs", usecTimestampNow() - start, "usecs");
+    results.add(name + ".svoWrite.bytes", QFile(fileName).size(), "bytes");
+
+    decodeTree.lockForWrite();
+    decodeTree.eraseAllOctreeElements();
+    start = usecTimestampNow();
+    bool fileOk = decodeTree.readFromSVOFile(fileName.constData());
+    elapsed = usecTimestampNow() - start;
+    decodeTree.unlock();
+    if (!fileOk) {
+        qDebug() << "treeBenchmarks() failed to read back" << fileName;
+    }
+    results.add(name + ".svoRead.usecs", elapsed, "usecs");
+    QFile::remove(fileName);
+}
+
+void OctreeBenchmarks::voxelBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::voxelBenchmarks()";
+
+    QVector<QByteArray> edits;
+    edits.reserve(config.voxelCount);
+    for (int i = 0; i < config.voxelCount; i++) {
+        glm::vec3 point = randomPointInWorld();
+        point.y = terrainHeight(point.x, point.z);
+        xColor color = randomColor();
+        unsigned char* voxel = pointToVoxel(point.x, point.y, point.z, VOXEL_SCALE, color.red, color.green, color.blue);
+        int voxelDataSize = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(voxel)) + BYTES_PER_COLOR;
+        edits.append(QByteArray((const char*)voxel, voxelDataSize));
+        delete[] voxel;
+    }
+
+    VoxelTree tree;
+    quint64 memoryBefore = OctreeElement::getTotalMemoryUsage();
+    applyEdits(tree, PacketTypeVoxelSetDestructive, edits, "voxels", results);
+    quint64 treeMemory = OctreeElement::getTotalMemoryUsage() - memoryBefore;
+
+    VoxelTree decodeTree;
+    treeBenchmarks(tree, decodeTree, "voxels", config, results);
+    meaningfulViewBenchmarks(tree, config, results);
+    packetPackingBenchmarks(tree, config, results);
+
+    linearVoxelTreeBenchmarks(tree, treeMemory, config, results);
+}
+
+void OctreeBenchmarks::particleBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::particleBenchmarks()";
+
+    QVector<QByteArray> edits;
+    edits.reserve(config.particleCount);
+    unsigned char buffer[MAX_PACKET_SIZE];
+    for (int i = 0; i < config.particleCount; i++) {
+        ParticleProperties properties;
+        properties.setPosition(randomPointInWorld() * (float)TREE_SCALE);
+        properties.setRadius(randFloatInRange(0.1f, 1.0f));
+        properties.setColor(randomColor());
+        int editSize = 0;
+        if (Particle::encodeParticleEditMessageDetails(PacketTypeParticleAddOrEdit, ParticleID(NEW_PARTICLE, i, false),
+                                                       properties, buffer, sizeof(buffer), editSize)) {
+            edits.append(QByteArray((const char*)buffer, editSize));
+        }
+    }
+
+    ParticleTree tree;
+    applyEdits(tree, PacketTypeParticleAddOrEdit, edits, "particles", results);
+
+    ParticleTree decodeTree;
+    treeBenchmarks(tree, decodeTree, "particles", config, results);
+
+    particleIDBenchmarks(tree, results);
+}
+
+void OctreeBenchmarks::modelBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::modelBenchmarks()";
+
+    QVector<QByteArray> edits;
+    edits.reserve(config.modelCount);
+    unsigned char buffer[MAX_PACKET_SIZE];
+    for (int i = 0; i < config.modelCount; i++) {
+        ModelItemProperties properties;
+        properties.setPosition(randomPointInWorld() * (float)TREE_SCALE);
+        properties.setRadius(randFloatInRange(0.5f, 10.0f));
+        properties.setColor(randomColor());
+        int editSize = 0;
+        if (ModelItem::encodeModelEditMessageDetails(PacketTypeModelAddOrEdit, ModelItemID(NEW_MODEL, i, false),
+                                                     properties, buffer, sizeof(buffer), editSize)) {
+            edits.append(QByteArray((const char*)buffer, editSize));
+        }
+    }
+
+    ModelTree tree;
+    applyEdits(tree, PacketTypeModelAddOrEdit, edits, "models", results);
+
+    ModelTree decodeTree;
+    treeBenchmarks(tree, decodeTree, "models", config, results);
+
+    modelIDBenchmarks(tree, results);
+}
+
+void OctreeBenchmarks::runAllBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    voxelBenchmarks(config, results);
+    particleBenchmarks(config, results);
+    particleSimulationBenchmarks(config, results);
+    particleCollisionBenchmarks(config, results);
+    modelBenchmarks(config, results);
+    elementBagBenchmarks(config, results);
+    svoLoadBenchmarks(config, results);
+}
@@ -0,0 +1,76 @@
+//
+//  OctreeBenchmarks.h
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Timings of the octree server hot paths on synthetic voxel, particle and model worlds: applying edits, encoding
+//  scenes for client views, decoding them again, and saving and loading SVO files.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeBenchmarks_h
+#define hifi_OctreeBenchmarks_h
+
+#include <QtGlobal>
+
+class BenchmarkResults;
+class ModelTree;
+class ParticleTree;
+class VoxelTree;
+
+class BenchmarkConfig {
+public:
+    BenchmarkConfig();
+
+    int voxelCount;
+    int particleCount;
+    int simulatedParticleCount; // unscripted particles simulated in batches and one by one, then ten times as many
+    int collidingParticleCount; // particles checked for collisions against each other and the avatars
+    int avatarCount;
+    int modelCount;
+    int viewCount; // simulated client views that each world is encoded for
+    int rayCount; // ray intersections, and as many sphere penetrations, done against the voxel worlds
+    int bagCount; // element bags that are alive while elements are deleted
+    int deleteCount; // elements deleted while the bags are alive
+    int svoMegabytes; // size of the voxel SVO file that is loaded serially and in parallel
+};
+
+namespace OctreeBenchmarks {
+    void voxelBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+
+    /// LinearVoxelTree against the VoxelTree it is built from: memory per voxel, ray and sphere query throughput, and
+    /// encoding the whole world.
+    /// treeMemory is what the tree's elements use.
+    void linearVoxelTreeBenchmarks(VoxelTree& tree, quint64 treeMemory, const BenchmarkConfig& config,
+                                   BenchmarkResults& results);
+
+    /// Time to a first meaningful view of the voxel world from random client views, extracting from the element bag in
+    /// any order and by priority.
+    void meaningfulViewBenchmarks(VoxelTree& tree, const BenchmarkConfig& config, BenchmarkResults& results);
+
+    /// Packets per view and how full they are, when the compressed sections target the raw space left in a wire packet
+    /// and when they target the size predicted to fill it.
+    void packetPackingBenchmarks(VoxelTree& tree, const BenchmarkConfig& config, BenchmarkResults& results);
+
+    void particleBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+    void modelBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+
+    /// Lookups, edits and deletes by ID of every particle or model in the tree, which deletes them all.
+    void particleIDBenchmarks(ParticleTree& tree, BenchmarkResults& results);
+    void modelIDBenchmarks(ModelTree& tree, BenchmarkResults& results);
+
+    /// Ticks of ParticleTree::update() on unscripted particles, integrated in batches and one particle at a time.
+    void particleSimulationBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+
+    /// ParticleCollisionSystem::update() on moving particles among avatars, with the broadphase and without it.
+    void particleCollisionBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+
+    void elementBagBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+    void svoLoadBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+    void runAllBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results);
+}
+
+#endif // hifi_OctreeBenchmarks_h
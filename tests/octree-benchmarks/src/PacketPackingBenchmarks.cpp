@@ -0,0 +1,210 @@
+//
+//  PacketPackingBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <climits>
+
+#include <QDebug>
+#include <QVector>
+
+#include <OctreeElementBag.h>
+#include <OctreePacketData.h>
+#include <VoxelTree.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+// the ways the send threads have cut compressed sections to fill their wire packets
+enum PackingStrategy {
+    RAW_TARGET_PACKING, // each section targets the raw space left in the wire packet, as before size prediction
+    PREDICTED_ZLIB_PACKING,
+    PREDICTED_FAST_LZ_PACKING
+};
+
+const int PACKING_STRATEGIES = 3;
+
+class PackedScene {
+public:
+    PackedScene() : packets(0), encodedAgain(0), wireBytes(0) { }
+
+    int packets;
+    int encodedAgain; // sections that compressed so much worse than predicted that they outgrew an empty packet
+    quint64 wireBytes; // the section sizes and section payloads of the packets, not counting their headers
+    QVector<QByteArray> sections;
+};
+
+static void startSection(OctreePacketData& packetData, PackingStrategy strategy, int available) {
+    int compressedBytesAvailable = available - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+    switch (strategy) {
+        case RAW_TARGET_PACKING:
+            // the first section of a packet can't overflow it, it would just be sent in a packet of its own
+            if (available < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
+                compressedBytesAvailable -= COMPRESS_PADDING;
+            }
+            packetData.changeSettings(true, compressedBytesAvailable, ZLIB_PACKET_COMPRESSION);
+            break;
+        case PREDICTED_ZLIB_PACKING:
+            packetData.changeCompressedSettings(compressedBytesAvailable, ZLIB_PACKET_COMPRESSION);
+            break;
+        case PREDICTED_FAST_LZ_PACKING:
+            packetData.changeCompressedSettings(compressedBytesAvailable, FAST_LZ_PACKET_COMPRESSION);
+            break;
+    }
+}
+
+static void sendPacket(PackedScene& scene, int& available) {
+    scene.packets++;
+    scene.wireBytes += MAX_OCTREE_PACKET_DATA_SIZE - available;
+    available = MAX_OCTREE_PACKET_DATA_SIZE;
+}
+
+// Packs everything viewFrustum can see into wire packets the way OctreeSendThread::packetDistributor() does, with its
+// packets per interval limit lifted. The caller is responsible for locking the tree.
+static PackedScene packScene(VoxelTree& tree, const ViewFrustum* viewFrustum, OctreePacketData& packetData,
+                             PackingStrategy strategy) {
+    PackedScene scene;
+    OctreeElementBag bag;
+    bag.insert(tree.getRoot());
+
+    // the send threads used to keep packing for as long as there was space, now they give up after a few sections
+    int maxExtraPackingAttempts = (strategy == RAW_TARGET_PACKING) ? INT_MAX : REASONABLE_NUMBER_OF_PACKING_ATTEMPTS;
+    int extraPackingAttempts = 0;
+    int available = MAX_OCTREE_PACKET_DATA_SIZE;
+    startSection(packetData, strategy, available);
+    QVector<OctreeElement*> sectionSubTrees;
+
+    while (!bag.isEmpty()) {
+        OctreeElement* subTree = bag.extract();
+        sectionSubTrees.append(subTree);
+        EncodeBitstreamParams params(INT_MAX, viewFrustum);
+        int bytesWritten = tree.encodeTreeBitstream(subTree, &packetData, bag, params);
+        bool lastNodeDidntFit = (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT);
+        if (!lastNodeDidntFit && !bag.isEmpty()) {
+            continue;
+        }
+
+        bool sendNow = true;
+        if (packetData.hasContent()) {
+            int writtenSize = packetData.getFinalizedSize() + sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
+            if (writtenSize > (int)MAX_OCTREE_PACKET_DATA_SIZE) {
+                // not even an empty packet holds the section, its subtrees are encoded again at the size that fits
+                foreach (OctreeElement* sectionSubTree, sectionSubTrees) {
+                    bag.insert(sectionSubTree);
+                }
+                scene.encodedAgain++;
+            } else {
+                if (writtenSize > available) {
+                    sendPacket(scene, available);
+                    extraPackingAttempts = 0;
+                }
+                scene.sections.append(QByteArray((const char*)packetData.getFinalizedData(),
+                                                 packetData.getFinalizedSize()));
+                available -= writtenSize;
+            }
+            sendNow = available < (int)MINIMUM_ATTEMPT_MORE_PACKING
+                      || extraPackingAttempts >= maxExtraPackingAttempts;
+        } else if (lastNodeDidntFit && available == (int)MAX_OCTREE_PACKET_DATA_SIZE) {
+            qDebug() << "packScene() an element doesn't fit in an empty packet, the scene is incomplete";
+            break;
+        }
+        // an element that didn't fit in an empty section won't fit in a smaller one either, so then we send now
+
+        if (sendNow) {
+            if (available < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
+                sendPacket(scene, available);
+            }
+            extraPackingAttempts = 0;
+        } else {
+            extraPackingAttempts++;
+        }
+        startSection(packetData, strategy, available);
+        sectionSubTrees.clear();
+    }
+    if (available < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
+        sendPacket(scene, available);
+    }
+    return scene;
+}
+
+// How full the compressed wire packets of a scene are, and how many of them a scene takes, with sections cut at the raw
+// space left in the packet as the send threads used to, and at the predicted size with either codec. Every scene is
+// decoded again, the way the clients do, to show that the larger predicted sections lose nothing.
+void OctreeBenchmarks::packetPackingBenchmarks(VoxelTree& tree, const BenchmarkConfig& config,
+                                               BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::packetPackingBenchmarks()";
+
+    if (config.viewCount <= 0) {
+        return;
+    }
+
+    const char* strategyNames[PACKING_STRATEGIES] = { "packing.rawTarget", "packing.predictedZlib",
+                                                      "packing.predictedFastLZ" };
+    OctreePacketCompressionCodec codecs[PACKING_STRATEGIES] = { ZLIB_PACKET_COMPRESSION, ZLIB_PACKET_COMPRESSION,
+                                                                FAST_LZ_PACKET_COMPRESSION };
+    quint64 encodeUsecs[PACKING_STRATEGIES] = { 0, 0, 0 };
+    quint64 compressCalls[PACKING_STRATEGIES] = { 0, 0, 0 };
+    quint64 packets[PACKING_STRATEGIES] = { 0, 0, 0 };
+    quint64 encodedAgain[PACKING_STRATEGIES] = { 0, 0, 0 };
+    quint64 wireBytes[PACKING_STRATEGIES] = { 0, 0, 0 };
+    quint64 decodedElements[PACKING_STRATEGIES] = { 0, 0, 0 };
+
+    // like the send threads, each strategy keeps its packet data, and so its compression ratio, from scene to scene
+    QVector<OctreePacketData*> packetData;
+    for (int i = 0; i < PACKING_STRATEGIES; i++) {
+        packetData.append(new OctreePacketData(true));
+    }
+
+    VoxelTree decodeTree;
+    ReadBitstreamToTreeParams args(WANT_COLOR, WANT_EXISTS_BITS, NULL, QUuid(), SharedNodePointer(), false,
+                                   decodeTree.expectedVersion());
+    for (int view = 0; view < config.viewCount; view++) {
+        ViewFrustum viewFrustum;
+        setupRandomView(viewFrustum);
+
+        // all strategies pack the same views
+        for (int i = 0; i < PACKING_STRATEGIES; i++) {
+            quint64 startCompressCalls = OctreePacketData::getCompressContentCalls();
+            tree.lockForRead();
+            quint64 start = usecTimestampNow();
+            PackedScene scene = packScene(tree, &viewFrustum, *packetData[i], (PackingStrategy)i);
+            encodeUsecs[i] += usecTimestampNow() - start;
+            tree.unlock();
+            compressCalls[i] += OctreePacketData::getCompressContentCalls() - startCompressCalls;
+            packets[i] += scene.packets;
+            encodedAgain[i] += scene.encodedAgain;
+            wireBytes[i] += scene.wireBytes;
+
+            decodeTree.lockForWrite();
+            decodeTree.eraseAllOctreeElements();
+            foreach (const QByteArray& section, scene.sections) {
+                OctreePacketData sectionData(true, OctreePacketData::getMaxSectionSize(codecs[i]), codecs[i]);
+                sectionData.loadFinalizedContent((const unsigned char*)section.constData(), section.size());
+                decodeTree.readBitstreamToTree(sectionData.getUncompressedData(), sectionData.getUncompressedSize(),
+                                               args);
+            }
+            decodedElements[i] += decodeTree.getOctreeElementsCount();
+            decodeTree.unlock();
+        }
+    }
+
+    for (int i = 0; i < PACKING_STRATEGIES; i++) {
+        QString name = strategyNames[i];
+        results.add(name + ".packetsPerView", (double)packets[i] / config.viewCount, "packets");
+        results.add(name + ".encodePerView.usecs", (double)encodeUsecs[i] / config.viewCount, "usecs");
+        results.add(name + ".sectionsEncodedAgainPerView", (double)encodedAgain[i] / config.viewCount, "sections");
+        results.add(name + ".decodedElementsPerView", (double)decodedElements[i] / config.viewCount, "elements");
+        if (packets[i] > 0) {
+            double capacity = (double)packets[i] * MAX_OCTREE_PACKET_DATA_SIZE;
+            results.add(name + ".fillRatio", wireBytes[i] / capacity, "ratio");
+            results.add(name + ".compressCallsPerPacket", (double)compressCalls[i] / packets[i], "calls");
+        }
+        delete packetData[i];
+    }
+}
@@ -0,0 +1,72 @@
+//
+//  ParticleCollisionBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QUuid>
+#include <QVector>
+
+#include <AvatarHashMap.h>
+#include <Particle.h>
+#include <ParticleCollisionSystem.h>
+#include <ParticleTree.h>
+#include <SharedUtil.h>
+#include <VoxelTree.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+void OctreeBenchmarks::particleCollisionBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::particleCollisionBenchmarks()";
+
+    // The particles move, so the broadphase is built over new positions every update, and the few that collide are moved
+    // in it. The voxel tree is empty and nothing is sent or played. What is timed is the collision checks, for every
+    // particle against the other particles and the avatars, with the broadphase and with the brute force search it
+    // replaced. Both start from the same particles and avatars.
+    const float MAX_SPEED = 10.0f; // meters per second
+    const float LONG_LIFETIME = 3600.0f; // none of them die while they are timed
+    QVector<Particle> startingParticles;
+    startingParticles.reserve(config.collidingParticleCount);
+    for (int i = 0; i < config.collidingParticleCount; i++) {
+        glm::vec3 velocity = glm::vec3(randFloatInRange(-MAX_SPEED, MAX_SPEED), randFloatInRange(-MAX_SPEED, MAX_SPEED),
+                                       randFloatInRange(-MAX_SPEED, MAX_SPEED)) / (float)TREE_SCALE;
+        startingParticles.append(randomParticle(velocity, glm::vec3(0.0f), LONG_LIFETIME));
+    }
+    VoxelTree voxels;
+    AvatarHashMap avatars;
+    for (int i = 0; i < config.avatarCount; i++) {
+        AvatarSharedPointer avatar(new AvatarData());
+        avatar->setPosition(randomPointInWorld() * (float)TREE_SCALE);
+        avatars.insert(QUuid::createUuid(), avatar);
+    }
+
+    const int BROADPHASE_KINDS = 2;
+    const char* kindNames[BROADPHASE_KINDS] = { "particles.collisions.noBroadphase", "particles.collisions" };
+    bool useBroadphase[BROADPHASE_KINDS] = { false, true };
+    for (int kind = 0; kind < BROADPHASE_KINDS; kind++) {
+        ParticleTree particles;
+        foreach (const Particle& particle, startingParticles) {
+            particles.storeParticle(particle);
+        }
+        ParticleCollisionSystem collisionSystem(NULL, &particles, &voxels, NULL, &avatars);
+        collisionSystem.setUseBroadphase(useBroadphase[kind]);
+
+        // only the collision checks are timed, not the ticks that move the particles between them
+        const int UPDATE_COUNT = 10;
+        quint64 elapsed = 0;
+        for (int i = 0; i < UPDATE_COUNT; i++) {
+            particles.update();
+            quint64 start = usecTimestampNow();
+            collisionSystem.update();
+            elapsed += usecTimestampNow() - start;
+        }
+        results.addRate(kindNames[kind], elapsed, (quint64)config.collidingParticleCount * UPDATE_COUNT);
+    }
+}
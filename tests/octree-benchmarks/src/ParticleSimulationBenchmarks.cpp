@@ -0,0 +1,71 @@
+//
+//  ParticleSimulationBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QVector>
+
+#include <Particle.h>
+#include <ParticleTree.h>
+#include <SharedUtil.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+// Ticks of ParticleTree::update() on particles that only move, so that every one of them is in the batch. The same
+// particles are also ticked in a tree that runs Particle::update() on each of them, as every tree did before batching.
+static void simulateParticles(int particleCount, BenchmarkResults& results) {
+    const int UPDATE_COUNT = 10;
+    const float LONG_LIFETIME = 3600.0f; // none of them die while they are timed
+    QString name = QString("particles.simulate.%1").arg(particleCount);
+
+    QVector<Particle> particles;
+    particles.reserve(particleCount);
+    for (int i = 0; i < particleCount; i++) {
+        glm::vec3 velocity = glm::vec3(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f),
+                                       randFloatInRange(-1.0f, 1.0f)) / (float)TREE_SCALE;
+        particles.append(randomParticle(velocity, DEFAULT_GRAVITY, LONG_LIFETIME));
+    }
+
+    const int SIMULATION_KINDS = 2;
+    const char* kindNames[SIMULATION_KINDS] = { ".update", ".updatePerParticle" };
+    bool inBatches[SIMULATION_KINDS] = { true, false };
+    for (int kind = 0; kind < SIMULATION_KINDS; kind++) {
+        ParticleTree tree;
+        tree.setSimulateInBatches(inBatches[kind]);
+        quint64 start = usecTimestampNow();
+        foreach (const Particle& particle, particles) {
+            tree.storeParticle(particle);
+        }
+        if (inBatches[kind]) {
+            results.addRate(name + ".store", usecTimestampNow() - start, particleCount);
+        }
+
+        // the first tick adds the particles to the batch, the others only integrate it
+        start = usecTimestampNow();
+        tree.update();
+        results.addRate(name + kindNames[kind] + ".first", usecTimestampNow() - start, particleCount);
+
+        start = usecTimestampNow();
+        for (int i = 1; i < UPDATE_COUNT; i++) {
+            tree.update();
+        }
+        results.addRate(name + kindNames[kind], usecTimestampNow() - start,
+                        (quint64)particleCount * (UPDATE_COUNT - 1));
+    }
+}
+
+void OctreeBenchmarks::particleSimulationBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::particleSimulationBenchmarks()";
+
+    const int LARGER_WORLD_FACTOR = 10;
+    simulateParticles(config.simulatedParticleCount, results);
+    simulateParticles(config.simulatedParticleCount * LARGER_WORLD_FACTOR, results);
+}
@@ -0,0 +1,110 @@
+//
+//  SVOLoadBenchmarks.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QThreadPool>
+
+#include <OctalCode.h>
+#include <VoxelTree.h>
+
+#include "BenchmarkResults.h"
+#include "BenchmarkWorld.h"
+#include "OctreeBenchmarks.h"
+
+// the octal code of the index'th element at depth, in the order that the elements are in the tree
+static QByteArray octalCodeForIndex(quint64 index, int depth) {
+    QByteArray code(bytesRequiredForCodeLength(depth), 0);
+    code[0] = depth;
+    for (int section = 0; section < depth; section++) {
+        int value = (index >> (BITS_IN_OCTAL * (depth - 1 - section))) & (NUMBER_OF_CHILDREN - 1);
+        int bit = BITS_IN_OCTAL * section;
+        // a section can straddle two bytes, so it is placed in a 16 bit window
+        int shiftedValue = value << (16 - BITS_IN_OCTAL - bit % 8);
+        code[1 + bit / 8] = code[1 + bit / 8] | (char)(shiftedValue >> 8);
+        if (2 + bit / 8 < code.size()) {
+            code[2 + bit / 8] = code[2 + bit / 8] | (char)(shiftedValue & 0xFF);
+        }
+    }
+    return code;
+}
+
+// Loading a voxel SVO file of any size on one thread and on as many as the global thread pool has. The file is written
+// directly rather than from a tree, so that it can be bigger than would fit in memory twice.
+void OctreeBenchmarks::svoLoadBenchmarks(const BenchmarkConfig& config, BenchmarkResults& results) {
+    qDebug() << "OctreeBenchmarks::svoLoadBenchmarks()";
+
+    if (config.svoMegabytes <= 0) {
+        return;
+    }
+
+    // every subtree is an element with eight children, which each have eight colored leaves
+    QByteArray subtreeData;
+    subtreeData.append((char)0x00); // no colored children
+    subtreeData.append((char)0xFF); // eight children with children
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        subtreeData.append((char)0xFF); // eight colored children
+        for (int j = 0; j < NUMBER_OF_CHILDREN; j++) {
+            xColor color = randomColor();
+            subtreeData.append((char)color.red);
+            subtreeData.append((char)color.green);
+            subtreeData.append((char)color.blue);
+        }
+        subtreeData.append((char)0x00); // no children with children
+    }
+
+    // the subtrees are spread over the whole domain, the way the packets of a big world are
+    const int SUBTREE_DEPTH = 10;
+    quint64 fileBytes = (quint64)config.svoMegabytes * 1024 * 1024;
+    quint64 subtreeBytes = bytesRequiredForCodeLength(SUBTREE_DEPTH) + subtreeData.size();
+    quint64 subtreeCount = (fileBytes + subtreeBytes - 1) / subtreeBytes;
+    quint64 subtreeStride = std::max((quint64)1, ((quint64)1 << (BITS_IN_OCTAL * SUBTREE_DEPTH)) / subtreeCount);
+
+    QByteArray fileName = QDir(QDir::tempPath()).filePath("octree-benchmarks-load.svo").toLocal8Bit();
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "svoLoadBenchmarks() unable to write" << fileName;
+        return;
+    }
+    for (quint64 i = 0; i < subtreeCount; i++) {
+        file.write(octalCodeForIndex(i * subtreeStride, SUBTREE_DEPTH));
+        file.write(subtreeData);
+    }
+    file.close();
+    results.add("svoLoad.bytes", QFile(fileName).size(), "bytes");
+
+    const int LOAD_KINDS = 2;
+    const char* loadNames[LOAD_KINDS] = { "svoLoad.serial", "svoLoad.parallel" };
+    int loadThreads[LOAD_KINDS] = { 1, 0 };
+    unsigned long elementCounts[LOAD_KINDS];
+    for (int i = 0; i < LOAD_KINDS; i++) {
+        VoxelTree tree;
+        tree.setMaxLoadThreads(loadThreads[i]);
+        tree.lockForWrite();
+        quint64 start = usecTimestampNow();
+        bool fileOk = tree.readFromSVOFile(fileName.constData());
+        quint64 elapsed = usecTimestampNow() - start;
+        tree.unlock();
+        if (!fileOk) {
+            qDebug() << "svoLoadBenchmarks() failed to read" << fileName;
+        }
+        elementCounts[i] = tree.getOctreeElementsCount();
+        results.addRate(loadNames[i], elapsed, elementCounts[i]);
+    }
+    results.add("svoLoad.parallel.threads", QThreadPool::globalInstance()->maxThreadCount(), "threads");
+    if (elementCounts[0] != elementCounts[1]) {
+        qDebug() << "svoLoadBenchmarks() parallel load has" << elementCounts[1] << "elements, the serial one"
+            << elementCounts[0];
+    }
+    QFile::remove(fileName);
+}
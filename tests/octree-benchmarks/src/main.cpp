@@ -0,0 +1,76 @@
+//
+//  main.cpp
+//  tests/octree-benchmarks/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Usage: octree-benchmarks [--voxels N] [--particles N] [--simulated N] [--colliding N] [--avatars N] [--models N]
+//                           [--views N] [--rays N] [--bags N] [--deletes N] [--svoMegabytes N] [--seed N]
+//                           [--output file.json]
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+
+#include <NodeList.h>
+#include <SharedUtil.h>
+
+#include "BenchmarkResults.h"
+#include "OctreeBenchmarks.h"
+
+static void readIntOption(int argc, const char** argv, const char* option, int& value, BenchmarkResults& results) {
+    const char* optionValue = getCmdOption(argc, argv, option);
+    if (optionValue) {
+        value = atoi(optionValue);
+    }
+    results.setConfig(QString(option).mid(2), value); // without the leading dashes
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    NodeList::createInstance(NodeType::Agent); // the avatar hash map of the collision benchmarks connects to it
+    const char** constArgv = const_cast<const char**>(argv);
+
+    BenchmarkConfig config;
+    BenchmarkResults results;
+    readIntOption(argc, constArgv, "--voxels", config.voxelCount, results);
+    readIntOption(argc, constArgv, "--particles", config.particleCount, results);
+    readIntOption(argc, constArgv, "--simulated", config.simulatedParticleCount, results);
+    readIntOption(argc, constArgv, "--colliding", config.collidingParticleCount, results);
+    readIntOption(argc, constArgv, "--avatars", config.avatarCount, results);
+    readIntOption(argc, constArgv, "--models", config.modelCount, results);
+    readIntOption(argc, constArgv, "--views", config.viewCount, results);
+    readIntOption(argc, constArgv, "--rays", config.rayCount, results);
+    readIntOption(argc, constArgv, "--bags", config.bagCount, results);
+    readIntOption(argc, constArgv, "--deletes", config.deleteCount, results);
+    readIntOption(argc, constArgv, "--svoMegabytes", config.svoMegabytes, results);
+
+    // the same seed generates the same worlds and views, so that builds can be compared
+    int seed = 1;
+    readIntOption(argc, constArgv, "--seed", seed, results);
+    srand(seed);
+
+    OctreeBenchmarks::runAllBenchmarks(config, results);
+
+    // the log goes to stderr, so stdout only has the results
+    QByteArray json = results.toJson();
+    const char* outputFileName = getCmdOption(argc, constArgv, "--output");
+    if (outputFileName) {
+        QFile outputFile(outputFileName);
+        if (!outputFile.open(QIODevice::WriteOnly)) {
+            qDebug() << "Unable to write results to" << outputFileName;
+            return 1;
+        }
+        outputFile.write(json);
+    } else {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,402 @@
+//
+//  JurisdictionLoadTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <JurisdictionLoad.h>
+#include <OctalCode.h>
+
+#include "JurisdictionLoadTests.h"
+
+static const quint64 INTERVAL_USECS = 1000000;
+
+// an edit under the given child of the load's root that took the given fraction of an interval
+static void recordChildEdit(JurisdictionLoad& load, int childIndex, float fraction) {
+    unsigned char* childCode = childOctalCode(load.getRootOctalCode(), childIndex);
+    unsigned char* editCode = childOctalCode(childCode, 0);
+    int editLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(editCode)) + SIZE_OF_COLOR_DATA;
+    load.recordEdit(editCode, editLength, (quint64)(fraction * INTERVAL_USECS));
+    delete[] childCode;
+    delete[] editCode;
+}
+
+// an interval in which only the given child is busy, and proposes what the load calls for
+static JurisdictionLoad::Proposal busyInterval(JurisdictionLoad& load, const JurisdictionMap* jurisdiction,
+                                               int childIndex, float fraction, int& splitChild) {
+    recordChildEdit(load, childIndex, fraction);
+    load.endInterval(INTERVAL_USECS);
+    return load.propose(jurisdiction, splitChild);
+}
+
+// a jurisdiction rooted at the given child of the universe, or at the universe for -1, with an end node two levels under
+// the given child of the root, if any
+static JurisdictionMap* childJurisdiction(int rootChild, int endNodeChild = -1) {
+    unsigned char* rootCode = new unsigned char[1];
+    *rootCode = 0;
+    if (rootChild != -1) {
+        unsigned char* childCode = childOctalCode(rootCode, rootChild);
+        delete[] rootCode;
+        rootCode = childCode;
+    }
+    std::vector<unsigned char*> endNodes;
+    if (endNodeChild != -1) {
+        unsigned char* endNodeParent = childOctalCode(rootCode, endNodeChild);
+        endNodes.push_back(childOctalCode(endNodeParent, 2));
+        delete[] endNodeParent;
+    }
+    return new JurisdictionMap(rootCode, endNodes); // takes ownership of the codes
+}
+
+void JurisdictionLoadTests::recordTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "JurisdictionLoadTests::recordTests()";
+
+    {
+        testsTaken++;
+        QString testName = "edits are charged to the whole jurisdiction and the child they are under";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionMap* jurisdiction = childJurisdiction(3);
+        JurisdictionLoad load(jurisdiction);
+        recordChildEdit(load, 5, 0.25f);
+        recordChildEdit(load, 5, 0.25f);
+        recordChildEdit(load, 1, 0.125f);
+
+        // addressed to the root like particle edits, or to somewhere outside of the jurisdiction
+        unsigned char rootCode = 0;
+        load.recordEdit(&rootCode, 1, INTERVAL_USECS / 8);
+        unsigned char* outsideCode = childOctalCode(&rootCode, 6);
+        load.recordEdit(outsideCode, bytesRequiredForCodeLength(1), INTERVAL_USECS / 8);
+        delete[] outsideCode;
+        load.endInterval(INTERVAL_USECS);
+
+        bool passed = load.getLast(JurisdictionLoad::TOTAL).edits == 5 &&
+            load.getLastLoad(JurisdictionLoad::TOTAL) == 0.875f &&
+            load.getLast(5).edits == 2 && load.getLastLoad(5) == 0.5f &&
+            load.getLast(1).edits == 1 && load.getLastLoad(1) == 0.125f;
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            if (i != 5 && i != 1) {
+                passed = passed && load.getLast(i).edits == 0;
+            }
+        }
+        delete jurisdiction;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    total=" << load.getLastLoad(JurisdictionLoad::TOTAL) << "child5=" << load.getLastLoad(5)
+                << "child1=" << load.getLastLoad(1);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "encodes are charged to the child the client is in";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // the universe is the unit cube, so child 6 is the one at high x and y and low z
+        JurisdictionLoad load;
+        QUuid inside = QUuid::createUuid();
+        QUuid outside = QUuid::createUuid();
+        load.recordEncode(inside, glm::vec3(0.75f, 0.75f, 0.25f), INTERVAL_USECS / 4);
+        load.recordEncode(inside, glm::vec3(0.75f, 0.75f, 0.25f), INTERVAL_USECS / 4);
+        load.recordEncode(outside, glm::vec3(1.5f, 0.5f, 0.5f), INTERVAL_USECS / 4);
+        load.endInterval(INTERVAL_USECS);
+
+        bool passed = load.getLastLoad(6) == 0.5f && load.getLast(6).clients.size() == 1 &&
+            load.getLastLoad(JurisdictionLoad::TOTAL) == 0.75f && load.getLast(JurisdictionLoad::TOTAL).clients.size() == 2;
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            if (i != 6) {
+                passed = passed && load.getLast(i).encodeUsecs == 0;
+            }
+        }
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    child6=" << load.getLastLoad(6) << "total=" << load.getLastLoad(JurisdictionLoad::TOTAL);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "endInterval() starts over and setJurisdiction() forgets everything";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionLoad load;
+        recordChildEdit(load, 2, 0.5f);
+        load.endInterval(INTERVAL_USECS);
+        load.endInterval(INTERVAL_USECS);
+        bool passed = load.getLast(2).edits == 0 && load.getLastLoad(JurisdictionLoad::TOTAL) == 0.0f;
+
+        recordChildEdit(load, 2, 0.5f);
+        load.endInterval(INTERVAL_USECS);
+        JurisdictionMap* jurisdiction = childJurisdiction(2);
+        load.setJurisdiction(jurisdiction);
+        passed = passed && load.getLastIntervalUsecs() == 0 && load.getLast(2).edits == 0 &&
+            load.getRootCodeLength() == 1 && compareOctalCodes(load.getRootOctalCode(),
+                                                                jurisdiction->getRootOctalCode()) == EXACT_MATCH;
+        delete jurisdiction;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void JurisdictionLoadTests::proposalTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "JurisdictionLoadTests::proposalTests()";
+
+    {
+        testsTaken++;
+        QString testName = "a split is proposed after a streak of busy intervals";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionMap* jurisdiction = childJurisdiction(-1);
+        JurisdictionLoad load(jurisdiction);
+        int splitChild = -1;
+        bool passed = true;
+        for (int i = 1; i < JurisdictionLoad::INTERVALS_BEFORE_SPLIT; i++) {
+            passed = passed && busyInterval(load, jurisdiction, 5, 0.75f, splitChild) == JurisdictionLoad::NO_PROPOSAL;
+        }
+        passed = passed && busyInterval(load, jurisdiction, 5, 0.75f, splitChild) == JurisdictionLoad::SPLIT_PROPOSAL &&
+            splitChild == 5;
+        delete jurisdiction;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    splitChild=" << splitChild;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "a quiet interval breaks the streak";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionLoad load;
+        int splitChild = -1;
+        bool passed = true;
+        for (int i = 1; i < JurisdictionLoad::INTERVALS_BEFORE_SPLIT; i++) {
+            passed = passed && busyInterval(load, NULL, 4, 0.75f, splitChild) == JurisdictionLoad::NO_PROPOSAL;
+        }
+        passed = passed && busyInterval(load, NULL, 4, 0.25f, splitChild) == JurisdictionLoad::NO_PROPOSAL &&
+            load.getBusyIntervals() == 0;
+        for (int i = 1; i < JurisdictionLoad::INTERVALS_BEFORE_SPLIT; i++) {
+            passed = passed && busyInterval(load, NULL, 4, 0.75f, splitChild) == JurisdictionLoad::NO_PROPOSAL;
+        }
+        passed = passed && busyInterval(load, NULL, 4, 0.75f, splitChild) == JurisdictionLoad::SPLIT_PROPOSAL;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "the split leaves both servers closest to half of the load";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // half of 0.9 is 0.45, which child 2 is closest to, and a child without load is never split off
+        JurisdictionLoad load;
+        int splitChild = -1;
+        JurisdictionLoad::Proposal proposal = JurisdictionLoad::NO_PROPOSAL;
+        for (int i = 0; i < JurisdictionLoad::INTERVALS_BEFORE_SPLIT; i++) {
+            recordChildEdit(load, 1, 0.1f);
+            recordChildEdit(load, 2, 0.4f);
+            recordChildEdit(load, 7, 0.3f);
+            recordChildEdit(load, 3, 0.1f);
+            load.endInterval(INTERVAL_USECS);
+            proposal = load.propose(NULL, splitChild);
+        }
+        bool passed = proposal == JurisdictionLoad::SPLIT_PROPOSAL && splitChild == 2;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    proposal=" << proposal << "splitChild=" << splitChild;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "a child that is partly another server's is not split off";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // child 3 alone would be the best split, but there is an end node under it
+        JurisdictionMap* jurisdiction = childJurisdiction(-1, 3);
+        JurisdictionLoad load(jurisdiction);
+        int splitChild = -1;
+        JurisdictionLoad::Proposal proposal = JurisdictionLoad::NO_PROPOSAL;
+        for (int i = 0; i < JurisdictionLoad::INTERVALS_BEFORE_SPLIT; i++) {
+            recordChildEdit(load, 3, 0.5f);
+            recordChildEdit(load, 0, 0.2f);
+            load.endInterval(INTERVAL_USECS);
+            proposal = load.propose(jurisdiction, splitChild);
+        }
+        bool passed = proposal == JurisdictionLoad::SPLIT_PROPOSAL && splitChild == 0;
+
+        // with only that child busy there is nothing to split off
+        JurisdictionLoad onlyPartlyOurs(jurisdiction);
+        for (int i = 0; i < JurisdictionLoad::INTERVALS_BEFORE_SPLIT; i++) {
+            proposal = busyInterval(onlyPartlyOurs, jurisdiction, 3, 0.75f, splitChild);
+        }
+        passed = passed && proposal == JurisdictionLoad::NO_PROPOSAL;
+        delete jurisdiction;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    proposal=" << proposal << "splitChild=" << splitChild;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "an idle subtree server proposes a merge after a streak of idle intervals";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionMap* jurisdiction = childJurisdiction(6);
+        JurisdictionLoad load(jurisdiction);
+        int splitChild = -1;
+        bool passed = true;
+        for (int i = 1; i < JurisdictionLoad::INTERVALS_BEFORE_MERGE; i++) {
+            passed = passed && busyInterval(load, jurisdiction, 1, 0.01f, splitChild) == JurisdictionLoad::NO_PROPOSAL;
+        }
+        passed = passed && busyInterval(load, jurisdiction, 1, 0.01f, splitChild) == JurisdictionLoad::MERGE_PROPOSAL;
+        delete jurisdiction;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "the universe and servers with end nodes never propose a merge";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionMap* universe = childJurisdiction(-1);
+        JurisdictionMap* withEndNode = childJurisdiction(6, 2);
+        JurisdictionLoad universeLoad(universe);
+        JurisdictionLoad endNodeLoad(withEndNode);
+        bool passed = true;
+        int splitChild = -1;
+        for (int i = 0; i < 2 * JurisdictionLoad::INTERVALS_BEFORE_MERGE; i++) {
+            universeLoad.endInterval(INTERVAL_USECS);
+            endNodeLoad.endInterval(INTERVAL_USECS);
+            passed = passed && universeLoad.propose(universe, splitChild) == JurisdictionLoad::NO_PROPOSAL &&
+                endNodeLoad.propose(withEndNode, splitChild) == JurisdictionLoad::NO_PROPOSAL;
+        }
+        passed = passed && endNodeLoad.getIdleIntervals() == 2 * JurisdictionLoad::INTERVALS_BEFORE_MERGE;
+        delete universe;
+        delete withEndNode;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "nothing is proposed before the first complete interval";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionMap* jurisdiction = childJurisdiction(6);
+        JurisdictionLoad load(jurisdiction);
+        int splitChild = -1;
+        bool passed = true;
+        for (int i = 0; i < 2 * JurisdictionLoad::INTERVALS_BEFORE_MERGE; i++) {
+            passed = passed && load.propose(jurisdiction, splitChild) == JurisdictionLoad::NO_PROPOSAL;
+        }
+        passed = passed && load.getIdleIntervals() == 0;
+        delete jurisdiction;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void JurisdictionLoadTests::runAllTests(bool verbose) {
+    recordTests(verbose);
+    proposalTests(verbose);
+}
@@ -0,0 +1,20 @@
+//
+//  JurisdictionLoadTests.h
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JurisdictionLoadTests_h
+#define hifi_JurisdictionLoadTests_h
+
+namespace JurisdictionLoadTests {
+    void recordTests(bool verbose = false);
+    void proposalTests(bool verbose = false);
+    void runAllTests(bool verbose = false);
+}
+
+#endif // hifi_JurisdictionLoadTests_h
@@ -0,0 +1,352 @@
+//
+//  JurisdictionMapTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QVector>
+
+#include <JurisdictionMap.h>
+#include <LimitedNodeList.h>
+#include <OctalCode.h>
+#include <PacketHeaders.h>
+#include <SharedUtil.h>
+
+#include "JurisdictionMapTests.h"
+
+// a random code up to maxDepth deep, which mostly follows the sections of base so that it lands near it
+static unsigned char* randomCode(int maxDepth, const unsigned char* base) {
+    unsigned char* code = new unsigned char[1];
+    *code = 0;
+    int depth = randIntInRange(0, maxDepth);
+    int baseLength = base ? numberOfThreeBitSectionsInCode(base) : 0;
+    for (int section = 0; section < depth; section++) {
+        bool followBase = section < baseLength && randIntInRange(0, 3) != 0;
+        char childNumber = followBase ? getOctalCodeSectionValue(base, section) : (char)randIntInRange(0, 7);
+        unsigned char* childCode = childOctalCode(code, childNumber);
+        delete[] code;
+        code = childCode;
+    }
+    return code;
+}
+
+// the linear lookup that isMyJurisdiction() used before it had an index
+static JurisdictionMap::Area linearIsMyJurisdiction(const JurisdictionMap& map, const unsigned char* nodeOctalCode) {
+    if (isAncestorOf(nodeOctalCode, map.getRootOctalCode())) {
+        return JurisdictionMap::ABOVE;
+    }
+    bool isInJurisdiction = isAncestorOf(map.getRootOctalCode(), nodeOctalCode);
+    for (int i = 0; isInJurisdiction && i < map.getEndNodeCount(); i++) {
+        if (isAncestorOf(map.getEndNodeOctalCode(i), nodeOctalCode)) {
+            isInJurisdiction = false;
+        }
+    }
+    return isInJurisdiction ? JurisdictionMap::WITHIN : JurisdictionMap::BELOW;
+}
+
+static JurisdictionMap* randomJurisdiction(int endNodeCount) {
+    std::vector<unsigned char*> endNodes;
+    unsigned char* rootCode = randomCode(4, NULL);
+    for (int i = 0; i < endNodeCount; i++) {
+        endNodes.push_back(randomCode(8, rootCode));
+    }
+    return new JurisdictionMap(rootCode, endNodes); // takes ownership of the codes
+}
+
+void JurisdictionMapTests::isMyJurisdictionTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "JurisdictionMapTests::isMyJurisdictionTests()";
+
+    {
+        testsTaken++;
+        QString testName = "isMyJurisdiction() matches the linear lookup";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        const int MAP_COUNT = 500;
+        const int CODES_PER_MAP = 1000;
+        int mismatches = 0;
+        for (int i = 0; i < MAP_COUNT; i++) {
+            JurisdictionMap* map = randomJurisdiction(randIntInRange(0, 6));
+            for (int j = 0; j < CODES_PER_MAP; j++) {
+                const unsigned char* base = (map->getEndNodeCount() > 0 && randIntInRange(0, 1))
+                    ? map->getEndNodeOctalCode(0) : map->getRootOctalCode();
+                unsigned char* code = randomCode(10, base);
+                JurisdictionMap::Area expected = linearIsMyJurisdiction(*map, code);
+                if (map->isMyJurisdiction(code, CHECK_NODE_ONLY) != expected ||
+                        map->isMyJurisdiction(code, randIntInRange(0, 7)) != expected) {
+                    mismatches++;
+                }
+                delete[] code;
+            }
+            delete map;
+        }
+
+        bool passed = (mismatches == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    mismatches=" << mismatches;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "isMyJurisdiction() follows assignment";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        JurisdictionMap map;
+        unsigned char* rootCode = new unsigned char[1];
+        *rootCode = 0;
+        unsigned char* parent = childOctalCode(rootCode, 4);
+        unsigned char* endNode = childOctalCode(parent, 0);
+        unsigned char* underEndNode = childOctalCode(endNode, 3);
+        unsigned char* beside = childOctalCode(parent, 1);
+
+        bool passed = map.isMyJurisdiction(underEndNode, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN;
+        map = JurisdictionMap(qPrintable(octalCodeToHexString(rootCode)), qPrintable(octalCodeToHexString(endNode)));
+        passed = passed && map.isMyJurisdiction(underEndNode, CHECK_NODE_ONLY) == JurisdictionMap::BELOW;
+        passed = passed && map.isMyJurisdiction(endNode, CHECK_NODE_ONLY) == JurisdictionMap::BELOW;
+        passed = passed && map.isMyJurisdiction(beside, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN;
+        map = JurisdictionMap(qPrintable(octalCodeToHexString(parent)), qPrintable(octalCodeToHexString(beside)));
+        passed = passed && map.isMyJurisdiction(underEndNode, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN;
+        passed = passed && map.isMyJurisdiction(beside, CHECK_NODE_ONLY) == JurisdictionMap::BELOW;
+        passed = passed && map.isMyJurisdiction(rootCode, CHECK_NODE_ONLY) == JurisdictionMap::ABOVE;
+
+        delete[] rootCode;
+        delete[] parent;
+        delete[] endNode;
+        delete[] underEndNode;
+        delete[] beside;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "performance - isMyJurisdiction() vs linear lookup";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // a fine grained jurisdiction, which is where the linear lookup hurts
+        const int END_NODE_COUNT = 64;
+        const int CODE_COUNT = 10000;
+        const int ITERATIONS = 50;
+        JurisdictionMap* map = randomJurisdiction(END_NODE_COUNT);
+        QVector<unsigned char*> codes;
+        for (int i = 0; i < CODE_COUNT; i++) {
+            codes.append(randomCode(12, map->getRootOctalCode()));
+        }
+
+        // accumulate the results so that neither loop can be optimized away
+        int linearWithin = 0;
+        quint64 start = usecTimestampNow();
+        for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+            foreach (const unsigned char* code, codes) {
+                if (linearIsMyJurisdiction(*map, code) == JurisdictionMap::WITHIN) {
+                    linearWithin++;
+                }
+            }
+        }
+        quint64 linearEnd = usecTimestampNow();
+
+        int indexedWithin = 0;
+        for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+            foreach (const unsigned char* code, codes) {
+                if (map->isMyJurisdiction(code, CHECK_NODE_ONLY) == JurisdictionMap::WITHIN) {
+                    indexedWithin++;
+                }
+            }
+        }
+        quint64 indexedEnd = usecTimestampNow();
+
+        bool passed = (indexedWithin == linearWithin);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    linearWithin=" << linearWithin << "indexedWithin=" << indexedWithin;
+        }
+        float USECS_PER_MSECS = 1000.0f;
+        qDebug() << "TIME - Test" << testsTaken <<":" << qPrintable(testName)
+                 << "linear=" << (float)(linearEnd - start) / USECS_PER_MSECS << "msecs"
+                 << "indexed=" << (float)(indexedEnd - linearEnd) / USECS_PER_MSECS << "msecs";
+
+        foreach (unsigned char* code, codes) {
+            delete[] code;
+        }
+        delete map;
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+static bool sameJurisdiction(const JurisdictionMap& first, const JurisdictionMap& second) {
+    if (first.getNodeType() != second.getNodeType() || first.getEndNodeCount() != second.getEndNodeCount() ||
+            (first.getRootOctalCode() == NULL) != (second.getRootOctalCode() == NULL)) {
+        return false;
+    }
+    if (first.getRootOctalCode() &&
+            compareOctalCodes(first.getRootOctalCode(), second.getRootOctalCode()) != EXACT_MATCH) {
+        return false;
+    }
+    for (int i = 0; i < first.getEndNodeCount(); i++) {
+        if (compareOctalCodes(first.getEndNodeOctalCode(i), second.getEndNodeOctalCode(i)) != EXACT_MATCH) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void JurisdictionMapTests::packetTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "JurisdictionMapTests::packetTests()";
+
+    // the packet headers carry the session UUID of the node list
+    LimitedNodeList::createInstance();
+
+    const int MAP_COUNT = 500;
+    unsigned char buffer[MAX_PACKET_SIZE];
+
+    {
+        testsTaken++;
+        QString testName = "unpackFromMessage() gives back the map that packIntoMessage() packed";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        const NodeType_t NODE_TYPES[] = { NodeType::VoxelServer, NodeType::ParticleServer, NodeType::ModelServer };
+        int mismatches = 0;
+        for (int i = 0; i < MAP_COUNT; i++) {
+            JurisdictionMap* map = randomJurisdiction(randIntInRange(0, 6));
+            map->setNodeType(NODE_TYPES[i % 3]);
+            int packedBytes = map->packIntoMessage(buffer, MAX_PACKET_SIZE);
+            JurisdictionMap unpackedMap;
+            int unpackedBytes = unpackedMap.unpackFromMessage(buffer, packedBytes);
+            if (unpackedBytes != packedBytes || !sameJurisdiction(*map, unpackedMap)) {
+                mismatches++;
+            }
+            delete map;
+        }
+
+        bool passed = (mismatches == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    maps=" << MAP_COUNT << "mismatches=" << mismatches;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "an empty jurisdiction unpacks with its node type and no root";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        int packedBytes = JurisdictionMap::packEmptyJurisdictionIntoMessage(NodeType::ParticleServer, buffer,
+                                                                            MAX_PACKET_SIZE);
+        JurisdictionMap unpackedMap;
+        int unpackedBytes = unpackedMap.unpackFromMessage(buffer, packedBytes);
+
+        bool passed = (unpackedBytes == packedBytes && unpackedMap.getNodeType() == NodeType::ParticleServer &&
+                       unpackedMap.getRootOctalCode() == NULL && unpackedMap.getEndNodeCount() == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    packedBytes=" << packedBytes << "unpackedBytes=" << unpackedBytes;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "truncated and damaged messages unpack without reading past their end";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // a truncated message can only lose end nodes, or the root and all of them
+        int overreads = 0;
+        int extraEndNodes = 0;
+        for (int i = 0; i < MAP_COUNT; i++) {
+            JurisdictionMap* map = randomJurisdiction(randIntInRange(1, 6));
+            int packedBytes = map->packIntoMessage(buffer, MAX_PACKET_SIZE);
+            int headerBytes = numBytesForPacketHeader(reinterpret_cast<const char*>(buffer));
+            int truncatedBytes = randIntInRange(headerBytes, packedBytes - 1);
+            JurisdictionMap truncatedMap;
+            if (truncatedMap.unpackFromMessage(buffer, truncatedBytes) > truncatedBytes) {
+                overreads++;
+            }
+            if (truncatedMap.getEndNodeCount() > map->getEndNodeCount()) {
+                extraEndNodes++;
+            }
+
+            // the same message with random bytes in place of everything after the header
+            for (int j = headerBytes; j < packedBytes; j++) {
+                buffer[j] = (unsigned char)randIntInRange(0, 255);
+            }
+            JurisdictionMap damagedMap;
+            if (damagedMap.unpackFromMessage(buffer, packedBytes) > packedBytes) {
+                overreads++;
+            }
+            delete map;
+        }
+
+        bool passed = (overreads == 0 && extraEndNodes == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    overreads=" << overreads << "extraEndNodes=" << extraEndNodes;
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void JurisdictionMapTests::runAllTests(bool verbose) {
+    isMyJurisdictionTests(verbose);
+    packetTests(verbose);
+}
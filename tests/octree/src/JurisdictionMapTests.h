@@ -0,0 +1,20 @@
+//
+//  JurisdictionMapTests.h
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JurisdictionMapTests_h
+#define hifi_JurisdictionMapTests_h
+
+namespace JurisdictionMapTests {
+    void isMyJurisdictionTests(bool verbose = false);
+    void packetTests(bool verbose = false);
+    void runAllTests(bool verbose = false);
+}
+
+#endif // hifi_JurisdictionMapTests_h
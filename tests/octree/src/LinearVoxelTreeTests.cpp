@@ -0,0 +1,302 @@
+//
+//  LinearVoxelTreeTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cmath>
+#include <cstring>
+
+#include <QDebug>
+#include <QVector>
+
+#include <LinearVoxelTree.h>
+#include <OctalCode.h>
+#include <OctreePacketData.h>
+#include <SharedUtil.h>
+#include <VoxelTree.h>
+#include <VoxelTreeElement.h>
+
+#include "LinearVoxelTreeTests.h"
+
+// the voxels are in a cube in the middle of the domain, so that rays can start outside of them
+const float WORLD_CORNER = 0.25f;
+const float WORLD_SCALE = 0.5f;
+
+// voxels of mixed sizes, so that some are made inside of others and split them
+static void addRandomVoxels(VoxelTree& tree, int voxelCount) {
+    const int MIN_LEVEL = 5;
+    const int MAX_LEVEL = 10;
+    for (int i = 0; i < voxelCount; i++) {
+        float scale = 1.0f / (1 << randIntInRange(MIN_LEVEL, MAX_LEVEL));
+        float x = WORLD_CORNER + floorf(randFloatInRange(0.0f, WORLD_SCALE) / scale) * scale;
+        float y = WORLD_CORNER + floorf(randFloatInRange(0.0f, WORLD_SCALE) / scale) * scale;
+        float z = WORLD_CORNER + floorf(randFloatInRange(0.0f, WORLD_SCALE) / scale) * scale;
+        tree.createVoxel(x, y, z, scale, randIntInRange(0, 255), randIntInRange(0, 255), randIntInRange(0, 255));
+    }
+}
+
+static bool sameVoxels(const LinearVoxelTree& first, const LinearVoxelTree& second) {
+    if (first.getVoxelCount() != second.getVoxelCount()) {
+        return false;
+    }
+    for (int i = 0; i < first.getVoxelCount(); i++) {
+        const LinearVoxel& firstVoxel = first.getVoxel(i);
+        const LinearVoxel& secondVoxel = second.getVoxel(i);
+        if (firstVoxel.mortonCode != secondVoxel.mortonCode || firstVoxel.level != secondVoxel.level ||
+                memcmp(firstVoxel.color, secondVoxel.color, sizeof(rgbColor)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LinearVoxelTreeTests::roundTripTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "LinearVoxelTreeTests::roundTripTests()";
+
+    const int VOXEL_COUNT = 2000;
+    VoxelTree tree;
+    addRandomVoxels(tree, VOXEL_COUNT);
+    LinearVoxelTree linearTree;
+    linearTree.buildFromTree(&tree);
+
+    {
+        testsTaken++;
+        QString testName = "every linear voxel is a colored leaf of the tree";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        int mismatches = 0;
+        for (int i = 0; i < linearTree.getVoxelCount(); i++) {
+            unsigned char* octalCode = linearTree.getVoxelOctalCode(i);
+            AACube cube = linearTree.getVoxelCube(i);
+            VoxelTreeElement* element = tree.getVoxelAt(cube.getCorner().x, cube.getCorner().y, cube.getCorner().z,
+                                                         cube.getScale());
+            const LinearVoxel& voxel = linearTree.getVoxel(i);
+            if (!element || !element->isLeaf() || !element->isColored() ||
+                    compareOctalCodes(element->getOctalCode(), octalCode) != EXACT_MATCH ||
+                    memcmp(element->getColor(), voxel.color, sizeof(rgbColor)) != 0) {
+                mismatches++;
+            }
+            delete[] octalCode;
+        }
+
+        bool passed = (linearTree.getVoxelCount() > 0 && mismatches == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    voxels=" << linearTree.getVoxelCount() << "mismatches=" << mismatches;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "writeToTree() and buildFromTree() give back the same voxels";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        VoxelTree copiedTree;
+        linearTree.writeToTree(&copiedTree);
+        LinearVoxelTree copiedLinearTree;
+        copiedLinearTree.buildFromTree(&copiedTree);
+
+        bool passed = sameVoxels(linearTree, copiedLinearTree);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    voxels=" << linearTree.getVoxelCount() << "copied=" << copiedLinearTree.getVoxelCount();
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "addVoxel() in any order sorts the same as buildFromTree()";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        LinearVoxelTree addedTree;
+        for (int i = linearTree.getVoxelCount() - 1; i >= 0; i--) {
+            unsigned char* octalCode = linearTree.getVoxelOctalCode(i);
+            addedTree.addVoxel(octalCode, linearTree.getVoxel(i).color);
+            delete[] octalCode;
+        }
+        addedTree.finalize();
+
+        bool passed = sameVoxels(linearTree, addedTree);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "encodeSubTree() packets decode to the same voxels";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // small packets, so that subtrees are left over and encoded in later ones
+        const int SMALL_PACKET_SIZE = 256;
+        OctreePacketData packetData(false, SMALL_PACKET_SIZE);
+        QVector<LinearSubTree> remaining;
+        LinearSubTree root = { 0, 0 };
+        remaining.append(root);
+        VoxelTree decodedTree;
+        ReadBitstreamToTreeParams args(WANT_COLOR, WANT_EXISTS_BITS, NULL, QUuid(), SharedNodePointer(), false,
+                                       decodedTree.expectedVersion());
+        int packets = 0;
+        bool fits = true;
+        while (!remaining.isEmpty() || packetData.hasContent()) {
+            if (!remaining.isEmpty()) {
+                LinearSubTree subTree = remaining.takeLast();
+                if (linearTree.encodeSubTree(subTree, &packetData, remaining) > 0) {
+                    continue;
+                }
+                if (!packetData.hasContent()) {
+                    fits = false;
+                    break;
+                }
+            }
+            decodedTree.readBitstreamToTree(packetData.getUncompressedData(), packetData.getUncompressedSize(), args);
+            packetData.reset();
+            packets++;
+        }
+        LinearVoxelTree decodedLinearTree;
+        decodedLinearTree.buildFromTree(&decodedTree);
+
+        bool passed = fits && packets > 1 && sameVoxels(linearTree, decodedLinearTree);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    voxels=" << linearTree.getVoxelCount() << "decoded=" << decodedLinearTree.getVoxelCount()
+                     << "packets=" << packets << "fits=" << fits;
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void LinearVoxelTreeTests::rayIntersectionTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "LinearVoxelTreeTests::rayIntersectionTests()";
+
+    const int VOXEL_COUNT = 2000;
+    VoxelTree tree;
+    addRandomVoxels(tree, VOXEL_COUNT);
+    LinearVoxelTree linearTree;
+    linearTree.buildFromTree(&tree);
+
+    {
+        testsTaken++;
+        QString testName = "findRayIntersection() matches Octree::findRayIntersection()";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // rays start above the voxels and point at a random place among them, so that most of them hit something
+        const int RAY_COUNT = 5000;
+        const float DISTANCE_TOLERANCE = 0.001f; // meters
+        int hits = 0;
+        int mismatches = 0;
+        for (int i = 0; i < RAY_COUNT; i++) {
+            glm::vec3 origin(randFloatInRange(0.0f, 1.0f), 0.9f, randFloatInRange(0.0f, 1.0f));
+            glm::vec3 target = glm::vec3(WORLD_CORNER) + WORLD_SCALE *
+                glm::vec3(randFloatInRange(0.0f, 1.0f), randFloatInRange(0.0f, 1.0f), randFloatInRange(0.0f, 1.0f));
+            glm::vec3 direction = glm::normalize(target - origin);
+            origin *= (float)TREE_SCALE;
+
+            OctreeElement* element = NULL;
+            float treeDistance;
+            BoxFace treeFace;
+            bool treeHit = tree.findRayIntersection(origin, direction, element, treeDistance, treeFace, NULL,
+                                                    Octree::NoLock);
+            float linearDistance;
+            BoxFace linearFace;
+            int voxelIndex;
+            bool linearHit = linearTree.findRayIntersection(origin, direction, linearDistance, linearFace, voxelIndex);
+
+            if (treeHit != linearHit) {
+                mismatches++;
+            } else if (treeHit) {
+                hits++;
+                if (fabsf(treeDistance - linearDistance) > DISTANCE_TOLERANCE) {
+                    mismatches++;
+                }
+            }
+        }
+
+        bool passed = (hits > 0 && mismatches == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    hits=" << hits << "mismatches=" << mismatches;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "rays that pass beside the voxels hit nothing";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        glm::vec3 origin = glm::vec3(0.1f, 0.1f, 0.1f) * (float)TREE_SCALE;
+        glm::vec3 direction(1.0f, 0.0f, 0.0f); // along the bottom of the domain, below the voxels
+        float distance;
+        BoxFace face;
+        int voxelIndex;
+        bool passed = !linearTree.findRayIntersection(origin, direction, distance, face, voxelIndex);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void LinearVoxelTreeTests::runAllTests(bool verbose) {
+    roundTripTests(verbose);
+    rayIntersectionTests(verbose);
+}
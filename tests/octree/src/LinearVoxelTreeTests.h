@@ -0,0 +1,20 @@
+//
+//  LinearVoxelTreeTests.h
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LinearVoxelTreeTests_h
+#define hifi_LinearVoxelTreeTests_h
+
+namespace LinearVoxelTreeTests {
+    void roundTripTests(bool verbose = false);
+    void rayIntersectionTests(bool verbose = false);
+    void runAllTests(bool verbose = false);
+}
+
+#endif // hifi_LinearVoxelTreeTests_h
@@ -251,6 +251,93 @@ void ModelTests::modelTreeTests(bool verbose) {
         qDebug() << "TIME - Test" << testsTaken <<":" << qPrintable(testName) << "elapsed=" << elapsedInMSecs << "msecs";
     }
 
+    {
+        testsTaken++;
+        QString testName = "models leave the index when their elements are deleted";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // half of the models near the origin, which is in the root's first child, and half near the far corner
+        ModelTree indexedTree;
+        const int MODEL_COUNT = 100;
+        for (int i = 0; i < MODEL_COUNT; i++) {
+            ModelItemID indexedID(i + 1);
+            indexedID.isKnownID = false; // the same workaround as above
+            glm::vec3 offset(oneMeter * (1 + i / 2));
+            properties.setPosition((i % 2 == 0) ? offset : glm::vec3((float)TREE_SCALE) - offset);
+            properties.setRadius(halfMeter);
+            indexedTree.addModel(indexedID, properties);
+        }
+        bool passed = indexedTree.getModelCount() == MODEL_COUNT;
+
+        unsigned char rootCode = 0;
+        unsigned char* nearOriginCode = childOctalCode(&rootCode, 0);
+        indexedTree.deleteOctalCodeFromTree(nearOriginCode, COLLAPSE_EMPTY_TREE);
+        delete[] nearOriginCode;
+        passed = passed && indexedTree.getModelCount() == MODEL_COUNT / 2 && !indexedTree.findModelByID(1) &&
+            indexedTree.findModelByID(2);
+
+        indexedTree.eraseAllOctreeElements();
+        passed = passed && indexedTree.getModelCount() == 0 && !indexedTree.findModelByID(2);
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    getModelCount()=" << indexedTree.getModelCount();
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "models that start playing rejoin the active models with a fresh animation clock";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        ModelTree animatedTree;
+        ModelItemID animatedID(1);
+        animatedID.isKnownID = false; // the same workaround as above
+        ModelItemProperties animatedProperties;
+        animatedProperties.setPosition(positionAtCenterInMeters);
+        animatedProperties.setRadius(halfMeter);
+        animatedTree.addModel(animatedID, animatedProperties);
+
+        // the first pass finds that the model isn't playing, so later passes skip it
+        animatedTree.update();
+        bool passed = animatedTree.getActiveModelCount() == 0;
+
+        // the model sits out passes for long enough that a clock left over from its last pass would skip many frames
+        const float ANIMATION_FPS = 100.0f;
+        const int IDLE_USECS = 500 * 1000;
+        animatedTree.update();
+        usleep(IDLE_USECS);
+
+        ModelItemProperties playingProperties;
+        playingProperties.setAnimationFPS(ANIMATION_FPS);
+        playingProperties.setAnimationFrameIndex(0.0f);
+        playingProperties.setAnimationIsPlaying(true);
+        animatedTree.updateModel(ModelItemID(1), playingProperties);
+        animatedTree.update();
+
+        const ModelItem* animatedModel = animatedTree.findModelByID(1);
+        float idleFrames = ANIMATION_FPS * (float)IDLE_USECS / (float)USECS_PER_SECOND;
+        passed = passed && animatedTree.getActiveModelCount() == 1 && animatedModel &&
+            animatedModel->getAnimationIsPlaying() && animatedModel->getAnimationFrameIndex() < idleFrames * 0.5f;
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            if (animatedModel) {
+                qDebug() << "    getAnimationFrameIndex()=" << animatedModel->getAnimationFrameIndex();
+            }
+        }
+    }
+
     qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
     if (verbose) {
         qDebug() << "******************************************************************************************";
@@ -0,0 +1,356 @@
+//
+//  OcclusionBufferTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cmath>
+#include <vector>
+
+#include <QDebug>
+
+#include <OcclusionBuffer.h>
+#include <OctreeProjectedPolygon.h>
+#include <SharedUtil.h>
+
+#include "OcclusionBufferTests.h"
+
+// the size of a pixel of the buffer in the -1 to 1 projected space
+const float PIXEL_SIZE = 2.0f / OcclusionBuffer::RESOLUTION;
+
+// a shadow, as a box would cast it, between two distances from the camera
+class TestShadow {
+public:
+    OctreeProjectedPolygon polygon;
+    float nearDistance;
+    float farDistance;
+};
+
+// counter clockwise, which is the winding OctreeProjectedPolygon::pointInside() expects
+static OctreeProjectedPolygon makeRectangle(float minX, float minY, float maxX, float maxY) {
+    OctreeProjectedPolygon polygon(4);
+    polygon.setVertex(0, glm::vec2(minX, minY));
+    polygon.setVertex(1, glm::vec2(maxX, minY));
+    polygon.setVertex(2, glm::vec2(maxX, maxY));
+    polygon.setVertex(3, glm::vec2(minX, maxY));
+    polygon.setAnyInView(true);
+    polygon.setAllInView(true);
+    return polygon;
+}
+
+// a rectangle turned by angle around its center, so that the edges don't line up with the pixels
+static OctreeProjectedPolygon makeTurnedRectangle(const glm::vec2& center, const glm::vec2& halfSize, float angle) {
+    const glm::vec2 CORNERS[] = { glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f),
+                                  glm::vec2(-1.0f, 1.0f) };
+    float cosine = cosf(angle);
+    float sine = sinf(angle);
+    OctreeProjectedPolygon polygon(4);
+    for (int i = 0; i < 4; i++) {
+        glm::vec2 corner = CORNERS[i] * halfSize;
+        polygon.setVertex(i, center + glm::vec2(corner.x * cosine - corner.y * sine, corner.x * sine + corner.y * cosine));
+    }
+    polygon.setAnyInView(true);
+    polygon.setAllInView(true);
+    return polygon;
+}
+
+static TestShadow randomShadow(float maxHalfSize, float minDistance, float maxDistance) {
+    TestShadow shadow;
+    glm::vec2 center(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+    glm::vec2 halfSize(randFloatInRange(PIXEL_SIZE * 0.25f, maxHalfSize), randFloatInRange(PIXEL_SIZE * 0.25f, maxHalfSize));
+    shadow.polygon = makeTurnedRectangle(center, halfSize, randFloatInRange(0.0f, PI));
+    shadow.nearDistance = randFloatInRange(minDistance, maxDistance);
+    shadow.farDistance = shadow.nearDistance + randFloatInRange(0.0f, maxDistance - minDistance);
+    return shadow;
+}
+
+// finds a point of the occludee, in the part of it that is on screen, that no nearer occluder hides. The buffer must
+// never call a shadow with such a point occluded.
+static bool findVisiblePoint(const TestShadow& occludee, const std::vector<TestShadow>& occluders) {
+    const int SAMPLES_PER_SIDE = 24;
+    const OctreeProjectedPolygon& polygon = occludee.polygon;
+    for (int i = 0; i < SAMPLES_PER_SIDE; i++) {
+        for (int j = 0; j < SAMPLES_PER_SIDE; j++) {
+            glm::vec2 point(polygon.getMinX() + (polygon.getMaxX() - polygon.getMinX()) * (i + 0.5f) / SAMPLES_PER_SIDE,
+                            polygon.getMinY() + (polygon.getMaxY() - polygon.getMinY()) * (j + 0.5f) / SAMPLES_PER_SIDE);
+            if (fabsf(point.x) > 1.0f || fabsf(point.y) > 1.0f || !polygon.pointInside(point)) {
+                continue;
+            }
+            bool hidden = false;
+            for (size_t k = 0; k < occluders.size() && !hidden; k++) {
+                hidden = occluders[k].farDistance < occludee.nearDistance && occluders[k].polygon.pointInside(point);
+            }
+            if (!hidden) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void OcclusionBufferTests::occludedTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "OcclusionBufferTests::occludedTests()";
+
+    const float OCCLUDER_MIN = -0.5f;
+    const float OCCLUDER_MAX = 0.5f;
+    const float OCCLUDER_FAR_DISTANCE = 10.0f;
+    const int BOX_COUNT = 500;
+
+    {
+        testsTaken++;
+        QString testName = "the first shadow is stored, not occluded";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        OcclusionBuffer buffer;
+        OctreeProjectedPolygon occluder = makeRectangle(OCCLUDER_MIN, OCCLUDER_MIN, OCCLUDER_MAX, OCCLUDER_MAX);
+        CoverageMapStorageResult result = buffer.checkBuffer(occluder, OCCLUDER_FAR_DISTANCE - 1.0f, OCCLUDER_FAR_DISTANCE);
+
+        bool passed = (result == STORED && buffer.getOccluderCount() == 1);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    result=" << result << "occluders=" << buffer.getOccluderCount();
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "boxes inside of a nearer occluder's shadow are occluded";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        OcclusionBuffer buffer;
+        buffer.checkBuffer(makeRectangle(OCCLUDER_MIN, OCCLUDER_MIN, OCCLUDER_MAX, OCCLUDER_MAX),
+                           OCCLUDER_FAR_DISTANCE - 1.0f, OCCLUDER_FAR_DISTANCE);
+
+        // the buffer tests every pixel the box's bounds touch, so keep them a pixel inside of the occluder
+        const float INSIDE_MIN = OCCLUDER_MIN + PIXEL_SIZE;
+        const float INSIDE_MAX = OCCLUDER_MAX - PIXEL_SIZE;
+        int notOccluded = 0;
+        for (int i = 0; i < BOX_COUNT; i++) {
+            float minX = randFloatInRange(INSIDE_MIN, INSIDE_MAX);
+            float minY = randFloatInRange(INSIDE_MIN, INSIDE_MAX);
+            float maxX = randFloatInRange(minX, INSIDE_MAX);
+            float maxY = randFloatInRange(minY, INSIDE_MAX);
+            float nearDistance = OCCLUDER_FAR_DISTANCE + randFloatInRange(0.01f, 100.0f);
+            if (buffer.checkBuffer(makeRectangle(minX, minY, maxX, maxY), nearDistance, nearDistance + 1.0f,
+                                   false) != OCCLUDED) {
+                notOccluded++;
+            }
+        }
+
+        bool passed = (notOccluded == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    boxes=" << BOX_COUNT << "notOccluded=" << notOccluded;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "boxes behind two occluders that meet are occluded";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // the occluders overlap by a pixel, so every pixel in between is fully inside of one of them
+        OcclusionBuffer buffer;
+        buffer.checkBuffer(makeRectangle(OCCLUDER_MIN, OCCLUDER_MIN, PIXEL_SIZE, OCCLUDER_MAX),
+                           OCCLUDER_FAR_DISTANCE - 1.0f, OCCLUDER_FAR_DISTANCE);
+        buffer.checkBuffer(makeRectangle(-PIXEL_SIZE, OCCLUDER_MIN, OCCLUDER_MAX, OCCLUDER_MAX),
+                           OCCLUDER_FAR_DISTANCE - 1.0f, OCCLUDER_FAR_DISTANCE);
+
+        OctreeProjectedPolygon box = makeRectangle(OCCLUDER_MIN + PIXEL_SIZE, OCCLUDER_MIN + PIXEL_SIZE,
+                                                   OCCLUDER_MAX - PIXEL_SIZE, OCCLUDER_MAX - PIXEL_SIZE);
+        CoverageMapStorageResult result = buffer.checkBuffer(box, OCCLUDER_FAR_DISTANCE + 1.0f,
+                                                             OCCLUDER_FAR_DISTANCE + 2.0f, false);
+
+        bool passed = (buffer.getOccluderCount() == 2 && result == OCCLUDED);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    result=" << result << "occluders=" << buffer.getOccluderCount();
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void OcclusionBufferTests::visibleTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "OcclusionBufferTests::visibleTests()";
+
+    const float OCCLUDER_MIN = -0.5f;
+    const float OCCLUDER_MAX = 0.5f;
+    const float OCCLUDER_FAR_DISTANCE = 10.0f;
+    const int BOX_COUNT = 500;
+
+    OcclusionBuffer buffer;
+    buffer.checkBuffer(makeRectangle(OCCLUDER_MIN, OCCLUDER_MIN, OCCLUDER_MAX, OCCLUDER_MAX),
+                       OCCLUDER_FAR_DISTANCE - 1.0f, OCCLUDER_FAR_DISTANCE);
+
+    {
+        testsTaken++;
+        QString testName = "boxes that stick out past the occluder's edge are not occluded";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // each box is inside of the occluder except for one side, which ends anywhere up to the edge of the screen
+        int occluded = 0;
+        for (int i = 0; i < BOX_COUNT; i++) {
+            float minX = randFloatInRange(OCCLUDER_MIN, OCCLUDER_MAX);
+            float minY = randFloatInRange(OCCLUDER_MIN, OCCLUDER_MAX);
+            float maxX = randFloatInRange(minX, OCCLUDER_MAX);
+            float maxY = randFloatInRange(minY, OCCLUDER_MAX);
+            float outside = randFloatInRange(0.001f, 1.0f);
+            switch (i % 4) {
+                case 0:
+                    minX = OCCLUDER_MIN - outside * (OCCLUDER_MIN + 1.0f);
+                    break;
+                case 1:
+                    minY = OCCLUDER_MIN - outside * (OCCLUDER_MIN + 1.0f);
+                    break;
+                case 2:
+                    maxX = OCCLUDER_MAX + outside * (1.0f - OCCLUDER_MAX);
+                    break;
+                default:
+                    maxY = OCCLUDER_MAX + outside * (1.0f - OCCLUDER_MAX);
+                    break;
+            }
+            float nearDistance = OCCLUDER_FAR_DISTANCE + randFloatInRange(0.01f, 100.0f);
+            if (buffer.checkBuffer(makeRectangle(minX, minY, maxX, maxY), nearDistance, nearDistance + 1.0f,
+                                   false) == OCCLUDED) {
+                occluded++;
+            }
+        }
+
+        bool passed = (occluded == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    boxes=" << BOX_COUNT << "occluded=" << occluded;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "boxes that straddle or are in front of the occluder's depth are not occluded";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        int occluded = 0;
+        for (int i = 0; i < BOX_COUNT; i++) {
+            float minX = randFloatInRange(OCCLUDER_MIN, OCCLUDER_MAX);
+            float minY = randFloatInRange(OCCLUDER_MIN, OCCLUDER_MAX);
+            float maxX = randFloatInRange(minX, OCCLUDER_MAX);
+            float maxY = randFloatInRange(minY, OCCLUDER_MAX);
+            // even halves straddle the occluder's far distance, odd halves are entirely in front of it
+            float nearDistance = (i % 2 == 0) ? randFloatInRange(OCCLUDER_FAR_DISTANCE - 2.0f, OCCLUDER_FAR_DISTANCE)
+                                              : randFloatInRange(0.1f, OCCLUDER_FAR_DISTANCE - 2.0f);
+            float farDistance = (i % 2 == 0) ? randFloatInRange(OCCLUDER_FAR_DISTANCE, OCCLUDER_FAR_DISTANCE + 2.0f)
+                                             : nearDistance + 1.0f;
+            if (buffer.checkBuffer(makeRectangle(minX, minY, maxX, maxY), nearDistance, farDistance,
+                                   false) == OCCLUDED) {
+                occluded++;
+            }
+        }
+
+        bool passed = (occluded == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    boxes=" << BOX_COUNT << "occluded=" << occluded;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "on random scenes, no box with a visible point is occluded";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // the same order the encoder uses: each shadow is checked, and stored if it is visible
+        const int SCENE_COUNT = 20;
+        const int SHADOWS_PER_SCENE = 200;
+        const float MAX_HALF_SIZE = 0.4f;
+        const float MIN_DISTANCE = 1.0f;
+        const float MAX_DISTANCE = 100.0f;
+        int wronglyOccluded = 0;
+        int occluded = 0;
+        for (int scene = 0; scene < SCENE_COUNT; scene++) {
+            OcclusionBuffer sceneBuffer;
+            std::vector<TestShadow> occluders;
+            for (int i = 0; i < SHADOWS_PER_SCENE; i++) {
+                TestShadow shadow = randomShadow(MAX_HALF_SIZE, MIN_DISTANCE, MAX_DISTANCE);
+                CoverageMapStorageResult result = sceneBuffer.checkBuffer(shadow.polygon, shadow.nearDistance,
+                                                                          shadow.farDistance);
+                if (result == OCCLUDED) {
+                    occluded++;
+                    if (findVisiblePoint(shadow, occluders)) {
+                        wronglyOccluded++;
+                    }
+                } else if (result == STORED) {
+                    occluders.push_back(shadow);
+                }
+            }
+        }
+
+        bool passed = (wronglyOccluded == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    occluded=" << occluded << "wronglyOccluded=" << wronglyOccluded;
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void OcclusionBufferTests::runAllTests(bool verbose) {
+    occludedTests(verbose);
+    visibleTests(verbose);
+}
@@ -0,0 +1,20 @@
+//
+//  OcclusionBufferTests.h
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OcclusionBufferTests_h
+#define hifi_OcclusionBufferTests_h
+
+namespace OcclusionBufferTests {
+    void occludedTests(bool verbose = false);
+    void visibleTests(bool verbose = false);
+    void runAllTests(bool verbose = false);
+}
+
+#endif // hifi_OcclusionBufferTests_h
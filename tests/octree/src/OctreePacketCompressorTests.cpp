@@ -0,0 +1,301 @@
+//
+//  OctreePacketCompressorTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QVector>
+
+#include <OctreePacketCompressor.h>
+#include <OctreePacketData.h>
+#include <SharedUtil.h>
+
+#include "OctreePacketCompressorTests.h"
+
+const int CODEC_COUNT = 2;
+const OctreePacketCompressionCodec CODECS[CODEC_COUNT] = { ZLIB_PACKET_COMPRESSION, FAST_LZ_PACKET_COMPRESSION };
+
+// bytes past the capacity given to decompress(), which must never be written
+const int GUARD_SIZE = 64;
+const unsigned char GUARD_BYTE = 0xA5;
+
+// inputs up to a predicted section in size, of incompressible noise, of long repeats, and of runs from the default
+// dictionary
+static QVector<QByteArray> sampleInputs() {
+    QVector<QByteArray> inputs;
+    const int SIZES[] = { 1, 3, 4, 5, 16, 100, 1000, MAX_OCTREE_UNCOMRESSED_PACKET_SIZE,
+                          MAX_OCTREE_PREDICTED_SECTION_SIZE };
+    const QByteArray& dictionary = OctreePacketCompressor::getDefaultDictionary();
+    const int RUN_LENGTH = 8;
+    for (size_t i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); i++) {
+        QByteArray noise;
+        QByteArray repeats;
+        for (int j = 0; j < SIZES[i]; j++) {
+            noise.append((char)randIntInRange(0, 255));
+            repeats.append((char)((j / 7) % 3));
+        }
+        QByteArray dictionaryRuns;
+        while (dictionaryRuns.size() < SIZES[i]) {
+            if (dictionary.size() < RUN_LENGTH || randIntInRange(0, 3) == 0) {
+                dictionaryRuns.append((char)randIntInRange(0, 255));
+            } else {
+                dictionaryRuns.append(dictionary.mid(randIntInRange(0, dictionary.size() - RUN_LENGTH), RUN_LENGTH));
+            }
+        }
+        dictionaryRuns.truncate(SIZES[i]);
+        inputs.append(noise);
+        inputs.append(repeats);
+        inputs.append(dictionaryRuns);
+    }
+    return inputs;
+}
+
+static QByteArray compress(OctreePacketCompressor& compressor, const QByteArray& input) {
+    QByteArray output(MAX_OCTREE_PREDICTED_SECTION_SIZE * 2, 0);
+    int length = compressor.compress((const unsigned char*)input.constData(), input.size(),
+                                     (unsigned char*)output.data(), output.size());
+    return (length < 0) ? QByteArray() : output.left(length);
+}
+
+/// \return the result of decompress(), or -2 if it wrote past outputCapacity
+static int guardedDecompress(OctreePacketCompressor& compressor, const QByteArray& input, int outputCapacity,
+                             QByteArray& output) {
+    output = QByteArray(outputCapacity + GUARD_SIZE, (char)GUARD_BYTE);
+    int length = compressor.decompress((const unsigned char*)input.constData(), input.size(),
+                                       (unsigned char*)output.data(), outputCapacity);
+    for (int i = outputCapacity; i < output.size(); i++) {
+        if ((unsigned char)output.at(i) != GUARD_BYTE) {
+            return -2;
+        }
+    }
+    if (length > outputCapacity) {
+        return -2;
+    }
+    output.truncate(std::max(length, 0));
+    return length;
+}
+
+// a compressor of each codec with the given dictionary, rather than the shared instances
+static OctreePacketCompressor* newCompressor(OctreePacketCompressionCodec codec, const QByteArray& dictionary) {
+    OctreePacketCompressor* compressor = (codec == FAST_LZ_PACKET_COMPRESSION)
+        ? static_cast<OctreePacketCompressor*>(new FastLZPacketCompressor())
+        : static_cast<OctreePacketCompressor*>(new ZlibPacketCompressor());
+    compressor->setDictionary(dictionary);
+    return compressor;
+}
+
+void OctreePacketCompressorTests::roundTripTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "OctreePacketCompressorTests::roundTripTests()";
+
+    QVector<QByteArray> inputs = sampleInputs();
+    const QByteArray& defaultDictionary = OctreePacketCompressor::getDefaultDictionary();
+
+    for (int useDictionary = 0; useDictionary < 2; useDictionary++) {
+        for (int i = 0; i < CODEC_COUNT; i++) {
+            OctreePacketCompressor* compressor = newCompressor(CODECS[i], useDictionary ? defaultDictionary : QByteArray());
+            testsTaken++;
+            QString testName = QString("%1 %2 dictionary: decompress() gives back what compress() was given")
+                .arg(compressor->getName()).arg(useDictionary ? "with" : "without");
+            if (verbose) {
+                qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+            }
+
+            int mismatches = 0;
+            foreach (const QByteArray& input, inputs) {
+                QByteArray compressed = compress(*compressor, input);
+                QByteArray output;
+                if (compressed.isEmpty() || guardedDecompress(*compressor, compressed, input.size(), output) != input.size()
+                        || output != input) {
+                    mismatches++;
+                }
+            }
+
+            bool passed = (mismatches == 0 && compressor->getCompressCalls() == (quint64)inputs.size());
+            if (passed) {
+                testsPassed++;
+            } else {
+                testsFailed++;
+                qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+                qDebug() << "    inputs=" << inputs.size() << "mismatches=" << mismatches;
+            }
+            delete compressor;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "the default dictionary is the same every time and fits the fast LZ window";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        bool passed = !defaultDictionary.isEmpty() &&
+            defaultDictionary.size() <= FastLZPacketCompressor::MAX_DICTIONARY_SIZE &&
+            OctreePacketCompressor::getCompressor(FAST_LZ_PACKET_COMPRESSION)->getDictionary() == defaultDictionary &&
+            OctreePacketCompressor::getCompressor(ZLIB_PACKET_COMPRESSION)->getDictionary().isEmpty();
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    dictionary size=" << defaultDictionary.size();
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "sections made of dictionary content compress smaller with the dictionary";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // short sections are where a dictionary helps, since they have little of their own to match against
+        OctreePacketCompressor* plain = newCompressor(FAST_LZ_PACKET_COMPRESSION, QByteArray());
+        OctreePacketCompressor* primed = newCompressor(FAST_LZ_PACKET_COMPRESSION, defaultDictionary);
+        int plainBytes = 0;
+        int primedBytes = 0;
+        foreach (const QByteArray& input, inputs) {
+            if (input.size() >= 100 && input.size() <= 1000) {
+                plainBytes += compress(*plain, input).size();
+                primedBytes += compress(*primed, input).size();
+            }
+        }
+        bool passed = (primedBytes < plainBytes);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    plainBytes=" << plainBytes << "primedBytes=" << primedBytes;
+        }
+        delete plain;
+        delete primed;
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void OctreePacketCompressorTests::damagedInputTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "OctreePacketCompressorTests::damagedInputTests()";
+
+    QVector<QByteArray> inputs = sampleInputs();
+    const QByteArray& defaultDictionary = OctreePacketCompressor::getDefaultDictionary();
+
+    for (int i = 0; i < CODEC_COUNT; i++) {
+        OctreePacketCompressor* compressor = newCompressor(CODECS[i], defaultDictionary);
+
+        {
+            testsTaken++;
+            QString testName = QString("%1: every truncated stream is rejected").arg(compressor->getName());
+            if (verbose) {
+                qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+            }
+
+            int accepted = 0;
+            int overruns = 0;
+            foreach (const QByteArray& input, inputs) {
+                QByteArray compressed = compress(*compressor, input);
+                for (int length = 0; length < compressed.size(); length++) {
+                    QByteArray output;
+                    int result = guardedDecompress(*compressor, compressed.left(length), input.size(), output);
+                    if (result == -2) {
+                        overruns++;
+                    } else if (result >= 0) {
+                        accepted++;
+                    }
+                }
+            }
+
+            bool passed = (accepted == 0 && overruns == 0);
+            if (passed) {
+                testsPassed++;
+            } else {
+                testsFailed++;
+                qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+                qDebug() << "    accepted=" << accepted << "overruns=" << overruns;
+            }
+        }
+
+        {
+            testsTaken++;
+            QString testName = QString("%1: corrupt streams never write past the output").arg(compressor->getName());
+            if (verbose) {
+                qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+            }
+
+            // the fast LZ codec has no checksum, so a corrupt stream may decode to other bytes, but never to more
+            const int CORRUPTIONS_PER_INPUT = 200;
+            int overruns = 0;
+            foreach (const QByteArray& input, inputs) {
+                QByteArray compressed = compress(*compressor, input);
+                for (int j = 0; j < CORRUPTIONS_PER_INPUT; j++) {
+                    QByteArray corrupt = compressed;
+                    int flips = randIntInRange(1, 3);
+                    for (int k = 0; k < flips; k++) {
+                        int at = randIntInRange(0, corrupt.size() - 1);
+                        corrupt[at] = corrupt.at(at) ^ (char)(1 << randIntInRange(0, 7));
+                    }
+                    QByteArray output;
+                    if (guardedDecompress(*compressor, corrupt, input.size(), output) == -2) {
+                        overruns++;
+                    }
+                }
+                QByteArray garbage;
+                for (int j = 0; j < compressed.size(); j++) {
+                    garbage.append((char)randIntInRange(0, 255));
+                }
+                QByteArray output;
+                if (guardedDecompress(*compressor, garbage, input.size(), output) == -2) {
+                    overruns++;
+                }
+            }
+
+            bool passed = (overruns == 0);
+            if (passed) {
+                testsPassed++;
+            } else {
+                testsFailed++;
+                qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+                qDebug() << "    overruns=" << overruns;
+            }
+        }
+
+        delete compressor;
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void OctreePacketCompressorTests::runAllTests(bool verbose) {
+    roundTripTests(verbose);
+    damagedInputTests(verbose);
+}
@@ -0,0 +1,20 @@
+//
+//  OctreePacketCompressorTests.h
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePacketCompressorTests_h
+#define hifi_OctreePacketCompressorTests_h
+
+namespace OctreePacketCompressorTests {
+    void roundTripTests(bool verbose = false);
+    void damagedInputTests(bool verbose = false);
+    void runAllTests(bool verbose = false);
+}
+
+#endif // hifi_OctreePacketCompressorTests_h
@@ -11,8 +11,11 @@
 
 #include <QDebug>
 
+#include <OctreeElement.h>
 #include <PropertyFlags.h>
 #include <SharedUtil.h>
+#include <VoxelTree.h>
+#include <VoxelTreeElement.h>
 
 #include "OctreeTests.h"
 
@@ -411,6 +414,52 @@ void OctreeTests::propertyFlagsTests() {
     qDebug() << "******************************************************************************************";
 }
 
+void OctreeTests::elementHandleTests() {
+    qDebug() << "******************************************************************************************";
+    qDebug() << "OctreeTests::elementHandleTests()";
+
+    int testsTaken = 0;
+    int testsPassed = 0;
+
+    const float VOXEL_SCALE = 0.5f;
+    VoxelTree tree;
+    tree.createVoxel(0.0f, 0.0f, 0.0f, VOXEL_SCALE, 255, 0, 0);
+    VoxelTreeElement* element = tree.getVoxelAt(0.0f, 0.0f, 0.0f, VOXEL_SCALE);
+    OctreeElementHandle handle = element ? element->getHandle() : OctreeElementHandle();
+
+    // what an element made after every slot was taken hands out
+    OctreeElementHandle noSlotHandle = handle;
+    noSlotHandle.slot = OctreeElementHandle::NO_SLOT;
+
+    testsTaken++;
+    bool passed = handle.isAlive() && !noSlotHandle.isAlive();
+    qDebug() << "Test" << testsTaken << ": the handle of a live element is alive, a NO_SLOT one isn't:"
+             << (passed ? "PASSED" : "FAILED");
+    testsPassed += passed ? 1 : 0;
+
+    tree.deleteVoxelAt(0.0f, 0.0f, 0.0f, VOXEL_SCALE);
+
+    testsTaken++;
+    passed = !handle.isAlive() && !noSlotHandle.isAlive();
+    qDebug() << "Test" << testsTaken << ": handles report dead after their element is deleted:"
+             << (passed ? "PASSED" : "FAILED");
+    testsPassed += passed ? 1 : 0;
+
+    // the new element can get the deleted one's memory and slot back, but not its generation
+    tree.createVoxel(0.0f, 0.0f, 0.0f, VOXEL_SCALE, 0, 255, 0);
+    element = tree.getVoxelAt(0.0f, 0.0f, 0.0f, VOXEL_SCALE);
+
+    testsTaken++;
+    passed = element && element->getHandle().isAlive() && !handle.isAlive() && !noSlotHandle.isAlive();
+    qDebug() << "Test" << testsTaken << ": handles stay dead when an element is made in their element's place:"
+             << (passed ? "PASSED" : "FAILED");
+    testsPassed += passed ? 1 : 0;
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    qDebug() << "******************************************************************************************";
+}
+
 void OctreeTests::runAllTests() {
     propertyFlagsTests();
+    elementHandleTests();
 }
@@ -0,0 +1,134 @@
+//
+//  ParticleCollisionTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdlib.h>
+
+#include <QDebug>
+
+#include <OctreeConstants.h>
+#include <ParticleCollisionSystem.h>
+#include <ParticleTree.h>
+#include <SharedUtil.h>
+#include <VoxelTree.h>
+
+#include "ParticleCollisionTests.h"
+
+// a random scene of particles crowded into a small cube, so that many of them overlap and move into each other
+static void randomScene(int seed, int particleCount, QVector<Particle>& particles) {
+    const float SCENE_SIZE = 10.0f; // meters
+    const float MAX_SPEED = 2.0f; // meters per second
+    srand(seed);
+    particles.clear();
+    for (int i = 0; i < particleCount; i++) {
+        glm::vec3 position = glm::vec3(TREE_SCALE * 0.5f) + glm::vec3(randFloatInRange(0.0f, SCENE_SIZE),
+            randFloatInRange(0.0f, SCENE_SIZE), randFloatInRange(0.0f, SCENE_SIZE));
+        glm::vec3 velocity(randFloatInRange(-MAX_SPEED, MAX_SPEED), randFloatInRange(-MAX_SPEED, MAX_SPEED),
+                           randFloatInRange(-MAX_SPEED, MAX_SPEED));
+        rgbColor color = { 255, 255, 255 };
+        Particle particle;
+        particle.init(position / (float)TREE_SCALE, randFloatInRange(0.1f, 1.0f) / (float)TREE_SCALE, color,
+                      velocity / (float)TREE_SCALE, glm::vec3(0.0f), DEFAULT_DAMPING, DEFAULT_LIFETIME);
+        particles.append(particle);
+    }
+}
+
+// runs the collision passes over the scene, and collects where the particles ended up and how fast they are going
+static void collideScene(const QVector<Particle>& scene, bool useBroadphase, int passes, QVector<Particle>& results) {
+    ParticleTree particles;
+    foreach (const Particle& particle, scene) {
+        particles.storeParticle(particle);
+    }
+    VoxelTree voxels;
+    ParticleCollisionSystem collisionSystem(NULL, &particles, &voxels);
+    collisionSystem.setUseBroadphase(useBroadphase);
+    for (int i = 0; i < passes; i++) {
+        collisionSystem.update();
+    }
+
+    results.clear();
+    foreach (const Particle& particle, scene) {
+        const Particle* collided = particles.findParticleByID(particle.getID());
+        if (collided) {
+            results.append(*collided);
+        }
+    }
+}
+
+void ParticleCollisionTests::broadphaseTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "ParticleCollisionTests::broadphaseTests()";
+
+    {
+        testsTaken++;
+        QString testName = "random scenes collide the same with and without the broadphase";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        const int SCENE_COUNT = 10;
+        const int PARTICLES_PER_SCENE = 200;
+        const int PASSES_PER_SCENE = 3; // later passes start with the particles that earlier ones moved
+        bool passed = true;
+        int collidedCount = 0;
+        QVector<Particle> scene;
+        QVector<Particle> withBroadphase;
+        QVector<Particle> withoutBroadphase;
+        for (int seed = 1; seed <= SCENE_COUNT; seed++) {
+            randomScene(seed, PARTICLES_PER_SCENE, scene);
+            collideScene(scene, true, PASSES_PER_SCENE, withBroadphase);
+            collideScene(scene, false, PASSES_PER_SCENE, withoutBroadphase);
+
+            if (withBroadphase.size() != scene.size() || withoutBroadphase.size() != scene.size()) {
+                passed = false;
+                continue;
+            }
+            for (int i = 0; i < scene.size(); i++) {
+                if (withBroadphase[i].getPosition() != withoutBroadphase[i].getPosition() ||
+                        withBroadphase[i].getVelocity() != withoutBroadphase[i].getVelocity()) {
+                    if (verbose) {
+                        qDebug() << "scene" << seed << "particle" << scene[i].getID() << "collided differently";
+                    }
+                    passed = false;
+                }
+                if (withoutBroadphase[i].getVelocity() != scene[i].getVelocity()) {
+                    collidedCount++;
+                }
+            }
+        }
+        // scenes in which nothing collides wouldn't show anything
+        passed = passed && collidedCount > 0;
+        if (verbose) {
+            qDebug() << collidedCount << "particles collided in" << SCENE_COUNT << "scenes";
+        }
+
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void ParticleCollisionTests::runAllTests(bool verbose) {
+    broadphaseTests(verbose);
+}
@@ -0,0 +1,19 @@
+//
+//  ParticleCollisionTests.h
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParticleCollisionTests_h
+#define hifi_ParticleCollisionTests_h
+
+namespace ParticleCollisionTests {
+    void broadphaseTests(bool verbose = false);
+    void runAllTests(bool verbose = false);
+}
+
+#endif // hifi_ParticleCollisionTests_h
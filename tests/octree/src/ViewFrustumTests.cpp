@@ -0,0 +1,192 @@
+//
+//  ViewFrustumTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QVector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AACube.h>
+#include <OctreeConstants.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+#include "ViewFrustumTests.h"
+
+// a camera in the middle of the domain, looking along a random direction
+static void setupViewFrustum(ViewFrustum& viewFrustum) {
+    float halfOfDomain = TREE_SCALE * 0.5f;
+    viewFrustum.setPosition(glm::vec3(halfOfDomain, halfOfDomain, halfOfDomain) +
+                            glm::vec3(randFloatInRange(-10.0f, 10.0f), randFloatInRange(-10.0f, 10.0f),
+                                      randFloatInRange(-10.0f, 10.0f)));
+    viewFrustum.setOrientation(glm::quat(glm::vec3(randFloatInRange(-PI, PI), randFloatInRange(-PI, PI), 0.0f)));
+    viewFrustum.setFieldOfView(DEFAULT_FIELD_OF_VIEW_DEGREES);
+    viewFrustum.setAspectRatio(DEFAULT_ASPECT_RATIO);
+    viewFrustum.setNearClip(DEFAULT_NEAR_CLIP);
+    viewFrustum.setFarClip(DEFAULT_FAR_CLIP);
+    viewFrustum.setKeyholeRadius(DEFAULT_KEYHOLE_RADIUS);
+    viewFrustum.calculate();
+}
+
+// a cube of a random octree level near the camera, in voxel scale
+static AACube randomParentCube(const ViewFrustum& viewFrustum) {
+    const int MAX_LEVEL = 16;
+    float scale = 1.0f / (float)(1 << randIntInRange(8, MAX_LEVEL));
+    glm::vec3 point = viewFrustum.getPositionVoxelScale() + glm::vec3(randFloatInRange(-0.002f, 0.002f),
+                                                                      randFloatInRange(-0.002f, 0.002f),
+                                                                      randFloatInRange(-0.002f, 0.002f));
+    glm::vec3 corner = glm::floor(point / scale) * scale;
+    return AACube(corner, scale);
+}
+
+// the children of parent in voxel scale, the way OctreeElement lays them out
+static AACube childCube(const AACube& parent, int childIndex) {
+    float childScale = parent.getScale() * 0.5f;
+    glm::vec3 offset((childIndex & 4) ? childScale : 0.0f, (childIndex & 2) ? childScale : 0.0f,
+                     (childIndex & 1) ? childScale : 0.0f);
+    return AACube(parent.getCorner() + offset, childScale);
+}
+
+static ViewFrustum::location scalarCubeInFrustum(const ViewFrustum& viewFrustum, const AACube& cube) {
+    AACube scaledCube = cube;
+    scaledCube.scale(TREE_SCALE);
+    return viewFrustum.cubeInFrustum(scaledCube);
+}
+
+static float scalarDistanceToCamera(const ViewFrustum& viewFrustum, const AACube& cube) {
+    glm::vec3 temp = viewFrustum.getPosition() - cube.calcCenter() * (float)TREE_SCALE;
+    return sqrtf(glm::dot(temp, temp));
+}
+
+void ViewFrustumTests::childrenInFrustumTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "ViewFrustumTests::childrenInFrustumTests()";
+
+    const int VIEW_COUNT = 16;
+    const int CUBES_PER_VIEW = 1000;
+
+    // the batch sums the plane distances in a different order, so cubes within rounding of a plane may differ
+    const int ALLOWED_BOUNDARY_MISMATCHES = 8;
+
+    {
+        testsTaken++;
+        QString testName = "calculateChildrenInFrustum() matches cubeInFrustum() and distanceToCamera()";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        const float DISTANCE_EPSILON = 0.001f;
+        int locationMismatches = 0;
+        int distanceMismatches = 0;
+        for (int view = 0; view < VIEW_COUNT; view++) {
+            ViewFrustum viewFrustum;
+            setupViewFrustum(viewFrustum);
+            for (int i = 0; i < CUBES_PER_VIEW; i++) {
+                AACube parent = randomParentCube(viewFrustum);
+                ViewFrustum::ChildrenInFrustum children;
+                viewFrustum.calculateChildrenInFrustum(parent, ViewFrustum::INTERSECT, children);
+                for (int child = 0; child < NUMBER_OF_CHILDREN; child++) {
+                    AACube cube = childCube(parent, child);
+                    if (children.locations[child] != scalarCubeInFrustum(viewFrustum, cube)) {
+                        locationMismatches++;
+                    }
+                    float expectedDistance = scalarDistanceToCamera(viewFrustum, cube);
+                    if (fabsf(children.distances[child] - expectedDistance) > DISTANCE_EPSILON * (1.0f + expectedDistance)) {
+                        distanceMismatches++;
+                    }
+                }
+            }
+        }
+
+        bool passed = (locationMismatches <= ALLOWED_BOUNDARY_MISMATCHES && distanceMismatches == 0);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    locationMismatches=" << locationMismatches << "distanceMismatches=" << distanceMismatches;
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "performance - calculateChildrenInFrustum() vs per child calls";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        const int ITERATIONS = 200;
+        ViewFrustum viewFrustum;
+        setupViewFrustum(viewFrustum);
+        QVector<AACube> parents;
+        for (int i = 0; i < CUBES_PER_VIEW; i++) {
+            parents.append(randomParentCube(viewFrustum));
+        }
+
+        // accumulate the results so that neither loop can be optimized away
+        int scalarInView = 0;
+        quint64 start = usecTimestampNow();
+        for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+            foreach (const AACube& parent, parents) {
+                for (int child = 0; child < NUMBER_OF_CHILDREN; child++) {
+                    AACube cube = childCube(parent, child);
+                    if (scalarCubeInFrustum(viewFrustum, cube) != ViewFrustum::OUTSIDE &&
+                            scalarDistanceToCamera(viewFrustum, cube) < TREE_SCALE) {
+                        scalarInView++;
+                    }
+                }
+            }
+        }
+        quint64 scalarEnd = usecTimestampNow();
+
+        int batchInView = 0;
+        for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+            foreach (const AACube& parent, parents) {
+                ViewFrustum::ChildrenInFrustum children;
+                viewFrustum.calculateChildrenInFrustum(parent, ViewFrustum::INTERSECT, children);
+                for (int child = 0; child < NUMBER_OF_CHILDREN; child++) {
+                    if (children.locations[child] != ViewFrustum::OUTSIDE && children.distances[child] < TREE_SCALE) {
+                        batchInView++;
+                    }
+                }
+            }
+        }
+        quint64 batchEnd = usecTimestampNow();
+
+        bool passed = (qAbs(batchInView - scalarInView) <= ITERATIONS * ALLOWED_BOUNDARY_MISMATCHES);
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+            qDebug() << "    scalarInView=" << scalarInView << "batchInView=" << batchInView;
+        }
+        float USECS_PER_MSECS = 1000.0f;
+        qDebug() << "TIME - Test" << testsTaken <<":" << qPrintable(testName)
+                 << "scalar=" << (float)(scalarEnd - start) / USECS_PER_MSECS << "msecs"
+                 << "batch=" << (float)(batchEnd - scalarEnd) / USECS_PER_MSECS << "msecs";
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void ViewFrustumTests::runAllTests(bool verbose) {
+    childrenInFrustumTests(verbose);
+}
@@ -8,13 +8,27 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "JurisdictionLoadTests.h"
+#include "JurisdictionMapTests.h"
+#include "LinearVoxelTreeTests.h"
 #include "ModelTests.h"
+#include "OcclusionBufferTests.h"
+#include "OctreePacketCompressorTests.h"
 #include "OctreeTests.h"
+#include "ParticleCollisionTests.h"
 #include "AABoxCubeTests.h"
+#include "ViewFrustumTests.h"
 
 int main(int argc, char** argv) {
     OctreeTests::runAllTests();
     AABoxCubeTests::runAllTests();
     ModelTests::runAllTests(true);
+    ViewFrustumTests::runAllTests(true);
+    JurisdictionMapTests::runAllTests(true);
+    JurisdictionLoadTests::runAllTests(true);
+    LinearVoxelTreeTests::runAllTests(true);
+    OctreePacketCompressorTests::runAllTests(true);
+    OcclusionBufferTests::runAllTests(true);
+    ParticleCollisionTests::runAllTests(true);
     return 0;
 }
@@ -0,0 +1,102 @@
+//
+//  AllocationCounter.cpp
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <new>
+#include <stdlib.h>
+
+#include "AllocationCounter.h"
+
+static bool counting = false;
+static int numAllocations = 0;
+
+static inline void countAllocation() {
+    if (counting) {
+        ++numAllocations;
+    }
+}
+
+void AllocationCounter::start() {
+    numAllocations = 0;
+    counting = true;
+}
+
+int AllocationCounter::stop() {
+    counting = false;
+    return numAllocations;
+}
+
+#ifdef __GLIBC__
+
+// glibc exports its allocator under these names too, so ours can count and pass everything on
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+
+    void* malloc(size_t size) {
+        countAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) {
+        countAllocation();
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) {
+        countAllocation();
+        return __libc_realloc(pointer, size);
+    }
+}
+
+#else
+
+// dynamic exception specifications are deprecated since C++11 and gone in C++17, which declares the operators this way
+#if __cplusplus >= 201103L
+#define THROWS_BAD_ALLOC
+#define THROWS_NOTHING noexcept
+#else
+#define THROWS_BAD_ALLOC throw(std::bad_alloc)
+#define THROWS_NOTHING throw()
+#endif
+
+void* operator new(size_t size) THROWS_BAD_ALLOC {
+    countAllocation();
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](size_t size) THROWS_BAD_ALLOC {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) THROWS_NOTHING {
+    free(pointer);
+}
+
+void operator delete[](void* pointer) THROWS_NOTHING {
+    free(pointer);
+}
+
+#ifdef __cpp_sized_deallocation
+// C++14 deletes with the size when it knows it, which would otherwise go to the library's operators
+void operator delete(void* pointer, size_t size) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void* pointer, size_t size) noexcept {
+    free(pointer);
+}
+#endif
+
+#endif // __GLIBC__
@@ -0,0 +1,25 @@
+//
+//  AllocationCounter.h
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Counts the heap allocations made between start() and stop(), for tests of code that shouldn't allocate. On glibc
+//  every malloc is counted, which catches Qt containers as well as new. Elsewhere only new is counted.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AllocationCounter_h
+#define hifi_AllocationCounter_h
+
+namespace AllocationCounter {
+    /// Starts counting allocations. Only allocations on the calling thread should happen while counting.
+    void start();
+
+    /// \return the number of allocations since start()
+    int stop();
+}
+
+#endif // hifi_AllocationCounter_h
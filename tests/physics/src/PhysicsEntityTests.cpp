@@ -0,0 +1,246 @@
+//
+//  PhysicsEntityTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <float.h>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <CapsuleShape.h>
+#include <PhysicsEntity.h>
+#include <ShapeCollider.h>
+#include <SharedUtil.h>
+#include <SphereShape.h>
+
+#include "PhysicsEntityTests.h"
+
+const int NUM_SKELETON_SHAPES = 60; // as many as a detailed avatar has joints
+const float SKELETON_HEIGHT = 1.8f;
+const float SKELETON_WIDTH = 0.6f;
+
+static glm::vec3 randVector(float scale) {
+    return scale * glm::vec3(randFloat() - 0.5f, randFloat() - 0.5f, randFloat() - 0.5f);
+}
+
+// spheres and capsules scattered through the box of a standing avatar, like the shapes of its joints
+class SkeletonEntity : public PhysicsEntity {
+public:
+    SkeletonEntity(int numShapes = NUM_SKELETON_SHAPES) : _numShapes(numShapes) {
+        setEnableShapes(true);
+    }
+
+    virtual ~SkeletonEntity() {
+        clearShapes();
+    }
+
+    virtual void buildShapes() {
+        for (int i = 0; i < _numShapes; ++i) {
+            glm::vec3 center = glm::vec3(SKELETON_WIDTH, SKELETON_HEIGHT, SKELETON_WIDTH) *
+                glm::vec3(randFloat() - 0.5f, randFloat(), randFloat() - 0.5f);
+            float radius = 0.02f + 0.06f * randFloat();
+            if (i % 2 == 0) {
+                _shapes.push_back(new SphereShape(radius, center));
+            } else {
+                glm::vec3 halfAxis = randVector(0.2f);
+                _shapes.push_back(new CapsuleShape(radius, center - halfAxis, center + halfAxis));
+            }
+        }
+        setShapeBackPointers();
+    }
+
+    void moveShapes(const glm::vec3& offset) {
+        for (int i = 0; i < _shapes.size(); ++i) {
+            _shapes[i]->setTranslation(_shapes[i]->getTranslation() + offset);
+        }
+    }
+
+private:
+    int _numShapes;
+};
+
+// the results of a query, to compare with and without the tree
+class QueryResults {
+public:
+    std::vector<int> shapes;
+    std::vector<glm::vec3> penetrations;
+    bool rayHit;
+    float rayDistance;
+
+    bool operator==(const QueryResults& other) const {
+        return shapes == other.shapes && penetrations == other.penetrations &&
+            rayHit == other.rayHit && (!rayHit || rayDistance == other.rayDistance);
+    }
+};
+
+static void runQuery(SkeletonEntity& entity, const glm::vec3& center, float radius,
+        const glm::vec3& rayStart, const glm::vec3& rayDirection, QueryResults& results) {
+    CollisionList collisions(NUM_SKELETON_SHAPES);
+    entity.findSphereCollisions(center, radius, collisions);
+    results.shapes.clear();
+    results.penetrations.clear();
+    for (int i = 0; i < collisions.size(); ++i) {
+        results.shapes.push_back(collisions.getCollision(i)->_intData);
+        results.penetrations.push_back(collisions.getCollision(i)->_penetration);
+    }
+    results.rayDistance = FLT_MAX;
+    results.rayHit = entity.findRayIntersection(rayStart, rayDirection, results.rayDistance);
+}
+
+void PhysicsEntityTests::shapeTreeFindsWhatScanFinds() {
+    const int NUM_QUERIES = 500;
+    srand(1234);
+    SkeletonEntity entity;
+    std::vector<QueryResults> scanResults(NUM_QUERIES);
+    std::vector<glm::vec3> centers;
+    std::vector<glm::vec3> rayStarts;
+    std::vector<glm::vec3> rayDirections;
+    int numHits = 0;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        centers.push_back(glm::vec3(0.0f, 0.5f * SKELETON_HEIGHT, 0.0f) + randVector(SKELETON_HEIGHT));
+        rayStarts.push_back(randVector(4.0f * SKELETON_HEIGHT));
+        rayDirections.push_back(glm::normalize(centers.back() - rayStarts.back() + randVector(0.5f)));
+        runQuery(entity, centers[i], 0.1f, rayStarts[i], rayDirections[i], scanResults[i]);
+        if (!scanResults[i].shapes.empty()) {
+            ++numHits;
+        }
+    }
+    if (numHits == 0 || numHits == NUM_QUERIES) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected some queries to hit and some not, but "
+            << numHits << " hit" << std::endl;
+    }
+
+    entity.updateShapeTree();
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        QueryResults treeResults;
+        runQuery(entity, centers[i], 0.1f, rayStarts[i], rayDirections[i], treeResults);
+        if (!(treeResults == scanResults[i])) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: query " << i
+                << " differs between the tree and the scan" << std::endl;
+            return;
+        }
+    }
+}
+
+void PhysicsEntityTests::shapeTreeFollowsMovedShapes() {
+    srand(4321);
+    SkeletonEntity entity;
+    entity.updateShapeTree();
+    glm::vec3 center(0.0f, 0.5f * SKELETON_HEIGHT, 0.0f);
+    float radius = SKELETON_HEIGHT;
+    CollisionList collisions(NUM_SKELETON_SHAPES);
+    if (!entity.findSphereCollisions(center, radius, collisions)) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: a sphere around the skeleton should touch it" << std::endl;
+    }
+
+    // walk away, one step a frame
+    const glm::vec3 STEP(0.3f, 0.0f, 0.0f);
+    const int NUM_STEPS = 20;
+    for (int i = 0; i < NUM_STEPS; ++i) {
+        entity.moveShapes(STEP);
+        entity.updateShapeTree();
+    }
+    glm::vec3 offset = (float)NUM_STEPS * STEP;
+    collisions.clear();
+    if (entity.findSphereCollisions(center, radius, collisions)) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: the skeleton should have moved away" << std::endl;
+    }
+    collisions.clear();
+    if (!entity.findSphereCollisions(center + offset, radius, collisions)) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: a sphere around the moved skeleton should touch it"
+            << std::endl;
+    }
+    float distance = FLT_MAX;
+    glm::vec3 rayStart = entity.getShapes().at(0)->getTranslation() - glm::vec3(0.0f, 0.0f, 4.0f);
+    if (!entity.findRayIntersection(rayStart, glm::vec3(0.0f, 0.0f, 1.0f), distance)) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: a ray through the moved skeleton should hit it" << std::endl;
+    }
+}
+
+void PhysicsEntityTests::shapeTreeFindsMoreShapesThanFit() {
+    // a find lists only so many shapes, and one that touches more than that tests every shape instead
+    const int NUM_SHAPES = 200;
+    srand(2468);
+    SkeletonEntity entity(NUM_SHAPES);
+    entity.updateShapeTree();
+    glm::vec3 center(0.0f, 0.5f * SKELETON_HEIGHT, 0.0f);
+    CollisionList collisions(NUM_SHAPES);
+    entity.findSphereCollisions(center, SKELETON_HEIGHT, collisions);
+    if (collisions.size() != NUM_SHAPES) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: a sphere around the skeleton should touch all " << NUM_SHAPES
+            << " shapes, but touched " << collisions.size() << std::endl;
+    }
+    for (int i = 0; i < collisions.size(); ++i) {
+        if (collisions.getCollision(i)->_intData != i) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected the shapes in order, but collision " << i
+                << " is with shape " << collisions.getCollision(i)->_intData << std::endl;
+            break;
+        }
+    }
+}
+
+void PhysicsEntityTests::measureShapeQueries() {
+    const int NUM_QUERIES = 100000;
+    const float PARTICLE_RADIUS = 0.05f;
+    srand(5678);
+    SkeletonEntity entity;
+    std::vector<glm::vec3> centers;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        centers.push_back(glm::vec3(0.0f, 0.5f * SKELETON_HEIGHT, 0.0f) + randVector(2.0f * SKELETON_HEIGHT));
+    }
+    glm::vec3 rayStart(0.0f, 0.5f * SKELETON_HEIGHT, -10.0f);
+    CollisionList collisions(NUM_SKELETON_SHAPES);
+
+    // without the tree, then with it
+    quint64 sphereUsecs[2];
+    quint64 rayUsecs[2];
+    for (int i = 0; i < 2; ++i) {
+        if (i == 1) {
+            entity.updateShapeTree();
+        }
+        quint64 startTime = usecTimestampNow();
+        for (int j = 0; j < NUM_QUERIES; ++j) {
+            collisions.clear();
+            entity.findSphereCollisions(centers[j], PARTICLE_RADIUS, collisions);
+        }
+        sphereUsecs[i] = usecTimestampNow() - startTime;
+
+        startTime = usecTimestampNow();
+        for (int j = 0; j < NUM_QUERIES; ++j) {
+            float distance;
+            entity.findRayIntersection(rayStart, glm::normalize(centers[j] - rayStart), distance);
+        }
+        rayUsecs[i] = usecTimestampNow() - startTime;
+    }
+
+    quint64 startTime = usecTimestampNow();
+    const int NUM_UPDATES = 1000;
+    for (int i = 0; i < NUM_UPDATES; ++i) {
+        entity.moveShapes(glm::vec3(0.01f, 0.0f, 0.0f));
+        entity.updateShapeTree();
+    }
+    quint64 updateUsecs = usecTimestampNow() - startTime;
+
+    std::cout << NUM_QUERIES << " queries of " << NUM_SKELETON_SHAPES << " shapes: spheres in " << sphereUsecs[0]
+        << " usec scanning, " << sphereUsecs[1] << " usec with the tree; rays in " << rayUsecs[0] << " usec scanning, "
+        << rayUsecs[1] << " usec with the tree; " << ((float)updateUsecs / NUM_UPDATES) << " usec per tree update"
+        << std::endl;
+}
+
+void PhysicsEntityTests::runAllTests() {
+    ShapeCollider::initDispatchTable();
+
+    shapeTreeFindsWhatScanFinds();
+    shapeTreeFindsMoreShapesThanFit();
+    shapeTreeFollowsMovedShapes();
+
+    measureShapeQueries();
+}
@@ -0,0 +1,24 @@
+//
+//  PhysicsEntityTests.h
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsEntityTests_h
+#define hifi_PhysicsEntityTests_h
+
+namespace PhysicsEntityTests {
+    void shapeTreeFindsWhatScanFinds();
+    void shapeTreeFollowsMovedShapes();
+    void shapeTreeFindsMoreShapesThanFit();
+
+    void measureShapeQueries();
+
+    void runAllTests();
+}
+
+#endif // hifi_PhysicsEntityTests_h
@@ -0,0 +1,494 @@
+//
+//  PhysicsReplay.cpp
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+
+#include <DistanceConstraint.h>
+#include <PhysicsEntity.h>
+#include <PhysicsSimulation.h>
+#include <Profiler.h>
+#include <Ragdoll.h>
+#include <Shape.h>
+#include <ShapeCollider.h>
+#include <SharedUtil.h>
+#include <StreamUtils.h>
+#include <VerletCapsuleShape.h>
+#include <VerletSphereShape.h>
+
+#include "PhysicsReplay.h"
+#include "PhysicsTestUtil.h"
+
+const quint32 REPLAY_MAGIC = 0x50485250; // "PHRP"
+const quint32 REPLAY_VERSION = 1;
+
+const float DEFAULT_DELTA_TIME = 1.0f / 60.0f;
+const float DEFAULT_MIN_ERROR = 0.00001f;
+const int DEFAULT_MAX_ITERATIONS = 3;
+
+// the most of each thing that a recording may hold, so that a damaged file can't make load() run out of memory
+const int MAX_RECORDED_BODIES = 100000;
+const int MAX_RECORDED_BODY_PARTS = 10000; // points, constraints or shapes of a body
+const int MAX_RECORDED_FRAMES = 1000000;
+
+const int NUM_CHAIN_POINTS = 4;
+const float CHAIN_LINK_LENGTH = 0.15f;
+const float CHAIN_RADIUS = 0.08f;
+
+// a ragdoll whose points and constraints come from a recording, rather than from a skeleton
+class ReplayRagdoll : public Ragdoll {
+public:
+    ReplayRagdoll(int numPoints) {
+        _points.resize(numPoints);
+    }
+
+    void initPoint(int point, const glm::vec3& position, const glm::vec3& lastPosition, float mass) {
+        _points[point]._position = position;
+        _points[point]._lastPosition = lastPosition;
+        _points[point].setMass(mass);
+    }
+
+    virtual void initPoints() { }
+    virtual void buildConstraints() { }
+
+    void addConstraint(int pointA, int pointB, float distance) {
+        DistanceConstraint* constraint = new DistanceConstraint(&(_points[pointA]), &(_points[pointB]));
+        constraint->setDistance(distance);
+        _boneConstraints.push_back(constraint);
+    }
+};
+
+// the shapes of a ReplayRagdoll
+class ReplayEntity : public PhysicsEntity {
+public:
+    ReplayEntity(ReplayRagdoll* ragdoll) : _ragdoll(ragdoll) {
+        setEnableShapes(true);
+    }
+
+    virtual ~ReplayEntity() {
+        clearShapes();
+    }
+
+    virtual void buildShapes() { }
+
+    void addSphere(float radius, int point) {
+        _shapes.push_back(new VerletSphereShape(radius, &(_ragdoll->getPoints()[point])));
+    }
+
+    void addCapsule(float radius, int pointA, int pointB) {
+        QVector<VerletPoint>& points = _ragdoll->getPoints();
+        _shapes.push_back(new VerletCapsuleShape(radius, &(points[pointA]), &(points[pointB])));
+    }
+
+    void finishShapes() {
+        setShapeBackPointers();
+        // neighboring shapes overlap, as they do in a skeleton
+        disableCurrentSelfCollisions();
+    }
+
+private:
+    ReplayRagdoll* _ragdoll;
+};
+
+PhysicsReplay::PhysicsReplay() :
+    _multiBody(true),
+    _deltaTime(DEFAULT_DELTA_TIME),
+    _minError(DEFAULT_MIN_ERROR),
+    _maxIterations(DEFAULT_MAX_ITERATIONS) {
+}
+
+void PhysicsReplay::addRandomBodies(int numBodies, float density, int numFrames) {
+    float side = powf((float)numBodies / density, 1.0f / 3.0f);
+    const float SPEED = 1.0f;
+    int firstBody = _bodies.size();
+    QVector<glm::vec3> positions;
+    QVector<glm::vec3> velocities;
+    for (int i = 0; i < numBodies; ++i) {
+        // a chain of points with a sphere at each end and capsules between
+        RecordedBody body;
+        for (int j = 0; j < NUM_CHAIN_POINTS; ++j) {
+            RecordedPoint point = { glm::vec3((float)j * CHAIN_LINK_LENGTH, 0.0f, 0.0f),
+                glm::vec3((float)j * CHAIN_LINK_LENGTH, 0.0f, 0.0f), 1.0f };
+            body.points.push_back(point);
+            if (j > 0) {
+                RecordedConstraint constraint = { j - 1, j, CHAIN_LINK_LENGTH };
+                body.constraints.push_back(constraint);
+                RecordedShape capsule = { CAPSULE_SHAPE, CHAIN_RADIUS, j - 1, j };
+                body.shapes.push_back(capsule);
+            }
+        }
+        RecordedShape startSphere = { SPHERE_SHAPE, CHAIN_RADIUS, 0, 0 };
+        RecordedShape endSphere = { SPHERE_SHAPE, CHAIN_RADIUS, NUM_CHAIN_POINTS - 1, 0 };
+        body.shapes.push_back(startSphere);
+        body.shapes.push_back(endSphere);
+        _bodies.push_back(body);
+
+        glm::vec3 position = side * glm::vec3(randFloat() - 0.5f, randFloat() - 0.5f, randFloat() - 0.5f);
+        positions.push_back(position);
+        velocities.push_back((glm::length(position) > EPSILON) ? -SPEED * glm::normalize(position) : glm::vec3(0.0f));
+    }
+
+    // the new bodies move in straight lines, and any recorded before them stay where their recordings end
+    if (_frames.size() < numFrames) {
+        BodyTransform still = { glm::vec3(0.0f), glm::quat() };
+        QVector<BodyTransform> lastFrame = _frames.isEmpty() ? QVector<BodyTransform>(firstBody, still) : _frames.last();
+        _frames.resize(numFrames);
+        for (int i = 0; i < numFrames; ++i) {
+            if (_frames[i].isEmpty()) {
+                _frames[i] = lastFrame;
+            }
+        }
+    }
+    for (int i = 0; i < _frames.size(); ++i) {
+        for (int j = 0; j < numBodies; ++j) {
+            BodyTransform transform = { positions[j] + ((float)(i + 1) * _deltaTime) * velocities[j], glm::quat() };
+            _frames[i].push_back(transform);
+        }
+    }
+}
+
+// the main ragdoll first, as replay() expects, then the others
+template<class T> static QVector<T*> getBodies(T* main, const QVector<T*>& others) {
+    QVector<T*> bodies;
+    if (main && !others.contains(main)) {
+        bodies.push_back(main);
+    }
+    bodies += others;
+    return bodies;
+}
+
+bool PhysicsReplay::recordFrame(const PhysicsSimulation& simulation) {
+    QVector<Ragdoll*> ragdolls = getBodies(simulation.getRagdoll(), simulation.getOtherRagdolls());
+    if (_recordedRagdolls.isEmpty()) {
+        _multiBody = simulation.isMultiBody();
+        _bodies.clear();
+        _frames.clear();
+        QVector<PhysicsEntity*> entities = getBodies(simulation.getEntity(), simulation.getOtherEntities());
+        foreach (const Ragdoll* ragdoll, ragdolls) {
+            RecordedBody body;
+            const QVector<VerletPoint>& points = ragdoll->getPoints();
+            QHash<const VerletPoint*, int> pointIndices;
+            for (int i = 0; i < points.size(); ++i) {
+                RecordedPoint point = { points[i]._position, points[i]._lastPosition, points[i].getMass() };
+                body.points.push_back(point);
+                pointIndices.insert(&points[i], i);
+            }
+            foreach (const DistanceConstraint* constraint, ragdoll->getBoneConstraints()) {
+                int pointA = pointIndices.value(constraint->getPoint(0), -1);
+                int pointB = pointIndices.value(constraint->getPoint(1), -1);
+                if (pointA != -1 && pointB != -1) {
+                    RecordedConstraint recordedConstraint = { pointA, pointB, constraint->getDistance() };
+                    body.constraints.push_back(recordedConstraint);
+                }
+            }
+            foreach (const PhysicsEntity* entity, entities) {
+                foreach (Shape* shape, entity->getShapes()) {
+                    if (!shape) {
+                        continue;
+                    }
+                    QVector<VerletPoint*> shapePoints;
+                    shape->getVerletPoints(shapePoints);
+                    if (shape->getType() == SPHERE_SHAPE && shapePoints.size() == 1 &&
+                            pointIndices.contains(shapePoints[0])) {
+                        RecordedShape sphere = { SPHERE_SHAPE, static_cast<SphereShape*>(shape)->getRadius(),
+                            pointIndices.value(shapePoints[0]), 0 };
+                        body.shapes.push_back(sphere);
+
+                    } else if (shape->getType() == CAPSULE_SHAPE && shapePoints.size() == 2 &&
+                            pointIndices.contains(shapePoints[0]) && pointIndices.contains(shapePoints[1])) {
+                        RecordedShape capsule = { CAPSULE_SHAPE, static_cast<CapsuleShape*>(shape)->getRadius(),
+                            pointIndices.value(shapePoints[0]), pointIndices.value(shapePoints[1]) };
+                        body.shapes.push_back(capsule);
+                    }
+                }
+            }
+            _bodies.push_back(body);
+            _recordedRagdolls.push_back(ragdoll);
+        }
+    } else if (ragdolls.size() != _recordedRagdolls.size() ||
+            !std::equal(ragdolls.constBegin(), ragdolls.constEnd(), _recordedRagdolls.constBegin())) {
+        return false;
+    }
+
+    QVector<BodyTransform> frame;
+    foreach (const Ragdoll* ragdoll, ragdolls) {
+        BodyTransform transform = { ragdoll->getTranslation(), ragdoll->getRotation() };
+        frame.push_back(transform);
+    }
+    _frames.push_back(frame);
+    return true;
+}
+
+void PhysicsReplay::save(QDataStream& out) const {
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << REPLAY_MAGIC << REPLAY_VERSION;
+    out << _multiBody << _deltaTime << _minError << (qint32)_maxIterations;
+
+    out << (qint32)_bodies.size();
+    foreach (const RecordedBody& body, _bodies) {
+        out << (qint32)body.points.size();
+        foreach (const RecordedPoint& point, body.points) {
+            out << point.position << point.lastPosition << point.mass;
+        }
+        out << (qint32)body.constraints.size();
+        foreach (const RecordedConstraint& constraint, body.constraints) {
+            out << (qint32)constraint.pointA << (qint32)constraint.pointB << constraint.distance;
+        }
+        out << (qint32)body.shapes.size();
+        foreach (const RecordedShape& shape, body.shapes) {
+            out << shape.type << shape.radius << (qint32)shape.pointA << (qint32)shape.pointB;
+        }
+    }
+
+    out << (qint32)_frames.size();
+    foreach (const QVector<BodyTransform>& frame, _frames) {
+        foreach (const BodyTransform& transform, frame) {
+            out << transform.translation << transform.rotation;
+        }
+    }
+}
+
+// \return true if index is in [0, size)
+static bool isValidIndex(qint32 index, int size) {
+    return index >= 0 && index < size;
+}
+
+// \return true if the count was read and is in [0, maxCount]
+static bool isValidCount(QDataStream& in, qint32 count, int maxCount) {
+    return in.status() == QDataStream::Ok && count >= 0 && count <= maxCount;
+}
+
+bool PhysicsReplay::load(QDataStream& in) {
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 magic, version;
+    in >> magic >> version;
+    if (magic != REPLAY_MAGIC || version != REPLAY_VERSION) {
+        return false;
+    }
+    qint32 maxIterations;
+    in >> _multiBody >> _deltaTime >> _minError >> maxIterations;
+    _maxIterations = maxIterations;
+
+    qint32 numBodies;
+    in >> numBodies;
+    if (!isValidCount(in, numBodies, MAX_RECORDED_BODIES)) {
+        return false;
+    }
+    _bodies.clear();
+    _recordedRagdolls.clear();
+    for (int i = 0; i < numBodies && in.status() == QDataStream::Ok; ++i) {
+        RecordedBody body;
+        qint32 numPoints;
+        in >> numPoints;
+        if (!isValidCount(in, numPoints, MAX_RECORDED_BODY_PARTS)) {
+            return false;
+        }
+        for (int j = 0; j < numPoints && in.status() == QDataStream::Ok; ++j) {
+            RecordedPoint point;
+            in >> point.position >> point.lastPosition >> point.mass;
+            body.points.push_back(point);
+        }
+        qint32 numConstraints;
+        in >> numConstraints;
+        if (!isValidCount(in, numConstraints, MAX_RECORDED_BODY_PARTS)) {
+            return false;
+        }
+        for (int j = 0; j < numConstraints && in.status() == QDataStream::Ok; ++j) {
+            qint32 pointA, pointB;
+            RecordedConstraint constraint;
+            in >> pointA >> pointB >> constraint.distance;
+            if (!(isValidIndex(pointA, numPoints) && isValidIndex(pointB, numPoints))) {
+                return false;
+            }
+            constraint.pointA = pointA;
+            constraint.pointB = pointB;
+            body.constraints.push_back(constraint);
+        }
+        qint32 numShapes;
+        in >> numShapes;
+        if (!isValidCount(in, numShapes, MAX_RECORDED_BODY_PARTS)) {
+            return false;
+        }
+        for (int j = 0; j < numShapes && in.status() == QDataStream::Ok; ++j) {
+            qint32 pointA, pointB;
+            RecordedShape shape;
+            in >> shape.type >> shape.radius >> pointA >> pointB;
+            if (!((shape.type == SPHERE_SHAPE || shape.type == CAPSULE_SHAPE) && isValidIndex(pointA, numPoints) &&
+                    (shape.type == SPHERE_SHAPE || isValidIndex(pointB, numPoints)))) {
+                return false;
+            }
+            shape.pointA = pointA;
+            shape.pointB = pointB;
+            body.shapes.push_back(shape);
+        }
+        _bodies.push_back(body);
+    }
+
+    qint32 numFrames;
+    in >> numFrames;
+    if (!isValidCount(in, numFrames, MAX_RECORDED_FRAMES)) {
+        return false;
+    }
+    _frames.clear();
+    for (int i = 0; i < numFrames && in.status() == QDataStream::Ok; ++i) {
+        QVector<BodyTransform> frame(numBodies);
+        for (int j = 0; j < numBodies; ++j) {
+            in >> frame[j].translation >> frame[j].rotation;
+        }
+        _frames.push_back(frame);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool PhysicsReplay::saveFile(const QString& filename) const {
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&file);
+    save(out);
+    return out.status() == QDataStream::Ok;
+}
+
+bool PhysicsReplay::loadFile(const QString& filename) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    return load(in);
+}
+
+void PhysicsReplay::replay(int maxThreads, Results& results) const {
+    PhysicsSimulation simulation;
+    simulation.setMultiBody(_multiBody);
+    simulation.setMaxThreads(maxThreads);
+
+    QVector<ReplayRagdoll*> ragdolls;
+    QVector<ReplayEntity*> entities;
+    foreach (const RecordedBody& body, _bodies) {
+        // the shapes and constraints point into the ragdoll's points, which don't move after this
+        ReplayRagdoll* ragdoll = new ReplayRagdoll(body.points.size());
+        for (int i = 0; i < body.points.size(); ++i) {
+            const RecordedPoint& point = body.points[i];
+            ragdoll->initPoint(i, point.position, point.lastPosition, point.mass);
+        }
+        foreach (const RecordedConstraint& constraint, body.constraints) {
+            ragdoll->addConstraint(constraint.pointA, constraint.pointB, constraint.distance);
+        }
+        ReplayEntity* entity = new ReplayEntity(ragdoll);
+        foreach (const RecordedShape& shape, body.shapes) {
+            if (shape.type == SPHERE_SHAPE) {
+                entity->addSphere(shape.radius, shape.pointA);
+            } else {
+                entity->addCapsule(shape.radius, shape.pointA, shape.pointB);
+            }
+        }
+        entity->finishShapes();
+
+        if (!_multiBody && ragdolls.isEmpty()) {
+            simulation.setRagdoll(ragdoll);
+            simulation.setEntity(entity);
+        } else {
+            simulation.addRagdoll(ragdoll);
+            simulation.addEntity(entity);
+        }
+        ragdolls.push_back(ragdoll);
+        entities.push_back(entity);
+    }
+
+    // time only the steps, starting from empty records
+    Profiler::resetRecords();
+    results.usecs = 0;
+    results.numSteps = 0;
+    foreach (const QVector<BodyTransform>& frame, _frames) {
+        for (int i = 0; i < ragdolls.size(); ++i) {
+            ragdolls[i]->setTransform(frame[i].translation, frame[i].rotation);
+        }
+        quint64 startTime = usecTimestampNow();
+        simulation.stepForward(_deltaTime, _minError, _maxIterations, NO_STEP_TIME_LIMIT);
+        results.usecs += usecTimestampNow() - startTime;
+        ++results.numSteps;
+        Profiler::tallyRecords();
+
+        // the owners of recorded bodies don't follow them, so their movement is dropped
+        for (int i = 0; i < ragdolls.size(); ++i) {
+            ragdolls[i]->getAndClearAccumulatedMovement();
+        }
+    }
+
+    results.phaseUsecs.clear();
+    const QMap<QString, PerformanceTimerRecord>& records = Profiler::getRecords();
+    for (QMap<QString, PerformanceTimerRecord>::const_iterator it = records.constBegin(); it != records.constEnd(); ++it) {
+        results.phaseUsecs.insert(it.key(), it.value().getAverage());
+    }
+
+    results.hash = INITIAL_POINT_HASH;
+    foreach (ReplayRagdoll* ragdoll, ragdolls) {
+        results.hash = hashPoints(ragdoll->getPoints(), results.hash);
+    }
+
+    simulation.setEntity(NULL);
+    simulation.setRagdoll(NULL);
+    for (int i = 0; i < ragdolls.size(); ++i) {
+        delete entities[i];
+        delete ragdolls[i];
+    }
+}
+
+int PhysicsReplay::runCommand(int argc, char** argv) {
+    ShapeCollider::initDispatchTable();
+
+    if (argc >= 2 && strcmp(argv[0], "--record") == 0) {
+        const float DENSITY = 20.0f; // bodies per cubic meter
+        int numBodies = (argc >= 3) ? atoi(argv[2]) : 500;
+        int numFrames = (argc >= 4) ? atoi(argv[3]) : 60;
+        PhysicsReplay replay;
+        replay.setMultiBody(!(argc >= 5 && strcmp(argv[4], "single") == 0));
+        replay.addRandomBodies(numBodies, DENSITY, numFrames);
+        if (!replay.saveFile(argv[1])) {
+            std::cout << "couldn't write " << argv[1] << std::endl;
+            return 1;
+        }
+        std::cout << "recorded " << numBodies << " bodies over " << numFrames << " frames in " << argv[1] << std::endl;
+        return 0;
+    }
+
+    if (argc >= 2 && strcmp(argv[0], "--replay") == 0) {
+        PhysicsReplay replay;
+        if (!replay.loadFile(argv[1])) {
+            std::cout << "couldn't read a recording from " << argv[1] << std::endl;
+            return 1;
+        }
+        int maxThreads = (argc >= 3) ? atoi(argv[2]) : 1;
+        Results results;
+        replay.replay(maxThreads, results);
+
+        std::cout << replay.getBodyCount() << " bodies, " << results.numSteps << " steps on " << maxThreads
+            << " thread(s) in " << results.usecs << " usec" << std::endl;
+        for (QMap<QString, quint64>::const_iterator it = results.phaseUsecs.constBegin();
+                it != results.phaseUsecs.constEnd(); ++it) {
+            std::cout << "  " << it.key().toLatin1().constData() << ": " << it.value() << " usec per step" << std::endl;
+        }
+        std::cout << "hash: " << std::hex << results.hash << std::dec << std::endl;
+        return 0;
+    }
+
+    std::cout << "usage: physics-tests [--record <file> [bodies] [frames] [multi|single] | --replay <file> [threads]]"
+        << std::endl;
+    return 1;
+}
@@ -0,0 +1,121 @@
+//
+//  PhysicsReplay.h
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  A recording of ragdolls, their shapes, and where their owners put them every frame, which can be stepped through a
+//  PhysicsSimulation without avatars or a clock. Steps are limited by iterations alone, so replaying a recording on the
+//  same build always ends in the same state, and the hash of that state shows whether a change to the physics changed
+//  its results. Recordings are saved with QDataStream, so they can be kept in files and replayed by physics-tests.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsReplay_h
+#define hifi_PhysicsReplay_h
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class PhysicsSimulation;
+class QDataStream;
+class Ragdoll;
+
+class PhysicsReplay {
+public:
+    PhysicsReplay();
+
+    /// Records chains of spheres and capsules scattered through a cube, all moving toward its center.
+    void addRandomBodies(int numBodies, float density, int numFrames);
+
+    /// \param multiBody whether all bodies are peers, rather than the first being the main one
+    void setMultiBody(bool multiBody) { _multiBody = multiBody; }
+
+    /// Records a frame of a live simulation, after its owners have put its ragdolls where they are this frame and before
+    /// it steps. The first frame also records the points and bone constraints of every ragdoll, with the sphere and capsule
+    /// shapes of the simulation's entities that are on the ragdoll's points. Other shapes aren't recorded.
+    /// \return false if the simulation's ragdolls aren't the ones of the first frame
+    bool recordFrame(const PhysicsSimulation& simulation);
+
+    int getBodyCount() const { return _bodies.size(); }
+    int getFrameCount() const { return _frames.size(); }
+
+    void save(QDataStream& out) const;
+
+    /// \return false if the stream doesn't hold a recording of this version
+    bool load(QDataStream& in);
+
+    bool saveFile(const QString& filename) const;
+    bool loadFile(const QString& filename);
+
+    /// The results of replaying a recording.
+    class Results {
+    public:
+        quint64 hash; // of the final positions of every point, as hashPoints() computes
+        quint64 usecs; // for all the steps
+        int numSteps;
+        QMap<QString, quint64> phaseUsecs; // the average usecs per step of each zone that the Profiler timed
+    };
+
+    /// Steps a new simulation of the recording through every frame.
+    /// \param maxThreads the most threads a multi-body simulation may step islands on, or 0 for the global thread pool
+    void replay(int maxThreads, Results& results) const;
+
+    /// Runs physics-tests as the harness, with the arguments after the program name:
+    ///   --record <file> [bodies] [frames] [multi|single]   records random bodies
+    ///   --replay <file> [threads]                           replays a recording and prints its timings and hash
+    /// \return the exit code
+    static int runCommand(int argc, char** argv);
+
+private:
+    class RecordedPoint {
+    public:
+        glm::vec3 position;
+        glm::vec3 lastPosition;
+        float mass;
+    };
+
+    class RecordedConstraint {
+    public:
+        int pointA;
+        int pointB;
+        float distance;
+    };
+
+    class RecordedShape {
+    public:
+        quint8 type; // SPHERE_SHAPE or CAPSULE_SHAPE
+        float radius;
+        int pointA;
+        int pointB; // for capsules
+    };
+
+    class RecordedBody {
+    public:
+        QVector<RecordedPoint> points;
+        QVector<RecordedConstraint> constraints;
+        QVector<RecordedShape> shapes;
+    };
+
+    class BodyTransform {
+    public:
+        glm::vec3 translation;
+        glm::quat rotation;
+    };
+
+    bool _multiBody;
+    float _deltaTime;
+    float _minError;
+    int _maxIterations;
+    QVector<RecordedBody> _bodies;
+    QVector<QVector<BodyTransform> > _frames; // the transform of every body in every frame
+    QVector<const Ragdoll*> _recordedRagdolls; // by recordFrame(), which are never saved
+};
+
+#endif // hifi_PhysicsReplay_h
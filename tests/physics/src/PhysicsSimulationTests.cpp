@@ -0,0 +1,503 @@
+//
+//  PhysicsSimulationTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <QBuffer>
+#include <QDataStream>
+
+#include <glm/glm.hpp>
+
+#include <DistanceConstraint.h>
+#include <PhysicsEntity.h>
+#include <PhysicsSimulation.h>
+#include <Ragdoll.h>
+#include <ShapeCollider.h>
+#include <SharedUtil.h>
+#include <VerletSphereShape.h>
+
+#include "AllocationCounter.h"
+#include "PhysicsReplay.h"
+#include "PhysicsSimulationTests.h"
+#include "PhysicsTestUtil.h"
+
+const int NUM_CHAIN_POINTS = 3;
+const float CHAIN_LINK_LENGTH = 0.15f;
+const float CHAIN_SPHERE_RADIUS = 0.1f;
+
+const float DELTA_TIME = 1.0f / 60.0f;
+const float MIN_ERROR = 0.00001f;
+const int MAX_ITERATIONS = 3;
+
+// a short chain of points held together by distance constraints
+class ChainRagdoll : public Ragdoll {
+public:
+    ChainRagdoll() {
+        initPoints();
+        buildConstraints();
+    }
+
+    virtual void initPoints() {
+        _points.resize(NUM_CHAIN_POINTS);
+        for (int i = 0; i < NUM_CHAIN_POINTS; ++i) {
+            _points[i].initPosition(glm::vec3((float)i * CHAIN_LINK_LENGTH, 0.0f, 0.0f));
+        }
+    }
+
+    virtual void buildConstraints() {
+        for (int i = 1; i < NUM_CHAIN_POINTS; ++i) {
+            _boneConstraints.push_back(new DistanceConstraint(&(_points[i - 1]), &(_points[i])));
+        }
+    }
+};
+
+// a sphere around each point of a ChainRagdoll
+class ChainEntity : public PhysicsEntity {
+public:
+    ChainEntity(ChainRagdoll* ragdoll) : _ragdoll(ragdoll) {
+        setEnableShapes(true);
+        disableCurrentSelfCollisions();
+    }
+
+    virtual ~ChainEntity() {
+        clearShapes();
+    }
+
+    virtual void buildShapes() {
+        QVector<VerletPoint>& points = _ragdoll->getPoints();
+        for (int i = 0; i < points.size(); ++i) {
+            _shapes.push_back(new VerletSphereShape(CHAIN_SPHERE_RADIUS, &(points[i])));
+        }
+        setShapeBackPointers();
+    }
+
+private:
+    ChainRagdoll* _ragdoll;
+};
+
+// a sphere on each of two points, which can belong to different ragdolls
+class BridgeEntity : public PhysicsEntity {
+public:
+    BridgeEntity(VerletPoint* pointA, VerletPoint* pointB) : _pointA(pointA), _pointB(pointB) {
+        setEnableShapes(true);
+        disableCurrentSelfCollisions();
+    }
+
+    virtual ~BridgeEntity() {
+        clearShapes();
+    }
+
+    virtual void buildShapes() {
+        _shapes.push_back(new VerletSphereShape(CHAIN_SPHERE_RADIUS, _pointA));
+        _shapes.push_back(new VerletSphereShape(CHAIN_SPHERE_RADIUS, _pointB));
+        setShapeBackPointers();
+    }
+
+private:
+    VerletPoint* _pointA;
+    VerletPoint* _pointB;
+};
+
+// chains that move in a straight line until they are pushed, as their owners would move them
+class ChainScene {
+public:
+    /// \param multiBody whether all chains are peers, rather than the first being the main one
+    ChainScene(bool multiBody = true) {
+        _simulation.setMultiBody(multiBody);
+    }
+
+    ~ChainScene() {
+        _simulation.setEntity(NULL);
+        _simulation.setRagdoll(NULL);
+        for (size_t i = 0; i < _entities.size(); ++i) {
+            delete _entities[i];
+            delete _ragdolls[i];
+        }
+    }
+
+    PhysicsSimulation& getSimulation() { return _simulation; }
+
+    int addChain(const glm::vec3& position, const glm::vec3& velocity) {
+        ChainRagdoll* ragdoll = new ChainRagdoll();
+        ChainEntity* entity = new ChainEntity(ragdoll);
+        if (!_simulation.isMultiBody() && _ragdolls.empty()) {
+            _simulation.setRagdoll(ragdoll);
+            _simulation.setEntity(entity);
+        } else {
+            _simulation.addRagdoll(ragdoll);
+            _simulation.addEntity(entity);
+        }
+        _ragdolls.push_back(ragdoll);
+        _entities.push_back(entity);
+        _positions.push_back(position);
+        _velocities.push_back(velocity);
+        return _ragdolls.size() - 1;
+    }
+
+    // scatters chains through a cube, all moving toward its center
+    void addRandomChains(int numChains, float density) {
+        float side = powf((float)numChains / density, 1.0f / 3.0f);
+        const float SPEED = 1.0f;
+        for (int i = 0; i < numChains; ++i) {
+            glm::vec3 position = side * glm::vec3(randFloat() - 0.5f, randFloat() - 0.5f, randFloat() - 0.5f);
+            glm::vec3 velocity(0.0f);
+            if (glm::length(position) > EPSILON) {
+                velocity = -SPEED * glm::normalize(position);
+            }
+            addChain(position, velocity);
+        }
+    }
+
+    /// \param recording if not NULL, records every frame before it's stepped
+    void stepForward(int numSteps, PhysicsReplay* recording = NULL) {
+        for (int step = 0; step < numSteps; ++step) {
+            int numChains = _ragdolls.size();
+            for (int i = 0; i < numChains; ++i) {
+                _positions[i] += DELTA_TIME * _velocities[i];
+                _ragdolls[i]->setTransform(_positions[i], glm::quat());
+            }
+            if (recording && !recording->recordFrame(_simulation)) {
+                std::cout << __FILE__ << ":" << __LINE__ << " ERROR: couldn't record a frame" << std::endl;
+            }
+            _simulation.stepForward(DELTA_TIME, MIN_ERROR, MAX_ITERATIONS, NO_STEP_TIME_LIMIT);
+            for (int i = 0; i < numChains; ++i) {
+                _positions[i] += _ragdolls[i]->getAndClearAccumulatedMovement();
+            }
+        }
+    }
+
+    const glm::vec3& getPosition(int chain) const { return _positions[chain]; }
+
+    quint64 getPointHash() const {
+        quint64 hash = INITIAL_POINT_HASH;
+        for (size_t i = 0; i < _ragdolls.size(); ++i) {
+            hash = hashPoints(_ragdolls[i]->getPoints(), hash);
+        }
+        return hash;
+    }
+
+    void getPointPositions(std::vector<glm::vec3>& positions) const {
+        positions.clear();
+        for (size_t i = 0; i < _ragdolls.size(); ++i) {
+            const QVector<VerletPoint>& points = _ragdolls[i]->getPoints();
+            for (int j = 0; j < points.size(); ++j) {
+                positions.push_back(points[j]._position);
+            }
+        }
+    }
+
+private:
+    PhysicsSimulation _simulation;
+    std::vector<ChainRagdoll*> _ragdolls;
+    std::vector<ChainEntity*> _entities;
+    std::vector<glm::vec3> _positions;
+    std::vector<glm::vec3> _velocities;
+};
+
+void PhysicsSimulationTests::separateBodiesAreSeparateIslands() {
+    ChainScene scene;
+    scene.addChain(glm::vec3(0.0f), glm::vec3(0.0f));
+    scene.addChain(glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(0.0f));
+    scene.stepForward(1);
+
+    PhysicsSimulation& simulation = scene.getSimulation();
+    if (simulation.getIslandCount() != 2) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected 2 islands but found "
+            << simulation.getIslandCount() << std::endl;
+    }
+    if (scene.getPosition(0) != glm::vec3(0.0f) || scene.getPosition(1) != glm::vec3(10.0f, 0.0f, 0.0f)) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: chains that don't touch should not move" << std::endl;
+    }
+}
+
+void PhysicsSimulationTests::touchingBodiesPushApart() {
+    // two parallel chains, with spheres that overlap by half their radius
+    ChainScene scene;
+    float offset = 1.5f * CHAIN_SPHERE_RADIUS;
+    scene.addChain(glm::vec3(0.0f), glm::vec3(0.0f));
+    scene.addChain(glm::vec3(0.0f, offset, 0.0f), glm::vec3(0.0f));
+    scene.stepForward(1);
+
+    PhysicsSimulation& simulation = scene.getSimulation();
+    if (simulation.getIslandCount() != 1) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected 1 island but found "
+            << simulation.getIslandCount() << std::endl;
+    }
+    if (simulation.getPairCount() < NUM_CHAIN_POINTS) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected at least " << NUM_CHAIN_POINTS
+            << " pairs but found " << simulation.getPairCount() << std::endl;
+    }
+    if (scene.getPosition(0).y >= 0.0f || scene.getPosition(1).y <= offset) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: touching chains should push each other apart:"
+            << " y0 = " << scene.getPosition(0).y << " y1 = " << scene.getPosition(1).y << std::endl;
+    }
+}
+
+void PhysicsSimulationTests::sharedPointsJoinIslands() {
+    // The bridge's first sphere is on a ragdoll that isn't in the simulation and touches the chain, and its second is on
+    // a ragdoll of the simulation that is far away and has no entity of its own. Only the shared point joins the far
+    // ragdoll to the others, which then have to be stepped together.
+    ChainRagdoll outsideRagdoll;
+    ChainRagdoll farRagdoll;
+    farRagdoll.setTransform(glm::vec3(10.0f, 0.0f, 0.0f), glm::quat());
+    BridgeEntity bridge(&(outsideRagdoll.getPoints()[0]), &(farRagdoll.getPoints()[0]));
+
+    ChainScene scene;
+    scene.addChain(glm::vec3(0.0f, 1.5f * CHAIN_SPHERE_RADIUS, 0.0f), glm::vec3(0.0f));
+    PhysicsSimulation& simulation = scene.getSimulation();
+    simulation.addRagdoll(&farRagdoll);
+    scene.stepForward(1);
+    if (simulation.getIslandCount() != 2) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected 2 islands before the bridge but found "
+            << simulation.getIslandCount() << std::endl;
+    }
+
+    simulation.addEntity(&bridge);
+    scene.stepForward(1);
+    if (simulation.getIslandCount() != 1) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected the bridge to make 1 island but found "
+            << simulation.getIslandCount() << std::endl;
+    }
+    simulation.removeEntity(&bridge);
+    simulation.removeRagdoll(&farRagdoll);
+}
+
+void PhysicsSimulationTests::parallelStepMatchesSerialStep() {
+    // islands share nothing that moves, so the threads that step them can't change the results
+    const int NUM_CHAINS = 500;
+    const float DENSITY = 20.0f; // chains per cubic meter
+    const int NUM_STEPS = 20;
+    const unsigned int SEED = 1234;
+    const int NUM_PARALLEL_THREADS = 4;
+
+    std::vector<glm::vec3> serialPositions;
+    {
+        srand(SEED);
+        ChainScene scene;
+        scene.addRandomChains(NUM_CHAINS, DENSITY);
+        scene.getSimulation().setMaxThreads(1);
+        scene.stepForward(NUM_STEPS);
+        scene.getPointPositions(serialPositions);
+    }
+    std::vector<glm::vec3> parallelPositions;
+    {
+        srand(SEED);
+        ChainScene scene;
+        scene.addRandomChains(NUM_CHAINS, DENSITY);
+        scene.getSimulation().setMaxThreads(NUM_PARALLEL_THREADS);
+        scene.stepForward(NUM_STEPS);
+        scene.getPointPositions(parallelPositions);
+    }
+
+    if (serialPositions.size() != parallelPositions.size()) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: scenes have different numbers of points" << std::endl;
+        return;
+    }
+    for (size_t i = 0; i < serialPositions.size(); ++i) {
+        if (serialPositions[i] != parallelPositions[i]) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: point " << i
+                << " differs between the serial and parallel steps" << std::endl;
+            return;
+        }
+    }
+}
+
+void PhysicsSimulationTests::stepDoesNotAllocate() {
+    // once the contacts of a scene have come and gone, a step reuses the memory of the steps before it
+    const int NUM_WARMUP_STEPS = 10;
+    const int NUM_COUNTED_STEPS = 10;
+    for (int i = 0; i < 2; ++i) {
+        bool multiBody = (i == 1);
+        ChainScene scene(multiBody);
+        float offset = 1.5f * CHAIN_SPHERE_RADIUS;
+        scene.addChain(glm::vec3(0.0f), glm::vec3(0.0f));
+        scene.addChain(glm::vec3(0.0f, offset, 0.0f), glm::vec3(0.0f));
+        scene.addChain(glm::vec3(0.0f, -offset, 0.0f), glm::vec3(0.0f));
+        // the thread pool allocates to start its threads
+        scene.getSimulation().setMaxThreads(1);
+        scene.stepForward(NUM_WARMUP_STEPS);
+
+        AllocationCounter::start();
+        scene.stepForward(NUM_COUNTED_STEPS);
+        int numAllocations = AllocationCounter::stop();
+        if (numAllocations != 0) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: " << (multiBody ? "multi" : "single")
+                << "-body steps made " << numAllocations << " allocations" << std::endl;
+        }
+    }
+}
+
+void PhysicsSimulationTests::replayIsRepeatable() {
+    // a recording that is saved and loaded again replays to the same state, on any number of threads
+    const int NUM_BODIES = 200;
+    const float DENSITY = 20.0f; // bodies per cubic meter
+    const int NUM_FRAMES = 20;
+    const int NUM_PARALLEL_THREADS = 4;
+    for (int i = 0; i < 2; ++i) {
+        bool multiBody = (i == 1);
+        srand(NUM_BODIES);
+        PhysicsReplay recording;
+        recording.setMultiBody(multiBody);
+        recording.addRandomBodies(NUM_BODIES, DENSITY, NUM_FRAMES);
+
+        QByteArray bytes;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        QDataStream out(&buffer);
+        recording.save(out);
+        buffer.close();
+
+        PhysicsReplay loaded;
+        buffer.open(QIODevice::ReadOnly);
+        QDataStream in(&buffer);
+        if (!loaded.load(in)) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: couldn't load a saved recording" << std::endl;
+            continue;
+        }
+        if (loaded.getBodyCount() != NUM_BODIES || loaded.getFrameCount() != NUM_FRAMES) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << NUM_BODIES << " bodies and "
+                << NUM_FRAMES << " frames but loaded " << loaded.getBodyCount() << " and "
+                << loaded.getFrameCount() << std::endl;
+            continue;
+        }
+
+        PhysicsReplay::Results recordedResults;
+        recording.replay(1, recordedResults);
+        PhysicsReplay::Results loadedResults;
+        loaded.replay(1, loadedResults);
+        if (loadedResults.hash != recordedResults.hash || loadedResults.numSteps != NUM_FRAMES) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: " << (multiBody ? "multi" : "single")
+                << "-body replay of a loaded recording differs from the original" << std::endl;
+        }
+        if (multiBody) {
+            PhysicsReplay::Results parallelResults;
+            loaded.replay(NUM_PARALLEL_THREADS, parallelResults);
+            if (parallelResults.hash != recordedResults.hash) {
+                std::cout << __FILE__ << ":" << __LINE__
+                    << " ERROR: parallel replay differs from serial replay" << std::endl;
+            }
+        }
+    }
+}
+
+void PhysicsSimulationTests::recordedSceneReplaysLikeLive() {
+    // a live scene that is recorded as it runs replays to the state it ended in
+    const int NUM_CHAINS = 50;
+    const float DENSITY = 20.0f; // chains per cubic meter
+    const int NUM_STEPS = 20;
+    for (int i = 0; i < 2; ++i) {
+        bool multiBody = (i == 1);
+        srand(NUM_CHAINS);
+        ChainScene scene(multiBody);
+        scene.addRandomChains(NUM_CHAINS, DENSITY);
+        PhysicsReplay recording;
+        scene.stepForward(NUM_STEPS, &recording);
+
+        if (recording.getBodyCount() != NUM_CHAINS || recording.getFrameCount() != NUM_STEPS) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << NUM_CHAINS << " bodies and " << NUM_STEPS
+                << " frames but recorded " << recording.getBodyCount() << " and " << recording.getFrameCount() << std::endl;
+            continue;
+        }
+        PhysicsReplay::Results results;
+        recording.replay(1, results);
+        if (results.hash != scene.getPointHash()) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: " << (multiBody ? "multi" : "single")
+                << "-body replay of a live scene differs from the scene" << std::endl;
+        }
+    }
+}
+
+void PhysicsSimulationTests::loadRejectsBadCounts() {
+    // a recording whose counts are out of range is rejected before anything is allocated for them
+    const quint32 REPLAY_MAGIC = 0x50485250;
+    const quint32 REPLAY_VERSION = 1;
+    const qint32 BAD_COUNTS[] = { -1, 0x7fffffff };
+    for (int i = 0; i < 2; ++i) {
+        QByteArray bytes;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        QDataStream out(&buffer);
+        out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        out << REPLAY_MAGIC << REPLAY_VERSION << true << DELTA_TIME << MIN_ERROR << (qint32)MAX_ITERATIONS << BAD_COUNTS[i];
+        buffer.close();
+
+        PhysicsReplay loaded;
+        buffer.open(QIODevice::ReadOnly);
+        QDataStream in(&buffer);
+        if (loaded.load(in)) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: loaded a recording of " << BAD_COUNTS[i] << " bodies"
+                << std::endl;
+        }
+    }
+}
+
+void PhysicsSimulationTests::measureMultiBodyScaling() {
+    const float DENSITY = 20.0f; // chains per cubic meter
+    const int NUM_STEPS = 30;
+    const int MAX_CHAINS = 4096;
+    for (int numChains = 64; numChains <= MAX_CHAINS; numChains *= 4) {
+        // 1 thread, then as many as the global thread pool has
+        quint64 usecsPerStep[2];
+        int numIslands = 0;
+        int numPairs = 0;
+        for (int i = 0; i < 2; ++i) {
+            srand(numChains);
+            ChainScene scene;
+            scene.addRandomChains(numChains, DENSITY);
+            scene.getSimulation().setMaxThreads(i == 0 ? 1 : 0);
+
+            quint64 startTime = usecTimestampNow();
+            scene.stepForward(NUM_STEPS);
+            usecsPerStep[i] = (usecTimestampNow() - startTime) / NUM_STEPS;
+            numIslands = scene.getSimulation().getIslandCount();
+            numPairs = scene.getSimulation().getPairCount();
+        }
+        std::cout << numChains << " chains: " << usecsPerStep[0] << " usec per step on 1 thread, "
+            << usecsPerStep[1] << " usec per step on the thread pool, "
+            << numIslands << " islands, " << numPairs << " pairs" << std::endl;
+    }
+}
+
+void PhysicsSimulationTests::measureReplayPhases() {
+    const int NUM_BODIES = 1000;
+    const float DENSITY = 20.0f; // bodies per cubic meter
+    const int NUM_FRAMES = 30;
+    srand(NUM_BODIES);
+    PhysicsReplay recording;
+    recording.addRandomBodies(NUM_BODIES, DENSITY, NUM_FRAMES);
+
+    PhysicsReplay::Results results;
+    recording.replay(1, results);
+    std::cout << NUM_BODIES << " replayed bodies: " << (results.usecs / results.numSteps) << " usec per step, hash "
+        << std::hex << results.hash << std::dec << std::endl;
+    for (QMap<QString, quint64>::const_iterator it = results.phaseUsecs.constBegin();
+            it != results.phaseUsecs.constEnd(); ++it) {
+        std::cout << "  " << it.key().toLatin1().constData() << ": " << it.value() << " usec per step" << std::endl;
+    }
+}
+
+void PhysicsSimulationTests::runAllTests() {
+    ShapeCollider::initDispatchTable();
+
+    separateBodiesAreSeparateIslands();
+    touchingBodiesPushApart();
+    sharedPointsJoinIslands();
+    parallelStepMatchesSerialStep();
+    stepDoesNotAllocate();
+    replayIsRepeatable();
+    recordedSceneReplaysLikeLive();
+    loadRejectsBadCounts();
+
+    measureMultiBodyScaling();
+    measureReplayPhases();
+}
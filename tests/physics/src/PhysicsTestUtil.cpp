@@ -20,3 +20,21 @@ std::ostream& operator<<(std::ostream& s, const CollisionInfo& c) {
         << ", addedVelocity=" << c._addedVelocity;
     return s;
 }
+
+// 64-bit FNV-1a
+static quint64 hashBytes(const void* bytes, int numBytes, quint64 hash) {
+    const quint64 FNV_PRIME = 1099511628211ULL;
+    const unsigned char* data = static_cast<const unsigned char*>(bytes);
+    for (int i = 0; i < numBytes; ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+quint64 hashPoints(const QVector<VerletPoint>& points, quint64 hash) {
+    for (int i = 0; i < points.size(); ++i) {
+        hash = hashBytes(glm::value_ptr(points[i]._position), sizeof(glm::vec3), hash);
+        hash = hashBytes(glm::value_ptr(points[i]._lastPosition), sizeof(glm::vec3), hash);
+    }
+    return hash;
+}
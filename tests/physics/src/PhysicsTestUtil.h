@@ -15,7 +15,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <QVector>
+
 #include <CollisionInfo.h>
+#include <VerletPoint.h>
 
 const glm::vec3 xAxis(1.f, 0.f, 0.f);
 const glm::vec3 yAxis(0.f, 1.f, 0.f);
@@ -23,4 +26,10 @@ const glm::vec3 zAxis(0.f, 0.f, 1.f);
 
 std::ostream& operator<<(std::ostream& s, const CollisionInfo& c);
 
+const quint64 INITIAL_POINT_HASH = 14695981039346656037ULL;
+
+/// Adds the bits of the current and last positions of points to a hash, so that two runs that end with the same hash
+/// ended with every point in exactly the same place.
+quint64 hashPoints(const QVector<VerletPoint>& points, quint64 hash = INITIAL_POINT_HASH);
+
 #endif // hifi_PhysicsTestUtil_h
@@ -0,0 +1,186 @@
+//
+//  RagdollTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <glm/glm.hpp>
+
+#include <ColoredConstraintSolver.h>
+#include <DistanceConstraint.h>
+#include <Ragdoll.h>
+#include <SharedUtil.h>
+
+#include "RagdollTests.h"
+
+const float GRID_SPACING = 0.1f;
+
+// a square grid of points, each held to its neighbors by distance constraints, like a cloth
+class GridRagdoll : public Ragdoll {
+public:
+    GridRagdoll(int side) : _side(side) {
+        initPoints();
+        buildConstraints();
+    }
+
+    virtual void initPoints() {
+        _points.resize(_side * _side);
+        for (int i = 0; i < _side; ++i) {
+            for (int j = 0; j < _side; ++j) {
+                _points[i * _side + j].initPosition(GRID_SPACING * glm::vec3((float)i, (float)j, 0.0f));
+            }
+        }
+    }
+
+    virtual void buildConstraints() {
+        for (int i = 0; i < _side; ++i) {
+            for (int j = 0; j < _side; ++j) {
+                if (j + 1 < _side) {
+                    addConstraint(i * _side + j, i * _side + j + 1);
+                }
+                if (i + 1 < _side) {
+                    addConstraint(i * _side + j, (i + 1) * _side + j);
+                }
+            }
+        }
+    }
+
+    void addConstraint(int start, int end) {
+        _boneConstraints.push_back(new DistanceConstraint(&(_points[start]), &(_points[end])));
+    }
+
+    const QVector<DistanceConstraint*>& getConstraints() const { return _boneConstraints; }
+
+    /// moves every point a random distance of up to a quarter of the spacing along each axis
+    void shake() {
+        const float MAX_SHAKE = 0.25f * GRID_SPACING;
+        for (int i = 0; i < _points.size(); ++i) {
+            _points[i]._position += MAX_SHAKE * glm::vec3(randFloatInRange(-1.0f, 1.0f),
+                randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+        }
+    }
+
+private:
+    int _side;
+};
+
+void RagdollTests::coloredSolverColorsConstraints() {
+    // the points of a grid have at most four neighbors, and alternating constraints along each row and column share
+    // no points, so four colors are enough
+    GridRagdoll grid(8);
+    ColoredConstraintSolver solver;
+    if (!solver.build(grid.getPoints(), grid.getConstraints())) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: failed to color the constraints of a grid" << std::endl;
+        return;
+    }
+    if (solver.getConstraintCount() != grid.getConstraints().size()) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << grid.getConstraints().size()
+            << " constraints but found " << solver.getConstraintCount() << std::endl;
+    }
+    if (solver.getColorCount() != 4) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected 4 colors but found "
+            << solver.getColorCount() << std::endl;
+    }
+    if (!solver.isBuiltFor(grid.getPoints(), grid.getConstraints().size())) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: solver should be built for the grid" << std::endl;
+    }
+}
+
+void RagdollTests::coloredSolverRejectsForeignPoints() {
+    GridRagdoll grid(2);
+    GridRagdoll otherGrid(2);
+    QVector<DistanceConstraint*> constraints;
+    DistanceConstraint constraint(&(grid.getPoints()[0]), &(otherGrid.getPoints()[1]));
+    constraints.push_back(&constraint);
+
+    ColoredConstraintSolver solver;
+    if (solver.build(grid.getPoints(), constraints) || solver.isValid()) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: constraints to points of another ragdoll can't be colored"
+            << std::endl;
+    }
+}
+
+// shakes two identical grids, then enforces the constraints of one with each solver until they're both relaxed
+static void compareSolvers(int side, int numIterations, float* serialErrors, float* coloredErrors,
+        quint64& serialUsecs, quint64& coloredUsecs) {
+    const unsigned int SEED = 4321;
+    srand(SEED);
+    GridRagdoll serialGrid(side);
+    serialGrid.shake();
+    srand(SEED);
+    GridRagdoll coloredGrid(side);
+    coloredGrid.shake();
+    coloredGrid.setUseColoredSolver(true);
+    coloredGrid.enforceConstraints(); // the first enforcement builds the solver, which isn't timed
+    serialGrid.enforceConstraints();
+
+    quint64 startTime = usecTimestampNow();
+    for (int i = 0; i < numIterations; ++i) {
+        serialErrors[i] = serialGrid.enforceConstraints();
+    }
+    serialUsecs = usecTimestampNow() - startTime;
+
+    startTime = usecTimestampNow();
+    for (int i = 0; i < numIterations; ++i) {
+        coloredErrors[i] = coloredGrid.enforceConstraints();
+    }
+    coloredUsecs = usecTimestampNow() - startTime;
+}
+
+void RagdollTests::coloredSolverConverges() {
+    const int SIDE = 16;
+    const int NUM_ITERATIONS = 50;
+    float serialErrors[NUM_ITERATIONS];
+    float coloredErrors[NUM_ITERATIONS];
+    quint64 serialUsecs = 0;
+    quint64 coloredUsecs = 0;
+    compareSolvers(SIDE, NUM_ITERATIONS, serialErrors, coloredErrors, serialUsecs, coloredUsecs);
+
+    // the colored solver relaxes the constraints in another order, so its error isn't the same, but it should be close
+    const float MAX_ERROR_RATIO = 2.0f;
+    float serialError = serialErrors[NUM_ITERATIONS - 1];
+    float coloredError = coloredErrors[NUM_ITERATIONS - 1];
+    if (coloredError > MAX_ERROR_RATIO * serialError + EPSILON) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: colored solver converges too slowly:"
+            << " serial error = " << serialError << " colored error = " << coloredError << std::endl;
+    }
+    if (coloredError >= coloredErrors[0]) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: colored solver doesn't converge:"
+            << " first error = " << coloredErrors[0] << " last error = " << coloredError << std::endl;
+    }
+}
+
+void RagdollTests::measureSolverConvergence() {
+    const int NUM_ITERATIONS = 20;
+    const int MAX_SIDE = 64;
+    float serialErrors[NUM_ITERATIONS];
+    float coloredErrors[NUM_ITERATIONS];
+    for (int side = 8; side <= MAX_SIDE; side *= 2) {
+        quint64 serialUsecs = 0;
+        quint64 coloredUsecs = 0;
+        compareSolvers(side, NUM_ITERATIONS, serialErrors, coloredErrors, serialUsecs, coloredUsecs);
+        std::cout << side << "x" << side << " grid: " << (float)serialUsecs / (float)NUM_ITERATIONS
+            << " usec per serial iteration, " << (float)coloredUsecs / (float)NUM_ITERATIONS
+            << " usec per colored iteration" << std::endl;
+        std::cout << "    error per iteration (serial/colored):";
+        for (int i = 0; i < NUM_ITERATIONS; i += 4) {
+            std::cout << " " << serialErrors[i] << "/" << coloredErrors[i];
+        }
+        std::cout << std::endl;
+    }
+}
+
+void RagdollTests::runAllTests() {
+    coloredSolverColorsConstraints();
+    coloredSolverRejectsForeignPoints();
+    coloredSolverConverges();
+
+    measureSolverConvergence();
+}
@@ -0,0 +1,24 @@
+//
+//  RagdollTests.h
+//  tests/physics/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RagdollTests_h
+#define hifi_RagdollTests_h
+
+namespace RagdollTests {
+    void coloredSolverColorsConstraints();
+    void coloredSolverRejectsForeignPoints();
+    void coloredSolverConverges();
+
+    void measureSolverConvergence();
+
+    void runAllTests();
+}
+
+#endif // hifi_RagdollTests_h
@@ -12,6 +12,8 @@
 //#include <stdio.h>
 #include <iostream>
 #include <math.h>
+#include <stdlib.h>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -20,6 +22,7 @@
 #include <CollisionInfo.h>
 #include <PlaneShape.h>
 #include <ShapeCollider.h>
+#include <ShapePairBatch.h>
 #include <SharedUtil.h>
 #include <SphereShape.h>
 #include <StreamUtils.h>
@@ -1331,6 +1334,162 @@ void ShapeColliderTests::measureTimeOfCollisionDispatch() {
     */
 }
 
+// spheres and capsules scattered through a cube, and a plane, with every pair of them in a batch
+class ShapeScene {
+public:
+    ShapeScene(int numShapes, float side) : _plane(glm::vec4(0.0f, 1.0f, 0.0f, 0.5f * side)) {
+        for (int i = 0; i < numShapes; ++i) {
+            float radius = 0.05f + 0.2f * randFloat();
+            glm::vec3 center = side * glm::vec3(randFloat() - 0.5f, randFloat() - 0.5f, randFloat() - 0.5f);
+            if (i % 2 == 0) {
+                _shapes.push_back(new SphereShape(radius, center));
+            } else {
+                glm::vec3 halfAxis = 0.3f * glm::vec3(randFloat() - 0.5f, randFloat() - 0.5f, randFloat() - 0.5f);
+                _shapes.push_back(new CapsuleShape(radius, center - halfAxis, center + halfAxis));
+            }
+        }
+        _shapes.push_back(&_plane);
+        for (size_t i = 0; i < _shapes.size(); ++i) {
+            for (size_t j = i + 1; j < _shapes.size(); ++j) {
+                // alternate the order of each pair, so that capsules are collided with spheres both ways
+                if (j % 2 == 0) {
+                    _batch.addPair(_shapes[i], _shapes[j]);
+                } else {
+                    _batch.addPair(_shapes[j], _shapes[i]);
+                }
+            }
+        }
+    }
+
+    ~ShapeScene() {
+        _shapes.pop_back();
+        for (size_t i = 0; i < _shapes.size(); ++i) {
+            delete _shapes[i];
+        }
+    }
+
+    ShapePairBatch& getBatch() { return _batch; }
+
+    // collides the pairs of the batch in the same order, one at a time
+    void collidePairs(CollisionList& collisions) {
+        for (size_t i = 0; i < _shapes.size(); ++i) {
+            for (size_t j = i + 1; j < _shapes.size(); ++j) {
+                if (j % 2 == 0) {
+                    ShapeCollider::collideShapes(_shapes[i], _shapes[j], collisions);
+                } else {
+                    ShapeCollider::collideShapes(_shapes[j], _shapes[i], collisions);
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<Shape*> _shapes;
+    PlaneShape _plane;
+    ShapePairBatch _batch;
+};
+
+static bool isNear(const glm::vec3& a, const glm::vec3& b) {
+    return fabsf(a.x - b.x) < EPSILON && fabsf(a.y - b.y) < EPSILON && fabsf(a.z - b.z) < EPSILON;
+}
+
+// the batch does the same math four pairs at a time, where rounding may differ, so the collisions need only be near
+static void compareCollisions(CollisionList& pairCollisions, CollisionList& batchCollisions) {
+    if (batchCollisions.size() != pairCollisions.size()) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: batch found " << batchCollisions.size()
+            << " collisions but pairs found " << pairCollisions.size() << std::endl;
+        return;
+    }
+    for (int j = 0; j < pairCollisions.size(); ++j) {
+        CollisionInfo* pairCollision = pairCollisions.getCollision(j);
+        CollisionInfo* batchCollision = batchCollisions.getCollision(j);
+        if (batchCollision->_shapeA != pairCollision->_shapeA || batchCollision->_shapeB != pairCollision->_shapeB ||
+                !isNear(batchCollision->_penetration, pairCollision->_penetration) ||
+                !isNear(batchCollision->_contactPoint, pairCollision->_contactPoint)) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: collision " << j
+                << " differs between the batch and the pairs" << std::endl;
+            break;
+        }
+    }
+}
+
+void ShapeColliderTests::batchMatchesPairs() {
+    // dense enough that many pairs touch and many don't, and a list too short for all of them
+    const int NUM_SHAPES = 200;
+    const float SIDE = 3.0f;
+    const int MAX_COLLISIONS[] = { 20000, 50 };
+    srand(1234);
+    ShapeScene scene(NUM_SHAPES, SIDE);
+    for (int i = 0; i < 2; ++i) {
+        CollisionList pairCollisions(MAX_COLLISIONS[i]);
+        scene.collidePairs(pairCollisions);
+        CollisionList batchCollisions(MAX_COLLISIONS[i]);
+        scene.getBatch().collide(batchCollisions);
+
+        if (pairCollisions.size() == 0 || pairCollisions.size() == NUM_SHAPES * NUM_SHAPES / 2) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected some pairs to touch and some not, but "
+                << pairCollisions.size() << " touched" << std::endl;
+        }
+        compareCollisions(pairCollisions, batchCollisions);
+    }
+
+    // the special cases that the batch leaves to ShapeCollider: concentric spheres, spheres on the axis of a capsule or
+    // beyond its cap, parallel capsules, and capsules that cross at their centers
+    glm::vec3 center(1.0f, 2.0f, 3.0f);
+    std::vector<Shape*> shapes;
+    shapes.push_back(new SphereShape(0.5f, center));
+    shapes.push_back(new SphereShape(0.3f, center));
+    shapes.push_back(new CapsuleShape(0.2f, center - yAxis, center + yAxis));
+    shapes.push_back(new CapsuleShape(0.2f, center - yAxis + 0.1f * xAxis, center + yAxis + 0.1f * xAxis));
+    shapes.push_back(new CapsuleShape(0.2f, center - xAxis, center + xAxis));
+    shapes.push_back(new SphereShape(0.3f, center + 1.2f * yAxis));
+    shapes.push_back(new SphereShape(0.3f, center - 0.5f * yAxis));
+    ShapePairBatch batch;
+    CollisionList pairCollisions(shapes.size() * shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (size_t j = 0; j < shapes.size(); ++j) {
+            if (i != j) {
+                batch.addPair(shapes[i], shapes[j]);
+                ShapeCollider::collideShapes(shapes[i], shapes[j], pairCollisions);
+            }
+        }
+    }
+    CollisionList batchCollisions(shapes.size() * shapes.size());
+    batch.collide(batchCollisions);
+    compareCollisions(pairCollisions, batchCollisions);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        delete shapes[i];
+    }
+}
+
+void ShapeColliderTests::measureTimeOfBatchCollision() {
+    // sparse enough that few pairs touch, as in a crowd of avatars
+    const int NUM_SHAPES = 400;
+    const float SIDE = 20.0f;
+    const int NUM_TESTS = 20;
+    srand(4321);
+    ShapeScene scene(NUM_SHAPES, SIDE);
+    CollisionList collisions(16 * NUM_SHAPES);
+
+    quint64 startTime = usecTimestampNow();
+    for (int i = 0; i < NUM_TESTS; ++i) {
+        collisions.clear();
+        scene.collidePairs(collisions);
+    }
+    quint64 pairTime = usecTimestampNow() - startTime;
+
+    startTime = usecTimestampNow();
+    for (int i = 0; i < NUM_TESTS; ++i) {
+        collisions.clear();
+        scene.getBatch().collide(collisions);
+    }
+    quint64 batchTime = usecTimestampNow() - startTime;
+
+    std::cout << scene.getBatch().size() << " pairs with " << collisions.size() << " collisions: "
+        << (pairTime / NUM_TESTS) << " usec one pair at a time, " << (batchTime / NUM_TESTS) << " usec in a batch"
+        << std::endl;
+}
+
 void ShapeColliderTests::runAllTests() {
     ShapeCollider::initDispatchTable();
 
@@ -1356,4 +1515,7 @@ void ShapeColliderTests::runAllTests() {
     rayMissesCapsule();
     rayHitsPlane();
     rayMissesPlane();
+
+    batchMatchesPairs();
+    measureTimeOfBatchCollision();
 }
@@ -35,7 +35,10 @@ namespace ShapeColliderTests {
     void rayHitsPlane();
     void rayMissesPlane();
 
+    void batchMatchesPairs();
+
     void measureTimeOfCollisionDispatch();
+    void measureTimeOfBatchCollision();
 
     void runAllTests(); 
 }
@@ -8,11 +8,22 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "PhysicsEntityTests.h"
+#include "PhysicsReplay.h"
+#include "PhysicsSimulationTests.h"
+#include "RagdollTests.h"
 #include "ShapeColliderTests.h"
 #include "VerletShapeTests.h"
 
 int main(int argc, char** argv) {
+    if (argc > 1) {
+        // run as the replay harness rather than the tests
+        return PhysicsReplay::runCommand(argc - 1, argv + 1);
+    }
     ShapeColliderTests::runAllTests();
     VerletShapeTests::runAllTests();
+    PhysicsSimulationTests::runAllTests();
+    RagdollTests::runAllTests();
+    PhysicsEntityTests::runAllTests();
     return 0;
 }
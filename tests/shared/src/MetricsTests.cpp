@@ -0,0 +1,207 @@
+//
+//  MetricsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <iostream>
+#include <math.h>
+
+#include <QtCore/QThread>
+
+#include <Metrics.h>
+#include <SharedUtil.h>
+
+#include "MetricsTests.h"
+
+const int NUM_WORKER_INCREMENTS = 100000;
+
+static MetricCounter workerCounter("metrics-test/workerCounter");
+static MetricHistogram workerHistogram("metrics-test/workerHistogram");
+
+class CountingWorker : public QThread {
+public:
+    virtual void run() {
+        for (int i = 0; i < NUM_WORKER_INCREMENTS; ++i) {
+            workerCounter.increment();
+            workerHistogram.record(i % 100);
+        }
+    }
+};
+
+void MetricsTests::countersAddUpAcrossThreads() {
+    const int NUM_WORKERS = 4;
+    workerCounter.reset();
+    workerHistogram.reset();
+    CountingWorker workers[NUM_WORKERS];
+    for (int i = 0; i < NUM_WORKERS; ++i) {
+        workers[i].start();
+    }
+    // read while the workers are writing, which sums the shards under them
+    workerCounter.getValue();
+    workerHistogram.getSnapshot();
+    for (int i = 0; i < NUM_WORKERS; ++i) {
+        workers[i].wait();
+    }
+
+    if (workerCounter.getValue() != NUM_WORKERS * NUM_WORKER_INCREMENTS) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << NUM_WORKERS * NUM_WORKER_INCREMENTS
+            << " increments but counted " << workerCounter.getValue() << std::endl;
+    }
+    MetricHistogramSnapshot snapshot = workerHistogram.getSnapshot();
+    if (snapshot.getCount() != NUM_WORKERS * NUM_WORKER_INCREMENTS || snapshot.max != 99) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << NUM_WORKERS * NUM_WORKER_INCREMENTS
+            << " values up to 99 but recorded " << snapshot.getCount() << " up to " << snapshot.max << std::endl;
+    }
+}
+
+void MetricsTests::histogramsReportPercentiles() {
+    MetricHistogram histogram("metrics-test/percentiles");
+    const int NUM_VALUES = 1000;
+    for (int i = 1; i <= NUM_VALUES; ++i) {
+        histogram.record(i);
+    }
+    MetricHistogramSnapshot snapshot = histogram.getSnapshot();
+
+    if (snapshot.getCount() != NUM_VALUES || snapshot.getSum() != NUM_VALUES * (NUM_VALUES + 1) / 2) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << NUM_VALUES << " values but recorded "
+            << snapshot.getCount() << " with a sum of " << snapshot.getSum() << std::endl;
+    }
+    // the percentiles are the bounds of the buckets, at 1, 2 and 5 times each power of ten
+    if (snapshot.getPercentile(0.5f) != 500 || snapshot.getPercentile(0.9f) != 1000 ||
+            snapshot.getPercentile(0.99f) != 1000 || snapshot.max != NUM_VALUES) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: wrong percentiles: p50 = " << snapshot.getPercentile(0.5f)
+            << " p90 = " << snapshot.getPercentile(0.9f) << " p99 = " << snapshot.getPercentile(0.99f)
+            << " max = " << snapshot.max << std::endl;
+    }
+    // but the means of the buckets are exact
+    const float EPSILON = 0.001f;
+    if (snapshot.getCount(10, 100) != 90 || fabsf(snapshot.getMean(10, 100) - 55.5f) > EPSILON) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected 90 values in (10, 100] with a mean of 55.5 but found "
+            << snapshot.getCount(10, 100) << " with a mean of " << snapshot.getMean(10, 100) << std::endl;
+    }
+}
+
+void MetricsTests::resetClearsMetrics() {
+    MetricCounter counter("metrics-test/resetCounter");
+    MetricHistogram histogram("metrics-test/resetHistogram");
+    counter.increment(5);
+    histogram.record(5);
+    Metrics::resetAll();
+
+    MetricHistogramSnapshot snapshot = histogram.getSnapshot();
+    if (counter.getValue() != 0 || snapshot.getCount() != 0 || snapshot.max != 0) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: metrics were not reset" << std::endl;
+    }
+}
+
+void MetricsTests::intervalsSplitTheValues() {
+    MetricHistogram histogram("metrics-test/intervalHistogram");
+    MetricHistogramWindow window(histogram, 2);
+    for (int i = 1; i <= 10; ++i) {
+        histogram.record(i);
+    }
+    window.endInterval();
+    histogram.record(100);
+    window.endInterval();
+
+    const MetricHistogramSnapshot& lastInterval = window.getLastInterval();
+    if (lastInterval.getCount() != 1 || lastInterval.getSum() != 100 || lastInterval.max != 100) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected only 100 in the last interval but found "
+            << lastInterval.getCount() << " values with a sum of " << lastInterval.getSum() << std::endl;
+    }
+    MetricHistogramSnapshot both = window.getWindow();
+    if (both.getCount() != 11 || both.getSum() != 155 || both.max != 100) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected 11 values with a sum of 155 in the window but found "
+            << both.getCount() << " with a sum of " << both.getSum() << std::endl;
+    }
+
+    // the oldest interval leaves the window, but the histogram keeps every value
+    histogram.record(5);
+    window.endInterval();
+    if (window.getWindow().getCount() != 2 || window.getWindow().max != 100) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected the first interval to leave the window" << std::endl;
+    }
+    if (histogram.getSnapshot().getCount() != 12) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected the histogram to keep all 12 values" << std::endl;
+    }
+
+    window.clear();
+    if (window.getNumIntervals() != 0 || window.getWindow().getCount() != 0 || window.getLastInterval().getCount() != 0) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected a cleared window to be empty" << std::endl;
+    }
+}
+
+void MetricsTests::statsHaveEveryMetric() {
+    QStringList names;
+    {
+        MetricCounter counter("metrics-test/statsCounter");
+        MetricGauge gauge("metrics-test/statsGauge");
+        counter.increment(3);
+        gauge.setValue(7);
+
+        names = Metrics::getNames();
+        QJsonObject statsObject;
+        Metrics::addToStats(statsObject, names);
+        if (statsObject.value("metric/metrics-test/statsCounter").toDouble() != 3.0 ||
+                statsObject.value("metric/metrics-test/statsGauge").toDouble() != 7.0) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: stats are missing the counter or the gauge" << std::endl;
+        }
+        if (!statsObject.contains("metric/metrics-test/workerHistogram_p99")) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: stats are missing the histogram" << std::endl;
+        }
+    }
+
+    // other assignments' metrics can be left out
+    {
+        MetricCounter counter("metrics-test/prefixCounter");
+        MetricCounter otherCounter("metrics-test-other/prefixCounter");
+        QStringList prefixNames = Metrics::getNames("metrics-test/");
+        if (!prefixNames.contains("metrics-test/prefixCounter") || prefixNames.contains("metrics-test-other/prefixCounter")) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: names were not filtered by prefix" << std::endl;
+        }
+    }
+
+    // metrics that are gone are no longer reported
+    if (Metrics::getNames().contains("metrics-test/statsCounter")) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: destroyed metric is still registered" << std::endl;
+    }
+    QJsonObject statsObject;
+    Metrics::addToStats(statsObject, names);
+    if (statsObject.contains("metric/metrics-test/statsCounter")) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: destroyed metric is still reported" << std::endl;
+    }
+}
+
+void MetricsTests::measureRecordCost() {
+    MetricCounter counter("metrics-test/measuredCounter");
+    MetricHistogram histogram("metrics-test/measuredHistogram");
+    const int NUM_RECORDS = 1000000;
+    quint64 startTime = usecTimestampNow();
+    for (int i = 0; i < NUM_RECORDS; ++i) {
+        counter.increment();
+    }
+    quint64 counterUsecs = usecTimestampNow() - startTime;
+
+    startTime = usecTimestampNow();
+    for (int i = 0; i < NUM_RECORDS; ++i) {
+        histogram.record(i % 1000);
+    }
+    quint64 histogramUsecs = usecTimestampNow() - startTime;
+    std::cout << "metric increment: " << (float)counterUsecs * 1000.0f / (float)NUM_RECORDS << " nsec, record: "
+        << (float)histogramUsecs * 1000.0f / (float)NUM_RECORDS << " nsec" << std::endl;
+}
+
+void MetricsTests::runAllTests() {
+    countersAddUpAcrossThreads();
+    histogramsReportPercentiles();
+    resetClearsMetrics();
+    intervalsSplitTheValues();
+    statsHaveEveryMetric();
+
+    measureRecordCost();
+}
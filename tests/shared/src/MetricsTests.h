@@ -0,0 +1,26 @@
+//
+//  MetricsTests.h
+//  tests/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MetricsTests_h
+#define hifi_MetricsTests_h
+
+namespace MetricsTests {
+    void countersAddUpAcrossThreads();
+    void histogramsReportPercentiles();
+    void resetClearsMetrics();
+    void intervalsSplitTheValues();
+    void statsHaveEveryMetric();
+
+    void measureRecordCost();
+
+    void runAllTests();
+}
+
+#endif // hifi_MetricsTests_h
@@ -0,0 +1,145 @@
+//
+//  ProfilerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <iostream>
+
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+
+#include <Profiler.h>
+#include <SharedUtil.h>
+
+#include "ProfilerTests.h"
+
+static void innerScope() {
+    PROFILE_SCOPE("profilerTestInner");
+}
+
+static void outerScope() {
+    PROFILE_SCOPE("profilerTestOuter");
+    innerScope();
+}
+
+void ProfilerTests::nestedScopesHaveNestedPaths() {
+    outerScope();
+    innerScope();
+    Profiler::tallyRecords();
+
+    const QMap<QString, PerformanceTimerRecord>& records = Profiler::getRecords();
+    const char* EXPECTED_PATHS[] = { "/profilerTestOuter", "/profilerTestOuter/profilerTestInner", "/profilerTestInner" };
+    for (int i = 0; i < 3; ++i) {
+        if (!records.contains(EXPECTED_PATHS[i])) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: missing record for " << EXPECTED_PATHS[i] << std::endl;
+        }
+    }
+}
+
+static void disabledScope() {
+    PROFILE_SCOPE("profilerTestDisabled");
+}
+
+void ProfilerTests::disabledScopesAreNotRecorded() {
+    Profiler::setEnabled(false);
+    disabledScope();
+    Profiler::setEnabled(true);
+    Profiler::tallyRecords();
+
+    if (Profiler::getRecords().contains("/profilerTestDisabled")) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: scope was recorded while the profiler was disabled"
+            << std::endl;
+    }
+}
+
+const int NUM_WORKER_SCOPES = 1000;
+
+// the workers all wait until they've all started, so that none of them gets the buffer of one that has finished
+static QSemaphore startedWorkers;
+static QSemaphore releasedWorkers;
+
+class ProfiledWorker : public QThread {
+public:
+    virtual void run() {
+        for (int i = 0; i < NUM_WORKER_SCOPES; ++i) {
+            PROFILE_SCOPE("profilerTestWorker");
+            innerScope();
+            if (i == 0) {
+                startedWorkers.release();
+                releasedWorkers.acquire();
+            }
+        }
+    }
+};
+
+void ProfilerTests::threadsAreTracedSeparately() {
+    const int NUM_WORKERS = 4;
+    Profiler::setTracing(true);
+    ProfiledWorker workers[NUM_WORKERS];
+    for (int i = 0; i < NUM_WORKERS; ++i) {
+        workers[i].setObjectName(QString("profilerTestWorker%1").arg(i));
+        workers[i].start();
+    }
+    startedWorkers.acquire(NUM_WORKERS);
+    releasedWorkers.release(NUM_WORKERS);
+    for (int i = 0; i < NUM_WORKERS; ++i) {
+        workers[i].wait();
+    }
+    Profiler::setTracing(false);
+
+    // the workers' timings are gathered into one record
+    Profiler::tallyRecords();
+    if (!Profiler::getRecords().contains("/profilerTestWorker/profilerTestInner")) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: missing record for the workers" << std::endl;
+    }
+
+    // but their scopes are traced on their own threads
+    QByteArray trace = Profiler::exportChromeTrace();
+    if (!trace.startsWith("{\"traceEvents\":[") || !trace.endsWith("]}")) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: trace is not a list of events" << std::endl;
+    }
+    for (int i = 0; i < NUM_WORKERS; ++i) {
+        if (!trace.contains(QString("\"name\":\"profilerTestWorker%1\"").arg(i).toUtf8())) {
+            std::cout << __FILE__ << ":" << __LINE__ << " ERROR: trace has no thread called profilerTestWorker"
+                << i << std::endl;
+        }
+    }
+    int numWorkerEvents = trace.count("\"name\":\"profilerTestWorker\"");
+    if (numWorkerEvents != NUM_WORKERS * NUM_WORKER_SCOPES) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << NUM_WORKERS * NUM_WORKER_SCOPES
+            << " traced worker scopes but found " << numWorkerEvents << std::endl;
+    }
+}
+
+static void measuredScope() {
+    PROFILE_SCOPE("profilerTestMeasured");
+}
+
+void ProfilerTests::measureScopeCost() {
+    const int NUM_SCOPES = 1000000;
+    quint64 usecs[2];
+    for (int i = 0; i < 2; ++i) {
+        Profiler::setEnabled(i == 0);
+        quint64 startTime = usecTimestampNow();
+        for (int j = 0; j < NUM_SCOPES; ++j) {
+            measuredScope();
+        }
+        usecs[i] = usecTimestampNow() - startTime;
+    }
+    Profiler::setEnabled(true);
+    std::cout << "profiled scope: " << (float)usecs[0] * 1000.0f / (float)NUM_SCOPES << " nsec enabled, "
+        << (float)usecs[1] * 1000.0f / (float)NUM_SCOPES << " nsec disabled" << std::endl;
+}
+
+void ProfilerTests::runAllTests() {
+    nestedScopesHaveNestedPaths();
+    disabledScopesAreNotRecorded();
+    threadsAreTracedSeparately();
+
+    measureScopeCost();
+}
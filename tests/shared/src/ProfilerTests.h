@@ -0,0 +1,24 @@
+//
+//  ProfilerTests.h
+//  tests/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ProfilerTests_h
+#define hifi_ProfilerTests_h
+
+namespace ProfilerTests {
+    void nestedScopesHaveNestedPaths();
+    void disabledScopesAreNotRecorded();
+    void threadsAreTracedSeparately();
+
+    void measureScopeCost();
+
+    void runAllTests();
+}
+
+#endif // hifi_ProfilerTests_h
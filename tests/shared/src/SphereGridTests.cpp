@@ -0,0 +1,168 @@
+//
+//  SphereGridTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <iostream>
+#include <vector>
+
+#include <SharedUtil.h>
+#include <SphereGrid.h>
+
+#include "SphereGridTests.h"
+
+static glm::vec3 randomPoint(float extent) {
+    return glm::vec3(randFloatInRange(-extent, extent), randFloatInRange(-extent, extent), randFloatInRange(-extent, extent));
+}
+
+// the exact answer, every sphere that the query overlaps once grown by the margin
+static void findOverlappingByBruteForce(const std::vector<glm::vec4>& spheres, float margin, const glm::vec3& center,
+                                        float radius, std::vector<int>& overlapping) {
+    overlapping.clear();
+    for (int i = 0; i < (int)spheres.size(); i++) {
+        glm::vec3 offset = center - glm::vec3(spheres[i]);
+        float limit = radius + spheres[i].w + margin;
+        if (glm::dot(offset, offset) <= limit * limit) {
+            overlapping.push_back(i);
+        }
+    }
+}
+
+void SphereGridTests::emptyGridFindsNothing() {
+    SphereGrid grid;
+    std::vector<int> overlapping(1, 0);
+    if (grid.findOverlapping(glm::vec3(0.0f), 1.0f, overlapping) || !overlapping.empty()) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: a new grid found " << overlapping.size() << " spheres"
+            << std::endl;
+    }
+
+    grid.clear(1.0f);
+    if (grid.findOverlapping(glm::vec3(0.0f), 1000.0f, overlapping) || grid.getSphereCount() != 0) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: a cleared grid found " << overlapping.size() << " spheres"
+            << std::endl;
+    }
+}
+
+void SphereGridTests::findsWhatBruteForceFinds() {
+    const int NUM_SPHERES = 1000;
+    const int NUM_LARGE_SPHERES = 5;
+    const int NUM_QUERIES = 1000;
+    const float EXTENT = 50.0f; // spheres are around the origin, so that cells have negative coordinates too
+    const float MAX_RADIUS = 1.0f;
+    const float MARGIN = 0.01f;
+
+    std::vector<glm::vec4> spheres;
+    SphereGrid grid;
+    grid.clear(MAX_RADIUS * 2.0f, MARGIN);
+    for (int i = 0; i < NUM_SPHERES; i++) {
+        // some spheres span more cells than a bucket entry is made for
+        float radius = (i % (NUM_SPHERES / NUM_LARGE_SPHERES) == 0) ? EXTENT * 0.5f : randFloatInRange(0.01f, MAX_RADIUS);
+        glm::vec3 center = randomPoint(EXTENT);
+        spheres.push_back(glm::vec4(center, radius));
+        grid.add(center, radius);
+    }
+    if (grid.getSphereCount() != NUM_SPHERES) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << NUM_SPHERES << " spheres but the grid has "
+            << grid.getSphereCount() << std::endl;
+    }
+
+    std::vector<int> found;
+    std::vector<int> expected;
+    int mismatches = 0;
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        // the last queries are too large for the cells, so they test every sphere
+        float radius = (i >= NUM_QUERIES - NUM_LARGE_SPHERES) ? EXTENT : randFloatInRange(0.0f, MAX_RADIUS * 2.0f);
+        glm::vec3 center = randomPoint(EXTENT * 1.1f);
+        bool foundAny = grid.findOverlapping(center, radius, found);
+        findOverlappingByBruteForce(spheres, MARGIN, center, radius, expected);
+        if (found != expected || foundAny != !expected.empty()) {
+            mismatches++;
+        }
+    }
+    if (mismatches > 0) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: " << mismatches << " of " << NUM_QUERIES
+            << " queries found other spheres than brute force" << std::endl;
+    }
+}
+
+void SphereGridTests::refillingReplacesSpheres() {
+    SphereGrid grid;
+    grid.clear(1.0f);
+    grid.add(glm::vec3(0.0f), 0.5f);
+    grid.add(glm::vec3(10.0f), 0.5f);
+    std::vector<int> found;
+    if (!grid.findOverlapping(glm::vec3(10.5f), 0.5f, found) || found.size() != 1 || found[0] != 1) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected to find sphere 1 only" << std::endl;
+    }
+
+    // a rebuilt grid knows nothing of the old spheres, and finds spheres added after a lookup
+    grid.clear(2.0f);
+    grid.add(glm::vec3(-10.0f), 1.0f);
+    if (grid.findOverlapping(glm::vec3(10.5f), 0.5f, found)) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: found " << found.size() << " spheres that were cleared"
+            << std::endl;
+    }
+    grid.add(glm::vec3(10.0f), 1.0f);
+    if (!grid.findOverlapping(glm::vec3(10.5f), 0.5f, found) || found.size() != 1 || found[0] != 1) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected to find the sphere added after the lookup"
+            << std::endl;
+    }
+}
+
+void SphereGridTests::movedSpheresAreFoundWhereTheyAre() {
+    const int NUM_SPHERES = 500;
+    const int NUM_ROUNDS = 10;
+    const int NUM_MOVES_PER_ROUND = 50;
+    const int NUM_QUERIES_PER_ROUND = 100;
+    const float EXTENT = 20.0f;
+    const float MAX_RADIUS = 1.0f;
+    const float MARGIN = 0.01f;
+
+    std::vector<glm::vec4> spheres;
+    SphereGrid grid;
+    grid.clear(MAX_RADIUS * 2.0f, MARGIN);
+    for (int i = 0; i < NUM_SPHERES; i++) {
+        float radius = (i == 0) ? EXTENT : randFloatInRange(0.01f, MAX_RADIUS);
+        glm::vec3 center = randomPoint(EXTENT);
+        spheres.push_back(glm::vec4(center, radius));
+        grid.add(center, radius);
+    }
+
+    std::vector<int> found;
+    std::vector<int> expected;
+    int mismatches = 0;
+    for (int round = 0; round < NUM_ROUNDS; round++) {
+        // moves before the first lookup are in the build, the others go into the moved lists, some spheres more than once
+        for (int i = 0; i < NUM_MOVES_PER_ROUND; i++) {
+            int sphere = randIntInRange(0, NUM_SPHERES - 1);
+            glm::vec3 center = randomPoint(EXTENT);
+            spheres[sphere] = glm::vec4(center, spheres[sphere].w);
+            grid.move(sphere, center);
+        }
+        for (int i = 0; i < NUM_QUERIES_PER_ROUND; i++) {
+            float radius = randFloatInRange(0.0f, MAX_RADIUS * 2.0f);
+            glm::vec3 center = randomPoint(EXTENT * 1.1f);
+            bool foundAny = grid.findOverlapping(center, radius, found);
+            findOverlappingByBruteForce(spheres, MARGIN, center, radius, expected);
+            if (found != expected || foundAny != !expected.empty()) {
+                mismatches++;
+            }
+        }
+    }
+    if (mismatches > 0) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: " << mismatches << " of " << NUM_ROUNDS * NUM_QUERIES_PER_ROUND
+            << " queries found other spheres than brute force after moves" << std::endl;
+    }
+}
+
+void SphereGridTests::runAllTests() {
+    emptyGridFindsNothing();
+    findsWhatBruteForceFinds();
+    refillingReplacesSpheres();
+    movedSpheresAreFoundWhereTheyAre();
+}
@@ -0,0 +1,23 @@
+//
+//  SphereGridTests.h
+//  tests/shared/src
+//
+//  Copyright 2014 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SphereGridTests_h
+#define hifi_SphereGridTests_h
+
+namespace SphereGridTests {
+    void emptyGridFindsNothing();
+    void findsWhatBruteForceFinds();
+    void refillingReplacesSpheres();
+    void movedSpheresAreFoundWhereTheyAre();
+
+    void runAllTests();
+}
+
+#endif // hifi_SphereGridTests_h
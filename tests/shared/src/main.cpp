@@ -10,12 +10,18 @@
 
 #include "AngularConstraintTests.h"
 #include "MovingPercentileTests.h"
+#include "MetricsTests.h"
 #include "MovingMinMaxAvgTests.h"
+#include "ProfilerTests.h"
+#include "SphereGridTests.h"
 
 int main(int argc, char** argv) {
     MovingMinMaxAvgTests::runAllTests();
     MovingPercentileTests::runAllTests();
     AngularConstraintTests::runAllTests();
+    ProfilerTests::runAllTests();
+    MetricsTests::runAllTests();
+    SphereGridTests::runAllTests();
     printf("tests complete, press enter to exit\n");
     getchar();
     return 0;